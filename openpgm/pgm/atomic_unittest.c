@@ -85,6 +85,36 @@ START_TEST (test_int32_add_pass_002)
 }
 END_TEST
 
+/* target:
+ *	bool
+ *	pgm_atomic_compare_and_exchange32 (
+ *		volatile uint32_t*	atomic,
+ *		const uint32_t		newval,
+ *		const uint32_t		oldval
+ *	)
+ */
+
+START_TEST (test_int32_compare_and_exchange_pass_001)
+{
+	volatile uint32_t atomic = 5;
+	fail_unless (pgm_atomic_compare_and_exchange32 (&atomic, (uint32_t)-1, 5), "cas failed");
+	fail_unless ((uint32_t)-1 == atomic, "cas failed");
+	fail_if (pgm_atomic_compare_and_exchange32 (&atomic, 10, 5), "cas failed");
+	fail_unless ((uint32_t)-1 == atomic, "cas failed");
+}
+END_TEST
+
+/* failed exchange must not leak the current value into following operations */
+START_TEST (test_int32_compare_and_exchange_pass_002)
+{
+	volatile uint32_t flag = 1;
+	volatile uint32_t atomic = 7;
+	fail_if (pgm_atomic_compare_and_exchange32 (&flag, 1, 0), "cas failed");
+	fail_unless (7 == pgm_atomic_exchange_and_add32 (&atomic, 0), "cas failed");
+	fail_unless (7 == atomic, "cas failed");
+}
+END_TEST
+
 /* target:
  *	uint32_t
  *	pgm_atomic_read32 (
@@ -115,6 +145,42 @@ START_TEST (test_int32_set_pass_001)
 }
 END_TEST
 
+/* target:
+ *	void
+ *	pgm_atomic_add64 (
+ *		volatile uint64_t*	atomic,
+ *		const uint64_t		val
+ *	)
+ */
+
+/* carry across 32-bit boundary */
+START_TEST (test_int64_add_pass_001)
+{
+	volatile uint64_t atomic = UINT32_MAX;
+	pgm_atomic_add64 (&atomic, 1);
+	fail_unless ((uint64_t)UINT32_MAX + 1 == atomic, "add failed");
+	fail_unless ((uint64_t)UINT32_MAX + 1 == pgm_atomic_read64 (&atomic), "read failed");
+	pgm_atomic_add64 (&atomic, UINT64_MAX);
+	fail_unless (UINT32_MAX == atomic, "add failed");
+}
+END_TEST
+
+/* target:
+ *	void
+ *	pgm_atomic_write64 (
+ *		volatile uint64_t*	atomic,
+ *		const uint64_t		val
+ *	)
+ */
+
+START_TEST (test_int64_set_pass_001)
+{
+	volatile uint64_t atomic = 0;
+	pgm_atomic_write64 (&atomic, UINT64_C(0x100000005));
+	fail_unless (UINT64_C(0x100000005) == atomic, "write failed");
+}
+END_TEST
+
 
 static
 Suite*
@@ -132,6 +198,12 @@ make_test_suite (void)
 	suite_add_tcase (s, tc_add);
 	tcase_add_test (tc_add, test_int32_add_pass_001);
 	tcase_add_test (tc_add, test_int32_add_pass_002);
+	tcase_add_test (tc_add, test_int64_add_pass_001);
+
+	TCase* tc_compare_and_exchange = tcase_create ("compare-and-exchange");
+	suite_add_tcase (s, tc_compare_and_exchange);
+	tcase_add_test (tc_compare_and_exchange, test_int32_compare_and_exchange_pass_001);
+	tcase_add_test (tc_compare_and_exchange, test_int32_compare_and_exchange_pass_002);
 
 	TCase* tc_get = tcase_create ("get");
 	suite_add_tcase (s, tc_get);
@@ -140,6 +212,7 @@ make_test_suite (void)
 	TCase* tc_set = tcase_create ("set");
 	suite_add_tcase (s, tc_set);
 	tcase_add_test (tc_set, test_int32_set_pass_001);
+	tcase_add_test (tc_set, test_int64_set_pass_001);
 
 	return s;
 }
@@ -240,6 +240,39 @@ START_TEST (test_block_add_pass_001)
 END_TEST
 
 
+/* target:
+ *	guint16
+ *	pgm_csum_replace (
+ *		guint16			csum,
+ *		guint32			from,
+ *		guint32			to
+ *	)
+ */
+
+START_TEST (test_replace_pass_001)
+{
+	const guint32 words[] = { 0x00000000, 0x00000001, 0x0000ffff, 0x80000000, 0xfffffffe, 0xffffffff };
+	char source[24] = "i am not a string";
+
+	for (unsigned i = 0; i < G_N_ELEMENTS(words); i++)
+		for (unsigned j = 0; j < G_N_ELEMENTS(words); j++)
+		{
+			guint32 from = words[i], to = words[j];
+			guint16 type_from, type_to;
+			memcpy (source + 20, &from, sizeof (from));
+			memcpy (&type_from, source + 4, sizeof (type_from));
+			const guint16 csum = pgm_csum_fold (pgm_csum_partial (source, sizeof(source), 0));
+			memcpy (source + 20, &to, sizeof (to));
+			type_to = type_from ^ (guint16)to;
+			memcpy (source + 4, &type_to, sizeof (type_to));
+			const guint16 answer = pgm_csum_fold (pgm_csum_partial (source, sizeof(source), 0));
+			guint16 updated = pgm_csum_replace (csum, from, to);
+			updated = pgm_csum_replace (updated, type_from, type_to);
+			fail_unless (answer == updated, "checksum mismatch replacing 0x%08x with 0x%08x", from, to);
+		}
+}
+END_TEST
+
 static
 Suite*
 make_test_suite (void)
@@ -266,6 +299,11 @@ make_test_suite (void)
 	tcase_add_checked_fixture (tc_block_add, mock_setup, NULL);
 	tcase_add_test (tc_block_add, test_block_add_pass_001);
 
+	TCase* tc_replace = tcase_create ("replace");
+	suite_add_tcase (s, tc_replace);
+	tcase_add_checked_fixture (tc_replace, mock_setup, NULL);
+	tcase_add_test (tc_replace, test_replace_pass_001);
+
 	TCase* tc_partial = tcase_create ("partial");
 	suite_add_tcase (s, tc_partial);
 	tcase_add_checked_fixture (tc_partial, mock_setup, NULL);
@@ -92,6 +92,7 @@ pgm_cpuid (pgm_cpu_t* cpu)
 			(cpu_info[2] & 0x08000000) != 0 /* OSXSAVE */ &&
 			(_xgetbv(0) & 6) == 6 /* XSAVE enabled by kernel */;
 	cpu->has_avx2 = cpu->has_avx && (cpu_info7[1] & 0x00000020) != 0;
+	cpu->has_gfni = (cpu_info7[2] & 0x00000100) != 0;
 }
 
 /* eof */
@@ -208,6 +208,9 @@ pgm_init (
 /* set preferred checksum algorithm */
 	pgm_checksum_init (&pgm_cpu);
 
+/* select Reed-Solomon kernel */
+	pgm_rs_init (&pgm_cpu);
+
 	pgm_is_supported = TRUE;
 	return TRUE;
 
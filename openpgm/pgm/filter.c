@@ -0,0 +1,389 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * In-kernel packet filter for receive sockets.
+ *
+ * Raw PGM sockets receive every PGM packet arriving at the host, for every
+ * multicast group and every data-destination port, and UDP encapsulated sockets
+ * sharing a port see the same.  A classic BPF program matching the joined groups,
+ * the data-destination port and optionally a single source TSI is attached to the
+ * receive socket so that unwanted packets are discarded before checksumming.
+ *
+ * Copyright (c) 2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+#include <impl/i18n.h>
+#include <impl/framework.h>
+#include <impl/socket.h>
+#include <impl/filter.h>
+
+
+//#define FILTER_DEBUG
+
+/* classic BPF opcodes */
+#define PGM_BPF_LD		0x00
+#define PGM_BPF_LDX		0x01
+#define PGM_BPF_ALU		0x04
+#define PGM_BPF_JMP		0x05
+#define PGM_BPF_RET		0x06
+#define PGM_BPF_W		0x00
+#define PGM_BPF_H		0x08
+#define PGM_BPF_B		0x10
+#define PGM_BPF_IMM		0x00
+#define PGM_BPF_ABS		0x20
+#define PGM_BPF_IND		0x40
+#define PGM_BPF_MSH		0xa0
+#define PGM_BPF_AND		0x50
+#define PGM_BPF_JA		0x00
+#define PGM_BPF_JEQ		0x10
+#define PGM_BPF_K		0x00
+
+/* Linux offset of the network header, independent of where the socket data starts */
+#define PGM_BPF_NET_OFF		((uint32_t)-0x100000)
+
+#define FILTER_ACCEPT		0xffffffff
+#define FILTER_REJECT		0
+
+/* offsets into the PGM header */
+#define FILTER_SPORT		0
+#define FILTER_DPORT		2
+#define FILTER_GSI		8
+
+/* forward references to an instruction not yet emitted */
+#define FILTER_MAX_FIXUPS	16
+
+struct filter_label_t {
+	unsigned		idx[FILTER_MAX_FIXUPS];
+	bool			is_jt[FILTER_MAX_FIXUPS];
+	unsigned		len;
+};
+
+struct filter_prog_t {
+	struct pgm_filter_insn_t*	insns;
+	unsigned			len;
+	unsigned			max;
+	bool				is_invalid;
+};
+
+static
+void
+emit (
+	struct filter_prog_t*	prog,
+	const uint16_t		code,
+	const uint32_t		k
+	)
+{
+	if (prog->len < prog->max) {
+		struct pgm_filter_insn_t* insn = &prog->insns[prog->len];
+		insn->code = code;
+		insn->jt = insn->jf = 0;
+		insn->k = k;
+	} else
+		prog->is_invalid = TRUE;
+	prog->len++;
+}
+
+/* conditional jump on A == k, a NULL label falls through.
+ */
+
+static
+void
+emit_jeq (
+	struct filter_prog_t*	restrict prog,
+	const uint32_t		k,
+	struct filter_label_t*	restrict jt,
+	struct filter_label_t*	restrict jf
+	)
+{
+	const unsigned idx = prog->len;
+	emit (prog, PGM_BPF_JMP|PGM_BPF_JEQ|PGM_BPF_K, k);
+	if (NULL != jt) {
+		pgm_assert (jt->len < FILTER_MAX_FIXUPS);
+		jt->idx[jt->len] = idx;
+		jt->is_jt[jt->len++] = TRUE;
+	}
+	if (NULL != jf) {
+		pgm_assert (jf->len < FILTER_MAX_FIXUPS);
+		jf->idx[jf->len] = idx;
+		jf->is_jt[jf->len++] = FALSE;
+	}
+}
+
+/* resolve pending jumps to the next instruction, offsets are limited to 8 bits.
+ */
+
+static
+void
+bind_label (
+	struct filter_prog_t*	restrict prog,
+	struct filter_label_t*	restrict label
+	)
+{
+	for (unsigned i = 0; i < label->len; i++)
+	{
+		const unsigned idx = label->idx[i];
+		const unsigned offset = prog->len - (idx + 1);
+		if (idx >= prog->max || offset > UINT8_MAX) {
+			prog->is_invalid = TRUE;
+			continue;
+		}
+		if (label->is_jt[i])
+			prog->insns[idx].jt = (uint8_t)offset;
+		else
+			prog->insns[idx].jf = (uint8_t)offset;
+	}
+	label->len = 0;
+}
+
+/* compare an address in the network header, jump to mismatch on any difference.
+ */
+
+static
+void
+emit_match_addr (
+	struct filter_prog_t*	restrict prog,
+	const uint32_t		offset,
+	const struct sockaddr*	restrict sa,
+	struct filter_label_t*	restrict mismatch
+	)
+{
+	const uint8_t* addr;
+	unsigned words;
+
+	if (AF_INET6 == sa->sa_family) {
+		addr  = (const uint8_t*)&((const struct sockaddr_in6*)sa)->sin6_addr;
+		words = 4;
+	} else {
+		addr  = (const uint8_t*)&((const struct sockaddr_in*)sa)->sin_addr;
+		words = 1;
+	}
+	for (unsigned i = 0; i < words; i++, addr += 4)
+	{
+		const uint32_t w = ((uint32_t)addr[0] << 24) | ((uint32_t)addr[1] << 16) | ((uint32_t)addr[2] << 8) | addr[3];
+		emit (prog, PGM_BPF_LD|PGM_BPF_W|PGM_BPF_ABS, PGM_BPF_NET_OFF + offset + (i * 4));
+		emit_jeq (prog, w, NULL, mismatch);
+	}
+}
+
+/* group and source addresses can only be matched when every entry is of the
+ * socket address family.
+ */
+
+static
+bool
+can_match_addr (
+	const pgm_sock_t*const	sock
+	)
+{
+	if (AF_INET != sock->family && AF_INET6 != sock->family)
+		return FALSE;
+	for (unsigned i = 0; i < sock->recv_gsr_len; i++)
+		if (sock->family != sock->recv_gsr[i].gsr_group.ss_family ||
+		    sock->family != sock->recv_gsr[i].gsr_source.ss_family)
+			return FALSE;
+	for (unsigned i = 0; i < sock->block_gsr_len; i++)
+		if (sock->family != sock->block_gsr[i].gsr_group.ss_family ||
+		    sock->family != sock->block_gsr[i].gsr_source.ss_family)
+			return FALSE;
+	return TRUE;
+}
+
+/* Generate a program accepting,
+ *
+ * 1. downstream packets to our data-destination port, SPM, ODATA, RDATA, NCF.
+ * 2. upstream packets to our source port when sending, NAK, NNAK, SPMR, ACK.
+ * 3. peer packets from our data-destination port, multicast SPMR.
+ *
+ * optionally only with the GSI and source port of the PGM_FILTER_TSI source, and
+ * when multicast only to a joined group from a source not blocked.  Unicast
+ * destinations are always accepted.
+ *
+ * returns count of instructions, or zero if the buffer is too small.
+ */
+
+PGM_GNUC_INTERNAL
+unsigned
+pgm_filter_compile (
+	const pgm_sock_t* const		  restrict sock,
+	struct pgm_filter_insn_t*	  restrict insns,
+	const unsigned			  max_len
+	)
+{
+	struct filter_prog_t prog;
+	struct filter_label_t reject, next;
+	const uint16_t dport = ntohs (sock->dport);
+
+/* pre-conditions */
+	pgm_assert (NULL != sock);
+	pgm_assert (NULL != insns);
+
+	prog.insns	= insns;
+	prog.len	= 0;
+	prog.max	= max_len;
+	prog.is_invalid	= FALSE;
+	reject.len = next.len = 0;
+
+/* X = offset of the PGM header */
+	if (IPPROTO_UDP == sock->protocol)
+		emit (&prog, PGM_BPF_LDX|PGM_BPF_W|PGM_BPF_IMM, sizeof(struct pgm_udphdr));
+	else if (AF_INET == sock->family)
+		emit (&prog, PGM_BPF_LDX|PGM_BPF_B|PGM_BPF_MSH, 0);
+	else	/* IPv6 raw sockets start at the transport header */
+		emit (&prog, PGM_BPF_LDX|PGM_BPF_W|PGM_BPF_IMM, 0);
+
+	emit (&prog, PGM_BPF_LD|PGM_BPF_H|PGM_BPF_IND, FILTER_DPORT);
+	if (sock->use_filter_tsi)
+	{
+		struct filter_label_t downstream;
+		const uint8_t* gsi = sock->filter_tsi.gsi.identifier;
+		downstream.len = 0;
+		emit_jeq (&prog, dport, &downstream, NULL);
+		if (sock->can_send_data) {
+			emit_jeq (&prog, ntohs (sock->tsi.sport), NULL, &next);
+			emit (&prog, PGM_BPF_RET|PGM_BPF_K, FILTER_ACCEPT);
+			bind_label (&prog, &next);
+		}
+/* upstream or peer, source port is the destination port */
+		emit (&prog, PGM_BPF_LD|PGM_BPF_H|PGM_BPF_IND, FILTER_SPORT);
+		emit_jeq (&prog, dport, NULL, &reject);
+		emit (&prog, PGM_BPF_LD|PGM_BPF_H|PGM_BPF_IND, FILTER_DPORT);
+		emit (&prog, PGM_BPF_JMP|PGM_BPF_JA, 1);
+		bind_label (&prog, &downstream);
+		emit (&prog, PGM_BPF_LD|PGM_BPF_H|PGM_BPF_IND, FILTER_SPORT);
+		emit_jeq (&prog, ntohs (sock->filter_tsi.sport), NULL, &reject);
+		emit (&prog, PGM_BPF_LD|PGM_BPF_W|PGM_BPF_IND, FILTER_GSI);
+		emit_jeq (&prog, ((uint32_t)gsi[0] << 24) | ((uint32_t)gsi[1] << 16) | ((uint32_t)gsi[2] << 8) | gsi[3], NULL, &reject);
+		emit (&prog, PGM_BPF_LD|PGM_BPF_H|PGM_BPF_IND, FILTER_GSI + 4);
+		emit_jeq (&prog, ((uint32_t)gsi[4] << 8) | gsi[5], &next, NULL);
+		bind_label (&prog, &reject);
+		emit (&prog, PGM_BPF_RET|PGM_BPF_K, FILTER_REJECT);
+		bind_label (&prog, &next);
+	}
+	else
+	{
+		struct filter_label_t accept_port;
+		accept_port.len = 0;
+		emit_jeq (&prog, dport, &accept_port, NULL);
+		if (sock->can_send_data) {
+			emit_jeq (&prog, ntohs (sock->tsi.sport), NULL, &next);
+			emit (&prog, PGM_BPF_RET|PGM_BPF_K, FILTER_ACCEPT);
+			bind_label (&prog, &next);
+		}
+		emit (&prog, PGM_BPF_LD|PGM_BPF_H|PGM_BPF_IND, FILTER_SPORT);
+		emit_jeq (&prog, dport, &accept_port, NULL);
+		emit (&prog, PGM_BPF_RET|PGM_BPF_K, FILTER_REJECT);
+		bind_label (&prog, &accept_port);
+	}
+
+	if (can_match_addr (sock))
+	{
+		const bool is_ipv6 = (AF_INET6 == sock->family);
+		const uint32_t dst_offset = is_ipv6 ? 24 : 16;
+		const uint32_t src_offset = is_ipv6 ?  8 : 12;
+
+/* unicast destination */
+		if (is_ipv6) {
+			emit (&prog, PGM_BPF_LD|PGM_BPF_B|PGM_BPF_ABS, PGM_BPF_NET_OFF + dst_offset);
+			emit_jeq (&prog, 0xff, &next, NULL);
+		} else {
+			emit (&prog, PGM_BPF_LD|PGM_BPF_W|PGM_BPF_ABS, PGM_BPF_NET_OFF + dst_offset);
+			emit (&prog, PGM_BPF_ALU|PGM_BPF_AND|PGM_BPF_K, 0xf0000000);
+			emit_jeq (&prog, 0xe0000000, &next, NULL);
+		}
+		emit (&prog, PGM_BPF_RET|PGM_BPF_K, FILTER_ACCEPT);
+		bind_label (&prog, &next);
+
+/* PGM_BLOCK_SOURCE */
+		for (unsigned i = 0; i < sock->block_gsr_len; i++)
+		{
+			emit_match_addr (&prog, dst_offset, (const struct sockaddr*)&sock->block_gsr[i].gsr_group, &next);
+			emit_match_addr (&prog, src_offset, (const struct sockaddr*)&sock->block_gsr[i].gsr_source, &next);
+			emit (&prog, PGM_BPF_RET|PGM_BPF_K, FILTER_REJECT);
+			bind_label (&prog, &next);
+		}
+
+/* PGM_JOIN_GROUP entries use the group as source, PGM_JOIN_SOURCE_GROUP the real source */
+		for (unsigned i = 0; i < sock->recv_gsr_len; i++)
+		{
+			const struct group_source_req* gsr = &sock->recv_gsr[i];
+			emit_match_addr (&prog, dst_offset, (const struct sockaddr*)&gsr->gsr_group, &next);
+			if (0 != pgm_sockaddr_cmp ((const struct sockaddr*)&gsr->gsr_group, (const struct sockaddr*)&gsr->gsr_source))
+				emit_match_addr (&prog, src_offset, (const struct sockaddr*)&gsr->gsr_source, &next);
+			emit (&prog, PGM_BPF_RET|PGM_BPF_K, FILTER_ACCEPT);
+			bind_label (&prog, &next);
+		}
+		emit (&prog, PGM_BPF_RET|PGM_BPF_K, FILTER_REJECT);
+	}
+	else
+		emit (&prog, PGM_BPF_RET|PGM_BPF_K, FILTER_ACCEPT);
+
+	if (PGM_UNLIKELY(prog.is_invalid))
+		return 0;
+	return prog.len;
+}
+
+/* regenerate and attach the filter after binding and on every change of group
+ * membership, source blocking or TSI filter.  A program that cannot be generated
+ * removes any filter so that nothing expected is lost, filtering then happens in
+ * user space.
+ *
+ * returns TRUE on success, returns FALSE when the kernel refuses the filter.
+ */
+
+PGM_GNUC_INTERNAL
+bool
+pgm_filter_update (
+	pgm_sock_t* const	sock
+	)
+{
+	struct pgm_filter_insn_t* insns;
+	unsigned len;
+
+/* pre-conditions */
+	pgm_assert (NULL != sock);
+
+	if (!sock->use_kernel_filter)
+		return TRUE;
+
+	insns = pgm_new (struct pgm_filter_insn_t, PGM_FILTER_MAX_INSNS);
+	len = pgm_filter_compile (sock, insns, PGM_FILTER_MAX_INSNS);
+#ifdef FILTER_DEBUG
+	for (unsigned i = 0; i < len; i++)
+		pgm_debug ("{ 0x%02x, %u, %u, 0x%08x }",
+			insns[i].code, insns[i].jt, insns[i].jf, insns[i].k);
+#endif
+	if (SOCKET_ERROR == pgm_sockaddr_filter (sock->recv_sock, insns, len) && len > 0)
+	{
+		char errbuf[1024];
+		const int save_errno = pgm_get_last_sock_error();
+		pgm_warn (_("Kernel packet filter unavailable, filtering in user space: %s"),
+			  pgm_sock_strerror_s (errbuf, sizeof (errbuf), save_errno));
+		sock->use_kernel_filter = FALSE;
+		pgm_free (insns);
+		return FALSE;
+	}
+	if (len > 0)
+		pgm_trace (PGM_LOG_ROLE_NETWORK,_("Attached kernel packet filter of %u instructions."), len);
+	else
+		pgm_trace (PGM_LOG_ROLE_NETWORK,_("Kernel packet filter too large, filtering in user space."));
+	pgm_free (insns);
+	return TRUE;
+}
+
+/* eof */
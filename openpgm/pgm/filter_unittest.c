@@ -0,0 +1,465 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * unit tests for in-kernel packet filter generation.
+ *
+ * Copyright (c) 2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include <errno.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#	include <sys/socket.h>
+#	include <netinet/in.h>
+#	include <arpa/inet.h>
+#endif
+#include <glib.h>
+#include <check.h>
+
+
+/* mock state */
+
+#define TEST_SOCK		3
+#define TEST_DPORT		7500
+#define TEST_SPORT		1000
+#define TEST_OTHER_PORT		7501
+
+static unsigned mock_filter_len = 0;
+static int mock_filter_retval = 0;
+
+int mock_pgm_sockaddr_filter (const SOCKET, void*, const unsigned);
+
+#define pgm_sockaddr_filter	mock_pgm_sockaddr_filter
+
+#define FILTER_DEBUG
+#include "filter.c"
+
+
+static
+void
+mock_setup (void)
+{
+	mock_filter_len = 0;
+	mock_filter_retval = 0;
+}
+
+/* mock functions for external references */
+
+PGM_GNUC_INTERNAL
+int
+pgm_get_nprocs (void)
+{
+	return 1;
+}
+
+int
+mock_pgm_sockaddr_filter (
+	const SOCKET		s,
+	void*			insns,
+	const unsigned		len
+	)
+{
+	g_assert (TEST_SOCK == s);
+	g_assert (NULL != insns);
+	mock_filter_len = len;
+	if (mock_filter_retval)
+		errno = EINVAL;
+	return mock_filter_retval;
+}
+
+/* classic BPF interpreter for the subset of instructions generated, data
+ * offsets are relative to the socket data, negative offsets relative to
+ * the network header.
+ */
+
+static
+uint32_t
+run_filter (
+	const struct pgm_filter_insn_t*	insns,
+	const unsigned			len,
+	const guint8*			packet,
+	const gsize			packet_len,
+	const gsize			data_offset
+	)
+{
+	uint32_t A = 0, X = 0;
+	for (unsigned pc = 0; pc < len; pc++)
+	{
+		const struct pgm_filter_insn_t* insn = &insns[pc];
+		gsize offset, size;
+		switch (insn->code & 0x07) {
+		case PGM_BPF_LD:
+		case PGM_BPF_LDX:
+			if (PGM_BPF_IMM == (insn->code & 0xe0)) {
+				X = insn->k;
+				continue;
+			}
+			size = (PGM_BPF_W == (insn->code & 0x18)) ? 4 : (PGM_BPF_H == (insn->code & 0x18)) ? 2 : 1;
+			if (insn->k >= PGM_BPF_NET_OFF)
+				offset = insn->k - PGM_BPF_NET_OFF;
+			else
+				offset = data_offset + insn->k + ((PGM_BPF_IND == (insn->code & 0xe0)) ? X : 0);
+			if (offset + size > packet_len)
+				return 0;
+			if (PGM_BPF_MSH == (insn->code & 0xe0)) {
+				X = (packet[offset] & 0xf) << 2;
+				continue;
+			}
+			A = packet[offset];
+			for (gsize i = 1; i < size; i++)
+				A = (A << 8) | packet[offset + i];
+			break;
+		case PGM_BPF_ALU:
+			g_assert (PGM_BPF_AND == (insn->code & 0xf0));
+			A &= insn->k;
+			break;
+		case PGM_BPF_JMP:
+			if (PGM_BPF_JA == (insn->code & 0xf0))
+				pc += insn->k;
+			else
+				pc += (A == insn->k) ? insn->jt : insn->jf;
+			break;
+		case PGM_BPF_RET:
+			return insn->k;
+		default:
+			g_assert_not_reached();
+		}
+	}
+	g_assert_not_reached();
+	return 0;
+}
+
+static
+pgm_sock_t*
+generate_sock (
+	const sa_family_t	family,
+	const int		protocol
+	)
+{
+	pgm_sock_t* sock = g_new0 (pgm_sock_t, 1);
+	sock->family		= family;
+	sock->protocol		= protocol;
+	sock->recv_sock		= TEST_SOCK;
+	sock->dport		= g_htons (TEST_DPORT);
+	sock->tsi.sport		= g_htons (TEST_SPORT);
+	sock->can_send_data	= TRUE;
+	sock->can_recv_data	= TRUE;
+	sock->use_kernel_filter	= TRUE;
+	return sock;
+}
+
+static
+void
+add_group (
+	pgm_sock_t*		sock,
+	const char*		group,
+	const char*		source		/* NULL for any-source */
+	)
+{
+	struct group_source_req* gsr = &sock->recv_gsr[ sock->recv_gsr_len++ ];
+	g_assert (1 == pgm_sockaddr_pton (group, (struct sockaddr*)&gsr->gsr_group));
+	g_assert (1 == pgm_sockaddr_pton (source ? source : group, (struct sockaddr*)&gsr->gsr_source));
+}
+
+static
+void
+add_block (
+	pgm_sock_t*		sock,
+	const char*		group,
+	const char*		source
+	)
+{
+	struct group_source_req* gsr = &sock->block_gsr[ sock->block_gsr_len++ ];
+	g_assert (1 == pgm_sockaddr_pton (group, (struct sockaddr*)&gsr->gsr_group));
+	g_assert (1 == pgm_sockaddr_pton (source, (struct sockaddr*)&gsr->gsr_source));
+}
+
+/* build a PGM packet as seen by the socket filter, returns offset of socket data.
+ */
+
+static
+gsize
+generate_packet (
+	const pgm_sock_t*	sock,
+	guint8*			packet,
+	gsize*			packet_len,
+	const char*		src,
+	const char*		dst,
+	const guint16		sport,
+	const guint16		dport,
+	const guint8		type,
+	const guint8		gsi0
+	)
+{
+	gsize pgm_offset, data_offset;
+	memset (packet, 0, 1024);
+	if (AF_INET6 == sock->family) {
+		packet[0] = 0x60;
+		packet[6] = (IPPROTO_UDP == sock->protocol) ? IPPROTO_UDP : IPPROTO_PGM;
+		g_assert (1 == inet_pton (AF_INET6, src, &packet[8]));
+		g_assert (1 == inet_pton (AF_INET6, dst, &packet[24]));
+		data_offset = pgm_offset = 40;
+	} else {
+		packet[0] = 0x46;		/* with 4 bytes of IP options */
+		packet[9] = (IPPROTO_UDP == sock->protocol) ? IPPROTO_UDP : IPPROTO_PGM;
+		g_assert (1 == inet_pton (AF_INET, src, &packet[12]));
+		g_assert (1 == inet_pton (AF_INET, dst, &packet[16]));
+		data_offset = 0;
+		pgm_offset = 24;
+	}
+	if (IPPROTO_UDP == sock->protocol) {
+		data_offset = pgm_offset;
+		pgm_offset += sizeof(struct pgm_udphdr);
+	}
+	struct pgm_header* header = (struct pgm_header*)&packet[pgm_offset];
+	header->pgm_sport	= g_htons (sport);
+	header->pgm_dport	= g_htons (dport);
+	header->pgm_type	= type;
+	header->pgm_gsi[0]	= gsi0;
+	header->pgm_gsi[5]	= 0x55;
+	*packet_len = pgm_offset + sizeof(struct pgm_header) + sizeof(struct pgm_data);
+	return data_offset;
+}
+
+static
+uint32_t
+filter_packet (
+	const pgm_sock_t*	sock,
+	const char*		src,
+	const char*		dst,
+	const guint16		sport,
+	const guint16		dport,
+	const guint8		type,
+	const guint8		gsi0
+	)
+{
+	struct pgm_filter_insn_t insns[ PGM_FILTER_MAX_INSNS ];
+	guint8 packet[ 1024 ];
+	gsize packet_len;
+	const unsigned len = pgm_filter_compile (sock, insns, G_N_ELEMENTS(insns));
+	fail_unless (len > 0, "compile failed");
+	const gsize data_offset = generate_packet (sock, packet, &packet_len, src, dst, sport, dport, type, gsi0);
+	return run_filter (insns, len, packet, packet_len, data_offset);
+}
+
+/* target:
+ *	unsigned
+ *	pgm_filter_compile (
+ *		const pgm_sock_t*		sock,
+ *		struct pgm_filter_insn_t*	insns,
+ *		const unsigned			max_len
+ *	)
+ */
+
+/* any-source multicast on raw IPv4 */
+START_TEST (test_compile_pass_001)
+{
+	pgm_sock_t* sock = generate_sock (AF_INET, IPPROTO_PGM);
+	add_group (sock, "239.192.0.1", NULL);
+/* downstream to our port and group */
+	fail_unless (0 != filter_packet (sock, "10.0.0.1", "239.192.0.1", 2000, TEST_DPORT, PGM_ODATA, 1), "odata rejected");
+/* other session */
+	fail_unless (0 == filter_packet (sock, "10.0.0.1", "239.192.0.1", 2000, TEST_OTHER_PORT, PGM_ODATA, 1), "other port accepted");
+/* other group */
+	fail_unless (0 == filter_packet (sock, "10.0.0.1", "239.192.0.2", 2000, TEST_DPORT, PGM_ODATA, 1), "other group accepted");
+/* unicast NAK to our source */
+	fail_unless (0 != filter_packet (sock, "10.0.0.1", "10.0.0.2", TEST_DPORT, TEST_SPORT, PGM_NAK, 1), "nak rejected");
+/* multicast SPMR from a peer */
+	fail_unless (0 != filter_packet (sock, "10.0.0.1", "239.192.0.1", TEST_DPORT, 2000, PGM_SPMR, 1), "spmr rejected");
+/* NAK to another source port of another session */
+	fail_unless (0 == filter_packet (sock, "10.0.0.1", "10.0.0.2", TEST_OTHER_PORT, 2000, PGM_NAK, 1), "other nak accepted");
+	g_free (sock);
+}
+END_TEST
+
+/* source-specific multicast */
+START_TEST (test_compile_pass_002)
+{
+	pgm_sock_t* sock = generate_sock (AF_INET, IPPROTO_PGM);
+	add_group (sock, "232.0.0.1", "10.0.0.1");
+	fail_unless (0 != filter_packet (sock, "10.0.0.1", "232.0.0.1", 2000, TEST_DPORT, PGM_ODATA, 1), "joined source rejected");
+	fail_unless (0 == filter_packet (sock, "10.0.0.9", "232.0.0.1", 2000, TEST_DPORT, PGM_ODATA, 1), "other source accepted");
+	g_free (sock);
+}
+END_TEST
+
+/* blocked source */
+START_TEST (test_compile_pass_003)
+{
+	pgm_sock_t* sock = generate_sock (AF_INET, IPPROTO_PGM);
+	add_group (sock, "239.192.0.1", NULL);
+	add_block (sock, "239.192.0.1", "10.0.0.9");
+	fail_unless (0 != filter_packet (sock, "10.0.0.1", "239.192.0.1", 2000, TEST_DPORT, PGM_ODATA, 1), "source rejected");
+	fail_unless (0 == filter_packet (sock, "10.0.0.9", "239.192.0.1", 2000, TEST_DPORT, PGM_ODATA, 1), "blocked source accepted");
+	g_free (sock);
+}
+END_TEST
+
+/* single source TSI */
+START_TEST (test_compile_pass_004)
+{
+	pgm_sock_t* sock = generate_sock (AF_INET, IPPROTO_PGM);
+	sock->can_send_data = FALSE;
+	add_group (sock, "239.192.0.1", NULL);
+	sock->use_filter_tsi = TRUE;
+	sock->filter_tsi.gsi.identifier[0] = 1;
+	sock->filter_tsi.gsi.identifier[5] = 0x55;
+	sock->filter_tsi.sport = g_htons (2000);
+	fail_unless (0 != filter_packet (sock, "10.0.0.1", "239.192.0.1", 2000, TEST_DPORT, PGM_ODATA, 1), "source rejected");
+	fail_unless (0 == filter_packet (sock, "10.0.0.1", "239.192.0.1", 2000, TEST_DPORT, PGM_ODATA, 2), "other gsi accepted");
+	fail_unless (0 == filter_packet (sock, "10.0.0.1", "239.192.0.1", 2001, TEST_DPORT, PGM_ODATA, 1), "other sport accepted");
+/* peer SPMR to the source */
+	fail_unless (0 != filter_packet (sock, "10.0.0.3", "239.192.0.1", TEST_DPORT, 2000, PGM_SPMR, 1), "spmr rejected");
+	fail_unless (0 == filter_packet (sock, "10.0.0.3", "239.192.0.1", TEST_DPORT, 2001, PGM_SPMR, 1), "other spmr accepted");
+	g_free (sock);
+}
+END_TEST
+
+/* raw IPv6 */
+START_TEST (test_compile_pass_005)
+{
+	pgm_sock_t* sock = generate_sock (AF_INET6, IPPROTO_PGM);
+	add_group (sock, "ff08::1", NULL);
+	add_group (sock, "ff3e::8000:1", "2001:db8::1");
+	fail_unless (0 != filter_packet (sock, "2001:db8::9", "ff08::1", 2000, TEST_DPORT, PGM_ODATA, 1), "asm rejected");
+	fail_unless (0 == filter_packet (sock, "2001:db8::9", "ff08::2", 2000, TEST_DPORT, PGM_ODATA, 1), "other group accepted");
+	fail_unless (0 != filter_packet (sock, "2001:db8::1", "ff3e::8000:1", 2000, TEST_DPORT, PGM_ODATA, 1), "ssm rejected");
+	fail_unless (0 == filter_packet (sock, "2001:db8::2", "ff3e::8000:1", 2000, TEST_DPORT, PGM_ODATA, 1), "other source accepted");
+	fail_unless (0 != filter_packet (sock, "2001:db8::9", "2001:db8::2", TEST_DPORT, TEST_SPORT, PGM_NAK, 1), "nak rejected");
+	g_free (sock);
+}
+END_TEST
+
+/* UDP encapsulation */
+START_TEST (test_compile_pass_006)
+{
+	pgm_sock_t* sock = generate_sock (AF_INET, IPPROTO_UDP);
+	add_group (sock, "239.192.0.1", NULL);
+	fail_unless (0 != filter_packet (sock, "10.0.0.1", "239.192.0.1", 2000, TEST_DPORT, PGM_ODATA, 1), "odata rejected");
+	fail_unless (0 == filter_packet (sock, "10.0.0.1", "239.192.0.1", 2000, TEST_OTHER_PORT, PGM_ODATA, 1), "other port accepted");
+	g_free (sock);
+}
+END_TEST
+
+/* mixed address families cannot be matched, accept all groups */
+START_TEST (test_compile_pass_007)
+{
+	pgm_sock_t* sock = generate_sock (AF_INET, IPPROTO_PGM);
+	add_group (sock, "239.192.0.1", NULL);
+	add_group (sock, "ff08::1", NULL);
+	fail_unless (0 != filter_packet (sock, "10.0.0.1", "239.192.0.2", 2000, TEST_DPORT, PGM_ODATA, 1), "group rejected");
+	fail_unless (0 == filter_packet (sock, "10.0.0.1", "239.192.0.2", 2000, TEST_OTHER_PORT, PGM_ODATA, 1), "other port accepted");
+	g_free (sock);
+}
+END_TEST
+
+/* buffer too small */
+START_TEST (test_compile_fail_001)
+{
+	struct pgm_filter_insn_t insns[ 4 ];
+	pgm_sock_t* sock = generate_sock (AF_INET, IPPROTO_PGM);
+	add_group (sock, "239.192.0.1", NULL);
+	fail_unless (0 == pgm_filter_compile (sock, insns, G_N_ELEMENTS(insns)), "compile succeeded");
+	g_free (sock);
+}
+END_TEST
+
+/* target:
+ *	bool
+ *	pgm_filter_update (
+ *		pgm_sock_t*		sock
+ *	)
+ */
+
+START_TEST (test_update_pass_001)
+{
+	pgm_sock_t* sock = generate_sock (AF_INET, IPPROTO_PGM);
+	add_group (sock, "239.192.0.1", NULL);
+	fail_unless (TRUE == pgm_filter_update (sock), "update failed");
+	fail_unless (mock_filter_len > 0, "no filter attached");
+	fail_unless (TRUE == sock->use_kernel_filter, "filter disabled");
+	g_free (sock);
+}
+END_TEST
+
+/* kernel refuses, fall back to user space filtering */
+START_TEST (test_update_fail_001)
+{
+	pgm_sock_t* sock = generate_sock (AF_INET, IPPROTO_PGM);
+	mock_filter_retval = SOCKET_ERROR;
+	fail_unless (FALSE == pgm_filter_update (sock), "update succeeded");
+	fail_unless (FALSE == sock->use_kernel_filter, "filter not disabled");
+	mock_filter_len = 0;
+	fail_unless (TRUE == pgm_filter_update (sock), "update failed");
+	fail_unless (0 == mock_filter_len, "filter attached");
+	g_free (sock);
+}
+END_TEST
+
+static
+Suite*
+make_test_suite (void)
+{
+	Suite* s;
+
+	s = suite_create (__FILE__);
+
+	TCase* tc_compile = tcase_create ("compile");
+	suite_add_tcase (s, tc_compile);
+	tcase_add_test (tc_compile, test_compile_pass_001);
+	tcase_add_test (tc_compile, test_compile_pass_002);
+	tcase_add_test (tc_compile, test_compile_pass_003);
+	tcase_add_test (tc_compile, test_compile_pass_004);
+	tcase_add_test (tc_compile, test_compile_pass_005);
+	tcase_add_test (tc_compile, test_compile_pass_006);
+	tcase_add_test (tc_compile, test_compile_pass_007);
+	tcase_add_test (tc_compile, test_compile_fail_001);
+
+	TCase* tc_update = tcase_create ("update");
+	suite_add_tcase (s, tc_update);
+	tcase_add_checked_fixture (tc_update, mock_setup, NULL);
+	tcase_add_test (tc_update, test_update_pass_001);
+	tcase_add_test (tc_update, test_update_fail_001);
+
+	return s;
+}
+
+static
+Suite*
+make_master_suite (void)
+{
+	Suite* s = suite_create ("Master");
+	return s;
+}
+
+int
+main (void)
+{
+	pgm_messages_init();
+	SRunner* sr = srunner_create (make_master_suite ());
+	srunner_add_suite (sr, make_test_suite ());
+	srunner_run_all (sr, CK_ENV);
+	int number_failed = srunner_ntests_failed (sr);
+	srunner_free (sr);
+	pgm_messages_shutdown();
+	return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* eof */
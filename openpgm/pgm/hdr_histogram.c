@@ -0,0 +1,324 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * High dynamic range latency histograms.
+ *
+ * Copyright (c) 2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+#include <string.h>
+#ifdef HAVE_CLOCK_GETTIME
+#	include <time.h>
+#endif
+#include <impl/framework.h>
+
+
+//#define HDR_HISTOGRAM_DEBUG
+
+/* each shard: padding, sample sum, bucket counts */
+#define HDR_SUM			PGM_STATS_PAD
+#define HDR_COUNTS		(HDR_SUM + 1)
+#define HDR_SHARD_LEN		(HDR_COUNTS + PGM_HDR_BUCKETS)
+
+#if defined(__GNUC__) || defined(__SUNPRO_C)
+#	define HDR_THREAD		__thread
+#elif defined(_MSC_VER)
+#	define HDR_THREAD		__declspec(thread)
+#endif
+
+static volatile uint64_t hdr_shards[ PGM_HDR_MAX ][ PGM_HDR_SHARDS ][ HDR_SHARD_LEN ];
+
+#ifdef HDR_THREAD
+static HDR_THREAD unsigned hdr_thread_shard = 0;	/* shard + 1, 0 = unassigned */
+static volatile uint32_t hdr_next_shard = 0;
+#endif
+
+static const char* hdr_names[ PGM_HDR_MAX ] = {
+	"Tx.SendCall",
+	"Tx.RdataDwell",
+	"Rx.DeliverLatency",
+	"Rx.RepairTime",
+	"Timer.Lateness"
+};
+
+
+/* position of most significant bit, value must be non-zero.
+ */
+
+static inline
+unsigned
+_pgm_hdr_msb (
+	uint64_t	value
+	)
+{
+#ifdef __GNUC__
+	return 63 - __builtin_clzll (value);
+#else
+	unsigned msb = 0;
+	while (value >>= 1)
+		msb++;
+	return msb;
+#endif
+}
+
+/* bucket of value, exact below PGM_HDR_SUB_BUCKETS, otherwise the top
+ * PGM_HDR_SUB_BITS + 1 bits of the value select the sub-bucket of its
+ * power of two range.
+ */
+
+static inline
+unsigned
+_pgm_hdr_index (
+	uint64_t	value
+	)
+{
+	if (value < PGM_HDR_SUB_BUCKETS)
+		return (unsigned)value;
+	if (PGM_UNLIKELY(value > PGM_HDR_MAX_VALUE))
+		value = PGM_HDR_MAX_VALUE;
+	const unsigned shift = _pgm_hdr_msb (value) - PGM_HDR_SUB_BITS;
+	return ((shift + 1) << PGM_HDR_SUB_BITS) + (unsigned)(value >> shift) - PGM_HDR_SUB_BUCKETS;
+}
+
+/* smallest value counted in bucket i.
+ */
+
+static inline
+uint64_t
+_pgm_hdr_lowest (
+	const unsigned	i
+	)
+{
+	const unsigned group = i >> PGM_HDR_SUB_BITS;
+	const unsigned sub   = i & (PGM_HDR_SUB_BUCKETS - 1);
+	if (0 == group)
+		return sub;
+	return (uint64_t)(PGM_HDR_SUB_BUCKETS + sub) << (group - 1);
+}
+
+/* largest value counted in bucket i.
+ */
+
+static inline
+uint64_t
+_pgm_hdr_highest (
+	const unsigned	i
+	)
+{
+	const unsigned group = i >> PGM_HDR_SUB_BITS;
+	if (0 == group)
+		return i;
+	return _pgm_hdr_lowest (i) + (UINT64_C(1) << (group - 1)) - 1;
+}
+
+static inline
+unsigned
+_pgm_hdr_shard (void)
+{
+#ifdef HDR_THREAD
+	if (PGM_UNLIKELY(0 == hdr_thread_shard))
+		hdr_thread_shard = 1 + pgm_atomic_exchange_and_add32 (&hdr_next_shard, 1) % PGM_HDR_SHARDS;
+	return hdr_thread_shard - 1;
+#else
+	return 0;
+#endif
+}
+
+/* monotonic time in nanoseconds for bracketing short calls, falls back to
+ * the library clock where no nanosecond clock is available.
+ */
+
+PGM_GNUC_INTERNAL
+uint64_t
+pgm_hdr_now (void)
+{
+#ifdef HAVE_CLOCK_GETTIME
+	struct timespec ts = { 0, 0 };
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * UINT64_C(1000000000) + (uint64_t)ts.tv_nsec;
+#else
+	return pgm_to_nsecs (pgm_time_update_now());
+#endif
+}
+
+/* count one sample of histogram id, safe from any thread.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_hdr_record (
+	const unsigned	id,
+	const uint64_t	nsecs
+	)
+{
+/* pre-conditions */
+	pgm_assert (id < PGM_HDR_MAX);
+
+	volatile uint64_t* shard = hdr_shards[ id ][ _pgm_hdr_shard() ];
+	pgm_atomic_add64 (&shard[ HDR_COUNTS + _pgm_hdr_index (nsecs) ], 1);
+	pgm_atomic_add64 (&shard[ HDR_SUM ], nsecs);
+}
+
+/* merge all shards of histogram id into snapshot without stopping writers.
+ *
+ * the total is taken from the copied buckets so percentiles are always
+ * consistent with it, the sum may include samples counted after their
+ * bucket was read.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_hdr_snapshot (
+	const unsigned		id,
+	pgm_hdr_snapshot_t*	snapshot
+	)
+{
+/* pre-conditions */
+	pgm_assert (id < PGM_HDR_MAX);
+	pgm_assert (NULL != snapshot);
+
+	memset (snapshot, 0, sizeof(pgm_hdr_snapshot_t));
+	for (unsigned j = 0; j < PGM_HDR_SHARDS; j++)
+	{
+		const volatile uint64_t* shard = hdr_shards[ id ][ j ];
+		for (unsigned i = 0; i < PGM_HDR_BUCKETS; i++) {
+			const uint64_t count = pgm_atomic_read64 (&shard[ HDR_COUNTS + i ]);
+			snapshot->counts[ i ]   += count;
+			snapshot->total_count   += count;
+		}
+		snapshot->sum += pgm_atomic_read64 (&shard[ HDR_SUM ]);
+	}
+}
+
+/* add the samples of src into dst, e.g. to combine histograms of several
+ * processes or intervals.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_hdr_merge (
+	pgm_hdr_snapshot_t*	  restrict dst,
+	const pgm_hdr_snapshot_t* restrict src
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != dst);
+	pgm_assert (NULL != src);
+
+	for (unsigned i = 0; i < PGM_HDR_BUCKETS; i++)
+		dst->counts[ i ] += src->counts[ i ];
+	dst->total_count += src->total_count;
+	dst->sum	 += src->sum;
+}
+
+/* value at or below which percentile of the samples fall, reported as the
+ * highest value equivalent to the bucket.  returns 0 for an empty snapshot.
+ */
+
+PGM_GNUC_INTERNAL
+uint64_t
+pgm_hdr_percentile (
+	const pgm_hdr_snapshot_t* snapshot,
+	const double		  percentile
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != snapshot);
+	pgm_assert (percentile >= 0.0 && percentile <= 100.0);
+
+	if (0 == snapshot->total_count)
+		return 0;
+	uint64_t target = (uint64_t)((percentile / 100.0) * (double)snapshot->total_count + 0.5);
+	if (0 == target)
+		target = 1;
+	uint64_t count = 0;
+	for (unsigned i = 0; i < PGM_HDR_BUCKETS; i++) {
+		count += snapshot->counts[ i ];
+		if (count >= target)
+			return _pgm_hdr_highest (i);
+	}
+	return PGM_HDR_MAX_VALUE;
+}
+
+PGM_GNUC_INTERNAL
+uint64_t
+pgm_hdr_max (
+	const pgm_hdr_snapshot_t* snapshot
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != snapshot);
+
+	for (unsigned i = PGM_HDR_BUCKETS; i > 0; i--)
+		if (snapshot->counts[ i - 1 ])
+			return _pgm_hdr_highest (i - 1);
+	return 0;
+}
+
+PGM_GNUC_INTERNAL
+const char*
+pgm_hdr_name (
+	const unsigned	id
+	)
+{
+/* pre-conditions */
+	pgm_assert (id < PGM_HDR_MAX);
+
+	return hdr_names[ id ];
+}
+
+/* percentile table of every histogram for the web interface.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_hdr_write_html_all (
+	pgm_string_t*		string
+	)
+{
+	static const double percentiles[] = { 50.0, 90.0, 99.0, 99.9 };
+	pgm_hdr_snapshot_t* snapshot = pgm_new (pgm_hdr_snapshot_t, 1);
+
+	pgm_string_append (string,	"<table>"
+					"<tr>"
+						"<th>Histogram</th>"
+						"<th>Samples</th>"
+						"<th>Mean ns</th>"
+						"<th>50% ns</th>"
+						"<th>90% ns</th>"
+						"<th>99% ns</th>"
+						"<th>99.9% ns</th>"
+						"<th>Max ns</th>"
+					"</tr>");
+	for (unsigned id = 0; id < PGM_HDR_MAX; id++)
+	{
+		pgm_hdr_snapshot (id, snapshot);
+		pgm_string_append_printf (string, "<tr><td>%s</td><td>%" PRIu64 "</td><td>%" PRIu64 "</td>",
+					  hdr_names[ id ],
+					  snapshot->total_count,
+					  snapshot->total_count ? snapshot->sum / snapshot->total_count : 0);
+		for (unsigned i = 0; i < PGM_N_ELEMENTS(percentiles); i++)
+			pgm_string_append_printf (string, "<td>%" PRIu64 "</td>", pgm_hdr_percentile (snapshot, percentiles[ i ]));
+		pgm_string_append_printf (string, "<td>%" PRIu64 "</td></tr>", pgm_hdr_max (snapshot));
+	}
+	pgm_string_append (string, "</table>\n");
+	pgm_free (snapshot);
+}
+
+/* eof */
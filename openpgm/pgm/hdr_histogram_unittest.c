@@ -0,0 +1,254 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * unit tests for high dynamic range latency histograms.
+ *
+ * Copyright (c) 2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include <signal.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+#include <check.h>
+
+#ifdef _WIN32
+#	define PGM_CHECK_NOFORK		1
+#endif
+
+
+/* mock state */
+
+
+/* mock functions for external references */
+
+#define HDR_HISTOGRAM_DEBUG
+#include "hdr_histogram.c"
+
+PGM_GNUC_INTERNAL
+int
+pgm_get_nprocs (void)
+{
+	return 1;
+}
+
+static
+void
+mock_setup (void)
+{
+	memset ((void*)hdr_shards, 0, sizeof(hdr_shards));
+}
+
+
+/* target:
+ *	internal layout, each value lies within its bucket and the bucket width
+ *	is within 1/32 of the value.
+ */
+
+START_TEST (test_index_pass_001)
+{
+	fail_unless (PGM_HDR_BUCKETS - 1 == _pgm_hdr_index (PGM_HDR_MAX_VALUE), "last bucket");
+	fail_unless (PGM_HDR_BUCKETS - 1 == _pgm_hdr_index (UINT64_MAX), "saturation");
+	for (uint64_t value = 0; value < 1000000; value += 1 + value / 64)
+	{
+		const unsigned i = _pgm_hdr_index (value);
+		fail_unless (i < PGM_HDR_BUCKETS, "index out of range");
+		fail_unless (_pgm_hdr_lowest (i) <= value && value <= _pgm_hdr_highest (i), "value outside bucket");
+		fail_unless ((_pgm_hdr_highest (i) - _pgm_hdr_lowest (i)) * PGM_HDR_SUB_BUCKETS <= value, "bucket too wide");
+	}
+}
+END_TEST
+
+/* buckets are contiguous */
+START_TEST (test_index_pass_002)
+{
+	for (unsigned i = 1; i < PGM_HDR_BUCKETS; i++)
+		fail_unless (_pgm_hdr_highest (i - 1) + 1 == _pgm_hdr_lowest (i), "gap between buckets");
+	fail_unless (PGM_HDR_MAX_VALUE == _pgm_hdr_highest (PGM_HDR_BUCKETS - 1), "range end");
+}
+END_TEST
+
+/* target:
+ *	void
+ *	pgm_hdr_record (
+ *		const unsigned	id,
+ *		const uint64_t	nsecs
+ *	)
+ */
+
+START_TEST (test_record_pass_001)
+{
+	pgm_hdr_snapshot_t snapshot;
+	pgm_hdr_record (PGM_HDR_SEND_CALL, 7);
+	pgm_hdr_record (PGM_HDR_SEND_CALL, 7);
+	pgm_hdr_record (PGM_HDR_SEND_CALL, 100000);
+	pgm_hdr_snapshot (PGM_HDR_SEND_CALL, &snapshot);
+	fail_unless (3 == snapshot.total_count, "total mismatch");
+	fail_unless (100014 == snapshot.sum, "sum mismatch");
+	fail_unless (2 == snapshot.counts[7], "exact bucket mismatch");
+	pgm_hdr_snapshot (PGM_HDR_DELIVER, &snapshot);
+	fail_unless (0 == snapshot.total_count, "other histogram modified");
+}
+END_TEST
+
+START_TEST (test_record_fail_001)
+{
+	pgm_hdr_record (PGM_HDR_MAX, 1);
+	fail ("reached");
+}
+END_TEST
+
+/* target:
+ *	uint64_t
+ *	pgm_hdr_percentile (
+ *		const pgm_hdr_snapshot_t* snapshot,
+ *		const double		  percentile
+ *	)
+ */
+
+START_TEST (test_percentile_pass_001)
+{
+	pgm_hdr_snapshot_t snapshot;
+	pgm_hdr_snapshot (PGM_HDR_REPAIR_TIME, &snapshot);
+	fail_unless (0 == pgm_hdr_percentile (&snapshot, 50.0), "empty histogram");
+	for (uint64_t value = 1; value <= 1000; value++)
+		pgm_hdr_record (PGM_HDR_REPAIR_TIME, value * 1000);
+	pgm_hdr_snapshot (PGM_HDR_REPAIR_TIME, &snapshot);
+	const uint64_t median = pgm_hdr_percentile (&snapshot, 50.0);
+	const uint64_t p99    = pgm_hdr_percentile (&snapshot, 99.0);
+	fail_unless (median >= 500000 && median <= 500000 + 500000 / PGM_HDR_SUB_BUCKETS, "median out of range");
+	fail_unless (p99 >= 990000 && p99 <= 990000 + 990000 / PGM_HDR_SUB_BUCKETS, "99th out of range");
+	fail_unless (pgm_hdr_percentile (&snapshot, 0.0) < 1000 + 1000 / PGM_HDR_SUB_BUCKETS, "minimum out of range");
+	fail_unless (pgm_hdr_percentile (&snapshot, 100.0) == pgm_hdr_max (&snapshot), "maximum mismatch");
+}
+END_TEST
+
+START_TEST (test_percentile_fail_001)
+{
+	pgm_hdr_snapshot_t snapshot;
+	memset (&snapshot, 0, sizeof(snapshot));
+	pgm_hdr_percentile (&snapshot, 101.0);
+	fail ("reached");
+}
+END_TEST
+
+/* target:
+ *	void
+ *	pgm_hdr_merge (
+ *		pgm_hdr_snapshot_t*	  restrict dst,
+ *		const pgm_hdr_snapshot_t* restrict src
+ *	)
+ */
+
+START_TEST (test_merge_pass_001)
+{
+	pgm_hdr_snapshot_t a, b;
+	pgm_hdr_record (PGM_HDR_SEND_CALL, 10);
+	pgm_hdr_record (PGM_HDR_TIMER_LATENESS, 5000000);
+	pgm_hdr_snapshot (PGM_HDR_SEND_CALL, &a);
+	pgm_hdr_snapshot (PGM_HDR_TIMER_LATENESS, &b);
+	pgm_hdr_merge (&a, &b);
+	fail_unless (2 == a.total_count, "total mismatch");
+	fail_unless (5000010 == a.sum, "sum mismatch");
+	fail_unless (10 == pgm_hdr_percentile (&a, 50.0), "median mismatch");
+	fail_unless (_pgm_hdr_highest (_pgm_hdr_index (5000000)) == pgm_hdr_max (&a), "maximum mismatch");
+}
+END_TEST
+
+/* target:
+ *	void
+ *	pgm_hdr_write_html_all (
+ *		pgm_string_t*		string
+ *	)
+ */
+
+START_TEST (test_write_html_all_pass_001)
+{
+	pgm_string_t* string = pgm_string_new (NULL);
+	pgm_hdr_record (PGM_HDR_DELIVER, 1234);
+	pgm_hdr_write_html_all (string);
+	fail_unless (NULL != strstr (string->str, "Rx.DeliverLatency"), "name missing");
+	fail_unless (NULL != strstr (string->str, "</table>"), "table unterminated");
+	pgm_string_free (string, TRUE);
+}
+END_TEST
+
+
+static
+Suite*
+make_test_suite (void)
+{
+	Suite* s;
+
+	s = suite_create (__FILE__);
+
+	TCase* tc_index = tcase_create ("index");
+	suite_add_tcase (s, tc_index);
+	tcase_add_test (tc_index, test_index_pass_001);
+	tcase_add_test (tc_index, test_index_pass_002);
+
+	TCase* tc_record = tcase_create ("record");
+	suite_add_tcase (s, tc_record);
+	tcase_add_checked_fixture (tc_record, mock_setup, NULL);
+	tcase_add_test (tc_record, test_record_pass_001);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_record, test_record_fail_001, SIGABRT);
+#endif
+
+	TCase* tc_percentile = tcase_create ("percentile");
+	suite_add_tcase (s, tc_percentile);
+	tcase_add_checked_fixture (tc_percentile, mock_setup, NULL);
+	tcase_add_test (tc_percentile, test_percentile_pass_001);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_percentile, test_percentile_fail_001, SIGABRT);
+#endif
+
+	TCase* tc_merge = tcase_create ("merge");
+	suite_add_tcase (s, tc_merge);
+	tcase_add_checked_fixture (tc_merge, mock_setup, NULL);
+	tcase_add_test (tc_merge, test_merge_pass_001);
+
+	TCase* tc_write_html_all = tcase_create ("write-html-all");
+	suite_add_tcase (s, tc_write_html_all);
+	tcase_add_checked_fixture (tc_write_html_all, mock_setup, NULL);
+	tcase_add_test (tc_write_html_all, test_write_html_all_pass_001);
+	return s;
+}
+
+static
+Suite*
+make_master_suite (void)
+{
+	Suite* s = suite_create ("Master");
+	return s;
+}
+
+int
+main (void)
+{
+	pgm_messages_init();
+	SRunner* sr = srunner_create (make_master_suite ());
+	srunner_add_suite (sr, make_test_suite ());
+	srunner_run_all (sr, CK_ENV);
+	int number_failed = srunner_ntests_failed (sr);
+	srunner_free (sr);
+	pgm_messages_shutdown();
+	return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* eof */
@@ -1069,6 +1069,7 @@ histograms_callback (
         )
 {
 	pgm_string_t* response = http_create_response ("Histograms", HTTP_TAB_HISTOGRAMS);
+	pgm_hdr_write_html_all (response);
 	pgm_histogram_write_html_graph_all (response);
 	http_finalize_response (connection, response);
 }
@@ -1126,7 +1127,7 @@ http_tsi_response (
 
 /* check receivers */
 		pgm_rwlock_reader_lock (&list_sock->peers_lock);
-		pgm_peer_t* receiver = pgm_hashtable_lookup (list_sock->peers_hashtable, tsi);
+		pgm_peer_t* receiver = pgm_tsitable_lookup (list_sock->peers_hashtable, tsi);
 		if (receiver) {
 			const int retval = http_receiver_response (connection, list_sock, receiver);
 			pgm_rwlock_reader_unlock (&list_sock->peers_lock);
@@ -1287,61 +1288,63 @@ http_tsi_response (
 /* performance information */
 
 	const pgm_txw_t* window = sock->window;
+	uint64_t stats[PGM_PC_SOURCE_MAX];
+	pgm_sock_stats_snapshot (sock, stats);
 	pgm_string_append_printf (response,	"\n<h2>Performance information</h2>"
 						"\n<table>"
 						"<tr>"
-							"<th>Data bytes sent</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>Data bytes sent</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>Data packets sent</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>Data packets sent</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
 							"<th>Bytes buffered</th><td>%" GROUP_FORMAT PRIu32 "</td>"
 						"</tr><tr>"
 							"<th>Packets buffered</th><td>%" GROUP_FORMAT PRIu32 "</td>"
 						"</tr><tr>"
-							"<th>Bytes sent</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>Bytes sent</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>Raw NAKs received</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>Raw NAKs received</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>Checksum errors</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>Checksum errors</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>Malformed NAKs</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>Malformed NAKs</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>Packets discarded</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>Packets discarded</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>Bytes retransmitted</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>Bytes retransmitted</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>Packets retransmitted</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>Packets retransmitted</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>NAKs received</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>NAKs received</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>NAKs ignored</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>NAKs ignored</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>Transmission rate</th><td>%" GROUP_FORMAT PRIu32 " bps</td>"
+							"<th>Transmission rate</th><td>%" GROUP_FORMAT PRIu64 " bps</td>"
 						"</tr><tr>"
-							"<th>NNAK packets received</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>NNAK packets received</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>NNAKs received</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>NNAKs received</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>Malformed NNAKs</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>Malformed NNAKs</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr>"
 						"</table>\n",
-						sock->cumulative_stats[PGM_PC_SOURCE_DATA_BYTES_SENT],
-						sock->cumulative_stats[PGM_PC_SOURCE_DATA_MSGS_SENT],
+						stats[PGM_PC_SOURCE_DATA_BYTES_SENT],
+						stats[PGM_PC_SOURCE_DATA_MSGS_SENT],
 						window ? (uint32_t)pgm_txw_size (window) : 0,	/* minus IP & any UDP header */
 						window ? (uint32_t)pgm_txw_length (window) : 0,
-						sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT],
-						sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED],
-						sock->cumulative_stats[PGM_PC_SOURCE_CKSUM_ERRORS],
-						sock->cumulative_stats[PGM_PC_SOURCE_MALFORMED_NAKS],
-						sock->cumulative_stats[PGM_PC_SOURCE_PACKETS_DISCARDED],
-						sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_BYTES_RETRANSMITTED],
-						sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_MSGS_RETRANSMITTED],
-						sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED],
-						sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NAKS_IGNORED],
-						sock->cumulative_stats[PGM_PC_SOURCE_TRANSMISSION_CURRENT_RATE],
-						sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NNAK_PACKETS_RECEIVED],
-						sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NNAKS_RECEIVED],
-						sock->cumulative_stats[PGM_PC_SOURCE_NNAK_ERRORS]);
+						stats[PGM_PC_SOURCE_BYTES_SENT],
+						stats[PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED],
+						stats[PGM_PC_SOURCE_CKSUM_ERRORS],
+						stats[PGM_PC_SOURCE_MALFORMED_NAKS],
+						stats[PGM_PC_SOURCE_PACKETS_DISCARDED],
+						stats[PGM_PC_SOURCE_SELECTIVE_BYTES_RETRANSMITTED],
+						stats[PGM_PC_SOURCE_SELECTIVE_MSGS_RETRANSMITTED],
+						stats[PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED],
+						stats[PGM_PC_SOURCE_SELECTIVE_NAKS_IGNORED],
+						stats[PGM_PC_SOURCE_TRANSMISSION_CURRENT_RATE],
+						stats[PGM_PC_SOURCE_SELECTIVE_NNAK_PACKETS_RECEIVED],
+						stats[PGM_PC_SOURCE_SELECTIVE_NNAKS_RECEIVED],
+						stats[PGM_PC_SOURCE_NNAK_ERRORS]);
 
 	pgm_rwlock_reader_unlock (&pgm_sock_list_lock);
 	http_finalize_response (connection, response);
@@ -1488,7 +1491,7 @@ http_receiver_response (
 	const in_port_t sport = pgm_ntohs (peer->tsi.sport);
 	const in_port_t dport = pgm_ntohs (sock->dport);	/* by definition must be the same */
 	const pgm_rxw_t* window = peer->window;
-	const uint32_t outstanding_naks = window->nak_backoff_queue.length +
+	const uint32_t outstanding_naks = window->nak_backoff_count +
 					  window->wait_ncf_queue.length +
 					  window->wait_data_queue.length;
 
@@ -1561,28 +1564,30 @@ http_receiver_response (
 						sock->nak_data_retries,
 						sock->hops);
 
+	uint64_t stats[PGM_PC_RECEIVER_MAX];
+	pgm_peer_stats_snapshot (peer, stats);
 	pgm_string_append_printf (response,	"\n<h2>Performance information</h2>"
 						"\n<table>"
 						"<tr>"
-							"<th>Data bytes received</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>Data bytes received</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>Data packets received</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>Data packets received</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>NAK failures</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>NAK failures</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>Bytes received</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>Bytes received</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>Checksum errors</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>Checksum errors</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>Malformed SPMs</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>Malformed SPMs</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>Malformed ODATA</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>Malformed ODATA</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>Malformed RDATA</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>Malformed RDATA</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>Malformed NCFs</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>Malformed NCFs</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>Packets discarded</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>Packets discarded</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
 							"<th>Losses</th><td>%" GROUP_FORMAT PRIu32 "</td>"	/* detected missed packets */
 						"</tr><tr>"
@@ -1590,29 +1595,29 @@ http_receiver_response (
 						"</tr><tr>"
 							"<th>Packets delivered to app</th><td>%" GROUP_FORMAT PRIu32 "</td>"
 						"</tr><tr>"
-							"<th>Duplicate SPMs</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>Duplicate SPMs</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>Duplicate ODATA/RDATA</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>Duplicate ODATA/RDATA</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>NAK packets sent</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>NAK packets sent</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>NAKs sent</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>NAKs sent</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>NAKs retransmitted</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>NAKs retransmitted</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>NAKs failed</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>NAKs failed</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>NAKs failed due to RXW advance</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>NAKs failed due to RXW advance</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>NAKs failed due to NCF retries</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>NAKs failed due to NCF retries</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>NAKs failed due to DATA retries</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>NAKs failed due to DATA retries</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>NAK failures delivered to app</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>NAK failures delivered to app</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>NAKs suppressed</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>NAKs suppressed</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
-							"<th>Malformed NAKs</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>Malformed NAKs</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
 							"<th>Outstanding NAKs</th><td>%" GROUP_FORMAT PRIu32 "</td>"
 						"</tr><tr>"
@@ -1620,58 +1625,58 @@ http_receiver_response (
 						"</tr><tr>"
 							"<th>NAK repair min time</th><td>%" GROUP_FORMAT PRIu32 " μs</td>"
 						"</tr><tr>"
-							"<th>NAK repair mean time</th><td>%" GROUP_FORMAT PRIu32 " μs</td>"
+							"<th>NAK repair mean time</th><td>%" GROUP_FORMAT PRIu64 " μs</td>"
 						"</tr><tr>"
 							"<th>NAK repair max time</th><td>%" GROUP_FORMAT PRIu32 " μs</td>"
 						"</tr><tr>"
 							"<th>NAK fail min time</th><td>%" GROUP_FORMAT PRIu32 " μs</td>"
 						"</tr><tr>"
-							"<th>NAK fail mean time</th><td>%" GROUP_FORMAT PRIu32 " μs</td>"
+							"<th>NAK fail mean time</th><td>%" GROUP_FORMAT PRIu64 " μs</td>"
 						"</tr><tr>"
 							"<th>NAK fail max time</th><td>%" GROUP_FORMAT PRIu32 " μs</td>"
 						"</tr><tr>"
 							"<th>NAK min retransmit count</th><td>%" GROUP_FORMAT PRIu32 "</td>"
 						"</tr><tr>"
-							"<th>NAK mean retransmit count</th><td>%" GROUP_FORMAT PRIu32 "</td>"
+							"<th>NAK mean retransmit count</th><td>%" GROUP_FORMAT PRIu64 "</td>"
 						"</tr><tr>"
 							"<th>NAK max retransmit count</th><td>%" GROUP_FORMAT PRIu32 "</td>"
 						"</tr>"
 						"</table>\n",
-						peer->cumulative_stats[PGM_PC_RECEIVER_DATA_BYTES_RECEIVED],
-						peer->cumulative_stats[PGM_PC_RECEIVER_DATA_MSGS_RECEIVED],
-						peer->cumulative_stats[PGM_PC_RECEIVER_NAK_FAILURES],
-						peer->cumulative_stats[PGM_PC_RECEIVER_BYTES_RECEIVED],
-						sock->cumulative_stats[PGM_PC_SOURCE_CKSUM_ERRORS],
-						peer->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_SPMS],
-						peer->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_ODATA],
-						peer->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_RDATA],
-						peer->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_NCFS],
-						peer->cumulative_stats[PGM_PC_RECEIVER_PACKETS_DISCARDED],
+						stats[PGM_PC_RECEIVER_DATA_BYTES_RECEIVED],
+						stats[PGM_PC_RECEIVER_DATA_MSGS_RECEIVED],
+						stats[PGM_PC_RECEIVER_NAK_FAILURES],
+						stats[PGM_PC_RECEIVER_BYTES_RECEIVED],
+						stats[PGM_PC_RECEIVER_CKSUM_ERRORS],
+						stats[PGM_PC_RECEIVER_MALFORMED_SPMS],
+						stats[PGM_PC_RECEIVER_MALFORMED_ODATA],
+						stats[PGM_PC_RECEIVER_MALFORMED_RDATA],
+						stats[PGM_PC_RECEIVER_MALFORMED_NCFS],
+						stats[PGM_PC_RECEIVER_PACKETS_DISCARDED],
 						window->cumulative_losses,
 						window->bytes_delivered,
 						window->msgs_delivered,
-						peer->cumulative_stats[PGM_PC_RECEIVER_DUP_SPMS],
-						peer->cumulative_stats[PGM_PC_RECEIVER_DUP_DATAS],
-						peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAK_PACKETS_SENT],
-						peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_SENT],
-						peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_RETRANSMITTED],
-						peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_FAILED],
-						peer->cumulative_stats[PGM_PC_RECEIVER_NAKS_FAILED_RXW_ADVANCED],
-						peer->cumulative_stats[PGM_PC_RECEIVER_NAKS_FAILED_NCF_RETRIES_EXCEEDED],
-						peer->cumulative_stats[PGM_PC_RECEIVER_NAKS_FAILED_DATA_RETRIES_EXCEEDED],
-						peer->cumulative_stats[PGM_PC_RECEIVER_NAK_FAILURES_DELIVERED],
-						peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_SUPPRESSED],
-						peer->cumulative_stats[PGM_PC_RECEIVER_NAK_ERRORS],
+						stats[PGM_PC_RECEIVER_DUP_SPMS],
+						stats[PGM_PC_RECEIVER_DUP_DATAS],
+						stats[PGM_PC_RECEIVER_SELECTIVE_NAK_PACKETS_SENT],
+						stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_SENT],
+						stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_RETRANSMITTED],
+						stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_FAILED],
+						stats[PGM_PC_RECEIVER_NAKS_FAILED_RXW_ADVANCED],
+						stats[PGM_PC_RECEIVER_NAKS_FAILED_NCF_RETRIES_EXCEEDED],
+						stats[PGM_PC_RECEIVER_NAKS_FAILED_DATA_RETRIES_EXCEEDED],
+						stats[PGM_PC_RECEIVER_NAK_FAILURES_DELIVERED],
+						stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_SUPPRESSED],
+						stats[PGM_PC_RECEIVER_NAK_ERRORS],
 						outstanding_naks,
 						last_activity,
 						window->min_fill_time,
-						peer->cumulative_stats[PGM_PC_RECEIVER_NAK_SVC_TIME_MEAN],
+						stats[PGM_PC_RECEIVER_NAK_SVC_TIME_MEAN],
 						window->max_fill_time,
 						peer->min_fail_time,
-						peer->cumulative_stats[PGM_PC_RECEIVER_NAK_FAIL_TIME_MEAN],
+						stats[PGM_PC_RECEIVER_NAK_FAIL_TIME_MEAN],
 						peer->max_fail_time,
 						window->min_nak_transmit_count,
-						peer->cumulative_stats[PGM_PC_RECEIVER_TRANSMIT_MEAN],
+						stats[PGM_PC_RECEIVER_TRANSMIT_MEAN],
 						window->max_nak_transmit_count);
 	http_finalize_response (connection, response);
 	return 0;
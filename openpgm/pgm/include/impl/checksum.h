@@ -64,11 +64,22 @@ static inline uint32_t add32_with_carry (uint32_t a, uint32_t b)
 static inline uint32_t add32_with_carry (uint32_t a, uint32_t b)
 {
 	a += b;
-	a  = (a >> 16) + (a & 0xffff);
-	return a;
+	return a + (a < b);			/* end-around carry */
 }
 #endif
 
+/* incremental update of a folded checksum for one 16 or 32-bit field at an even
+ * offset changed from m to m', RFC 1624 eqn. 3: HC' = ~(~HC + ~m + m')
+ */
+
+static inline uint16_t pgm_csum_replace (const uint16_t csum, const uint32_t from, const uint32_t to)
+{
+	uint32_t sum = (0xffff == csum) ? csum : (uint16_t)~csum;
+	sum = add32_with_carry (sum, ~from);
+	sum = add32_with_carry (sum, to);
+	return pgm_csum_fold (sum);
+}
+
 #	define pgm_csum_partial            pgm_compat_csum_partial
 #	define pgm_csum_partial_copy       pgm_compat_csum_partial_copy
 
@@ -45,6 +45,7 @@ struct pgm_cpu_t {
 	bool		has_sse42;
 	bool		has_avx;
 	bool		has_avx2;
+	bool		has_gfni;
 };
 
 PGM_GNUC_INTERNAL void pgm_cpuid (pgm_cpu_t*);
@@ -0,0 +1,52 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * In-kernel packet filter for receive sockets.
+ *
+ * Copyright (c) 2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#	pragma once
+#endif
+#ifndef __PGM_IMPL_FILTER_H__
+#define __PGM_IMPL_FILTER_H__
+
+#include <impl/framework.h>
+
+PGM_BEGIN_DECLS
+
+/* One classic BPF instruction, layout matches struct sock_filter and struct bpf_insn.
+ */
+
+struct pgm_filter_insn_t {
+	uint16_t			code;
+	uint8_t				jt;		/* jump offset if true */
+	uint8_t				jf;		/* jump offset if false */
+	uint32_t			k;
+};
+
+/* port checks and returns, optional TSI, then per group and per blocked source
+ * address matching of up to IPv6 length.
+ */
+#define PGM_FILTER_MAX_INSNS	(32 + (2 * IP_MAX_MEMBERSHIPS * 18))
+
+PGM_GNUC_INTERNAL unsigned pgm_filter_compile (const pgm_sock_t*const restrict, struct pgm_filter_insn_t*restrict, const unsigned) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL bool pgm_filter_update (pgm_sock_t*const);
+
+PGM_END_DECLS
+
+#endif /* __PGM_IMPL_FILTER_H__ */
@@ -55,6 +55,7 @@
 #include <impl/getnodeaddr.h>
 #include <impl/getprotobyname.h>
 #include <impl/hashtable.h>
+#include <impl/hdr_histogram.h>
 #include <impl/histogram.h>
 #include <impl/indextoaddr.h>
 #include <impl/indextoname.h>
@@ -71,15 +72,20 @@
 #include <impl/rand.h>
 #include <impl/rate_control.h>
 #include <impl/reed_solomon.h>
+#include <impl/ring.h>
 #include <impl/security.h>
+#include <impl/skbuff.h>
 #include <impl/slist.h>
 #include <impl/sn.h>
 #include <impl/sockaddr.h>
+#include <impl/stats.h>
 #include <impl/string.h>
 #include <impl/thread.h>
 #include <impl/time.h>
 #include <impl/tsi.h>
+#include <impl/tsitable.h>
 #include <impl/wsastrerror.h>
+#include <impl/zerocopy.h>
 
 #undef __PGM_IMPL_FRAMEWORK_H_INSIDE__
 
@@ -0,0 +1,96 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * High dynamic range latency histograms.
+ *
+ * Copyright (c) 2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#if !defined (__PGM_IMPL_FRAMEWORK_H_INSIDE__) && !defined (PGM_COMPILATION)
+#	error "Only <framework.h> can be included directly."
+#endif
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#	pragma once
+#endif
+#ifndef __PGM_IMPL_HDR_HISTOGRAM_H__
+#define __PGM_IMPL_HDR_HISTOGRAM_H__
+
+#include <pgm/types.h>
+#include <impl/string.h>
+
+PGM_BEGIN_DECLS
+
+/* Nanosecond samples are counted in buckets of log-linear layout: each power
+ * of two range is split into PGM_HDR_SUB_BUCKETS equal sub-buckets, values
+ * below PGM_HDR_SUB_BUCKETS are exact and larger values carry at most 1/32
+ * relative error.  Values beyond PGM_HDR_MAX_VALUE (~18 minutes) saturate.
+ */
+
+#define PGM_HDR_SUB_BITS	5
+#define PGM_HDR_SUB_BUCKETS	(1 << PGM_HDR_SUB_BITS)
+#define PGM_HDR_MAX_BITS	40
+#define PGM_HDR_MAX_VALUE	((UINT64_C(1) << PGM_HDR_MAX_BITS) - 1)
+#define PGM_HDR_BUCKETS		((PGM_HDR_MAX_BITS - PGM_HDR_SUB_BITS + 1) * PGM_HDR_SUB_BUCKETS)
+
+/* recording threads are spread across shards to keep them off each others
+ * cache lines, updates are atomic so threads sharing a shard stay exact.
+ */
+#define PGM_HDR_SHARDS		8
+
+/* hot path events */
+enum {
+	PGM_HDR_SEND_CALL = 0,		/* Tx.SendCall: successful pgm_send*() call */
+	PGM_HDR_RDATA_DWELL,		/* Tx.RdataDwell: NAK receipt to RDATA */
+	PGM_HDR_DELIVER,		/* Rx.DeliverLatency: packet arrival to application */
+	PGM_HDR_REPAIR_TIME,		/* Rx.RepairTime: loss detection to repair */
+	PGM_HDR_TIMER_LATENESS,		/* Timer.Lateness: expiration to dispatch */
+	PGM_HDR_MAX
+};
+
+/* merged shards of one histogram */
+struct pgm_hdr_snapshot_t {
+	uint64_t	counts[ PGM_HDR_BUCKETS ];
+	uint64_t	total_count;
+	uint64_t	sum;
+};
+
+typedef struct pgm_hdr_snapshot_t pgm_hdr_snapshot_t;
+
+#ifdef USE_HISTOGRAMS
+#	define PGM_HDR_START(start)		const uint64_t start = pgm_hdr_now()
+#	define PGM_HDR_RECORD(id, nsecs)	pgm_hdr_record ((id), (nsecs))
+#	define PGM_HDR_RECORD_SINCE(id, start)	pgm_hdr_record ((id), pgm_hdr_now() - (start))
+#else
+#	define PGM_HDR_START(start)
+#	define PGM_HDR_RECORD(id, nsecs)		do { } while (0)
+#	define PGM_HDR_RECORD_SINCE(id, start)	do { } while (0)
+#endif /* USE_HISTOGRAMS */
+
+PGM_GNUC_INTERNAL uint64_t pgm_hdr_now (void);
+PGM_GNUC_INTERNAL void pgm_hdr_record (const unsigned, const uint64_t);
+PGM_GNUC_INTERNAL void pgm_hdr_snapshot (const unsigned, pgm_hdr_snapshot_t*);
+PGM_GNUC_INTERNAL void pgm_hdr_merge (pgm_hdr_snapshot_t*restrict, const pgm_hdr_snapshot_t*restrict);
+PGM_GNUC_INTERNAL uint64_t pgm_hdr_percentile (const pgm_hdr_snapshot_t*, const double) PGM_GNUC_PURE;
+PGM_GNUC_INTERNAL uint64_t pgm_hdr_max (const pgm_hdr_snapshot_t*) PGM_GNUC_PURE;
+PGM_GNUC_INTERNAL const char* pgm_hdr_name (const unsigned) PGM_GNUC_PURE;
+PGM_GNUC_INTERNAL void pgm_hdr_write_html_all (pgm_string_t*);
+
+PGM_END_DECLS
+
+#endif /* __PGM_IMPL_HDR_HISTOGRAM_H__ */
+
+/* eof */
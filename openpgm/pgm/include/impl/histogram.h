@@ -101,10 +101,22 @@ typedef struct pgm_histogram_t pgm_histogram_t;
 		pgm_histogram_add (&counter, (sample)); \
 	} while (0)
 
+/* sub-millisecond times, 1μs to 1s */
+#	define PGM_HISTOGRAM_USECS(name, sample) do { \
+		PGM_HISTOGRAM_DEFINE(name, 1, 1000000, 50); \
+		if (!counter.is_registered) { \
+			memset (counts, 0, sizeof(counts)); \
+			memset (ranges, 0, sizeof(ranges)); \
+			pgm_histogram_init (&counter); \
+		} \
+		pgm_histogram_add (&counter, (int)MIN(pgm_to_usecs (sample), INT_MAX)); \
+	} while (0)
+
 #else
 
 #	define PGM_HISTOGRAM_TIMES(name, sample)
 #	define PGM_HISTOGRAM_COUNTS(name, sample)
+#	define PGM_HISTOGRAM_USECS(name, sample)
 
 #endif /* USE_HISTOGRAMS */
 
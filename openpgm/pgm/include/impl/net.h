@@ -32,7 +32,11 @@
 
 PGM_BEGIN_DECLS
 
+struct pgm_send_burst_t;
+
 PGM_GNUC_INTERNAL ssize_t pgm_sendto_hops (pgm_sock_t*restrict, bool, pgm_rate_t*restrict, bool, int, const void*restrict, size_t, const struct sockaddr*restrict, socklen_t);
+PGM_GNUC_INTERNAL ssize_t pgm_sendto_skb (pgm_sock_t*restrict, bool, pgm_rate_t*restrict, struct pgm_sk_buff_t*restrict, const struct sockaddr*restrict, socklen_t);
+PGM_GNUC_INTERNAL int pgm_sendto_burst (pgm_sock_t*restrict, bool, pgm_rate_t*restrict, bool, struct pgm_send_burst_t*restrict, const struct sockaddr*restrict, socklen_t);
 PGM_GNUC_INTERNAL int pgm_set_nonblocking (SOCKET fd[2]);
 
 static inline
@@ -20,6 +20,9 @@
 
 int(*priv_sendto)(SOCKET, const char*, int, int, const struct sockaddr*, int);
 int(*priv_recvfrom)(SOCKET, char*, int, int, const struct sockaddr*, int);
+#ifdef HAVE_SENDMMSG
+int(*priv_sendmmsg)(SOCKET, struct mmsghdr*, unsigned, int);
+#endif
 
 static int empty_sendto(SOCKET s, const char * buf, int len, int flags, const struct sockaddr *to, int tolen)
 {
@@ -31,6 +34,20 @@ static int empty_recvfrom(SOCKET s, char * buf, int len, int flags, struct socka
     return len;
 }
 
+#ifdef HAVE_SENDMMSG
+static int empty_sendmmsg(SOCKET s, struct mmsghdr * msgvec, unsigned vlen, int flags)
+{
+    for (unsigned i = 0; i < vlen; i++)
+        msgvec[i].msg_len = msgvec[i].msg_hdr.msg_iov[0].iov_len;
+    return vlen;
+}
+
+static int default_sendmmsg(SOCKET s, struct mmsghdr * msgvec, unsigned vlen, int flags)
+{
+    return sendmmsg(s, msgvec, vlen, flags);
+}
+#endif
+
 #ifdef _WIN32
     int wsa_sendto(SOCKET s, const char * buf, int len, int flags, const struct sockaddr *to, int tolen)
     {
@@ -87,6 +104,9 @@ void pgm_send_recv_init()
 {
     priv_sendto = &default_sendto;
     priv_recvfrom = &default_recvfrom;
+#ifdef HAVE_SENDMMSG
+    priv_sendmmsg = &default_sendmmsg;
+#endif
 
     char* pgm_send;
     size_t envlen;
@@ -109,6 +129,9 @@ void pgm_send_recv_init()
         {
             priv_sendto = &empty_sendto;
             priv_recvfrom = &empty_recvfrom;
+#ifdef HAVE_SENDMMSG
+            priv_sendmmsg = &empty_sendmmsg;
+#endif
             pgm_trace(PGM_LOG_LEVEL_TRACE, "PGM_SEND: NONE");
             break;
         }
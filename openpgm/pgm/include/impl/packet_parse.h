@@ -34,6 +34,7 @@ PGM_BEGIN_DECLS
 
 PGM_GNUC_INTERNAL bool pgm_parse_raw (struct pgm_sk_buff_t*const restrict, struct sockaddr*const restrict, pgm_error_t**restrict);
 PGM_GNUC_INTERNAL bool pgm_parse_udp_encap (struct pgm_sk_buff_t*const restrict, pgm_error_t**restrict);
+PGM_GNUC_INTERNAL bool pgm_verify_checksum (struct pgm_sk_buff_t*const restrict, void*restrict, const uint16_t);
 PGM_GNUC_INTERNAL bool pgm_verify_spm (const struct pgm_sk_buff_t* const);
 PGM_GNUC_INTERNAL bool pgm_verify_spmr (const struct pgm_sk_buff_t* const);
 PGM_GNUC_INTERNAL bool pgm_verify_nak (const struct pgm_sk_buff_t* const);
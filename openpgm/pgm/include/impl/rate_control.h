@@ -33,21 +33,25 @@ typedef struct pgm_rate_t pgm_rate_t;
 
 #include <pgm/types.h>
 #include <pgm/time.h>
+#include <pgm/atomic.h>
 #include <impl/thread.h>
 
 PGM_BEGIN_DECLS
 
-struct pgm_rate_t {
-	ssize_t		rate_per_sec;
-	ssize_t		rate_per_msec;
-	size_t		iphdr_len;
+/* generic cell rate algorithm: the token count and refill timestamp are packed
+ * into a single word, the nanosecond time the bucket last ran dry.  tokens
+ * available at time t are min(burst, t - empty_at) nanoseconds of transmission.
+ */
 
-	ssize_t		rate_limit;		/* signed for math */
-	pgm_time_t	last_rate_check;
-	pgm_spinlock_t	spinlock;
+struct pgm_rate_t {
+	ssize_t			rate_per_sec;
+	size_t			iphdr_len;
+	uint64_t		burst;			/* bucket depth in ns */
+	volatile uint64_t	empty_at;		/* CAS only */
 };
 
 PGM_GNUC_INTERNAL void pgm_rate_create (pgm_rate_t*, const ssize_t, const size_t, const uint16_t);
+PGM_GNUC_INTERNAL void pgm_rate_set_pacing (pgm_rate_t*, const uint16_t);
 PGM_GNUC_INTERNAL void pgm_rate_destroy (pgm_rate_t*);
 PGM_GNUC_INTERNAL bool pgm_rate_check2 (pgm_rate_t*, pgm_rate_t*, const size_t, const bool);
 PGM_GNUC_INTERNAL bool pgm_rate_check (pgm_rate_t*, const size_t, const bool);
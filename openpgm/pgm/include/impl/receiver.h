@@ -79,6 +79,7 @@ enum {
 	PGM_PC_RECEIVER_TRANSMIT_MEAN,
 /*	PGM_PC_RECEIVER_TRANSMIT_MAX, */
 	PGM_PC_RECEIVER_ACKS_SENT, 
+	PGM_PC_RECEIVER_CKSUM_ERRORS,			/* deferred verification only */
 
 /* marker */
 	PGM_PC_RECEIVER_MAX
@@ -106,6 +107,8 @@ struct pgm_peer_t {
 
 	uint32_t			spm_sqn;
 	pgm_time_t			expiry;
+	pgm_time_t			next_expiry;			/* earliest of all state timers */
+	uint32_t			timer_index;			/* into pgm_sock_t::peers_timer */
 
 	pgm_time_t			ack_rb_expiry;			/* 0 = no ACK pending */
 	pgm_time_t			ack_last_tstamp;		/* in source time reference */
@@ -118,18 +121,29 @@ struct pgm_peer_t {
 	unsigned			last_commit;
 	uint32_t			lost_count;
 	uint32_t			last_cumulative_losses;
-	volatile uint32_t		cumulative_stats[PGM_PC_RECEIVER_MAX];
-	uint32_t			snap_stats[PGM_PC_RECEIVER_MAX];
+	volatile uint64_t		cumulative_stats[PGM_PC_RECEIVER_MAX];	/* receive path only */
 
 	uint32_t			min_fail_time;
 	uint32_t			max_fail_time;
 };
 
+/* all counters at one instant */
+static inline
+void
+pgm_peer_stats_snapshot (
+	const pgm_peer_t*const	peer,
+	uint64_t*		snapshot	/* [PGM_PC_RECEIVER_MAX] */
+	)
+{
+	pgm_stats_snapshot (peer->cumulative_stats, 0, 1, PGM_PC_RECEIVER_MAX, snapshot);
+}
+
 PGM_GNUC_INTERNAL pgm_peer_t* pgm_new_peer (pgm_sock_t*const restrict, const pgm_tsi_t*const restrict, const struct sockaddr*const restrict, const socklen_t, const struct sockaddr*const restrict, const socklen_t, const pgm_time_t);
 PGM_GNUC_INTERNAL void pgm_peer_unref (pgm_peer_t*);
 PGM_GNUC_INTERNAL int pgm_flush_peers_pending (pgm_sock_t*const restrict, struct pgm_msgv_t**restrict, const struct pgm_msgv_t*const, size_t*const restrict, unsigned*const restrict);
 PGM_GNUC_INTERNAL bool pgm_peer_has_pending (pgm_peer_t*const) PGM_GNUC_WARN_UNUSED_RESULT;
 PGM_GNUC_INTERNAL void pgm_peer_set_pending (pgm_sock_t*const restrict, pgm_peer_t*const restrict);
+PGM_GNUC_INTERNAL void pgm_peer_set_corrupt (pgm_sock_t*const restrict, pgm_peer_t*const restrict, const unsigned);
 PGM_GNUC_INTERNAL bool pgm_check_peer_state (pgm_sock_t*const, const pgm_time_t);
 PGM_GNUC_INTERNAL void pgm_set_reset_error (pgm_sock_t*const restrict, pgm_peer_t*const restrict, struct pgm_msgv_t*const restrict);
 PGM_GNUC_INTERNAL pgm_time_t pgm_min_receiver_expiry (pgm_sock_t*, pgm_time_t) PGM_GNUC_WARN_UNUSED_RESULT;
@@ -0,0 +1,69 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * Bounded single-producer single-consumer ring of received APDUs.
+ *
+ * Copyright (c) 2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#if !defined (__PGM_IMPL_FRAMEWORK_H_INSIDE__) && !defined (PGM_COMPILATION)
+#	error "Only <framework.h> can be included directly."
+#endif
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#	pragma once
+#endif
+#ifndef __PGM_IMPL_RING_H__
+#define __PGM_IMPL_RING_H__
+
+typedef struct pgm_ring_t pgm_ring_t;
+
+#include <pgm/types.h>
+#include <pgm/msgv.h>
+
+PGM_BEGIN_DECLS
+
+#define PGM_RING_CACHELINE	64
+
+/* Power-of-two ring of pgm_msgv_t slots between one producer, the network thread,
+ * and one consumer, the application reader.
+ *
+ * Positions are free running 32-bit counters, each written by one side only and
+ * published with a fully fenced atomic add, so no locks are required.  Slots are
+ * filled and drained in place as contiguous spans up to the wrap point.  A slot
+ * with msgv_len of zero carries a reset notification in msgv_skb[0].
+ */
+
+struct pgm_ring_t {
+	volatile uint32_t		head;		/* producer, next slot written */
+	char				pad0[PGM_RING_CACHELINE - sizeof(uint32_t)];
+	volatile uint32_t		tail;		/* consumer, next slot read */
+	volatile uint32_t		is_full;	/* producer waiting for space */
+	char				pad1[PGM_RING_CACHELINE - (2 * sizeof(uint32_t))];
+	uint32_t			mask;		/* capacity - 1 */
+	struct pgm_msgv_t*		msgv;
+};
+
+PGM_GNUC_INTERNAL pgm_ring_t* pgm_ring_create (const uint32_t) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL void pgm_ring_destroy (pgm_ring_t*const);
+PGM_GNUC_INTERNAL struct pgm_msgv_t* pgm_ring_reserve (pgm_ring_t*const restrict, uint32_t*const restrict);
+PGM_GNUC_INTERNAL bool pgm_ring_commit (pgm_ring_t*const, const uint32_t);
+PGM_GNUC_INTERNAL struct pgm_msgv_t* pgm_ring_peek (pgm_ring_t*const restrict, uint32_t*const restrict);
+PGM_GNUC_INTERNAL bool pgm_ring_release (pgm_ring_t*const, const uint32_t);
+
+PGM_END_DECLS
+
+#endif /* __PGM_IMPL_RING_H__ */
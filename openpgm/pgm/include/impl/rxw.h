@@ -25,7 +25,6 @@
 #ifndef __PGM_IMPL_RXW_H__
 #define __PGM_IMPL_RXW_H__
 
-typedef struct pgm_rxw_state_t pgm_rxw_state_t;
 typedef struct pgm_rxw_t pgm_rxw_t;
 
 #include <impl/framework.h>
@@ -58,24 +57,10 @@ enum
 	PGM_RXW_UNKNOWN
 };
 
-/* must be smaller than PGM skbuff control buffer */
-struct pgm_rxw_state_t {
-	pgm_time_t	timer_expiry;
-        int		pkt_state;
-
-	uint8_t		nak_transmit_count;	/* 8-bit for size constraints */
-        uint8_t		ncf_retry_count;
-        uint8_t		data_retry_count;
-
-/* only valid on tg_sqn::pkt_sqn = 0 */
-	unsigned	is_contiguous:1;	/* transmission group */
-};
-
 struct pgm_rxw_t {
 	const pgm_tsi_t*	tsi;
 
         pgm_queue_t		ack_backoff_queue;
-        pgm_queue_t		nak_backoff_queue;
         pgm_queue_t		wait_ncf_queue;
         pgm_queue_t		wait_data_queue;
 /* window context counters */
@@ -110,11 +95,40 @@ struct pgm_rxw_t {
 	uint32_t		msgs_delivered;
 
 	size_t			size;			/* in bytes */
-	unsigned		alloc;			/* in pkts */
-/* C90 and older */
-	struct pgm_sk_buff_t*   pdata[1];
+	unsigned		alloc;			/* window limit in pkts */
+	uint32_t		mask;			/* slot count - 1, power of 2, grows with occupancy */
+	pgm_skb_pool_t*		pool;			/* placeholder & repair buffers, maybe NULL */
+
+/* per-sequence state in parallel arrays indexed by pgm_rxw_index() so that
+ * window scans do not touch the skbs.
+ */
+	pgm_time_t*		timer_expiry;
+	uint8_t*		pkt_state;
+	uint8_t*		nak_transmit_count;
+	uint8_t*		ncf_retry_count;
+	uint8_t*		data_retry_count;
+	uint8_t*		is_contiguous;		/* only valid on tg_sqn::pkt_sqn = 0 */
+	pgm_time_t*		tstamp;			/* loss detection time of placeholders */
+	pgm_list_t*		link;			/* WAIT-NCF and WAIT-DATA queue entries */
+	struct pgm_sk_buff_t**	pdata;
+
+/* sequences in BACK-OFF state, one bit per slot.  placeholders are only
+ * slot state, no skb is allocated until repair data arrives.
+ */
+	uint32_t*		backoff_bitmap;
+	uint32_t		nak_backoff_count;
+	pgm_time_t		nak_backoff_expiry;	/* lower bound of BACK-OFF timers */
 };
 
+/* slot arrays start at PGM_RXW_MIN_SLOTS and double when the window is
+ * full, up to the window limit.  they halve when occupancy falls to a
+ * quarter.
+ */
+#define PGM_RXW_MIN_SLOTS	32
+
+/* bytes of slot state per sequence, excluding the NAK backoff bitmap */
+#define PGM_RXW_SLOT_SIZE	(2 * sizeof(pgm_time_t) + sizeof(struct pgm_sk_buff_t*) + sizeof(pgm_list_t) + 5 * sizeof(uint8_t))
+
 
 PGM_GNUC_INTERNAL pgm_rxw_t* pgm_rxw_create (const pgm_tsi_t*const, const uint16_t, const unsigned, const unsigned, const ssize_t, const uint32_t) PGM_GNUC_WARN_UNUSED_RESULT;
 PGM_GNUC_INTERNAL void pgm_rxw_destroy (pgm_rxw_t*const);
@@ -128,7 +142,8 @@ PGM_GNUC_INTERNAL unsigned pgm_rxw_update (pgm_rxw_t*const, const uint32_t, cons
 PGM_GNUC_INTERNAL void pgm_rxw_update_fec (pgm_rxw_t*const, const uint8_t);
 PGM_GNUC_INTERNAL int pgm_rxw_confirm (pgm_rxw_t*const, const uint32_t, const pgm_time_t, const pgm_time_t, const pgm_time_t) PGM_GNUC_WARN_UNUSED_RESULT;
 PGM_GNUC_INTERNAL void pgm_rxw_lost (pgm_rxw_t*const, const uint32_t);
-PGM_GNUC_INTERNAL void pgm_rxw_state (pgm_rxw_t*const restrict, struct pgm_sk_buff_t*const restrict, const int);
+PGM_GNUC_INTERNAL void pgm_rxw_state (pgm_rxw_t*const, const uint32_t, const int);
+PGM_GNUC_INTERNAL bool pgm_rxw_find_backoff (const pgm_rxw_t*const restrict, const uint32_t, uint32_t*restrict) PGM_GNUC_WARN_UNUSED_RESULT;
 PGM_GNUC_INTERNAL struct pgm_sk_buff_t* pgm_rxw_peek (pgm_rxw_t*const, const uint32_t) PGM_GNUC_WARN_UNUSED_RESULT;
 PGM_GNUC_INTERNAL const char* pgm_pkt_state_string (const int) PGM_GNUC_WARN_UNUSED_RESULT;
 PGM_GNUC_INTERNAL const char* pgm_rxw_returns_string (const int) PGM_GNUC_WARN_UNUSED_RESULT;
@@ -142,6 +157,10 @@ static inline bool pgm_rxw_is_empty (const pgm_rxw_t*const) PGM_GNUC_WARN_UNUSED
 static inline bool pgm_rxw_is_full (const pgm_rxw_t*const) PGM_GNUC_WARN_UNUSED_RESULT;
 static inline uint32_t pgm_rxw_lead (const pgm_rxw_t*const) PGM_GNUC_WARN_UNUSED_RESULT;
 static inline uint32_t pgm_rxw_next_lead (const pgm_rxw_t*const) PGM_GNUC_WARN_UNUSED_RESULT;
+static inline uint_fast32_t pgm_rxw_index (const pgm_rxw_t*const, const uint32_t) PGM_GNUC_WARN_UNUSED_RESULT;
+static inline uint32_t pgm_rxw_link_sequence (const pgm_rxw_t*const, const pgm_list_t*const) PGM_GNUC_WARN_UNUSED_RESULT;
+static inline size_t pgm_rxw_reserved (const pgm_rxw_t*const) PGM_GNUC_WARN_UNUSED_RESULT;
+static inline size_t pgm_rxw_used (const pgm_rxw_t*const) PGM_GNUC_WARN_UNUSED_RESULT;
 
 static inline
 unsigned
@@ -213,6 +232,61 @@ pgm_rxw_next_lead (
 	return (uint32_t)(pgm_rxw_lead (window) + 1);
 }
 
+/* slot of sequence in the skb and state arrays */
+
+static inline
+uint_fast32_t
+pgm_rxw_index (
+	const pgm_rxw_t* const window,
+	const uint32_t	       sequence
+	)
+{
+	pgm_assert (NULL != window);
+	return sequence & window->mask;
+}
+
+/* sequence of a WAIT-NCF or WAIT-DATA queue entry */
+
+static inline
+uint32_t
+pgm_rxw_link_sequence (
+	const pgm_rxw_t*  const window,
+	const pgm_list_t* const link
+	)
+{
+	pgm_assert (NULL != window);
+	pgm_assert (NULL != link);
+	const uint_fast32_t index_ = link - window->link;
+	const uint_fast32_t trail_index = pgm_rxw_index (window, window->trail);
+	pgm_assert_cmpuint (index_, <=, window->mask);
+	return window->trail + (uint32_t)((index_ - trail_index) & window->mask);
+}
+
+/* slot memory allocated for the window */
+
+static inline
+size_t
+pgm_rxw_reserved (
+	const pgm_rxw_t* const window
+	)
+{
+	pgm_assert (NULL != window);
+	const size_t slots = (size_t)window->mask + 1;
+	return (slots * PGM_RXW_SLOT_SIZE) + (((slots + 31) / 32) * sizeof(uint32_t));
+}
+
+/* slot memory holding sequences between trail and lead */
+
+static inline
+size_t
+pgm_rxw_used (
+	const pgm_rxw_t* const window
+	)
+{
+	pgm_assert (NULL != window);
+	return pgm_rxw_length (window) * PGM_RXW_SLOT_SIZE;
+}
+
 PGM_END_DECLS
 
 #endif /* __PGM_IMPL_RXW_H__ */
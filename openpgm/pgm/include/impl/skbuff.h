@@ -0,0 +1,102 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * PGM socket buffer pools.
+ *
+ * Copyright (c) 2006-2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#if !defined (__PGM_IMPL_FRAMEWORK_H_INSIDE__) && !defined (PGM_COMPILATION)
+#	error "Only <framework.h> can be included directly."
+#endif
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#	pragma once
+#endif
+#ifndef __PGM_IMPL_SKBUFF_H__
+#define __PGM_IMPL_SKBUFF_H__
+
+typedef struct pgm_skb_pool_t pgm_skb_pool_t;
+
+#include <pgm/types.h>
+#include <pgm/skbuff.h>
+
+PGM_BEGIN_DECLS
+
+#define PGM_SKB_POOL_NIL	UINT32_MAX
+
+/* Fixed size buffer pool with a single consumer and any number of producers.
+ *
+ * Released buffers are pushed with compare-and-swap onto a shared free list
+ * indexed by slot number, the consumer takes the entire shared list with one
+ * swap into a private cache and pops without atomics.  As only the one
+ * consumer ever removes entries the free list is not subject to ABA.
+ */
+
+struct pgm_skb_pool_t {
+	volatile uint32_t		ref_count;	/* owner plus outstanding buffers */
+	volatile uint32_t		free_list;	/* shared, released slots */
+	uint32_t			cache;		/* consumer private, free slots */
+	uint32_t			capacity;
+	uint16_t			tpdu_size;
+
+/* statistics */
+	volatile uint32_t		hits;		/* recycled */
+	volatile uint32_t		misses;		/* fallback to heap */
+	volatile uint32_t		high_water;	/* populated slots */
+
+	uint32_t*			next;
+	struct pgm_sk_buff_t**		slot;
+};
+
+/* A pooled buffer carries its pool link between the public header and the
+ * data, the public pgm_sk_buff_t layout is unchanged and a pooled buffer is
+ * identified by pgm_sk_buff_t::head not immediately following the header.
+ * Buffers are returned to their pool by pgm_free_skb().
+ */
+
+struct pgm_skb_pool_link_t {
+	pgm_skb_pool_t*			pool;
+	uint32_t			index;
+};
+
+#define PGM_SKB_POOL_LINK_SIZE	((sizeof(struct pgm_skb_pool_link_t) + 7) & ~(size_t)7)
+
+PGM_GNUC_INTERNAL pgm_skb_pool_t* pgm_skb_pool_create (const uint32_t, const uint16_t) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL void pgm_skb_pool_destroy (pgm_skb_pool_t*const);
+PGM_GNUC_INTERNAL struct pgm_sk_buff_t* pgm_skb_pool_alloc (pgm_skb_pool_t*const, const uint16_t) PGM_GNUC_WARN_UNUSED_RESULT;
+
+static inline
+bool
+pgm_skb_is_pooled (
+	const struct pgm_sk_buff_t*const skb
+	)
+{
+	return skb->head != (const void*)(skb + 1);
+}
+
+static inline
+struct pgm_skb_pool_link_t*
+pgm_skb_pool_link (
+	struct pgm_sk_buff_t*const skb
+	)
+{
+	return (struct pgm_skb_pool_link_t*)(skb + 1);
+}
+
+PGM_END_DECLS
+
+#endif /* __PGM_IMPL_SKBUFF_H__ */
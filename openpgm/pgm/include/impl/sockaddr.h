@@ -140,6 +140,10 @@ PGM_GNUC_INTERNAL int pgm_sockaddr_cmp (const struct sockaddr*restrict sa1, cons
 PGM_GNUC_INTERNAL int pgm_sockaddr_hdrincl (const SOCKET s, const sa_family_t sa_family, const bool v);
 PGM_GNUC_INTERNAL int pgm_sockaddr_pktinfo (const SOCKET s, const sa_family_t sa_family, const bool v);
 PGM_GNUC_INTERNAL int pgm_sockaddr_router_alert (const SOCKET s, const sa_family_t sa_family, const bool v);
+PGM_GNUC_INTERNAL int pgm_sockaddr_timestamp (const SOCKET s, const bool v);
+PGM_GNUC_INTERNAL int pgm_sockaddr_zerocopy (const SOCKET s, const bool v);
+PGM_GNUC_INTERNAL int pgm_sockaddr_filter (const SOCKET s, void* insns, const unsigned len);
+PGM_GNUC_INTERNAL int pgm_sockaddr_pacing_rate (const SOCKET s, const ssize_t rate);
 PGM_GNUC_INTERNAL int pgm_sockaddr_tos (const SOCKET s, const sa_family_t sa_family, const int tos);
 PGM_GNUC_INTERNAL int pgm_sockaddr_join_group (const SOCKET s, const sa_family_t sa_family, const struct group_req* gr);
 PGM_GNUC_INTERNAL int pgm_sockaddr_leave_group (const SOCKET s, const sa_family_t sa_family, const struct group_req* gr);
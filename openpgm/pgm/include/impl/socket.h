@@ -30,6 +30,7 @@ struct pgm_sock_t;
 #include <impl/framework.h>
 #include <impl/txw.h>
 #include <impl/source.h>
+#include <impl/sqn_list.h>
 
 PGM_BEGIN_DECLS
 
@@ -37,6 +38,16 @@ PGM_BEGIN_DECLS
 #	define IP_MAX_MEMBERSHIPS	20
 #endif
 
+/* recently active sources checked before the peer table */
+#define PGM_PEERS_LRU_LEN	4
+
+/* NAK sequences awaiting an aggregated NCF with the NLAs of the NAKs */
+struct pgm_ncf_pending_t {
+	struct sockaddr_storage		src_nla;
+	struct sockaddr_storage		grp_nla;
+	struct pgm_sqn_list_t		sqn_list;
+};
+
 struct pgm_sock_t {
 	sa_family_t			family;				/* communications domain */
 	int				socket_type;
@@ -65,6 +76,8 @@ struct pgm_sock_t {
 	bool				can_recv_data;			/* send-only */
 	bool				is_edge_triggered_recv;
 	bool				is_nonblocking;
+	bool				use_deferred_checksum;		/* verify data on copy out */
+	bool				use_rx_timestamp;		/* kernel receive timestamps */
 
 	struct group_source_req		send_gsr;			/* multicast */
 	struct sockaddr_storage		send_addr;			/* unicast nla */
@@ -72,7 +85,12 @@ struct pgm_sock_t {
 	SOCKET				send_with_router_alert_sock;
 	struct group_source_req 	recv_gsr[IP_MAX_MEMBERSHIPS];	/* sa_family = 0 terminated */
 	unsigned			recv_gsr_len;
+	struct group_source_req		block_gsr[IP_MAX_MEMBERSHIPS];	/* PGM_BLOCK_SOURCE */
+	unsigned			block_gsr_len;
 	SOCKET				recv_sock;
+	bool				use_kernel_filter;		/* SO_ATTACH_FILTER on recv_sock */
+	bool				use_filter_tsi;
+	pgm_tsi_t			filter_tsi;			/* single source */
 
 	size_t				max_apdu;
 	uint16_t			max_tpdu;
@@ -86,6 +104,7 @@ struct pgm_sock_t {
 	ssize_t				txw_max_rte, rxw_max_rte;
 	ssize_t				odata_max_rte;
 	ssize_t				rdata_max_rte;
+	int				txw_pacing;		/* PGM_PACING_* */
 	size_t				sndbuf, rcvbuf;		    /* setsockopt (SO_SNDBUF/SO_RCVBUF) */
 
 	pgm_txw_t* restrict    		window;
@@ -122,8 +141,7 @@ struct pgm_sock_t {
 	pgm_notify_t			ack_notify;
 	pgm_notify_t			rdata_notify;
 
-	pgm_hash_t			last_hash_key;
-	void* restrict			last_hash_value;
+	struct pgm_peer_t*		peers_lru[PGM_PEERS_LRU_LEN]; /* most recent first */
 	unsigned			last_commit;
 	size_t				blocklen;		    /* length of buffer blocked */
 	bool				is_apdu_eagain;		    /* writer-lock on window_lock exists as send would block */
@@ -140,8 +158,19 @@ struct pgm_sock_t {
 		unsigned			vector_index;
 		size_t				vector_offset;
 		bool				is_rate_limited;
+		bool				is_burst;	/* packets queued on tx_burst */
+		pgm_time_t			tstamp;		/* one clock read per send call */
 	} pkt_dontwait_state;
 
+/* pre-built headers with the unfolded checksum of invariant fields, the
+ * type/options word and per-packet fields are zero in the checksum.
+ */
+	char				odata_template[sizeof(struct pgm_header) + sizeof(struct pgm_data)];
+	uint32_t			unfolded_odata_template;
+	char				spm_template[sizeof(struct pgm_header) + sizeof(struct pgm_spm6)];
+	uint16_t			spm_template_len;
+	uint32_t			unfolded_spm_template;
+
 	uint32_t			spm_sqn;
 	unsigned			spm_ambient_interval;	    /* microseconds */
 	unsigned* restrict		spm_heartbeat_interval;     /* zero terminated, zero lead-pad */
@@ -153,6 +182,9 @@ struct pgm_sock_t {
 	pgm_rand_t			rand_;			    /* for calculating nak_rb_ivl from nak_bo_ivl */
 	unsigned			nak_data_retries, nak_ncf_retries;
 	pgm_time_t			nak_bo_ivl, nak_rpt_ivl, nak_rdata_ivl;
+	pgm_time_t			ncf_ivl;		    /* NAK aggregation interval, 0 = disabled */
+	pgm_time_t			ncf_expiry;		    /* next aggregated NCF, 0 = none pending */
+	struct pgm_ncf_pending_t	ncf_pending[2];		    /* selective, parity */
 	pgm_time_t			next_heartbeat_spm, next_ambient_spm;
 
 	bool				use_proactive_parity;
@@ -163,26 +195,110 @@ struct pgm_sock_t {
 	uint8_t				rs_proactive_h;		    /* 0 <= proactive-h <= ( n - k ) */
 	uint8_t				tg_sqn_shift;
 	struct pgm_sk_buff_t* restrict	rx_buffer;
+	struct pgm_recv_batch_t* restrict rx_batch;		    /* recvmmsg() ring, NULL = disabled */
+	unsigned			rx_batch_len;		    /* datagrams per call */
+	pgm_skb_pool_t* restrict	rx_pool;		    /* receiver_mutex consumer */
+	pgm_skb_pool_t* restrict	tx_pool;		    /* source_mutex consumer */
+	struct pgm_send_burst_t* restrict tx_burst;		    /* sendmmsg() queue, NULL = disabled */
+	unsigned			tx_burst_len;		    /* datagrams per call */
+	struct pgm_send_burst_t* restrict rdata_burst;		    /* repair queue, timer thread, NULL = disabled */
+	pgm_zerocopy_t* restrict	zerocopy;		    /* MSG_ZEROCOPY completions, NULL = disabled */
+	unsigned			zerocopy_min;		    /* smallest zero-copy TPDU, 0 = disabled */
+	pgm_ring_t* restrict		rx_ring;		    /* network thread to application, NULL = disabled */
+	unsigned			rx_ring_len;		    /* APDU slots */
+	uint32_t			rx_ring_held;		    /* slots lent to application by last read */
+	pgm_notify_t			ring_notify;		    /* ring to application */
+	bool				has_rx_thread;
+	volatile uint32_t		rx_thread_status;	    /* PGM_IO_STATUS_NORMAL whilst running */
+	pgm_error_t*			rx_thread_error;
+#ifndef _WIN32
+	pthread_t			rx_thread;
+#else
+	HANDLE				rx_thread;
+#endif
 
 	pgm_rwlock_t			peers_lock;
-	pgm_hashtable_t* restrict	peers_hashtable;	    /* fast lookup */
+	pgm_tsitable_t*  restrict	peers_hashtable;	    /* fast lookup */
 	pgm_list_t*      restrict	peers_list;		    /* easy iteration */
 	pgm_slist_t*     restrict	peers_pending;		    /* rxw: have or lost data */
+	struct pgm_peer_t**		peers_timer;		    /* min-heap on next state expiry */
+	unsigned			peers_timer_len;
+	unsigned			peers_timer_size;
 	pgm_notify_t			pending_notify;		    /* timer to rx */
 	bool				is_pending_read;
 	pgm_time_t			next_poll;
 
-	uint32_t			cumulative_stats[PGM_PC_SOURCE_MAX];
-	uint32_t			snap_stats[PGM_PC_SOURCE_MAX];
-	pgm_time_t			snap_time;
+	volatile uint64_t		cumulative_stats[PGM_STATS_SHARDS][PGM_STATS_SHARD_LEN(PGM_PC_SOURCE_MAX)];
 };
 
+/* counters of one writer role, see <impl/stats.h> */
+#define pgm_sock_stats(sock,role)	(&(sock)->cumulative_stats[(role)][PGM_STATS_PAD])
+
+/* one counter summed over all roles */
+static inline
+uint64_t
+pgm_sock_stats_read (
+	const pgm_sock_t*const	sock,
+	const unsigned		counter
+	)
+{
+	uint64_t sum = 0;
+	for (unsigned i = 0; i < PGM_STATS_SHARDS; i++)
+		sum += pgm_atomic_read64 (&pgm_sock_stats (sock, i)[counter]);
+	return sum;
+}
+
+/* all counters at one instant */
+static inline
+void
+pgm_sock_stats_snapshot (
+	const pgm_sock_t*const	sock,
+	uint64_t*		snapshot	/* [PGM_PC_SOURCE_MAX] */
+	)
+{
+	pgm_stats_snapshot (pgm_sock_stats (sock, 0), PGM_STATS_SHARD_LEN(PGM_PC_SOURCE_MAX), PGM_STATS_SHARDS, PGM_PC_SOURCE_MAX, snapshot);
+}
+
+
+/* batched receive ring, slots are swapped with pgm_sock_t::rx_buffer as consumed */
+struct pgm_recv_batch_t {
+	unsigned			len;			    /* slots */
+	unsigned			head;			    /* next unread slot */
+	unsigned			count;			    /* slots filled by last call */
+	uint32_t			calls;			    /* fill accounting */
+	uint32_t			datagrams;
+	struct pgm_sk_buff_t**		skb;
+	struct sockaddr_storage*	src;
+	struct pgm_iovec*		iov;
+	char*				aux;			    /* per slot control buffers */
+	void*				msg;			    /* struct mmsghdr */
+};
+
+/* burst transmit queue of original data, slots hold a reference until sent */
+struct pgm_send_burst_t {
+	unsigned			len;			    /* slots */
+	unsigned			head;			    /* next unsent slot */
+	unsigned			count;			    /* slots queued */
+	uint32_t			calls;			    /* fill accounting */
+	uint32_t			datagrams;
+	struct pgm_sk_buff_t**		skb;
+	size_t*				sent;			    /* bytes per slot, 0 on error */
+	struct pgm_iovec*		iov;
+	void*				msg;			    /* struct mmsghdr */
+	struct sockaddr_storage		name;			    /* destination */
+};
 
 /* global variables */
 extern pgm_rwlock_t pgm_sock_list_lock;
 extern pgm_slist_t* pgm_sock_list;
 
 size_t pgm_pkt_offset (bool, sa_family_t);
+PGM_GNUC_INTERNAL struct pgm_recv_batch_t* pgm_recv_batch_create (const unsigned, pgm_skb_pool_t*const, const uint16_t) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL void pgm_recv_batch_destroy (struct pgm_recv_batch_t*);
+PGM_GNUC_INTERNAL bool pgm_recv_thread_create (pgm_sock_t*const restrict, pgm_error_t**restrict);
+PGM_GNUC_INTERNAL void pgm_recv_thread_join (pgm_sock_t*const);
+PGM_GNUC_INTERNAL struct pgm_send_burst_t* pgm_send_burst_create (const unsigned) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL void pgm_send_burst_destroy (struct pgm_send_burst_t*);
 
 PGM_END_DECLS
 
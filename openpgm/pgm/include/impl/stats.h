@@ -0,0 +1,112 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * 64-bit performance counters sharded by writer role.
+ *
+ * Copyright (c) 2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#if !defined (__PGM_IMPL_FRAMEWORK_H_INSIDE__) && !defined (PGM_COMPILATION)
+#	error "Only <framework.h> can be included directly."
+#endif
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#	pragma once
+#endif
+#ifndef __PGM_IMPL_STATS_H__
+#define __PGM_IMPL_STATS_H__
+
+#include <pgm/types.h>
+#include <pgm/atomic.h>
+
+PGM_BEGIN_DECLS
+
+/* Socket counters are split into one shard per writer role.  Roles serialised
+ * by a lock update their shard with a plain 64-bit add, the application
+ * shard may be written by any thread and uses a locked add.  Readers
+ * sum the shards with pgm_stats_snapshot().
+ */
+
+enum {
+	PGM_STATS_SEND = 0,		/* application send calls, source_mutex */
+	PGM_STATS_RECV,			/* receive path and timers, receiver_mutex */
+	PGM_STATS_APP,			/* any thread, e.g. application receive calls */
+	PGM_STATS_SHARDS
+};
+
+/* each shard is led by a cache line of padding so that writers of
+ * neighbouring shards do not share lines.
+ */
+#define PGM_STATS_CACHELINE	64
+#define PGM_STATS_PAD		(PGM_STATS_CACHELINE / sizeof(uint64_t))
+#define PGM_STATS_SHARD_LEN(n)	(PGM_STATS_PAD + (n))
+
+/* largest counter set that can be snapshot */
+#define PGM_STATS_MAX_LEN	64
+
+PGM_GNUC_INTERNAL void pgm_stats_snapshot (const volatile uint64_t*restrict, const size_t, const unsigned, const unsigned, uint64_t*restrict);
+
+/* counter update by the only writer of the shard.
+ */
+
+static inline
+void
+pgm_stats_add (
+	volatile uint64_t*	shard,
+	const unsigned		counter,
+	const uint64_t		val
+	)
+{
+	pgm_atomic_write64 (&shard[counter], shard[counter] + val);
+}
+
+static inline
+void
+pgm_stats_inc (
+	volatile uint64_t*	shard,
+	const unsigned		counter
+	)
+{
+	pgm_stats_add (shard, counter, 1);
+}
+
+/* counter update from any thread.
+ */
+
+static inline
+void
+pgm_stats_atomic_add (
+	volatile uint64_t*	shard,
+	const unsigned		counter,
+	const uint64_t		val
+	)
+{
+	pgm_atomic_add64 (&shard[counter], val);
+}
+
+static inline
+void
+pgm_stats_atomic_inc (
+	volatile uint64_t*	shard,
+	const unsigned		counter
+	)
+{
+	pgm_stats_atomic_add (shard, counter, 1);
+}
+
+PGM_END_DECLS
+
+#endif /* __PGM_IMPL_STATS_H__ */
@@ -0,0 +1,69 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * Open addressing table keyed on transport session identifier.
+ *
+ * Copyright (c) 2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#if !defined (__PGM_IMPL_FRAMEWORK_H_INSIDE__) && !defined (PGM_COMPILATION)
+#	error "Only <framework.h> can be included directly."
+#endif
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#	pragma once
+#endif
+#ifndef __PGM_IMPL_TSITABLE_H__
+#define __PGM_IMPL_TSITABLE_H__
+
+typedef struct pgm_tsitable_t pgm_tsitable_t;
+
+#include <pgm/types.h>
+#include <pgm/tsi.h>
+
+PGM_BEGIN_DECLS
+
+/* Linear probing table of TSI keys stored inline with their values, a NULL
+ * value marks an empty slot.  Capacity is a power of two and the load is kept
+ * under three quarters.  Growth allocates a table of twice the capacity and
+ * migrates a few slots of the previous table on every following insert or
+ * remove, lookups consult both tables until migration completes.
+ */
+
+struct pgm_tsientry_t {
+	pgm_tsi_t			tsi;
+	void*				value;
+};
+
+struct pgm_tsitable_t {
+	struct pgm_tsientry_t*		entries;
+	uint32_t			mask;		/* capacity - 1 */
+	uint32_t			count;		/* entries in both tables */
+	struct pgm_tsientry_t*		old_entries;	/* NULL unless migrating */
+	uint32_t			old_mask;
+	uint32_t			old_first;	/* first slot migrated, empty at start */
+	uint32_t			old_done;	/* slots migrated from old_first */
+};
+
+PGM_GNUC_INTERNAL pgm_tsitable_t* pgm_tsitable_new (void) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL void pgm_tsitable_destroy (pgm_tsitable_t*);
+PGM_GNUC_INTERNAL void pgm_tsitable_insert (pgm_tsitable_t*restrict, const pgm_tsi_t*restrict, void*restrict);
+PGM_GNUC_INTERNAL bool pgm_tsitable_remove (pgm_tsitable_t*restrict, const pgm_tsi_t*restrict);
+PGM_GNUC_INTERNAL void* pgm_tsitable_lookup (const pgm_tsitable_t*restrict, const pgm_tsi_t*restrict) PGM_GNUC_WARN_UNUSED_RESULT;
+
+PGM_END_DECLS
+
+#endif /* __PGM_IMPL_TSITABLE_H__ */
@@ -42,8 +42,14 @@ struct pgm_txw_state_t {
 
 	uint8_t		pkt_cnt_requested;	/* # parity packets to send */
 	uint8_t		pkt_cnt_sent;		/* # parity packets already sent */
+
+	pgm_time_t	ncf_expiry;		/* NAKs eliminated until */
+	pgm_time_t	nak_tstamp;		/* NAK that queued the repair */
 };
 
+/* maximum parity packets encoded in one pass over a transmission group */
+#define PGM_TXW_PARITY_ROWS	16
+
 struct pgm_txw_t {
 	const pgm_tsi_t* restrict	tsi;
 
@@ -57,6 +63,14 @@ struct pgm_txw_t {
 	uint8_t				tg_sqn_shift;
 	struct pgm_sk_buff_t* restrict	parity_buffer;
 
+/* parity payloads encoded ahead for the transmission group being repaired */
+	pgm_gf8_t*			parity_rows;
+	uint16_t			parity_row_size;	/* stride of parity_rows, grows with TSDU */
+	uint16_t			parity_row_length;	/* encoded length */
+	uint32_t			parity_tg_sqn;
+	uint8_t				parity_row_first;	/* rs_h of first row */
+	uint8_t				parity_row_count;	/* 0 = empty */
+
 /* Advance with data */
 	pgm_time_t			adv_ivl_expiry;	
 	unsigned			increment_window_naks;
@@ -67,7 +81,8 @@ struct pgm_txw_t {
 	unsigned			adv_mode:1;		/* 0 = advance by time, 1 = advance by data */
 
 	size_t				size;			/* window content size in bytes */
-	unsigned			alloc;			/* length of pdata[] */
+	unsigned			alloc;			/* window limit in sequences */
+	uint32_t			mask;			/* length of pdata[] - 1, power of 2 */
 /* C90 and older */
 	struct pgm_sk_buff_t*		pdata[1];
 };
@@ -78,13 +93,19 @@ PGM_GNUC_INTERNAL void pgm_txw_add (pgm_txw_t*const restrict, struct pgm_sk_buff
 PGM_GNUC_INTERNAL struct pgm_sk_buff_t* pgm_txw_peek (const pgm_txw_t*const, const uint32_t) PGM_GNUC_WARN_UNUSED_RESULT;
 PGM_GNUC_INTERNAL bool pgm_txw_retransmit_push (pgm_txw_t*const, const uint32_t, const bool, const uint8_t) PGM_GNUC_WARN_UNUSED_RESULT;
 PGM_GNUC_INTERNAL struct pgm_sk_buff_t* pgm_txw_retransmit_try_peek (pgm_txw_t*const) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL unsigned pgm_txw_retransmit_try_peek_selective (pgm_txw_t*const restrict, struct pgm_sk_buff_t**restrict, const unsigned) PGM_GNUC_WARN_UNUSED_RESULT;
 PGM_GNUC_INTERNAL void pgm_txw_retransmit_remove_head (pgm_txw_t*const);
 PGM_GNUC_INTERNAL uint32_t pgm_txw_get_unfolded_checksum (const struct pgm_sk_buff_t*const) PGM_GNUC_PURE;
 PGM_GNUC_INTERNAL void pgm_txw_set_unfolded_checksum (struct pgm_sk_buff_t*const, const uint32_t);
 PGM_GNUC_INTERNAL void pgm_txw_inc_retransmit_count (struct pgm_sk_buff_t*const);
+PGM_GNUC_INTERNAL pgm_time_t pgm_txw_get_ncf_expiry (const struct pgm_sk_buff_t*const) PGM_GNUC_PURE;
+PGM_GNUC_INTERNAL void pgm_txw_set_ncf_expiry (struct pgm_sk_buff_t*const, const pgm_time_t);
+PGM_GNUC_INTERNAL pgm_time_t pgm_txw_get_nak_tstamp (const struct pgm_sk_buff_t*const) PGM_GNUC_PURE;
+PGM_GNUC_INTERNAL void pgm_txw_set_nak_tstamp (struct pgm_sk_buff_t*const, const pgm_time_t);
 PGM_GNUC_INTERNAL bool pgm_txw_retransmit_is_empty (const pgm_txw_t*const) PGM_GNUC_WARN_UNUSED_RESULT;
 
 /* declare for GCC attributes */
+static inline uint_fast32_t pgm_txw_index (const pgm_txw_t*const, const uint32_t) PGM_GNUC_WARN_UNUSED_RESULT;
 static inline size_t pgm_txw_max_length (const pgm_txw_t*const) PGM_GNUC_WARN_UNUSED_RESULT;
 static inline uint32_t pgm_txw_length (const pgm_txw_t*const) PGM_GNUC_WARN_UNUSED_RESULT;
 static inline size_t pgm_txw_size (const pgm_txw_t*const) PGM_GNUC_WARN_UNUSED_RESULT;
@@ -96,6 +117,19 @@ static inline uint32_t pgm_txw_next_lead (const pgm_txw_t* const) PGM_GNUC_WARN_
 static inline uint32_t pgm_txw_trail (const pgm_txw_t* const) PGM_GNUC_WARN_UNUSED_RESULT;
 static inline uint32_t pgm_txw_trail_atomic (const pgm_txw_t* const) PGM_GNUC_WARN_UNUSED_RESULT;
 
+/* slot of sequence in pdata[] */
+
+static inline
+uint_fast32_t
+pgm_txw_index (
+	const pgm_txw_t*const window,
+	const uint32_t	      sequence
+	)
+{
+	pgm_assert (NULL != window);
+	return sequence & window->mask;
+}
+
 static inline
 size_t
 pgm_txw_max_length (
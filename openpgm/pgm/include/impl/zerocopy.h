@@ -0,0 +1,68 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * Completion tracking of zero-copy transmit buffers.
+ *
+ * Copyright (c) 2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#if !defined (__PGM_IMPL_FRAMEWORK_H_INSIDE__) && !defined (PGM_COMPILATION)
+#	error "Only <framework.h> can be included directly."
+#endif
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#	pragma once
+#endif
+#ifndef __PGM_IMPL_ZEROCOPY_H__
+#define __PGM_IMPL_ZEROCOPY_H__
+
+typedef struct pgm_zerocopy_t pgm_zerocopy_t;
+
+#include <pgm/types.h>
+#include <pgm/skbuff.h>
+#include <impl/sockaddr.h>
+#include <impl/thread.h>
+
+PGM_BEGIN_DECLS
+
+/* Every MSG_ZEROCOPY send is numbered by the kernel in order from zero, completed
+ * ranges of numbers are reported on the socket error queue once the kernel no
+ * longer references the buffer.  A reference is held on each sent skbuff in a
+ * power of two ring indexed by that number so the buffer is neither recycled nor
+ * rewritten, e.g. as a repair, whilst in flight.  Completions are taken in order.
+ */
+
+struct pgm_zerocopy_t {
+	pgm_mutex_t			mutex;
+	struct pgm_sk_buff_t**		skb;		/* held buffers, indexed by id & mask */
+	uint32_t			mask;		/* capacity - 1 */
+	uint32_t			next;		/* id of next send */
+	uint32_t			done;		/* first id not completed */
+
+/* statistics */
+	uint32_t			completed;
+	uint32_t			copied;		/* kernel fell back to copying */
+};
+
+PGM_GNUC_INTERNAL pgm_zerocopy_t* pgm_zerocopy_create (void) PGM_GNUC_WARN_UNUSED_RESULT;
+PGM_GNUC_INTERNAL void pgm_zerocopy_destroy (pgm_zerocopy_t*);
+PGM_GNUC_INTERNAL void pgm_zerocopy_hold (pgm_zerocopy_t*restrict, const SOCKET, struct pgm_sk_buff_t*restrict);
+PGM_GNUC_INTERNAL unsigned pgm_zerocopy_reap (pgm_zerocopy_t*, const SOCKET);
+PGM_GNUC_INTERNAL bool pgm_zerocopy_is_pending (pgm_zerocopy_t*restrict, const SOCKET, const struct pgm_sk_buff_t*restrict) PGM_GNUC_WARN_UNUSED_RESULT;
+
+PGM_END_DECLS
+
+#endif /* __PGM_IMPL_ZEROCOPY_H__ */
@@ -199,6 +199,64 @@ pgm_atomic_dec32 (
 #endif
 }
 
+/* 32-bit word CAS, returns TRUE if swap occurred.
+ *
+ *	if (*atomic == oldval) {
+ *		*atomic = newval;
+ *		return TRUE;
+ *	}
+ *	return FALSE;
+ *
+ * Sun Studio on x86 GCC-compatible assembler not implemented.
+ */
+
+static inline
+bool
+pgm_atomic_compare_and_exchange32 (
+	volatile uint32_t*	atomic,
+	const uint32_t		newval,
+	const uint32_t		oldval
+	)
+{
+#if defined( __GNUC__ ) && ( defined( __i386__ ) || defined( __x86_64__ ) )
+/* GCC assembler */
+	uint32_t expected = oldval;	/* eax is overwritten on failure */
+	uint8_t result;
+	__asm__ volatile ("lock; cmpxchgl %3, %0\n\t"
+			  "setz %1\n\t"
+			: "+m" (*atomic), "=q" (result), "+a" (expected)
+			: "r" (newval)
+			: "memory", "cc"  );
+	return (bool)result;
+#elif defined( __SUNPRO_C ) && ( defined( __i386__ ) || defined( __x86_64__ ) )
+/* GCC-compatible assembler */
+	uint32_t expected = oldval;	/* eax is overwritten on failure */
+	uint8_t result;
+	__asm__ volatile ("lock; cmpxchgl %3, %0\n\t"
+			  "setz %1\n\t"
+			: "+m" (*atomic), "=q" (result), "+a" (expected)
+			: "r" (newval)
+			: "memory", "cc"  );
+	return (bool)result;
+#elif defined( __sun ) || defined( __NetBSD__ )
+/* Solaris and NetBSD intrinsic */
+	const uint32_t original = atomic_cas_32 (atomic, oldval, newval);
+	return (oldval == original);
+#elif defined( __APPLE__ )
+/* Darwin intrinsic */
+	return OSAtomicCompareAndSwap32Barrier ((int32_t)oldval, (int32_t)newval, (volatile int32_t*)atomic);
+#elif defined( __GNUC__ ) && ( __GNUC__ * 100 + __GNUC_MINOR__ >= 401 )
+/* GCC 4.0.1 intrinsic */
+	return __sync_bool_compare_and_swap (atomic, oldval, newval);
+#elif defined( _AIX )
+	return compare_and_swap ((int *)atomic, (int *)&oldval, newval);
+#elif defined( _WIN32 )
+/* Windows intrinsic */
+	const uint32_t original = _InterlockedCompareExchange ((volatile LONG*)atomic, newval, oldval);
+	return (oldval == original);
+#endif
+}
+
 /* 32-bit word load 
  */
 
@@ -224,4 +282,101 @@ pgm_atomic_write32 (
 	*atomic = val;
 }
 
+/* 64-bit word CAS, returns TRUE if swap occurred.
+ *
+ * Requires cmpxchg8b on 32-bit x86, i.e. i586 or later.
+ */
+
+static inline
+bool
+pgm_atomic_compare_and_exchange64 (
+	volatile uint64_t*	atomic,
+	const uint64_t		newval,
+	const uint64_t		oldval
+	)
+{
+#if defined( __sun ) || defined( __NetBSD__ )
+/* Solaris and NetBSD intrinsic */
+	const uint64_t original = atomic_cas_64 (atomic, oldval, newval);
+	return (oldval == original);
+#elif defined( __APPLE__ )
+/* Darwin intrinsic */
+	return OSAtomicCompareAndSwap64Barrier ((int64_t)oldval, (int64_t)newval, (volatile int64_t*)atomic);
+#elif defined( __GNUC__ ) && ( __GNUC__ * 100 + __GNUC_MINOR__ >= 401 )
+/* GCC 4.0.1 intrinsic */
+	return __sync_bool_compare_and_swap (atomic, oldval, newval);
+#elif defined( _AIX ) && defined( __64BIT__ )
+	return compare_and_swaplp ((long *)atomic, (long *)&oldval, newval);
+#elif defined( _WIN32 )
+/* Windows intrinsic */
+	const uint64_t original = _InterlockedCompareExchange64 ((volatile LONGLONG*)atomic, newval, oldval);
+	return (oldval == original);
+#else
+#	error "No supported 64-bit atomic operations for this platform."
+#endif
+}
+
+/* 64-bit word load, a plain load may tear on 32-bit platforms.
+ */
+
+static inline
+uint64_t
+pgm_atomic_read64 (
+	const volatile uint64_t* atomic
+	)
+{
+#if defined( __x86_64__ ) || defined( _M_X64 ) || defined( __LP64__ ) || defined( _LP64 )
+	return *atomic;
+#else
+	uint64_t val;
+	do {
+		val = *atomic;
+	} while (!pgm_atomic_compare_and_exchange64 ((volatile uint64_t*)atomic, val, val));
+	return val;
+#endif
+}
+
+/* 64-bit word store, a plain store may tear on 32-bit platforms.
+ */
+
+static inline
+void
+pgm_atomic_write64 (
+	volatile uint64_t*	atomic,
+	const uint64_t		val
+	)
+{
+#if defined( __x86_64__ ) || defined( _M_X64 ) || defined( __LP64__ ) || defined( _LP64 )
+	*atomic = val;
+#else
+	uint64_t oldval;
+	do {
+		oldval = *atomic;
+	} while (!pgm_atomic_compare_and_exchange64 (atomic, val, oldval));
+#endif
+}
+
+/* 64-bit word addition.
+ *
+ * 	*atomic += val;
+ */
+
+static inline
+void
+pgm_atomic_add64 (
+	volatile uint64_t*	atomic,
+	const uint64_t		val
+	)
+{
+#if defined( __GNUC__ ) && ( __GNUC__ * 100 + __GNUC_MINOR__ >= 401 ) && !defined( __APPLE__ ) && !defined( __sun ) && !defined( __NetBSD__ )
+/* GCC 4.0.1 intrinsic */
+	__sync_add_and_fetch (atomic, val);
+#else
+	uint64_t oldval;
+	do {
+		oldval = pgm_atomic_read64 (atomic);
+	} while (!pgm_atomic_compare_and_exchange64 (atomic, oldval + val, oldval));
+#endif
+}
+
 #endif /* __PGM_ATOMIC_H__ */
@@ -0,0 +1,49 @@
+/* vim:ts=8:sts=4:sw=4:noai:noexpandtab
+ *
+ * Event loop driving many PGM sockets from one thread.
+ *
+ * Copyright (c) 2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+#	pragma once
+#endif
+#ifndef __PGM_LOOP_H__
+#define __PGM_LOOP_H__
+
+typedef struct pgm_loop_t pgm_loop_t;
+
+#include <pgm/types.h>
+#include <pgm/error.h>
+#include <pgm/socket.h>
+
+PGM_BEGIN_DECLS
+
+/* called when the socket has data, a reset, or a session end to read.  read with
+ * MSG_DONTWAIT until PGM_IO_STATUS_WOULD_BLOCK or PGM_IO_STATUS_TIMER_PENDING.
+ */
+typedef void (*pgm_loop_func_t) (pgm_sock_t*, void*);
+
+bool pgm_loop_create (pgm_loop_t**restrict, pgm_error_t**restrict);
+bool pgm_loop_destroy (pgm_loop_t*);
+bool pgm_loop_add (pgm_loop_t*restrict, pgm_sock_t*restrict, pgm_loop_func_t, void*restrict, pgm_error_t**restrict);
+bool pgm_loop_remove (pgm_loop_t*restrict, pgm_sock_t*restrict);
+bool pgm_loop_dispatch (pgm_loop_t*restrict, const int, pgm_error_t**restrict);
+
+PGM_END_DECLS
+
+#endif /* __PGM_LOOP_H__ */
@@ -38,6 +38,7 @@
 #include <pgm/error.h>
 #include <pgm/gsi.h>
 #include <pgm/if.h>
+#include <pgm/loop.h>
 #include <pgm/macros.h>
 #include <pgm/mem.h>
 #include <pgm/messages.h>
@@ -54,7 +54,8 @@ struct pgm_sk_buff_t {
 
 	uint16_t			len;		/* actual data */
 	unsigned			zero_padded:1;
-	unsigned			__padding2:31;	/* fix bit field */
+	unsigned			csum_deferred:1;	/* PGM checksum not yet verified */
+	unsigned			__padding2:30;	/* fix bit field */
 
 	struct pgm_header*		pgm_header;
 	struct pgm_opt_fragment* 	pgm_opt_fragment;
@@ -75,6 +76,7 @@ struct pgm_sk_buff_t {
 void pgm_skb_over_panic (const struct pgm_sk_buff_t*const, const uint16_t) PGM_GNUC_NORETURN;
 void pgm_skb_under_panic (const struct pgm_sk_buff_t*const, const uint16_t) PGM_GNUC_NORETURN;
 bool pgm_skb_is_valid (const struct pgm_sk_buff_t*const) PGM_GNUC_PURE PGM_GNUC_WARN_UNUSED_RESULT;
+void pgm_skb_pool_release (struct pgm_sk_buff_t*const);
 
 /* attribute __pure__ only valid for platforms with atomic ops.
  * attribute __malloc__ not used as only part of the memory should be aliased.
@@ -125,8 +127,13 @@ pgm_free_skb (
 	struct pgm_sk_buff_t*const skb
 	)
 {
-	if (pgm_atomic_exchange_and_add32 (&skb->users, (uint32_t)-1) == 1)
-		pgm_free (skb);
+	if (pgm_atomic_exchange_and_add32 (&skb->users, (uint32_t)-1) == 1) {
+/* receive buffers may be owned by a library pool */
+		if (PGM_UNLIKELY(skb->head != (void*)(skb + 1)))
+			pgm_skb_pool_release (skb);
+		else
+			pgm_free (skb);
+	}
 }
 
 /* add data */
@@ -94,6 +94,26 @@ struct pgm_pgmccinfo_t {
 	uint32_t				ack_c_p;
 };
 
+/* cumulative counters, receive side summed over all peers */
+struct pgm_stats_t {
+	uint64_t				data_bytes_sent;
+	uint64_t				data_msgs_sent;
+	uint64_t				bytes_sent;
+	uint64_t				bytes_retransmitted;
+	uint64_t				msgs_retransmitted;
+	uint64_t				naks_received;
+	uint64_t				naks_ignored;
+	uint64_t				nnaks_received;
+	uint64_t				cksum_errors;
+	uint64_t				packets_discarded;
+	uint64_t				data_bytes_received;
+	uint64_t				data_msgs_received;
+	uint64_t				bytes_received;
+	uint64_t				naks_sent;
+	uint64_t				naks_failed;
+	uint64_t				dup_datas;
+};
+
 /* socket options */
 enum {
 	PGM_SEND_SOCK		= 0x2000,
@@ -149,7 +169,32 @@ enum {
 	PGM_UNCONTROLLED_ODATA,
 	PGM_UNCONTROLLED_RDATA,
 	PGM_ODATA_MAX_RTE,
-	PGM_RDATA_MAX_RTE
+	PGM_RDATA_MAX_RTE,
+	PGM_RECV_BATCH,
+	PGM_RECV_BATCH_FILL,
+	PGM_SKB_POOL_HITS,
+	PGM_SKB_POOL_MISSES,
+	PGM_SKB_POOL_HIGH_WATER,
+	PGM_SEND_BURST,
+	PGM_SEND_BURST_FILL,
+	PGM_DEFER_CHECKSUM,
+	PGM_RECV_THREAD,
+	PGM_RX_TIMESTAMP,
+	PGM_SEND_ZEROCOPY,
+	PGM_PACING,
+	PGM_NCF_IVL,
+	PGM_KERNEL_FILTER,
+	PGM_FILTER_TSI,
+	PGM_RXW_RESERVED,
+	PGM_RXW_USED,
+	PGM_STATS
+};
+
+/* transmit pacing */
+enum {
+	PGM_PACING_NONE,		/* millisecond bursts at the rate limit */
+	PGM_PACING_USER,		/* packets spaced by the library */
+	PGM_PACING_KERNEL		/* packets spaced by the kernel, SO_MAX_PACING_RATE */
 };
 
 /* IO status */
@@ -165,6 +210,13 @@ enum {
 	PGM_IO_STATUS_CONGESTION	/* would-block waiting on ACK or timeout */
 };
 
+/* Maximum datagrams per batched read or burst write, Linux UIO_MAXIOV */
+#define PGM_MAX_RECV_BATCH			1024
+#define PGM_MAX_SEND_BURST			1024
+
+/* Maximum APDUs queued from the network thread to the application */
+#define PGM_MAX_RECV_RING			65536
+
 /* Socket count for event handlers */
 #define PGM_SEND_SOCKET_READ_COUNT		3
 #define PGM_SEND_SOCKET_WRITE_COUNT		1
@@ -0,0 +1,549 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * Event loop driving many PGM sockets from one thread.
+ *
+ * Copyright (c) 2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+#include <errno.h>
+#include <limits.h>
+#ifdef HAVE_EPOLL_CTL
+#	include <unistd.h>
+#	include <sys/epoll.h>
+#endif
+#include <impl/i18n.h>
+#include <impl/framework.h>
+#include <impl/socket.h>
+#include <impl/source.h>
+#include <impl/timer.h>
+#include <pgm/loop.h>
+
+
+//#define LOOP_DEBUG
+
+/* One epoll set holds the receive socket and notification pipes of every socket,
+ * one binary min-heap orders every socket by its next timer expiration.  A single
+ * epoll_wait() sleeps until the earliest timer across all sockets.
+ *
+ * Receive and pending-data events are passed to the application callback, which
+ * reads as normal.  Timers and queued selective repairs are serviced by the loop
+ * itself under the receiver lock as per pgm_recvmsgv().  The repair pipe is armed
+ * one-shot so a rate limited repair queue waits on the heap instead of spinning.
+ *
+ * Sockets with a receive thread only register the ring notification, the network
+ * thread services their timers.  A loop is used by one thread only.
+ */
+
+#define PGM_LOOP_NEVER		((pgm_time_t)-1)
+
+/* retry interval for send-in-receive blocked without a rate limit to wait on */
+#define PGM_LOOP_BACKOFF	( pgm_msecs(1) )
+
+enum {
+	PGM_LOOP_WATCH_RECV = 0,	/* receive socket, or ring notification */
+	PGM_LOOP_WATCH_PENDING,		/* data pending in the receive window */
+	PGM_LOOP_WATCH_REPAIR,		/* queued selective repairs */
+	PGM_LOOP_WATCH_MAX
+};
+
+struct pgm_loop_source_t;
+
+struct pgm_loop_watch_t {
+	struct pgm_loop_source_t*	source;
+	SOCKET				fd;		/* INVALID_SOCKET = unused */
+	unsigned			type;
+};
+
+struct pgm_loop_source_t {
+	pgm_sock_t*			sock;
+	pgm_loop_func_t			func;
+	void*				user_data;
+	struct pgm_loop_watch_t		watch[ PGM_LOOP_WATCH_MAX ];
+	pgm_time_t			expiry;		/* heap key */
+	pgm_time_t			repair_expiry;	/* 0 = repair watch armed */
+	unsigned			heap_index;
+	bool				is_ready;	/* queued for callback */
+};
+
+struct pgm_loop_t {
+	int				epfd;
+	struct pgm_loop_source_t**	heap;		/* min-heap on expiry, every source */
+	unsigned			len;
+	unsigned			size;
+	struct pgm_loop_source_t**	ready;		/* callbacks of current dispatch */
+	unsigned			ready_len;
+	struct epoll_event*		events;
+};
+
+
+#ifdef HAVE_EPOLL_CTL
+static
+void
+_pgm_loop_heap_swap (
+	pgm_loop_t*	loop,
+	unsigned	i,
+	unsigned	j
+	)
+{
+	struct pgm_loop_source_t* t = loop->heap[i];
+	loop->heap[i] = loop->heap[j];
+	loop->heap[j] = t;
+	loop->heap[i]->heap_index = i;
+	loop->heap[j]->heap_index = j;
+}
+
+static
+void
+_pgm_loop_heap_update (
+	pgm_loop_t*		   restrict loop,
+	struct pgm_loop_source_t*  restrict source,
+	const pgm_time_t		    expiry
+	)
+{
+	unsigned i = source->heap_index;
+
+	source->expiry = expiry;
+/* sift up */
+	while (i > 0 && loop->heap[ (i - 1) / 2 ]->expiry > loop->heap[i]->expiry) {
+		_pgm_loop_heap_swap (loop, i, (i - 1) / 2);
+		i = (i - 1) / 2;
+	}
+/* sift down */
+	for (;;) {
+		const unsigned l = 2 * i + 1, r = l + 1;
+		unsigned min = i;
+		if (l < loop->len && loop->heap[l]->expiry < loop->heap[min]->expiry)
+			min = l;
+		if (r < loop->len && loop->heap[r]->expiry < loop->heap[min]->expiry)
+			min = r;
+		if (min == i)
+			break;
+		_pgm_loop_heap_swap (loop, i, min);
+		i = min;
+	}
+}
+
+/* re-key the source on the next socket timer or blocked repair retry.
+ */
+
+static
+void
+_pgm_loop_refresh (
+	pgm_loop_t*		   restrict loop,
+	struct pgm_loop_source_t*  restrict source,
+	const pgm_time_t		    now
+	)
+{
+	pgm_time_t expiry = PGM_LOOP_NEVER;
+
+	if (NULL == source->sock->rx_ring)
+		expiry = now + pgm_timer_expiration (source->sock, now);
+	if (0 != source->repair_expiry && source->repair_expiry < expiry)
+		expiry = source->repair_expiry;
+	_pgm_loop_heap_update (loop, source, expiry);
+}
+
+static
+int
+_pgm_loop_watch_ctl (
+	pgm_loop_t*		 restrict loop,
+	struct pgm_loop_watch_t* restrict watch,
+	const int			  op
+	)
+{
+	struct epoll_event event;
+
+	memset (&event, 0, sizeof(event));
+	event.events   = EPOLLIN | (PGM_LOOP_WATCH_REPAIR == watch->type ? EPOLLONESHOT : 0);
+	event.data.ptr = watch;
+	return epoll_ctl (loop->epfd, op, watch->fd, &event);
+}
+
+/* send queued selective repairs, on a blocked send wait on the heap for the rate
+ * limit before re-arming the repair pipe.
+ */
+
+static
+void
+_pgm_loop_repair (
+	pgm_loop_t*		   restrict loop,
+	struct pgm_loop_source_t*  restrict source,
+	const pgm_time_t		    now
+	)
+{
+	pgm_sock_t* sock = source->sock;
+	bool is_blocked = TRUE;
+
+	if (pgm_rwlock_reader_trylock (&sock->lock)) {
+		if (sock->is_bound && !sock->is_destroyed) {
+			pgm_mutex_lock (&sock->receiver_mutex);
+			if (!pgm_txw_retransmit_is_empty (sock->window))
+				is_blocked = !pgm_on_deferred_nak (sock);
+			else {
+				pgm_notify_clear (&sock->rdata_notify);
+				is_blocked = FALSE;
+			}
+			pgm_mutex_unlock (&sock->receiver_mutex);
+		}
+		pgm_rwlock_reader_unlock (&sock->lock);
+	}
+
+	if (is_blocked) {
+		const pgm_time_t remaining = pgm_rate_remaining2 (&sock->rate_control, &sock->rdata_rate_control, sock->blocklen);
+		source->repair_expiry = now + MAX(remaining, PGM_LOOP_BACKOFF);
+		_pgm_loop_refresh (loop, source, now);
+	} else
+		_pgm_loop_watch_ctl (loop, &source->watch[ PGM_LOOP_WATCH_REPAIR ], EPOLL_CTL_MOD);
+}
+
+/* run expired timers of the heap minimum and retry blocked repairs now due.
+ */
+
+static
+void
+_pgm_loop_timer (
+	pgm_loop_t*		   restrict loop,
+	struct pgm_loop_source_t*  restrict source,
+	const pgm_time_t		    now
+	)
+{
+	pgm_sock_t* sock = source->sock;
+
+	if (0 != source->repair_expiry && source->repair_expiry <= now) {
+		source->repair_expiry = 0;
+		_pgm_loop_repair (loop, source, now);
+	}
+
+	if (NULL != sock->rx_ring) {
+		_pgm_loop_refresh (loop, source, now);
+		return;
+	}
+
+	if (pgm_rwlock_reader_trylock (&sock->lock)) {
+		if (sock->is_bound && !sock->is_destroyed) {
+			pgm_mutex_lock (&sock->receiver_mutex);
+			if (pgm_timer_check (sock, now))
+				pgm_timer_dispatch (sock, now);
+			pgm_mutex_unlock (&sock->receiver_mutex);
+		}
+		pgm_rwlock_reader_unlock (&sock->lock);
+	}
+
+/* still due after blocked send-in-receive or a socket closing */
+	_pgm_loop_refresh (loop, source, now);
+	if (source->expiry <= now)
+		_pgm_loop_heap_update (loop, source, now + PGM_LOOP_BACKOFF);
+}
+#endif /* HAVE_EPOLL_CTL */
+
+/* create an empty loop.
+ *
+ * on success, TRUE is returned.  on failure, FALSE is returned and error set.
+ */
+
+bool
+pgm_loop_create (
+	pgm_loop_t**  restrict loop,
+	pgm_error_t** restrict error
+	)
+{
+	pgm_return_val_if_fail (NULL != loop, FALSE);
+
+#ifdef HAVE_EPOLL_CTL
+	pgm_loop_t* new_loop;
+	const int epfd = epoll_create (1);
+
+	if (-1 == epfd) {
+		const int save_errno = errno;
+		char errbuf[1024];
+		pgm_set_error (error,
+			       PGM_ERROR_DOMAIN_ENGINE,
+			       pgm_error_from_errno (save_errno),
+			       _("Creating epoll set: %s"),
+			       pgm_strerror_s (errbuf, sizeof (errbuf), save_errno));
+		return FALSE;
+	}
+	new_loop = pgm_new0 (pgm_loop_t, 1);
+	new_loop->epfd = epfd;
+	*loop = new_loop;
+	return TRUE;
+#else
+	pgm_set_error (error,
+		       PGM_ERROR_DOMAIN_ENGINE,
+		       PGM_ERROR_NOSYS,
+		       _("Event loop requires epoll."));
+	return FALSE;
+#endif /* HAVE_EPOLL_CTL */
+}
+
+/* destroy the loop, sockets still added are left open.
+ */
+
+bool
+pgm_loop_destroy (
+	pgm_loop_t*	loop
+	)
+{
+	pgm_return_val_if_fail (NULL != loop, FALSE);
+
+#ifdef HAVE_EPOLL_CTL
+	for (unsigned i = 0; i < loop->len; i++)
+		pgm_free (loop->heap[i]);
+	close (loop->epfd);
+	pgm_free (loop->events);
+	pgm_free (loop->ready);
+	pgm_free (loop->heap);
+	pgm_free (loop);
+	return TRUE;
+#else
+	return FALSE;
+#endif
+}
+
+/* add a bound socket, func is called with user_data when the socket has data
+ * to read.  the socket must not be added to more than one loop.
+ *
+ * on success, TRUE is returned.  on failure, FALSE is returned and error set.
+ */
+
+bool
+pgm_loop_add (
+	pgm_loop_t*   restrict loop,
+	pgm_sock_t*   restrict sock,
+	pgm_loop_func_t	       func,
+	void*	      restrict user_data,
+	pgm_error_t** restrict error
+	)
+{
+	pgm_return_val_if_fail (NULL != loop, FALSE);
+	pgm_return_val_if_fail (NULL != sock, FALSE);
+	pgm_return_val_if_fail (NULL != func, FALSE);
+
+#ifdef HAVE_EPOLL_CTL
+	struct pgm_loop_source_t* source;
+
+	if (PGM_UNLIKELY(!sock->is_bound || sock->is_destroyed)) {
+		pgm_set_error (error,
+			       PGM_ERROR_DOMAIN_ENGINE,
+			       PGM_ERROR_INVAL,
+			       _("Socket is not bound."));
+		return FALSE;
+	}
+
+	source = pgm_new0 (struct pgm_loop_source_t, 1);
+	source->sock	  = sock;
+	source->func	  = func;
+	source->user_data = user_data;
+	for (unsigned i = 0; i < PGM_LOOP_WATCH_MAX; i++) {
+		source->watch[i].source = source;
+		source->watch[i].fd	= INVALID_SOCKET;
+		source->watch[i].type	= i;
+	}
+	if (NULL != sock->rx_ring) {
+		source->watch[ PGM_LOOP_WATCH_RECV ].fd = pgm_notify_get_socket (&sock->ring_notify);
+	} else {
+		source->watch[ PGM_LOOP_WATCH_RECV ].fd    = sock->recv_sock;
+		source->watch[ PGM_LOOP_WATCH_PENDING ].fd = pgm_notify_get_socket (&sock->pending_notify);
+		if (sock->can_send_data)
+			source->watch[ PGM_LOOP_WATCH_REPAIR ].fd = pgm_notify_get_socket (&sock->rdata_notify);
+	}
+
+	for (unsigned i = 0; i < PGM_LOOP_WATCH_MAX; i++) {
+		if (INVALID_SOCKET == source->watch[i].fd)
+			continue;
+		if (-1 == _pgm_loop_watch_ctl (loop, &source->watch[i], EPOLL_CTL_ADD)) {
+			const int save_errno = errno;
+			char errbuf[1024];
+			while (i--)
+				if (INVALID_SOCKET != source->watch[i].fd)
+					epoll_ctl (loop->epfd, EPOLL_CTL_DEL, source->watch[i].fd, NULL);
+			pgm_free (source);
+			pgm_set_error (error,
+				       PGM_ERROR_DOMAIN_ENGINE,
+				       pgm_error_from_errno (save_errno),
+				       _("Adding socket to epoll set: %s"),
+				       pgm_strerror_s (errbuf, sizeof (errbuf), save_errno));
+			return FALSE;
+		}
+	}
+
+	if (loop->len == loop->size) {
+		loop->size   = loop->size ? 2 * loop->size : 16;
+		loop->heap   = pgm_realloc (loop->heap, loop->size * sizeof(struct pgm_loop_source_t*));
+		loop->ready  = pgm_realloc (loop->ready, loop->size * sizeof(struct pgm_loop_source_t*));
+		loop->events = pgm_realloc (loop->events, loop->size * PGM_LOOP_WATCH_MAX * sizeof(struct epoll_event));
+	}
+	source->heap_index = loop->len;
+	source->expiry	   = PGM_LOOP_NEVER;
+	loop->heap[ loop->len++ ] = source;
+	_pgm_loop_refresh (loop, source, pgm_time_update_now());
+	return TRUE;
+#else
+	pgm_set_error (error,
+		       PGM_ERROR_DOMAIN_ENGINE,
+		       PGM_ERROR_NOSYS,
+		       _("Event loop requires epoll."));
+	return FALSE;
+#endif /* HAVE_EPOLL_CTL */
+}
+
+/* remove a socket before closing it, may be called from a callback.
+ *
+ * returns TRUE if the socket was found and removed.
+ */
+
+bool
+pgm_loop_remove (
+	pgm_loop_t* restrict loop,
+	pgm_sock_t* restrict sock
+	)
+{
+	pgm_return_val_if_fail (NULL != loop, FALSE);
+	pgm_return_val_if_fail (NULL != sock, FALSE);
+
+#ifdef HAVE_EPOLL_CTL
+	struct pgm_loop_source_t* source = NULL;
+
+	for (unsigned i = 0; i < loop->len; i++)
+		if (sock == loop->heap[i]->sock) {
+			source = loop->heap[i];
+			break;
+		}
+	if (NULL == source)
+		return FALSE;
+
+	for (unsigned i = 0; i < PGM_LOOP_WATCH_MAX; i++)
+		if (INVALID_SOCKET != source->watch[i].fd)
+			epoll_ctl (loop->epfd, EPOLL_CTL_DEL, source->watch[i].fd, NULL);
+
+/* move to the heap end and remove */
+	_pgm_loop_heap_update (loop, source, 0);
+	pgm_assert (0 == source->heap_index);
+	_pgm_loop_heap_swap (loop, 0, --loop->len);
+	if (loop->len > 0)
+		_pgm_loop_heap_update (loop, loop->heap[0], loop->heap[0]->expiry);
+
+/* cancel a pending callback of this dispatch */
+	for (unsigned i = 0; i < loop->ready_len; i++)
+		if (source == loop->ready[i])
+			loop->ready[i] = NULL;
+	pgm_free (source);
+	return TRUE;
+#else
+	return FALSE;
+#endif /* HAVE_EPOLL_CTL */
+}
+
+/* wait up to timeout milliseconds, -1 for no limit, or the earliest socket timer
+ * for events then service repairs, expired timers, and call back sockets with data.
+ *
+ * on success, TRUE is returned.  on failure, FALSE is returned and error set.
+ */
+
+bool
+pgm_loop_dispatch (
+	pgm_loop_t*   restrict loop,
+	const int	       timeout,
+	pgm_error_t** restrict error
+	)
+{
+	pgm_return_val_if_fail (NULL != loop, FALSE);
+
+#ifdef HAVE_EPOLL_CTL
+	pgm_time_t now = pgm_time_update_now();
+	int msec = timeout;
+	int ready;
+
+	if (loop->len > 0 && PGM_LOOP_NEVER != loop->heap[0]->expiry) {
+		const pgm_time_t expiry = loop->heap[0]->expiry;
+/* round up to not wake before the timer */
+		const pgm_time_t wait = expiry > now ? (pgm_to_usecs (expiry - now) + 999) / 1000 : 0;
+		if (msec < 0 || wait < (pgm_time_t)msec)
+			msec = (int)MIN(wait, INT_MAX);
+	}
+
+#ifdef LOOP_DEBUG
+	pgm_debug ("pgm_loop_dispatch (loop:%p timeout:%d sockets:%u wait:%dms)",
+		(const void*)loop, timeout, loop->len, msec);
+#endif
+
+	ready = epoll_wait (loop->epfd, loop->events, (int)(MAX(loop->len, 1) * PGM_LOOP_WATCH_MAX), msec);
+	if (-1 == ready) {
+		const int save_errno = errno;
+		char errbuf[1024];
+		if (EINTR == save_errno)
+			return TRUE;
+		pgm_set_error (error,
+			       PGM_ERROR_DOMAIN_ENGINE,
+			       pgm_error_from_errno (save_errno),
+			       _("Waiting for events: %s"),
+			       pgm_strerror_s (errbuf, sizeof (errbuf), save_errno));
+		return FALSE;
+	}
+
+	now = pgm_time_update_now();
+	loop->ready_len = 0;
+	for (int i = 0; i < ready; i++)
+	{
+		struct pgm_loop_watch_t* watch = loop->events[i].data.ptr;
+		struct pgm_loop_source_t* source = watch->source;
+		if (PGM_LOOP_WATCH_REPAIR == watch->type)
+			_pgm_loop_repair (loop, source, now);
+		else if (!source->is_ready) {
+			source->is_ready = TRUE;
+			loop->ready[ loop->ready_len++ ] = source;
+		}
+	}
+
+	while (loop->len > 0 && loop->heap[0]->expiry <= now)
+		_pgm_loop_timer (loop, loop->heap[0], now);
+
+	for (unsigned i = 0; i < loop->ready_len; i++)
+	{
+		struct pgm_loop_source_t* source = loop->ready[i];
+		if (NULL == source)
+			continue;
+		source->is_ready = FALSE;
+		source->func (source->sock, source->user_data);
+		if (NULL == loop->ready[i])
+			continue;
+		now = pgm_time_update_now();
+/* NAKs received in the callback queue repairs without raising the repair
+ * notification, blocked repairs wait for their retry on the heap.
+ */
+		if (INVALID_SOCKET != source->watch[ PGM_LOOP_WATCH_REPAIR ].fd &&
+		    0 == source->repair_expiry &&
+		    !pgm_txw_retransmit_is_empty (source->sock->window))
+			_pgm_loop_repair (loop, source, now);
+/* receipt reschedules NAK and SPMR timers */
+		_pgm_loop_refresh (loop, source, now);
+	}
+	loop->ready_len = 0;
+	return TRUE;
+#else
+	pgm_set_error (error,
+		       PGM_ERROR_DOMAIN_ENGINE,
+		       PGM_ERROR_NOSYS,
+		       _("Event loop requires epoll."));
+	return FALSE;
+#endif /* HAVE_EPOLL_CTL */
+}
+
+/* eof */
@@ -0,0 +1,462 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * unit tests for the multi-socket event loop.
+ *
+ * Copyright (c) 2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include <signal.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#	include <unistd.h>
+#	include <sys/socket.h>
+#endif
+#include <glib.h>
+#include <check.h>
+
+
+/* mock state */
+
+#define TEST_SOCKETS		3
+
+static guint64 mock_expiration = 0;		/* μs, 0 = never */
+static guint mock_timer_calls = 0;
+static gboolean mock_is_retransmit_empty = TRUE;
+static guint mock_repair_calls = 0;
+static guint mock_callback_calls = 0;
+
+#define pgm_timer_expiration		mock_pgm_timer_expiration
+#define pgm_timer_check			mock_pgm_timer_check
+#define pgm_timer_dispatch		mock_pgm_timer_dispatch
+#define pgm_on_deferred_nak		mock_pgm_on_deferred_nak
+#define pgm_txw_retransmit_is_empty	mock_pgm_txw_retransmit_is_empty
+#define pgm_rate_remaining2		mock_pgm_rate_remaining2
+
+#define LOOP_DEBUG
+#include "loop.c"
+
+
+static
+void
+mock_setup (void)
+{
+	mock_expiration = 0;
+	mock_timer_calls = 0;
+	mock_is_retransmit_empty = TRUE;
+	mock_repair_calls = 0;
+	mock_callback_calls = 0;
+}
+
+static
+pgm_sock_t*
+generate_sock (
+	const bool	can_send_data
+	)
+{
+	pgm_sock_t* sock = g_new0 (pgm_sock_t, 1);
+	int sv[2];
+	g_assert (0 == socketpair (AF_UNIX, SOCK_DGRAM, 0, sv));
+	sock->recv_sock = sv[0];
+	sock->send_sock = sv[1];
+	sock->can_send_data = can_send_data;
+	sock->can_recv_data = TRUE;
+	sock->is_bound = TRUE;
+	pgm_rwlock_init (&sock->lock);
+	pgm_mutex_init (&sock->receiver_mutex);
+	pgm_mutex_init (&sock->timer_mutex);
+	pgm_notify_init (&sock->pending_notify);
+	pgm_notify_init (&sock->rdata_notify);
+	return sock;
+}
+
+static
+void
+destroy_sock (
+	pgm_sock_t*	sock
+	)
+{
+	pgm_notify_destroy (&sock->rdata_notify);
+	pgm_notify_destroy (&sock->pending_notify);
+	pgm_mutex_free (&sock->timer_mutex);
+	pgm_mutex_free (&sock->receiver_mutex);
+	pgm_rwlock_free (&sock->lock);
+	close (sock->recv_sock);
+	close (sock->send_sock);
+	g_free (sock);
+}
+
+/* mock functions for external references */
+
+PGM_GNUC_INTERNAL
+int
+pgm_get_nprocs (void)
+{
+	return 1;
+}
+
+PGM_GNUC_INTERNAL
+pgm_time_t
+mock_pgm_timer_expiration (
+	pgm_sock_t* const	sock,
+	const pgm_time_t	now
+	)
+{
+	return mock_expiration ? mock_expiration : pgm_secs (3600);
+}
+
+PGM_GNUC_INTERNAL
+bool
+mock_pgm_timer_check (
+	pgm_sock_t* const	sock,
+	const pgm_time_t	now
+	)
+{
+	return TRUE;
+}
+
+PGM_GNUC_INTERNAL
+bool
+mock_pgm_timer_dispatch (
+	pgm_sock_t* const	sock,
+	const pgm_time_t	now
+	)
+{
+	g_debug ("mock_pgm_timer_dispatch (sock:%p now:%" PGM_TIME_FORMAT ")",
+		(gpointer)sock, now);
+	mock_timer_calls++;
+/* next timer an hour away */
+	mock_expiration = 0;
+	return TRUE;
+}
+
+PGM_GNUC_INTERNAL
+bool
+mock_pgm_on_deferred_nak (
+	pgm_sock_t* const	sock
+	)
+{
+	mock_repair_calls++;
+	mock_is_retransmit_empty = TRUE;
+	return TRUE;
+}
+
+PGM_GNUC_INTERNAL
+bool
+mock_pgm_txw_retransmit_is_empty (
+	const pgm_txw_t* const	window
+	)
+{
+	return mock_is_retransmit_empty;
+}
+
+PGM_GNUC_INTERNAL
+pgm_time_t
+mock_pgm_rate_remaining2 (
+	pgm_rate_t*		major_bucket,
+	pgm_rate_t*		minor_bucket,
+	const size_t		n
+	)
+{
+	return 0;
+}
+
+static
+void
+on_data (
+	pgm_sock_t*	sock,
+	void*		user_data
+	)
+{
+	g_debug ("on_data (sock:%p user-data:%p)", (gpointer)sock, user_data);
+	mock_callback_calls++;
+	pgm_notify_clear (&sock->pending_notify);
+	if (NULL != user_data)
+		fail_unless (TRUE == pgm_loop_remove ((pgm_loop_t*)user_data, sock), "remove failed");
+}
+
+
+/* receive a NAK that queues a selective repair */
+static
+void
+on_nak (
+	pgm_sock_t*	sock,
+	void*		user_data
+	)
+{
+	g_debug ("on_nak (sock:%p user-data:%p)", (gpointer)sock, user_data);
+	mock_callback_calls++;
+	pgm_notify_clear (&sock->pending_notify);
+	mock_is_retransmit_empty = FALSE;
+}
+
+
+/* target:
+ *	bool
+ *	pgm_loop_create (
+ *		pgm_loop_t**		loop,
+ *		pgm_error_t**		error
+ *	)
+ */
+
+START_TEST (test_create_pass_001)
+{
+	pgm_loop_t* loop = NULL;
+	pgm_error_t* err = NULL;
+	fail_unless (TRUE == pgm_loop_create (&loop, &err), "create failed");
+	fail_if (NULL == loop, "create failed");
+	fail_unless (0 == loop->len, "not empty");
+	fail_unless (TRUE == pgm_loop_destroy (loop), "destroy failed");
+}
+END_TEST
+
+START_TEST (test_create_fail_001)
+{
+	fail_unless (FALSE == pgm_loop_create (NULL, NULL), "create failed");
+}
+END_TEST
+
+/* target:
+ *	bool
+ *	pgm_loop_add (
+ *		pgm_loop_t*		loop,
+ *		pgm_sock_t*		sock,
+ *		pgm_loop_func_t		func,
+ *		void*			user_data,
+ *		pgm_error_t**		error
+ *	)
+ */
+
+/* heap ordered by timer expiration */
+START_TEST (test_add_pass_001)
+{
+	pgm_loop_t* loop = NULL;
+	pgm_sock_t* sock[TEST_SOCKETS];
+	fail_unless (TRUE == pgm_loop_create (&loop, NULL), "create failed");
+	for (unsigned i = 0; i < TEST_SOCKETS; i++) {
+		sock[i] = generate_sock (TRUE);
+		mock_expiration = pgm_secs (TEST_SOCKETS - i);
+		fail_unless (TRUE == pgm_loop_add (loop, sock[i], on_data, NULL, NULL), "add failed");
+	}
+	fail_unless (TEST_SOCKETS == loop->len, "count mismatch");
+	fail_unless (sock[TEST_SOCKETS - 1] == loop->heap[0]->sock, "heap minimum mismatch");
+	for (unsigned i = 0; i < TEST_SOCKETS; i++) {
+		fail_unless (TRUE == pgm_loop_remove (loop, sock[i]), "remove failed");
+		destroy_sock (sock[i]);
+	}
+	fail_unless (0 == loop->len, "not empty");
+	pgm_loop_destroy (loop);
+}
+END_TEST
+
+/* unbound socket */
+START_TEST (test_add_fail_001)
+{
+	pgm_loop_t* loop = NULL;
+	pgm_error_t* err = NULL;
+	fail_unless (TRUE == pgm_loop_create (&loop, NULL), "create failed");
+	pgm_sock_t* sock = generate_sock (FALSE);
+	sock->is_bound = FALSE;
+	fail_unless (FALSE == pgm_loop_add (loop, sock, on_data, NULL, &err), "add failed");
+	fail_if (NULL == err, "error not set");
+	pgm_error_free (err);
+	destroy_sock (sock);
+	pgm_loop_destroy (loop);
+}
+END_TEST
+
+/* target:
+ *	bool
+ *	pgm_loop_dispatch (
+ *		pgm_loop_t*		loop,
+ *		const int		timeout,
+ *		pgm_error_t**		error
+ *	)
+ */
+
+/* pending data calls back once per socket */
+START_TEST (test_dispatch_pass_001)
+{
+	pgm_loop_t* loop = NULL;
+	fail_unless (TRUE == pgm_loop_create (&loop, NULL), "create failed");
+	pgm_sock_t* sock = generate_sock (FALSE);
+	fail_unless (TRUE == pgm_loop_add (loop, sock, on_data, NULL, NULL), "add failed");
+	pgm_notify_send (&sock->pending_notify);
+	fail_unless (1 == send (sock->send_sock, "x", 1, 0), "send failed");
+	fail_unless (TRUE == pgm_loop_dispatch (loop, 0, NULL), "dispatch failed");
+	fail_unless (1 == mock_callback_calls, "callback count mismatch");
+	fail_unless (0 == mock_timer_calls, "timer dispatched early");
+	pgm_loop_remove (loop, sock);
+	destroy_sock (sock);
+	pgm_loop_destroy (loop);
+}
+END_TEST
+
+/* shared timer wakes the loop without events */
+START_TEST (test_dispatch_pass_002)
+{
+	pgm_loop_t* loop = NULL;
+	fail_unless (TRUE == pgm_loop_create (&loop, NULL), "create failed");
+	pgm_sock_t* sock[TEST_SOCKETS];
+	for (unsigned i = 0; i < TEST_SOCKETS; i++) {
+		sock[i] = generate_sock (FALSE);
+		mock_expiration = 0 == i ? pgm_msecs (10) : 0;
+		fail_unless (TRUE == pgm_loop_add (loop, sock[i], on_data, NULL, NULL), "add failed");
+	}
+	const pgm_time_t start = pgm_time_update_now();
+	fail_unless (TRUE == pgm_loop_dispatch (loop, -1, NULL), "dispatch failed");
+	fail_unless (pgm_time_update_now() - start >= pgm_msecs (10), "woke early");
+	fail_unless (1 == mock_timer_calls, "timer count mismatch");
+	fail_unless (0 == mock_callback_calls, "unexpected callback");
+	fail_unless (loop->heap[0]->expiry > start + pgm_secs (60), "timer not rescheduled");
+	for (unsigned i = 0; i < TEST_SOCKETS; i++) {
+		pgm_loop_remove (loop, sock[i]);
+		destroy_sock (sock[i]);
+	}
+	pgm_loop_destroy (loop);
+}
+END_TEST
+
+/* repairs queued by NAKs received in the callback are serviced in the same
+ * dispatch without a repair notification.
+ */
+START_TEST (test_dispatch_pass_003)
+{
+	pgm_loop_t* loop = NULL;
+	fail_unless (TRUE == pgm_loop_create (&loop, NULL), "create failed");
+	pgm_sock_t* sock = generate_sock (TRUE);
+	fail_unless (TRUE == pgm_loop_add (loop, sock, on_nak, NULL, NULL), "add failed");
+	pgm_notify_send (&sock->pending_notify);
+	fail_unless (TRUE == pgm_loop_dispatch (loop, 0, NULL), "dispatch failed");
+	fail_unless (1 == mock_callback_calls, "callback count mismatch");
+	fail_unless (1 == mock_repair_calls, "repair count mismatch");
+	fail_unless (TRUE == mock_is_retransmit_empty, "queue not drained");
+/* nothing further queued */
+	fail_unless (TRUE == pgm_loop_dispatch (loop, 0, NULL), "dispatch failed");
+	fail_unless (1 == mock_repair_calls, "unexpected repair");
+	fail_unless (FALSE == pgm_notify_read (&sock->rdata_notify), "unexpected notification");
+	pgm_loop_remove (loop, sock);
+	destroy_sock (sock);
+	pgm_loop_destroy (loop);
+}
+END_TEST
+
+/* remove from within callback */
+START_TEST (test_dispatch_pass_004)
+{
+	pgm_loop_t* loop = NULL;
+	fail_unless (TRUE == pgm_loop_create (&loop, NULL), "create failed");
+	pgm_sock_t* sock = generate_sock (FALSE);
+	fail_unless (TRUE == pgm_loop_add (loop, sock, on_data, loop, NULL), "add failed");
+	pgm_notify_send (&sock->pending_notify);
+	fail_unless (TRUE == pgm_loop_dispatch (loop, 0, NULL), "dispatch failed");
+	fail_unless (1 == mock_callback_calls, "callback count mismatch");
+	fail_unless (0 == loop->len, "not removed");
+	destroy_sock (sock);
+	pgm_loop_destroy (loop);
+}
+END_TEST
+
+START_TEST (test_dispatch_fail_001)
+{
+	fail_unless (FALSE == pgm_loop_dispatch (NULL, 0, NULL), "dispatch failed");
+}
+END_TEST
+
+/* target:
+ *	bool
+ *	pgm_loop_remove (
+ *		pgm_loop_t*		loop,
+ *		pgm_sock_t*		sock
+ *	)
+ */
+
+START_TEST (test_remove_fail_001)
+{
+	pgm_loop_t* loop = NULL;
+	fail_unless (TRUE == pgm_loop_create (&loop, NULL), "create failed");
+	pgm_sock_t* sock = generate_sock (FALSE);
+	fail_unless (FALSE == pgm_loop_remove (loop, sock), "remove failed");
+	destroy_sock (sock);
+	pgm_loop_destroy (loop);
+}
+END_TEST
+
+
+static
+Suite*
+make_test_suite (void)
+{
+	Suite* s;
+
+	s = suite_create (__FILE__);
+
+	TCase* tc_create = tcase_create ("create");
+	suite_add_tcase (s, tc_create);
+	tcase_add_checked_fixture (tc_create, mock_setup, NULL);
+	tcase_add_test (tc_create, test_create_pass_001);
+	tcase_add_test (tc_create, test_create_fail_001);
+
+	TCase* tc_add = tcase_create ("add");
+	suite_add_tcase (s, tc_add);
+	tcase_add_checked_fixture (tc_add, mock_setup, NULL);
+	tcase_add_test (tc_add, test_add_pass_001);
+	tcase_add_test (tc_add, test_add_fail_001);
+
+	TCase* tc_dispatch = tcase_create ("dispatch");
+	suite_add_tcase (s, tc_dispatch);
+	tcase_add_checked_fixture (tc_dispatch, mock_setup, NULL);
+	tcase_add_test (tc_dispatch, test_dispatch_pass_001);
+	tcase_add_test (tc_dispatch, test_dispatch_pass_002);
+	tcase_add_test (tc_dispatch, test_dispatch_pass_003);
+	tcase_add_test (tc_dispatch, test_dispatch_pass_004);
+	tcase_add_test (tc_dispatch, test_dispatch_fail_001);
+
+	TCase* tc_remove = tcase_create ("remove");
+	suite_add_tcase (s, tc_remove);
+	tcase_add_checked_fixture (tc_remove, mock_setup, NULL);
+	tcase_add_test (tc_remove, test_remove_fail_001);
+
+	return s;
+}
+
+static
+Suite*
+make_master_suite (void)
+{
+	Suite* s = suite_create ("Master");
+	return s;
+}
+
+int
+main (void)
+{
+	pgm_messages_init();
+	pgm_time_init (NULL);
+	SRunner* sr = srunner_create (make_master_suite ());
+	srunner_add_suite (sr, make_test_suite ());
+	srunner_run_all (sr, CK_ENV);
+	int number_failed = srunner_ntests_failed (sr);
+	srunner_free (sr);
+	pgm_time_shutdown ();
+	pgm_messages_shutdown();
+	return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* eof */
@@ -22,6 +22,9 @@
 #ifdef HAVE_CONFIG_H
 #	include <config.h>
 #endif
+#ifndef _GNU_SOURCE
+#	define _GNU_SOURCE		/* sendmmsg() */
+#endif
 #include <errno.h>
 #ifdef HAVE_POLL
 #	include <poll.h>
@@ -41,15 +44,52 @@
 //#define NET_DEBUG
 
 
-/* locked and rate regulated sendto
+/* wait up to 500ms for a blocked socket to clear.
+ *
+ * returns > 0 when writable, 0 on timeout, -1 on error with errno set appropriately.
+ */
+
+static
+int
+wait_for_send (
+	const SOCKET	send_sock
+	)
+{
+#ifdef HAVE_POLL
+/* poll for cleared socket */
+	struct pollfd p = {
+		.fd		= send_sock,
+		.events		= POLLOUT,
+		.revents	= 0
+	};
+	return poll (&p, 1, 500 /* ms */);
+#else
+	fd_set writefds;
+	FD_ZERO(&writefds);
+	FD_SET(send_sock, &writefds);
+#	ifndef _WIN32
+	const int n_fds = send_sock + 1;	/* largest fd + 1 */
+#	else
+	const int n_fds = 1;			/* count of fds */
+#	endif
+	struct timeval tv = {
+		.tv_sec  = 0,
+		.tv_usec = 500 /* ms */ * 1000
+	};
+	return select (n_fds, NULL, &writefds, NULL, &tv);
+#endif /* HAVE_POLL */
+}
+
+/* locked and rate regulated sendto, when skb is provided the datagram may be sent
+ * with MSG_ZEROCOPY and a reference held on skb until the kernel completes.
  *
  * on success, returns number of bytes sent.  on error, -1 is returned, and
  * errno set appropriately.
  */
 
-PGM_GNUC_INTERNAL
+static
 ssize_t
-pgm_sendto_hops (
+_pgm_sendto (
 	pgm_sock_t*	       restrict	sock,
 	bool				use_rate_limit,
 	pgm_rate_t*	       restrict	minor_rate_control,
@@ -58,7 +98,8 @@ pgm_sendto_hops (
 	const void*	       restrict	buf,
 	size_t				len,
 	const struct sockaddr* restrict	to,
-	socklen_t			tolen
+	socklen_t			tolen,
+	struct pgm_sk_buff_t*  restrict	skb
 	)
 {
 	pgm_assert( NULL != sock );
@@ -104,45 +145,42 @@ pgm_sendto_hops (
 		}
 	}
 
+	int flags = 0;
+#ifdef MSG_ZEROCOPY
+/* no completions are generated by the PGM_SEND=N test transport */
+	if (NULL != skb &&
+	    NULL != sock->zerocopy &&
+	    !use_router_alert &&
+	    len >= sock->zerocopy_min &&
+	    &default_sendto == priv_sendto)
+	{
+		flags = MSG_ZEROCOPY;
+	}
+#endif
+
 	if (!use_router_alert && sock->can_send_data)
 		pgm_mutex_lock (&sock->send_mutex);
 	if (-1 != hops)
 		pgm_sockaddr_multicast_hops (send_sock, sock->send_gsr.gsr_group.ss_family, hops);
 
-	ssize_t sent = (*priv_sendto)(send_sock, buf, len, 0, to, (socklen_t)tolen);
+	ssize_t sent = (*priv_sendto)(send_sock, buf, len, flags, to, (socklen_t)tolen);
 	pgm_debug ("sendto returned %" PRIzd, sent);
+	if (sent < 0 && 0 != flags && PGM_SOCK_ENOBUFS == pgm_get_last_sock_error()) {
+/* pinned pages exhaust the socket option memory limit, take completions and copy */
+		pgm_zerocopy_reap (sock->zerocopy, send_sock);
+		flags = 0;
+		sent = (*priv_sendto)(send_sock, buf, len, flags, to, (socklen_t)tolen);
+	}
 	if (sent < 0) {
 		int save_errno = pgm_get_last_sock_error();
 		if (PGM_UNLIKELY(save_errno != PGM_SOCK_ENETUNREACH &&	/* Network is unreachable */
 		 		 save_errno != PGM_SOCK_EHOSTUNREACH &&	/* No route to host */
 		    		 save_errno != PGM_SOCK_EAGAIN))	/* would block on non-blocking send */
 		{
-#ifdef HAVE_POLL
-/* poll for cleared socket */
-			struct pollfd p = {
-				.fd		= send_sock,
-				.events		= POLLOUT,
-				.revents	= 0
-			};
-			const int ready = poll (&p, 1, 500 /* ms */);
-#else
-			fd_set writefds;
-			FD_ZERO(&writefds);
-			FD_SET(send_sock, &writefds);
-#	ifndef _WIN32
-			const int n_fds = send_sock + 1;	/* largest fd + 1 */
-#	else
-			const int n_fds = 1;			/* count of fds */
-#	endif
-			struct timeval tv = {
-				.tv_sec  = 0,
-				.tv_usec = 500 /* ms */ * 1000
-			};
-			const int ready = select (n_fds, NULL, &writefds, NULL, &tv);
-#endif /* HAVE_POLL */
+			const int ready = wait_for_send (send_sock);
 			if (ready > 0)
 			{
-				sent = (*priv_sendto)(send_sock, buf, len, 0, to, (socklen_t)tolen);
+				sent = (*priv_sendto)(send_sock, buf, len, flags, to, (socklen_t)tolen);
 				if ( sent < 0 )
 				{
 					char errbuf[1024];
@@ -170,6 +208,10 @@ pgm_sendto_hops (
 		}
 	}
 
+/* hold in send order under the send lock to match kernel numbering */
+	if (0 != flags && sent >= 0)
+		pgm_zerocopy_hold (sock->zerocopy, send_sock, skb);
+
 /* revert to default value hop limit */
 	if (-1 != hops)
 		pgm_sockaddr_multicast_hops (send_sock, sock->send_gsr.gsr_group.ss_family, sock->hops);
@@ -178,6 +220,257 @@ pgm_sendto_hops (
 	return sent;
 }
 
+PGM_GNUC_INTERNAL
+ssize_t
+pgm_sendto_hops (
+	pgm_sock_t*	       restrict	sock,
+	bool				use_rate_limit,
+	pgm_rate_t*	       restrict	minor_rate_control,
+	bool				use_router_alert,
+	int				hops,			/* -1 == system default */
+	const void*	       restrict	buf,
+	size_t				len,
+	const struct sockaddr* restrict	to,
+	socklen_t			tolen
+	)
+{
+	return _pgm_sendto (sock, use_rate_limit, minor_rate_control, use_router_alert, hops, buf, len, to, tolen, NULL);
+}
+
+/* send the packet of skb from head to tail, zero-copy if enabled on the socket.
+ * the caller must not modify the skb contents whilst pgm_zerocopy_is_pending().
+ */
+
+PGM_GNUC_INTERNAL
+ssize_t
+pgm_sendto_skb (
+	pgm_sock_t*	       restrict	sock,
+	bool				use_rate_limit,
+	pgm_rate_t*	       restrict	minor_rate_control,
+	struct pgm_sk_buff_t*  restrict	skb,
+	const struct sockaddr* restrict	to,
+	socklen_t			tolen
+	)
+{
+	pgm_assert( NULL != skb );
+
+	return _pgm_sendto (sock, use_rate_limit, minor_rate_control, FALSE, -1, skb->head, (char*)skb->tail - (char*)skb->head, to, tolen, skb);
+}
+
+/* create a queue for burst transmission of up to burst_len datagrams.
+ *
+ * returns NULL if burst transmission is not supported by the platform.
+ */
+
+PGM_GNUC_INTERNAL
+struct pgm_send_burst_t*
+pgm_send_burst_create (
+	const unsigned		burst_len
+	)
+{
+/* pre-conditions */
+	pgm_assert (burst_len > 1);
+
+	pgm_debug ("pgm_send_burst_create (burst-len:%u)", burst_len);
+
+#ifdef HAVE_SENDMMSG
+	struct pgm_send_burst_t* burst = pgm_new0 (struct pgm_send_burst_t, 1);
+	burst->skb  = pgm_new0 (struct pgm_sk_buff_t*, burst_len);
+	burst->sent = pgm_new0 (size_t, burst_len);
+	burst->iov  = pgm_new0 (struct pgm_iovec, burst_len);
+	burst->msg  = pgm_new0 (struct mmsghdr, burst_len);
+	burst->len  = burst_len;
+	return burst;
+#else
+	return NULL;
+#endif /* HAVE_SENDMMSG */
+}
+
+/* release queued packets and free the queue.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_send_burst_destroy (
+	struct pgm_send_burst_t*	burst
+	)
+{
+	pgm_assert (NULL != burst);
+
+	for (unsigned i = burst->head; i < burst->count; i++)
+		pgm_free_skb (burst->skb[i]);
+	pgm_free (burst->msg);
+	pgm_free (burst->iov);
+	pgm_free (burst->sent);
+	pgm_free (burst->skb);
+	pgm_free (burst);
+}
+
+/* locked and rate regulated sendmmsg of queued packets pgm_send_burst_t::skb
+ * from head to count, rate regulation applies to the entire burst.  router alert
+ * bursts use the dedicated socket without the send lock as per pgm_sendto_hops().
+ *
+ * on success, returns number of datagrams consumed with the byte count of each in
+ * pgm_send_burst_t::sent.  as per pgm_sendto_hops() a blocked socket is polled for
+ * up to 500ms and the datagram retried once, datagrams still failing are consumed
+ * with a zero count.  on error, -1 is returned, and errno set appropriately, for
+ * would-block, or ENOBUFS on non-blocking sockets, when no datagram was consumed.
+ */
+
+PGM_GNUC_INTERNAL
+int
+pgm_sendto_burst (
+	pgm_sock_t*		 restrict sock,
+	bool				  use_rate_limit,
+	pgm_rate_t*		 restrict minor_rate_control,
+	bool				  use_router_alert,
+	struct pgm_send_burst_t* restrict burst,
+	const struct sockaddr*	 restrict to,
+	socklen_t			  tolen
+	)
+{
+	pgm_assert( NULL != sock );
+	pgm_assert( NULL != burst );
+	pgm_assert( burst->head < burst->count );
+	pgm_assert( NULL != to );
+	pgm_assert( tolen > 0 );
+
+#ifdef HAVE_SENDMMSG
+	const SOCKET send_sock = use_router_alert ? sock->send_with_router_alert_sock : sock->send_sock;
+	struct mmsghdr* msgvec = (struct mmsghdr*)burst->msg + burst->head;
+	const unsigned vlen = burst->count - burst->head;
+	unsigned done = 0;
+	bool is_retry = FALSE;
+
+	if (use_rate_limit)
+	{
+		size_t len = 0;
+		for (unsigned i = burst->head; i < burst->count; i++)
+			len += sock->iphdr_len + ((char*)burst->skb[i]->tail - (char*)burst->skb[i]->head);
+		len -= sock->iphdr_len;		/* bucket includes 1 × IP header len */
+		if (NULL == minor_rate_control ?
+			!pgm_rate_check (&sock->rate_control, len, sock->is_nonblocking) :
+			!pgm_rate_check2 (&sock->rate_control, minor_rate_control, len, sock->is_nonblocking))
+		{
+			pgm_set_last_sock_error (PGM_SOCK_ENOBUFS);
+			return -1;
+		}
+	}
+
+	memcpy (&burst->name, to, tolen);
+	for (unsigned i = 0; i < vlen; i++)
+	{
+		const struct pgm_sk_buff_t* skb = burst->skb[burst->head + i];
+		struct pgm_iovec* iov = &burst->iov[burst->head + i];
+		iov->iov_base = skb->head;
+		iov->iov_len  = (char*)skb->tail - (char*)skb->head;
+		msgvec[i].msg_hdr.msg_name	 = &burst->name;
+		msgvec[i].msg_hdr.msg_namelen	 = tolen;
+		msgvec[i].msg_hdr.msg_iov	 = (struct iovec*)iov;
+		msgvec[i].msg_hdr.msg_iovlen	 = 1;
+		msgvec[i].msg_hdr.msg_control	 = NULL;
+		msgvec[i].msg_hdr.msg_controllen = 0;
+		msgvec[i].msg_hdr.msg_flags	 = 0;
+		msgvec[i].msg_len		 = 0;
+	}
+
+	int flags = 0;
+#ifdef MSG_ZEROCOPY
+	if (NULL != sock->zerocopy &&
+	    !use_router_alert &&
+	    &default_sendmmsg == priv_sendmmsg)
+	{
+		flags = MSG_ZEROCOPY;
+		for (unsigned i = 0; i < vlen; i++)
+			if (burst->iov[burst->head + i].iov_len < sock->zerocopy_min) {
+				flags = 0;
+				break;
+			}
+	}
+#endif
+
+	if (!use_router_alert && sock->can_send_data)
+		pgm_mutex_lock (&sock->send_mutex);
+	while (done < vlen)
+	{
+		const int sent = (*priv_sendmmsg)(send_sock, &msgvec[done], vlen - done, flags);
+		pgm_debug ("sendmmsg returned %d", sent);
+		burst->calls++;
+		if (sent > 0) {
+			is_retry = FALSE;
+			for (unsigned i = done; i < done + sent; i++) {
+				burst->sent[burst->head + i] = msgvec[i].msg_len;
+				if (0 != flags)
+					pgm_zerocopy_hold (sock->zerocopy, send_sock, burst->skb[burst->head + i]);
+			}
+			burst->datagrams += sent;
+			done += sent;
+			continue;
+		}
+		const int save_errno = pgm_get_last_sock_error();
+		if (0 != flags && PGM_SOCK_ENOBUFS == save_errno) {
+/* pinned pages exhaust the socket option memory limit, take completions and copy */
+			pgm_zerocopy_reap (sock->zerocopy, send_sock);
+			flags = 0;
+			continue;
+		}
+		if (PGM_SOCK_EAGAIN == save_errno ||
+		    (PGM_SOCK_ENOBUFS == save_errno && sock->is_nonblocking))
+		{
+			if (done > 0)
+				break;
+			if (!use_router_alert && sock->can_send_data)
+				pgm_mutex_unlock (&sock->send_mutex);
+			pgm_set_last_sock_error (save_errno);
+			return -1;
+		}
+/* poll for cleared socket and retry once as per pgm_sendto_hops() */
+		if (PGM_UNLIKELY(save_errno != PGM_SOCK_ENETUNREACH &&
+				 save_errno != PGM_SOCK_EHOSTUNREACH))
+		{
+			if (!is_retry) {
+				const int ready = wait_for_send (send_sock);
+				if (ready > 0) {
+					is_retry = TRUE;
+					continue;
+				}
+				if (ready == 0)
+				{
+					char toaddr[INET6_ADDRSTRLEN];
+					pgm_sockaddr_ntop (to, toaddr, sizeof(toaddr));
+					pgm_warn (_("sendmmsg() %s failed: socket timeout."), toaddr);
+				}
+				else
+				{
+					char errbuf[1024];
+					pgm_warn (_("blocked socket failed: %s"),
+						  pgm_sock_strerror_s (errbuf, sizeof (errbuf), pgm_get_last_sock_error()));
+				}
+			}
+			else
+			{
+				char errbuf[1024];
+				char toaddr[INET6_ADDRSTRLEN];
+				pgm_sockaddr_ntop (to, toaddr, sizeof(toaddr));
+				pgm_warn (_("sendmmsg() %s failed: %s"),
+					toaddr,
+					pgm_sock_strerror_s (errbuf, sizeof (errbuf), save_errno));
+			}
+		}
+/* drop failing datagram and continue */
+		burst->sent[burst->head + done] = 0;
+		done++;
+		is_retry = FALSE;
+	}
+	if (!use_router_alert && sock->can_send_data)
+		pgm_mutex_unlock (&sock->send_mutex);
+	return (int)done;
+#else
+	pgm_set_last_sock_error (PGM_SOCK_EINVAL);
+	return -1;
+#endif /* HAVE_SENDMMSG */
+}
+
 /* socket helper, for setting pipe ends non-blocking
  *
  * on success, returns 0.  on error, returns -1, and sets errno appropriately.
@@ -258,7 +258,11 @@ pgm_parse_udp_encap (
 	return pgm_parse (skb, error);
 }
 
-/* will modify packet contents to calculate and check PGM checksum
+/* will modify packet contents to calculate and check PGM checksum.
+ *
+ * if skb::csum_deferred is set by the caller, verification of original data
+ * packets is left for pgm_verify_checksum() at delivery and the flag is kept,
+ * otherwise the flag is cleared.
  */
 static
 bool
@@ -270,8 +274,20 @@ pgm_parse (
 /* pre-conditions */
 	pgm_assert (NULL != skb);
 
+	if (skb->csum_deferred &&
+	    !(skb->pgm_header->pgm_checksum &&
+	      (PGM_ODATA == skb->pgm_header->pgm_type || PGM_RDATA == skb->pgm_header->pgm_type) &&
+	      !(skb->pgm_header->pgm_options & PGM_OPT_PARITY)))
+	{
+		skb->csum_deferred = 0;
+	}
+
 /* pgm_checksum == 0 means no transmitted checksum */
-	if (skb->pgm_header->pgm_checksum)
+	if (skb->csum_deferred)
+	{
+		pgm_debug ("Deferred PGM checksum.");
+	}
+	else if (skb->pgm_header->pgm_checksum)
 	{
 		const uint16_t sum = skb->pgm_header->pgm_checksum;
 		skb->pgm_header->pgm_checksum = 0;
@@ -305,6 +321,46 @@ pgm_parse (
 	return TRUE;
 }
 
+/* complete checksum verification deferred by pgm_parse() on a data packet
+ * whose data pointer has been advanced to the payload.  The header and
+ * options are summed in place, the first len bytes of payload are summed
+ * whilst copying to dst, if provided, and the remainder in place.
+ *
+ * returns TRUE if the checksum is valid and clears skb::csum_deferred.
+ */
+
+PGM_GNUC_INTERNAL
+bool
+pgm_verify_checksum (
+	struct pgm_sk_buff_t* const restrict skb,
+	void*			    restrict dst,	/* may be NULL */
+	const uint16_t			     len	/* bytes to copy */
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != skb);
+	pgm_assert (skb->csum_deferred);
+	pgm_assert (NULL == dst || len <= skb->len);
+
+	const uint16_t header_length = (uint16_t)((char*)skb->data - (char*)skb->pgm_header);
+	const uint16_t copy_length = dst ? len : 0;
+	uint32_t data_csum = dst ? pgm_csum_partial_copy (skb->data, dst, copy_length, 0) : 0;
+	if (copy_length < skb->len)
+		data_csum = pgm_csum_block_add (data_csum,
+						pgm_csum_partial ((const char*)skb->data + copy_length, skb->len - copy_length, 0),
+						copy_length);
+	const uint32_t csum = pgm_csum_block_add (pgm_csum_partial (skb->pgm_header, header_length, 0),
+						  data_csum,
+						  header_length);
+
+/* summed including the transmitted checksum a valid packet folds to all ones */
+	if (PGM_UNLIKELY(0xffff != pgm_csum_fold (csum)))
+		return FALSE;
+
+	skb->csum_deferred = 0;
+	return TRUE;
+}
+
 /* 8.1.  Source Path Messages (SPM)
  *
  *  0                   1                   2                   3
@@ -239,6 +239,52 @@ START_TEST (test_parse_udp_encap_fail_001)
 }
 END_TEST
 
+/* target:
+ *	bool
+ *	pgm_verify_checksum (
+ *		struct pgm_sk_buff_t* const	skb,
+ *		void*				dst,
+ *		const uint16_t			len
+ *	)
+ */
+
+/* deferred on parse, verified whilst copying part of the payload */
+START_TEST (test_verify_checksum_pass_001)
+{
+	pgm_error_t* err = NULL;
+	char buf[1500];
+	struct pgm_sk_buff_t* skb = generate_udp_encap_pgm ();
+	skb->csum_deferred = 1;
+	fail_unless (TRUE == pgm_parse_udp_encap (skb, &err), "parse_udp_encap failed");
+	fail_unless (1 == skb->csum_deferred, "parse_udp_encap failed");
+	pgm_skb_pull (skb, sizeof(struct pgm_header) + sizeof(struct pgm_data));
+	fail_unless (TRUE == pgm_verify_checksum (skb, buf, 5), "verify_checksum failed");
+	fail_unless (0 == skb->csum_deferred, "verify_checksum failed");
+	fail_unless (0 == memcmp (buf, skb->data, 5), "verify_checksum failed");
+}
+END_TEST
+
+/* corrupt payload */
+START_TEST (test_verify_checksum_pass_002)
+{
+	pgm_error_t* err = NULL;
+	struct pgm_sk_buff_t* skb = generate_udp_encap_pgm ();
+	skb->csum_deferred = 1;
+	fail_unless (TRUE == pgm_parse_udp_encap (skb, &err), "parse_udp_encap failed");
+	pgm_skb_pull (skb, sizeof(struct pgm_header) + sizeof(struct pgm_data));
+	((char*)skb->data)[3] ^= 0x40;
+	fail_unless (FALSE == pgm_verify_checksum (skb, NULL, 0), "verify_checksum failed");
+	fail_unless (1 == skb->csum_deferred, "verify_checksum failed");
+}
+END_TEST
+
+START_TEST (test_verify_checksum_fail_001)
+{
+	pgm_verify_checksum (NULL, NULL, 0);
+	fail ("reached");
+}
+END_TEST
+
 /* target:
  *	bool
  *	pgm_verify_spm (
@@ -357,6 +403,14 @@ make_test_suite (void)
 	tcase_add_test_raise_signal (tc_parse_udp_encap, test_parse_udp_encap_fail_001, SIGABRT);
 #endif
 
+	TCase* tc_verify_checksum = tcase_create ("verify-checksum");
+	suite_add_tcase (s, tc_verify_checksum);
+	tcase_add_test (tc_verify_checksum, test_verify_checksum_pass_001);
+	tcase_add_test (tc_verify_checksum, test_verify_checksum_pass_002);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_verify_checksum, test_verify_checksum_fail_001, SIGABRT);
+#endif
+
 	TCase* tc_verify_spm = tcase_create ("verify-spm");
 	suite_add_tcase (s, tc_verify_spm);
 	tcase_add_test (tc_verify_spm, test_verify_spm_pass_001);
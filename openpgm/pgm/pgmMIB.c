@@ -998,7 +998,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCEDATABYTESSENT:
 				{
-					const unsigned data_bytes = sock->cumulative_stats[PGM_PC_SOURCE_DATA_BYTES_SENT];
+					const unsigned data_bytes = pgm_sock_stats_read (sock, PGM_PC_SOURCE_DATA_BYTES_SENT);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&data_bytes, sizeof(data_bytes) );
 				}
@@ -1006,7 +1006,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCEDATAMSGSSENT:
 				{
-					const unsigned data_msgs = sock->cumulative_stats[PGM_PC_SOURCE_DATA_MSGS_SENT];
+					const unsigned data_msgs = pgm_sock_stats_read (sock, PGM_PC_SOURCE_DATA_MSGS_SENT);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&data_msgs, sizeof(data_msgs) );
 				}
@@ -1031,7 +1031,7 @@ pgmSourcePerformanceTable_handler (
 /* PGM_PC_SOURCE_SELECTIVE_BYTES_RETRANSMITTED + COLUMN_PGMSOURCEPARITYBYTESRETRANSMITTED */
 			case COLUMN_PGMSOURCEBYTESRETRANSMITTED:
 				{
-					const unsigned bytes_resent = sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_BYTES_RETRANSMITTED];
+					const unsigned bytes_resent = pgm_sock_stats_read (sock, PGM_PC_SOURCE_SELECTIVE_BYTES_RETRANSMITTED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&bytes_resent, sizeof(bytes_resent) );
 				}
@@ -1040,7 +1040,7 @@ pgmSourcePerformanceTable_handler (
 /* PGM_PC_SOURCE_SELECTIVE_MSGS_RETRANSMITTED + COLUMN_PGMSOURCEPARITYMSGSRETRANSMITTED */
 			case COLUMN_PGMSOURCEMSGSRETRANSMITTED:
 				{
-					const unsigned msgs_resent = sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_MSGS_RETRANSMITTED];
+					const unsigned msgs_resent = pgm_sock_stats_read (sock, PGM_PC_SOURCE_SELECTIVE_MSGS_RETRANSMITTED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&msgs_resent, sizeof(msgs_resent) );
 				}
@@ -1048,7 +1048,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCEBYTESSENT:
 				{
-					const unsigned bytes_sent = sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT];
+					const unsigned bytes_sent = pgm_sock_stats_read (sock, PGM_PC_SOURCE_BYTES_SENT);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&bytes_sent, sizeof(bytes_sent) );
 				}
@@ -1057,7 +1057,7 @@ pgmSourcePerformanceTable_handler (
 /* COLUMN_PGMSOURCEPARITYNAKPACKETSRECEIVED + COLUMN_PGMSOURCESELECTIVENAKPACKETSRECEIVED */
 			case COLUMN_PGMSOURCERAWNAKSRECEIVED:
 				{
-					const unsigned nak_packets = sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED];
+					const unsigned nak_packets = pgm_sock_stats_read (sock, PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&nak_packets, sizeof(nak_packets) );
 				}
@@ -1066,7 +1066,7 @@ pgmSourcePerformanceTable_handler (
 /* PGM_PC_SOURCE_SELECTIVE_NAKS_IGNORED + COLUMN_PGMSOURCEPARITYNAKSIGNORED */
 			case COLUMN_PGMSOURCENAKSIGNORED:
 				{
-					const unsigned naks_ignored = sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NAKS_IGNORED];
+					const unsigned naks_ignored = pgm_sock_stats_read (sock, PGM_PC_SOURCE_SELECTIVE_NAKS_IGNORED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&naks_ignored, sizeof(naks_ignored) );
 				}
@@ -1074,7 +1074,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCECKSUMERRORS:
 				{
-					const unsigned cksum_errors = sock->cumulative_stats[PGM_PC_SOURCE_CKSUM_ERRORS];
+					const unsigned cksum_errors = pgm_sock_stats_read (sock, PGM_PC_SOURCE_CKSUM_ERRORS);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&cksum_errors, sizeof(cksum_errors) );
 				}
@@ -1082,7 +1082,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCEMALFORMEDNAKS:
 				{
-					const unsigned malformed_naks = sock->cumulative_stats[PGM_PC_SOURCE_MALFORMED_NAKS];
+					const unsigned malformed_naks = pgm_sock_stats_read (sock, PGM_PC_SOURCE_MALFORMED_NAKS);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&malformed_naks, sizeof(malformed_naks) );
 				}
@@ -1090,7 +1090,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCEPACKETSDISCARDED:
 				{
-					const unsigned packets_discarded = sock->cumulative_stats[PGM_PC_SOURCE_PACKETS_DISCARDED];
+					const unsigned packets_discarded = pgm_sock_stats_read (sock, PGM_PC_SOURCE_PACKETS_DISCARDED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&packets_discarded, sizeof(packets_discarded) );
 				}
@@ -1099,7 +1099,7 @@ pgmSourcePerformanceTable_handler (
 /* PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED + COLUMN_PGMSOURCEPARITYNAKSRECEIVED */
 			case COLUMN_PGMSOURCENAKSRCVD:
 				{
-					const unsigned naks_received = sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED];
+					const unsigned naks_received = pgm_sock_stats_read (sock, PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&naks_received, sizeof(naks_received) );
 				}
@@ -1116,7 +1116,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCESELECTIVEBYTESRETRANSMITED:
 				{
-					const unsigned selective_bytes_resent = sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_BYTES_RETRANSMITTED];
+					const unsigned selective_bytes_resent = pgm_sock_stats_read (sock, PGM_PC_SOURCE_SELECTIVE_BYTES_RETRANSMITTED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&selective_bytes_resent, sizeof(selective_bytes_resent) );
 				}
@@ -1133,7 +1133,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCESELECTIVEMSGSRETRANSMITTED:
 				{
-					const unsigned selective_msgs_resent = sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_MSGS_RETRANSMITTED];
+					const unsigned selective_msgs_resent = pgm_sock_stats_read (sock, PGM_PC_SOURCE_SELECTIVE_MSGS_RETRANSMITTED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&selective_msgs_resent, sizeof(selective_msgs_resent) );
 				}
@@ -1168,7 +1168,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCESELECTIVENAKPACKETSRECEIVED:
 				{
-					const unsigned selective_nak_packets = sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED];
+					const unsigned selective_nak_packets = pgm_sock_stats_read (sock, PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&selective_nak_packets, sizeof(selective_nak_packets) );
 				}
@@ -1185,7 +1185,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCESELECTIVENAKSRECEIVED:
 				{
-					const unsigned selective_naks = sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED];
+					const unsigned selective_naks = pgm_sock_stats_read (sock, PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&selective_naks, sizeof(selective_naks) );
 				}
@@ -1202,7 +1202,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCESELECTIVENAKSIGNORED:
 				{
-					const unsigned selective_naks_ignored = sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NAKS_IGNORED];
+					const unsigned selective_naks_ignored = pgm_sock_stats_read (sock, PGM_PC_SOURCE_SELECTIVE_NAKS_IGNORED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&selective_naks_ignored, sizeof(selective_naks_ignored) );
 				}
@@ -1210,7 +1210,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCEACKERRORS:
 				{
-					const unsigned ack_errors = sock->cumulative_stats[PGM_PC_SOURCE_ACK_ERRORS];;
+					const unsigned ack_errors = pgm_sock_stats_read (sock, PGM_PC_SOURCE_ACK_ERRORS);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&ack_errors, sizeof(ack_errors) );
 				}
@@ -1231,7 +1231,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCETRANSMISSIONCURRENTRATE:
 				{
-					const unsigned tx_current_rate = sock->cumulative_stats[PGM_PC_SOURCE_TRANSMISSION_CURRENT_RATE];
+					const unsigned tx_current_rate = pgm_sock_stats_read (sock, PGM_PC_SOURCE_TRANSMISSION_CURRENT_RATE);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&tx_current_rate, sizeof(tx_current_rate) );
 				}
@@ -1239,7 +1239,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCEACKPACKETSRECEIVED:
 				{
-					const unsigned ack_packets = sock->cumulative_stats[PGM_PC_SOURCE_ACK_PACKETS_RECEIVED];
+					const unsigned ack_packets = pgm_sock_stats_read (sock, PGM_PC_SOURCE_ACK_PACKETS_RECEIVED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&ack_packets, sizeof(ack_packets) );
 				}
@@ -1248,7 +1248,7 @@ pgmSourcePerformanceTable_handler (
 /* COLUMN_PGMSOURCEPARITYNNAKPACKETSRECEIVED + COLUMN_PGMSOURCESELECTIVENNAKPACKETSRECEIVED */
 			case COLUMN_PGMSOURCENNAKPACKETSRECEIVED:
 				{
-					const unsigned nnak_packets = sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NNAK_PACKETS_RECEIVED];
+					const unsigned nnak_packets = pgm_sock_stats_read (sock, PGM_PC_SOURCE_SELECTIVE_NNAK_PACKETS_RECEIVED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&nnak_packets, sizeof(nnak_packets) );
 				}
@@ -1265,7 +1265,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCESELECTIVENNAKPACKETSRECEIVED:
 				{
-					const unsigned selective_nnak_packets = sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NNAK_PACKETS_RECEIVED];
+					const unsigned selective_nnak_packets = pgm_sock_stats_read (sock, PGM_PC_SOURCE_SELECTIVE_NNAK_PACKETS_RECEIVED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&selective_nnak_packets, sizeof(selective_nnak_packets) );
 				}
@@ -1274,7 +1274,7 @@ pgmSourcePerformanceTable_handler (
 /* COLUMN_PGMSOURCEPARITYNNAKSRECEIVED + COLUMN_PGMSOURCESELECTIVENNAKSRECEIVED */
 			case COLUMN_PGMSOURCENNAKSRECEIVED:
 				{
-					const unsigned nnaks_received = sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NNAKS_RECEIVED];
+					const unsigned nnaks_received = pgm_sock_stats_read (sock, PGM_PC_SOURCE_SELECTIVE_NNAKS_RECEIVED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&nnaks_received, sizeof(nnaks_received) );
 				}
@@ -1291,7 +1291,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCESELECTIVENNAKSRECEIVED:
 				{
-					const unsigned selective_nnaks = sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NNAKS_RECEIVED];
+					const unsigned selective_nnaks = pgm_sock_stats_read (sock, PGM_PC_SOURCE_SELECTIVE_NNAKS_RECEIVED);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&selective_nnaks, sizeof(selective_nnaks) );
 				}
@@ -1299,7 +1299,7 @@ pgmSourcePerformanceTable_handler (
 
 			case COLUMN_PGMSOURCENNAKERRORS:
 				{
-					const unsigned malformed_nnaks = sock->cumulative_stats[PGM_PC_SOURCE_NNAK_ERRORS];
+					const unsigned malformed_nnaks = pgm_sock_stats_read (sock, PGM_PC_SOURCE_NNAK_ERRORS);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&malformed_nnaks, sizeof(malformed_nnaks) );
 				}
@@ -2353,7 +2353,7 @@ pgmReceiverPerformanceTable_handler (
 
 			case COLUMN_PGMRECEIVERDATABYTESRECEIVED:
 				{
-					const unsigned data_bytes = peer->cumulative_stats[PGM_PC_RECEIVER_DATA_BYTES_RECEIVED];
+					const unsigned data_bytes = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_DATA_BYTES_RECEIVED]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&data_bytes, sizeof(data_bytes) );
 				}
@@ -2361,7 +2361,7 @@ pgmReceiverPerformanceTable_handler (
 		
 			case COLUMN_PGMRECEIVERDATAMSGSRECEIVED:
 				{
-					const unsigned data_msgs = peer->cumulative_stats[PGM_PC_RECEIVER_DATA_MSGS_RECEIVED];
+					const unsigned data_msgs = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_DATA_MSGS_RECEIVED]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&data_msgs, sizeof(data_msgs) );
 				}
@@ -2370,7 +2370,7 @@ pgmReceiverPerformanceTable_handler (
 /* total */
 			case COLUMN_PGMRECEIVERNAKSSENT:
 				{
-					const unsigned naks_sent = peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_SENT];
+					const unsigned naks_sent = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_SENT]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&naks_sent, sizeof(naks_sent) );
 				}
@@ -2379,7 +2379,7 @@ pgmReceiverPerformanceTable_handler (
 /* total */	
 			case COLUMN_PGMRECEIVERNAKSRETRANSMITTED:
 				{
-					const unsigned naks_resent = peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_RETRANSMITTED];
+					const unsigned naks_resent = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_RETRANSMITTED]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&naks_resent, sizeof(naks_resent) );
 				}
@@ -2388,7 +2388,7 @@ pgmReceiverPerformanceTable_handler (
 /* total */	
 			case COLUMN_PGMRECEIVERNAKFAILURES:
 				{
-					const unsigned nak_failures = peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_FAILED];
+					const unsigned nak_failures = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_FAILED]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&nak_failures, sizeof(nak_failures) );
 				}
@@ -2396,7 +2396,7 @@ pgmReceiverPerformanceTable_handler (
 		
 			case COLUMN_PGMRECEIVERBYTESRECEIVED:
 				{
-					const unsigned bytes_received = peer->cumulative_stats[PGM_PC_RECEIVER_BYTES_RECEIVED];
+					const unsigned bytes_received = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_BYTES_RECEIVED]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&bytes_received, sizeof(bytes_received) );
 				}
@@ -2405,16 +2405,16 @@ pgmReceiverPerformanceTable_handler (
 /* total */	
 			case COLUMN_PGMRECEIVERNAKSSUPPRESSED:
 				{
-					const unsigned naks_suppressed = peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_SUPPRESSED];
+					const unsigned naks_suppressed = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_SUPPRESSED]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&naks_suppressed, sizeof(naks_suppressed) );
 				}
 				break;
 	
-/* bogus: same as source checksum errors */	
+/* only failures of deferred verification can be attributed to a peer */
 			case COLUMN_PGMRECEIVERCKSUMERRORS:
 				{
-					const unsigned cksum_errors = sock->cumulative_stats[PGM_PC_SOURCE_CKSUM_ERRORS];
+					const unsigned cksum_errors = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_CKSUM_ERRORS]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&cksum_errors, sizeof(cksum_errors) );
 				}
@@ -2422,7 +2422,7 @@ pgmReceiverPerformanceTable_handler (
 		
 			case COLUMN_PGMRECEIVERMALFORMEDSPMS:
 				{
-					const unsigned malformed_spms = peer->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_SPMS];
+					const unsigned malformed_spms = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_SPMS]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&malformed_spms, sizeof(malformed_spms) );
 				}
@@ -2430,7 +2430,7 @@ pgmReceiverPerformanceTable_handler (
 		
 			case COLUMN_PGMRECEIVERMALFORMEDODATA:
 				{
-					const unsigned malformed_odata = peer->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_ODATA];
+					const unsigned malformed_odata = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_ODATA]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&malformed_odata, sizeof(malformed_odata) );
 				}
@@ -2438,7 +2438,7 @@ pgmReceiverPerformanceTable_handler (
 		
 			case COLUMN_PGMRECEIVERMALFORMEDRDATA:
 				{
-					const unsigned malformed_rdata = peer->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_RDATA];
+					const unsigned malformed_rdata = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_RDATA]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&malformed_rdata, sizeof(malformed_rdata) );
 				}
@@ -2446,7 +2446,7 @@ pgmReceiverPerformanceTable_handler (
 		
 			case COLUMN_PGMRECEIVERMALFORMEDNCFS:
 				{
-					const unsigned malformed_ncfs = peer->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_NCFS];
+					const unsigned malformed_ncfs = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_NCFS]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&malformed_ncfs, sizeof(malformed_ncfs) );
 				}
@@ -2454,7 +2454,7 @@ pgmReceiverPerformanceTable_handler (
 		
 			case COLUMN_PGMRECEIVERPACKETSDISCARDED:
 				{
-					const unsigned packets_discarded = peer->cumulative_stats[PGM_PC_RECEIVER_PACKETS_DISCARDED];
+					const unsigned packets_discarded = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_PACKETS_DISCARDED]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&packets_discarded, sizeof(packets_discarded) );
 				}
@@ -2486,7 +2486,7 @@ pgmReceiverPerformanceTable_handler (
 		
 			case COLUMN_PGMRECEIVERDUPSPMS:
 				{
-					const unsigned dup_spms = peer->cumulative_stats[PGM_PC_RECEIVER_DUP_SPMS];
+					const unsigned dup_spms = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_DUP_SPMS]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&dup_spms, sizeof(dup_spms) );
 				}
@@ -2494,7 +2494,7 @@ pgmReceiverPerformanceTable_handler (
 		
 			case COLUMN_PGMRECEIVERDUPDATAS:
 				{
-					const unsigned dup_data = peer->cumulative_stats[PGM_PC_RECEIVER_DUP_DATAS];
+					const unsigned dup_data = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_DUP_DATAS]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&dup_data, sizeof(dup_data) );
 				}
@@ -2512,7 +2512,7 @@ pgmReceiverPerformanceTable_handler (
 /* COLUMN_PGMRECEIVERPARITYNAKPACKETSSENT + COLUMN_PGMRECEIVERSELECTIVENAKPACKETSSENT */	
 			case COLUMN_PGMRECEIVERNAKPACKETSSENT:
 				{
-					const unsigned nak_packets = peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAK_PACKETS_SENT];
+					const unsigned nak_packets = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAK_PACKETS_SENT]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&nak_packets, sizeof(nak_packets) );
 				}
@@ -2529,7 +2529,7 @@ pgmReceiverPerformanceTable_handler (
 		
 			case COLUMN_PGMRECEIVERSELECTIVENAKPACKETSSENT:
 				{
-					const unsigned nak_packets = peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAK_PACKETS_SENT];
+					const unsigned nak_packets = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAK_PACKETS_SENT]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&nak_packets, sizeof(nak_packets) );
 				}
@@ -2546,7 +2546,7 @@ pgmReceiverPerformanceTable_handler (
 		
 			case COLUMN_PGMRECEIVERSELECTIVENAKSSENT:
 				{
-					const unsigned naks_sent = peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_SENT];
+					const unsigned naks_sent = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_SENT]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&naks_sent, sizeof(naks_sent) );
 				}
@@ -2563,7 +2563,7 @@ pgmReceiverPerformanceTable_handler (
 		
 			case COLUMN_PGMRECEIVERSELECTIVENAKSRETRANSMITTED:
 				{
-					const unsigned naks_resent = peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_RETRANSMITTED];
+					const unsigned naks_resent = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_RETRANSMITTED]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&naks_resent, sizeof(naks_resent) );
 				}
@@ -2572,7 +2572,7 @@ pgmReceiverPerformanceTable_handler (
 /* COLUMN_PGMRECEIVERPARITYNAKSFAILED + COLUMN_PGMRECEIVERSELECTIVENAKSFAILED */	
 			case COLUMN_PGMRECEIVERNAKSFAILED:
 				{
-					const unsigned naks_failed = peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_FAILED];
+					const unsigned naks_failed = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_FAILED]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&naks_failed, sizeof(naks_failed) );
 				}
@@ -2589,7 +2589,7 @@ pgmReceiverPerformanceTable_handler (
 		
 			case COLUMN_PGMRECEIVERSELECTIVENAKSFAILED:
 				{
-					const unsigned naks_failed = peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_FAILED];
+					const unsigned naks_failed = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_FAILED]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&naks_failed, sizeof(naks_failed) );
 				}
@@ -2597,7 +2597,7 @@ pgmReceiverPerformanceTable_handler (
 		
 			case COLUMN_PGMRECEIVERNAKSFAILEDRXWADVANCED:
 				{
-					const unsigned rxw_failed = peer->cumulative_stats[PGM_PC_RECEIVER_NAKS_FAILED_RXW_ADVANCED];
+					const unsigned rxw_failed = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_NAKS_FAILED_RXW_ADVANCED]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&rxw_failed, sizeof(rxw_failed) );
 				}
@@ -2605,7 +2605,7 @@ pgmReceiverPerformanceTable_handler (
 		
 			case COLUMN_PGMRECEIVERNAKSFALEDNCFRETRIESEXCEEDED:
 				{
-					const unsigned ncf_retries = peer->cumulative_stats[PGM_PC_RECEIVER_NAKS_FAILED_NCF_RETRIES_EXCEEDED];
+					const unsigned ncf_retries = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_NAKS_FAILED_NCF_RETRIES_EXCEEDED]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&ncf_retries, sizeof(ncf_retries) );
 				}
@@ -2613,7 +2613,7 @@ pgmReceiverPerformanceTable_handler (
 		
 			case COLUMN_PGMRECEIVERNAKSFAILEDDATARETRIESEXCEEDED:
 				{
-					const unsigned data_retries = peer->cumulative_stats[PGM_PC_RECEIVER_NAKS_FAILED_DATA_RETRIES_EXCEEDED];
+					const unsigned data_retries = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_NAKS_FAILED_DATA_RETRIES_EXCEEDED]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&data_retries, sizeof(data_retries) );
 				}
@@ -2630,7 +2630,7 @@ pgmReceiverPerformanceTable_handler (
 		
 			case COLUMN_PGMRECEIVERNAKFAILURESDELIVERED:
 				{
-					const unsigned delivered = peer->cumulative_stats[PGM_PC_RECEIVER_NAK_FAILURES_DELIVERED];
+					const unsigned delivered = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_NAK_FAILURES_DELIVERED]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&delivered, sizeof(delivered) );
 				}
@@ -2647,7 +2647,7 @@ pgmReceiverPerformanceTable_handler (
 		
 			case COLUMN_PGMRECEIVERSELECTIVENAKSSUPPRESSED:
 				{
-					const unsigned suppressed = peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_SUPPRESSED];
+					const unsigned suppressed = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_SUPPRESSED]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&suppressed, sizeof(suppressed) );
 				}
@@ -2655,7 +2655,7 @@ pgmReceiverPerformanceTable_handler (
 		
 			case COLUMN_PGMRECEIVERNAKERRORS:
 				{
-					const unsigned malformed_naks = peer->cumulative_stats[PGM_PC_RECEIVER_NAK_ERRORS];
+					const unsigned malformed_naks = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_NAK_ERRORS]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&malformed_naks, sizeof(malformed_naks) );
 				}
@@ -2672,7 +2672,7 @@ pgmReceiverPerformanceTable_handler (
 		
 			case COLUMN_PGMRECEIVEROUTSTANDINGSELECTIVENAKS:
 				{
-					const unsigned outstanding_selective = window->nak_backoff_queue.length +
+					const unsigned outstanding_selective = window->nak_backoff_count +
 										window->wait_ncf_queue.length +
 										window->wait_data_queue.length;
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
@@ -2702,7 +2702,7 @@ pgmReceiverPerformanceTable_handler (
 		
 			case COLUMN_PGMRECEIVERNAKSVCTIMEMEAN:
 				{
-					const unsigned mean_repair_time = peer->cumulative_stats[PGM_PC_RECEIVER_NAK_SVC_TIME_MEAN];
+					const unsigned mean_repair_time = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_NAK_SVC_TIME_MEAN]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&mean_repair_time, sizeof(mean_repair_time) );
 				}
@@ -2726,7 +2726,7 @@ pgmReceiverPerformanceTable_handler (
 		
 			case COLUMN_PGMRECEIVERNAKFAILTIMEMEAN:
 				{
-					const unsigned mean_fail_time = peer->cumulative_stats[PGM_PC_RECEIVER_NAK_FAIL_TIME_MEAN];
+					const unsigned mean_fail_time = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_NAK_FAIL_TIME_MEAN]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&mean_fail_time, sizeof(mean_fail_time) );
 				}
@@ -2750,7 +2750,7 @@ pgmReceiverPerformanceTable_handler (
 		
 			case COLUMN_PGMRECEIVERNAKTRANSMITMEAN:
 				{
-					const unsigned mean_transmit_count = peer->cumulative_stats[PGM_PC_RECEIVER_TRANSMIT_MEAN];
+					const unsigned mean_transmit_count = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_TRANSMIT_MEAN]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&mean_transmit_count, sizeof(mean_transmit_count) );
 				}
@@ -2766,7 +2766,7 @@ pgmReceiverPerformanceTable_handler (
 	
 			case COLUMN_PGMRECEIVERACKSSENT:
 				{
-					const unsigned acks_sent = peer->cumulative_stats[PGM_PC_RECEIVER_ACKS_SENT];
+					const unsigned acks_sent = pgm_atomic_read64 (&peer->cumulative_stats[PGM_PC_RECEIVER_ACKS_SENT]);
 					snmp_set_var_typed_value (var, ASN_COUNTER, /* ASN_COUNTER32 */
 								  (const u_char*)&acks_sent, sizeof(acks_sent) );
 				}
@@ -25,8 +25,95 @@
 #include <impl/framework.h>
 
 
+/* nanoseconds to transmit a packet at the bucket rate.
+ */
+
+static inline
+uint64_t
+_pgm_rate_cost (
+	const pgm_rate_t*	bucket,
+	const size_t		data_size
+	)
+{
+	return ((uint64_t)(bucket->iphdr_len + data_size) * UINT64_C(1000000000)) / bucket->rate_per_sec;
+}
+
+/* earliest permitted drain time, a full bucket.
+ */
+
+static inline
+uint64_t
+_pgm_rate_floor (
+	const pgm_rate_t*	bucket,
+	const uint64_t		now
+	)
+{
+	return now > bucket->burst ? now - bucket->burst : 0;
+}
+
+/* take cost nanoseconds of tokens, overdrawing the bucket unless non-blocking.
+ *
+ * returns TRUE and sets ready to the time the bucket is no longer overdrawn.
+ * returns FALSE if the bucket lacks tokens and non-blocking flag is set.
+ */
+
+static
+bool
+_pgm_rate_take (
+	pgm_rate_t*		bucket,
+	const uint64_t		now,
+	const uint64_t		cost,
+	const bool		is_nonblocking,
+	uint64_t*		ready
+	)
+{
+	uint64_t empty_at, new_empty_at;
+	do {
+		empty_at = pgm_atomic_read64 (&bucket->empty_at);
+		new_empty_at = MAX(empty_at, _pgm_rate_floor (bucket, now)) + cost;
+		if (is_nonblocking && new_empty_at > now)
+			return FALSE;
+	} while (!pgm_atomic_compare_and_exchange64 (&bucket->empty_at, new_empty_at, empty_at));
+	*ready = new_empty_at;
+	return TRUE;
+}
+
+/* return tokens taken for a packet that was not sent.
+ */
+
+static
+void
+_pgm_rate_refund (
+	pgm_rate_t*		bucket,
+	const uint64_t		cost
+	)
+{
+	uint64_t empty_at;
+	do {
+		empty_at = pgm_atomic_read64 (&bucket->empty_at);
+	} while (!pgm_atomic_compare_and_exchange64 (&bucket->empty_at, empty_at - cost, empty_at));
+}
+
+/* yield until an overdrawn bucket has refilled.
+ */
+
+static
+void
+_pgm_rate_wait (
+	const uint64_t		ready,
+	uint64_t		now
+	)
+{
+	while (now < ready) {
+		pgm_thread_yield();
+		now = pgm_to_nsecs (pgm_time_update_now());
+	}
+}
+
 /* create machinery for rate regulation.
- * the rate_per_sec is ammortized over millisecond time periods.
+ * the bucket holds one millisecond of the rate_per_sec, or one second when
+ * a millisecond is smaller than one TPDU, and refills continuously with
+ * nanosecond resolution.
  *
  * NB: bucket MUST be memset 0 before calling.
  */
@@ -46,15 +133,31 @@ pgm_rate_create (
 
 	bucket->rate_per_sec	= rate_per_sec;
 	bucket->iphdr_len	= iphdr_len;
-	bucket->last_rate_check	= pgm_time_update_now ();
+	if ((rate_per_sec / 1000) >= max_tpdu)
+		bucket->burst	= pgm_to_nsecs (pgm_msecs (1));
+	else
+		bucket->burst	= pgm_to_nsecs (pgm_secs (1));
 /* pre-fill bucket */
-	if ((rate_per_sec / 1000) >= max_tpdu) {
-		bucket->rate_per_msec	= bucket->rate_per_sec / 1000;
-		bucket->rate_limit	= bucket->rate_per_msec;
-	} else {
-		bucket->rate_limit	= bucket->rate_per_sec;
-	}
-	pgm_spinlock_init (&bucket->spinlock);
+	bucket->empty_at	= _pgm_rate_floor (bucket, pgm_to_nsecs (pgm_time_update_now ()));
+}
+
+/* shrink the bucket to one TPDU so that packets leave evenly spaced at the
+ * configured rate instead of in millisecond bursts.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_rate_set_pacing (
+	pgm_rate_t*		bucket,
+	const uint16_t		max_tpdu
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != bucket);
+	pgm_assert (bucket->rate_per_sec > 0);
+
+	bucket->burst		= _pgm_rate_cost (bucket, max_tpdu);
+	bucket->empty_at	= _pgm_rate_floor (bucket, pgm_to_nsecs (pgm_time_update_now ()));
 }
 
 PGM_GNUC_INTERNAL
@@ -66,7 +169,7 @@ pgm_rate_destroy (
 /* pre-conditions */
 	pgm_assert (NULL != bucket);
 
-	pgm_spinlock_free (&bucket->spinlock);
+	bucket->rate_per_sec = 0;
 }
 
 /* check bit bucket whether an operation can proceed or should wait.
@@ -84,8 +187,7 @@ pgm_rate_check2 (
 	const bool		is_nonblocking
 	)
 {
-	int64_t new_major_limit, new_minor_limit;
-	pgm_time_t now;
+	uint64_t major_ready = 0, minor_ready = 0;
 
 /* pre-conditions */
 	pgm_assert (NULL != major_bucket);
@@ -95,112 +197,24 @@ pgm_rate_check2 (
 	if (0 == major_bucket->rate_per_sec && 0 == minor_bucket->rate_per_sec)
 		return TRUE;
 
-	if (0 != major_bucket->rate_per_sec)
-	{
-		pgm_spinlock_lock (&major_bucket->spinlock);
-		now = pgm_time_update_now();
-
-		if (major_bucket->rate_per_msec)
-		{
-			const pgm_time_t time_since_last_rate_check = now - major_bucket->last_rate_check;
-			if (time_since_last_rate_check > pgm_msecs(1)) 
-				new_major_limit = major_bucket->rate_per_msec;
-			else {
-				new_major_limit = major_bucket->rate_limit + ((major_bucket->rate_per_msec * time_since_last_rate_check) / 1000UL);
-				if (new_major_limit > major_bucket->rate_per_msec)
-					new_major_limit = major_bucket->rate_per_msec;
-			}
-		}
-		else
-		{
-			const pgm_time_t time_since_last_rate_check = now - major_bucket->last_rate_check;
-			if (time_since_last_rate_check > pgm_secs(1)) 
-				new_major_limit = major_bucket->rate_per_sec;
-			else {
-				new_major_limit = major_bucket->rate_limit + ((major_bucket->rate_per_sec * time_since_last_rate_check) / 1000000UL);
-				if (new_major_limit > major_bucket->rate_per_sec)
-					new_major_limit = major_bucket->rate_per_sec;
-			}
-		}
-
-		new_major_limit -= ( major_bucket->iphdr_len + data_size );
-		if (is_nonblocking && new_major_limit < 0) {
-			pgm_spinlock_unlock (&major_bucket->spinlock);
-			return FALSE;
-		}
-
-		if (new_major_limit < 0) {
-			const pgm_time_t wait_start = now;
-			ssize_t sleep_amount;
-			do {
-				pgm_thread_yield();
-				now = pgm_time_update_now();
-				sleep_amount = (ssize_t)pgm_to_secs (major_bucket->rate_per_sec * (now - wait_start));
-			} while (sleep_amount + new_major_limit < 0);
-			new_major_limit += sleep_amount;
-		} 
-	}
-	else
-	{
-/* ensure we have a timestamp */
-		now = pgm_time_update_now();
-	}
+	const uint64_t now = pgm_to_nsecs (pgm_time_update_now());
 
-	if (0 != minor_bucket->rate_per_sec)
+	if (0 != major_bucket->rate_per_sec &&
+	    !_pgm_rate_take (major_bucket, now, _pgm_rate_cost (major_bucket, data_size), is_nonblocking, &major_ready))
 	{
-		if (minor_bucket->rate_per_msec)
-		{
-			const pgm_time_t time_since_last_rate_check = now - minor_bucket->last_rate_check;
-			if (time_since_last_rate_check > pgm_msecs(1)) 
-				new_minor_limit = minor_bucket->rate_per_msec;
-			else {
-				new_minor_limit = minor_bucket->rate_limit + ((minor_bucket->rate_per_msec * time_since_last_rate_check) / 1000UL);
-				if (new_minor_limit > minor_bucket->rate_per_msec)
-					new_minor_limit = minor_bucket->rate_per_msec;
-			}
-		}
-		else
-		{
-			const pgm_time_t time_since_last_rate_check = now - minor_bucket->last_rate_check;
-			if (time_since_last_rate_check > pgm_secs(1)) 
-				new_minor_limit = minor_bucket->rate_per_sec;
-			else {
-				new_minor_limit = minor_bucket->rate_limit + ((minor_bucket->rate_per_sec * time_since_last_rate_check) / 1000000UL);
-				if (new_minor_limit > minor_bucket->rate_per_sec)
-					new_minor_limit = minor_bucket->rate_per_sec;
-			}
-		}
-
-		new_minor_limit -= ( minor_bucket->iphdr_len + data_size );
-		if (is_nonblocking && new_minor_limit < 0) {
-			if (0 != major_bucket->rate_per_sec)
-				pgm_spinlock_unlock (&major_bucket->spinlock);
-			return FALSE;
-		}
-
-/* commit new rate limit */
-		minor_bucket->rate_limit = new_minor_limit;
-		minor_bucket->last_rate_check = now;
+		return FALSE;
 	}
 
-	if (0 != major_bucket->rate_per_sec) {
-		major_bucket->rate_limit = new_major_limit;
-		major_bucket->last_rate_check = now;
-		pgm_spinlock_unlock (&major_bucket->spinlock);
+	if (0 != minor_bucket->rate_per_sec &&
+	    !_pgm_rate_take (minor_bucket, now, _pgm_rate_cost (minor_bucket, data_size), is_nonblocking, &minor_ready))
+	{
+		if (0 != major_bucket->rate_per_sec)
+			_pgm_rate_refund (major_bucket, _pgm_rate_cost (major_bucket, data_size));
+		return FALSE;
 	}
 
-/* sleep on minor bucket outside of lock */
-	if (minor_bucket->rate_limit < 0) {
-		ssize_t sleep_amount;
-		do {
-			pgm_thread_yield();
-			now = pgm_time_update_now();
-			sleep_amount = (ssize_t)pgm_to_secs (minor_bucket->rate_per_sec * (now - minor_bucket->last_rate_check));
-		} while (sleep_amount + minor_bucket->rate_limit < 0);
-		minor_bucket->rate_limit += sleep_amount;
-		minor_bucket->last_rate_check = now;
-	} 
-
+/* sleep outside of both buckets */
+	_pgm_rate_wait (MAX(major_ready, minor_ready), now);
 	return TRUE;
 }
 
@@ -212,7 +226,7 @@ pgm_rate_check (
 	const bool		is_nonblocking
 	)
 {
-	int64_t new_rate_limit;
+	uint64_t ready;
 
 /* pre-conditions */
 	pgm_assert (NULL != bucket);
@@ -221,54 +235,35 @@ pgm_rate_check (
 	if (0 == bucket->rate_per_sec)
 		return TRUE;
 
-	pgm_spinlock_lock (&bucket->spinlock);
-	pgm_time_t now = pgm_time_update_now();
-
-	if (bucket->rate_per_msec)
-	{
-		const pgm_time_t time_since_last_rate_check = now - bucket->last_rate_check;
-		if (time_since_last_rate_check > pgm_msecs(1)) 
-			new_rate_limit = bucket->rate_per_msec;
-		else {
-			new_rate_limit = bucket->rate_limit + ((bucket->rate_per_msec * time_since_last_rate_check) / 1000UL);
-			if (new_rate_limit > bucket->rate_per_msec)
-				new_rate_limit = bucket->rate_per_msec;
-		}
-	}
-	else
-	{
-		const pgm_time_t time_since_last_rate_check = now - bucket->last_rate_check;
-		if (time_since_last_rate_check > pgm_secs(1)) 
-			new_rate_limit = bucket->rate_per_sec;
-		else {
-			new_rate_limit = bucket->rate_limit + ((bucket->rate_per_sec * time_since_last_rate_check) / 1000000UL);
-			if (new_rate_limit > bucket->rate_per_sec)
-				new_rate_limit = bucket->rate_per_sec;
-		}
-	}
-
-	new_rate_limit -= ( bucket->iphdr_len + data_size );
-	if (is_nonblocking && new_rate_limit < 0) {
-		pgm_spinlock_unlock (&bucket->spinlock);
+	const uint64_t now = pgm_to_nsecs (pgm_time_update_now());
+	if (!_pgm_rate_take (bucket, now, _pgm_rate_cost (bucket, data_size), is_nonblocking, &ready))
 		return FALSE;
-	}
 
-	bucket->rate_limit = new_rate_limit;
-	bucket->last_rate_check = now;
-	if (bucket->rate_limit < 0) {
-		ssize_t sleep_amount;
-		do {
-			pgm_thread_yield();
-			now = pgm_time_update_now();
-			sleep_amount = (ssize_t)pgm_to_secs (bucket->rate_per_sec * (now - bucket->last_rate_check));
-		} while (sleep_amount + bucket->rate_limit < 0);
-		bucket->rate_limit += sleep_amount;
-		bucket->last_rate_check = now;
-	} 
-	pgm_spinlock_unlock (&bucket->spinlock);
+	_pgm_rate_wait (ready, now);
 	return TRUE;
 }
 
+/* time until n bytes may be sent, rounded up to the next microsecond.
+ */
+
+static
+pgm_time_t
+_pgm_rate_remaining (
+	const pgm_rate_t*	bucket,
+	const uint64_t		now,
+	const size_t		n
+	)
+{
+	const uint64_t empty_at = pgm_atomic_read64 (&bucket->empty_at);
+	const uint64_t ready = MAX(empty_at, _pgm_rate_floor (bucket, now)) + _pgm_rate_cost (bucket, n);
+	if (ready <= now)
+		return 0;
+	return pgm_nsecs (ready - now + 999);
+}
+
+/* both buckets must permit the send so the longer wait wins.
+ */
+
 PGM_GNUC_INTERNAL
 pgm_time_t
 pgm_rate_remaining2 (
@@ -278,7 +273,6 @@ pgm_rate_remaining2 (
 	)
 {
 	pgm_time_t remaining = 0;
-	pgm_time_t now;
 
 /* pre-conditions */
 	pgm_assert (NULL != major_bucket);
@@ -287,40 +281,14 @@ pgm_rate_remaining2 (
 	if (PGM_UNLIKELY(0 == major_bucket->rate_per_sec && 0 == minor_bucket->rate_per_sec))
 		return remaining;
 
-	if (0 != major_bucket->rate_per_sec)
-	{
-		pgm_spinlock_lock (&major_bucket->spinlock);
-		now = pgm_time_update_now();
-		const int64_t bucket_bytes = major_bucket->rate_limit + pgm_to_secs (major_bucket->rate_per_sec * (now - major_bucket->last_rate_check)) - n;
-
-		if (bucket_bytes < 0) {
-			const int64_t outstanding_bytes = -bucket_bytes;
-			const pgm_time_t major_remaining = (1000000UL * outstanding_bytes) / major_bucket->rate_per_sec;
-			remaining = major_remaining;
-		}
-	}
-	else
-	{
-/* ensure we have a timestamp */
-		now = pgm_time_update_now();
-	}
-
-	if (0 != minor_bucket->rate_per_sec)
-	{
-		const int64_t bucket_bytes = minor_bucket->rate_limit + pgm_to_secs (minor_bucket->rate_per_sec * (now - minor_bucket->last_rate_check)) - n;
-
-		if (bucket_bytes < 0) {
-			const int64_t outstanding_bytes = -bucket_bytes;
-			const pgm_time_t minor_remaining = (1000000UL * outstanding_bytes) / minor_bucket->rate_per_sec;
-			remaining = remaining > 0 ? MIN(remaining, minor_remaining) : minor_remaining;
-		}
-	}
+	const uint64_t now = pgm_to_nsecs (pgm_time_update_now());
 
 	if (0 != major_bucket->rate_per_sec)
-	{
-		pgm_spinlock_unlock (&major_bucket->spinlock);
+		remaining = _pgm_rate_remaining (major_bucket, now, n);
+	if (0 != minor_bucket->rate_per_sec) {
+		const pgm_time_t minor_remaining = _pgm_rate_remaining (minor_bucket, now, n);
+		remaining = MAX(remaining, minor_remaining);
 	}
-
 	return remaining;
 }
 
@@ -337,19 +305,7 @@ pgm_rate_remaining (
 	if (PGM_UNLIKELY(0 == bucket->rate_per_sec))
 		return 0;
 
-	pgm_spinlock_lock (&bucket->spinlock);
-	const pgm_time_t now = pgm_time_update_now();
-	const pgm_time_t time_since_last_rate_check = now - bucket->last_rate_check;
-	const int64_t bucket_bytes = bucket->rate_limit + pgm_to_secs (bucket->rate_per_sec * time_since_last_rate_check) - n;
-	pgm_spinlock_unlock (&bucket->spinlock);
-
-	if (bucket_bytes >= 0)
-		return 0;
-
-	const int64_t outstanding_bytes = -bucket_bytes;
-	const pgm_time_t remaining = (1000000UL * outstanding_bytes) / bucket->rate_per_sec;
-
-	return remaining;
+	return _pgm_rate_remaining (bucket, pgm_to_nsecs (pgm_time_update_now()), n);
 }
 
 /* eof */
@@ -202,6 +202,69 @@ START_TEST (test_check_pass_003)
 }
 END_TEST
 
+/* 004: refills smaller than a byte per check accumulate.
+ */
+
+START_TEST (test_check_pass_004)
+{
+	pgm_rate_t rate;
+	memset (&rate, 0, sizeof(rate));
+	mock_pgm_time_now = 1;
+	pgm_rate_create (&rate, 1010*1000, 10, 1000);
+	mock_pgm_time_now += pgm_secs(2);
+	fail_unless (TRUE == pgm_rate_check (&rate, 1000, TRUE), "rate_check failed");
+	fail_unless (FALSE == pgm_rate_check (&rate, 1000, TRUE), "rate_check failed");
+/* one byte per microsecond, checked every microsecond */
+	for (unsigned i = 0; i < 999; i++) {
+		mock_pgm_time_now += pgm_usecs(1);
+		fail_unless (FALSE == pgm_rate_check (&rate, 1000, TRUE), "rate_check failed");
+	}
+	mock_pgm_time_now += pgm_usecs(1);
+	fail_unless (TRUE == pgm_rate_check (&rate, 1000, TRUE), "rate_check failed");
+	pgm_rate_destroy (&rate);
+}
+END_TEST
+
+/* target:
+ *	void
+ *	pgm_rate_set_pacing (
+ *		pgm_rate_t*		bucket,
+ *		const uint16_t		max_tpdu
+ *	)
+ */
+
+/* paced bucket permits one packet per interval instead of a millisecond burst.
+ */
+
+START_TEST (test_set_pacing_pass_001)
+{
+	pgm_rate_t rate;
+	memset (&rate, 0, sizeof(rate));
+	mock_pgm_time_now = 1;
+	pgm_rate_create (&rate, 2*1010*1000, 10, 1000);
+	pgm_rate_set_pacing (&rate, 1000);
+	mock_pgm_time_now += pgm_secs(2);
+	fail_unless (TRUE == pgm_rate_check (&rate, 1000, TRUE), "rate_check failed");
+	fail_unless (FALSE == pgm_rate_check (&rate, 1000, TRUE), "rate_check failed");
+	mock_pgm_time_now += pgm_usecs(250);
+	fail_unless (FALSE == pgm_rate_check (&rate, 1000, TRUE), "rate_check failed");
+	mock_pgm_time_now += pgm_usecs(250);
+	fail_unless (TRUE == pgm_rate_check (&rate, 1000, TRUE), "rate_check failed");
+/* idle time does not build a burst */
+	mock_pgm_time_now += pgm_secs(10);
+	fail_unless (TRUE == pgm_rate_check (&rate, 1000, TRUE), "rate_check failed");
+	fail_unless (FALSE == pgm_rate_check (&rate, 1000, TRUE), "rate_check failed");
+	pgm_rate_destroy (&rate);
+}
+END_TEST
+
+START_TEST (test_set_pacing_fail_001)
+{
+	pgm_rate_set_pacing (NULL, 1500);
+	fail ("reached");
+}
+END_TEST
+
 /* target:
  *	bool
  *	pgm_rate_check2 (
@@ -520,6 +583,66 @@ START_TEST (test_check2_pass_003)
 END_TEST
 
 
+/* 004: minor failure does not consume the major bucket.
+ */
+
+START_TEST (test_check2_pass_004)
+{
+	pgm_rate_t major, minor;
+	memset (&major, 0, sizeof(major));
+	memset (&minor, 0, sizeof(minor));
+	mock_pgm_time_now = 1;
+	pgm_rate_create (&major, 2*1010, 10, 1500);
+	pgm_rate_create (&minor, 1*1010, 10, 1000);
+	mock_pgm_time_now += pgm_secs(2);
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2 failed");
+	fail_unless (FALSE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2 failed");
+	fail_unless (TRUE == pgm_rate_check (&major, 1000, TRUE), "rate_check failed");
+	pgm_rate_destroy (&major);
+	pgm_rate_destroy (&minor);
+}
+END_TEST
+
+/* target:
+ *	pgm_time_t
+ *	pgm_rate_remaining2 (
+ *		pgm_rate_t*		major_bucket,
+ *		pgm_rate_t*		minor_bucket,
+ *		const size_t		n
+ *	)
+ */
+
+/* longer wait of both buckets.
+ */
+
+START_TEST (test_remaining2_pass_001)
+{
+	pgm_rate_t major, minor;
+	memset (&major, 0, sizeof(major));
+	memset (&minor, 0, sizeof(minor));
+	mock_pgm_time_now = 1;
+	pgm_rate_create (&major, 2*1010*1000, 10, 1000);
+	pgm_rate_create (&minor, 1010*1000, 10, 1000);
+	pgm_rate_set_pacing (&major, 1000);
+	pgm_rate_set_pacing (&minor, 1000);
+	mock_pgm_time_now += pgm_secs(2);
+	fail_unless (0 == pgm_rate_remaining2 (&major, &minor, 1000), "rate_remaining2 failed");
+	fail_unless (TRUE == pgm_rate_check2 (&major, &minor, 1000, TRUE), "rate_check2 failed");
+	fail_unless (pgm_usecs(1000) == pgm_rate_remaining2 (&major, &minor, 1000), "rate_remaining2 failed");
+	mock_pgm_time_now += pgm_usecs(400);
+	fail_unless (pgm_usecs(600) == pgm_rate_remaining2 (&major, &minor, 1000), "rate_remaining2 failed");
+	pgm_rate_destroy (&major);
+	pgm_rate_destroy (&minor);
+}
+END_TEST
+
+START_TEST (test_remaining2_fail_001)
+{
+	pgm_rate_remaining2 (NULL, NULL, 1000);
+	fail ("reached");
+}
+END_TEST
+
 static
 Suite*
 make_test_suite (void)
@@ -547,6 +670,7 @@ make_test_suite (void)
 	tcase_add_test (tc_check, test_check_pass_001);
 	tcase_add_test (tc_check, test_check_pass_002);
 	tcase_add_test (tc_check, test_check_pass_003);
+	tcase_add_test (tc_check, test_check_pass_004);
 #ifndef PGM_CHECK_NOFORK
 	tcase_add_test_raise_signal (tc_check, test_check_fail_001, SIGABRT);
 #endif
@@ -556,9 +680,24 @@ make_test_suite (void)
 	tcase_add_test (tc_check2, test_check2_pass_001);
 	tcase_add_test (tc_check2, test_check2_pass_002);
 	tcase_add_test (tc_check2, test_check2_pass_003);
+	tcase_add_test (tc_check2, test_check2_pass_004);
 #ifndef PGM_CHECK_NOFORK
 	tcase_add_test_raise_signal (tc_check2, test_check2_fail_001, SIGABRT);
 #endif
+
+	TCase* tc_set_pacing = tcase_create ("set-pacing");
+	suite_add_tcase (s, tc_set_pacing);
+	tcase_add_test (tc_set_pacing, test_set_pacing_pass_001);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_set_pacing, test_set_pacing_fail_001, SIGABRT);
+#endif
+
+	TCase* tc_remaining2 = tcase_create ("remaining2");
+	suite_add_tcase (s, tc_remaining2);
+	tcase_add_test (tc_remaining2, test_remaining2_pass_001);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_remaining2, test_remaining2_fail_001, SIGABRT);
+#endif
 	return s;
 }
 
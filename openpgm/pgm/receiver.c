@@ -74,15 +74,10 @@ next_nak_rb_expiry (
 	const pgm_rxw_t*	window
 	)
 {
-	const struct pgm_sk_buff_t* skb;
-	const pgm_rxw_state_t* state;
-
 	pgm_assert (NULL != window);
-	pgm_assert (NULL != window->nak_backoff_queue.tail);
+	pgm_assert (window->nak_backoff_count > 0);
 
-	skb = (const struct pgm_sk_buff_t*)window->nak_backoff_queue.tail;
-	state = (const pgm_rxw_state_t*)&skb->cb;
-	return state->timer_expiry;
+	return window->nak_backoff_expiry;
 }
 
 static inline
@@ -91,15 +86,13 @@ next_nak_rpt_expiry (
 	const pgm_rxw_t*	window
 	)
 {
-	const struct pgm_sk_buff_t* skb;
-	const pgm_rxw_state_t* state;
+	const pgm_list_t* link;
 
 	pgm_assert (NULL != window);
 	pgm_assert (NULL != window->wait_ncf_queue.tail);
 
-	skb = (const struct pgm_sk_buff_t*)window->wait_ncf_queue.tail;
-	state = (const pgm_rxw_state_t*)&skb->cb;
-	return state->timer_expiry;
+	link = window->wait_ncf_queue.tail;
+	return window->timer_expiry[ link - window->link ];
 }
 
 static inline
@@ -108,15 +101,155 @@ next_nak_rdata_expiry (
 	const pgm_rxw_t*	window
 	)
 {
-	const struct pgm_sk_buff_t* skb;
-	const pgm_rxw_state_t* state;
+	const pgm_list_t* link;
 
 	pgm_assert (NULL != window);
 	pgm_assert (NULL != window->wait_data_queue.tail);
 
-	skb = (const struct pgm_sk_buff_t*)window->wait_data_queue.tail;
-	state = (const pgm_rxw_state_t*)&skb->cb;
-	return state->timer_expiry;
+	link = window->wait_data_queue.tail;
+	return window->timer_expiry[ link - window->link ];
+}
+
+/* earliest expiration of any state timer of a peer, bounded by the peer
+ * expiration itself.
+ */
+
+static
+pgm_time_t
+peer_next_expiry (
+	const pgm_peer_t*	peer
+	)
+{
+	pgm_time_t expiry = peer->expiry;
+
+	if (peer->spmr_expiry && pgm_time_after (expiry, peer->spmr_expiry))
+		expiry = peer->spmr_expiry;
+	if (peer->window->ack_backoff_queue.tail && pgm_time_after (expiry, next_ack_rb_expiry (peer->window)))
+		expiry = next_ack_rb_expiry (peer->window);
+	if (peer->window->nak_backoff_count && pgm_time_after (expiry, next_nak_rb_expiry (peer->window)))
+		expiry = next_nak_rb_expiry (peer->window);
+	if (peer->window->wait_ncf_queue.tail && pgm_time_after (expiry, next_nak_rpt_expiry (peer->window)))
+		expiry = next_nak_rpt_expiry (peer->window);
+	if (peer->window->wait_data_queue.tail && pgm_time_after (expiry, next_nak_rdata_expiry (peer->window)))
+		expiry = next_nak_rdata_expiry (peer->window);
+	return expiry;
+}
+
+/* indexed binary min-heap of peers on pgm_peer_t::next_expiry.
+ *
+ * A peer key may be earlier than its actual next expiry, such a peer is
+ * visited by the timer and re-keyed.  It must never be later, so arming any
+ * state timer must be followed by peer_timer_update().
+ */
+
+#define PEER_TIMER_DETACHED	UINT32_MAX
+
+static
+void
+peer_timer_sift_up (
+	pgm_sock_t*const	sock,
+	uint32_t		i
+	)
+{
+	pgm_peer_t** heap = sock->peers_timer;
+	pgm_peer_t* peer = heap[i];
+
+	while (i > 0) {
+		const uint32_t parent = (i - 1) / 2;
+		if (!pgm_time_after (heap[parent]->next_expiry, peer->next_expiry))
+			break;
+		heap[i] = heap[parent];
+		heap[i]->timer_index = i;
+		i = parent;
+	}
+	heap[i] = peer;
+	peer->timer_index = i;
+}
+
+static
+void
+peer_timer_sift_down (
+	pgm_sock_t*const	sock,
+	uint32_t		i
+	)
+{
+	pgm_peer_t** heap = sock->peers_timer;
+	pgm_peer_t* peer = heap[i];
+	const uint32_t len = sock->peers_timer_len;
+
+	for (;;) {
+		uint32_t child = (2 * i) + 1;
+		if (child >= len)
+			break;
+		if (child + 1 < len && pgm_time_after (heap[child]->next_expiry, heap[child + 1]->next_expiry))
+			child++;
+		if (!pgm_time_after (peer->next_expiry, heap[child]->next_expiry))
+			break;
+		heap[i] = heap[child];
+		heap[i]->timer_index = i;
+		i = child;
+	}
+	heap[i] = peer;
+	peer->timer_index = i;
+}
+
+static
+void
+peer_timer_insert (
+	pgm_sock_t*const restrict	sock,
+	pgm_peer_t*const restrict	peer
+	)
+{
+	if (sock->peers_timer_len == sock->peers_timer_size) {
+		sock->peers_timer_size = sock->peers_timer_size ? (2 * sock->peers_timer_size) : 16;
+		sock->peers_timer = pgm_realloc (sock->peers_timer, sock->peers_timer_size * sizeof(pgm_peer_t*));
+	}
+	peer->next_expiry = peer_next_expiry (peer);
+	sock->peers_timer[ sock->peers_timer_len ] = peer;
+	peer_timer_sift_up (sock, sock->peers_timer_len++);
+}
+
+static
+void
+peer_timer_remove (
+	pgm_sock_t*const restrict	sock,
+	pgm_peer_t*const restrict	peer
+	)
+{
+	const uint32_t i = peer->timer_index;
+
+	pgm_assert (i < sock->peers_timer_len);
+	pgm_assert (peer == sock->peers_timer[ i ]);
+
+	peer->timer_index = PEER_TIMER_DETACHED;
+	if (i == --sock->peers_timer_len)
+		return;
+	pgm_peer_t* last = sock->peers_timer[ sock->peers_timer_len ];
+	sock->peers_timer[ i ] = last;
+	last->timer_index = i;
+	peer_timer_sift_up (sock, i);
+	peer_timer_sift_down (sock, last->timer_index);
+}
+
+/* re-key a peer after arming or cancelling state timers, peers detached for
+ * dispatch are re-keyed by the dispatcher.
+ */
+
+static
+void
+peer_timer_update (
+	pgm_sock_t*const restrict	sock,
+	pgm_peer_t*const restrict	peer
+	)
+{
+	if (PEER_TIMER_DETACHED == peer->timer_index)
+		return;
+	const pgm_time_t next_expiry = peer_next_expiry (peer);
+	if (next_expiry == peer->next_expiry)
+		return;
+	peer->next_expiry = next_expiry;
+	peer_timer_sift_up (sock, peer->timer_index);
+	peer_timer_sift_down (sock, peer->timer_index);
 }
 
 /* calculate ACK_RB_IVL.
@@ -155,21 +288,22 @@ nak_rb_ivl (
 
 static
 void
-cancel_skb (
-	pgm_sock_t*	    	    restrict sock,
-	pgm_peer_t*		    restrict peer,
-	const struct pgm_sk_buff_t* restrict skb,
-	const pgm_time_t		     now
+cancel_sequence (
+	pgm_sock_t*    restrict sock,
+	pgm_peer_t*    restrict peer,
+	const uint32_t		sequence,
+	const pgm_time_t	now
 	)
 {
 	pgm_assert (NULL != sock);
 	pgm_assert (NULL != peer);
-	pgm_assert (NULL != skb);
-	pgm_assert_cmpuint (now, >=, skb->tstamp);
 
-	pgm_trace (PGM_LOG_ROLE_RX_WINDOW, _("Lost data #%u due to cancellation."), skb->sequence);
+	const pgm_time_t tstamp = peer->window->tstamp[ pgm_rxw_index (peer->window, sequence) ];
+	pgm_assert_cmpuint (now, >=, tstamp);
+
+	pgm_trace (PGM_LOG_ROLE_RX_WINDOW, _("Lost data #%u due to cancellation."), sequence);
 
-	const uint32_t fail_time = (uint32_t)(now - skb->tstamp);
+	const uint32_t fail_time = (uint32_t)(now - tstamp);
 	if (!peer->max_fail_time)
 		peer->max_fail_time = peer->min_fail_time = fail_time;
 	else if (fail_time > peer->max_fail_time)
@@ -177,7 +311,7 @@ cancel_skb (
 	else if (fail_time < peer->min_fail_time)
 		peer->min_fail_time = fail_time;
 
-	pgm_rxw_lost (peer->window, skb->sequence);
+	pgm_rxw_lost (peer->window, sequence);
 	PGM_HISTOGRAM_TIMES("Rx.FailTime", fail_time);
 
 /* mark receiver window for flushing on next recv() */
@@ -416,15 +550,18 @@ pgm_new_peer (
 					sock->rxw_secs,
 					sock->rxw_max_rte,
 					sock->ack_c_p);
+	peer->window->pool = sock->rx_pool;
 	peer->spmr_expiry = now + sock->spmr_expiry;
 
 /* add peer to hash table and linked list */
 	pgm_rwlock_writer_lock (&sock->peers_lock);
-	pgm_hashtable_insert (sock->peers_hashtable, &peer->tsi, _pgm_peer_ref (peer));
+	pgm_tsitable_insert (sock->peers_hashtable, &peer->tsi, _pgm_peer_ref (peer));
 	peer->peers_link.data = peer;
 	sock->peers_list = pgm_list_prepend_link (sock->peers_list, &peer->peers_link);
 	pgm_rwlock_writer_unlock (&sock->peers_lock);
 
+	peer_timer_insert (sock, peer);
+
 	pgm_timer_lock (sock);
 	if (pgm_time_after( sock->next_poll, peer->spmr_expiry ))
 		sock->next_poll = peer->spmr_expiry;
@@ -432,6 +569,27 @@ pgm_new_peer (
 	return peer;
 }
 
+#ifdef USE_HISTOGRAMS
+/* time from arrival of each delivered message to its hand over to the
+ * application.
+ */
+
+static
+void
+record_deliver_latency (
+	const struct pgm_msgv_t*	first,
+	const struct pgm_msgv_t*	last		/* one past */
+	)
+{
+	if (first == last)
+		return;
+	const pgm_time_t now = pgm_time_update_now();
+	for (const struct pgm_msgv_t* msg = first; msg < last; msg++)
+		if (msg->msgv_len > 0 && pgm_time_after_eq (now, msg->msgv_skb[0]->tstamp))
+			PGM_HDR_RECORD (PGM_HDR_DELIVER, pgm_to_nsecs (now - msg->msgv_skb[0]->tstamp));
+}
+#endif /* USE_HISTOGRAMS */
+
 /* copy any contiguous buffers in the peer list to the provided 
  * message vector.
  * returns -PGM_SOCK_ENOBUFS if the vector is full, returns -PGM_SOCK_ECONNRESET if
@@ -466,7 +624,13 @@ pgm_flush_peers_pending (
 		pgm_peer_t* peer = sock->peers_pending->data;
 		if (peer->last_commit && peer->last_commit < sock->last_commit)
 			pgm_rxw_remove_commit (peer->window);
+#ifdef USE_HISTOGRAMS
+		const struct pgm_msgv_t* first = *pmsg;
+#endif
 		const ssize_t peer_bytes = pgm_rxw_readv (peer->window, pmsg, (unsigned)(msg_end - *pmsg + 1));
+#ifdef USE_HISTOGRAMS
+		record_deliver_latency (first, *pmsg);
+#endif
 
 		if (peer->last_cumulative_losses != ((pgm_rxw_t*)peer->window)->cumulative_losses)
 		{
@@ -535,6 +699,43 @@ pgm_peer_set_pending (
 	sock->peers_pending = pgm_slist_prepend_link (sock->peers_pending, &peer->pending_link);
 }
 
+/* APDUs returned in place to the application are already committed from the
+ * receive window, a failed deferred checksum verification cannot be repaired
+ * and is reported as unrecoverable loss.  The peer moves to the head of the
+ * pending list where the reset is reported from.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_peer_set_corrupt (
+	pgm_sock_t* const restrict sock,
+	pgm_peer_t* const restrict peer,
+	const unsigned		   packets
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != sock);
+	pgm_assert (NULL != peer);
+	pgm_assert (packets > 0);
+
+	pgm_stats_inc (peer->cumulative_stats, PGM_PC_RECEIVER_CKSUM_ERRORS);
+	pgm_stats_add (peer->cumulative_stats, PGM_PC_RECEIVER_PACKETS_DISCARDED, packets);
+	peer->window->cumulative_losses += packets;
+	sock->is_reset = TRUE;
+	peer->lost_count = peer->window->cumulative_losses - peer->last_cumulative_losses;
+	peer->last_cumulative_losses = peer->window->cumulative_losses;
+
+	if (peer->pending_link.data) {
+		pgm_slist_t* restrict* link = &sock->peers_pending;
+		while (*link != &peer->pending_link)
+			link = &(*link)->next;
+		*link = peer->pending_link.next;
+		peer->pending_link.data = NULL;
+		peer->pending_link.next = NULL;
+	}
+	pgm_peer_set_pending (sock, peer);
+}
+
 /* Create a new error SKB detailing data loss.
  */
 
@@ -589,7 +790,7 @@ pgm_on_spm (
 
 	if (PGM_UNLIKELY(!pgm_verify_spm (skb))) {
 		pgm_trace(PGM_LOG_ROLE_NETWORK,_("Discarded invalid SPM."));
-		source->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_SPMS]++;
+		pgm_stats_inc (source->cumulative_stats, PGM_PC_RECEIVER_MALFORMED_SPMS);
 		return FALSE;
 	}
 
@@ -613,6 +814,7 @@ pgm_on_spm (
 						      pgm_ntohl (spm->spm_trail),
 						      skb->tstamp,
 						      nak_rb_expiry);
+		peer_timer_update (sock, source);
 		if (naks) {
 			pgm_timer_lock (sock);
 			if (pgm_time_after (sock->next_poll, nak_rb_expiry))
@@ -633,7 +835,7 @@ pgm_on_spm (
 	else
 	{	/* does not advance SPM sequence number */
 		pgm_trace (PGM_LOG_ROLE_NETWORK,_("Discarded duplicate SPM."));
-		source->cumulative_stats[PGM_PC_RECEIVER_DUP_SPMS]++;
+		pgm_stats_inc (source->cumulative_stats, PGM_PC_RECEIVER_DUP_SPMS);
 		return FALSE;
 	}
 
@@ -649,13 +851,13 @@ pgm_on_spm (
 		if (PGM_UNLIKELY(opt_len->opt_type != PGM_OPT_LENGTH))
 		{
 			pgm_trace (PGM_LOG_ROLE_NETWORK,_("Discarded malformed SPM."));
-			source->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_SPMS]++;
+			pgm_stats_inc (source->cumulative_stats, PGM_PC_RECEIVER_MALFORMED_SPMS);
 			return FALSE;
 		}
 		if (PGM_UNLIKELY(opt_len->opt_length != sizeof(struct pgm_opt_length)))
 		{
 			pgm_trace (PGM_LOG_ROLE_NETWORK,_("Discarded malformed SPM."));
-			source->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_SPMS]++;
+			pgm_stats_inc (source->cumulative_stats, PGM_PC_RECEIVER_MALFORMED_SPMS);
 			return FALSE;
 		}
 /* TODO: check for > 16 options & past packet end */
@@ -670,7 +872,7 @@ pgm_on_spm (
 				if (PGM_UNLIKELY((opt_parity_prm->opt_reserved & PGM_PARITY_PRM_MASK) == 0))
 				{
 					pgm_trace (PGM_LOG_ROLE_NETWORK,_("Discarded malformed SPM."));
-					source->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_SPMS]++;
+					pgm_stats_inc (source->cumulative_stats, PGM_PC_RECEIVER_MALFORMED_SPMS);
 					return FALSE;
 				}
 
@@ -678,7 +880,7 @@ pgm_on_spm (
 				if (PGM_UNLIKELY(parity_prm_tgs < 2 || parity_prm_tgs > 128))
 				{
 					pgm_trace (PGM_LOG_ROLE_NETWORK,_("Discarded malformed SPM."));
-					source->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_SPMS]++;
+					pgm_stats_inc (source->cumulative_stats, PGM_PC_RECEIVER_MALFORMED_SPMS);
 					return FALSE;
 				}
 			
@@ -732,7 +934,7 @@ pgm_on_peer_nak (
 	if (PGM_UNLIKELY(!pgm_verify_nak (skb)))
 	{
 		pgm_trace (PGM_LOG_ROLE_NETWORK,_("Discarded invalid multicast NAK."));
-		peer->cumulative_stats[PGM_PC_RECEIVER_NAK_ERRORS]++;
+		pgm_stats_inc (peer->cumulative_stats, PGM_PC_RECEIVER_NAK_ERRORS);
 		return FALSE;
 	}
 
@@ -770,7 +972,8 @@ pgm_on_peer_nak (
 				      skb->tstamp + sock->nak_rdata_ivl,
 				      skb->tstamp + nak_rb_ivl(sock));
 	if (PGM_RXW_UPDATED == ncf_status || PGM_RXW_APPENDED == ncf_status)
-		peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_SUPPRESSED]++;
+		pgm_stats_inc (peer->cumulative_stats, PGM_PC_RECEIVER_SELECTIVE_NAKS_SUPPRESSED);
+	peer_timer_update (sock, peer);
 
 /* check NAK list */
 	if (skb->pgm_header->pgm_options & PGM_OPT_PRESENT)
@@ -786,13 +989,13 @@ pgm_on_peer_nak (
 		if (PGM_UNLIKELY(opt_len->opt_type != PGM_OPT_LENGTH))
 		{
 			pgm_trace (PGM_LOG_ROLE_NETWORK,_("Discarded malformed multicast NAK."));
-			peer->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_NCFS]++;
+			pgm_stats_inc (peer->cumulative_stats, PGM_PC_RECEIVER_MALFORMED_NCFS);
 			return FALSE;
 		}
 		if (PGM_UNLIKELY(opt_len->opt_length != sizeof(struct pgm_opt_length)))
 		{
 			pgm_trace (PGM_LOG_ROLE_NETWORK,_("Discarded malformed multicast NAK."));
-			peer->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_NCFS]++;
+			pgm_stats_inc (peer->cumulative_stats, PGM_PC_RECEIVER_MALFORMED_NCFS);
 			return FALSE;
 		}
 /* TODO: check for > 16 options & past packet end */
@@ -814,10 +1017,11 @@ pgm_on_peer_nak (
 						      skb->tstamp + sock->nak_rdata_ivl,
 						      skb->tstamp + nak_rb_ivl(sock));
 			if (PGM_RXW_UPDATED == ncf_status || PGM_RXW_APPENDED == ncf_status)
-				peer->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_SUPPRESSED]++;
+				pgm_stats_inc (peer->cumulative_stats, PGM_PC_RECEIVER_SELECTIVE_NAKS_SUPPRESSED);
 			nak_list++;
 			nak_list_len--;
 		}
+		peer_timer_update (sock, peer);
 	}
 
 /* mark receiver window for flushing on next recv() */
@@ -863,7 +1067,7 @@ pgm_on_ncf (
 	if (PGM_UNLIKELY(!pgm_verify_ncf (skb)))
 	{
 		pgm_trace (PGM_LOG_ROLE_NETWORK,_("Discarded invalid NCF."));
-		source->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_NCFS]++;
+		pgm_stats_inc (source->cumulative_stats, PGM_PC_RECEIVER_MALFORMED_NCFS);
 		return FALSE;
 	}
 
@@ -876,7 +1080,7 @@ pgm_on_ncf (
 #if 0
 	if (PGM(pgm_sockaddr_cmp ((struct sockaddr*)&ncf_src_nla, (struct sockaddr*)&sock->send_addr) != 0)) {
 		g_trace ("INFO", "Discarded NCF on NLA mismatch.");
-		peer->cumulative_stats[PGM_PC_RECEIVER_PACKETS_DISCARDED]++;
+		pgm_stats_inc (peer->cumulative_stats, PGM_PC_RECEIVER_PACKETS_DISCARDED);
 		return FALSE;
 	}
 #endif
@@ -904,8 +1108,9 @@ pgm_on_ncf (
 			sock->next_poll = ncf_ivl;
 		}
 		pgm_timer_unlock (sock);
-		source->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_SUPPRESSED]++;
+		pgm_stats_inc (source->cumulative_stats, PGM_PC_RECEIVER_SELECTIVE_NAKS_SUPPRESSED);
 	}
+	peer_timer_update (sock, source);
 
 /* check NCF list */
 	if (skb->pgm_header->pgm_options & PGM_OPT_PRESENT)
@@ -921,13 +1126,13 @@ pgm_on_ncf (
 		if (PGM_UNLIKELY(opt_len->opt_type != PGM_OPT_LENGTH))
 		{
 			pgm_trace (PGM_LOG_ROLE_NETWORK,_("Discarded malformed NCF."));
-			source->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_NCFS]++;
+			pgm_stats_inc (source->cumulative_stats, PGM_PC_RECEIVER_MALFORMED_NCFS);
 			return FALSE;
 		}
 		if (PGM_UNLIKELY(opt_len->opt_length != sizeof(struct pgm_opt_length)))
 		{
 			pgm_trace (PGM_LOG_ROLE_NETWORK,_("Discarded malformed NCF."));
-			source->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_NCFS]++;
+			pgm_stats_inc (source->cumulative_stats, PGM_PC_RECEIVER_MALFORMED_NCFS);
 			return FALSE;
 		}
 /* TODO: check for > 16 options & past packet end */
@@ -951,10 +1156,11 @@ pgm_on_ncf (
 						      ncf_rdata_ivl,
 						      ncf_rb_ivl);
 			if (PGM_RXW_UPDATED == ncf_status || PGM_RXW_APPENDED == ncf_status)
-				source->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_SUPPRESSED]++;
+				pgm_stats_inc (source->cumulative_stats, PGM_PC_RECEIVER_SELECTIVE_NAKS_SUPPRESSED);
 			ncf_list++;
 			ncf_list_len--;
 		}
+		peer_timer_update (sock, source);
 	}
 
 /* mark receiver window for flushing on next recv() */
@@ -1031,7 +1237,7 @@ send_spmr (
 	if (sent < 0 && PGM_LIKELY(PGM_SOCK_EAGAIN == pgm_get_last_sock_error()))
 		return FALSE;
 
-	sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT] += tpdu_length * 2;
+	pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_BYTES_SENT, tpdu_length * 2);
 	return TRUE;
 }
 
@@ -1104,8 +1310,8 @@ send_nak (
 	if (sent < 0 && PGM_LIKELY(PGM_SOCK_EAGAIN == pgm_get_last_sock_error()))
 		return FALSE;
 
-	source->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAK_PACKETS_SENT]++;
-	source->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_SENT]++;
+	pgm_stats_inc (source->cumulative_stats, PGM_PC_RECEIVER_SELECTIVE_NAK_PACKETS_SENT);
+	pgm_stats_inc (source->cumulative_stats, PGM_PC_RECEIVER_SELECTIVE_NAKS_SENT);
 	return TRUE;
 }
 
@@ -1179,8 +1385,8 @@ send_parity_nak (
 	if (sent < 0 && PGM_LIKELY(PGM_SOCK_EAGAIN == pgm_get_last_sock_error()))
 		return FALSE;
 
-	source->cumulative_stats[PGM_PC_RECEIVER_PARITY_NAK_PACKETS_SENT]++;
-	source->cumulative_stats[PGM_PC_RECEIVER_PARITY_NAKS_SENT]++;
+	pgm_stats_inc (source->cumulative_stats, PGM_PC_RECEIVER_PARITY_NAK_PACKETS_SENT);
+	pgm_stats_inc (source->cumulative_stats, PGM_PC_RECEIVER_PARITY_NAKS_SENT);
 	return TRUE;
 }
 
@@ -1294,8 +1500,8 @@ send_nak_list (
 	if (sent < 0 && PGM_LIKELY(PGM_SOCK_EAGAIN == pgm_get_last_sock_error()))
 		return FALSE;
 
-	source->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAK_PACKETS_SENT]++;
-	source->cumulative_stats[PGM_PC_RECEIVER_SELECTIVE_NAKS_SENT] += 1 + sqn_list->len;
+	pgm_stats_inc (source->cumulative_stats, PGM_PC_RECEIVER_SELECTIVE_NAK_PACKETS_SENT);
+	pgm_stats_add (source->cumulative_stats, PGM_PC_RECEIVER_SELECTIVE_NAKS_SENT, 1 + sqn_list->len);
 	return TRUE;
 }
 
@@ -1391,7 +1597,7 @@ send_ack (
 	if (sent < 0 && PGM_LIKELY(PGM_SOCK_EAGAIN == pgm_get_last_sock_error()))
 		return FALSE;
 
-	source->cumulative_stats[PGM_PC_RECEIVER_ACKS_SENT]++;
+	pgm_stats_inc (source->cumulative_stats, PGM_PC_RECEIVER_ACKS_SENT);
 	return TRUE;
 }
 
@@ -1498,7 +1704,9 @@ nak_rb_state (
 	const pgm_time_t	now
 	)
 {
-	pgm_queue_t*		nak_backoff_queue;
+	pgm_rxw_t*		window;
+	pgm_time_t		next_expiry = 0;
+	uint32_t		sequence;
 	unsigned		dropped_invalid = 0;
 
 /* pre-conditions */
@@ -1516,13 +1724,10 @@ nak_rb_state (
  * alternative: after each packet check for incoming data and return to the
  * event loop.  bias for shorter loops as retry count increases.
  */
-	nak_backoff_queue = &peer->window->nak_backoff_queue;
-	if (NULL == nak_backoff_queue->tail) {
-		pgm_assert (NULL == nak_backoff_queue->head);
+	window = peer->window;
+	if (0 == window->nak_backoff_count) {
 		pgm_trace (PGM_LOG_ROLE_RX_WINDOW,_("Backoff queue is empty in nak_rb_state."));
 		return TRUE;
-	} else {
-		pgm_assert (NULL != nak_backoff_queue->head);
 	}
 
 /* have not learned this peers NLA */
@@ -1530,73 +1735,75 @@ nak_rb_state (
 
 /* TODO: process BOTH selective and parity NAKs? */
 
+/* sequences in BACK-OFF state are visited in sequence order from the loss
+ * bitmap, unexpired entries define the next expiration.
+ */
+
 /* calculate current transmission group for parity enabled peers */
 	if (peer->has_ondemand_parity)
 	{
-		const uint32_t tg_sqn_mask = 0xffffffff << peer->window->tg_sqn_shift;
+		const uint32_t tg_sqn_mask = 0xffffffff << window->tg_sqn_shift;
 
 /* NAKs only generated previous to current transmission group */
-		const uint32_t current_tg_sqn = peer->window->lead & tg_sqn_mask;
+		const uint32_t current_tg_sqn = window->lead & tg_sqn_mask;
 
 		uint32_t nak_tg_sqn = 0;
 		uint32_t nak_pkt_cnt = 0;
+		bool is_tg_complete = FALSE;
 
 /* parity NAK generation */
 
-		for (pgm_list_t *it = nak_backoff_queue->tail, *prev = it->prev;
-		     NULL != it;
-		     it = prev)
+		for (bool found = pgm_rxw_find_backoff (window, window->trail, &sequence);
+		     found;
+		     found = pgm_rxw_find_backoff (window, sequence + 1, &sequence))
 		{
-			struct pgm_sk_buff_t* skb	= (struct pgm_sk_buff_t*)it;
-			pgm_rxw_state_t* state		= (pgm_rxw_state_t*)&skb->cb;
-
-			prev = it->prev;
+			const uint_fast32_t index_	= pgm_rxw_index (window, sequence);
 
 /* check this packet for state expiration */
-			if (pgm_time_after_eq (now, state->timer_expiry))
+			if (!is_tg_complete && pgm_time_after_eq (now, window->timer_expiry[index_]))
 			{
 				if (PGM_UNLIKELY(!is_valid_nla)) {
 					dropped_invalid++;
-					pgm_rxw_lost (peer->window, skb->sequence);
+					pgm_rxw_lost (window, sequence);
 /* mark receiver window for flushing on next recv() */
 					pgm_peer_set_pending (sock, peer);
 					continue;
 				}
 
 /* TODO: parity nak lists */
-				const uint32_t tg_sqn = skb->sequence & tg_sqn_mask;
+				const uint32_t tg_sqn = sequence & tg_sqn_mask;
 				if (	(  nak_pkt_cnt && tg_sqn == nak_tg_sqn ) ||
 					( !nak_pkt_cnt && tg_sqn != current_tg_sqn )	)
 				{
-					pgm_rxw_state (peer->window, skb, PGM_PKT_STATE_WAIT_NCF);
+					pgm_rxw_state (window, sequence, PGM_PKT_STATE_WAIT_NCF);
 
 					if (!nak_pkt_cnt++)
 						nak_tg_sqn = tg_sqn;
-					state->nak_transmit_count++;
+					window->nak_transmit_count[index_]++;
 
 #ifdef PGM_ABSOLUTE_EXPIRY
-					state->timer_expiry += sock->nak_rpt_ivl;
-					while (pgm_time_after_eq (now, state->timer_expiry)) {
-						state->timer_expiry += sock->nak_rpt_ivl;
-						state->ncf_retry_count++;
+					window->timer_expiry[index_] += sock->nak_rpt_ivl;
+					while (pgm_time_after_eq (now, window->timer_expiry[index_])) {
+						window->timer_expiry[index_] += sock->nak_rpt_ivl;
+						window->ncf_retry_count[index_]++;
 					}
 #else
-					state->timer_expiry = now + sock->nak_rpt_ivl;
+					window->timer_expiry[index_] = now + sock->nak_rpt_ivl;
 #endif
 					pgm_timer_lock (sock);
-					if (pgm_time_after (sock->next_poll, state->timer_expiry))
-						sock->next_poll = state->timer_expiry;
+					if (pgm_time_after (sock->next_poll, window->timer_expiry[index_]))
+						sock->next_poll = window->timer_expiry[index_];
 					pgm_timer_unlock (sock);
+					continue;
 				}
-				else
-				{	/* different transmission group */
-					break;
-				}
-			}
-			else
-			{	/* packet expires some time later */
-				break;
+
+/* different transmission group */
+				is_tg_complete = TRUE;
 			}
+
+/* packet expires some time later */
+			if (!next_expiry || pgm_time_after (next_expiry, window->timer_expiry[index_]))
+				next_expiry = window->timer_expiry[index_];
 		}
 
 		if (nak_pkt_cnt && !send_parity_nak (sock, peer, nak_tg_sqn, nak_pkt_cnt))
@@ -1608,48 +1815,45 @@ nak_rb_state (
 
 /* select NAK generation */
 
-		for (pgm_list_t *it = nak_backoff_queue->tail, *prev = it->prev;
-		     NULL != it;
-		     it = prev)
+		for (bool found = pgm_rxw_find_backoff (window, window->trail, &sequence);
+		     found;
+		     found = pgm_rxw_find_backoff (window, sequence + 1, &sequence))
 		{
-			struct pgm_sk_buff_t* skb	= (struct pgm_sk_buff_t*)it;
-			pgm_rxw_state_t* state		= (pgm_rxw_state_t*)&skb->cb;
-
-			prev = it->prev;
+			const uint_fast32_t index_	= pgm_rxw_index (window, sequence);
 
 /* check this packet for state expiration */
-			if (pgm_time_after_eq(now, state->timer_expiry))
+			if (pgm_time_after_eq(now, window->timer_expiry[index_]))
 			{
 				if (PGM_UNLIKELY(!is_valid_nla)) {
 					dropped_invalid++;
-					pgm_rxw_lost (peer->window, skb->sequence);
+					pgm_rxw_lost (window, sequence);
 /* mark receiver window for flushing on next recv() */
 					pgm_peer_set_pending (sock, peer);
 					continue;
 				}
 
-				pgm_rxw_state (peer->window, skb, PGM_PKT_STATE_WAIT_NCF);
-				nak_list.sqn[nak_list.len++] = skb->sequence;
-				state->nak_transmit_count++;
+				pgm_rxw_state (window, sequence, PGM_PKT_STATE_WAIT_NCF);
+				nak_list.sqn[nak_list.len++] = sequence;
+				window->nak_transmit_count[index_]++;
 
 /* we have two options here, calculate the expiry time in the new state relative to the current
  * state execution time, skipping missed expirations due to delay in state processing, or base
  * from the actual current time.
  */
 #ifdef PGM_ABSOLUTE_EXPIRY
-				state->timer_expiry += sock->nak_rpt_ivl;
-				while (pgm_time_after_eq(now, state->timer_expiry)){
-					state->timer_expiry += sock->nak_rpt_ivl;
-					state->ncf_retry_count++;
+				window->timer_expiry[index_] += sock->nak_rpt_ivl;
+				while (pgm_time_after_eq(now, window->timer_expiry[index_])){
+					window->timer_expiry[index_] += sock->nak_rpt_ivl;
+					window->ncf_retry_count[index_]++;
 				}
 #else
-				state->timer_expiry = now + sock->nak_rpt_ivl;
+				window->timer_expiry[index_] = now + sock->nak_rpt_ivl;
 pgm_trace(PGM_LOG_ROLE_NETWORK,_("nak_rpt_expiry in %f seconds."),
-		pgm_to_secsf( state->timer_expiry - now ) );
+		pgm_to_secsf( window->timer_expiry[index_] - now ) );
 #endif
 				pgm_timer_lock (sock);
-				if (pgm_time_after (sock->next_poll, state->timer_expiry))
-					sock->next_poll = state->timer_expiry;
+				if (pgm_time_after (sock->next_poll, window->timer_expiry[index_]))
+					sock->next_poll = window->timer_expiry[index_];
 				pgm_timer_unlock (sock);
 
 				if (nak_list.len == PGM_N_ELEMENTS(nak_list.sqn)) {
@@ -1660,7 +1864,8 @@ pgm_trace(PGM_LOG_ROLE_NETWORK,_("nak_rpt_expiry in %f seconds."),
 			}
 			else
 			{	/* packet expires some time later */
-				break;
+				if (!next_expiry || pgm_time_after (next_expiry, window->timer_expiry[index_]))
+					next_expiry = window->timer_expiry[index_];
 			}
 		}
 
@@ -1679,41 +1884,93 @@ pgm_trace(PGM_LOG_ROLE_NETWORK,_("nak_rpt_expiry in %f seconds."),
 		pgm_trace (PGM_LOG_ROLE_RX_WINDOW,_("Dropped %u messages due to invalid NLA."), dropped_invalid);
 
 /* mark receiver window for flushing on next recv() */
-		if (peer->window->cumulative_losses != peer->last_cumulative_losses &&
+		if (window->cumulative_losses != peer->last_cumulative_losses &&
 		    !peer->pending_link.data)
 		{
 			sock->is_reset = TRUE;
-			peer->lost_count = peer->window->cumulative_losses - peer->last_cumulative_losses;
-			peer->last_cumulative_losses = peer->window->cumulative_losses;
+			peer->lost_count = window->cumulative_losses - peer->last_cumulative_losses;
+			peer->last_cumulative_losses = window->cumulative_losses;
 			pgm_peer_set_pending (sock, peer);
 		}
 	}
 
-	if (nak_backoff_queue->length == 0)
+/* every remaining entry was visited */
+	if (window->nak_backoff_count)
 	{
-		pgm_assert ((struct rxw_packet*)nak_backoff_queue->head == NULL);
-		pgm_assert ((struct rxw_packet*)nak_backoff_queue->tail == NULL);
+		pgm_assert (0 != next_expiry);
+		window->nak_backoff_expiry = next_expiry;
+		pgm_trace (PGM_LOG_ROLE_NETWORK,_("Next expiry set in %f seconds."),
+			pgm_to_secsf(next_nak_rb_expiry(window) - now));
 	}
 	else
 	{
-		pgm_assert ((struct rxw_packet*)nak_backoff_queue->head != NULL);
-		pgm_assert ((struct rxw_packet*)nak_backoff_queue->tail != NULL);
+		pgm_trace (PGM_LOG_ROLE_RX_WINDOW,_("NAK backoff queue empty."));
 	}
+	return TRUE;
+}
+
+/* check one peer for SPMR, ACK and NAK state timers, uses the tail of each
+ * queue for the nearest timer execution.
+ *
+ * returns TRUE on complete sweep, returns FALSE if operation would block.
+ */
 
-	if (nak_backoff_queue->tail)
+static
+bool
+peer_state (
+	pgm_sock_t*const restrict	sock,
+	pgm_peer_t*const restrict	peer,
+	const pgm_time_t		now
+	)
+{
+	if (peer->spmr_expiry)
 	{
-		pgm_trace (PGM_LOG_ROLE_NETWORK,_("Next expiry set in %f seconds."),
-			pgm_to_secsf(next_nak_rb_expiry(peer->window) - now));
+		if (pgm_time_after_eq (now, peer->spmr_expiry))
+		{
+			if (sock->can_send_nak) {
+				if (!send_spmr (sock, peer)) {
+					return FALSE;
+				}
+				peer->spmr_tstamp = now;
+			}
+			peer->spmr_expiry = 0;
+		}
 	}
-	else
+
+	if (peer->window->ack_backoff_queue.tail)
 	{
-		pgm_trace (PGM_LOG_ROLE_RX_WINDOW,_("NAK backoff queue empty."));
+		pgm_assert (sock->use_pgmcc);
+
+		if (pgm_time_after_eq (now, next_ack_rb_expiry (peer->window)))
+			if (!ack_rb_state (sock, peer, now)) {
+				return FALSE;
+			}
+	}
+
+	if (peer->window->nak_backoff_count)
+	{
+		if (pgm_time_after_eq (now, next_nak_rb_expiry (peer->window)))
+			if (!nak_rb_state (sock, peer, now)) {
+				return FALSE;
+			}
+	}
+	
+	if (peer->window->wait_ncf_queue.tail)
+	{
+		if (pgm_time_after_eq (now, next_nak_rpt_expiry (peer->window)))
+			nak_rpt_state (sock, peer, now);
+	}
+
+	if (peer->window->wait_data_queue.tail)
+	{
+		if (pgm_time_after_eq (now, next_nak_rdata_expiry (peer->window)))
+			nak_rdata_state (sock, peer, now);
 	}
 	return TRUE;
 }
 
-/* check this peer for NAK state timers, uses the tail of each queue for the nearest
- * timer execution.
+/* check the peers due on the timer heap for NAK state timers and expiration,
+ * peers not due are not visited.
  *
  * returns TRUE on complete sweep, returns FALSE if operation would block.
  */
@@ -1725,69 +1982,39 @@ pgm_check_peer_state (
 	const pgm_time_t	now
 	)
 {
+	bool is_blocked = FALSE;
+	uint32_t due = 0;
+
 /* pre-conditions */
 	pgm_assert (NULL != sock);
 
 	pgm_debug ("pgm_check_peer_state (sock:%p now:%" PGM_TIME_FORMAT ")",
 		(const void*)sock, now);
 
-	if (!sock->peers_list)
+	if (!sock->peers_timer_len)
 		return TRUE;
 
-	for (pgm_list_t *it = sock->peers_list, *next = it->next;
-	     NULL != it;
-	     it = next)
+/* detach due peers to the end of the heap so that each is visited once */
+	while (sock->peers_timer_len > 0 &&
+	       pgm_time_after_eq (now, sock->peers_timer[ 0 ]->next_expiry))
 	{
-		pgm_peer_t* peer = it->data;
-
-		next = it->next;
-
-		if (peer->spmr_expiry)
-		{
-			if (pgm_time_after_eq (now, peer->spmr_expiry))
-			{
-				if (sock->can_send_nak) {
-					if (!send_spmr (sock, peer)) {
-						return FALSE;
-					}
-					peer->spmr_tstamp = now;
-				}
-				peer->spmr_expiry = 0;
-			}
-		}
-
-		if (peer->window->ack_backoff_queue.tail)
-		{
-			pgm_assert (sock->use_pgmcc);
-
-			if (pgm_time_after_eq (now, next_ack_rb_expiry (peer->window)))
-				if (!ack_rb_state (sock, peer, now)) {
-					return FALSE;
-				}
-		}
+		pgm_peer_t* peer = sock->peers_timer[ 0 ];
+		peer_timer_remove (sock, peer);
+/* the heap shrank by one, the freed slot leads the due run */
+		sock->peers_timer[ sock->peers_timer_len ] = peer;
+		due++;
+	}
 
-		if (peer->window->nak_backoff_queue.tail)
-		{
-			if (pgm_time_after_eq (now, next_nak_rb_expiry (peer->window)))
-				if (!nak_rb_state (sock, peer, now)) {
-					return FALSE;
-				}
-		}
-		
-		if (peer->window->wait_ncf_queue.tail)
-		{
-			if (pgm_time_after_eq (now, next_nak_rpt_expiry (peer->window)))
-				nak_rpt_state (sock, peer, now);
-		}
+	const uint32_t first = sock->peers_timer_len;
+	for (uint32_t i = first; i < first + due; i++)
+	{
+		pgm_peer_t* peer = sock->peers_timer[ i ];
 
-		if (peer->window->wait_data_queue.tail)
-		{
-			if (pgm_time_after_eq (now, next_nak_rdata_expiry (peer->window)))
-				nak_rdata_state (sock, peer, now);
-		}
+		if (!is_blocked && !peer_state (sock, peer, now))
+			is_blocked = TRUE;
 
 /* expired, remove from hash table and linked list */
-		if (pgm_time_after_eq (now, peer->expiry))
+		if (!is_blocked && pgm_time_after_eq (now, peer->expiry))
 		{
 			if (peer->pending_link.data)
 			{
@@ -1802,16 +2029,28 @@ pgm_check_peer_state (
 			else
 			{
 				pgm_trace (PGM_LOG_ROLE_SESSION,_("Peer expired, tsi %s"), pgm_tsi_print (&peer->tsi));
-				pgm_hashtable_remove (sock->peers_hashtable, &peer->tsi);
+				pgm_tsitable_remove (sock->peers_hashtable, &peer->tsi);
 				sock->peers_list = pgm_list_remove_link (sock->peers_list, &peer->peers_link);
-				if (sock->last_hash_value == peer)
-					sock->last_hash_value = NULL;
+				for (unsigned j = 0; j < PGM_PEERS_LRU_LEN; j++)
+					if (sock->peers_lru[ j ] == peer) {
+						memmove (&sock->peers_lru[ j ], &sock->peers_lru[ j + 1 ], (PGM_PEERS_LRU_LEN - 1 - j) * sizeof(pgm_peer_t*));
+						sock->peers_lru[ PGM_PEERS_LRU_LEN - 1 ] = NULL;
+						break;
+					}
 				pgm_peer_unref (peer);
+				continue;
 			}
 		}
 
+/* re-attach with next expiry, slot never beyond the current peer */
+		peer->next_expiry = peer_next_expiry (peer);
+		sock->peers_timer[ sock->peers_timer_len ] = peer;
+		peer_timer_sift_up (sock, sock->peers_timer_len++);
 	}
 
+	if (is_blocked)
+		return FALSE;
+
 /* check for waiting contiguous packets */
 	if (sock->peers_pending && !sock->is_pending_read)
 	{
@@ -1841,50 +2080,9 @@ pgm_min_receiver_expiry (
 	pgm_debug ("pgm_min_receiver_expiry (sock:%p expiration:%" PGM_TIME_FORMAT ")",
 		(void*)sock, expiration);
 
-	if (!sock->peers_list)
-		return expiration;
-
-	for (pgm_list_t *it = sock->peers_list, *next = it->next;
-	     NULL != it;
-	     it = next)
-	{
-		pgm_peer_t* peer = it->data;
-
-		next = it->next;
-
-		if (peer->spmr_expiry)
-		{
-			if (pgm_time_after_eq (expiration, peer->spmr_expiry))
-				expiration = peer->spmr_expiry;
-		}
-
-		if (peer->window->ack_backoff_queue.tail)
-		{
-			pgm_assert (sock->use_pgmcc);
-			if (pgm_time_after_eq (expiration, next_ack_rb_expiry (peer->window)))
-				expiration = next_ack_rb_expiry (peer->window);
-		}
-
-		if (peer->window->nak_backoff_queue.tail)
-		{
-			if (pgm_time_after_eq (expiration, next_nak_rb_expiry (peer->window)))
-				expiration = next_nak_rb_expiry (peer->window);
-		}
-
-		if (peer->window->wait_ncf_queue.tail)
-		{
-			if (pgm_time_after_eq (expiration, next_nak_rpt_expiry (peer->window)))
-				expiration = next_nak_rpt_expiry (peer->window);
-		}
-
-		if (peer->window->wait_data_queue.tail)
-		{
-			if (pgm_time_after_eq (expiration, next_nak_rdata_expiry (peer->window)))
-				expiration = next_nak_rdata_expiry (peer->window);
-		}
-
-	}
-
+	if (sock->peers_timer_len &&
+	    pgm_time_after_eq (expiration, sock->peers_timer[ 0 ]->next_expiry))
+		expiration = sock->peers_timer[ 0 ]->next_expiry;
 	return expiration;
 }
 
@@ -1921,56 +2119,55 @@ nak_rpt_state (
 	     NULL != it;
 	     it = prev)
 	{
-		struct pgm_sk_buff_t* skb	= (struct pgm_sk_buff_t*)it;
-		pgm_assert (NULL != skb);
-		pgm_rxw_state_t* state		= (pgm_rxw_state_t*)&skb->cb;
+		const uint32_t sequence		= pgm_rxw_link_sequence (peer->window, it);
+		const uint_fast32_t index_	= pgm_rxw_index (peer->window, sequence);
 
 		prev = it->prev;
 
 /* check this packet for state expiration */
-		if (pgm_time_after_eq (now, state->timer_expiry))
+		if (pgm_time_after_eq (now, peer->window->timer_expiry[index_]))
 		{
 			if (PGM_UNLIKELY(!is_valid_nla)) {
 				dropped_invalid++;
-				pgm_rxw_lost (peer->window, skb->sequence);
+				pgm_rxw_lost (peer->window, sequence);
 /* mark receiver window for flushing on next recv() */
 				pgm_peer_set_pending (sock, peer);
 				continue;
 			}
 
-			if (++state->ncf_retry_count >= sock->nak_ncf_retries)
+			if (++peer->window->ncf_retry_count[index_] >= sock->nak_ncf_retries)
 			{
 				dropped++;
-				cancel_skb (sock, peer, skb, now);
-				peer->cumulative_stats[PGM_PC_RECEIVER_NAKS_FAILED_NCF_RETRIES_EXCEEDED]++;
+				cancel_sequence (sock, peer, sequence, now);
+				pgm_stats_inc (peer->cumulative_stats, PGM_PC_RECEIVER_NAKS_FAILED_NCF_RETRIES_EXCEEDED);
 			}
 			else
 			{
 /* retry */
-//				state->timer_expiry += nak_rb_ivl(sock);
-				state->timer_expiry = now + nak_rb_ivl (sock);
-				pgm_rxw_state (peer->window, skb, PGM_PKT_STATE_BACK_OFF);
-				pgm_trace (PGM_LOG_ROLE_RX_WINDOW,_("NCF retry #%u attempt %u/%u."), skb->sequence, state->ncf_retry_count, sock->nak_ncf_retries);
+//				peer->window->timer_expiry[index_] += nak_rb_ivl(sock);
+				peer->window->timer_expiry[index_] = now + nak_rb_ivl (sock);
+				pgm_rxw_state (peer->window, sequence, PGM_PKT_STATE_BACK_OFF);
+				pgm_trace (PGM_LOG_ROLE_RX_WINDOW,_("NCF retry #%u attempt %u/%u."), sequence, peer->window->ncf_retry_count[index_], sock->nak_ncf_retries);
 			}
 		}
 		else
 		{
 /* packet expires some time later */
 			pgm_trace(PGM_LOG_ROLE_RX_WINDOW,_("NCF retry #%u is delayed %f seconds."),
-				skb->sequence, pgm_to_secsf (state->timer_expiry - now));
+				sequence, pgm_to_secsf (peer->window->timer_expiry[index_] - now));
 			break;
 		}
 	}
 
 	if (wait_ncf_queue->length == 0)
 	{
-		pgm_assert ((pgm_rxw_state_t*)wait_ncf_queue->head == NULL);
-		pgm_assert ((pgm_rxw_state_t*)wait_ncf_queue->tail == NULL);
+		pgm_assert (wait_ncf_queue->head == NULL);
+		pgm_assert (wait_ncf_queue->tail == NULL);
 	}
 	else
 	{
-		pgm_assert ((pgm_rxw_state_t*)wait_ncf_queue->head != NULL);
-		pgm_assert ((pgm_rxw_state_t*)wait_ncf_queue->tail != NULL);
+		pgm_assert (wait_ncf_queue->head != NULL);
+		pgm_assert (wait_ncf_queue->tail != NULL);
 	}
 
 	if (PGM_UNLIKELY(dropped_invalid)) {
@@ -1987,7 +2184,7 @@ nak_rpt_state (
 				" frag %" PRIu32),
 				dropped,
 				pgm_rxw_length (peer->window),
-				peer->window->nak_backoff_queue.length,
+				peer->window->nak_backoff_count,
 				peer->window->wait_ncf_queue.length,
 				peer->window->wait_data_queue.length,
 				peer->window->lost_count,
@@ -2054,37 +2251,36 @@ nak_rdata_state (
 	     NULL != it;
 	     it = prev)
 	{
-		struct pgm_sk_buff_t* rdata_skb	= (struct pgm_sk_buff_t*)it;
-		pgm_assert (NULL != rdata_skb);
-		pgm_rxw_state_t* rdata_state	= (pgm_rxw_state_t*)&rdata_skb->cb;
+		const uint32_t sequence		= pgm_rxw_link_sequence (peer->window, it);
+		const uint_fast32_t index_	= pgm_rxw_index (peer->window, sequence);
 
 		prev = it->prev;
 
 /* check this packet for state expiration */
-		if (pgm_time_after_eq (now, rdata_state->timer_expiry))
+		if (pgm_time_after_eq (now, peer->window->timer_expiry[index_]))
 		{
 			if (PGM_UNLIKELY(!is_valid_nla)) {
 				dropped_invalid++;
-				pgm_rxw_lost (peer->window, rdata_skb->sequence);
+				pgm_rxw_lost (peer->window, sequence);
 /* mark receiver window for flushing on next recv() */
 				pgm_peer_set_pending (sock, peer);
 				continue;
 			}
 
-			if (++rdata_state->data_retry_count >= sock->nak_data_retries)
+			if (++peer->window->data_retry_count[index_] >= sock->nak_data_retries)
 			{
 				dropped++;
-				cancel_skb (sock, peer, rdata_skb, now);
-				peer->cumulative_stats[PGM_PC_RECEIVER_NAKS_FAILED_DATA_RETRIES_EXCEEDED]++;
+				cancel_sequence (sock, peer, sequence, now);
+				pgm_stats_inc (peer->cumulative_stats, PGM_PC_RECEIVER_NAKS_FAILED_DATA_RETRIES_EXCEEDED);
 				continue;
 			}
 
-//			rdata_state->timer_expiry += nak_rb_ivl(sock);
-			rdata_state->timer_expiry = now + nak_rb_ivl (sock);
-			pgm_rxw_state (peer->window, rdata_skb, PGM_PKT_STATE_BACK_OFF);
+//			peer->window->timer_expiry[index_] += nak_rb_ivl(sock);
+			peer->window->timer_expiry[index_] = now + nak_rb_ivl (sock);
+			pgm_rxw_state (peer->window, sequence, PGM_PKT_STATE_BACK_OFF);
 
 /* retry back to back-off state */
-			pgm_trace(PGM_LOG_ROLE_RX_WINDOW,_("Data retry #%u attempt %u/%u."), rdata_skb->sequence, rdata_state->data_retry_count, sock->nak_data_retries);
+			pgm_trace(PGM_LOG_ROLE_RX_WINDOW,_("Data retry #%u attempt %u/%u."), sequence, peer->window->data_retry_count[index_], sock->nak_data_retries);
 		}
 		else
 		{	/* packet expires some time later */
@@ -2095,13 +2291,13 @@ nak_rdata_state (
 
 	if (wait_data_queue->length == 0)
 	{
-		pgm_assert (NULL == (pgm_rxw_state_t*)wait_data_queue->head);
-		pgm_assert (NULL == (pgm_rxw_state_t*)wait_data_queue->tail);
+		pgm_assert (NULL == wait_data_queue->head);
+		pgm_assert (NULL == wait_data_queue->tail);
 	}
 	else
 	{
-		pgm_assert (NULL != (pgm_rxw_state_t*)wait_data_queue->head);
-		pgm_assert (NULL != (pgm_rxw_state_t*)wait_data_queue->tail);
+		pgm_assert (NULL != wait_data_queue->head);
+		pgm_assert (NULL != wait_data_queue->tail);
 	}
 
 	if (PGM_UNLIKELY(dropped_invalid)) {
@@ -2130,6 +2326,26 @@ nak_rdata_state (
 	}
 }
 
+/* a data packet whose checksum is not yet verified may only append the next
+ * sequence, with a trail that advances no further than committed data.
+ */
+
+static inline
+bool
+is_deferrable_data (
+	const pgm_rxw_t*	       const restrict window,
+	const struct pgm_sk_buff_t*    const restrict skb
+	)
+{
+	const uint32_t data_sqn   = pgm_ntohl (skb->pgm_data->data_sqn);
+	const uint32_t data_trail = pgm_ntohl (skb->pgm_data->data_trail);
+
+	return window->is_defined &&
+		data_sqn == window->lead + 1 &&
+		pgm_uint32_gte (data_trail, window->rxw_trail) &&
+		pgm_uint32_lte (data_trail, window->commit_lead);
+}
+
 /* ODATA or RDATA packet with any of the following options:
  *
  * OPT_FRAGMENT - this TPDU part of a larger APDU.
@@ -2171,6 +2387,22 @@ pgm_on_data (
 /* advance data pointer to payload */
 	pgm_skb_pull (skb, (uint16_t)(sizeof(struct pgm_data) + opt_total_length));
 
+/* header fields act on the window before delivery, only the next in-order
+ * packet that cannot move the trail over missing data may leave verification
+ * until copied out.  Packets feeding parity reconstruction cannot wait.
+ */
+	if (skb->csum_deferred &&
+	    (source->window->is_fec_available ||
+	     !is_deferrable_data (source->window, skb)) &&
+	    !pgm_verify_checksum (skb, NULL, 0))
+	{
+		pgm_trace (PGM_LOG_ROLE_NETWORK,_("Discarded data packet on PGM checksum mismatch, tsi %s"), pgm_tsi_print (&source->tsi));
+		pgm_stats_atomic_inc (pgm_sock_stats (sock, PGM_STATS_APP), PGM_PC_SOURCE_CKSUM_ERRORS);
+		pgm_stats_inc (source->cumulative_stats, PGM_PC_RECEIVER_CKSUM_ERRORS);
+		pgm_stats_inc (source->cumulative_stats, PGM_PC_RECEIVER_PACKETS_DISCARDED);
+		return FALSE;
+	}
+
 	if (opt_total_length > 0 &&			/* there are options */
 	    get_pgm_options (skb) &&			/* valid options */
 	    sock->use_pgmcc &&				/* PGMCC is enabled */
@@ -2193,11 +2425,11 @@ pgm_on_data (
 		break;
 
 	case PGM_RXW_DUPLICATE:
-		source->cumulative_stats[PGM_PC_RECEIVER_DUP_DATAS]++;
+		pgm_stats_inc (source->cumulative_stats, PGM_PC_RECEIVER_DUP_DATAS);
 		goto discarded;
 
 	case PGM_RXW_MALFORMED:
-		source->cumulative_stats[PGM_PC_RECEIVER_MALFORMED_ODATA]++;
+		pgm_stats_inc (source->cumulative_stats, PGM_PC_RECEIVER_MALFORMED_ODATA);
 /* fall through */
 	case PGM_RXW_BOUNDS:
 discarded:
@@ -2208,8 +2440,8 @@ discarded:
 
 /* valid data */
 	PGM_HISTOGRAM_COUNTS("Rx.DataBytesReceived", tsdu_length);
-	source->cumulative_stats[PGM_PC_RECEIVER_DATA_BYTES_RECEIVED] += tsdu_length;
-	source->cumulative_stats[PGM_PC_RECEIVER_DATA_MSGS_RECEIVED]  += msg_count;
+	pgm_stats_add (source->cumulative_stats, PGM_PC_RECEIVER_DATA_BYTES_RECEIVED, tsdu_length);
+	pgm_stats_add (source->cumulative_stats, PGM_PC_RECEIVER_DATA_MSGS_RECEIVED, msg_count);
 
 /* congestion control */
 	if (0 != ack_rb_expiry)
@@ -2248,6 +2480,7 @@ discarded:
 	}
 
 	if (flush_naks || 0 != ack_rb_expiry) {
+		peer_timer_update (sock, source);
 /* flush out 1st time nak packets */
 		pgm_timer_lock (sock);
 		if (flush_naks && pgm_time_after (sock->next_poll, nak_rb_expiry))
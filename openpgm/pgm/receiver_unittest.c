@@ -52,6 +52,7 @@
 
 
 #define pgm_histogram_add	mock_pgm_histogram_add
+#define pgm_verify_checksum	mock_pgm_verify_checksum
 #define pgm_verify_spm		mock_pgm_verify_spm
 #define pgm_verify_nak		mock_pgm_verify_nak
 #define pgm_verify_ncf		mock_pgm_verify_ncf
@@ -66,6 +67,7 @@
 #define pgm_rxw_confirm		mock_pgm_rxw_confirm
 #define pgm_rxw_lost		mock_pgm_rxw_lost
 #define pgm_rxw_state		mock_pgm_rxw_state
+#define pgm_rxw_find_backoff	mock_pgm_rxw_find_backoff
 #define pgm_rxw_add		mock_pgm_rxw_add
 #define pgm_rxw_remove_commit	mock_pgm_rxw_remove_commit
 #define pgm_rxw_readv		mock_pgm_rxw_readv
@@ -178,6 +180,19 @@ _mock_pgm_time_update_now (void)
 }
 
 /* packet module */
+bool
+mock_pgm_verify_checksum (
+	struct pgm_sk_buff_t* const	skb,
+	void*				dst,
+	const uint16_t			len
+	)
+{
+	if (dst)
+		memcpy (dst, skb->data, len);
+	skb->csum_deferred = 0;
+	return TRUE;
+}
+
 bool
 mock_pgm_verify_spm (
 	const struct pgm_sk_buff_t* const       skb
@@ -256,12 +271,22 @@ mock_pgm_rxw_lost (
 void
 mock_pgm_rxw_state (
 	pgm_rxw_t* const		window,
-	struct pgm_sk_buff_t* const	skb,
+	const uint32_t			sequence,
 	const int			new_state
 	)
 {
 }
 
+bool
+mock_pgm_rxw_find_backoff (
+	const pgm_rxw_t* const		window,
+	uint32_t			sequence,
+	uint32_t*			found
+	)
+{
+	return FALSE;
+}
+
 unsigned
 mock_pgm_rxw_update (
 	pgm_rxw_t* const		window,
@@ -423,6 +448,57 @@ START_TEST (test_check_peer_state_pass_001)
 }
 END_TEST
 
+/* only due peers are visited and re-keyed */
+START_TEST (test_check_peer_state_pass_002)
+{
+	pgm_sock_t* sock = generate_sock();
+	sock->is_bound = TRUE;
+	pgm_peer_t* peer1 = generate_peer();
+	pgm_peer_t* peer2 = generate_peer();
+	peer1->expiry = peer2->expiry = mock_pgm_time_now + pgm_secs(300);
+	peer1->spmr_expiry = mock_pgm_time_now;
+	peer2->spmr_expiry = mock_pgm_time_now + pgm_secs(1);
+	peer_timer_insert (sock, peer2);
+	peer_timer_insert (sock, peer1);
+	fail_unless (peer1 == sock->peers_timer[0], "heap order mismatch");
+	fail_unless (pgm_check_peer_state (sock, mock_pgm_time_now), "check_peer_state failed");
+	fail_unless (2 == sock->peers_timer_len, "heap length mismatch");
+	fail_unless (0 == peer1->spmr_expiry, "due peer not visited");
+	fail_unless (peer1->expiry == peer1->next_expiry, "due peer not re-keyed");
+	fail_unless (mock_pgm_time_now + pgm_secs(1) == peer2->spmr_expiry, "peer visited early");
+	fail_unless (peer2 == sock->peers_timer[0], "heap order mismatch");
+}
+END_TEST
+
+/* several peers due in the same pass are each visited once and re-keyed */
+START_TEST (test_check_peer_state_pass_003)
+{
+	pgm_sock_t* sock = generate_sock();
+	sock->is_bound = TRUE;
+	pgm_peer_t* peers[4];
+	for (unsigned i = 0; i < G_N_ELEMENTS(peers); i++) {
+		peers[i] = generate_peer();
+		peers[i]->expiry = mock_pgm_time_now + pgm_secs(300 + i);
+		peers[i]->spmr_expiry = mock_pgm_time_now + (i < 3 ? 0 : pgm_secs(1));
+		peer_timer_insert (sock, peers[i]);
+	}
+	fail_unless (pgm_check_peer_state (sock, mock_pgm_time_now), "check_peer_state failed");
+	fail_unless (G_N_ELEMENTS(peers) == sock->peers_timer_len, "heap length mismatch");
+	for (unsigned i = 0; i < G_N_ELEMENTS(peers); i++) {
+		if (i < 3) {
+			fail_unless (0 == peers[i]->spmr_expiry, "due peer not visited");
+			fail_unless (peers[i]->expiry == peers[i]->next_expiry, "due peer not re-keyed");
+		} else {
+			fail_unless (mock_pgm_time_now + pgm_secs(1) == peers[i]->spmr_expiry, "peer visited early");
+		}
+		fail_unless (peers[i] == sock->peers_timer[ peers[i]->timer_index ], "heap index mismatch");
+	}
+	for (uint32_t i = 1; i < sock->peers_timer_len; i++)
+		fail_unless (!pgm_time_after (sock->peers_timer[ (i - 1) / 2 ]->next_expiry, sock->peers_timer[ i ]->next_expiry), "heap order mismatch");
+	fail_unless (peers[3] == sock->peers_timer[0], "heap order mismatch");
+}
+END_TEST
+
 START_TEST (test_check_peer_state_fail_001)
 {
 	pgm_check_peer_state (NULL, mock_pgm_time_now);
@@ -447,6 +523,23 @@ START_TEST (test_min_receiver_expiry_pass_001)
 }
 END_TEST
 
+START_TEST (test_min_receiver_expiry_pass_002)
+{
+	pgm_sock_t* sock = generate_sock();
+	sock->is_bound = TRUE;
+	const pgm_time_t expiration = pgm_secs(10);
+	for (unsigned i = 0; i < 64; i++) {
+		pgm_peer_t* peer = generate_peer();
+		peer->expiry = pgm_secs(100) - pgm_msecs((i * 37) % 64);
+		peer_timer_insert (sock, peer);
+	}
+	fail_unless (expiration == pgm_min_receiver_expiry (sock, expiration), "expiry mismatch");
+	fail_unless (pgm_secs(100) - pgm_msecs(63) == pgm_min_receiver_expiry (sock, pgm_secs(200)), "expiry mismatch");
+	peer_timer_remove (sock, sock->peers_timer[0]);
+	fail_unless (pgm_secs(100) - pgm_msecs(62) == pgm_min_receiver_expiry (sock, pgm_secs(200)), "expiry mismatch");
+}
+END_TEST
+
 START_TEST (test_min_receiver_expiry_fail_001)
 {
 	const pgm_time_t expiration = pgm_secs(1);
@@ -823,6 +916,8 @@ make_test_suite (void)
 	suite_add_tcase (s, tc_check_peer_state);
 	tcase_add_checked_fixture (tc_check_peer_state, mock_setup, NULL);
 	tcase_add_test (tc_check_peer_state, test_check_peer_state_pass_001);
+	tcase_add_test (tc_check_peer_state, test_check_peer_state_pass_002);
+	tcase_add_test (tc_check_peer_state, test_check_peer_state_pass_003);
 #ifndef PGM_CHECK_NOFORK
 	tcase_add_test_raise_signal (tc_check_peer_state, test_check_peer_state_fail_001, SIGABRT);
 #endif
@@ -832,6 +927,7 @@ make_test_suite (void)
 	suite_add_tcase (s, tc_min_receiver_expiry);
 	tcase_add_checked_fixture (tc_min_receiver_expiry, mock_setup, NULL);
 	tcase_add_test (tc_min_receiver_expiry, test_min_receiver_expiry_pass_001);
+	tcase_add_test (tc_min_receiver_expiry, test_min_receiver_expiry_pass_002);
 #ifndef PGM_CHECK_NOFORK
 	tcase_add_test_raise_signal (tc_min_receiver_expiry, test_min_receiver_expiry_fail_001, SIGABRT);
 #endif
@@ -29,12 +29,14 @@
 
 #include <errno.h>
 #ifndef _WIN32
+#	include <time.h>
 #	include <sys/types.h>
 #	include <sys/socket.h>
 #	include <netinet/in.h>		/* _GNU_SOURCE for in6_pktinfo */
 #else
 #	include <ws2tcpip.h>
 #	include <mswsock.h>
+#	include <process.h>
 #endif
 #include <impl/i18n.h>
 #include <impl/framework.h>
@@ -75,6 +77,161 @@
 #	define pgm_cmsghdr			cmsghdr
 #endif
 
+#ifndef _WIN32
+#	define pgm_msghdr			msghdr
+#else
+#	define pgm_msghdr			_WSAMSG
+#endif
+
+/* size of per datagram control buffer in a receive batch */
+#define PGM_RECV_BATCH_AUX_LEN		256
+
+
+/* extract the destination address of a datagram from IP_PKTINFO, IP_RECVDSTADDR,
+ * or IPV6_PKTINFO ancillary data.
+ *
+ * returns TRUE on success, returns FALSE on invalid control message.
+ */
+
+static
+bool
+recvskb_dst_addr (
+	struct pgm_msghdr*    const restrict msg,
+	struct sockaddr*      const restrict dst_addr
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != msg);
+	pgm_assert (NULL != dst_addr);
+
+	struct pgm_cmsghdr* cmsg;
+	for (cmsg = PGM_CMSG_FIRSTHDR(msg);
+	     cmsg != NULL;
+	     cmsg = PGM_CMSG_NXTHDR(msg, cmsg))
+	{
+/* both IP_PKTINFO and IP_RECVDSTADDR exist on OpenSolaris, so capture
+ * each type if defined.
+ */
+#ifdef IP_PKTINFO
+		if (IPPROTO_IP == cmsg->cmsg_level && 
+		    IP_PKTINFO == cmsg->cmsg_type)
+		{
+			const void* pktinfo		= PGM_CMSG_DATA(cmsg);
+/* discard on invalid address */
+			if (PGM_UNLIKELY(NULL == pktinfo)) {
+				pgm_debug ("in_pktinfo is NULL");
+				return FALSE;
+			}
+			const struct in_pktinfo* in	= pktinfo;
+			struct sockaddr_in s4;
+			memset (&s4, 0, sizeof(s4));
+			s4.sin_family			= AF_INET;
+			s4.sin_addr.s_addr		= in->ipi_addr.s_addr;
+			memcpy (dst_addr, &s4, sizeof(s4));
+			break;
+		}
+#endif
+#ifdef IP_RECVDSTADDR
+		if (IPPROTO_IP == cmsg->cmsg_level &&
+		    IP_RECVDSTADDR == cmsg->cmsg_type)
+		{
+			const void* recvdstaddr		= PGM_CMSG_DATA(cmsg);
+/* discard on invalid address */
+			if (PGM_UNLIKELY(NULL == recvdstaddr)) {
+				pgm_debug ("in_recvdstaddr is NULL");
+				return FALSE;
+			}
+			const struct in_addr* in	= recvdstaddr;
+			struct sockaddr_in s4;
+			memset (&s4, 0, sizeof(s4));
+			s4.sin_family			= AF_INET;
+			s4.sin_addr.s_addr		= in->s_addr;
+			memcpy (dst_addr, &s4, sizeof(s4));
+			break;
+		}
+#endif
+#if !defined(IP_PKTINFO) && !defined(IP_RECVDSTADDR)
+#	error "No defined CMSG type for IPv4 destination address."
+#endif
+
+		if (IPPROTO_IPV6 == cmsg->cmsg_level && 
+		    IPV6_PKTINFO == cmsg->cmsg_type)
+		{
+			const void* pktinfo		= PGM_CMSG_DATA(cmsg);
+/* discard on invalid address */
+			if (PGM_UNLIKELY(NULL == pktinfo)) {
+				pgm_debug ("in6_pktinfo is NULL");
+				return FALSE;
+			}
+			const struct in6_pktinfo* in6	= pktinfo;
+			struct sockaddr_in6 s6;
+			memset (&s6, 0, sizeof(s6));
+			s6.sin6_family			= AF_INET6;
+			s6.sin6_addr			= in6->ipi6_addr;
+			s6.sin6_scope_id		= in6->ipi6_ifindex;
+			memcpy (dst_addr, &s6, sizeof(s6));
+/* does not set flow id */
+			break;
+		}
+	}
+	return TRUE;
+}
+
+#ifdef SO_TIMESTAMPNS
+/* wall clock time of reading the socket, the reference for kernel receive timestamps.
+ */
+
+static inline
+pgm_time_t
+recvskb_realtime (void)
+{
+	struct timespec ts;
+	clock_gettime (CLOCK_REALTIME, &ts);
+	return pgm_secs (ts.tv_sec) + pgm_nsecs (ts.tv_nsec);
+}
+
+/* move skb::tstamp back by the dwell time in the socket receive queue, from the
+ * SCM_TIMESTAMPNS ancillary data.  the kernel stamps against the wall clock so
+ * the delay is taken against a wall clock sample of the same read, a packet
+ * without a usable timestamp keeps the read time.
+ */
+
+static
+void
+recvskb_rx_tstamp (
+	struct pgm_msghdr*    const restrict msg,
+	struct pgm_sk_buff_t* const restrict skb,
+	const pgm_time_t		     realtime
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != msg);
+	pgm_assert (NULL != skb);
+
+	struct pgm_cmsghdr* cmsg;
+	for (cmsg = PGM_CMSG_FIRSTHDR(msg);
+	     cmsg != NULL;
+	     cmsg = PGM_CMSG_NXTHDR(msg, cmsg))
+	{
+		if (SOL_SOCKET == cmsg->cmsg_level &&
+		    SCM_TIMESTAMPNS == cmsg->cmsg_type)
+		{
+			struct timespec ts;
+			memcpy (&ts, PGM_CMSG_DATA(cmsg), sizeof(ts));
+			const pgm_time_t arrival = pgm_secs (ts.tv_sec) + pgm_nsecs (ts.tv_nsec);
+			if (PGM_UNLIKELY(pgm_time_after (arrival, realtime)))
+				break;
+			const pgm_time_t delay = realtime - arrival;
+/* wall clock stepped */
+			if (PGM_UNLIKELY(delay >= skb->tstamp))
+				break;
+			PGM_HISTOGRAM_USECS("Rx.QueueingDelay", delay);
+			skb->tstamp -= delay;
+			break;
+		}
+	}
+}
+#endif /* SO_TIMESTAMPNS */
 
 /* read a packet into a PGM skbuff
  * on success returns packet length, on closed socket returns 0,
@@ -158,83 +315,190 @@ recvskb (
 	skb->len		= (uint16_t)len;
 	skb->zero_padded	= 0;
 	skb->tail		= (char*)skb->data + len;
+#ifdef SO_TIMESTAMPNS
+	if (sock->use_rx_timestamp)
+		recvskb_rx_tstamp (&msg, skb, recvskb_realtime());
+#endif
 
 	if (sock->udp_encap_ucast_port ||
 	    AF_INET6 == pgm_sockaddr_family (src_addr))
 	{
-		struct pgm_cmsghdr* cmsg;
-		for (cmsg = PGM_CMSG_FIRSTHDR(&msg);
-		     cmsg != NULL;
-		     cmsg = PGM_CMSG_NXTHDR(&msg, cmsg))
-		{
-/* both IP_PKTINFO and IP_RECVDSTADDR exist on OpenSolaris, so capture
- * each type if defined.
+		if (PGM_UNLIKELY(!recvskb_dst_addr (&msg, dst_addr)))
+			return -1;
+	}
+	return len;
+}
+
+/* create a ring of receive buffers for batched reads, one skb per slot.
+ *
+ * returns NULL if batched reads are not supported by the platform.
  */
-#ifdef IP_PKTINFO
-			if (IPPROTO_IP == cmsg->cmsg_level && 
-			    IP_PKTINFO == cmsg->cmsg_type)
-			{
-				const void* pktinfo		= PGM_CMSG_DATA(cmsg);
-/* discard on invalid address */
-				if (PGM_UNLIKELY(NULL == pktinfo)) {
-					pgm_debug ("in_pktinfo is NULL");
-					return -1;
-				}
-				const struct in_pktinfo* in	= pktinfo;
-				struct sockaddr_in s4;
-				memset (&s4, 0, sizeof(s4));
-				s4.sin_family			= AF_INET;
-				s4.sin_addr.s_addr		= in->ipi_addr.s_addr;
-				memcpy (dst_addr, &s4, sizeof(s4));
-				break;
-			}
-#endif
-#ifdef IP_RECVDSTADDR
-			if (IPPROTO_IP == cmsg->cmsg_level &&
-			    IP_RECVDSTADDR == cmsg->cmsg_type)
-			{
-				const void* recvdstaddr		= PGM_CMSG_DATA(cmsg);
-/* discard on invalid address */
-				if (PGM_UNLIKELY(NULL == recvdstaddr)) {
-					pgm_debug ("in_recvdstaddr is NULL");
-					return -1;
-				}
-				const struct in_addr* in	= recvdstaddr;
-				struct sockaddr_in s4;
-				memset (&s4, 0, sizeof(s4));
-				s4.sin_family			= AF_INET;
-				s4.sin_addr.s_addr		= in->s_addr;
-				memcpy (dst_addr, &s4, sizeof(s4));
-				break;
-			}
-#endif
-#if !defined(IP_PKTINFO) && !defined(IP_RECVDSTADDR)
-#	error "No defined CMSG type for IPv4 destination address."
+
+struct pgm_recv_batch_t*
+pgm_recv_batch_create (
+	const unsigned		batch_len,
+	pgm_skb_pool_t*const	pool,		/* maybe NULL */
+	const uint16_t		max_tpdu
+	)
+{
+/* pre-conditions */
+	pgm_assert (batch_len > 1);
+	pgm_assert (max_tpdu > 0);
+
+	pgm_debug ("pgm_recv_batch_create (batch-len:%u max-tpdu:%" PRIu16 ")",
+		batch_len, max_tpdu);
+
+#ifdef HAVE_RECVMMSG
+	struct pgm_recv_batch_t* batch = pgm_new0 (struct pgm_recv_batch_t, 1);
+	batch->skb = pgm_new0 (struct pgm_sk_buff_t*, batch_len);
+	batch->src = pgm_new0 (struct sockaddr_storage, batch_len);
+	batch->iov = pgm_new0 (struct pgm_iovec, batch_len);
+	batch->aux = pgm_malloc0 (batch_len * PGM_RECV_BATCH_AUX_LEN);
+	batch->msg = pgm_new0 (struct mmsghdr, batch_len);
+	for (unsigned i = 0; i < batch_len; i++)
+		batch->skb[i] = pgm_skb_pool_alloc (pool, max_tpdu);
+	batch->len = batch_len;
+	return batch;
+#else
+	return NULL;
+#endif /* HAVE_RECVMMSG */
+}
+
+void
+pgm_recv_batch_destroy (
+	struct pgm_recv_batch_t*	batch
+	)
+{
+	pgm_assert (NULL != batch);
+
+	for (unsigned i = 0; i < batch->len; i++)
+		pgm_free_skb (batch->skb[i]);
+	pgm_free (batch->msg);
+	pgm_free (batch->aux);
+	pgm_free (batch->iov);
+	pgm_free (batch->src);
+	pgm_free (batch->skb);
+	pgm_free (batch);
+}
+
+/* unread datagrams remaining in the receive batch ring */
+
+static inline
+bool
+recvskb_batch_is_pending (
+	const pgm_sock_t*	const	sock
+	)
+{
+	return (NULL != sock->rx_batch && sock->rx_batch->head < sock->rx_batch->count);
+}
+
+#ifdef HAVE_RECVMMSG
+/* read the next packet from the receive batch ring, refilling the ring with a
+ * single recvmmsg() when exhausted.  the returned datagram is swapped into
+ * sock::rx_buffer, the previous spare buffer takes its slot for the next refill.
+ *
+ * on success returns packet length, on closed socket returns 0,
+ * on error returns -1.
+ */
+
+static
+ssize_t
+recvskb_batch (
+	pgm_sock_t*           const restrict sock,
+	const int			     flags,
+	struct sockaddr*      const restrict src_addr,
+	const socklen_t			     src_addrlen,
+	struct sockaddr*      const restrict dst_addr,
+	const socklen_t			     dst_addrlen
+	)
+{
+	struct pgm_recv_batch_t* batch = sock->rx_batch;
+	struct mmsghdr* msgvec = batch->msg;
+
+/* pre-conditions */
+	pgm_assert (NULL != sock);
+	pgm_assert (NULL != batch);
+	pgm_assert (NULL != src_addr);
+	pgm_assert (src_addrlen >= sizeof(struct sockaddr_storage));
+	pgm_assert (NULL != dst_addr);
+	pgm_assert (dst_addrlen > 0);
+
+	pgm_debug ("recvskb_batch (sock:%p flags:%d src-addr:%p src-addrlen:%d dst-addr:%p dst-addrlen:%d)",
+		(void*)sock, flags, (void*)src_addr, (int)src_addrlen, (void*)dst_addr, (int)dst_addrlen);
+
+	if (PGM_UNLIKELY(sock->is_destroyed))
+		return 0;
+
+	if (batch->head == batch->count)
+	{
+		for (unsigned i = 0; i < batch->len; i++) {
+			batch->iov[i].iov_base		= batch->skb[i]->head;
+			batch->iov[i].iov_len		= sock->max_tpdu;
+			msgvec[i].msg_hdr.msg_name	= &batch->src[i];
+			msgvec[i].msg_hdr.msg_namelen	= sizeof(struct sockaddr_storage);
+			msgvec[i].msg_hdr.msg_iov	= (void*)&batch->iov[i];
+			msgvec[i].msg_hdr.msg_iovlen	= 1;
+			msgvec[i].msg_hdr.msg_control	= batch->aux + (i * PGM_RECV_BATCH_AUX_LEN);
+			msgvec[i].msg_hdr.msg_controllen = PGM_RECV_BATCH_AUX_LEN;
+			msgvec[i].msg_hdr.msg_flags	= 0;
+		}
+		const int count = recvmmsg (sock->recv_sock, msgvec, batch->len, flags, NULL);
+		if (count <= 0)
+			return count;
+		batch->head  = 0;
+		batch->count = (unsigned)count;
+		batch->calls++;
+		batch->datagrams += count;
+/* one timestamp per batch */
+		const pgm_time_t now = pgm_time_update_now();
+		for (int i = 0; i < count; i++)
+			batch->skb[i]->tstamp = now;
+#ifdef SO_TIMESTAMPNS
+		if (sock->use_rx_timestamp) {
+			const pgm_time_t realtime = recvskb_realtime();
+			for (int i = 0; i < count; i++)
+				recvskb_rx_tstamp (&msgvec[i].msg_hdr, batch->skb[i], realtime);
+		}
 #endif
+	}
 
-			if (IPPROTO_IPV6 == cmsg->cmsg_level && 
-			    IPV6_PKTINFO == cmsg->cmsg_type)
-			{
-				const void* pktinfo		= PGM_CMSG_DATA(cmsg);
-/* discard on invalid address */
-				if (PGM_UNLIKELY(NULL == pktinfo)) {
-					pgm_debug ("in6_pktinfo is NULL");
-					return -1;
-				}
-				const struct in6_pktinfo* in6	= pktinfo;
-				struct sockaddr_in6 s6;
-				memset (&s6, 0, sizeof(s6));
-				s6.sin6_family			= AF_INET6;
-				s6.sin6_addr			= in6->ipi6_addr;
-				s6.sin6_scope_id		= in6->ipi6_ifindex;
-				memcpy (dst_addr, &s6, sizeof(s6));
-/* does not set flow id */
-				break;
-			}
+	const unsigned i = batch->head++;
+	const ssize_t len = msgvec[i].msg_len;
+	if (PGM_UNLIKELY(0 == len))
+		return 0;
+
+/* swap consumed slot with spare receive buffer */
+	struct pgm_sk_buff_t* skb = batch->skb[i];
+	batch->skb[i] = sock->rx_buffer;
+	sock->rx_buffer = skb;
+
+#ifdef PGM_DEBUG
+	if (PGM_UNLIKELY(pgm_loss_rate > 0)) {
+		const unsigned percent = pgm_rand_int_range (&sock->rand_, 0, 100);
+		if (percent <= pgm_loss_rate) {
+			pgm_debug ("Simulated packet loss");
+			pgm_set_last_sock_error (PGM_SOCK_EAGAIN);
+			return SOCKET_ERROR;
 		}
 	}
+#endif
+
+	skb->sock		= sock;
+	skb->data		= skb->head;
+	skb->len		= (uint16_t)len;
+	skb->zero_padded	= 0;
+	skb->tail		= (char*)skb->data + len;
+
+	memcpy (src_addr, &batch->src[i], sizeof(struct sockaddr_storage));
+	if (sock->udp_encap_ucast_port ||
+	    AF_INET6 == pgm_sockaddr_family (src_addr))
+	{
+		if (PGM_UNLIKELY(!recvskb_dst_addr (&msgvec[i].msg_hdr, dst_addr)))
+			return -1;
+	}
 	return len;
 }
+#endif /* HAVE_RECVMMSG */
 
 /* upstream = receiver to source, peer-to-peer = receive to receiver
  *
@@ -310,10 +574,54 @@ on_upstream (
 
 	return TRUE;
 out_discarded:
-	sock->cumulative_stats[PGM_PC_SOURCE_PACKETS_DISCARDED]++;
+	pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_PACKETS_DISCARDED);
 	return FALSE;
 }
 
+/* check the most recently active sources before the peer table, interleaved
+ * sources within a receive batch are usually found here.  a hit is moved to
+ * the front.
+ *
+ * returns peer or NULL if not cached.
+ */
+
+static inline
+pgm_peer_t*
+peers_lru_lookup (
+	pgm_sock_t*	 const restrict sock,
+	const pgm_tsi_t* const restrict tsi
+	)
+{
+	for (unsigned i = 0; i < PGM_PEERS_LRU_LEN && NULL != sock->peers_lru[ i ]; i++)
+	{
+		pgm_peer_t* peer = sock->peers_lru[ i ];
+		if (PGM_LIKELY(0 == memcmp (&peer->tsi, tsi, sizeof(pgm_tsi_t))))
+		{
+			if (i > 0) {
+				memmove (&sock->peers_lru[ 1 ], &sock->peers_lru[ 0 ], i * sizeof(pgm_peer_t*));
+				sock->peers_lru[ 0 ] = peer;
+			}
+			return peer;
+		}
+	}
+	return NULL;
+}
+
+/* insert peer at the front of the recent source cache, evicting the least
+ * recently active.
+ */
+
+static inline
+void
+peers_lru_push (
+	pgm_sock_t* const restrict sock,
+	pgm_peer_t* const restrict peer
+	)
+{
+	memmove (&sock->peers_lru[ 1 ], &sock->peers_lru[ 0 ], (PGM_PEERS_LRU_LEN - 1) * sizeof(pgm_peer_t*));
+	sock->peers_lru[ 0 ] = peer;
+}
+
 /* peer to peer message, either multicast NAK or multicast SPMR.
  *
  * returns TRUE on valid processed packet, returns FALSE on discarded packet.
@@ -355,7 +663,7 @@ on_peer (
 	upstream_tsi.sport = skb->pgm_header->pgm_dport;
 
 	pgm_rwlock_reader_lock (&sock->peers_lock);
-	*source = pgm_hashtable_lookup (sock->peers_hashtable, &upstream_tsi);
+	*source = pgm_tsitable_lookup (sock->peers_hashtable, &upstream_tsi);
 	pgm_rwlock_reader_unlock (&sock->peers_lock);
 	if (PGM_UNLIKELY(NULL == *source)) {
 /* this source is unknown, we don't care about messages about it */
@@ -388,9 +696,9 @@ on_peer (
 	return TRUE;
 out_discarded:
 	if (*source)
-		(*source)->cumulative_stats[PGM_PC_RECEIVER_PACKETS_DISCARDED]++;
+		pgm_stats_inc ((*source)->cumulative_stats, PGM_PC_RECEIVER_PACKETS_DISCARDED);
 	else if (sock->can_send_data)
-		sock->cumulative_stats[PGM_PC_SOURCE_PACKETS_DISCARDED]++;
+		pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_PACKETS_DISCARDED);
 	return FALSE;
 }
 
@@ -435,28 +743,37 @@ on_downstream (
 		goto out_discarded;
 	}
 
-/* search for TSI peer context or create a new one */
-	if (PGM_LIKELY(pgm_tsi_hash (&skb->tsi) == sock->last_hash_key &&
-			NULL != sock->last_hash_value))
-	{
-		*source = sock->last_hash_value;
+/* PGM_FILTER_TSI, repeated here for platforms without a kernel filter */
+	if (PGM_UNLIKELY(sock->use_filter_tsi && !pgm_tsi_equal (&skb->tsi, &sock->filter_tsi))) {
+		pgm_trace (PGM_LOG_ROLE_NETWORK,_("Discarded packet from filtered source."));
+		goto out_discarded;
 	}
-	else
+
+/* search for TSI peer context or create a new one */
+	*source = peers_lru_lookup (sock, &skb->tsi);
+	if (PGM_UNLIKELY(NULL == *source))
 	{
 		pgm_rwlock_reader_lock (&sock->peers_lock);
-		*source = pgm_hashtable_lookup_extended (sock->peers_hashtable, &skb->tsi, &sock->last_hash_key);
+		*source = pgm_tsitable_lookup (sock->peers_hashtable, &skb->tsi);
 		pgm_rwlock_reader_unlock (&sock->peers_lock);
 		if (PGM_UNLIKELY(NULL == *source)) {
+/* never create a peer from an unverified source identifier */
+			if (skb->csum_deferred && !pgm_verify_checksum (skb, NULL, 0)) {
+				pgm_trace (PGM_LOG_ROLE_NETWORK,_("Discarded packet from new source on PGM checksum mismatch."));
+				if (sock->can_send_data)
+					pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_CKSUM_ERRORS);
+				goto out_discarded;
+			}
 			*source = pgm_new_peer (sock,
 					       &skb->tsi,
 					       (struct sockaddr*)src_addr, pgm_sockaddr_len(src_addr),
 					       (struct sockaddr*)dst_addr, pgm_sockaddr_len(dst_addr),
 						skb->tstamp);
 		}
-		sock->last_hash_value = *source;
+		peers_lru_push (sock, *source);
 	}
 
-	(*source)->cumulative_stats[PGM_PC_RECEIVER_BYTES_RECEIVED] += skb->len;
+	pgm_stats_add ((*source)->cumulative_stats, PGM_PC_RECEIVER_BYTES_RECEIVED, skb->len);
 	(*source)->last_packet = skb->tstamp;
 
 	skb->data       = (void*)( skb->pgm_header + 1 );
@@ -468,7 +785,7 @@ on_downstream (
 	case PGM_RDATA:
 		if (PGM_UNLIKELY(!pgm_on_data (sock, *source, skb)))
 			goto out_discarded;
-		sock->rx_buffer = pgm_alloc_skb (sock->max_tpdu);
+		sock->rx_buffer = pgm_skb_pool_alloc (sock->rx_pool, sock->max_tpdu);
 		break;
 
 	case PGM_NCF:
@@ -500,9 +817,9 @@ on_downstream (
 	return TRUE;
 out_discarded:
 	if (*source)
-		(*source)->cumulative_stats[PGM_PC_RECEIVER_PACKETS_DISCARDED]++;
+		pgm_stats_inc ((*source)->cumulative_stats, PGM_PC_RECEIVER_PACKETS_DISCARDED);
 	else if (sock->can_send_data)
-		sock->cumulative_stats[PGM_PC_SOURCE_PACKETS_DISCARDED]++;
+		pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_PACKETS_DISCARDED);
 	return FALSE;
 }
 
@@ -550,25 +867,28 @@ on_pgm (
 
 	pgm_trace (PGM_LOG_ROLE_NETWORK,_("Discarded unknown PGM packet."));
 	if (sock->can_send_data)
-		sock->cumulative_stats[PGM_PC_SOURCE_PACKETS_DISCARDED]++;
+		pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_PACKETS_DISCARDED);
 	return FALSE;
 }
 
 /* block on receiving socket whilst holding sock::waiting-mutex
- * returns EAGAIN for waiting data, returns EINTR for waiting timer event,
- * returns ENOENT on closed sock, and returns EFAULT for libc error.
+ * returns EAGAIN for waiting data, returns EINTR for waiting timer event with the
+ * time of expiry in now, returns ENOENT on closed sock, and returns EFAULT for libc
+ * error.
  */
 
 static
 int
 wait_for_event (
-	pgm_sock_t* const	sock
+	pgm_sock_t* const	sock,
+	pgm_time_t*		now
 	)
 {
 	int n_fds = 3;
 
 /* pre-conditions */
 	pgm_assert (NULL != sock);
+	pgm_assert (NULL != now);
 
 	pgm_debug ("wait_for_event (sock:%p)", (const void*)sock);
 
@@ -602,7 +922,7 @@ wait_for_event (
 		if (sock->can_send_data && !pgm_txw_retransmit_is_empty (sock->window))
 			timeout = 0;
 		else
-			timeout = (int)pgm_timer_expiration (sock);
+			timeout = (int)pgm_timer_expiration (sock, pgm_time_update_now());
 		
 #ifdef HAVE_POLL
 		const int ready = poll (fds, n_fds, timeout /* μs */ / 1000 /* to ms */);
@@ -620,11 +940,75 @@ wait_for_event (
 			pgm_debug ("recv again on empty");
 			return EAGAIN;
 		}
-	} while (pgm_timer_check (sock));
+		*now = pgm_time_update_now();
+	} while (pgm_timer_check (sock, *now));
 	pgm_debug ("state generated event");
 	return EINTR;
 }
 
+/* an APDU failing deferred checksum verification has been committed from the
+ * window and cannot be repaired, reset on unrecoverable loss from its peer.
+ * caller holds the receiver mutex.
+ */
+
+static
+void
+discard_cksum_error (
+	pgm_sock_t*		     const restrict sock,
+	const struct pgm_msgv_t*     const restrict msgv
+	)
+{
+	const struct pgm_sk_buff_t* skb = msgv->msgv_skb[0];
+	pgm_peer_t* peer;
+
+	pgm_trace (PGM_LOG_ROLE_NETWORK,_("Discarded APDU on PGM checksum mismatch, tsi %s"), pgm_tsi_print (&skb->tsi));
+	pgm_stats_atomic_inc (pgm_sock_stats (sock, PGM_STATS_APP), PGM_PC_SOURCE_CKSUM_ERRORS);
+	pgm_rwlock_reader_lock (&sock->peers_lock);
+	peer = pgm_tsitable_lookup (sock->peers_hashtable, &skb->tsi);
+	pgm_rwlock_reader_unlock (&sock->peers_lock);
+	if (PGM_LIKELY(NULL != peer))
+		pgm_peer_set_corrupt (sock, peer, msgv->msgv_len);
+}
+
+/* complete checksum verification left from arrival on APDUs returned in place
+ * to the application, corrupt APDUs are removed from the vector.
+ *
+ * returns count of bytes removed.
+ */
+
+static
+size_t
+verify_msgv (
+	pgm_sock_t*	   const restrict sock,
+	struct pgm_msgv_t* const restrict msg_start,
+	struct pgm_msgv_t**	 restrict pmsg
+	)
+{
+	struct pgm_msgv_t* msgv = msg_start;
+	size_t bytes_removed = 0;
+
+	while (msgv < *pmsg)
+	{
+		size_t apdu_length = 0;
+		bool is_valid = TRUE;
+		for (unsigned i = 0; i < msgv->msgv_len; i++) {
+			struct pgm_sk_buff_t* skb = msgv->msgv_skb[i];
+			apdu_length += skb->len;
+			if (skb->csum_deferred && !pgm_verify_checksum (skb, NULL, 0))
+				is_valid = FALSE;
+		}
+		if (PGM_LIKELY(is_valid)) {
+			msgv++;
+			continue;
+		}
+		discard_cksum_error (sock, msgv);
+		bytes_removed += apdu_length;
+		memmove (msgv, msgv + 1, (char*)*pmsg - (char*)(msgv + 1));
+		(*pmsg)--;
+	}
+	return bytes_removed;
+}
+
 /* data incoming on receive sockets, can be from a sender or receiver, or simply bogus.
  * for IPv4 we receive the IP header to handle fragmentation, for IPv6 we cannot, but the
  * underlying stack handles this for us.
@@ -640,15 +1024,20 @@ wait_for_event (
  * returns PGM_IO_STATUS_TIMER_PENDING and caller should also wait.  On
  * unrecoverable dataloss, returns PGM_IO_STATUS_CONN_RESET.  If connection is
  * closed, returns PGM_IO_STATUS_EOF.  On error, returns PGM_IO_STATUS_ERROR.
+ *
+ * with is_copy_out the caller verifies deferred checksums whilst copying.
  */
 
+static
 int
-pgm_recvmsgv (
+recvmsgv (
 	pgm_sock_t*   	   const restrict sock,
 	struct pgm_msgv_t* const restrict msg_start,
 	const size_t			  msg_len,
 	const int			  flags,	/* MSG_DONTWAIT for non-blocking */
+	const bool			  is_copy_out,
 	size_t*			 restrict _bytes_read,	/* may be NULL */
+	size_t*			 restrict _msgv_read,	/* may be NULL */
 	pgm_error_t**		 restrict error
 	)
 {
@@ -706,9 +1095,10 @@ pgm_recvmsgv (
 		return PGM_IO_STATUS_RESET;
 	}
 
-/* timer status */
-	if (pgm_timer_check (sock) &&
-	    !pgm_timer_dispatch (sock))
+/* timer status, one clock read for both check and dispatch */
+	const pgm_time_t now = pgm_time_update_now();
+	if (pgm_timer_check (sock, now) &&
+	    !pgm_timer_dispatch (sock, now))
 	{
 /* block on send-in-recv */
 		status = PGM_IO_STATUS_RATE_LIMITED;
@@ -750,6 +1140,16 @@ pgm_recvmsgv (
 
 recv_again:
 
+#ifdef HAVE_RECVMMSG
+	if (NULL != sock->rx_batch)
+		len = recvskb_batch (sock,
+				     0,
+				     (struct sockaddr*)&src,
+				     sizeof(src),
+				     (struct sockaddr*)&dst,
+				     sizeof(dst));
+	else
+#endif
 	len = recvskb (sock,
 		       sock->rx_buffer,		/* PGM skbuff */
 		       0,
@@ -783,6 +1183,9 @@ recv_again:
 		bytes_received += len;
 	}
 
+/* original data may leave checksum verification until copied out */
+	sock->rx_buffer->csum_deferred = sock->use_deferred_checksum;
+
 	pgm_error_t* err = NULL;
 	const bool is_valid = (sock->udp_encap_ucast_port || AF_INET6 == src.ss_family) ?
 					pgm_parse_udp_encap (sock->rx_buffer, &err) :
@@ -796,8 +1199,8 @@ recv_again:
 		pgm_error_free (err);
 		if (sock->can_send_data) {
 			if (err && PGM_ERROR_CKSUM == err->code)
-				sock->cumulative_stats[PGM_PC_SOURCE_CKSUM_ERRORS]++;
-			sock->cumulative_stats[PGM_PC_SOURCE_PACKETS_DISCARDED]++;
+				pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_CKSUM_ERRORS);
+			pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_PACKETS_DISCARDED);
 		}
 		goto recv_again;
 	}
@@ -838,12 +1241,16 @@ check_for_repeat:
 /* repeat if blocking and empty, i.e. received non data packet.
  */
 		if (0 == data_read) {
-			const int wait_status = wait_for_event (sock);
+/* drain the receive batch before blocking on the socket */
+			if (recvskb_batch_is_pending (sock))
+				goto recv_again;
+			pgm_time_t expiry;
+			const int wait_status = wait_for_event (sock, &expiry);
 			switch (wait_status) {
 			case EAGAIN:
 				goto recv_again;
 			case EINTR:
-				if (!pgm_timer_dispatch (sock))
+				if (!pgm_timer_dispatch (sock, expiry))
 					goto check_for_repeat;
 				goto flush_pending;
 			case ENOENT:
@@ -870,10 +1277,17 @@ check_for_repeat:
 	}
 
 out:
+	if (data_read && sock->use_deferred_checksum && !is_copy_out)
+	{
+		bytes_read -= verify_msgv (sock, msg_start, &pmsg);
+		if (pmsg == msg_start)
+			data_read = 0;
+	}
+
 	if (0 == data_read)
 	{
 /* clear event notification */
-		if (sock->is_pending_read) {
+		if (sock->is_pending_read && !recvskb_batch_is_pending (sock)) {
 			pgm_notify_clear (&sock->pending_notify);
 			sock->is_pending_read = FALSE;
 		}
@@ -910,7 +1324,7 @@ out:
 		return status;
 	}
 
-	if (sock->peers_pending)
+	if (sock->peers_pending || recvskb_batch_is_pending (sock))
 	{
 /* set event notification for additional available data */
 		if (sock->is_pending_read && sock->is_edge_triggered_recv)
@@ -929,11 +1343,404 @@ out:
 
 	if (NULL != _bytes_read)
 		*_bytes_read = bytes_read;
+	if (NULL != _msgv_read)
+		*_msgv_read = pmsg - msg_start;
 	pgm_mutex_unlock (&sock->receiver_mutex);
 	pgm_rwlock_reader_unlock (&sock->lock);
 	return PGM_IO_STATUS_NORMAL;
 }
 
+/* network thread: block until data arrives, a timer expires, or with a full ring
+ * until the application releases slots.  Timers are dispatched here whilst the ring
+ * is full as the receive path is not entered.
+ */
+
+static
+void
+recv_thread_wait (
+	pgm_sock_t* const	sock,
+	const bool		is_full
+	)
+{
+	uint32_t count;
+	int timeout;
+
+/* pre-conditions */
+	pgm_assert (NULL != sock);
+
+	if (PGM_UNLIKELY(!pgm_rwlock_reader_trylock (&sock->lock)))
+		return;
+	if (PGM_UNLIKELY(sock->is_destroyed))
+		goto out;
+
+/* flush waiting notifications before sampling state */
+	pgm_notify_clear (&sock->pending_notify);
+	sock->is_pending_read = FALSE;
+	if (is_full && NULL != pgm_ring_reserve (sock->rx_ring, &count))
+		goto out;
+
+	if (sock->can_send_data && !pgm_txw_retransmit_is_empty (sock->window))
+		timeout = 0;
+	else
+		timeout = (int)pgm_timer_expiration (sock, pgm_time_update_now());
+
+#ifdef HAVE_POLL
+	struct pollfd fds[3];
+	int n_fds = 0;
+	memset (fds, 0, sizeof(fds));
+	if (!is_full) {
+		fds[n_fds].fd = sock->recv_sock;
+		fds[n_fds++].events = POLLIN;
+	}
+	if (sock->can_send_data) {
+		fds[n_fds].fd = pgm_notify_get_socket (&sock->rdata_notify);
+		fds[n_fds++].events = POLLIN;
+	}
+	fds[n_fds].fd = pgm_notify_get_socket (&sock->pending_notify);
+	fds[n_fds++].events = POLLIN;
+	poll (fds, n_fds, timeout /* μs */ / 1000 /* to ms */);
+#else
+	fd_set readfds;
+	int n_fds = 0;
+	FD_ZERO(&readfds);
+	if (!is_full) {
+		FD_SET(sock->recv_sock, &readfds);
+		n_fds = MAX(n_fds, (int)sock->recv_sock + 1);
+	}
+	if (sock->can_send_data) {
+		const SOCKET rdata_fd = pgm_notify_get_socket (&sock->rdata_notify);
+		FD_SET(rdata_fd, &readfds);
+		n_fds = MAX(n_fds, (int)rdata_fd + 1);
+	}
+	const SOCKET pending_fd = pgm_notify_get_socket (&sock->pending_notify);
+	FD_SET(pending_fd, &readfds);
+	n_fds = MAX(n_fds, (int)pending_fd + 1);
+	struct timeval tv_timeout = {
+		.tv_sec		= timeout > 1000000L ? (timeout / 1000000L) : 0,
+		.tv_usec	= timeout > 1000000L ? (timeout % 1000000L) : timeout
+	};
+	select (n_fds, &readfds, NULL, NULL, &tv_timeout);
+#endif /* HAVE_POLL */
+
+	if (is_full) {
+		const pgm_time_t now = pgm_time_update_now();
+		pgm_mutex_lock (&sock->receiver_mutex);
+		if (pgm_timer_check (sock, now))
+			pgm_timer_dispatch (sock, now);
+		pgm_mutex_unlock (&sock->receiver_mutex);
+	}
+out:
+	pgm_rwlock_reader_unlock (&sock->lock);
+}
+
+/* network thread: runs the receive path non-blocking directly into free ring slots.
+ * Window buffers are referenced before publication as the next pass commits and
+ * removes them from the receive window.
+ */
+
+static
+#ifndef _WIN32
+void*
+#else
+unsigned
+__stdcall
+#endif
+recv_thread (
+	void*		arg
+	)
+{
+	pgm_sock_t* const sock = (pgm_sock_t*)arg;
+
+	pgm_debug ("recv_thread (sock:%p)", (const void*)sock);
+
+	while (!sock->is_destroyed)
+	{
+		uint32_t count;
+		struct pgm_msgv_t* msgv = pgm_ring_reserve (sock->rx_ring, &count);
+		if (NULL == msgv) {
+			recv_thread_wait (sock, TRUE);
+			continue;
+		}
+
+		size_t msgv_read = 0;
+		pgm_error_t* err = NULL;
+		const int status = recvmsgv (sock, msgv, count, MSG_DONTWAIT | MSG_ERRQUEUE, FALSE, NULL, &msgv_read, &err);
+		switch (status) {
+		case PGM_IO_STATUS_NORMAL:
+			for (size_t i = 0; i < msgv_read; i++)
+				for (uint32_t j = 0; j < msgv[i].msgv_len; j++)
+					pgm_skb_get (msgv[i].msgv_skb[j]);
+			if (pgm_ring_commit (sock->rx_ring, (uint32_t)msgv_read))
+				pgm_notify_send (&sock->ring_notify);
+			break;
+
+		case PGM_IO_STATUS_RESET:
+/* loss is queued in order with data as a zero length vector holding the error buffer */
+			msgv->msgv_len = 0;
+			if (pgm_ring_commit (sock->rx_ring, 1))
+				pgm_notify_send (&sock->ring_notify);
+			if (!sock->is_abort_on_reset)
+				break;
+			pgm_atomic_write32 (&sock->rx_thread_status, PGM_IO_STATUS_RESET);
+			pgm_notify_send (&sock->ring_notify);
+			goto out;
+
+		case PGM_IO_STATUS_WOULD_BLOCK:
+		case PGM_IO_STATUS_RATE_LIMITED:
+		case PGM_IO_STATUS_TIMER_PENDING:
+			recv_thread_wait (sock, FALSE);
+			break;
+
+		default:
+/* closing socket is not an error */
+			if (sock->is_destroyed) {
+				pgm_error_free (err);
+				goto out;
+			}
+			sock->rx_thread_error = err;
+			pgm_atomic_compare_and_exchange32 (&sock->rx_thread_status, (uint32_t)status, PGM_IO_STATUS_NORMAL);
+			pgm_notify_send (&sock->ring_notify);
+			goto out;
+		}
+	}
+
+out:
+	pgm_debug ("recv_thread exit (sock:%p)", (const void*)sock);
+#ifndef _WIN32
+	return NULL;
+#else
+	return 0;
+#endif
+}
+
+/* start the network thread, called without the socket lock held.
+ *
+ * returns TRUE on success, returns FALSE on failure and sets error appropriately.
+ */
+
+PGM_GNUC_INTERNAL
+bool
+pgm_recv_thread_create (
+	pgm_sock_t*   const restrict sock,
+	pgm_error_t**	    restrict error
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != sock);
+	pgm_assert (NULL != sock->rx_ring);
+	pgm_assert (!sock->has_rx_thread);
+
+	pgm_debug ("pgm_recv_thread_create (sock:%p error:%p)",
+		(const void*)sock, (const void*)error);
+
+#ifndef _WIN32
+	const int status = pthread_create (&sock->rx_thread, NULL, &recv_thread, sock);
+	if (0 != status) {
+		char errbuf[1024];
+		pgm_set_error (error,
+			     PGM_ERROR_DOMAIN_SOCKET,
+			     pgm_error_from_errno (status),
+			     _("Creating network thread: %s"),
+			     pgm_strerror_s (errbuf, sizeof (errbuf), status));
+		return FALSE;
+	}
+#else
+	sock->rx_thread = (HANDLE)_beginthreadex (NULL, 0, &recv_thread, sock, 0, NULL);
+	if (0 == sock->rx_thread) {
+		const int save_errno = errno;
+		char errbuf[1024];
+		pgm_set_error (error,
+			     PGM_ERROR_DOMAIN_SOCKET,
+			     pgm_error_from_errno (save_errno),
+			     _("Creating network thread: %s"),
+			     pgm_strerror_s (errbuf, sizeof (errbuf), save_errno));
+		return FALSE;
+	}
+#endif /* _WIN32 */
+	sock->has_rx_thread = TRUE;
+	return TRUE;
+}
+
+/* wait for the network thread to exit after the socket is marked destroyed.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_recv_thread_join (
+	pgm_sock_t* const	sock
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != sock);
+	pgm_assert (sock->has_rx_thread);
+	pgm_assert (sock->is_destroyed);
+
+#ifndef _WIN32
+	pthread_join (sock->rx_thread, NULL);
+#else
+	WaitForSingleObject (sock->rx_thread, INFINITE);
+	CloseHandle (sock->rx_thread);
+#endif
+}
+
+/* application side of the network thread, APDUs are read from the ring without the
+ * socket locks.  Returned vectors reference ring slots which are lent to the
+ * application until the next call, the lock is only taken to block on an empty ring.
+ */
+
+static
+int
+recvmsgv_ring (
+	pgm_sock_t*   	   const restrict sock,
+	struct pgm_msgv_t* const restrict msg_start,
+	const size_t			  msg_len,
+	const int			  flags,	/* MSG_DONTWAIT for non-blocking */
+	size_t*			 restrict _bytes_read,	/* may be NULL */
+	pgm_error_t**		 restrict error
+	)
+{
+	struct pgm_msgv_t* msgv;
+	uint32_t count;
+
+	pgm_debug ("recvmsgv_ring (sock:%p msg-start:%p msg-len:%" PRIzu " flags:%d bytes-read:%p error:%p)",
+		(void*)sock, (void*)msg_start, msg_len, flags, (void*)_bytes_read, (void*)error);
+
+/* parameters */
+	pgm_return_val_if_fail (NULL != sock, PGM_IO_STATUS_ERROR);
+	if (PGM_LIKELY(msg_len)) pgm_return_val_if_fail (NULL != msg_start, PGM_IO_STATUS_ERROR);
+
+/* return slots lent by the previous call */
+	if (sock->rx_ring_held) {
+		msgv = pgm_ring_peek (sock->rx_ring, &count);
+		pgm_assert (count >= sock->rx_ring_held);
+		for (uint32_t i = 0; i < sock->rx_ring_held; i++)
+			for (uint32_t j = 0; j < msgv[i].msgv_len; j++)
+				pgm_free_skb (msgv[i].msgv_skb[j]);
+		if (pgm_ring_release (sock->rx_ring, sock->rx_ring_held))
+			pgm_notify_send (&sock->pending_notify);
+		sock->rx_ring_held = 0;
+	}
+
+/* thread status is sampled first as final data is published before exit */
+	int thread_status = (int)pgm_atomic_read32 (&sock->rx_thread_status);
+	msgv = pgm_ring_peek (sock->rx_ring, &count);
+	if (NULL == msgv) {
+/* clear event notification then re-check so a concurrent publish is not lost */
+		pgm_notify_clear (&sock->ring_notify);
+		thread_status = (int)pgm_atomic_read32 (&sock->rx_thread_status);
+		msgv = pgm_ring_peek (sock->rx_ring, &count);
+	}
+	while (NULL == msgv)
+	{
+		if (PGM_IO_STATUS_NORMAL != thread_status) {
+			if (sock->rx_thread_error) {
+				pgm_propagate_error (error, sock->rx_thread_error);
+				sock->rx_thread_error = NULL;
+			}
+			return thread_status;
+		}
+		if (sock->is_nonblocking ||
+		    flags & MSG_DONTWAIT)
+		{
+			return PGM_IO_STATUS_WOULD_BLOCK;
+		}
+
+/* shutdown */
+		if (PGM_UNLIKELY(!pgm_rwlock_reader_trylock (&sock->lock)))
+			pgm_return_val_if_reached (PGM_IO_STATUS_ERROR);
+		if (PGM_UNLIKELY(sock->is_destroyed)) {
+			pgm_rwlock_reader_unlock (&sock->lock);
+			return PGM_IO_STATUS_EOF;
+		}
+#ifdef HAVE_POLL
+		struct pollfd fds[1];
+		memset (fds, 0, sizeof(fds));
+		fds[0].fd = pgm_notify_get_socket (&sock->ring_notify);
+		fds[0].events = POLLIN;
+		const int ready = poll (fds, 1, -1);
+#else
+		fd_set readfds;
+		const SOCKET ring_fd = pgm_notify_get_socket (&sock->ring_notify);
+		FD_ZERO(&readfds);
+		FD_SET(ring_fd, &readfds);
+		const int ready = select ((int)ring_fd + 1, &readfds, NULL, NULL, NULL);
+#endif /* HAVE_POLL */
+		if (PGM_UNLIKELY(SOCKET_ERROR == ready)) {
+			const int save_errno = pgm_get_last_sock_error();
+			char errbuf[1024];
+			pgm_set_error (error,
+					PGM_ERROR_DOMAIN_RECV,
+					pgm_error_from_sock_errno (save_errno),
+					_("Waiting for event: %s"),
+					pgm_sock_strerror_s (errbuf, sizeof (errbuf), save_errno)
+					);
+			pgm_rwlock_reader_unlock (&sock->lock);
+			return PGM_IO_STATUS_ERROR;
+		}
+		pgm_rwlock_reader_unlock (&sock->lock);
+		pgm_notify_clear (&sock->ring_notify);
+		thread_status = (int)pgm_atomic_read32 (&sock->rx_thread_status);
+		msgv = pgm_ring_peek (sock->rx_ring, &count);
+	}
+
+/* report data loss */
+	if (PGM_UNLIKELY(0 == msgv->msgv_len))
+	{
+		struct pgm_sk_buff_t* error_skb = msgv->msgv_skb[0];
+		if (flags & MSG_ERRQUEUE && msg_len) {
+			msg_start->msgv_skb[0] = error_skb;
+			msg_start->msgv_len    = 1;
+		} else {
+			if (error) {
+				char tsi[PGM_TSISTRLEN];
+				pgm_tsi_print_r (&error_skb->tsi, tsi, sizeof(tsi));
+				pgm_set_error (error,
+					     PGM_ERROR_DOMAIN_RECV,
+					     PGM_ERROR_CONNRESET,
+					     _("Transport has been reset on unrecoverable loss from %s."),
+					     tsi);
+			}
+			pgm_free_skb (error_skb);
+		}
+		if (pgm_ring_release (sock->rx_ring, 1))
+			pgm_notify_send (&sock->pending_notify);
+		return PGM_IO_STATUS_RESET;
+	}
+
+	size_t bytes_read = 0;
+	uint32_t i;
+	for (i = 0; i < count && i < msg_len && 0 != msgv[i].msgv_len; i++)
+	{
+		msg_start[i].msgv_len = msgv[i].msgv_len;
+		for (uint32_t j = 0; j < msgv[i].msgv_len; j++) {
+			msg_start[i].msgv_skb[j] = msgv[i].msgv_skb[j];
+			bytes_read += msgv[i].msgv_skb[j]->len;
+		}
+	}
+	sock->rx_ring_held = i;
+
+	if (NULL != _bytes_read)
+		*_bytes_read = bytes_read;
+	return PGM_IO_STATUS_NORMAL;
+}
+
+int
+pgm_recvmsgv (
+	pgm_sock_t*   	   const restrict sock,
+	struct pgm_msgv_t* const restrict msg_start,
+	const size_t			  msg_len,
+	const int			  flags,	/* MSG_DONTWAIT for non-blocking */
+	size_t*			 restrict _bytes_read,	/* may be NULL */
+	pgm_error_t**		 restrict error
+	)
+{
+	pgm_return_val_if_fail (NULL != sock, PGM_IO_STATUS_ERROR);
+
+	if (NULL != sock->rx_ring)
+		return recvmsgv_ring (sock, msg_start, msg_len, flags, _bytes_read, error);
+	return recvmsgv (sock, msg_start, msg_len, flags, FALSE, _bytes_read, NULL, error);
+}
+
 /* read one contiguous apdu and return as a IO scatter/gather array.  msgv is owned by
  * the caller, tpdu contents are owned by the receive window.
  *
@@ -990,7 +1797,11 @@ pgm_recvfrom (
 	pgm_debug ("pgm_recvfrom (sock:%p buf:%p buflen:%" PRIzu " flags:%d bytes-read:%p from:%p from:%p error:%p)",
 		(const void*)sock, buf, buflen, flags, (const void*)_bytes_read, (const void*)from, (const void*)fromlen, (const void*)error);
 
-	const int status = pgm_recvmsg (sock, &msgv, flags & ~(MSG_ERRQUEUE), &bytes_read, error);
+again:
+	bytes_read = 0;
+	const int status = (NULL != sock->rx_ring) ?
+				recvmsgv_ring (sock, &msgv, 1, flags & ~(MSG_ERRQUEUE), &bytes_read, error) :
+				recvmsgv (sock, &msgv, 1, flags & ~(MSG_ERRQUEUE), TRUE, &bytes_read, NULL, error);
 	if (PGM_IO_STATUS_NORMAL != status)
 		return status;
 
@@ -1012,7 +1823,18 @@ pgm_recvfrom (
 			copy_len = buflen - bytes_copied;
 			bytes_read = buflen;
 		}
-		memcpy ((char*)buf + bytes_copied, pskb->data, copy_len);
+/* verify deferred checksum in the same pass as the copy, a corrupt APDU is
+ * reported as a reset by the next read.
+ */
+		if (pskb->csum_deferred) {
+			if (PGM_UNLIKELY(!pgm_verify_checksum (pskb, (char*)buf + bytes_copied, (uint16_t)copy_len))) {
+				pgm_mutex_lock (&sock->receiver_mutex);
+				discard_cksum_error (sock, &msgv);
+				pgm_mutex_unlock (&sock->receiver_mutex);
+				goto again;
+			}
+		} else
+			memcpy ((char*)buf + bytes_copied, pskb->data, copy_len);
 		bytes_copied += copy_len;
 		pskb = *(++skb);
 	}
@@ -22,6 +22,9 @@
 #ifndef _GNU_SOURCE
 #	define _GNU_SOURCE
 #endif
+#ifdef HAVE_CONFIG_H
+#	include <config.h>		/* HAVE_RECVMMSG for mock prototypes */
+#endif
 
 #include <signal.h>
 #include <stdbool.h>
@@ -87,12 +90,16 @@ unsigned mock_pgm_loss_rate = 0;
 
 #ifndef _WIN32
 static ssize_t mock_recvmsg (int, struct msghdr*, int);
+#	ifdef HAVE_RECVMMSG
+static int mock_recvmmsg (int, struct mmsghdr*, unsigned, int, struct timespec*);
+#	endif
 #else
 static int mock_recvfrom (SOCKET, char*, int, int, struct sockaddr*, int*);
 #endif
 
 #define pgm_parse_raw			mock_pgm_parse_raw
 #define pgm_parse_udp_encap		mock_pgm_parse_udp_encap
+#define pgm_verify_checksum		mock_pgm_verify_checksum
 #define pgm_verify_spm			mock_pgm_verify_spm
 #define pgm_verify_nak			mock_pgm_verify_nak
 #define pgm_verify_ncf			mock_pgm_verify_ncf
@@ -102,6 +109,7 @@ static int mock_recvfrom (SOCKET, char*, int, int, struct sockaddr*, int*);
 #define pgm_flush_peers_pending		mock_pgm_flush_peers_pending
 #define pgm_peer_has_pending		mock_pgm_peer_has_pending
 #define pgm_peer_set_pending		mock_pgm_peer_set_pending
+#define pgm_peer_set_corrupt		mock_pgm_peer_set_corrupt
 #define pgm_txw_retransmit_is_empty	mock_pgm_txw_retransmit_is_empty
 #define pgm_rxw_create			mock_pgm_rxw_create
 #define pgm_rxw_readv			mock_pgm_rxw_readv
@@ -123,6 +131,7 @@ static int mock_recvfrom (SOCKET, char*, int, int, struct sockaddr*, int*);
 #define pgm_time_now			mock_pgm_time_now
 #define pgm_time_update_now		mock_pgm_time_update_now
 #define recvmsg				mock_recvmsg
+#define recvmmsg			mock_recvmmsg
 #define recvfrom			mock_recvfrom
 #define pgm_WSARecvMsg			mock_pgm_WSARecvMsg
 #define pgm_loss_rate			mock_pgm_loss_rate
@@ -176,7 +185,7 @@ generate_sock (void)
 	sock->can_send_data = TRUE;
 	sock->can_send_nak = TRUE;
 	sock->can_recv_data = TRUE;
-	sock->peers_hashtable = pgm_hashtable_new (pgm_tsi_hash, pgm_tsi_equal);
+	sock->peers_hashtable = pgm_tsitable_new ();
 	pgm_rand_create (&sock->rand_);
 	sock->nak_bo_ivl = 100*1000;
 	pgm_notify_init (&sock->pending_notify);
@@ -588,6 +597,19 @@ mock_pgm_parse_udp_encap (
 	return TRUE;
 }
 
+bool
+mock_pgm_verify_checksum (
+	struct pgm_sk_buff_t* const	skb,
+	void*				dst,
+	const uint16_t			len
+	)
+{
+	if (dst)
+		memcpy (dst, skb->data, len);
+	skb->csum_deferred = 0;
+	return TRUE;
+}
+
 bool
 mock_pgm_verify_spm (
 	const struct pgm_sk_buff_t* const	skb
@@ -671,7 +693,7 @@ mock_pgm_new_peer (
 					    sock->ack_c_p);
 	peer->spmr_expiry = now + sock->spmr_expiry;
 	gpointer entry = mock__pgm_peer_ref(peer);
-	pgm_hashtable_insert (sock->peers_hashtable, &peer->tsi, entry);
+	pgm_tsitable_insert (sock->peers_hashtable, &peer->tsi, entry);
 	peer->peers_link.next = sock->peers_list;
 	peer->peers_link.data = peer;
 	if (sock->peers_list)
@@ -746,6 +768,20 @@ mock_pgm_peer_set_pending (
 	sock->peers_pending = &peer->pending_link;
 }
 
+PGM_GNUC_INTERNAL
+void
+mock_pgm_peer_set_corrupt (
+	pgm_sock_t* const          sock,
+	pgm_peer_t* const               peer,
+	const unsigned			packets
+	)
+{
+	g_assert (NULL != sock);
+	g_assert (NULL != peer);
+	sock->is_reset = TRUE;
+	mock_pgm_peer_set_pending (sock, peer);
+}
+
 PGM_GNUC_INTERNAL
 bool
 mock_pgm_on_data (
@@ -935,7 +971,8 @@ mock_pgm_timer_prepare (
 PGM_GNUC_INTERNAL
 bool
 mock_pgm_timer_check (
-	pgm_sock_t* const		sock
+	pgm_sock_t* const		sock,
+	const pgm_time_t		now
 	)
 {
 	return FALSE;
@@ -944,7 +981,8 @@ mock_pgm_timer_check (
 PGM_GNUC_INTERNAL
 pgm_time_t
 mock_pgm_timer_expiration (
-	pgm_sock_t* const		sock
+	pgm_sock_t* const		sock,
+	const pgm_time_t		now
 	)
 {
 	return 100L;
@@ -953,7 +991,8 @@ mock_pgm_timer_expiration (
 PGM_GNUC_INTERNAL
 bool
 mock_pgm_timer_dispatch (
-	pgm_sock_t* const		sock
+	pgm_sock_t* const		sock,
+	const pgm_time_t		now
 	)
 {
 	return TRUE;
@@ -1010,6 +1049,39 @@ mock_recvmsg (
 	errno = mock_errno;
 	return mock_retval;
 }
+
+#	ifdef HAVE_RECVMMSG
+/* consume consecutive successful reads from the recvmsg list */
+static
+int
+mock_recvmmsg (
+	int			s,
+	struct mmsghdr*		msgvec,
+	unsigned		vlen,
+	int			flags,
+	struct timespec*	timeout
+	)
+{
+	g_assert (NULL != msgvec);
+	g_assert (vlen > 0);
+	g_assert (NULL != mock_recvmsg_list);
+
+	g_debug ("mock_recvmmsg (s:%d msgvec:%p vlen:%u flags:%d timeout:%p)",
+		s, (gpointer)msgvec, vlen, flags, (gpointer)timeout);
+
+	struct mock_recvmsg_t* mr = mock_recvmsg_list->data;
+	if (mr->mr_retval < 0)
+		return mock_recvmsg (s, &msgvec[0].msg_hdr, flags);
+	unsigned i;
+	for (i = 0; i < vlen && NULL != mock_recvmsg_list; i++) {
+		mr = mock_recvmsg_list->data;
+		if (mr->mr_retval < 0)
+			break;
+		msgvec[i].msg_len = mock_recvmsg (s, &msgvec[i].msg_hdr, flags);
+	}
+	return i;
+}
+#	endif /* HAVE_RECVMMSG */
 #else
 static
 int
@@ -1569,6 +1641,131 @@ START_TEST (test_on_many_data_pass_001)
 }
 END_TEST
 
+#ifdef HAVE_RECVMMSG
+/* batched read of data and a following packet, both returned by one call */
+START_TEST (test_batch_pass_001)
+{
+	const char source[] = "i am not a string";
+	pgm_sock_t* sock = generate_sock();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->rx_batch_len = 4;
+	sock->rx_batch = pgm_recv_batch_create (sock->rx_batch_len, NULL, sock->max_tpdu);
+	fail_if (NULL == sock->rx_batch, "recv_batch_create failed");
+	guint8 buffer[ TEST_TXW_SQNS * TEST_MAX_TPDU ];
+	gpointer packet; gsize packet_len;
+	generate_odata (source, sizeof(source), 0 /* sqn */, -1 /* trail */, &packet, &packet_len);
+	generate_msghdr (packet, packet_len);
+	generate_spm (200 /* spm-sqn */, -1 /* trail */, 0 /* lead */, &packet, &packet_len);
+	generate_msghdr (packet, packet_len);
+	push_block_event ();
+	gsize bytes_read;
+	pgm_error_t* err = NULL;
+	fail_unless (PGM_IO_STATUS_TIMER_PENDING == pgm_recv (sock, buffer, sizeof(buffer), MSG_DONTWAIT, &bytes_read, &err), "recv failed");
+	fail_unless (PGM_SPM == mock_pgm_type, "unexpected PGM packet");
+	fail_unless (1 == sock->rx_batch->calls, "unexpected batch calls");
+	fail_unless (2 == sock->rx_batch->datagrams, "unexpected batch datagrams");
+	fail_unless (NULL == mock_recvmsg_list, "unread datagrams");
+}
+END_TEST
+#endif /* HAVE_RECVMMSG */
+
+#ifdef SO_TIMESTAMPNS
+/* kernel receive timestamp moves skb::tstamp back by the socket queueing delay */
+START_TEST (test_rx_timestamp_pass_001)
+{
+	const char source[] = "i am not a string";
+	pgm_sock_t* sock = generate_sock();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->use_rx_timestamp = TRUE;
+	mock_pgm_time_now = pgm_secs(100);
+	gpointer packet; gsize packet_len;
+	generate_odata (source, sizeof(source), 0 /* sqn */, -1 /* trail */, &packet, &packet_len);
+	generate_msghdr (packet, packet_len);
+/* replace ancillary data with an arrival 5ms before the read */
+	struct mock_recvmsg_t* mr = mock_recvmsg_list->data;
+	char* aux = g_malloc0 (CMSG_SPACE(sizeof(struct timespec)));
+	struct msghdr ts_msg = { .msg_control = aux, .msg_controllen = CMSG_SPACE(sizeof(struct timespec)) };
+	struct cmsghdr* cmsg = CMSG_FIRSTHDR(&ts_msg);
+	cmsg->cmsg_level = SOL_SOCKET;
+	cmsg->cmsg_type  = SCM_TIMESTAMPNS;
+	cmsg->cmsg_len   = CMSG_LEN(sizeof(struct timespec));
+	struct timespec ts;
+	clock_gettime (CLOCK_REALTIME, &ts);
+	ts.tv_nsec -= 5000000L;
+	if (ts.tv_nsec < 0) { ts.tv_sec--; ts.tv_nsec += 1000000000L; }
+	memcpy (CMSG_DATA(cmsg), &ts, sizeof(ts));
+	mr->mr_msg->msg_control    = aux;
+	mr->mr_msg->msg_controllen = ts_msg.msg_controllen;
+	struct pgm_sk_buff_t* skb = pgm_alloc_skb (sock->max_tpdu);
+	struct sockaddr_storage src, dst;
+	fail_unless ((ssize_t)packet_len == recvskb (sock, skb, 0, (struct sockaddr*)&src, sizeof(src), (struct sockaddr*)&dst, sizeof(dst)), "recvskb failed");
+	fail_unless (skb->tstamp <= mock_pgm_time_now - pgm_msecs(5), "timestamp not applied");
+	fail_unless (skb->tstamp > mock_pgm_time_now - pgm_secs(1), "timestamp out of range");
+	pgm_free_skb (skb);
+}
+END_TEST
+#endif /* SO_TIMESTAMPNS */
+
+/* APDUs from the network thread ring are lent until the next call */
+START_TEST (test_ring_pass_001)
+{
+	const char source[] = "i am not a string";
+	pgm_sock_t* sock = generate_sock();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->rx_ring = pgm_ring_create (4);
+	pgm_notify_init (&sock->ring_notify);
+	pgm_atomic_write32 (&sock->rx_thread_status, PGM_IO_STATUS_NORMAL);
+	struct pgm_sk_buff_t* skb = pgm_alloc_skb (TEST_MAX_TPDU);
+	memcpy (pgm_skb_put (skb, sizeof(source)), source, sizeof(source));
+	pgm_skb_get (skb);
+	uint32_t count;
+	struct pgm_msgv_t* slot = pgm_ring_reserve (sock->rx_ring, &count);
+	slot->msgv_len = 1;
+	slot->msgv_skb[0] = skb;
+	fail_unless (TRUE == pgm_ring_commit (sock->rx_ring, 1), "commit failed");
+	struct pgm_msgv_t msgv[4];
+	gsize bytes_read = 0;
+	pgm_error_t* err = NULL;
+	fail_unless (PGM_IO_STATUS_NORMAL == pgm_recvmsgv (sock, msgv, G_N_ELEMENTS(msgv), MSG_DONTWAIT, &bytes_read, &err), "recvmsgv failed");
+	fail_unless (sizeof(source) == bytes_read, "unexpected bytes read");
+	fail_unless (1 == msgv[0].msgv_len, "unexpected msgv length");
+	fail_unless (skb == msgv[0].msgv_skb[0], "unexpected msgv buffer");
+	fail_unless (1 == sock->rx_ring_held, "unexpected held slots");
+	fail_unless (2 == pgm_atomic_read32 (&skb->users), "unexpected buffer users");
+	fail_unless (PGM_IO_STATUS_WOULD_BLOCK == pgm_recvmsgv (sock, msgv, G_N_ELEMENTS(msgv), MSG_DONTWAIT, &bytes_read, &err), "recvmsgv failed");
+	fail_unless (0 == sock->rx_ring_held, "unexpected held slots");
+	fail_unless (1 == pgm_atomic_read32 (&skb->users), "unexpected buffer users");
+	pgm_free_skb (skb);
+}
+END_TEST
+
+/* loss notification in order with data, then thread exit status */
+START_TEST (test_ring_pass_002)
+{
+	pgm_sock_t* sock = generate_sock();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->rx_ring = pgm_ring_create (4);
+	pgm_notify_init (&sock->ring_notify);
+	pgm_atomic_write32 (&sock->rx_thread_status, PGM_IO_STATUS_NORMAL);
+	struct pgm_sk_buff_t* error_skb = pgm_alloc_skb (0);
+	uint32_t count;
+	struct pgm_msgv_t* slot = pgm_ring_reserve (sock->rx_ring, &count);
+	slot->msgv_len = 0;
+	slot->msgv_skb[0] = error_skb;
+	pgm_ring_commit (sock->rx_ring, 1);
+	pgm_atomic_write32 (&sock->rx_thread_status, PGM_IO_STATUS_EOF);
+	struct pgm_msgv_t msgv[4];
+	gsize bytes_read = 0;
+	pgm_error_t* err = NULL;
+	fail_unless (PGM_IO_STATUS_RESET == pgm_recvmsgv (sock, msgv, G_N_ELEMENTS(msgv), 0, &bytes_read, &err), "recvmsgv failed");
+	fail_if (NULL == err, "error not set");
+	fail_unless (PGM_ERROR_CONNRESET == err->code, "unexpected error code");
+	pgm_error_free (err);
+	err = NULL;
+	fail_unless (PGM_IO_STATUS_EOF == pgm_recvmsgv (sock, msgv, G_N_ELEMENTS(msgv), 0, &bytes_read, &err), "recvmsgv failed");
+}
+END_TEST
+
 START_TEST (test_recv_fail_001)
 {
 	guint8 buffer[ TEST_TXW_SQNS * TEST_MAX_TPDU ];
@@ -1725,6 +1922,26 @@ make_test_suite (void)
 	tcase_add_checked_fixture (tc_on_many_data, mock_setup, mock_teardown);
 	tcase_add_test (tc_on_many_data, test_on_many_data_pass_001);
 
+#ifdef HAVE_RECVMMSG
+	TCase* tc_batch = tcase_create ("batch");
+	suite_add_tcase (s, tc_batch);
+	tcase_add_checked_fixture (tc_batch, mock_setup, mock_teardown);
+	tcase_add_test (tc_batch, test_batch_pass_001);
+#endif
+
+#ifdef SO_TIMESTAMPNS
+	TCase* tc_rx_timestamp = tcase_create ("rx-timestamp");
+	suite_add_tcase (s, tc_rx_timestamp);
+	tcase_add_checked_fixture (tc_rx_timestamp, mock_setup, mock_teardown);
+	tcase_add_test (tc_rx_timestamp, test_rx_timestamp_pass_001);
+#endif
+
+	TCase* tc_ring = tcase_create ("ring");
+	suite_add_tcase (s, tc_ring);
+	tcase_add_checked_fixture (tc_ring, mock_setup, mock_teardown);
+	tcase_add_test (tc_ring, test_ring_pass_001);
+	tcase_add_test (tc_ring, test_ring_pass_002);
+
 	TCase* tc_recv = tcase_create ("recv");
 	suite_add_tcase (s, tc_recv);
 	tcase_add_checked_fixture (tc_recv, mock_setup, mock_teardown);
@@ -29,8 +29,47 @@
 #endif
 #include <impl/framework.h>
 
-#ifdef USE_GALOIS_SSE3
-#	include <x86intrin.h>
+#if defined(__SSSE3__) || defined(__AVX2__) || defined(__GFNI__) || defined(_M_AMD64) || defined(_M_X64)
+#	ifdef _MSC_VER
+#		include <intrin.h>
+#	else
+#		include <x86intrin.h>
+#	endif
+#endif
+
+
+/* locals */
+
+typedef void (*pgm_gf_vec_addmul_func) (pgm_gf8_t*restrict, const pgm_gf8_t, const pgm_gf8_t*restrict, uint16_t);
+
+static void _pgm_gf_vec_addmul_scalar (pgm_gf8_t*restrict, const pgm_gf8_t, const pgm_gf8_t*restrict, uint16_t);
+/* SSSE3 - PSHUFB as a 16 entry lookup table on each nibble. */
+#if defined(__SSSE3__) || defined(_M_AMD64) || defined(_M_X64)
+static void _pgm_gf_vec_addmul_ssse3 (pgm_gf8_t*restrict, const pgm_gf8_t, const pgm_gf8_t*restrict, uint16_t);
+#endif
+/* AVX2 - VPSHUFB on 256-bit operands. */
+#if defined(__AVX2__) || defined(_M_AMD64) || defined(_M_X64)
+static void _pgm_gf_vec_addmul_avx2 (pgm_gf8_t*restrict, const pgm_gf8_t, const pgm_gf8_t*restrict, uint16_t);
+#endif
+/* GFNI - VGF2P8MULB is fixed to the AES polynomial x⁸ + x⁴ + x³ + x + 1, so
+ * multiplication by a constant is performed with VGF2P8AFFINEQB instead.
+ */
+#if (defined(__GFNI__) && defined(__AVX2__)) || defined(_M_AMD64) || defined(_M_X64)
+static void _pgm_gf_vec_addmul_gfni (pgm_gf8_t*restrict, const pgm_gf8_t, const pgm_gf8_t*restrict, uint16_t);
+#endif
+
+static pgm_gf_vec_addmul_func gf_vec_addmul = _pgm_gf_vec_addmul_scalar;
+
+/* Products of every field element with each nibble value, b • j and
+ * b • (j << 4), and multiplication by b as an 8×8 bit matrix.  Built once
+ * by pgm_rs_init().
+ */
+static pgm_gf8_t nibble_gftable[ PGM_GF_NO_ELEMENTS ][ 2 ][ 16 ];
+static uint64_t affine_gftable[ PGM_GF_NO_ELEMENTS ];
+
+/* Explicitly protecting against alignment issues, so hush compiler. */
+#if (__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6) || defined(__clang__)
+#	pragma GCC diagnostic ignored "-Wcast-align"
 #endif
 
 /* Vector GF(2⁸) plus-equals multiplication.
@@ -38,7 +77,7 @@
  * d[] += b • s[]
  */
 
-static
+static inline
 void
 _pgm_gf_vec_addmul (
 	pgm_gf8_t*	 restrict d,
@@ -47,65 +86,34 @@ _pgm_gf_vec_addmul (
 	uint16_t		  len	/* length of vectors */
 	)
 {
-	uint_fast16_t i;
-#ifdef USE_GALOIS_SSE3
-	uint_fast16_t count16;
-#else
-	uint_fast16_t count8;
-#endif
-
 	if (PGM_UNLIKELY(b == 0))
 		return;
 
+	gf_vec_addmul (d, b, s, len);
+}
+
+static
+void
+_pgm_gf_vec_addmul_scalar (
+	pgm_gf8_t*	 restrict d,
+	const pgm_gf8_t		  b,
+	const pgm_gf8_t* restrict s,
+	uint16_t		  len
+	)
+{
+	uint_fast16_t i;
+	uint_fast16_t count8;
+
 #ifdef USE_GALOIS_MUL_LUT
         const pgm_gf8_t* gfmul_b = &pgm_gftable[ (uint16_t)b << 8 ];
 #endif
 
-/* Implementation per the Intel IPP whitepaper
- * The Use of Finite Field GF(256) in the Performance Primitives (2008)
- */
-#ifdef USE_GALOIS_SSE3
-	i = 0;
-	count16 = len >> 4;		/* 16-way unrolls */
-	if (count16)
-	{
-/* generate nibble size lookup table for feeding into SSE3 instruction PSHUFB */
-		struct {
-			pgm_gf8_t hi[PGM_GF_NO_ELEMENTS][16];
-			pgm_gf8_t lo[PGM_GF_NO_ELEMENTS][16];
-		} nibble_gftable;
-		for (int i = 0; i < PGM_GF_NO_ELEMENTS; i++) {
-			for (int j = 0; j < 16; j++) {
-				nibble_gftable.hi[i][j] = pgm_gfmul (i, j << 4);
-				nibble_gftable.lo[i][j] = pgm_gfmul (i, j);
-			}
-		}
-
-/* operate on GF((2^4)^2) */
-		const __m128i hi = _mm_loadu_si128 ((const __m128i*)nibble_gftable.hi[ b ]);
-		const __m128i lo = _mm_loadu_si128 ((const __m128i*)nibble_gftable.lo[ b ]);
-		const __m128i nibble_mask = _mm_set1_epi8 (0x0f);
-		while (count16--) {
-			const __m128i dst = _mm_load_si128 ((__m128i *)(&d[i]));
-			const __m128i src = _mm_load_si128 ((__m128i *)(&s[i]));
-			__m128i tmp = _mm_shuffle_epi8 (lo, _mm_and_si128 (nibble_mask, src));
-			tmp = _mm_xor_si128 (tmp, _mm_shuffle_epi8 (hi, _mm_and_si128 (nibble_mask, _mm_srli_epi64 (src, 4))));
-
-			tmp = _mm_xor_si128 (dst, tmp);
-			_mm_store_si128 ((__m128i *)(&d[i]), tmp);
-			i += 16;
-		}
-
-/* remaining */
-		len %= 16;
-	}
-#else
 	i = 0;
 	count8 = len >> 3;		/* 8-way unrolls */
 	if (count8)
 	{
 		while (count8--) {
-#	ifdef USE_GALOIS_MUL_LUT
+#ifdef USE_GALOIS_MUL_LUT
 			d[i  ] ^= gfmul_b[ s[i  ] ];
 			d[i+1] ^= gfmul_b[ s[i+1] ];
 			d[i+2] ^= gfmul_b[ s[i+2] ];
@@ -114,34 +122,181 @@ _pgm_gf_vec_addmul (
 			d[i+5] ^= gfmul_b[ s[i+5] ];
 			d[i+6] ^= gfmul_b[ s[i+6] ];
 			d[i+7] ^= gfmul_b[ s[i+7] ];
-#	else
-			d[i  ] ^= gfmul( b, s[i  ] );
-			d[i+1] ^= gfmul( b, s[i+1] );
-			d[i+2] ^= gfmul( b, s[i+2] );
-			d[i+3] ^= gfmul( b, s[i+3] );
-			d[i+4] ^= gfmul( b, s[i+4] );
-			d[i+5] ^= gfmul( b, s[i+5] );
-			d[i+6] ^= gfmul( b, s[i+6] );
-			d[i+7] ^= gfmul( b, s[i+7] );
-#	endif
+#else
+			d[i  ] ^= pgm_gfmul( b, s[i  ] );
+			d[i+1] ^= pgm_gfmul( b, s[i+1] );
+			d[i+2] ^= pgm_gfmul( b, s[i+2] );
+			d[i+3] ^= pgm_gfmul( b, s[i+3] );
+			d[i+4] ^= pgm_gfmul( b, s[i+4] );
+			d[i+5] ^= pgm_gfmul( b, s[i+5] );
+			d[i+6] ^= pgm_gfmul( b, s[i+6] );
+			d[i+7] ^= pgm_gfmul( b, s[i+7] );
+#endif
 			i += 8;
 		}
 
 /* remaining */
 		len %= 8;
 	}
-#endif
 
 	while (len--) {
 #ifdef USE_GALOIS_MUL_LUT
 		d[i] ^= gfmul_b[ s[i] ];
 #else
-		d[i] ^= gfmul( b, s[i] );
+		d[i] ^= pgm_gfmul( b, s[i] );
 #endif
 		i++;
 	}
 }
 
+/* Implementation per the Intel IPP whitepaper
+ * The Use of Finite Field GF(256) in the Performance Primitives (2008)
+ *
+ * operate on GF((2^4)^2), each byte is split into nibbles that index
+ * the product tables for b.
+ */
+
+#if defined(__SSSE3__) || defined(_M_AMD64) || defined(_M_X64)
+static
+void
+_pgm_gf_vec_addmul_ssse3 (
+	pgm_gf8_t*	 restrict d,
+	const pgm_gf8_t		  b,
+	const pgm_gf8_t* restrict s,
+	uint16_t		  len
+	)
+{
+	const __m128i lo = _mm_loadu_si128 ((const __m128i*)nibble_gftable[ b ][ 0 ]);
+	const __m128i hi = _mm_loadu_si128 ((const __m128i*)nibble_gftable[ b ][ 1 ]);
+	const __m128i nibble_mask = _mm_set1_epi8 (0x0f);
+	uint_fast16_t i = 0;
+
+	for (; i + 16 <= len; i += 16) {
+		const __m128i src = _mm_loadu_si128 ((const __m128i*)&s[i]);
+		const __m128i dst = _mm_loadu_si128 ((const __m128i*)&d[i]);
+		__m128i tmp = _mm_shuffle_epi8 (lo, _mm_and_si128 (nibble_mask, src));
+		tmp = _mm_xor_si128 (tmp, _mm_shuffle_epi8 (hi, _mm_and_si128 (nibble_mask, _mm_srli_epi64 (src, 4))));
+		_mm_storeu_si128 ((__m128i*)&d[i], _mm_xor_si128 (dst, tmp));
+	}
+
+/* remaining */
+	if (i < len)
+		_pgm_gf_vec_addmul_scalar (&d[i], b, &s[i], len - i);
+}
+#endif
+
+#if defined(__AVX2__) || defined(_M_AMD64) || defined(_M_X64)
+static
+void
+_pgm_gf_vec_addmul_avx2 (
+	pgm_gf8_t*	 restrict d,
+	const pgm_gf8_t		  b,
+	const pgm_gf8_t* restrict s,
+	uint16_t		  len
+	)
+{
+	const __m256i lo = _mm256_broadcastsi128_si256 (_mm_loadu_si128 ((const __m128i*)nibble_gftable[ b ][ 0 ]));
+	const __m256i hi = _mm256_broadcastsi128_si256 (_mm_loadu_si128 ((const __m128i*)nibble_gftable[ b ][ 1 ]));
+	const __m256i nibble_mask = _mm256_set1_epi8 (0x0f);
+	uint_fast16_t i = 0;
+
+	for (; i + 32 <= len; i += 32) {
+		const __m256i src = _mm256_loadu_si256 ((const __m256i*)&s[i]);
+		const __m256i dst = _mm256_loadu_si256 ((const __m256i*)&d[i]);
+		__m256i tmp = _mm256_shuffle_epi8 (lo, _mm256_and_si256 (nibble_mask, src));
+		tmp = _mm256_xor_si256 (tmp, _mm256_shuffle_epi8 (hi, _mm256_and_si256 (nibble_mask, _mm256_srli_epi64 (src, 4))));
+		_mm256_storeu_si256 ((__m256i*)&d[i], _mm256_xor_si256 (dst, tmp));
+	}
+
+/* remaining */
+	if (i < len)
+		_pgm_gf_vec_addmul_scalar (&d[i], b, &s[i], len - i);
+}
+#endif
+
+#if (defined(__GFNI__) && defined(__AVX2__)) || defined(_M_AMD64) || defined(_M_X64)
+static
+void
+_pgm_gf_vec_addmul_gfni (
+	pgm_gf8_t*	 restrict d,
+	const pgm_gf8_t		  b,
+	const pgm_gf8_t* restrict s,
+	uint16_t		  len
+	)
+{
+	const __m256i matrix = _mm256_set1_epi64x ((long long)affine_gftable[ b ]);
+	uint_fast16_t i = 0;
+
+	for (; i + 32 <= len; i += 32) {
+		const __m256i src = _mm256_loadu_si256 ((const __m256i*)&s[i]);
+		const __m256i dst = _mm256_loadu_si256 ((const __m256i*)&d[i]);
+		const __m256i tmp = _mm256_gf2p8affine_epi64_epi8 (src, matrix, 0);
+		_mm256_storeu_si256 ((__m256i*)&d[i], _mm256_xor_si256 (dst, tmp));
+	}
+
+/* remaining */
+	if (i < len)
+		_pgm_gf_vec_addmul_scalar (&d[i], b, &s[i], len - i);
+}
+#endif
+
+/* Build the product tables and select the widest vector kernel the
+ * processor supports, called once from pgm_init().
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_rs_init (
+	const pgm_cpu_t*	cpu
+	)
+{
+	pgm_assert (NULL != cpu);
+
+	for (unsigned b = 0; b < PGM_GF_NO_ELEMENTS; b++)
+	{
+		for (unsigned j = 0; j < 16; j++) {
+			nibble_gftable[ b ][ 0 ][ j ] = pgm_gfmul (b, j);
+			nibble_gftable[ b ][ 1 ][ j ] = pgm_gfmul (b, j << 4);
+		}
+
+/* row i of the matrix is stored in byte 7 - i, column k is the product
+ * with x^k.
+ */
+		uint64_t matrix = 0;
+		for (unsigned k = 0; k < 8; k++) {
+			const pgm_gf8_t column = pgm_gfmul (b, 1 << k);
+			for (unsigned i = 0; i < 8; i++) {
+				if (column & (1 << i))
+					matrix |= UINT64_C(1) << (((7 - i) * 8) + k);
+			}
+		}
+		affine_gftable[ b ] = matrix;
+	}
+
+#if (defined(__GFNI__) && defined(__AVX2__)) || defined(_M_AMD64) || defined(_M_X64)
+	if (cpu->has_gfni && cpu->has_avx2) {
+		pgm_minor (_("Using GFNI instructions for Reed-Solomon."));
+		gf_vec_addmul = _pgm_gf_vec_addmul_gfni;
+		return;
+	}
+#endif
+#if defined(__AVX2__) || defined(_M_AMD64) || defined(_M_X64)
+	if (cpu->has_avx2) {
+		pgm_minor (_("Using AVX2 instructions for Reed-Solomon."));
+		gf_vec_addmul = _pgm_gf_vec_addmul_avx2;
+		return;
+	}
+#endif
+#if defined(__SSSE3__) || defined(_M_AMD64) || defined(_M_X64)
+	if (cpu->has_ssse3) {
+		pgm_minor (_("Using SSSE3 instructions for Reed-Solomon."));
+		gf_vec_addmul = _pgm_gf_vec_addmul_ssse3;
+		return;
+	}
+#endif
+	gf_vec_addmul = _pgm_gf_vec_addmul_scalar;
+}
+
 /* Basic matrix multiplication.
  *
  * C = AB
@@ -523,11 +678,53 @@ pgm_rs_encode (
 	pgm_assert (NULL != dst);
 	pgm_assert (len > 0);
 
-	memset (dst, 0, len);
-	for (uint_fast8_t i = 0; i < rs->k; i++)
+	pgm_gf8_t* row = dst;
+	pgm_rs_encode_rows (rs, src, &offset, &row, 1, len);
+}
+
+/* create several parity packets from one vector of original data packets,
+ * the source packets are walked in stripes small enough that each stripe is
+ * read from memory once for all the requested parity rows.
+ */
+
+#define PGM_RS_STRIPE		256
+
+PGM_GNUC_INTERNAL
+void
+pgm_rs_encode_rows (
+	pgm_rs_t*	  restrict rs,
+	const pgm_gf8_t** restrict src,		/* length rs_t::k */
+	const uint8_t*	  restrict offsets,	/* length count */
+	pgm_gf8_t**	  restrict dst,		/* length count */
+	const uint8_t		   count,
+	const uint16_t		   len
+	)
+{
+	pgm_assert (NULL != rs);
+	pgm_assert (NULL != src);
+	pgm_assert (NULL != offsets);
+	pgm_assert (NULL != dst);
+	pgm_assert (count > 0);
+	pgm_assert (len > 0);
+
+	for (uint_fast8_t j = 0; j < count; j++)
 	{
-		const pgm_gf8_t c = rs->GM[ (offset * rs->k) + i ];
-		_pgm_gf_vec_addmul (dst, c, src[i], len);
+		pgm_assert (offsets[j] >= rs->k && offsets[j] < rs->n);	/* parity packet */
+		pgm_assert (NULL != dst[j]);
+		memset (dst[j], 0, len);
+	}
+
+	for (uint_fast16_t pos = 0; pos < len; pos += PGM_RS_STRIPE)
+	{
+		const uint16_t stripe = MIN(PGM_RS_STRIPE, len - pos);
+		for (uint_fast8_t i = 0; i < rs->k; i++)
+		{
+			for (uint_fast8_t j = 0; j < count; j++)
+			{
+				const pgm_gf8_t c = rs->GM[ (offsets[j] * rs->k) + i ];
+				_pgm_gf_vec_addmul (dst[j] + pos, c, src[i] + pos, stripe);
+			}
+		}
 	}
 }
 
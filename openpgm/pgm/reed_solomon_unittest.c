@@ -56,6 +56,60 @@ pgm_get_nprocs (void)
 	return 1;
 }
 
+/* target:
+ *	void
+ *	pgm_rs_init (
+ *		const pgm_cpu_t*	cpu
+ *	)
+ */
+
+/* every vector kernel matches the scalar kernel, including unaligned tails */
+START_TEST (test_init_pass_001)
+{
+	const guint16 len = 1403;
+	pgm_cpu_t cpu;
+	memset (&cpu, 0, sizeof (cpu));
+	pgm_rs_init (&cpu);
+	fail_unless (_pgm_gf_vec_addmul_scalar == gf_vec_addmul, "init failed");
+	pgm_gf8_t* src = g_malloc (len + 1);
+	pgm_gf8_t* expected = g_malloc (len + 1);
+	pgm_gf8_t* result = g_malloc (len + 1);
+	for (unsigned i = 0; i < len + 1; i++)
+		src[i] = (pgm_gf8_t)rand();
+	const pgm_gf_vec_addmul_func kernels[] = {
+#if defined(__SSSE3__) || defined(_M_AMD64) || defined(_M_X64)
+		_pgm_gf_vec_addmul_ssse3,
+#endif
+#if defined(__AVX2__) || defined(_M_AMD64) || defined(_M_X64)
+		_pgm_gf_vec_addmul_avx2,
+#endif
+#if (defined(__GFNI__) && defined(__AVX2__)) || defined(_M_AMD64) || defined(_M_X64)
+		_pgm_gf_vec_addmul_gfni,
+#endif
+		_pgm_gf_vec_addmul_scalar
+	};
+	for (unsigned k = 0; k < G_N_ELEMENTS(kernels); k++) {
+		for (unsigned b = 1; b < PGM_GF_NO_ELEMENTS; b++) {
+			memset (expected, 0x5a, len + 1);
+			memset (result, 0x5a, len + 1);
+			_pgm_gf_vec_addmul_scalar (expected, b, src + 1, len);
+			kernels[k] (result, b, src + 1, len);
+			fail_unless (0 == memcmp (expected, result, len + 1), "kernel %u mismatch on %u", k, b);
+		}
+	}
+	g_free (src);
+	g_free (expected);
+	g_free (result);
+}
+END_TEST
+
+START_TEST (test_init_fail_001)
+{
+	pgm_rs_init (NULL);
+	fail ("reached");
+}
+END_TEST
+
 /* target:
  *	void
  *	pgm_rs_create (
@@ -141,6 +195,54 @@ START_TEST (test_encode_fail_001)
 }
 END_TEST
 
+/* target:
+ *	void
+ *	pgm_rs_encode_rows (
+ *		pgm_rs_t*		rs,
+ *		const pgm_gf8_t**	src,
+ *		const uint8_t*		offsets,
+ *		pgm_gf8_t**		dst,
+ *		const uint8_t		count,
+ *		const uint16_t		len
+ *	)
+ */
+
+/* all rows in one pass match individually encoded rows */
+START_TEST (test_encode_rows_pass_001)
+{
+	pgm_rs_t rs;
+	const guint8 k = 8, h = 4;
+	const guint16 packet_len = 1400;
+	pgm_gf8_t* source_packets[k];
+	pgm_gf8_t* parity_packets[h];
+	guint8 offsets[h];
+	pgm_gf8_t* parity_packet = g_malloc0 (packet_len);
+	pgm_rs_create (&rs, 255, k);
+	for (unsigned i = 0; i < k; i++) {
+		source_packets[i] = g_malloc (packet_len);
+		for (unsigned j = 0; j < packet_len; j++)
+			source_packets[i][j] = (pgm_gf8_t)rand();
+	}
+	for (unsigned i = 0; i < h; i++) {
+		parity_packets[i] = g_malloc (packet_len);
+		offsets[i] = k + i;
+	}
+	pgm_rs_encode_rows (&rs, (const pgm_gf8_t**)source_packets, offsets, parity_packets, h, packet_len);
+	for (unsigned i = 0; i < h; i++) {
+		pgm_rs_encode (&rs, (const pgm_gf8_t**)source_packets, k + i, parity_packet, packet_len);
+		fail_unless (0 == memcmp (parity_packet, parity_packets[i], packet_len), "encode_rows failed");
+	}
+	pgm_rs_destroy (&rs);
+}
+END_TEST
+
+START_TEST (test_encode_rows_fail_001)
+{
+	pgm_rs_encode_rows (NULL, NULL, NULL, NULL, 0, 0);
+	fail ("reached");
+}
+END_TEST
+
 /* target:
  *	void
  *	pgm_rs_decode_parity_inline (
@@ -265,6 +367,13 @@ make_test_suite (void)
 
 	s = suite_create (__FILE__);
 
+	TCase* tc_init = tcase_create ("init");
+	suite_add_tcase (s, tc_init);
+	tcase_add_test (tc_init, test_init_pass_001);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_init, test_init_fail_001, SIGABRT);
+#endif
+
 	TCase* tc_create = tcase_create ("create");
 	suite_add_tcase (s, tc_create);
 	tcase_add_test (tc_create, test_create_pass_001);
@@ -286,6 +395,13 @@ make_test_suite (void)
 	tcase_add_test_raise_signal (tc_encode, test_encode_fail_001, SIGABRT);
 #endif
 
+	TCase* tc_encode_rows = tcase_create ("encode-rows");
+	suite_add_tcase (s, tc_encode_rows);
+	tcase_add_test (tc_encode_rows, test_encode_rows_pass_001);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_encode_rows, test_encode_rows_fail_001, SIGABRT);
+#endif
+
 	TCase* tc_decode_parity_inline = tcase_create ("decode-parity-inline");
 	suite_add_tcase (s, tc_decode_parity_inline);
 	tcase_add_test (tc_decode_parity_inline, test_decode_parity_inline_pass_001);
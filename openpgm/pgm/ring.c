@@ -0,0 +1,183 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * Bounded single-producer single-consumer ring of received APDUs.
+ *
+ * Copyright (c) 2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+#include <impl/framework.h>
+
+
+//#define RING_DEBUG
+
+#ifndef RING_DEBUG
+#	define PGM_DISABLE_ASSERT
+#endif
+
+
+/* create a ring of capacity slots, capacity must be a power of two.
+ */
+
+pgm_ring_t*
+pgm_ring_create (
+	const uint32_t		capacity
+	)
+{
+	pgm_ring_t* ring;
+
+/* pre-conditions */
+	pgm_assert_cmpuint (capacity, >, 0);
+	pgm_assert_cmpuint (capacity & (capacity - 1), ==, 0);
+
+	pgm_debug ("pgm_ring_create (capacity:%" PRIu32 ")", capacity);
+
+	ring = pgm_new0 (pgm_ring_t, 1);
+	ring->mask = capacity - 1;
+	ring->msgv = pgm_new0 (struct pgm_msgv_t, capacity);
+	pgm_atomic_write32 (&ring->head, 0);
+	pgm_atomic_write32 (&ring->tail, 0);
+	pgm_atomic_write32 (&ring->is_full, 0);
+	return ring;
+}
+
+/* destroy ring, buffer references held by unread or unreleased slots are dropped.
+ */
+
+void
+pgm_ring_destroy (
+	pgm_ring_t*const	ring
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != ring);
+
+	pgm_debug ("pgm_ring_destroy (ring:%p)", (const void*)ring);
+
+	for (uint32_t i = ring->tail; i != ring->head; i++)
+	{
+		struct pgm_msgv_t* msgv = &ring->msgv[ i & ring->mask ];
+		if (0 == msgv->msgv_len)
+			pgm_free_skb (msgv->msgv_skb[0]);
+		for (uint32_t j = 0; j < msgv->msgv_len; j++)
+			pgm_free_skb (msgv->msgv_skb[j]);
+	}
+	pgm_free (ring->msgv);
+	pgm_free (ring);
+}
+
+/* producer: returns the first free slot and saves the count of contiguous free slots
+ * into count.  On a full ring returns NULL and flags the consumer to signal on the
+ * next release.
+ */
+
+struct pgm_msgv_t*
+pgm_ring_reserve (
+	pgm_ring_t*const restrict ring,
+	uint32_t*   const restrict count
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != ring);
+	pgm_assert (NULL != count);
+
+	const uint32_t capacity = ring->mask + 1;
+	const uint32_t head = ring->head;
+	uint32_t used = head - pgm_atomic_exchange_and_add32 (&ring->tail, 0);
+	if (PGM_UNLIKELY(capacity == used))
+	{
+/* set flag before the re-read so that a concurrent release cannot be missed */
+		pgm_atomic_compare_and_exchange32 (&ring->is_full, 1, 0);
+		used = head - pgm_atomic_exchange_and_add32 (&ring->tail, 0);
+		if (capacity == used) {
+			*count = 0;
+			return NULL;
+		}
+	}
+	const uint32_t index_ = head & ring->mask;
+	*count = MIN(capacity - used, capacity - index_);
+	return &ring->msgv[ index_ ];
+}
+
+/* producer: publish count filled slots.
+ *
+ * returns TRUE if the consumer may have observed an empty ring and requires a wakeup.
+ */
+
+bool
+pgm_ring_commit (
+	pgm_ring_t*const	ring,
+	const uint32_t		count
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != ring);
+	pgm_assert_cmpuint (count, <=, ring->mask + 1);
+
+	const uint32_t head = ring->head;
+	pgm_atomic_add32 (&ring->head, count);
+	return (head == pgm_atomic_exchange_and_add32 (&ring->tail, 0));
+}
+
+/* consumer: returns the first unread slot and saves the count of contiguous unread
+ * slots into count, or NULL on an empty ring.
+ */
+
+struct pgm_msgv_t*
+pgm_ring_peek (
+	pgm_ring_t*const restrict ring,
+	uint32_t*   const restrict count
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != ring);
+	pgm_assert (NULL != count);
+
+	const uint32_t capacity = ring->mask + 1;
+	const uint32_t tail = ring->tail;
+	const uint32_t used = pgm_atomic_exchange_and_add32 (&ring->head, 0) - tail;
+	if (0 == used) {
+		*count = 0;
+		return NULL;
+	}
+	const uint32_t index_ = tail & ring->mask;
+	*count = MIN(used, capacity - index_);
+	return &ring->msgv[ index_ ];
+}
+
+/* consumer: return count read slots to the producer.
+ *
+ * returns TRUE if the producer is waiting for space and requires a wakeup.
+ */
+
+bool
+pgm_ring_release (
+	pgm_ring_t*const	ring,
+	const uint32_t		count
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != ring);
+	pgm_assert_cmpuint (count, <=, ring->head - ring->tail);
+
+	pgm_atomic_add32 (&ring->tail, count);
+	return pgm_atomic_compare_and_exchange32 (&ring->is_full, 0, 1);
+}
+
+/* eof */
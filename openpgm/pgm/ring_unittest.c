@@ -0,0 +1,358 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * unit tests for the network thread to application ring.
+ *
+ * Copyright (c) 2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include <signal.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#	include <pthread.h>
+#endif
+#include <glib.h>
+#include <check.h>
+
+#ifdef _WIN32
+#	define PGM_CHECK_NOFORK		1
+#endif
+
+
+/* mock state */
+
+/* mock functions for external references */
+
+#define RING_DEBUG
+#include "ring.c"
+
+PGM_GNUC_INTERNAL
+int
+pgm_get_nprocs (void)
+{
+	return 1;
+}
+
+
+/* target:
+ *	pgm_ring_t*
+ *	pgm_ring_create (
+ *		const uint32_t		capacity
+ *	)
+ */
+
+START_TEST (test_create_pass_001)
+{
+	pgm_ring_t* ring = pgm_ring_create (4);
+	fail_if (NULL == ring, "create failed");
+	fail_unless (3 == ring->mask, "create failed");
+	pgm_ring_destroy (ring);
+}
+END_TEST
+
+/* not a power of two */
+START_TEST (test_create_fail_001)
+{
+	pgm_ring_t* ring = pgm_ring_create (3);
+	fail ("reached");
+}
+END_TEST
+
+/* target:
+ *	void
+ *	pgm_ring_destroy (
+ *		pgm_ring_t*		ring
+ *	)
+ */
+
+/* unread buffers are released */
+START_TEST (test_destroy_pass_001)
+{
+	pgm_ring_t* ring = pgm_ring_create (4);
+	struct pgm_sk_buff_t* skb = pgm_alloc_skb (1500);
+	struct pgm_sk_buff_t* error_skb = pgm_alloc_skb (0);
+	uint32_t count;
+	struct pgm_msgv_t* msgv = pgm_ring_reserve (ring, &count);
+	pgm_skb_get (skb);
+	msgv[0].msgv_len = 1;
+	msgv[0].msgv_skb[0] = skb;
+	msgv[1].msgv_len = 0;
+	msgv[1].msgv_skb[0] = error_skb;
+	pgm_ring_commit (ring, 2);
+	pgm_ring_destroy (ring);
+	fail_unless (1 == pgm_atomic_read32 (&skb->users), "destroy failed");
+	pgm_free_skb (skb);
+}
+END_TEST
+
+/* target:
+ *	struct pgm_msgv_t*
+ *	pgm_ring_reserve (
+ *		pgm_ring_t*		ring,
+ *		uint32_t*		count
+ *	)
+ */
+
+/* contiguous span stops at the wrap */
+START_TEST (test_reserve_pass_001)
+{
+	pgm_ring_t* ring = pgm_ring_create (4);
+	uint32_t count;
+	struct pgm_msgv_t* msgv = pgm_ring_reserve (ring, &count);
+	fail_unless (&ring->msgv[0] == msgv, "reserve failed");
+	fail_unless (4 == count, "reserve failed");
+	pgm_ring_commit (ring, 3);
+	pgm_ring_peek (ring, &count);
+	pgm_ring_release (ring, 2);
+	msgv = pgm_ring_reserve (ring, &count);
+	fail_unless (&ring->msgv[3] == msgv, "reserve failed");
+	fail_unless (1 == count, "reserve failed");
+	pgm_ring_commit (ring, 1);
+	msgv = pgm_ring_reserve (ring, &count);
+	fail_unless (&ring->msgv[0] == msgv, "reserve failed");
+	fail_unless (2 == count, "reserve failed");
+	pgm_free (ring->msgv);
+	pgm_free (ring);
+}
+END_TEST
+
+/* full ring flags the consumer to wake the producer */
+START_TEST (test_reserve_pass_002)
+{
+	pgm_ring_t* ring = pgm_ring_create (2);
+	uint32_t count;
+	pgm_ring_reserve (ring, &count);
+	pgm_ring_commit (ring, 2);
+	fail_unless (NULL == pgm_ring_reserve (ring, &count), "reserve failed");
+	fail_unless (0 == count, "reserve failed");
+	fail_unless (1 == pgm_atomic_read32 (&ring->is_full), "reserve failed");
+	pgm_ring_peek (ring, &count);
+	fail_unless (TRUE == pgm_ring_release (ring, 1), "release failed");
+	fail_unless (0 == pgm_atomic_read32 (&ring->is_full), "release failed");
+	fail_unless (FALSE == pgm_ring_release (ring, 1), "release failed");
+	pgm_free (ring->msgv);
+	pgm_free (ring);
+}
+END_TEST
+
+START_TEST (test_reserve_fail_001)
+{
+	uint32_t count;
+	pgm_ring_reserve (NULL, &count);
+	fail ("reached");
+}
+END_TEST
+
+/* target:
+ *	bool
+ *	pgm_ring_commit (
+ *		pgm_ring_t*		ring,
+ *		const uint32_t		count
+ *	)
+ */
+
+/* wakeup only required on publishing to an empty ring */
+START_TEST (test_commit_pass_001)
+{
+	pgm_ring_t* ring = pgm_ring_create (4);
+	uint32_t count;
+	pgm_ring_reserve (ring, &count);
+	fail_unless (TRUE == pgm_ring_commit (ring, 1), "commit failed");
+	pgm_ring_reserve (ring, &count);
+	fail_unless (FALSE == pgm_ring_commit (ring, 1), "commit failed");
+	pgm_ring_peek (ring, &count);
+	pgm_ring_release (ring, 2);
+	pgm_ring_reserve (ring, &count);
+	fail_unless (TRUE == pgm_ring_commit (ring, 1), "commit failed");
+	pgm_free (ring->msgv);
+	pgm_free (ring);
+}
+END_TEST
+
+/* target:
+ *	struct pgm_msgv_t*
+ *	pgm_ring_peek (
+ *		pgm_ring_t*		ring,
+ *		uint32_t*		count
+ *	)
+ */
+
+START_TEST (test_peek_pass_001)
+{
+	pgm_ring_t* ring = pgm_ring_create (4);
+	uint32_t count;
+	fail_unless (NULL == pgm_ring_peek (ring, &count), "peek failed");
+	fail_unless (0 == count, "peek failed");
+	struct pgm_msgv_t* msgv = pgm_ring_reserve (ring, &count);
+	msgv[0].msgv_len = 1;
+	msgv[1].msgv_len = 2;
+	pgm_ring_commit (ring, 2);
+	msgv = pgm_ring_peek (ring, &count);
+	fail_unless (&ring->msgv[0] == msgv, "peek failed");
+	fail_unless (2 == count, "peek failed");
+	fail_unless (1 == msgv[0].msgv_len, "peek failed");
+	fail_unless (2 == msgv[1].msgv_len, "peek failed");
+	pgm_free (ring->msgv);
+	pgm_free (ring);
+}
+END_TEST
+
+START_TEST (test_peek_fail_001)
+{
+	uint32_t count;
+	pgm_ring_peek (NULL, &count);
+	fail ("reached");
+}
+END_TEST
+
+/* target:
+ *	bool
+ *	pgm_ring_release (
+ *		pgm_ring_t*		ring,
+ *		const uint32_t		count
+ *	)
+ */
+
+#ifndef _WIN32
+#define RING_TEST_ITERATIONS	100000
+
+static
+void*
+producer_routine (
+	void*		arg
+	)
+{
+	pgm_ring_t* ring = arg;
+	uint32_t sequence = 0;
+	while (sequence < RING_TEST_ITERATIONS) {
+		uint32_t count;
+		struct pgm_msgv_t* msgv = pgm_ring_reserve (ring, &count);
+		if (NULL == msgv)
+			continue;
+		count = MIN(count, RING_TEST_ITERATIONS - sequence);
+		for (uint32_t i = 0; i < count; i++)
+			msgv[i].msgv_len = ++sequence;
+		pgm_ring_commit (ring, count);
+	}
+	return NULL;
+}
+
+/* slots arrive in order across threads */
+START_TEST (test_release_pass_001)
+{
+	pgm_ring_t* ring = pgm_ring_create (64);
+	pthread_t producer;
+	uint32_t expected = 0;
+	fail_unless (0 == pthread_create (&producer, NULL, &producer_routine, ring), "create thread failed");
+	while (expected < RING_TEST_ITERATIONS) {
+		uint32_t count;
+		struct pgm_msgv_t* msgv = pgm_ring_peek (ring, &count);
+		if (NULL == msgv)
+			continue;
+		for (uint32_t i = 0; i < count; i++)
+			fail_unless (++expected == msgv[i].msgv_len, "release failed");
+		pgm_ring_release (ring, count);
+	}
+	pthread_join (producer, NULL);
+	fail_unless (ring->head == ring->tail, "release failed");
+	pgm_free (ring->msgv);
+	pgm_free (ring);
+}
+END_TEST
+#endif /* !_WIN32 */
+
+START_TEST (test_release_fail_001)
+{
+	pgm_ring_release (NULL, 1);
+	fail ("reached");
+}
+END_TEST
+
+
+static
+Suite*
+make_test_suite (void)
+{
+	Suite* s;
+
+	s = suite_create (__FILE__);
+
+	TCase* tc_create = tcase_create ("create");
+	suite_add_tcase (s, tc_create);
+	tcase_add_test (tc_create, test_create_pass_001);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_create, test_create_fail_001, SIGABRT);
+#endif
+
+	TCase* tc_destroy = tcase_create ("destroy");
+	suite_add_tcase (s, tc_destroy);
+	tcase_add_test (tc_destroy, test_destroy_pass_001);
+
+	TCase* tc_reserve = tcase_create ("reserve");
+	suite_add_tcase (s, tc_reserve);
+	tcase_add_test (tc_reserve, test_reserve_pass_001);
+	tcase_add_test (tc_reserve, test_reserve_pass_002);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_reserve, test_reserve_fail_001, SIGABRT);
+#endif
+
+	TCase* tc_commit = tcase_create ("commit");
+	suite_add_tcase (s, tc_commit);
+	tcase_add_test (tc_commit, test_commit_pass_001);
+
+	TCase* tc_peek = tcase_create ("peek");
+	suite_add_tcase (s, tc_peek);
+	tcase_add_test (tc_peek, test_peek_pass_001);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_peek, test_peek_fail_001, SIGABRT);
+#endif
+
+	TCase* tc_release = tcase_create ("release");
+	suite_add_tcase (s, tc_release);
+#ifndef _WIN32
+	tcase_add_test (tc_release, test_release_pass_001);
+#endif
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_release, test_release_fail_001, SIGABRT);
+#endif
+	return s;
+}
+
+static
+Suite*
+make_master_suite (void)
+{
+	Suite* s = suite_create ("Master");
+	return s;
+}
+
+int
+main (void)
+{
+	pgm_messages_init();
+	SRunner* sr = srunner_create (make_master_suite ());
+	srunner_add_suite (sr, make_test_suite ());
+	srunner_run_all (sr, CK_ENV);
+	int number_failed = srunner_ntests_failed (sr);
+	srunner_free (sr);
+	pgm_messages_shutdown();
+	return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* eof */
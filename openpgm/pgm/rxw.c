@@ -56,9 +56,6 @@ _pgm_tsi_is_null (
 	return (0 == u->l[0] && 0 == u->l[1]);
 }
 
-/* sequence state must be smaller than PGM skbuff control buffer */
-PGM_STATIC_ASSERT(sizeof(struct pgm_rxw_state_t) <= sizeof(((struct pgm_sk_buff_t*)0)->cb));
-
 static void _pgm_rxw_define (pgm_rxw_t*const, const uint32_t);
 static void _pgm_rxw_update_trail (pgm_rxw_t*const, const uint32_t);
 static inline uint32_t _pgm_rxw_update_lead (pgm_rxw_t*const, const uint32_t, const pgm_time_t, const pgm_time_t);
@@ -69,10 +66,10 @@ static inline bool _pgm_rxw_is_last_of_tg_sqn (pgm_rxw_t*const, const uint32_t);
 static int _pgm_rxw_insert (pgm_rxw_t*const restrict, struct pgm_sk_buff_t*const restrict);
 static int _pgm_rxw_append (pgm_rxw_t*const restrict, struct pgm_sk_buff_t*const restrict, const pgm_time_t);
 static int _pgm_rxw_add_placeholder_range (pgm_rxw_t*const, const uint32_t, const pgm_time_t, const pgm_time_t);
-static void _pgm_rxw_unlink (pgm_rxw_t*const restrict, struct pgm_sk_buff_t*const restrict);
+static void _pgm_rxw_unlink (pgm_rxw_t*const, const uint32_t);
 static uint32_t _pgm_rxw_remove_trail (pgm_rxw_t*const);
-static void _pgm_rxw_state (pgm_rxw_t*const restrict, struct pgm_sk_buff_t*const restrict, const int);
-static inline void _pgm_rxw_shuffle_parity (pgm_rxw_t*const restrict, struct pgm_sk_buff_t*const restrict);
+static void _pgm_rxw_state (pgm_rxw_t*const, const uint32_t, const int);
+static inline void _pgm_rxw_shuffle_parity (pgm_rxw_t*const, const uint32_t);
 static inline ssize_t _pgm_rxw_incoming_read (pgm_rxw_t*const restrict, struct pgm_msgv_t**restrict, uint32_t);
 static bool _pgm_rxw_is_apdu_complete (pgm_rxw_t*const, const uint32_t);
 static inline ssize_t _pgm_rxw_incoming_read_apdu (pgm_rxw_t*const restrict, struct pgm_msgv_t**restrict);
@@ -80,7 +77,49 @@ static inline int _pgm_rxw_recovery_update (pgm_rxw_t*const, const uint32_t, con
 static inline int _pgm_rxw_recovery_append (pgm_rxw_t*const, const pgm_time_t, const pgm_time_t);
 
 
-/* returns the pointer at the given index of the window.
+/* count trailing zero bits, undefined for zero.
+ */
+
+static inline
+unsigned
+_pgm_rxw_ctz (
+	uint32_t		n
+	)
+{
+#if (__GNUC__ > 3) || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4)
+	return __builtin_ctz (n);
+#elif defined(_MSC_VER)
+	unsigned long r;
+	_BitScanForward (&r, n);
+	return (unsigned)r;
+#else
+	unsigned r = 0;
+	while (0 == (n & 1)) {
+		n >>= 1;
+		r++;
+	}
+	return r;
+#endif
+}
+
+/* returns TRUE if sequence is between the trail and lead of the window.
+ */
+
+static inline
+bool
+_pgm_rxw_contains (
+	const pgm_rxw_t* const	window,
+	const uint32_t		sequence
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != window);
+
+	return pgm_uint32_gte (sequence, window->trail) && pgm_uint32_lte (sequence, window->lead);
+}
+
+/* returns the pointer at the given index of the window, placeholders
+ * return NULL.
  */
 
 static
@@ -98,8 +137,7 @@ _pgm_rxw_peek (
 
 	if (pgm_uint32_gte (sequence, window->trail) && pgm_uint32_lte (sequence, window->lead))
 	{
-		const uint_fast32_t index_ = sequence % pgm_rxw_max_length (window);
-		struct pgm_sk_buff_t* skb = window->pdata[index_];
+		struct pgm_sk_buff_t* skb = window->pdata[ pgm_rxw_index (window, sequence) ];
 /* availability only guaranteed inside commit window */
 		if (pgm_uint32_lt (sequence, window->commit_lead)) {
 			pgm_assert (NULL != skb);
@@ -112,6 +150,79 @@ _pgm_rxw_peek (
 	return NULL;
 }
 
+/* as _pgm_rxw_peek but parity packets held in place of data also return NULL.
+ */
+
+static inline
+struct pgm_sk_buff_t*
+_pgm_rxw_peek_data (
+	const pgm_rxw_t* const	window,
+	const uint32_t		sequence
+	)
+{
+	struct pgm_sk_buff_t* skb = _pgm_rxw_peek (window, sequence);
+	if (NULL != skb &&
+	    PGM_PKT_STATE_HAVE_PARITY == window->pkt_state[ pgm_rxw_index (window, sequence) ])
+		return NULL;
+	return skb;
+}
+
+/* reset sequence state of a vacated slot.
+ */
+
+static inline
+void
+_pgm_rxw_clear_state (
+	pgm_rxw_t* const	window,
+	const uint_fast32_t	index_
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != window);
+	pgm_assert_cmpuint (index_, <=, window->mask);
+
+	window->timer_expiry[index_]		= 0;
+	window->pkt_state[index_]		= PGM_PKT_STATE_ERROR;
+	window->nak_transmit_count[index_]	= 0;
+	window->ncf_retry_count[index_]		= 0;
+	window->data_retry_count[index_]	= 0;
+	window->is_contiguous[index_]		= 0;
+	window->tstamp[index_]			= 0;
+}
+
+/* exchange sequence state between two slots, neither may be linked to a
+ * state queue.
+ */
+
+static inline
+void
+_pgm_rxw_swap_state (
+	pgm_rxw_t* const	window,
+	const uint_fast32_t	a,
+	const uint_fast32_t	b
+	)
+{
+	pgm_time_t timer_expiry, tstamp;
+	uint8_t t;
+
+/* pre-conditions */
+	pgm_assert (NULL != window);
+	pgm_assert_cmpuint (a, <=, window->mask);
+	pgm_assert_cmpuint (b, <=, window->mask);
+
+	timer_expiry = window->timer_expiry[a];
+	window->timer_expiry[a] = window->timer_expiry[b];
+	window->timer_expiry[b] = timer_expiry;
+	tstamp = window->tstamp[a];
+	window->tstamp[a] = window->tstamp[b];
+	window->tstamp[b] = tstamp;
+	t = window->pkt_state[a];		window->pkt_state[a] = window->pkt_state[b];			window->pkt_state[b] = t;
+	t = window->nak_transmit_count[a];	window->nak_transmit_count[a] = window->nak_transmit_count[b];	window->nak_transmit_count[b] = t;
+	t = window->ncf_retry_count[a];		window->ncf_retry_count[a] = window->ncf_retry_count[b];	window->ncf_retry_count[b] = t;
+	t = window->data_retry_count[a];	window->data_retry_count[a] = window->data_retry_count[b];	window->data_retry_count[b] = t;
+	t = window->is_contiguous[a];		window->is_contiguous[a] = window->is_contiguous[b];		window->is_contiguous[b] = t;
+}
+
 /* sections of the receive window:
  * 
  *  |     Commit       |   Incoming   |
@@ -165,6 +276,104 @@ _pgm_rxw_incoming_is_empty (
 	return (_pgm_rxw_incoming_length (window) == 0);
 }
 
+/* move the slot arrays to a new power of 2 length which must hold every
+ * sequence from trail to lead.  only occupied slots are copied, WAIT-NCF and
+ * WAIT-DATA queues are relinked oldest first to keep their order.
+ */
+
+static
+void
+_pgm_rxw_resize (
+	pgm_rxw_t* const	window,
+	const unsigned		slots
+	)
+{
+	pgm_queue_t wait_ncf_queue = { NULL, NULL, 0 };
+	pgm_queue_t wait_data_queue = { NULL, NULL, 0 };
+
+/* pre-conditions */
+	pgm_assert (NULL != window);
+	pgm_assert_cmpuint (slots, >, 0);
+	pgm_assert_cmpuint (slots & (slots - 1), ==, 0);
+	pgm_assert_cmpuint (pgm_rxw_length (window), <=, slots);
+
+	pgm_debug ("resize (window:%p slots:%u)", (const void*)window, slots);
+
+/* one allocation with the 64-bit timers leading for alignment */
+	const uint32_t mask		= slots - 1;
+	const unsigned bitmap_words	= (slots + 31) / 32;
+	pgm_time_t* timer_expiry	= pgm_malloc0 (slots * PGM_RXW_SLOT_SIZE + bitmap_words * sizeof(uint32_t));
+	pgm_time_t* tstamp		= timer_expiry + slots;
+	struct pgm_sk_buff_t** pdata	= (struct pgm_sk_buff_t**)( tstamp + slots );
+	pgm_list_t* link		= (pgm_list_t*)( pdata + slots );
+	uint32_t* backoff_bitmap	= (uint32_t*)( link + slots );
+	uint8_t* pkt_state		= (uint8_t*)( backoff_bitmap + bitmap_words );
+	uint8_t* nak_transmit_count	= pkt_state + slots;
+	uint8_t* ncf_retry_count	= nak_transmit_count + slots;
+	uint8_t* data_retry_count	= ncf_retry_count + slots;
+	uint8_t* is_contiguous		= data_retry_count + slots;
+
+	if (NULL != window->timer_expiry)
+	{
+		const uint32_t length = pgm_rxw_length (window);
+		for (uint32_t i = 0; i < length; i++)
+		{
+			const uint32_t sequence		= window->trail + i;
+			const uint_fast32_t from	= pgm_rxw_index (window, sequence);
+			const uint_fast32_t to		= sequence & mask;
+			timer_expiry[to]		= window->timer_expiry[from];
+			tstamp[to]			= window->tstamp[from];
+			pdata[to]			= window->pdata[from];
+			pkt_state[to]			= window->pkt_state[from];
+			nak_transmit_count[to]		= window->nak_transmit_count[from];
+			ncf_retry_count[to]		= window->ncf_retry_count[from];
+			data_retry_count[to]		= window->data_retry_count[from];
+			is_contiguous[to]		= window->is_contiguous[from];
+			if (window->backoff_bitmap[ from >> 5 ] & ((uint32_t)1 << (from & 31)))
+				backoff_bitmap[ to >> 5 ] |= (uint32_t)1 << (to & 31);
+		}
+		for (const pgm_list_t* old = window->wait_ncf_queue.tail; NULL != old; old = old->prev)
+			pgm_queue_push_head_link (&wait_ncf_queue, &link[ pgm_rxw_link_sequence (window, old) & mask ]);
+		for (const pgm_list_t* old = window->wait_data_queue.tail; NULL != old; old = old->prev)
+			pgm_queue_push_head_link (&wait_data_queue, &link[ pgm_rxw_link_sequence (window, old) & mask ]);
+		pgm_assert_cmpuint (wait_ncf_queue.length, ==, window->wait_ncf_queue.length);
+		pgm_assert_cmpuint (wait_data_queue.length, ==, window->wait_data_queue.length);
+		pgm_free (window->timer_expiry);
+	}
+
+	window->mask			= mask;
+	window->timer_expiry		= timer_expiry;
+	window->tstamp			= tstamp;
+	window->pdata			= pdata;
+	window->link			= link;
+	window->backoff_bitmap		= backoff_bitmap;
+	window->pkt_state		= pkt_state;
+	window->nak_transmit_count	= nak_transmit_count;
+	window->ncf_retry_count		= ncf_retry_count;
+	window->data_retry_count	= data_retry_count;
+	window->is_contiguous		= is_contiguous;
+	window->wait_ncf_queue		= wait_ncf_queue;
+	window->wait_data_queue		= wait_data_queue;
+}
+
+/* double the slot arrays if the next lead would overwrite the trail.
+ */
+
+static inline
+void
+_pgm_rxw_reserve_lead (
+	pgm_rxw_t* const	window
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != window);
+	pgm_assert (!pgm_rxw_is_full (window));
+
+	if (PGM_LIKELY(pgm_rxw_length (window) <= window->mask))
+		return;
+	_pgm_rxw_resize (window, (window->mask + 1) << 1);
+}
+
 /* constructor for receive window.  zero-length windows are not permitted.
  *
  * returns pointer to window.
@@ -202,7 +411,8 @@ pgm_rxw_create (
 /* calculate receive window parameters */
 	pgm_assert (sqns || (secs && max_rte));
 	const unsigned alloc_sqns = sqns ? sqns : (unsigned)( (secs * max_rte) / tpdu_size );
-	window = pgm_malloc0 (sizeof(pgm_rxw_t) + ( alloc_sqns * sizeof(struct pgm_sk_buff_t*) ));
+/* slot arrays are allocated on demand */
+	window = pgm_malloc0 (sizeof(pgm_rxw_t));
 
 	window->tsi		= tsi;
 	window->max_tpdu	= tpdu_size;
@@ -225,8 +435,9 @@ pgm_rxw_create (
 	window->ack_c_p = pgm_fp16 (ack_c_p);
 	window->bitmap = 0xffffffff;
 
-/* pointer array */
+/* window limit, slot arrays start small and grow with occupancy */
 	window->alloc = alloc_sqns;
+	_pgm_rxw_resize (window, MIN(PGM_RXW_MIN_SLOTS, (unsigned)pgm_nearest_power (1, alloc_sqns)));
 
 /* post-conditions */
 	pgm_assert_cmpuint (pgm_rxw_max_length (window), ==, alloc_sqns);
@@ -265,6 +476,7 @@ pgm_rxw_destroy (
 	pgm_assert (!pgm_rxw_is_full (window));
 
 /* window */
+	pgm_free (window->timer_expiry);
 	pgm_free (window);
 }
 
@@ -302,7 +514,6 @@ pgm_rxw_add (
 	const pgm_time_t		     nak_rb_expiry	/* calculated expiry time for this skb */
 	)
 {
-	pgm_rxw_state_t* const state = (pgm_rxw_state_t*)&skb->cb;
 	int status;
 
 /* pre-conditions */
@@ -371,20 +582,26 @@ pgm_rxw_add (
 			return _pgm_rxw_insert (window, skb);
 		}
 
-		const struct pgm_sk_buff_t* const first_skb = _pgm_rxw_peek (window, _pgm_rxw_tg_sqn (window, skb->sequence));
-		const pgm_rxw_state_t* const first_state = (pgm_rxw_state_t*)&first_skb->cb;
+		const uint32_t tg_sqn = _pgm_rxw_tg_sqn (window, skb->sequence);
 
-		if (_pgm_rxw_tg_sqn (window, skb->sequence) == _pgm_rxw_tg_sqn (window, window->lead)) {
+		if (tg_sqn == _pgm_rxw_tg_sqn (window, window->lead)) {
 			window->has_event = 1;
-			if (NULL == first_state || first_state->is_contiguous) {
-				state->is_contiguous = 1;
-				return _pgm_rxw_append (window, skb, now);
+			if (!_pgm_rxw_contains (window, tg_sqn) || window->is_contiguous[ pgm_rxw_index (window, tg_sqn) ]) {
+				status = _pgm_rxw_append (window, skb, now);
+				if (PGM_RXW_APPENDED == status)
+					window->is_contiguous[ pgm_rxw_index (window, skb->sequence) ] = 1;
+				return status;
 			} else
 				return _pgm_rxw_insert (window, skb);
 		}
 
-		pgm_assert (NULL != first_state);
-		status = _pgm_rxw_add_placeholder_range (window, _pgm_rxw_tg_sqn (window, skb->sequence), now, nak_rb_expiry);
+/* group ahead of the lead, parity fills the first placeholder of the new group */
+		status = _pgm_rxw_add_placeholder_range (window, tg_sqn + 1, now, nak_rb_expiry);
+		if (PGM_RXW_APPENDED != status)
+			return status;
+		window->has_event = 1;
+		status = _pgm_rxw_insert (window, skb);
+		return PGM_RXW_INSERTED == status ? PGM_RXW_MISSING : status;
 	}
 	else
 	{
@@ -402,9 +619,11 @@ pgm_rxw_add (
 
 		if (skb->sequence == pgm_rxw_next_lead (window)) {
 			window->has_event = 1;
-			if (_pgm_rxw_is_first_of_tg_sqn (window, skb->sequence))
-				state->is_contiguous = 1;
-			return _pgm_rxw_append (window, skb, now);
+			status = _pgm_rxw_append (window, skb, now);
+			if (PGM_RXW_APPENDED == status &&
+			    _pgm_rxw_is_first_of_tg_sqn (window, skb->sequence))
+				window->is_contiguous[ pgm_rxw_index (window, skb->sequence) ] = 1;
+			return status;
 		}
 
 		status = _pgm_rxw_add_placeholder_range (window, skb->sequence, now, nak_rb_expiry);
@@ -554,14 +773,9 @@ _pgm_rxw_update_trail (
 	     pgm_uint32_gt (window->rxw_trail, sequence) && pgm_uint32_gte (window->lead, sequence);
 	     sequence++)
 	{
-		struct pgm_sk_buff_t* skb;
-		pgm_rxw_state_t* state;
-
-		skb = _pgm_rxw_peek (window, sequence);
-		pgm_assert (NULL != skb);
-		state = (pgm_rxw_state_t*)&skb->cb;
+		pgm_assert (_pgm_rxw_contains (window, sequence));
 
-		switch (state->pkt_state) {
+		switch (window->pkt_state[ pgm_rxw_index (window, sequence) ]) {
 		case PGM_PKT_STATE_HAVE_DATA:
 		case PGM_PKT_STATE_HAVE_PARITY:
 		case PGM_PKT_STATE_LOST_DATA:
@@ -618,14 +832,12 @@ _pgm_rxw_add_placeholder (
 	const pgm_time_t	nak_rb_expiry
 	)
 {
-	struct pgm_sk_buff_t* skb;
-	pgm_rxw_state_t* state;
-
 /* pre-conditions */
 	pgm_assert (NULL != window);
 	pgm_assert (!pgm_rxw_is_full (window));
 
 /* advance lead */
+	_pgm_rxw_reserve_lead (window);
 	window->lead++;
 
 /* add loss to bitmap */
@@ -638,26 +850,20 @@ _pgm_rxw_add_placeholder (
  */
 	window->data_loss = window->ack_c_p + pgm_fp16mul ((pgm_fp16 (1) - window->ack_c_p), window->data_loss);
 
-	skb			= pgm_alloc_skb (window->max_tpdu);
-	state			= (pgm_rxw_state_t*)&skb->cb;
-	skb->tstamp		= now;
-	skb->sequence		= window->lead;
-	state->timer_expiry	= nak_rb_expiry;
-
-	if (!_pgm_rxw_is_first_of_tg_sqn (window, skb->sequence))
+	if (!_pgm_rxw_is_first_of_tg_sqn (window, window->lead))
 	{
-		struct pgm_sk_buff_t* first_skb = _pgm_rxw_peek (window, _pgm_rxw_tg_sqn (window, skb->sequence));
-		if (first_skb) {
-			pgm_rxw_state_t* first_state = (pgm_rxw_state_t*)&first_skb->cb;
-			first_state->is_contiguous = 0;
-		}
+		const uint32_t tg_sqn = _pgm_rxw_tg_sqn (window, window->lead);
+		if (_pgm_rxw_contains (window, tg_sqn))
+			window->is_contiguous[ pgm_rxw_index (window, tg_sqn) ] = 0;
 	}
 
-/* add skb to window */
-	const uint_fast32_t index_	= skb->sequence % pgm_rxw_max_length (window);
-	window->pdata[index_]		= skb;
+/* add placeholder to window, skb is deferred until repair data arrives */
+	const uint_fast32_t index_	= pgm_rxw_index (window, window->lead);
+	window->pdata[index_]		= NULL;
+	window->tstamp[index_]		= now;
+	window->timer_expiry[index_]	= nak_rb_expiry;
 
-	pgm_rxw_state (window, skb, PGM_PKT_STATE_BACK_OFF);
+	pgm_rxw_state (window, window->lead, PGM_PKT_STATE_BACK_OFF);
 
 /* post-conditions */
 	pgm_assert_cmpuint (pgm_rxw_length (window), >, 0);
@@ -696,8 +902,8 @@ _pgm_rxw_add_placeholder_range (
 		_pgm_rxw_remove_trail (window);
 	}
 
-/* if packet is non-contiguous to current leading edge add place holders
- * TODO: can be rather inefficient on packet loss looping through dropped sequence numbers
+/* if packet is non-contiguous to current leading edge add place holders,
+ * each is slot state only.
  */
 	while (pgm_rxw_next_lead (window) != sequence)
 	{
@@ -776,14 +982,13 @@ _pgm_rxw_is_apdu_lost (
 	struct pgm_sk_buff_t* const restrict skb
 	)
 {
-	const pgm_rxw_state_t* state = (pgm_rxw_state_t*)&skb->cb;
-
 /* pre-conditions */
 	pgm_assert (NULL != window);
 	pgm_assert (NULL != skb);
 
 /* lost is lost */
-	if (PGM_PKT_STATE_LOST_DATA == state->pkt_state)
+	if (_pgm_rxw_peek (window, skb->sequence) == skb &&
+	    PGM_PKT_STATE_LOST_DATA == window->pkt_state[ pgm_rxw_index (window, skb->sequence) ])
 		return TRUE;
 
 /* by definition, a single-TPDU APDU is complete */
@@ -796,56 +1001,56 @@ _pgm_rxw_is_apdu_lost (
 	if (apdu_first_sqn == skb->sequence)
 		return FALSE;
 
-	const struct pgm_sk_buff_t* const first_skb = _pgm_rxw_peek (window, apdu_first_sqn);
 /* first fragment out-of-bounds */
-	if (NULL == first_skb)
+	if (!_pgm_rxw_contains (window, apdu_first_sqn))
 		return TRUE;
 
-	const pgm_rxw_state_t* first_state = (pgm_rxw_state_t*)&first_skb->cb;
-	if (PGM_PKT_STATE_LOST_DATA == first_state->pkt_state)
+	if (PGM_PKT_STATE_LOST_DATA == window->pkt_state[ pgm_rxw_index (window, apdu_first_sqn) ])
 		return TRUE;
 
 	return FALSE;
 }
 
-/* return the first missing packet sequence in the specified transmission
- * group or NULL if not required.
+/* find the first missing packet sequence in the specified transmission
+ * group.
+ *
+ * returns TRUE with the sequence stored in missing, returns FALSE if not required.
  */
 
 static inline
-struct pgm_sk_buff_t*
+bool
 _pgm_rxw_find_missing (
 	pgm_rxw_t* const		window,
-	const uint32_t			tg_sqn		/* tg_sqn | pkt_sqn */
+	const uint32_t			tg_sqn,		/* tg_sqn | pkt_sqn */
+	uint32_t*			missing
 	)
 {
-	struct pgm_sk_buff_t* skb;
-	pgm_rxw_state_t* state;
-
 /* pre-conditions */
 	pgm_assert (NULL != window);
+	pgm_assert (NULL != missing);
 
-	for (uint32_t i = tg_sqn, j = 0; j < window->tg_size; i++, j++)
+/* scan from the start of the group, not the packet sequence of the parity */
+	for (uint32_t i = _pgm_rxw_tg_sqn (window, tg_sqn), j = 0; j < window->tg_size; i++, j++)
 	{
-		skb = _pgm_rxw_peek (window, i);
-		pgm_assert (NULL != skb);
-		state = (pgm_rxw_state_t*)&skb->cb;
-		switch (state->pkt_state) {
+		pgm_assert (_pgm_rxw_contains (window, i));
+		switch (window->pkt_state[ pgm_rxw_index (window, i) ]) {
 		case PGM_PKT_STATE_BACK_OFF:
 		case PGM_PKT_STATE_WAIT_NCF:
 		case PGM_PKT_STATE_WAIT_DATA:
 		case PGM_PKT_STATE_LOST_DATA:
-			return skb;
+			*missing = i;
+			return TRUE;
 
 		case PGM_PKT_STATE_HAVE_DATA:
 		case PGM_PKT_STATE_HAVE_PARITY:
+		case PGM_PKT_STATE_COMMIT_DATA:
 			break;
 
 		default: pgm_assert_not_reached(); break;
 		}
 	}
 
-	return NULL;
+	return FALSE;
 }
 
 /* returns TRUE if skb is a parity packet with packet length not
@@ -949,7 +1154,7 @@ _pgm_rxw_insert (
 	)
 {
 	struct pgm_sk_buff_t* skb;
-	pgm_rxw_state_t* state;
+	uint32_t sequence;
 
 /* pre-conditions */
 	pgm_assert (NULL != window);
@@ -962,31 +1167,33 @@ _pgm_rxw_insert (
 
 	if (new_skb->pgm_header->pgm_options & PGM_OPT_PARITY)
 	{
-		skb = _pgm_rxw_find_missing (window, new_skb->sequence);
-		if (NULL == skb)
+		if (!_pgm_rxw_find_missing (window, new_skb->sequence, &sequence))
 			return PGM_RXW_DUPLICATE;
-		state = (pgm_rxw_state_t*)&skb->cb;
 	}
 	else
 	{
-		skb = _pgm_rxw_peek (window, new_skb->sequence);
-		pgm_assert (NULL != skb);
-		state = (pgm_rxw_state_t*)&skb->cb;
+		sequence = new_skb->sequence;
+		pgm_assert (_pgm_rxw_contains (window, sequence));
 
-		if (state->pkt_state == PGM_PKT_STATE_HAVE_DATA)
+		if (window->pkt_state[ pgm_rxw_index (window, sequence) ] == PGM_PKT_STATE_HAVE_DATA)
 			return PGM_RXW_DUPLICATE;
 	}
 
+	const uint_fast32_t index_ = pgm_rxw_index (window, sequence);
+
 /* APDU fragments are already declared lost */
 	if (new_skb->pgm_opt_fragment &&
 	    _pgm_rxw_is_apdu_lost (window, new_skb))
 	{
-		pgm_rxw_lost (window, skb->sequence);
+		pgm_rxw_lost (window, sequence);
 		return PGM_RXW_BOUNDS;
 	}
 
+/* statistics, parity shuffling moves the slot time */
+	const uint32_t fill_time = (uint32_t)(new_skb->tstamp - window->tstamp[index_]);
+
 /* verify placeholder state */
-	switch (state->pkt_state) {
+	switch (window->pkt_state[index_]) {
 	case PGM_PKT_STATE_BACK_OFF:
 	case PGM_PKT_STATE_WAIT_NCF:
 	case PGM_PKT_STATE_WAIT_DATA:
@@ -994,18 +1201,16 @@ _pgm_rxw_insert (
 		break;
 
 	case PGM_PKT_STATE_HAVE_PARITY:
-		_pgm_rxw_shuffle_parity (window, skb);
+		_pgm_rxw_shuffle_parity (window, sequence);
 		break;
 
 	default: pgm_assert_not_reached(); break;
 	}
 
-/* statistics */
-	const uint32_t fill_time = (uint32_t)(new_skb->tstamp - skb->tstamp);
-	PGM_HISTOGRAM_TIMES("Rx.RepairTime", fill_time);
-	PGM_HISTOGRAM_COUNTS("Rx.NakTransmits", state->nak_transmit_count);
-	PGM_HISTOGRAM_COUNTS("Rx.NcfRetries", state->ncf_retry_count);
-	PGM_HISTOGRAM_COUNTS("Rx.DataRetries", state->data_retry_count);
+	PGM_HDR_RECORD (PGM_HDR_REPAIR_TIME, pgm_to_nsecs (fill_time));
+	PGM_HISTOGRAM_COUNTS("Rx.NakTransmits", window->nak_transmit_count[index_]);
+	PGM_HISTOGRAM_COUNTS("Rx.NcfRetries", window->ncf_retry_count[index_]);
+	PGM_HISTOGRAM_COUNTS("Rx.DataRetries", window->data_retry_count[index_]);
 	if (!window->max_fill_time) {
 		window->max_fill_time = window->min_fill_time = fill_time;
 	}
@@ -1016,13 +1221,14 @@ _pgm_rxw_insert (
 		else if (fill_time < window->min_fill_time)
 			window->min_fill_time = fill_time;
 
+		const uint8_t nak_transmit_count = window->nak_transmit_count[index_];
 		if (!window->max_nak_transmit_count) {
-			window->max_nak_transmit_count = window->min_nak_transmit_count = state->nak_transmit_count;
+			window->max_nak_transmit_count = window->min_nak_transmit_count = nak_transmit_count;
 		} else {
-			if (state->nak_transmit_count > window->max_nak_transmit_count)
-				window->max_nak_transmit_count = state->nak_transmit_count;
-			else if (state->nak_transmit_count < window->min_nak_transmit_count)
-				window->min_nak_transmit_count = state->nak_transmit_count;
+			if (nak_transmit_count > window->max_nak_transmit_count)
+				window->max_nak_transmit_count = nak_transmit_count;
+			else if (nak_transmit_count < window->min_nak_transmit_count)
+				window->min_nak_transmit_count = nak_transmit_count;
 		}
 	}
 
@@ -1041,53 +1247,57 @@ _pgm_rxw_insert (
 	if (s > window->data_loss)	window->data_loss = 0;
 	else				window->data_loss -= s;
 
-/* replace place holder skb with incoming skb */
-	memcpy (new_skb->cb, skb->cb, sizeof(skb->cb));
-	state = (void*)new_skb->cb;
-	state->pkt_state = PGM_PKT_STATE_ERROR;
-	_pgm_rxw_unlink (window, skb);
-	pgm_free_skb (skb);
-	const uint_fast32_t index_ = new_skb->sequence % pgm_rxw_max_length (window);
+/* fill placeholder with incoming skb, sequence state is retained.  parity
+ * occupies the missing sequence, a parity skb not shuffled away is dropped.
+ */
+	_pgm_rxw_unlink (window, sequence);
+	skb = window->pdata[index_];
+	if (skb) {
+		window->size -= skb->len;
+		pgm_free_skb (skb);
+	}
+	new_skb->sequence = sequence;
 	window->pdata[index_] = new_skb;
+	window->tstamp[index_] = new_skb->tstamp;
 	if (new_skb->pgm_header->pgm_options & PGM_OPT_PARITY)
-		_pgm_rxw_state (window, new_skb, PGM_PKT_STATE_HAVE_PARITY);
+		_pgm_rxw_state (window, sequence, PGM_PKT_STATE_HAVE_PARITY);
 	else
-		_pgm_rxw_state (window, new_skb, PGM_PKT_STATE_HAVE_DATA);
+		_pgm_rxw_state (window, sequence, PGM_PKT_STATE_HAVE_DATA);
 	window->size += new_skb->len;
 
 	return PGM_RXW_INSERTED;
 }
 
-/* shuffle parity packet at skb->sequence to any other needed spot.
+/* shuffle parity packet at sequence to any other needed spot.
  */
 
 static inline
 void
 _pgm_rxw_shuffle_parity (
-	pgm_rxw_t*	      const restrict window,
-	struct pgm_sk_buff_t* const restrict skb
+	pgm_rxw_t* const	window,
+	const uint32_t		sequence
 	)
 {
-	struct pgm_sk_buff_t* restrict missing;
-	char cb[48];
+	struct pgm_sk_buff_t* skb;
+	uint32_t missing;
 
 /* pre-conditions */
 	pgm_assert (NULL != window);
-	pgm_assert (NULL != skb);
+	pgm_assert (_pgm_rxw_contains (window, sequence));
 
-	missing = _pgm_rxw_find_missing (window, skb->sequence);
-	if (NULL == missing)
+	if (!_pgm_rxw_find_missing (window, sequence, &missing))
 		return;
 
-/* replace place holder skb with parity skb */
+/* move parity skb into the placeholder, leaving a vacant slot */
 	_pgm_rxw_unlink (window, missing);
-	memcpy (cb, skb->cb, sizeof(skb->cb));
-	memcpy (skb->cb, missing->cb, sizeof(skb->cb));
-	memcpy (missing->cb, cb, sizeof(skb->cb));
-	const uint32_t parity_index = skb->sequence % pgm_rxw_max_length (window);
-	window->pdata[parity_index] = skb;
-	const uint32_t missing_index = missing->sequence % pgm_rxw_max_length (window);
-	window->pdata[missing_index] = missing;
+	const uint_fast32_t parity_index = pgm_rxw_index (window, sequence);
+	const uint_fast32_t missing_index = pgm_rxw_index (window, missing);
+	_pgm_rxw_swap_state (window, parity_index, missing_index);
+	skb = window->pdata[parity_index];
+	pgm_assert (NULL != skb);
+	skb->sequence = missing;
+	window->pdata[missing_index] = skb;
+	window->pdata[parity_index] = NULL;
 }
 
 /* skb advances the window lead.
@@ -1129,6 +1339,7 @@ _pgm_rxw_append (
 	}
 
 /* advance leading edge */
+	_pgm_rxw_reserve_lead (window);
 	window->lead++;
 
 /* add packet to bitmap */
@@ -1145,31 +1356,23 @@ _pgm_rxw_append (
 	if (PGM_UNLIKELY(skb->pgm_opt_fragment &&
 	    _pgm_rxw_is_apdu_lost (window, skb)))
 	{
-		struct pgm_sk_buff_t* lost_skb	= pgm_alloc_skb (window->max_tpdu);
-		lost_skb->tstamp		= now;
-		lost_skb->sequence		= skb->sequence;
-
-/* add lost-placeholder skb to window */
-		const uint_fast32_t index_	= lost_skb->sequence % pgm_rxw_max_length (window);
-		window->pdata[index_]		= lost_skb;
+/* add lost-placeholder to window */
+		const uint_fast32_t index_	= pgm_rxw_index (window, skb->sequence);
+		window->pdata[index_]		= NULL;
+		window->tstamp[index_]		= now;
 
-		_pgm_rxw_state (window, lost_skb, PGM_PKT_STATE_LOST_DATA);
+		_pgm_rxw_state (window, skb->sequence, PGM_PKT_STATE_LOST_DATA);
 		return PGM_RXW_BOUNDS;
 	}
 
 /* add skb to window */
+	const uint_fast32_t index_	= pgm_rxw_index (window, skb->sequence);
+	window->pdata[index_]		= skb;
+	window->tstamp[index_]		= skb->tstamp;
 	if (skb->pgm_header->pgm_options & PGM_OPT_PARITY)
-	{
-		const uint_fast32_t index_	= skb->sequence % pgm_rxw_max_length (window);
-		window->pdata[index_]		= skb;
-		_pgm_rxw_state (window, skb, PGM_PKT_STATE_HAVE_PARITY);
-	}
+		_pgm_rxw_state (window, skb->sequence, PGM_PKT_STATE_HAVE_PARITY);
 	else
-	{
-		const uint_fast32_t index_	= skb->sequence % pgm_rxw_max_length (window);
-		window->pdata[index_]		= skb;
-		_pgm_rxw_state (window, skb, PGM_PKT_STATE_HAVE_DATA);
-	}
+		_pgm_rxw_state (window, skb->sequence, PGM_PKT_STATE_HAVE_DATA);
 
 /* statistics */
 	window->size += skb->len;
@@ -1197,6 +1400,12 @@ pgm_rxw_remove_commit (
 	{
 		_pgm_rxw_remove_trail (window);
 	}
+
+/* release slot memory when occupancy falls to a quarter */
+	const unsigned slots = window->mask + 1;
+	if (slots > PGM_RXW_MIN_SLOTS &&
+	    pgm_rxw_length (window) <= slots / 4)
+		_pgm_rxw_resize (window, slots / 2);
 }
 
 /* flush packets but instead of calling on_data append the contiguous data packets
@@ -1221,8 +1430,6 @@ pgm_rxw_readv (
 	)
 {
 	const struct pgm_msgv_t* msg_end;
-	struct pgm_sk_buff_t* skb;
-	pgm_rxw_state_t* state;
 	ssize_t bytes_read;
 
 /* pre-conditions */
@@ -1238,11 +1445,11 @@ pgm_rxw_readv (
 	if (_pgm_rxw_incoming_is_empty (window))
 		return -1;
 
-	skb = _pgm_rxw_peek (window, window->commit_lead);
-	pgm_assert (NULL != skb);
+	pgm_assert (_pgm_rxw_contains (window, window->commit_lead));
 
-	state = (pgm_rxw_state_t*)&skb->cb;
-	switch (state->pkt_state) {
+	switch (window->pkt_state[ pgm_rxw_index (window, window->commit_lead) ]) {
+/* parity in place of the leading sequence may complete the transmission group */
+	case PGM_PKT_STATE_HAVE_PARITY:
 	case PGM_PKT_STATE_HAVE_DATA:
 		bytes_read = _pgm_rxw_incoming_read (window, pmsg, (unsigned)(msg_end - *pmsg + 1));
 		break;
@@ -1259,7 +1466,6 @@ pgm_rxw_readv (
 	case PGM_PKT_STATE_BACK_OFF:
 	case PGM_PKT_STATE_WAIT_NCF:
 	case PGM_PKT_STATE_WAIT_DATA:
-	case PGM_PKT_STATE_HAVE_PARITY:
 		bytes_read = -1;
 		break;
 
@@ -1292,16 +1498,19 @@ _pgm_rxw_remove_trail (
 	pgm_assert (NULL != window);
 	pgm_assert (!pgm_rxw_is_empty (window));
 
-	skb = _pgm_rxw_peek (window, window->trail);
-	pgm_assert (NULL != skb);
-	_pgm_rxw_unlink (window, skb);
-	window->size -= skb->len;
+	_pgm_rxw_unlink (window, window->trail);
+/* reset sequence state for the next occupant of the slot */
+	const uint_fast32_t index_ = pgm_rxw_index (window, window->trail);
+	_pgm_rxw_clear_state (window, index_);
+/* placeholders have no skb */
+	skb = window->pdata[index_];
+	if (skb) {
+		window->size -= skb->len;
 /* remove reference to skb */
-	if (PGM_UNLIKELY(pgm_mem_gc_friendly)) {
-		const uint_fast32_t index_ = skb->sequence % pgm_rxw_max_length (window);
-		window->pdata[index_] = NULL;
+		if (PGM_UNLIKELY(pgm_mem_gc_friendly))
+			window->pdata[index_] = NULL;
+		pgm_free_skb (skb);
 	}
-	pgm_free_skb (skb);
 	if (window->trail++ == window->commit_lead) {
 /* data-loss */
 		window->commit_lead++;
@@ -1355,10 +1564,9 @@ _pgm_rxw_incoming_read (
 
 	msg_end = *pmsg + pmsglen - 1;
 	do {
-		skb = _pgm_rxw_peek (window, window->commit_lead);
-		pgm_assert (NULL != skb);
+		skb = _pgm_rxw_peek_data (window, window->commit_lead);
 		if (_pgm_rxw_is_apdu_complete (window,
-					      skb->pgm_opt_fragment ? pgm_ntohl (skb->of_apdu_first_sqn) : skb->sequence))
+					      skb && skb->pgm_opt_fragment ? pgm_ntohl (skb->of_apdu_first_sqn) : window->commit_lead))
 		{
 			bytes_read += _pgm_rxw_incoming_read_apdu (window, pmsg);
 			data_read  ++;
@@ -1410,7 +1618,6 @@ _pgm_rxw_reconstruct (
 	)
 {
 	struct pgm_sk_buff_t	*skb;
-	pgm_rxw_state_t		*state;
 	struct pgm_sk_buff_t   **tg_skbs;
 	pgm_gf8_t	       **tg_data, **tg_opts;
 	uint8_t			*offsets;
@@ -1427,7 +1634,10 @@ _pgm_rxw_reconstruct (
 	tg_opts = pgm_newa (pgm_gf8_t*, window->rs.n);
 	offsets = pgm_newa (uint8_t, window->rs.k);
 
-	skb = _pgm_rxw_peek (window, tg_sqn);
+/* first data or parity skb of the group describes the encoding */
+	skb = NULL;
+	for (uint32_t i = tg_sqn; NULL == skb && i != (tg_sqn + window->rs.k); i++)
+		skb = _pgm_rxw_peek (window, i);
 	pgm_assert (NULL != skb);
 
 	const bool is_var_pktlen = skb->pgm_header->pgm_options & PGM_OPT_VAR_PKTLEN;
@@ -1436,10 +1646,11 @@ _pgm_rxw_reconstruct (
 
 	for (uint32_t i = tg_sqn, j = 0; i != (tg_sqn + window->rs.k); i++, j++)
 	{
-		skb = _pgm_rxw_peek (window, i);
-		pgm_assert (NULL != skb);
-		state = (pgm_rxw_state_t*)&skb->cb;
-		switch (state->pkt_state) {
+		pgm_assert (_pgm_rxw_contains (window, i));
+		skb = window->pdata[ pgm_rxw_index (window, i) ];
+		switch (window->pkt_state[ pgm_rxw_index (window, i) ]) {
+/* leading packets of the group may already be committed */
+		case PGM_PKT_STATE_COMMIT_DATA:
 		case PGM_PKT_STATE_HAVE_DATA:
 			tg_skbs[ j ] = skb;
 			tg_data[ j ] = skb->data;
@@ -1458,10 +1669,15 @@ _pgm_rxw_reconstruct (
 		case PGM_PKT_STATE_WAIT_NCF:
 		case PGM_PKT_STATE_WAIT_DATA:
 		case PGM_PKT_STATE_LOST_DATA:
-			skb = pgm_alloc_skb (window->max_tpdu);
+			skb = pgm_skb_pool_alloc (window->pool, window->max_tpdu);
+			memcpy (&skb->tsi, window->tsi, sizeof(pgm_tsi_t));
+			skb->sequence = i;
 			pgm_skb_reserve (skb, sizeof(struct pgm_header) + sizeof(struct pgm_data));
 			skb->pgm_header = skb->head;
 			skb->pgm_data = (void*)( skb->pgm_header + 1 );
+/* buffers are not cleared, a recycled header may carry parity options */
+			memset (skb->pgm_header, 0, sizeof(struct pgm_header) + sizeof(struct pgm_data));
+			skb->pgm_data->data_sqn = pgm_htonl (i);
 			if (is_op_encoded) {
 				const uint16_t opt_total_length = sizeof(struct pgm_opt_length) +
 								 sizeof(struct pgm_opt_header) +
@@ -1572,15 +1788,16 @@ _pgm_rxw_is_apdu_complete (
 	pgm_debug ("_pgm_rxw_is_apdu_complete (window:%p first-sequence:%" PRIu32 ")",
 		(const void*)window, first_sequence);
 
-	skb = _pgm_rxw_peek (window, first_sequence);
-	if (PGM_UNLIKELY(NULL == skb)) {
+	if (PGM_UNLIKELY(!_pgm_rxw_contains (window, first_sequence))) {
 		return FALSE;
 	}
 
-	const size_t apdu_size = skb->pgm_opt_fragment ? pgm_ntohl (skb->of_apdu_len) : skb->len;
+/* a placeholder or parity can only be completed by parity recovery */
+	skb = _pgm_rxw_peek_data (window, first_sequence);
+	const size_t apdu_size = NULL == skb ? 0 : skb->pgm_opt_fragment ? pgm_ntohl (skb->of_apdu_len) : skb->len;
 	const uint32_t  tg_sqn = _pgm_rxw_tg_sqn (window, first_sequence);
 
-	pgm_assert_cmpuint (apdu_size, >=, skb->len);
+	pgm_assert (NULL == skb || apdu_size >= skb->len);
 
 /* protocol sanity check: maximum length */
 	if (PGM_UNLIKELY(apdu_size > PGM_MAX_APDU)) {
@@ -1589,13 +1806,13 @@ _pgm_rxw_is_apdu_complete (
 	}
 
 	for (uint32_t sequence = first_sequence;
-	     skb;
-	     skb = _pgm_rxw_peek (window, ++sequence))
+	     _pgm_rxw_contains (window, sequence);
+	     skb = window->pdata[ pgm_rxw_index (window, ++sequence) ])
 	{
-		pgm_rxw_state_t* state = (pgm_rxw_state_t*)&skb->cb;
+		const int pkt_state = window->pkt_state[ pgm_rxw_index (window, sequence) ];
 
 		if (!check_parity &&
-		    PGM_PKT_STATE_HAVE_DATA != state->pkt_state)
+		    PGM_PKT_STATE_HAVE_DATA != pkt_state)
 		{
 			if (window->is_fec_available &&
 			    !_pgm_rxw_is_tg_sqn_lost (window, tg_sqn) )
@@ -1613,8 +1830,12 @@ _pgm_rxw_is_apdu_complete (
 
 		if (check_parity)
 		{
-			if (PGM_PKT_STATE_HAVE_DATA == state->pkt_state ||
-			    PGM_PKT_STATE_HAVE_PARITY == state->pkt_state)
+/* only the transmission group itself can contribute to recovery */
+			if (tg_sqn != _pgm_rxw_tg_sqn (window, sequence))
+				return FALSE;
+
+			if (PGM_PKT_STATE_HAVE_DATA == pkt_state ||
+			    PGM_PKT_STATE_HAVE_PARITY == pkt_state)
 				++contiguous_tpdus;
 
 /* have sufficient been received for reconstruction */
@@ -1626,7 +1847,7 @@ _pgm_rxw_is_apdu_complete (
 		else
 		{
 /* single packet APDU, already complete */
-			if (PGM_PKT_STATE_HAVE_DATA == state->pkt_state &&
+			if (PGM_PKT_STATE_HAVE_DATA == pkt_state &&
 			    !skb->pgm_opt_fragment)
 				return TRUE;
 
@@ -1691,7 +1912,7 @@ _pgm_rxw_incoming_read_apdu (
 	pgm_assert_cmpuint (apdu_len, >=, skb->len);
 
 	do {
-		_pgm_rxw_state (window, skb, PGM_PKT_STATE_COMMIT_DATA);
+		_pgm_rxw_state (window, skb->sequence, PGM_PKT_STATE_COMMIT_DATA);
 		(*pmsg)->msgv_skb[ count++ ] = skb;
 		contiguous_len += skb->len;
 		window->commit_lead++;
@@ -1775,40 +1996,41 @@ _pgm_rxw_is_last_of_tg_sqn (
 	return _pgm_rxw_pkt_sqn (window, sequence) == window->tg_size - 1;
 }
 
-/* set PGM skbuff to new FSM state.
+/* set sequence to new FSM state.
  */
 
 static
 void
 _pgm_rxw_state (
-	pgm_rxw_t*	      const restrict window,
-	struct pgm_sk_buff_t* const restrict skb,
-	const int			     new_pkt_state
+	pgm_rxw_t* const	window,
+	const uint32_t		sequence,
+	const int		new_pkt_state
 	)
 {
-	pgm_rxw_state_t* state;
-
 /* pre-conditions */
 	pgm_assert (NULL != window);
-	pgm_assert (NULL != skb);
+	pgm_assert (_pgm_rxw_contains (window, sequence));
 
-	state = (pgm_rxw_state_t*)&skb->cb;
+	const uint_fast32_t index_ = pgm_rxw_index (window, sequence);
 
 /* remove current state */
-	if (PGM_PKT_STATE_ERROR != state->pkt_state)
-		_pgm_rxw_unlink (window, skb);
+	if (PGM_PKT_STATE_ERROR != window->pkt_state[index_])
+		_pgm_rxw_unlink (window, sequence);
 
 	switch (new_pkt_state) {
 	case PGM_PKT_STATE_BACK_OFF:
-		pgm_queue_push_head_link (&window->nak_backoff_queue, (pgm_list_t*)skb);
+		window->backoff_bitmap[ index_ >> 5 ] |= (uint32_t)1 << (index_ & 31);
+		if (0 == window->nak_backoff_count++ ||
+		    pgm_time_after (window->nak_backoff_expiry, window->timer_expiry[index_]))
+			window->nak_backoff_expiry = window->timer_expiry[index_];
 		break;
 
 	case PGM_PKT_STATE_WAIT_NCF:
-		pgm_queue_push_head_link (&window->wait_ncf_queue, (pgm_list_t*)skb);
+		pgm_queue_push_head_link (&window->wait_ncf_queue, &window->link[index_]);
 		break;
 
 	case PGM_PKT_STATE_WAIT_DATA:
-		pgm_queue_push_head_link (&window->wait_data_queue, (pgm_list_t*)skb);
+		pgm_queue_push_head_link (&window->wait_data_queue, &window->link[index_]);
 		break;
 
 	case PGM_PKT_STATE_HAVE_DATA:
@@ -1839,20 +2061,20 @@ _pgm_rxw_state (
 	default: pgm_assert_not_reached(); break;
 	}
 
-	state->pkt_state = new_pkt_state;
+	window->pkt_state[index_] = (uint8_t)new_pkt_state;
 }
 
 PGM_GNUC_INTERNAL
 void
 pgm_rxw_state (
-	pgm_rxw_t*	      const restrict window,
-	struct pgm_sk_buff_t* const restrict skb,
-	const int			     new_pkt_state
+	pgm_rxw_t* const	window,
+	const uint32_t		sequence,
+	const int		new_pkt_state
 	)
 {
-	pgm_debug ("state (window:%p skb:%p new_pkt_state:%s)",
-		(const void*)window, (const void*)skb, pgm_pkt_state_string (new_pkt_state));
-	_pgm_rxw_state (window, skb, new_pkt_state);
+	pgm_debug ("state (window:%p sequence:%" PRIu32 " new_pkt_state:%s)",
+		(const void*)window, sequence, pgm_pkt_state_string (new_pkt_state));
+	_pgm_rxw_state (window, sequence, new_pkt_state);
 }
 
 /* remove current state from sequence.
@@ -1861,24 +2083,23 @@ pgm_rxw_state (
 static
 void
 _pgm_rxw_unlink (
-	pgm_rxw_t*	      const restrict window,
-	struct pgm_sk_buff_t* const restrict skb
+	pgm_rxw_t* const	window,
+	const uint32_t		sequence
 	)
 {
-	pgm_rxw_state_t* state;
 	pgm_queue_t* queue;
 
 /* pre-conditions */
 	pgm_assert (NULL != window);
-	pgm_assert (NULL != skb);
 
-	state = (pgm_rxw_state_t*)&skb->cb;
+	const uint_fast32_t index_ = pgm_rxw_index (window, sequence);
 
-	switch (state->pkt_state) {
+	switch (window->pkt_state[index_]) {
 	case PGM_PKT_STATE_BACK_OFF:
-		pgm_assert (!pgm_queue_is_empty (&window->nak_backoff_queue));
-		queue = &window->nak_backoff_queue;
-		goto unlink_queue;
+		pgm_assert_cmpuint (window->nak_backoff_count, >, 0);
+		window->backoff_bitmap[ index_ >> 5 ] &= ~((uint32_t)1 << (index_ & 31));
+		window->nak_backoff_count--;
+		break;
 
 	case PGM_PKT_STATE_WAIT_NCF:
 		pgm_assert (!pgm_queue_is_empty (&window->wait_ncf_queue));
@@ -1889,7 +2110,7 @@ _pgm_rxw_unlink (
 		pgm_assert (!pgm_queue_is_empty (&window->wait_data_queue));
 		queue = &window->wait_data_queue;
 unlink_queue:
-		pgm_queue_unlink (queue, (pgm_list_t*)skb);
+		pgm_queue_unlink (queue, &window->link[index_]);
 		break;
 
 	case PGM_PKT_STATE_HAVE_DATA:
@@ -1918,9 +2139,50 @@ unlink_queue:
 	default: pgm_assert_not_reached(); break;
 	}
 
-	state->pkt_state = PGM_PKT_STATE_ERROR;
-	pgm_assert (((pgm_list_t*)skb)->next == NULL);
-	pgm_assert (((pgm_list_t*)skb)->prev == NULL);
+	window->pkt_state[index_] = PGM_PKT_STATE_ERROR;
+	pgm_assert (window->link[index_].next == NULL);
+	pgm_assert (window->link[index_].prev == NULL);
+}
+
+/* find the first sequence in BACK-OFF state from sequence to the window lead,
+ * scanning the loss bitmap a word at a time.
+ *
+ * returns TRUE with the sequence stored in found, returns FALSE if none remain.
+ */
+
+PGM_GNUC_INTERNAL
+bool
+pgm_rxw_find_backoff (
+	const pgm_rxw_t* const restrict window,
+	uint32_t			sequence,
+	uint32_t*	       restrict found
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != window);
+	pgm_assert (NULL != found);
+
+	if (0 == window->nak_backoff_count)
+		return FALSE;
+	if (pgm_uint32_lt (sequence, window->trail))
+		sequence = window->trail;
+
+	while (pgm_uint32_lte (sequence, window->lead))
+	{
+		const uint_fast32_t index_ = pgm_rxw_index (window, sequence);
+		const uint32_t word = window->backoff_bitmap[ index_ >> 5 ] >> (index_ & 31);
+		if (word) {
+/* bits beyond the allocated slots are never set */
+			sequence += _pgm_rxw_ctz (word);
+			if (pgm_uint32_gt (sequence, window->lead))
+				return FALSE;
+			*found = sequence;
+			return TRUE;
+		}
+		const uint_fast32_t remaining = MIN(32 - (index_ & 31), window->mask + 1 - index_);
+		sequence += (uint32_t)remaining;
+	}
+	return FALSE;
 }
 
 /* returns the pointer at the given index of the window.
@@ -1947,9 +2209,6 @@ pgm_rxw_lost (
 	const uint32_t		sequence
 	)
 {
-	struct pgm_sk_buff_t* skb;
-	pgm_rxw_state_t* state;
-
 /* pre-conditions */
 	pgm_assert (NULL != window);
 	pgm_assert (!pgm_rxw_is_empty (window));
@@ -1957,22 +2216,21 @@ pgm_rxw_lost (
 	pgm_debug ("lost (window:%p sequence:%" PRIu32 ")",
 		 (const void*)window, sequence);
 
-	skb = _pgm_rxw_peek (window, sequence);
-	pgm_assert (NULL != skb);
+	pgm_assert (_pgm_rxw_contains (window, sequence));
 
-	state = (pgm_rxw_state_t*)&skb->cb;
+	const int pkt_state = window->pkt_state[ pgm_rxw_index (window, sequence) ];
 
-	if (PGM_UNLIKELY(!(state->pkt_state == PGM_PKT_STATE_BACK_OFF  ||
-	                 state->pkt_state == PGM_PKT_STATE_WAIT_NCF  ||
-	                 state->pkt_state == PGM_PKT_STATE_WAIT_DATA ||
-			 state->pkt_state == PGM_PKT_STATE_HAVE_DATA ||	/* fragments */
-			 state->pkt_state == PGM_PKT_STATE_HAVE_PARITY)))
+	if (PGM_UNLIKELY(!(pkt_state == PGM_PKT_STATE_BACK_OFF  ||
+	                 pkt_state == PGM_PKT_STATE_WAIT_NCF  ||
+	                 pkt_state == PGM_PKT_STATE_WAIT_DATA ||
+			 pkt_state == PGM_PKT_STATE_HAVE_DATA ||	/* fragments */
+			 pkt_state == PGM_PKT_STATE_HAVE_PARITY)))
 	{
-		pgm_fatal (_("Unexpected state %s(%u)"), pgm_pkt_state_string (state->pkt_state), state->pkt_state);
+		pgm_fatal (_("Unexpected state %s(%u)"), pgm_pkt_state_string (pkt_state), pkt_state);
 		pgm_assert_not_reached();
 	}
 
-	_pgm_rxw_state (window, skb, PGM_PKT_STATE_LOST_DATA);
+	_pgm_rxw_state (window, sequence, PGM_PKT_STATE_LOST_DATA);
 }
 
 /* received a uni/multicast ncf, search for a matching nak & tag or extend window if
@@ -2039,24 +2297,20 @@ _pgm_rxw_recovery_update (
 	const pgm_time_t	nak_rdata_expiry		/* pre-calculated expiry times */
 	)
 {
-	pgm_rxw_state_t* state;
-	struct pgm_sk_buff_t* skb;
-
 /* pre-conditions */
 	pgm_assert (NULL != window);
 
-/* fetch skb from window and bump expiration times */
-	skb = _pgm_rxw_peek (window, sequence);
-	pgm_assert (NULL != skb);
-	state = (pgm_rxw_state_t*)&skb->cb;
-	switch (state->pkt_state) {
+/* bump expiration times of sequence */
+	pgm_assert (_pgm_rxw_contains (window, sequence));
+	const uint_fast32_t index_ = pgm_rxw_index (window, sequence);
+	switch (window->pkt_state[index_]) {
 	case PGM_PKT_STATE_BACK_OFF:
 	case PGM_PKT_STATE_WAIT_NCF:
-		pgm_rxw_state (window, skb, PGM_PKT_STATE_WAIT_DATA);
+		pgm_rxw_state (window, sequence, PGM_PKT_STATE_WAIT_DATA);
 
 /* fall through */
 	case PGM_PKT_STATE_WAIT_DATA:
-		state->timer_expiry = nak_rdata_expiry;
+		window->timer_expiry[index_] = nak_rdata_expiry;
 		return PGM_RXW_UPDATED;
 
 	case PGM_PKT_STATE_HAVE_DATA:
@@ -2086,9 +2340,6 @@ _pgm_rxw_recovery_append (
 	const pgm_time_t	nak_rdata_expiry		/* pre-calculated expiry times */
 	)
 {
-	struct pgm_sk_buff_t* skb;
-	pgm_rxw_state_t* state;
-
 /* pre-conditions */
 	pgm_assert (NULL != window);
 
@@ -2102,6 +2353,7 @@ _pgm_rxw_recovery_append (
 	}
 
 /* advance leading edge */
+	_pgm_rxw_reserve_lead (window);
 	window->lead++;
 
 /* add loss to bitmap */
@@ -2114,15 +2366,11 @@ _pgm_rxw_recovery_append (
  */
 	window->data_loss = window->ack_c_p + pgm_fp16mul (pgm_fp16 (1) - window->ack_c_p, window->data_loss);
 
-	skb			= pgm_alloc_skb (window->max_tpdu);
-	state			= (pgm_rxw_state_t*)&skb->cb;
-	skb->tstamp		= now;
-	skb->sequence		= window->lead;
-	state->timer_expiry	= nak_rdata_expiry;
-
-	const uint_fast32_t index_	= pgm_rxw_lead (window) % pgm_rxw_max_length (window);
-	window->pdata[index_]		= skb;
-	_pgm_rxw_state (window, skb, PGM_PKT_STATE_WAIT_DATA);
+	const uint_fast32_t index_	= pgm_rxw_index (window, pgm_rxw_lead (window));
+	window->pdata[index_]		= NULL;
+	window->tstamp[index_]		= now;
+	window->timer_expiry[index_]	= nak_rdata_expiry;
+	_pgm_rxw_state (window, window->lead, PGM_PKT_STATE_WAIT_DATA);
 
 	return PGM_RXW_APPENDED;
 }
@@ -2138,7 +2386,8 @@ pgm_rxw_dump (
 {
 	pgm_info ("window = {"
 		"tsi = {gsi = {identifier = %i.%i.%i.%i.%i.%i}, sport = %" PRIu16 "}, "
-		"nak_backoff_queue = {head = %p, tail = %p, length = %u}, "
+		"nak_backoff_count = %" PRIu32 ", "
+		"nak_backoff_expiry = %" PGM_TIME_FORMAT ", "
 		"wait_ncf_queue = {head = %p, tail = %p, length = %u}, "
 		"wait_data_queue = {head = %p, tail = %p, length = %u}, "
 		"lost_count = %" PRIu32 ", "
@@ -2166,6 +2415,7 @@ pgm_rxw_dump (
 		"msgs_delivered = %" PRIu32 ", "
 		"size = %" PRIzu ", "
 		"alloc = %" PRIu32 ", "
+		"mask = 0x%" PRIx32 ", "
 		"pdata = []"
 		"}",
 		window->tsi->gsi.identifier[0], 
@@ -2175,9 +2425,8 @@ pgm_rxw_dump (
 			window->tsi->gsi.identifier[4],
 			window->tsi->gsi.identifier[5],
 			pgm_ntohs (window->tsi->sport),
-		(void*)window->nak_backoff_queue.head,
-			(void*)window->nak_backoff_queue.tail,
-			window->nak_backoff_queue.length,
+		window->nak_backoff_count,
+		window->nak_backoff_expiry,
 		(void*)window->wait_ncf_queue.head,
 			(void*)window->wait_ncf_queue.tail,
 			window->wait_ncf_queue.length,
@@ -2208,7 +2457,8 @@ pgm_rxw_dump (
 		window->bytes_delivered,
 		window->msgs_delivered,
 		window->size,
-		window->alloc
+		window->alloc,
+		window->mask
 	);
 }
 
@@ -0,0 +1,934 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * performance tests for the receive path.
+ *
+ * Copyright (c) 2010-2016 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* drives pgm_rxw_add() with pgm_rxw_readv() on a bare receive window,
+ * pgm_on_data() on a receiver peer, and pgm_recvmsgv() on a bound and
+ * connected socket with the network replaced by a stub serving pre-built
+ * datagrams.  each arrival pattern delivers the same sequence of APDUs with
+ * loss repaired by RDATA or on-demand parity.  one CSV line is printed per
+ * API and pattern:
+ *
+ *	api,pattern,packets,elapsed_us,packets_per_sec,ns_per_packet,allocs_per_packet,cache_misses_per_packet
+ *
+ * allocations are counted in the receive window, receiver and receive path
+ * compiled into this program, cache misses are -1 when hardware counters are
+ * unavailable.  pgm_recvmsgv() is not measured on Windows.
+ */
+
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+
+#ifndef _GNU_SOURCE
+#	define _GNU_SOURCE
+#endif
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#	include <sys/types.h>
+#	include <sys/socket.h>
+#	include <netinet/in.h>
+#endif
+#ifdef __linux__
+#	include <unistd.h>
+#	include <sys/ioctl.h>
+#	include <sys/syscall.h>
+#	include <linux/perf_event.h>
+#endif
+
+
+#define PERF_NETWORK		"127.0.0.1;239.192.0.1"
+#define PERF_UDP_ENCAP_PORT	3056
+#define PERF_DPORT		7500
+#define PERF_SPORT		1000
+#define PERF_SRC_ADDR		0x7f000006		/* 127.0.0.6 */
+#define PERF_GROUP_ADDR		0xefc00001		/* 239.192.0.1 */
+#define PERF_MAX_TPDU		1500
+#define PERF_RXW_SQNS		1024
+#define PERF_PACKETS		8192		/* per round */
+#define PERF_ROUNDS		8
+#define PERF_BATCH		16		/* packets per drain, cf. recvmmsg */
+#define PERF_REPAIR_DELAY	32		/* packets between loss and repair */
+#define PERF_TSDU		1000
+#define PERF_RS_K		8
+
+enum {
+	PERF_IN_ORDER = 0,
+	PERF_RANDOM_LOSS,
+	PERF_BURST_LOSS,
+	PERF_REORDER,
+	PERF_FEC,
+	PERF_PATTERN_MAX
+};
+
+enum {
+	PERF_RXW = 0,
+	PERF_ON_DATA,
+	PERF_RECVMSGV,
+	PERF_API_MAX
+};
+
+static const char* perf_pattern_name[ PERF_PATTERN_MAX ] = { "in-order", "random-loss", "burst-loss", "reorder", "fec" };
+static const char* perf_api_name[ PERF_API_MAX ] = { "pgm_rxw_add", "pgm_on_data", "pgm_recvmsgv" };
+
+struct perf_arrival_t {
+	uint32_t	sequence;
+	bool		is_parity;
+};
+
+static unsigned perf_allocs = 0;
+
+/* datagrams returned by the network stub, unread are [next, limit) */
+static char* perf_rx_tpdu[ 2 * PERF_PACKETS ];
+static uint16_t perf_rx_len[ 2 * PERF_PACKETS ];
+static unsigned perf_rx_next = 0;
+static unsigned perf_rx_limit = 0;
+
+/* count heap allocations made on the receive path */
+
+#define pgm_malloc		perf_pgm_malloc
+#define pgm_malloc_n		perf_pgm_malloc_n
+#define pgm_malloc0		perf_pgm_malloc0
+#define pgm_malloc0_n		perf_pgm_malloc0_n
+#define pgm_skb_pool_alloc	perf_pgm_skb_pool_alloc
+
+#ifndef _WIN32
+static ssize_t perf_recvmsg (int, struct msghdr*, int);
+#	define recvmsg			perf_recvmsg
+#	ifdef HAVE_RECVMMSG
+static int perf_recvmmsg (int, struct mmsghdr*, unsigned, int, struct timespec*);
+#		define recvmmsg		perf_recvmmsg
+#	endif
+#endif
+
+#include "rxw.c"
+#include "receiver.c"
+#include "recv.c"
+#include <pgm/pgm.h>
+
+#undef pgm_skb_pool_alloc
+PGM_GNUC_INTERNAL struct pgm_sk_buff_t* pgm_skb_pool_alloc (pgm_skb_pool_t*const, const uint16_t);
+
+/* network replacement in net.c */
+extern int (*priv_sendto)(SOCKET, const char*, int, int, const struct sockaddr*, int);
+
+
+void*
+perf_pgm_malloc (
+	const size_t	n_bytes
+	)
+{
+	perf_allocs++;
+	return malloc (n_bytes);
+}
+
+void*
+perf_pgm_malloc_n (
+	const size_t	n_blocks,
+	const size_t	block_bytes
+	)
+{
+	perf_allocs++;
+	return malloc (n_blocks * block_bytes);
+}
+
+void*
+perf_pgm_malloc0 (
+	const size_t	n_bytes
+	)
+{
+	perf_allocs++;
+	return calloc (1, n_bytes);
+}
+
+void*
+perf_pgm_malloc0_n (
+	const size_t	n_blocks,
+	const size_t	block_bytes
+	)
+{
+	perf_allocs++;
+	return calloc (n_blocks, block_bytes);
+}
+
+/* buffers recycled through a pool are not allocations, populating a new slot
+ * or falling back to the heap is.
+ */
+
+struct pgm_sk_buff_t*
+perf_pgm_skb_pool_alloc (
+	pgm_skb_pool_t*const	pool,
+	const uint16_t		size
+	)
+{
+	if (NULL == pool)
+		return pgm_alloc_skb (size);
+	const uint32_t heap_start = pool->high_water + pool->misses;
+	struct pgm_sk_buff_t* skb = pgm_skb_pool_alloc (pool, size);
+	perf_allocs += pool->high_water + pool->misses - heap_start;
+	return skb;
+}
+
+static
+int
+perf_sendto (
+	SOCKET			s,
+	const char*		buf,
+	int			len,
+	int			flags,
+	const struct sockaddr*	to,
+	int			tolen
+	)
+{
+	(void)s; (void)buf; (void)flags; (void)to; (void)tolen;
+	return len;
+}
+
+#ifndef _WIN32
+/* copy one pre-built datagram with the destination address, as enabled by
+ * IP_PKTINFO for UDP encapsulation.
+ */
+
+static
+ssize_t
+perf_fill_msghdr (
+	struct msghdr*	msg
+	)
+{
+	if (perf_rx_next == perf_rx_limit) {
+		pgm_set_last_sock_error (PGM_SOCK_EAGAIN);
+		return SOCKET_ERROR;
+	}
+
+	const unsigned i = perf_rx_next++;
+	struct sockaddr_in src;
+	memset (&src, 0, sizeof(src));
+	src.sin_family		= AF_INET;
+	src.sin_addr.s_addr	= htonl (PERF_SRC_ADDR);
+	memcpy (msg->msg_name, &src, sizeof(src));
+	msg->msg_namelen	= sizeof(src);
+	memcpy (msg->msg_iov[0].iov_base, perf_rx_tpdu[i], perf_rx_len[i]);
+
+	struct in_pktinfo pktinfo;
+	memset (&pktinfo, 0, sizeof(pktinfo));
+	pktinfo.ipi_addr.s_addr	= htonl (PERF_GROUP_ADDR);
+	struct cmsghdr* cmsg	= CMSG_FIRSTHDR (msg);
+	cmsg->cmsg_level	= IPPROTO_IP;
+	cmsg->cmsg_type		= IP_PKTINFO;
+	cmsg->cmsg_len		= CMSG_LEN (sizeof(pktinfo));
+	memcpy (CMSG_DATA (cmsg), &pktinfo, sizeof(pktinfo));
+	msg->msg_controllen	= CMSG_SPACE (sizeof(pktinfo));
+	msg->msg_flags		= 0;
+	return perf_rx_len[i];
+}
+
+static
+ssize_t
+perf_recvmsg (
+	int		s,
+	struct msghdr*	msg,
+	int		flags
+	)
+{
+	(void)s; (void)flags;
+	return perf_fill_msghdr (msg);
+}
+
+#	ifdef HAVE_RECVMMSG
+static
+int
+perf_recvmmsg (
+	int			s,
+	struct mmsghdr*		msgvec,
+	unsigned		vlen,
+	int			flags,
+	struct timespec*	timeout
+	)
+{
+	unsigned count = 0;
+
+	(void)s; (void)flags; (void)timeout;
+	while (count < vlen && perf_rx_next != perf_rx_limit) {
+		msgvec[count].msg_len = (unsigned)perf_fill_msghdr (&msgvec[count].msg_hdr);
+		count++;
+	}
+	if (0 == count) {
+		pgm_set_last_sock_error (PGM_SOCK_EAGAIN);
+		return SOCKET_ERROR;
+	}
+	return (int)count;
+}
+#	endif /* HAVE_RECVMMSG */
+#endif /* !_WIN32 */
+
+/* hardware cache miss counter for the calling thread, -1 when unavailable.
+ */
+
+static
+int
+perf_cache_open (void)
+{
+#ifdef __linux__
+	struct perf_event_attr attr;
+	memset (&attr, 0, sizeof(attr));
+	attr.size		= sizeof(attr);
+	attr.type		= PERF_TYPE_HARDWARE;
+	attr.config		= PERF_COUNT_HW_CACHE_MISSES;
+	attr.disabled		= 1;
+	attr.exclude_kernel	= 1;
+	attr.exclude_hv		= 1;
+	return (int)syscall (__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+	return -1;
+#endif
+}
+
+static
+void
+perf_cache_enable (
+	const int	fd,
+	const bool	enable
+	)
+{
+#ifdef __linux__
+	if (-1 != fd)
+		ioctl (fd, enable ? PERF_EVENT_IOC_ENABLE : PERF_EVENT_IOC_DISABLE, 0);
+#else
+	(void)fd; (void)enable;
+#endif
+}
+
+static
+bool
+perf_cache_read (
+	const int	fd,
+	uint64_t*	count
+	)
+{
+#ifdef __linux__
+	if (-1 != fd && sizeof(*count) == read (fd, count, sizeof(*count)))
+		return TRUE;
+#else
+	(void)fd; (void)count;
+#endif
+	return FALSE;
+}
+
+static
+void
+perf_cache_close (
+	const int	fd
+	)
+{
+#ifdef __linux__
+	if (-1 != fd)
+		close (fd);
+#else
+	(void)fd;
+#endif
+}
+
+/* write checksummed ODATA, or RDATA carrying on-demand parity, for one
+ * arrival.
+ *
+ * returns TPDU length.
+ */
+
+static
+uint16_t
+generate_tpdu (
+	const struct perf_arrival_t*	arrival,
+	char*				buf
+	)
+{
+	const pgm_gsi_t gsi = { { 1, 2, 3, 4, 5, 6 } };
+	const uint16_t tpdu_length = sizeof(struct pgm_header) + sizeof(struct pgm_data) + PERF_TSDU;
+	struct pgm_header* header = (struct pgm_header*)buf;
+	struct pgm_data* data = (struct pgm_data*)(header + 1);
+
+	memset (header, 0, sizeof(struct pgm_header) + sizeof(struct pgm_data));
+	memcpy (&header->pgm_gsi, &gsi, sizeof(gsi));
+	header->pgm_sport	= pgm_htons (PERF_SPORT);
+	header->pgm_dport	= pgm_htons (PERF_DPORT);
+	header->pgm_type	= PGM_ODATA;
+	header->pgm_tsdu_length	= pgm_htons (PERF_TSDU);
+	if (arrival->is_parity) {
+		header->pgm_type	= PGM_RDATA;
+		header->pgm_options	= PGM_OPT_PARITY;
+	}
+	data->data_sqn		= pgm_htonl (arrival->sequence);
+	data->data_trail	= 0;
+	memset (data + 1, 'x', PERF_TSDU);
+	header->pgm_checksum	= pgm_csum_fold (pgm_csum_partial (buf, tpdu_length, 0));
+	return tpdu_length;
+}
+
+/* SPM opening the session before any data, advertising parity for the FEC
+ * pattern as a source with proactive and on-demand parity enabled.
+ *
+ * returns TPDU length.
+ */
+
+static
+uint16_t
+generate_spm (
+	const bool	use_fec,
+	char*		buf
+	)
+{
+	const pgm_gsi_t gsi = { { 1, 2, 3, 4, 5, 6 } };
+	struct pgm_header* header = (struct pgm_header*)buf;
+	struct pgm_spm* spm = (struct pgm_spm*)(header + 1);
+	uint16_t tpdu_length = sizeof(struct pgm_header) + sizeof(struct pgm_spm);
+
+	memset (buf, 0, PERF_MAX_TPDU);
+	memcpy (&header->pgm_gsi, &gsi, sizeof(gsi));
+	header->pgm_sport	= pgm_htons (PERF_SPORT);
+	header->pgm_dport	= pgm_htons (PERF_DPORT);
+	header->pgm_type	= PGM_SPM;
+	spm->spm_sqn		= 0;
+	spm->spm_trail		= 0;
+	spm->spm_lead		= pgm_htonl (UINT32_MAX);	/* empty, first data is 0 */
+	spm->spm_nla_afi	= pgm_htons (AFI_IP);
+	spm->spm_nla.s_addr	= pgm_htonl (PERF_SRC_ADDR);
+	if (use_fec) {
+		struct pgm_opt_length* opt_len = (struct pgm_opt_length*)(spm + 1);
+		struct pgm_opt_header* opt_header = (struct pgm_opt_header*)(opt_len + 1);
+		struct pgm_opt_parity_prm* opt_parity_prm = (struct pgm_opt_parity_prm*)(opt_header + 1);
+		const uint16_t opt_total_length = sizeof(struct pgm_opt_length) +
+						  sizeof(struct pgm_opt_header) +
+						  sizeof(struct pgm_opt_parity_prm);
+		header->pgm_options		= PGM_OPT_PRESENT | PGM_OPT_NETWORK;
+		opt_len->opt_type		= PGM_OPT_LENGTH;
+		opt_len->opt_length		= sizeof(struct pgm_opt_length);
+		opt_len->opt_total_length	= pgm_htons (opt_total_length);
+		opt_header->opt_type		= PGM_OPT_PARITY_PRM | PGM_OPT_END;
+		opt_header->opt_length		= sizeof(struct pgm_opt_header) + sizeof(struct pgm_opt_parity_prm);
+		opt_parity_prm->opt_reserved	= PGM_PARITY_PRM_PRO | PGM_PARITY_PRM_OND;
+		opt_parity_prm->parity_prm_tgs	= pgm_htonl (PERF_RS_K);
+		tpdu_length += opt_total_length;
+	}
+	header->pgm_checksum	= pgm_csum_fold (pgm_csum_partial (buf, tpdu_length, 0));
+	return tpdu_length;
+}
+
+/* skb holding a copy of a datagram with the PGM header parsed and the data
+ * pointer at the ODATA/RDATA header, as passed to pgm_on_data().
+ */
+
+static
+struct pgm_sk_buff_t*
+generate_skb (
+	pgm_sock_t* const	sock,
+	const char*		tpdu,
+	const uint16_t		tpdu_length
+	)
+{
+	struct pgm_sk_buff_t* skb = pgm_alloc_skb (PERF_MAX_TPDU);
+	skb->sock	= sock;
+	skb->tstamp	= pgm_time_update_now();
+	memcpy (skb->head, tpdu, tpdu_length);
+	pgm_skb_put (skb, tpdu_length);
+	skb->pgm_header	= (struct pgm_header*)skb->head;
+	memcpy (&skb->tsi.gsi, &skb->pgm_header->pgm_gsi, sizeof(pgm_gsi_t));
+	skb->tsi.sport	= skb->pgm_header->pgm_sport;
+	pgm_skb_pull (skb, sizeof(struct pgm_header));
+	skb->pgm_data	= skb->data;
+	return skb;
+}
+
+/* arrival order of one round of sequences for the pattern, lost packets are
+ * repaired PERF_REPAIR_DELAY packets later either by RDATA or, for FEC, by
+ * one on-demand parity packet for the group.
+ *
+ * returns count of arrivals.
+ */
+
+static
+unsigned
+generate_schedule (
+	const int		pattern,
+	const uint32_t		first,
+	struct perf_arrival_t*	schedule
+	)
+{
+	static struct perf_arrival_t repair[ PERF_PACKETS ];
+	static unsigned repair_due[ PERF_PACKETS ];
+	unsigned n = 0, head = 0, tail = 0;
+	unsigned j = first;
+
+	for (unsigned i = 0; i < PERF_PACKETS; i++)
+	{
+		const uint32_t sequence = first + i;
+		bool is_lost = FALSE;
+
+		j = j * 1103515245 + 12345;
+/* first packet of a session defines the window */
+		switch (0 == sequence ? PERF_IN_ORDER : pattern) {
+		case PERF_RANDOM_LOSS:
+			is_lost = (0 == (j >> 16) % 100);
+			break;
+		case PERF_BURST_LOSS:
+			is_lost = ((i % 1024) >= 512 && (i % 1024) < 528);
+			break;
+		case PERF_REORDER:
+			if (0 == (j >> 16) % 10 && (i + 1) < PERF_PACKETS) {
+				schedule[n].sequence = sequence + 1;
+				schedule[n++].is_parity = FALSE;
+				schedule[n].sequence = sequence;
+				schedule[n++].is_parity = FALSE;
+				i++;
+				continue;
+			}
+			break;
+		case PERF_FEC:
+/* one erasure in every fourth transmission group, the first packet of a
+ * group carries the fixed length and is not recoverable.
+ */
+			if (0 == (i / PERF_RS_K) % 4 &&
+			    (i % PERF_RS_K) == 1 + ((i / PERF_RS_K / 4) % (PERF_RS_K - 1)))
+			{
+				is_lost = TRUE;
+			}
+			break;
+		default: break;
+		}
+
+		if (is_lost) {
+			if (PERF_FEC == pattern) {
+				repair[tail].sequence = sequence - (i % PERF_RS_K);	/* tg_sqn | h, h = 0 */
+				repair[tail].is_parity = TRUE;
+			} else {
+				repair[tail].sequence = sequence;
+				repair[tail].is_parity = FALSE;
+			}
+			repair_due[tail++] = i + PERF_REPAIR_DELAY;
+		} else {
+			schedule[n].sequence = sequence;
+			schedule[n++].is_parity = FALSE;
+		}
+
+		while (head != tail && repair_due[head] <= i)
+			schedule[n++] = repair[head++];
+	}
+	while (head != tail)
+		schedule[n++] = repair[head++];
+	return n;
+}
+
+/* commit all contiguous APDUs of a bare window to the application and
+ * release them.
+ *
+ * returns count of messages delivered.
+ */
+
+static
+unsigned
+drain_window (
+	pgm_rxw_t* const	window
+	)
+{
+	struct pgm_msgv_t msgv[ PERF_BATCH ], *pmsg;
+	unsigned delivered = 0;
+
+	for (;;) {
+		pmsg = msgv;
+		if (-1 == pgm_rxw_readv (window, &pmsg, PGM_N_ELEMENTS(msgv)))
+			break;
+		delivered += (unsigned)(pmsg - msgv);
+		pgm_rxw_remove_commit (window);
+	}
+	return delivered;
+}
+
+/* flush pending peers as pgm_recvmsgv() does, committed APDUs are released
+ * on the following flush.
+ *
+ * returns count of messages delivered.
+ */
+
+static
+unsigned
+drain_peers (
+	pgm_sock_t* const	sock
+	)
+{
+	struct pgm_msgv_t msgv[ PERF_BATCH ], *pmsg;
+	const struct pgm_msgv_t* msg_end = msgv + PGM_N_ELEMENTS(msgv) - 1;
+	unsigned delivered = 0;
+	int status;
+
+	do {
+		size_t bytes_read = 0;
+		unsigned data_read = 0;
+		if (0 == ++(sock->last_commit))
+			++(sock->last_commit);
+		pmsg = msgv;
+		status = pgm_flush_peers_pending (sock, &pmsg, msg_end, &bytes_read, &data_read);
+		delivered += (unsigned)(pmsg - msgv);
+	} while (-PGM_SOCK_ENOBUFS == status);
+	return delivered;
+}
+
+/* read until the network stub would block.
+ *
+ * returns count of messages delivered, or -1 on error.
+ */
+
+static
+int
+drain_socket (
+	pgm_sock_t* const	sock
+	)
+{
+	struct pgm_msgv_t msgv[ PERF_BATCH ];
+	pgm_error_t* pgm_err = NULL;
+	unsigned delivered = 0;
+	size_t bytes_read;
+	int status;
+
+	do {
+		bytes_read = 0;
+		status = pgm_recvmsgv (sock, msgv, PGM_N_ELEMENTS(msgv), MSG_DONTWAIT, &bytes_read, &pgm_err);
+		delivered += (unsigned)(bytes_read / PERF_TSDU);
+	} while (PGM_IO_STATUS_NORMAL == status);
+
+	switch (status) {
+	case PGM_IO_STATUS_WOULD_BLOCK:
+	case PGM_IO_STATUS_TIMER_PENDING:
+	case PGM_IO_STATUS_RATE_LIMITED:
+		return (int)delivered;
+	default:
+		fprintf (stderr, "pgm_recvmsgv returned status %d: %s\n",
+			 status, (NULL != pgm_err && NULL != pgm_err->message) ? pgm_err->message : "(null)");
+		if (NULL != pgm_err)
+			pgm_error_free (pgm_err);
+		return -1;
+	}
+}
+
+static
+pgm_sock_t*
+perf_create_sock (void)
+{
+	struct pgm_addrinfo_t* res = NULL;
+	pgm_error_t* pgm_err = NULL;
+	pgm_sock_t* sock = NULL;
+
+	if (!pgm_getaddrinfo (PERF_NETWORK, NULL, &res, &pgm_err)) {
+		fprintf (stderr, "Parsing network parameter: %s\n", pgm_err->message);
+		goto err_abort;
+	}
+	if (!pgm_socket (&sock, AF_INET, SOCK_SEQPACKET, IPPROTO_UDP, &pgm_err)) {
+		fprintf (stderr, "Creating PGM/UDP socket: %s\n", pgm_err->message);
+		goto err_abort;
+	}
+
+	const int recv_only = 1,
+		  passive = 0,
+		  max_tpdu = PERF_MAX_TPDU,
+		  sqns = PERF_RXW_SQNS,
+		  encap_port = PERF_UDP_ENCAP_PORT,
+		  peer_expiry = pgm_secs (300),
+		  spmr_expiry = pgm_msecs (250),
+		  nak_bo_ivl = pgm_msecs (50),
+		  nak_rpt_ivl = pgm_secs (2),
+		  nak_rdata_ivl = pgm_secs (2),
+		  nak_data_retries = 50,
+		  nak_ncf_retries = 50,
+		  blocking = 0;
+#ifdef HAVE_RECVMMSG
+	const int batch = PERF_BATCH;
+	pgm_setsockopt (sock, IPPROTO_PGM, PGM_RECV_BATCH, &batch, sizeof(batch));
+#endif
+
+	pgm_setsockopt (sock, IPPROTO_PGM, PGM_UDP_ENCAP_UCAST_PORT, &encap_port, sizeof(encap_port));
+	pgm_setsockopt (sock, IPPROTO_PGM, PGM_UDP_ENCAP_MCAST_PORT, &encap_port, sizeof(encap_port));
+	pgm_setsockopt (sock, IPPROTO_PGM, PGM_RECV_ONLY, &recv_only, sizeof(recv_only));
+	pgm_setsockopt (sock, IPPROTO_PGM, PGM_PASSIVE, &passive, sizeof(passive));
+	pgm_setsockopt (sock, IPPROTO_PGM, PGM_MTU, &max_tpdu, sizeof(max_tpdu));
+	pgm_setsockopt (sock, IPPROTO_PGM, PGM_RXW_SQNS, &sqns, sizeof(sqns));
+	pgm_setsockopt (sock, IPPROTO_PGM, PGM_PEER_EXPIRY, &peer_expiry, sizeof(peer_expiry));
+	pgm_setsockopt (sock, IPPROTO_PGM, PGM_SPMR_EXPIRY, &spmr_expiry, sizeof(spmr_expiry));
+	pgm_setsockopt (sock, IPPROTO_PGM, PGM_NAK_BO_IVL, &nak_bo_ivl, sizeof(nak_bo_ivl));
+	pgm_setsockopt (sock, IPPROTO_PGM, PGM_NAK_RPT_IVL, &nak_rpt_ivl, sizeof(nak_rpt_ivl));
+	pgm_setsockopt (sock, IPPROTO_PGM, PGM_NAK_RDATA_IVL, &nak_rdata_ivl, sizeof(nak_rdata_ivl));
+	pgm_setsockopt (sock, IPPROTO_PGM, PGM_NAK_DATA_RETRIES, &nak_data_retries, sizeof(nak_data_retries));
+	pgm_setsockopt (sock, IPPROTO_PGM, PGM_NAK_NCF_RETRIES, &nak_ncf_retries, sizeof(nak_ncf_retries));
+
+	struct pgm_sockaddr_t addr;
+	memset (&addr, 0, sizeof(addr));
+	addr.sa_port = PERF_DPORT;
+	addr.sa_addr.sport = 0;
+	if (!pgm_gsi_create_from_hostname (&addr.sa_addr.gsi, &pgm_err)) {
+		fprintf (stderr, "Creating GSI: %s\n", pgm_err->message);
+		goto err_abort;
+	}
+	struct pgm_interface_req_t if_req;
+	memset (&if_req, 0, sizeof(if_req));
+	if_req.ir_interface = res->ai_recv_addrs[0].gsr_interface;
+	memcpy (&if_req.ir_address, &res->ai_send_addrs[0].gsr_addr, sizeof(struct sockaddr_storage));
+	if (!pgm_bind3 (sock,
+			&addr, sizeof(addr),
+			&if_req, sizeof(if_req),	/* tx interface */
+			&if_req, sizeof(if_req),	/* rx interface */
+			&pgm_err))
+	{
+		fprintf (stderr, "Binding PGM socket: %s\n", pgm_err->message);
+		goto err_abort;
+	}
+	for (unsigned i = 0; i < res->ai_recv_addrs_len; i++)
+		pgm_setsockopt (sock, IPPROTO_PGM, PGM_JOIN_GROUP, &res->ai_recv_addrs[i], sizeof(struct pgm_group_source_req));
+	pgm_setsockopt (sock, IPPROTO_PGM, PGM_SEND_GROUP, &res->ai_send_addrs[0], sizeof(struct pgm_group_source_req));
+	pgm_setsockopt (sock, IPPROTO_PGM, PGM_NOBLOCK, &blocking, sizeof(blocking));
+	pgm_freeaddrinfo (res);
+	res = NULL;
+
+	if (!pgm_connect (sock, &pgm_err)) {
+		fprintf (stderr, "Connecting PGM socket: %s\n", pgm_err->message);
+		goto err_abort;
+	}
+	return sock;
+
+err_abort:
+	if (NULL != sock)
+		pgm_close (sock, FALSE);
+	if (NULL != res)
+		pgm_freeaddrinfo (res);
+	if (NULL != pgm_err)
+		pgm_error_free (pgm_err);
+	return NULL;
+}
+
+/* deliver PERF_ROUNDS of the arrival pattern through one API.
+ *
+ * returns elapsed time in microseconds, or -1 on error.
+ */
+
+static
+int64_t
+perf_run (
+	const int	api,
+	const int	pattern,
+	unsigned*	packets,
+	unsigned*	allocs,
+	int64_t*	cache_misses
+	)
+{
+	const pgm_gsi_t gsi = { { 1, 2, 3, 4, 5, 6 } };
+	struct perf_arrival_t* schedule = malloc (2 * PERF_PACKETS * sizeof(struct perf_arrival_t));
+	struct pgm_sk_buff_t** skbs = malloc (2 * PERF_PACKETS * sizeof(struct pgm_sk_buff_t*));
+	char* tpdus = malloc (2 * PERF_PACKETS * PERF_MAX_TPDU);
+	pgm_rxw_t* window = NULL;
+	pgm_sock_t* sock = NULL;
+	pgm_peer_t* peer = NULL;
+	pgm_time_t elapsed = 0;
+	unsigned delivered = 0;
+	uint64_t misses;
+	int64_t retval = -1;
+
+	pgm_tsi_t tsi;
+	memcpy (&tsi.gsi, &gsi, sizeof(gsi));
+	tsi.sport = pgm_htons (PERF_SPORT);
+	*packets = *allocs = 0;
+	*cache_misses = -1;
+
+	switch (api) {
+	case PERF_RXW:
+		window = pgm_rxw_create (&tsi, PERF_MAX_TPDU, PERF_RXW_SQNS, 0, 0, 500);
+		if (PERF_FEC == pattern)
+			pgm_rxw_update_fec (window, PERF_RS_K);
+		break;
+	case PERF_ON_DATA:
+	case PERF_RECVMSGV:
+		sock = perf_create_sock ();
+		if (NULL == sock)
+			goto cleanup;
+		break;
+	default: break;
+	}
+
+	if (PERF_ON_DATA == api) {
+		struct sockaddr_in src, dst;
+		memset (&src, 0, sizeof(src));
+		src.sin_family		= AF_INET;
+		src.sin_addr.s_addr	= pgm_htonl (PERF_SRC_ADDR);
+		memcpy (&dst, &src, sizeof(dst));
+		dst.sin_addr.s_addr	= pgm_htonl (PERF_GROUP_ADDR);
+		peer = pgm_new_peer (sock, &tsi, (struct sockaddr*)&src, sizeof(src), (struct sockaddr*)&dst, sizeof(dst), pgm_time_update_now());
+		if (PERF_FEC == pattern) {
+			peer->is_fec_enabled = 1;
+			pgm_rxw_update_fec (peer->window, PERF_RS_K);
+		}
+	} else if (PERF_RECVMSGV == api) {
+/* open the session outside of the measurement */
+		perf_rx_len[0] = generate_spm (PERF_FEC == pattern, tpdus);
+		perf_rx_tpdu[0] = tpdus;
+		perf_rx_next = 0;
+		perf_rx_limit = 1;
+		if (drain_socket (sock) < 0)
+			goto cleanup;
+	}
+
+	const int fd = perf_cache_open ();
+	for (unsigned round = 0; round < PERF_ROUNDS; round++)
+	{
+		const unsigned count = generate_schedule (pattern, round * PERF_PACKETS, schedule);
+		for (unsigned i = 0; i < count; i++) {
+			perf_rx_tpdu[i] = tpdus + (i * PERF_MAX_TPDU);
+			perf_rx_len[i] = generate_tpdu (&schedule[i], perf_rx_tpdu[i]);
+			if (PERF_RECVMSGV != api)
+				skbs[i] = generate_skb (sock, perf_rx_tpdu[i], perf_rx_len[i]);
+		}
+		if (PERF_RXW == api) {
+/* window receives the payload, parsing is left to the caller */
+			for (unsigned i = 0; i < count; i++)
+				pgm_skb_pull (skbs[i], sizeof(struct pgm_data));
+		}
+		perf_rx_next = perf_rx_limit = 0;
+
+		const unsigned allocs_start = perf_allocs;
+		perf_cache_enable (fd, TRUE);
+		const pgm_time_t start = pgm_time_update_now();
+		for (unsigned i = 0; i < count; i += PERF_BATCH)
+		{
+			const unsigned batch_end = (i + PERF_BATCH) < count ? (i + PERF_BATCH) : count;
+			int status;
+
+			switch (api) {
+			case PERF_RXW:
+				for (unsigned k = i; k < batch_end; k++)
+					switch (pgm_rxw_add (window, skbs[k], 1, 2)) {
+					case PGM_RXW_MISSING:
+					case PGM_RXW_INSERTED:
+					case PGM_RXW_APPENDED:
+						break;
+					default:
+						pgm_free_skb (skbs[k]);
+						break;
+					}
+				delivered += drain_window (window);
+				break;
+
+			case PERF_ON_DATA:
+				for (unsigned k = i; k < batch_end; k++) {
+					if (!pgm_on_data (sock, peer, skbs[k]))
+						pgm_free_skb (skbs[k]);
+					else if (pgm_peer_has_pending (peer))
+						pgm_peer_set_pending (sock, peer);
+				}
+				delivered += drain_peers (sock);
+				break;
+
+			case PERF_RECVMSGV:
+				perf_rx_limit = batch_end;
+				status = drain_socket (sock);
+				if (status < 0) {
+					perf_cache_enable (fd, FALSE);
+					perf_cache_close (fd);
+					goto cleanup;
+				}
+				delivered += (unsigned)status;
+				break;
+
+			default: break;
+			}
+		}
+		elapsed += pgm_time_update_now() - start;
+		perf_cache_enable (fd, FALSE);
+		*allocs += perf_allocs - allocs_start;
+		*packets += count;
+	}
+	if (perf_cache_read (fd, &misses))
+		*cache_misses = (int64_t)misses;
+	perf_cache_close (fd);
+
+	if ((PERF_ROUNDS * PERF_PACKETS) != delivered) {
+		fprintf (stderr, "%s %s delivered %u of %u messages.\n",
+			 perf_api_name[api], perf_pattern_name[pattern], delivered, PERF_ROUNDS * PERF_PACKETS);
+		goto cleanup;
+	}
+	retval = (int64_t)elapsed;
+
+cleanup:
+	if (NULL != window)
+		pgm_rxw_destroy (window);
+	if (NULL != sock)
+		pgm_close (sock, FALSE);
+	free (tpdus);
+	free (skbs);
+	free (schedule);
+	return retval;
+}
+
+int
+main (void)
+{
+	pgm_error_t* pgm_err = NULL;
+	int retval = EXIT_SUCCESS;
+
+	if (!pgm_init (&pgm_err)) {
+		fprintf (stderr, "Unable to start PGM engine: %s\n", pgm_err->message);
+		pgm_error_free (pgm_err);
+		return EXIT_FAILURE;
+	}
+	priv_sendto = &perf_sendto;
+
+	printf ("api,pattern,packets,elapsed_us,packets_per_sec,ns_per_packet,allocs_per_packet,cache_misses_per_packet\n");
+	for (int api = 0; api < PERF_API_MAX; api++)
+	{
+#ifdef _WIN32
+		if (PERF_RECVMSGV == api)
+			continue;
+#endif
+		for (int pattern = 0; pattern < PERF_PATTERN_MAX; pattern++)
+		{
+			unsigned packets, allocs;
+			int64_t cache_misses;
+			const int64_t elapsed = perf_run (api, pattern, &packets, &allocs, &cache_misses);
+			if (elapsed < 0) {
+				retval = EXIT_FAILURE;
+				goto cleanup;
+			}
+			printf ("%s,%s,%u,%" PRIi64 ",%.0f,%.1f,%.3f,%.2f\n",
+				perf_api_name[api],
+				perf_pattern_name[pattern],
+				packets,
+				elapsed,
+				elapsed > 0 ? (1e6 * packets) / elapsed : 0.0,
+				packets > 0 ? (1e3 * elapsed) / packets : 0.0,
+				packets > 0 ? (double)allocs / packets : 0.0,
+				cache_misses >= 0 && packets > 0 ? (double)cache_misses / packets : -1.0);
+			fflush (stdout);
+		}
+	}
+
+cleanup:
+	pgm_shutdown ();
+	return retval;
+}
+
+/* eof */
@@ -139,6 +139,60 @@ generate_valid_skb (void)
 	return skb;
 }
 
+/* generate on-demand parity skb for transmission group sequence, the reed-solomon
+ * codec is mocked so the payload is not significant.
+ */
+static
+struct pgm_sk_buff_t*
+generate_parity_skb (
+	const uint32_t		sequence
+	)
+{
+	struct pgm_sk_buff_t* skb = generate_valid_skb ();
+	skb->pgm_header->pgm_type = PGM_RDATA;
+	skb->pgm_header->pgm_options = PGM_OPT_PARITY;
+	skb->pgm_data->data_sqn = g_htonl (sequence);
+	return skb;
+}
+
+/* window with a transmission group size of 4, the mocked codec does not
+ * configure the reed-solomon parameters.
+ */
+static
+pgm_rxw_t*
+create_fec_window (
+	const pgm_tsi_t*	tsi
+	)
+{
+	const uint32_t ack_c_p = 500;
+	pgm_rxw_t* window = pgm_rxw_create (tsi, 1500, 100, 0, 0, ack_c_p);
+	pgm_rxw_update_fec (window, 4);
+	window->rs.n = PGM_RS_DEFAULT_N;
+	window->rs.k = window->tg_size = 4;
+	return window;
+}
+
+/* add original data #first to #last inclusive skipping #skip */
+static
+void
+add_valid_skbs (
+	pgm_rxw_t*		window,
+	const uint32_t		first,
+	const uint32_t		last,
+	const uint32_t		skip
+	)
+{
+	const pgm_time_t now = 1;
+	const pgm_time_t nak_rb_expiry = 2;
+	for (uint32_t i = first; i <= last; i++) {
+		if (i == skip) continue;
+		struct pgm_sk_buff_t* skb = generate_valid_skb ();
+		skb->pgm_data->data_sqn = g_htonl (i);
+		const int status = pgm_rxw_add (window, skb, now, nak_rb_expiry);
+		fail_unless (PGM_RXW_APPENDED == status || PGM_RXW_MISSING == status, "add failed");
+	}
+}
+
 /* target:
  *	pgm_rxw_t*
  *	pgm_rxw_create (
@@ -515,6 +569,8 @@ START_TEST (test_max_length_pass_001)
 	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, window_length, 0, 0, ack_c_p);
 	fail_if (NULL == window, "create failed");
 	fail_unless (window_length == pgm_rxw_max_length (window), "max_length failed");
+/* slot array starts small */
+	fail_unless (PGM_RXW_MIN_SLOTS - 1 == window->mask, "max_length failed");
 	pgm_rxw_destroy (window);
 }
 END_TEST
@@ -1109,6 +1165,67 @@ START_TEST (test_remove_commit_pass_001)
 }
 END_TEST
 
+/* slot arrays grow with occupancy keeping queue order and shrink once read */
+START_TEST (test_remove_commit_pass_002)
+{
+	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	const uint32_t ack_c_p = 500;
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	fail_if (NULL == window, "create failed");
+	fail_unless (PGM_RXW_MIN_SLOTS - 1 == window->mask, "mask failed");
+	const size_t reserved = pgm_rxw_reserved (window);
+	struct pgm_msgv_t msgv[1], *pmsg;
+	struct pgm_sk_buff_t* skb;
+	const pgm_time_t now = 1;
+	const pgm_time_t nak_rb_expiry = 2;
+/* #0, #20, then #1-#19 are missing */
+	skb = generate_valid_skb ();
+	skb->pgm_data->data_sqn = g_htonl (0);
+	fail_unless (PGM_RXW_APPENDED == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not appended");
+	skb = generate_valid_skb ();
+	skb->pgm_data->data_sqn = g_htonl (20);
+	fail_unless (PGM_RXW_MISSING == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not missing");
+	pgm_rxw_state (window, 5, PGM_PKT_STATE_WAIT_NCF);
+	pgm_rxw_state (window, 10, PGM_PKT_STATE_WAIT_NCF);
+	pgm_rxw_state (window, 15, PGM_PKT_STATE_WAIT_DATA);
+/* #70 grows window twice */
+	skb = generate_valid_skb ();
+	skb->pgm_data->data_sqn = g_htonl (70);
+	fail_unless (PGM_RXW_MISSING == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not missing");
+	fail_unless (127 == window->mask, "mask failed");
+	fail_unless (71 == pgm_rxw_length (window), "length failed");
+	fail_unless (pgm_rxw_reserved (window) > reserved, "reserved failed");
+	fail_unless (71 * PGM_RXW_SLOT_SIZE == pgm_rxw_used (window), "used failed");
+	fail_unless (2 == window->wait_ncf_queue.length, "wait_ncf_queue failed");
+	fail_unless (5 == pgm_rxw_link_sequence (window, window->wait_ncf_queue.tail), "wait_ncf_queue failed");
+	fail_unless (10 == pgm_rxw_link_sequence (window, window->wait_ncf_queue.head), "wait_ncf_queue failed");
+	fail_unless (1 == window->wait_data_queue.length, "wait_data_queue failed");
+	fail_unless (15 == pgm_rxw_link_sequence (window, window->wait_data_queue.tail), "wait_data_queue failed");
+	fail_unless (PGM_PKT_STATE_BACK_OFF == window->pkt_state[ pgm_rxw_index (window, 69) ], "state failed");
+	fail_unless (NULL != pgm_rxw_peek (window, 20), "peek failed");
+/* repair and read everything */
+	for (unsigned i = 1; i < 70; i++)
+	{
+		if (20 == i) continue;
+		skb = generate_valid_skb ();
+		skb->pgm_data->data_sqn = g_htonl (i);
+		fail_unless (PGM_RXW_INSERTED == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not inserted");
+	}
+	for (unsigned i = 0; i <= 70; i++)
+	{
+		pgm_rxw_remove_commit (window);
+		pmsg = msgv;
+		fail_unless (1000 == pgm_rxw_readv (window, &pmsg, G_N_ELEMENTS(msgv)), "readv failed");
+	}
+/* released back to minimum as the trail advanced */
+	pgm_rxw_remove_commit (window);
+	fail_unless (pgm_rxw_is_empty (window), "is_empty failed");
+	fail_unless (PGM_RXW_MIN_SLOTS - 1 == window->mask, "mask failed");
+	fail_unless (reserved == pgm_rxw_reserved (window), "reserved failed");
+	pgm_rxw_destroy (window);
+}
+END_TEST
+
 START_TEST (test_remove_commit_fail_001)
 {
 	pgm_rxw_remove_commit (NULL);
@@ -1302,6 +1419,66 @@ START_TEST (test_confirm_pass_002)
 }
 END_TEST
 
+/* sequence state does not survive reuse of a window slot */
+START_TEST (test_confirm_pass_003)
+{
+	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	const uint32_t ack_c_p = 500;
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 2, 0, 0, ack_c_p);
+	fail_if (NULL == window, "create failed");
+	const pgm_time_t now = 1;
+	const pgm_time_t nak_rb_expiry = 2;
+/* #1 at 100 */
+	struct pgm_sk_buff_t* skb = generate_valid_skb ();
+	fail_if (NULL == skb, "generate_valid_skb failed");
+	skb->pgm_data->data_sqn = g_htonl (100);
+	fail_unless (PGM_RXW_APPENDED == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not appended");
+	fail_unless (PGM_RXW_APPENDED == pgm_rxw_confirm (window, 101, now, 5, nak_rb_expiry), "confirm not appended");
+	const uint_fast32_t index_ = pgm_rxw_index (window, 101);
+	fail_unless (PGM_PKT_STATE_WAIT_DATA == window->pkt_state[index_], "state failed");
+	fail_unless (5 == window->timer_expiry[index_], "timer_expiry failed");
+	window->nak_transmit_count[index_] = 2;
+/* 101 falls out of the window and 103 takes over the slot */
+	fail_unless (PGM_RXW_APPENDED == pgm_rxw_confirm (window, 103, now, 7, nak_rb_expiry), "confirm not appended");
+	fail_unless (index_ == pgm_rxw_index (window, 103), "index failed");
+	fail_unless (PGM_PKT_STATE_WAIT_DATA == window->pkt_state[index_], "state failed");
+	fail_unless (7 == window->timer_expiry[index_], "timer_expiry failed");
+	fail_unless (0 == window->nak_transmit_count[index_], "nak_transmit_count failed");
+	fail_unless (PGM_PKT_STATE_BACK_OFF == window->pkt_state[ pgm_rxw_index (window, 102) ], "state failed");
+	fail_unless (nak_rb_expiry == window->timer_expiry[ pgm_rxw_index (window, 102) ], "timer_expiry failed");
+	pgm_rxw_destroy (window);
+}
+END_TEST
+
+/* confirm past the lead of full slot arrays grows them before the trail is overwritten */
+START_TEST (test_confirm_pass_004)
+{
+	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	const uint32_t ack_c_p = 500;
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	fail_if (NULL == window, "create failed");
+	const pgm_time_t now = 1;
+	const pgm_time_t nak_rdata_expiry = 2;
+	const pgm_time_t nak_rb_expiry = 2;
+	for (unsigned i = 0; i < PGM_RXW_MIN_SLOTS; i++)
+	{
+		struct pgm_sk_buff_t* skb = generate_valid_skb ();
+		fail_if (NULL == skb, "generate_valid_skb failed");
+		skb->pgm_data->data_sqn = g_htonl (i);
+		fail_unless (PGM_RXW_APPENDED == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not appended");
+	}
+	fail_unless (PGM_RXW_MIN_SLOTS == window->mask + 1, "slots failed");
+	fail_unless (PGM_RXW_APPENDED == pgm_rxw_confirm (window, PGM_RXW_MIN_SLOTS, now, nak_rdata_expiry, nak_rb_expiry), "confirm not appended");
+	fail_unless (PGM_RXW_MIN_SLOTS + 1 == pgm_rxw_length (window), "length failed");
+	fail_unless (PGM_RXW_MIN_SLOTS < window->mask + 1, "slots not grown");
+	fail_unless (PGM_PKT_STATE_WAIT_DATA == window->pkt_state[ pgm_rxw_index (window, PGM_RXW_MIN_SLOTS) ], "state failed");
+	fail_unless (NULL != window->pdata[ pgm_rxw_index (window, 0) ], "trail overwritten");
+	struct pgm_msgv_t msgv[PGM_RXW_MIN_SLOTS], *pmsg = msgv;
+	fail_unless (PGM_RXW_MIN_SLOTS * 1000 == pgm_rxw_readv (window, &pmsg, G_N_ELEMENTS(msgv)), "readv failed");
+	pgm_rxw_destroy (window);
+}
+END_TEST
+
 START_TEST (test_confirm_fail_001)
 {
 	int retval = pgm_rxw_confirm (NULL, 0, 0, 0, 0);
@@ -1361,7 +1538,7 @@ END_TEST
  *	void
  *	pgm_rxw_state (
  *		pgm_rxw_t* const	window,
- *		struct pgm_sk_buff_t*	skb,
+ *		const uint32_t		sequence,
  *		int			new_state
  *		)
  */
@@ -1377,19 +1554,17 @@ START_TEST (test_state_pass_001)
 	const pgm_time_t nak_rb_expiry = 2;
 	fail_unless (0 == pgm_rxw_update (window, 100, 99, now, nak_rb_expiry), "update failed");
 	fail_unless (PGM_RXW_APPENDED == pgm_rxw_confirm (window, 101, now, nak_rdata_expiry, nak_rb_expiry), "confirm not appended");
-	struct pgm_sk_buff_t* skb = pgm_rxw_peek (window, 101);
-	pgm_rxw_state (window, skb, PGM_PKT_STATE_WAIT_NCF);
-	pgm_rxw_state (window, skb, PGM_PKT_STATE_WAIT_DATA);
+/* placeholders carry no skb */
+	fail_unless (NULL == pgm_rxw_peek (window, 101), "peek failed");
+	pgm_rxw_state (window, 101, PGM_PKT_STATE_WAIT_NCF);
+	pgm_rxw_state (window, 101, PGM_PKT_STATE_WAIT_DATA);
 	pgm_rxw_destroy (window);
 }
 END_TEST
 
 START_TEST (test_state_fail_001)
 {
-	struct pgm_sk_buff_t* skb = generate_valid_skb ();
-	fail_if (NULL == skb, "generate_valid_skb failed");
-	skb->pgm_data->data_sqn = g_htonl (0);
-	pgm_rxw_state (NULL, skb, PGM_PKT_STATE_BACK_OFF);
+	pgm_rxw_state (NULL, 0, PGM_PKT_STATE_BACK_OFF);
 	fail ("reached");
 }
 END_TEST
@@ -1400,7 +1575,8 @@ START_TEST (test_state_fail_002)
 	const uint32_t ack_c_p = 500;
 	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
 	fail_if (NULL == window, "create failed");
-	pgm_rxw_state (window, NULL, PGM_PKT_STATE_BACK_OFF);
+/* sequence outside window */
+	pgm_rxw_state (window, 0, PGM_PKT_STATE_BACK_OFF);
 	fail ("reached");
 }
 END_TEST
@@ -1411,10 +1587,89 @@ START_TEST (test_state_fail_003)
 	const uint32_t ack_c_p = 500;
 	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
 	fail_if (NULL == window, "create failed");
-	struct pgm_sk_buff_t* skb = generate_valid_skb ();
-	fail_if (NULL == skb, "generate_valid_skb failed");
-	skb->pgm_data->data_sqn = g_htonl (0);
-	pgm_rxw_state (window, skb, -1);
+	const pgm_time_t now = 1;
+	const pgm_time_t nak_rb_expiry = 2;
+	fail_unless (0 == pgm_rxw_update (window, 100, 99, now, nak_rb_expiry), "update failed");
+	fail_unless (1 == pgm_rxw_update (window, 101, 99, now, nak_rb_expiry), "update failed");
+	pgm_rxw_state (window, 101, -1);
+	fail ("reached");
+}
+END_TEST
+
+/* target:
+ *	bool
+ *	pgm_rxw_find_backoff (
+ *		const pgm_rxw_t* const	window,
+ *		uint32_t		sequence,
+ *		uint32_t*		found
+ *		)
+ */
+
+START_TEST (test_find_backoff_pass_001)
+{
+	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	const uint32_t ack_c_p = 500;
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 100, 0, 0, ack_c_p);
+	fail_if (NULL == window, "create failed");
+	const pgm_time_t now = 1;
+	const pgm_time_t nak_rdata_expiry = 2;
+	const pgm_time_t nak_rb_expiry = 2;
+	uint32_t sequence;
+	fail_if (pgm_rxw_find_backoff (window, 0, &sequence), "find_backoff failed");
+	fail_unless (0 == pgm_rxw_update (window, 100, 99, now, nak_rb_expiry), "update failed");
+	fail_unless (5 == pgm_rxw_update (window, 105, 99, now, nak_rb_expiry), "update failed");
+	fail_unless (5 == window->nak_backoff_count, "update failed");
+/* search before trail starts at trail */
+	fail_unless (pgm_rxw_find_backoff (window, 0, &sequence), "find_backoff failed");
+	fail_unless (101 == sequence, "find_backoff failed");
+	fail_unless (PGM_RXW_UPDATED == pgm_rxw_confirm (window, 102, now, nak_rdata_expiry, nak_rb_expiry), "confirm failed");
+	pgm_rxw_lost (window, 103);
+	fail_unless (3 == window->nak_backoff_count, "confirm failed");
+	fail_unless (pgm_rxw_find_backoff (window, 102, &sequence), "find_backoff failed");
+	fail_unless (104 == sequence, "find_backoff failed");
+	fail_unless (pgm_rxw_find_backoff (window, 105, &sequence), "find_backoff failed");
+	fail_unless (105 == sequence, "find_backoff failed");
+	fail_if (pgm_rxw_find_backoff (window, 106, &sequence), "find_backoff failed");
+	pgm_rxw_destroy (window);
+}
+END_TEST
+
+/* scan across bitmap words and the slot wrap */
+START_TEST (test_find_backoff_pass_002)
+{
+	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	const uint32_t ack_c_p = 500;
+	pgm_rxw_t* window = pgm_rxw_create (&tsi, 1500, 40, 0, 0, ack_c_p);
+	fail_if (NULL == window, "create failed");
+	const pgm_time_t now = 1;
+	const pgm_time_t nak_rb_expiry = 2;
+	uint32_t sequence = 0;
+	fail_unless (0 == pgm_rxw_update (window, 30, 29, now, nak_rb_expiry), "update failed");
+	fail_unless (40 == pgm_rxw_update (window, 70, 29, now, nak_rb_expiry), "update failed");
+	unsigned count = 0;
+	for (bool found = pgm_rxw_find_backoff (window, 31, &sequence);
+	     found;
+	     found = pgm_rxw_find_backoff (window, sequence + 1, &sequence))
+	{
+		fail_unless (31 + count == sequence, "find_backoff failed");
+		count++;
+	}
+	fail_unless (40 == count, "find_backoff failed");
+	for (uint32_t i = 31; i < 70; i++)
+		if (45 != i)
+			pgm_rxw_lost (window, i);
+	fail_unless (pgm_rxw_find_backoff (window, 31, &sequence), "find_backoff failed");
+	fail_unless (45 == sequence, "find_backoff failed");
+	fail_unless (pgm_rxw_find_backoff (window, 46, &sequence), "find_backoff failed");
+	fail_unless (70 == sequence, "find_backoff failed");
+	pgm_rxw_destroy (window);
+}
+END_TEST
+
+START_TEST (test_find_backoff_fail_001)
+{
+	uint32_t sequence;
+	bool found = pgm_rxw_find_backoff (NULL, 0, &sequence);
 	fail ("reached");
 }
 END_TEST
@@ -1586,6 +1841,7 @@ make_basic_test_suite (void)
 	TCase* tc_remove_commit = tcase_create ("remove-commit");
 	suite_add_tcase (s, tc_remove_commit);
 	tcase_add_test (tc_remove_commit, test_remove_commit_pass_001);
+	tcase_add_test (tc_remove_commit, test_remove_commit_pass_002);
 #ifndef PGM_CHECK_NOFORK
 	tcase_add_test_raise_signal (tc_remove_commit, test_remove_commit_fail_001, SIGABRT);
 #endif
@@ -1602,6 +1858,8 @@ make_basic_test_suite (void)
 	suite_add_tcase (s, tc_confirm);
 	tcase_add_test (tc_confirm, test_confirm_pass_001);
 	tcase_add_test (tc_confirm, test_confirm_pass_002);
+	tcase_add_test (tc_confirm, test_confirm_pass_003);
+	tcase_add_test (tc_confirm, test_confirm_pass_004);
 #ifndef PGM_CHECK_NOFORK
 	tcase_add_test_raise_signal (tc_confirm, test_confirm_fail_001, SIGABRT);
 #endif
@@ -1620,6 +1878,14 @@ make_basic_test_suite (void)
 	tcase_add_test_raise_signal (tc_state, test_state_fail_001, SIGABRT);
 #endif
 
+	TCase* tc_find_backoff = tcase_create ("find-backoff");
+	suite_add_tcase (s, tc_find_backoff);
+	tcase_add_test (tc_find_backoff, test_find_backoff_pass_001);
+	tcase_add_test (tc_find_backoff, test_find_backoff_pass_002);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_find_backoff, test_find_backoff_fail_001, SIGABRT);
+#endif
+
 	return s;
 }
 
@@ -1866,6 +2132,169 @@ make_best_effort_test_suite (void)
 	return s;
 }
 
+/* a.k.a. forward error correction
+ */
+
+/* parity in place of the commit lead */
+START_TEST (test_readv_pass_010)
+{
+	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	pgm_rxw_t* window = create_fec_window (&tsi);
+	fail_if (NULL == window, "create failed");
+	struct pgm_msgv_t msgv[8], *pmsg;
+	const pgm_time_t now = 1;
+	const pgm_time_t nak_rb_expiry = 2;
+/* lose #1 and #2 */
+	add_valid_skbs (window, 0, 0, 0xffffffff);
+	add_valid_skbs (window, 3, 7, 0xffffffff);
+	pmsg = msgv;
+	fail_unless (1000 == pgm_rxw_readv (window, &pmsg, G_N_ELEMENTS(msgv)), "readv failed");
+	fail_unless (PGM_RXW_INSERTED == pgm_rxw_add (window, generate_parity_skb (0), now, nak_rb_expiry), "add not inserted");
+	fail_unless (PGM_PKT_STATE_HAVE_PARITY == window->pkt_state[ pgm_rxw_index (window, 1) ], "state not parity");
+	pmsg = msgv;
+	fail_unless (-1 == pgm_rxw_readv (window, &pmsg, G_N_ELEMENTS(msgv)), "readv failed");
+	fail_unless (PGM_RXW_INSERTED == pgm_rxw_add (window, generate_parity_skb (1), now, nak_rb_expiry), "add not inserted");
+	fail_unless (PGM_PKT_STATE_HAVE_PARITY == window->pkt_state[ pgm_rxw_index (window, 2) ], "state not parity");
+	pmsg = msgv;
+	fail_unless (7000 == pgm_rxw_readv (window, &pmsg, G_N_ELEMENTS(msgv)), "readv failed");
+	pgm_rxw_destroy (window);
+}
+END_TEST
+
+/* leading packet of the transmission group already committed */
+START_TEST (test_readv_pass_011)
+{
+	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	pgm_rxw_t* window = create_fec_window (&tsi);
+	fail_if (NULL == window, "create failed");
+	struct pgm_msgv_t msgv[4], *pmsg;
+	const pgm_time_t now = 1;
+	const pgm_time_t nak_rb_expiry = 2;
+/* lose #1 */
+	add_valid_skbs (window, 0, 3, 1);
+	pmsg = msgv;
+	fail_unless (1000 == pgm_rxw_readv (window, &pmsg, G_N_ELEMENTS(msgv)), "readv failed");
+	fail_unless (PGM_PKT_STATE_COMMIT_DATA == window->pkt_state[ pgm_rxw_index (window, 0) ], "state not commit");
+	fail_unless (PGM_RXW_INSERTED == pgm_rxw_add (window, generate_parity_skb (0), now, nak_rb_expiry), "add not inserted");
+	fail_unless (PGM_PKT_STATE_HAVE_PARITY == window->pkt_state[ pgm_rxw_index (window, 1) ], "state not parity");
+	pmsg = msgv;
+	fail_unless (3000 == pgm_rxw_readv (window, &pmsg, G_N_ELEMENTS(msgv)), "readv failed");
+	pgm_rxw_destroy (window);
+}
+END_TEST
+
+/* reconstructed packets carry their own sequence and a data header */
+START_TEST (test_readv_pass_012)
+{
+	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	pgm_rxw_t* window = create_fec_window (&tsi);
+	fail_if (NULL == window, "create failed");
+	struct pgm_msgv_t msgv[4], *pmsg;
+	const pgm_time_t now = 1;
+	const pgm_time_t nak_rb_expiry = 2;
+/* lose #1 */
+	add_valid_skbs (window, 0, 3, 1);
+	fail_unless (PGM_RXW_INSERTED == pgm_rxw_add (window, generate_parity_skb (0), now, nak_rb_expiry), "add not inserted");
+	pmsg = msgv;
+	fail_unless (4000 == pgm_rxw_readv (window, &pmsg, G_N_ELEMENTS(msgv)), "readv failed");
+	const struct pgm_sk_buff_t* skb = msgv[1].msgv_skb[0];
+	fail_unless (1 == skb->sequence, "sequence mismatch");
+	fail_unless (1 == g_ntohl (skb->pgm_data->data_sqn), "data_sqn mismatch");
+	fail_unless (0 == (skb->pgm_header->pgm_options & PGM_OPT_PARITY), "parity option set");
+	fail_unless (pgm_tsi_equal (&skb->tsi, &tsi), "tsi mismatch");
+	pgm_rxw_destroy (window);
+}
+END_TEST
+
+/* packets of the following transmission group do not complete recovery */
+START_TEST (test_readv_pass_013)
+{
+	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	pgm_rxw_t* window = create_fec_window (&tsi);
+	fail_if (NULL == window, "create failed");
+	struct pgm_msgv_t msgv[8], *pmsg;
+	const pgm_time_t now = 1;
+	const pgm_time_t nak_rb_expiry = 2;
+	add_valid_skbs (window, 0, 3, 0xffffffff);
+	pmsg = msgv;
+	fail_unless (4000 == pgm_rxw_readv (window, &pmsg, G_N_ELEMENTS(msgv)), "readv failed");
+	pgm_rxw_remove_commit (window);
+/* lose #5 and #6, one parity packet is insufficient */
+	add_valid_skbs (window, 4, 4, 0xffffffff);
+	add_valid_skbs (window, 7, 11, 0xffffffff);
+	fail_unless (PGM_RXW_INSERTED == pgm_rxw_add (window, generate_parity_skb (4), now, nak_rb_expiry), "add not inserted");
+	pmsg = msgv;
+	fail_unless (1000 == pgm_rxw_readv (window, &pmsg, G_N_ELEMENTS(msgv)), "readv failed");
+	fail_unless (PGM_PKT_STATE_HAVE_DATA != window->pkt_state[ pgm_rxw_index (window, 6) ], "state reconstructed");
+	pgm_rxw_destroy (window);
+}
+END_TEST
+
+/* parity in place of the commit lead carries an encoded fragment option */
+START_TEST (test_readv_pass_014)
+{
+	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	pgm_rxw_t* window = create_fec_window (&tsi);
+	fail_if (NULL == window, "create failed");
+	struct pgm_msgv_t msgv[4], *pmsg;
+	struct pgm_opt_fragment opt_fragment;
+	const pgm_time_t now = 1;
+	const pgm_time_t nak_rb_expiry = 2;
+/* lose #1 */
+	add_valid_skbs (window, 0, 3, 1);
+	pmsg = msgv;
+	fail_unless (1000 == pgm_rxw_readv (window, &pmsg, G_N_ELEMENTS(msgv)), "readv failed");
+/* encoded option fields do not describe a fragment */
+	memset (&opt_fragment, 0, sizeof(opt_fragment));
+	opt_fragment.opt_sqn = g_htonl (1);
+	struct pgm_sk_buff_t* skb = generate_parity_skb (0);
+	skb->pgm_opt_fragment = &opt_fragment;
+	fail_unless (PGM_RXW_INSERTED == pgm_rxw_add (window, skb, now, nak_rb_expiry), "add not inserted");
+	pmsg = msgv;
+	fail_unless (3000 == pgm_rxw_readv (window, &pmsg, G_N_ELEMENTS(msgv)), "readv failed");
+	pgm_rxw_destroy (window);
+}
+END_TEST
+
+/* parity for a transmission group ahead of the lead */
+START_TEST (test_add_pass_006)
+{
+	pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	pgm_rxw_t* window = create_fec_window (&tsi);
+	fail_if (NULL == window, "create failed");
+	const pgm_time_t now = 1;
+	const pgm_time_t nak_rb_expiry = 2;
+	add_valid_skbs (window, 0, 1, 0xffffffff);
+	fail_unless (PGM_RXW_MISSING == pgm_rxw_add (window, generate_parity_skb (4), now, nak_rb_expiry), "add not missing");
+	fail_unless (4 == pgm_rxw_lead (window), "lead failed");
+	fail_unless (PGM_PKT_STATE_HAVE_PARITY == window->pkt_state[ pgm_rxw_index (window, 4) ], "state not parity");
+	pgm_rxw_destroy (window);
+}
+END_TEST
+
+static
+Suite*
+make_fec_test_suite (void)
+{
+	Suite* s;
+
+	s = suite_create ("Forward error correction");
+
+	TCase* tc_add = tcase_create ("add");
+	suite_add_tcase (s, tc_add);
+	tcase_add_test (tc_add, test_add_pass_006);
+
+	TCase* tc_readv = tcase_create ("readv");
+	suite_add_tcase (s, tc_readv);
+	tcase_add_test (tc_readv, test_readv_pass_010);
+	tcase_add_test (tc_readv, test_readv_pass_011);
+	tcase_add_test (tc_readv, test_readv_pass_012);
+	tcase_add_test (tc_readv, test_readv_pass_013);
+	tcase_add_test (tc_readv, test_readv_pass_014);
+
+	return s;
+}
+
 static
 Suite*
 make_master_suite (void)
@@ -1880,6 +2309,7 @@ main (void)
 	SRunner* sr = srunner_create (make_master_suite ());
 	srunner_add_suite (sr, make_basic_test_suite ());
 	srunner_add_suite (sr, make_best_effort_test_suite ());
+	srunner_add_suite (sr, make_fec_test_suite ());
 	srunner_run_all (sr, CK_ENV);
 	int number_failed = srunner_ntests_failed (sr);
 	srunner_free (sr);
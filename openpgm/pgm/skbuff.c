@@ -48,6 +48,153 @@ pgm_skb_under_panic (
 	pgm_assert_not_reached();
 }
 
+/* create a pool of capacity buffers each holding up to tpdu_size bytes of payload,
+ * buffer memory is allocated on first use.
+ */
+
+pgm_skb_pool_t*
+pgm_skb_pool_create (
+	const uint32_t		capacity,
+	const uint16_t		tpdu_size
+	)
+{
+	pgm_skb_pool_t* pool;
+
+/* pre-conditions */
+	pgm_assert_cmpuint (capacity, >, 0);
+	pgm_assert_cmpuint (capacity, <, PGM_SKB_POOL_NIL);
+
+	pgm_debug ("pgm_skb_pool_create (capacity:%" PRIu32 " tpdu-size:%" PRIu16 ")",
+		capacity, tpdu_size);
+
+	pool = pgm_new0 (pgm_skb_pool_t, 1);
+	pool->capacity  = capacity;
+	pool->tpdu_size = tpdu_size;
+	pool->next      = pgm_new (uint32_t, capacity);
+	pool->slot      = pgm_new0 (struct pgm_sk_buff_t*, capacity);
+	pool->cache     = PGM_SKB_POOL_NIL;
+	pgm_atomic_write32 (&pool->free_list, PGM_SKB_POOL_NIL);
+	pgm_atomic_write32 (&pool->ref_count, 1);
+	return pool;
+}
+
+static
+void
+pgm_skb_pool_unref (
+	pgm_skb_pool_t*const	pool
+	)
+{
+	if (pgm_atomic_exchange_and_add32 (&pool->ref_count, (uint32_t)-1) != 1)
+		return;
+
+/* every populated slot has been returned */
+	for (uint32_t i = 0; i < pool->high_water; i++)
+		pgm_free (pool->slot[i]);
+	pgm_free (pool->slot);
+	pgm_free (pool->next);
+	pgm_free (pool);
+}
+
+/* release owner reference, memory is freed when the last outstanding buffer returns.
+ */
+
+void
+pgm_skb_pool_destroy (
+	pgm_skb_pool_t*const	pool
+	)
+{
+	pgm_assert (NULL != pool);
+
+	pgm_debug ("pgm_skb_pool_destroy (pool:%p)", (const void*)pool);
+
+	pgm_skb_pool_unref (pool);
+}
+
+/* allocate a buffer from the pool, only to be called from the owning context.  Falls
+ * back to the heap when the pool is exhausted or size exceeds the pool TPDU.
+ */
+
+struct pgm_sk_buff_t*
+pgm_skb_pool_alloc (
+	pgm_skb_pool_t*const	pool,
+	const uint16_t		size
+	)
+{
+	struct pgm_sk_buff_t* skb;
+	uint32_t index;
+
+	if (NULL == pool)
+		return pgm_alloc_skb (size);
+	if (PGM_UNLIKELY(size > pool->tpdu_size))
+		goto fallback;
+
+	index = pool->cache;
+	if (PGM_SKB_POOL_NIL == index) {
+/* take entire shared list */
+		do {
+			index = pgm_atomic_read32 (&pool->free_list);
+		} while (PGM_SKB_POOL_NIL != index &&
+			 !pgm_atomic_compare_and_exchange32 (&pool->free_list, PGM_SKB_POOL_NIL, index));
+	}
+	if (PGM_LIKELY(PGM_SKB_POOL_NIL != index)) {
+		pool->cache = pool->next[index];
+		skb = pool->slot[index];
+		pool->hits++;
+	} else if (pool->high_water < pool->capacity) {
+		index = pool->high_water;
+		skb = pool->slot[index] = (struct pgm_sk_buff_t*)pgm_malloc (sizeof(struct pgm_sk_buff_t) + PGM_SKB_POOL_LINK_SIZE + pool->tpdu_size);
+		pool->high_water++;
+	} else
+		goto fallback;
+
+	if (PGM_UNLIKELY(pgm_mem_gc_friendly)) {
+		memset (skb, 0, sizeof(struct pgm_sk_buff_t) + PGM_SKB_POOL_LINK_SIZE + size);
+		skb->zero_padded = 1;
+	} else {
+		memset (skb, 0, sizeof(struct pgm_sk_buff_t));
+	}
+	skb->truesize = sizeof(struct pgm_sk_buff_t) + PGM_SKB_POOL_LINK_SIZE + size;
+	pgm_atomic_write32 (&skb->users, 1);
+	skb->head = (char*)(skb + 1) + PGM_SKB_POOL_LINK_SIZE;
+	skb->data = skb->tail = skb->head;
+	skb->end  = (char*)skb->data + size;
+	pgm_skb_pool_link (skb)->pool  = pool;
+	pgm_skb_pool_link (skb)->index = index;
+	pgm_atomic_inc32 (&pool->ref_count);
+	return skb;
+
+fallback:
+	pool->misses++;
+	return pgm_alloc_skb (size);
+}
+
+/* return a buffer to its pool, called from pgm_free_skb() in any thread.
+ */
+
+void
+pgm_skb_pool_release (
+	struct pgm_sk_buff_t*const skb
+	)
+{
+	const struct pgm_skb_pool_link_t* link;
+	pgm_skb_pool_t* pool;
+	uint32_t index, head;
+
+	pgm_assert (pgm_skb_is_pooled (skb));
+
+	link  = pgm_skb_pool_link (skb);
+	pool  = link->pool;
+	index = link->index;
+	pgm_assert (NULL != pool);
+	pgm_assert_cmpuint (index, <, pool->high_water);
+
+	do {
+		head = pgm_atomic_read32 (&pool->free_list);
+		pool->next[index] = head;
+	} while (!pgm_atomic_compare_and_exchange32 (&pool->free_list, index, head));
+	pgm_skb_pool_unref (pool);
+}
+
 #ifndef SKB_DEBUG
 bool
 pgm_skb_is_valid (
@@ -0,0 +1,224 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * unit tests for socket buffer pools.
+ *
+ * Copyright (c) 2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include <signal.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+#include <check.h>
+
+#ifdef _WIN32
+#	define PGM_CHECK_NOFORK		1
+#endif
+
+
+/* mock state */
+
+/* mock functions for external references */
+
+#define SKB_DEBUG
+#include "skbuff.c"
+
+PGM_GNUC_INTERNAL
+int
+pgm_get_nprocs (void)
+{
+	return 1;
+}
+
+
+/* target:
+ *	pgm_skb_pool_t*
+ *	pgm_skb_pool_create (
+ *		const uint32_t		capacity,
+ *		const uint16_t		tpdu_size
+ *	)
+ */
+
+START_TEST (test_create_pass_001)
+{
+	pgm_skb_pool_t* pool = pgm_skb_pool_create (4, 1500);
+	fail_if (NULL == pool, "create failed");
+	fail_unless (0 == pool->high_water, "create failed");
+	pgm_skb_pool_destroy (pool);
+}
+END_TEST
+
+START_TEST (test_create_fail_001)
+{
+	pgm_skb_pool_t* pool = pgm_skb_pool_create (0, 1500);
+	fail ("reached");
+}
+END_TEST
+
+/* target:
+ *	struct pgm_sk_buff_t*
+ *	pgm_skb_pool_alloc (
+ *		pgm_skb_pool_t*		pool,
+ *		const uint16_t		size
+ *	)
+ */
+
+/* recycle released buffers */
+START_TEST (test_alloc_pass_001)
+{
+	pgm_skb_pool_t* pool = pgm_skb_pool_create (2, 1500);
+	struct pgm_sk_buff_t* skb1 = pgm_skb_pool_alloc (pool, 1500);
+	struct pgm_sk_buff_t* skb2 = pgm_skb_pool_alloc (pool, 1500);
+	fail_if (NULL == skb1, "alloc failed");
+	fail_if (NULL == skb2, "alloc failed");
+	fail_unless (pgm_skb_is_pooled (skb1) && pool == pgm_skb_pool_link (skb1)->pool, "alloc failed");
+	fail_unless (1500 == pgm_skb_tailroom (skb1), "alloc failed");
+	fail_unless (2 == pool->high_water, "alloc failed");
+	fail_unless (0 == pool->hits, "alloc failed");
+	pgm_free_skb (skb1);
+	pgm_free_skb (skb2);
+	struct pgm_sk_buff_t* skb3 = pgm_skb_pool_alloc (pool, 1500);
+	fail_unless (skb2 == skb3, "alloc failed");
+	fail_unless (1 == pool->hits, "alloc failed");
+	fail_unless (1 == pgm_atomic_read32 (&skb3->users), "alloc failed");
+	fail_unless (0 == skb3->len, "alloc failed");
+	pgm_free_skb (skb3);
+	pgm_skb_pool_destroy (pool);
+}
+END_TEST
+
+/* heap fallback on exhaustion and oversized requests */
+START_TEST (test_alloc_pass_002)
+{
+	pgm_skb_pool_t* pool = pgm_skb_pool_create (1, 1500);
+	struct pgm_sk_buff_t* skb1 = pgm_skb_pool_alloc (pool, 1500);
+	struct pgm_sk_buff_t* skb2 = pgm_skb_pool_alloc (pool, 1500);
+	struct pgm_sk_buff_t* skb3 = pgm_skb_pool_alloc (pool, 9000);
+	fail_unless (pgm_skb_is_pooled (skb1) && pool == pgm_skb_pool_link (skb1)->pool, "alloc failed");
+	fail_unless (!pgm_skb_is_pooled (skb2), "alloc failed");
+	fail_unless (!pgm_skb_is_pooled (skb3), "alloc failed");
+	fail_unless (2 == pool->misses, "alloc failed");
+	fail_unless (1 == pool->high_water, "alloc failed");
+	pgm_free_skb (skb1);
+	pgm_free_skb (skb2);
+	pgm_free_skb (skb3);
+	pgm_skb_pool_destroy (pool);
+}
+END_TEST
+
+/* null pool is plain heap */
+START_TEST (test_alloc_pass_003)
+{
+	struct pgm_sk_buff_t* skb = pgm_skb_pool_alloc (NULL, 1500);
+	fail_if (NULL == skb, "alloc failed");
+	fail_unless (!pgm_skb_is_pooled (skb), "alloc failed");
+	pgm_free_skb (skb);
+}
+END_TEST
+
+/* copies of pooled buffers are plain heap */
+START_TEST (test_alloc_pass_004)
+{
+	pgm_skb_pool_t* pool = pgm_skb_pool_create (1, 1500);
+	struct pgm_sk_buff_t* skb = pgm_skb_pool_alloc (pool, 1500);
+	memset (pgm_skb_put (skb, 100), 'x', 100);
+	struct pgm_sk_buff_t* copy = pgm_skb_copy (skb);
+	fail_unless (!pgm_skb_is_pooled (copy), "copy failed");
+	fail_unless (100 == copy->len, "copy failed");
+	fail_unless (0 == memcmp (copy->data, skb->data, 100), "copy failed");
+	pgm_free_skb (copy);
+	pgm_free_skb (skb);
+	fail_unless (0 == pool->misses, "copy failed");
+	pgm_skb_pool_destroy (pool);
+}
+END_TEST
+
+/* target:
+ *	void
+ *	pgm_skb_pool_release (
+ *		struct pgm_sk_buff_t*	skb
+ *	)
+ */
+
+/* buffers outlive the owner reference */
+START_TEST (test_release_pass_001)
+{
+	pgm_skb_pool_t* pool = pgm_skb_pool_create (2, 1500);
+	struct pgm_sk_buff_t* skb = pgm_skb_pool_alloc (pool, 1500);
+	fail_unless (2 == pgm_atomic_read32 (&pool->ref_count), "release failed");
+	pgm_skb_get (skb);
+	pgm_free_skb (skb);
+	fail_unless (2 == pgm_atomic_read32 (&pool->ref_count), "release failed");
+	pgm_skb_pool_destroy (pool);
+	fail_unless (1 == pgm_atomic_read32 (&pool->ref_count), "release failed");
+	pgm_free_skb (skb);
+}
+END_TEST
+
+
+static
+Suite*
+make_test_suite (void)
+{
+	Suite* s;
+
+	s = suite_create (__FILE__);
+
+	TCase* tc_create = tcase_create ("create");
+	suite_add_tcase (s, tc_create);
+	tcase_add_test (tc_create, test_create_pass_001);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_create, test_create_fail_001, SIGABRT);
+#endif
+
+	TCase* tc_alloc = tcase_create ("alloc");
+	suite_add_tcase (s, tc_alloc);
+	tcase_add_test (tc_alloc, test_alloc_pass_001);
+	tcase_add_test (tc_alloc, test_alloc_pass_002);
+	tcase_add_test (tc_alloc, test_alloc_pass_003);
+	tcase_add_test (tc_alloc, test_alloc_pass_004);
+
+	TCase* tc_release = tcase_create ("release");
+	suite_add_tcase (s, tc_release);
+	tcase_add_test (tc_release, test_release_pass_001);
+	return s;
+}
+
+static
+Suite*
+make_master_suite (void)
+{
+	Suite* s = suite_create ("Master");
+	return s;
+}
+
+int
+main (void)
+{
+	pgm_messages_init();
+	SRunner* sr = srunner_create (make_master_suite ());
+	srunner_add_suite (sr, make_test_suite ());
+	srunner_run_all (sr, CK_ENV);
+	int number_failed = srunner_ntests_failed (sr);
+	srunner_free (sr);
+	pgm_messages_shutdown();
+	return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* eof */
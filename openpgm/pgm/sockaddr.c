@@ -23,6 +23,7 @@
 #	include <config.h>
 #endif
 #include <errno.h>
+#include <limits.h>
 #ifndef _WIN32
 #	include <sys/socket.h>
 #	include <netdb.h>
@@ -43,6 +44,9 @@
 #if !defined( _WIN32 ) && !defined( MCAST_MSFILTER )
 #	include <sys/ioctl.h>
 #endif
+#if defined( __linux__ )
+#	include <linux/filter.h>
+#endif
 #if !defined( SOL_IP )
 /* IPPROTO_IP is often an enum value whilst SOL_IP is a pre-processor definition */
 #	define SOL_IP			IPPROTO_IP
@@ -495,6 +499,127 @@ pgm_sockaddr_pktinfo (
 	return retval;
 }
 
+/* Request kernel receive timestamp with nanosecond resolution on each packet as
+ * SCM_TIMESTAMPNS ancillary data, sampled against the wall clock.
+ *
+ * If no error occurs, pgm_sockaddr_timestamp returns zero.  Otherwise, a value
+ * of SOCKET_ERROR is returned, and a specific error code can be retrieved
+ * by calling pgm_get_last_sock_error().
+ */
+
+PGM_GNUC_INTERNAL
+int
+pgm_sockaddr_timestamp (
+	const SOCKET		s,
+	const bool		v
+	)
+{
+	int retval = SOCKET_ERROR;
+#ifdef SO_TIMESTAMPNS
+/* Linux:socket(7) "Enable or disable the receiving of the SO_TIMESTAMPNS control
+ * message.  The cmsg_data field is a struct timespec"
+ */
+	const int optval = v ? 1 : 0;
+	retval = setsockopt (s, SOL_SOCKET, SO_TIMESTAMPNS, (const char*)&optval, sizeof(optval));
+#else
+	pgm_set_last_sock_error (PGM_SOCK_EINVAL);
+#endif
+	return retval;
+}
+
+/* Enable MSG_ZEROCOPY transmit on the socket.
+ *
+ * If no error occurs, pgm_sockaddr_zerocopy returns zero.  Otherwise, a value
+ * of SOCKET_ERROR is returned, and a specific error code can be retrieved
+ * by calling pgm_get_last_sock_error().
+ */
+
+PGM_GNUC_INTERNAL
+int
+pgm_sockaddr_zerocopy (
+	const SOCKET		s,
+	const bool		v
+	)
+{
+	int retval = SOCKET_ERROR;
+#ifdef SO_ZEROCOPY
+/* Linux:msg_zerocopy "The kernel only allows MSG_ZEROCOPY on sockets that have
+ * set the SO_ZEROCOPY socket option"
+ */
+	const int optval = v ? 1 : 0;
+	retval = setsockopt (s, SOL_SOCKET, SO_ZEROCOPY, (const char*)&optval, sizeof(optval));
+#else
+	pgm_set_last_sock_error (PGM_SOCK_EINVAL);
+#endif
+	return retval;
+}
+
+/* Attach a classic BPF program to the socket, a zero length removes any attached
+ * program.
+ *
+ * If no error occurs, pgm_sockaddr_filter returns zero.  Otherwise, a value
+ * of SOCKET_ERROR is returned, and a specific error code can be retrieved
+ * by calling pgm_get_last_sock_error().
+ */
+
+PGM_GNUC_INTERNAL
+int
+pgm_sockaddr_filter (
+	const SOCKET		s,
+	void*			insns,
+	const unsigned		len
+	)
+{
+	int retval = SOCKET_ERROR;
+#if defined(SO_ATTACH_FILTER) && defined(SO_DETACH_FILTER)
+/* Linux:socket(7) "Attach a classic BPF program to the socket for use as a filter
+ * of incoming packets.  A packet will be dropped if the filter program returns
+ * zero."
+ */
+	if (len > 0) {
+		struct sock_fprog prog;
+		prog.len    = (unsigned short)len;
+		prog.filter = insns;
+		retval = setsockopt (s, SOL_SOCKET, SO_ATTACH_FILTER, (const char*)&prog, sizeof(prog));
+	} else {
+		const int optval = 0;
+		retval = setsockopt (s, SOL_SOCKET, SO_DETACH_FILTER, (const char*)&optval, sizeof(optval));
+		if (SOCKET_ERROR == retval && ENOENT == errno)
+			retval = 0;
+	}
+#else
+	pgm_set_last_sock_error (PGM_SOCK_EINVAL);
+#endif
+	return retval;
+}
+
+/* Cap the transmit rate of a socket in bytes per second, the kernel then
+ * spaces packets evenly.  Only enforced for datagram sockets when the fq
+ * queueing discipline is attached to the egress interface.
+ *
+ * If no error occurs, pgm_sockaddr_pacing_rate returns zero.  Otherwise, a
+ * value of SOCKET_ERROR is returned, and a specific error code can be
+ * retrieved by calling pgm_get_last_sock_error().
+ */
+
+PGM_GNUC_INTERNAL
+int
+pgm_sockaddr_pacing_rate (
+	const SOCKET		s,
+	const ssize_t		rate
+	)
+{
+	int retval = SOCKET_ERROR;
+#ifdef SO_MAX_PACING_RATE
+/* Linux:socket(7) unsigned int, UINT_MAX removes the cap. */
+	const unsigned optval = rate > 0 && (size_t)rate < UINT_MAX ? (unsigned)rate : UINT_MAX;
+	retval = setsockopt (s, SOL_SOCKET, SO_MAX_PACING_RATE, (const char*)&optval, sizeof(optval));
+#else
+	pgm_set_last_sock_error (PGM_SOCK_EINVAL);
+#endif
+	return retval;
+}
+
 /* Set IP Router Alert option for all outgoing packets.
  *
  * If no error occurs, pgm_sockaddr_router_alert returns zero.  Otherwise, a
@@ -37,6 +37,7 @@
 #include <impl/receiver.h>
 #include <impl/source.h>
 #include <impl/timer.h>
+#include <impl/filter.h>
 
 
 #define SOCK_DEBUG
@@ -246,7 +247,17 @@ pgm_close (
 		closesocket (sock->send_sock);
 		sock->send_sock = INVALID_SOCKET;
 	}
+/* wake network thread and any application reader blocked on the ring */
+	if (sock->rx_ring) {
+		pgm_notify_send (&sock->pending_notify);
+		pgm_notify_send (&sock->ring_notify);
+	}
 	pgm_rwlock_reader_unlock (&sock->lock);
+	if (sock->has_rx_thread) {
+		pgm_debug ("waiting for network thread ...");
+		pgm_recv_thread_join (sock);
+		sock->has_rx_thread = FALSE;
+	}
 	pgm_debug ("blocking on destroy lock ...");
 	pgm_rwlock_writer_lock (&sock->lock);
 
@@ -271,7 +282,7 @@ pgm_close (
 
 	if (sock->peers_hashtable) {
 		pgm_debug ("destroying peer lookup table.");
-		pgm_hashtable_destroy (sock->peers_hashtable);
+		pgm_tsitable_destroy (sock->peers_hashtable);
 		sock->peers_hashtable = NULL;
 	}
 	if (sock->peers_list) {
@@ -283,6 +294,11 @@ pgm_close (
 			sock->peers_list = next;
 		} while (sock->peers_list);
 	}
+	if (sock->peers_timer) {
+		pgm_free (sock->peers_timer);
+		sock->peers_timer = NULL;
+		sock->peers_timer_len = sock->peers_timer_size = 0;
+	}
 
 	if (sock->window) {
 		pgm_trace (PGM_LOG_ROLE_TX_WINDOW,_("Destroying transmit window."));
@@ -301,11 +317,52 @@ pgm_close (
 		pgm_free (sock->spm_heartbeat_interval);
 		sock->spm_heartbeat_interval = NULL;
 	}
+	if (sock->rx_batch) {
+		pgm_debug ("freeing receive batch.");
+		pgm_recv_batch_destroy (sock->rx_batch);
+		sock->rx_batch = NULL;
+	}
+	if (sock->tx_burst) {
+		pgm_debug ("freeing transmit burst.");
+		pgm_send_burst_destroy (sock->tx_burst);
+		sock->tx_burst = NULL;
+	}
+	if (sock->rdata_burst) {
+		pgm_debug ("freeing repair burst.");
+		pgm_send_burst_destroy (sock->rdata_burst);
+		sock->rdata_burst = NULL;
+	}
+	if (sock->zerocopy) {
+		pgm_debug ("freeing zero-copy completions.");
+		pgm_zerocopy_destroy (sock->zerocopy);
+		sock->zerocopy = NULL;
+	}
+	if (sock->rx_ring) {
+		pgm_debug ("freeing receive ring.");
+		pgm_ring_destroy (sock->rx_ring);
+		sock->rx_ring = NULL;
+		pgm_notify_destroy (&sock->ring_notify);
+	}
+	if (sock->rx_thread_error) {
+		pgm_error_free (sock->rx_thread_error);
+		sock->rx_thread_error = NULL;
+	}
 	if (sock->rx_buffer) {
 		pgm_debug ("freeing receive buffer.");
 		pgm_free_skb (sock->rx_buffer);
 		sock->rx_buffer = NULL;
 	}
+/* pools persist until outstanding application held buffers are freed */
+	if (sock->rx_pool) {
+		pgm_debug ("releasing receive buffer pool.");
+		pgm_skb_pool_destroy (sock->rx_pool);
+		sock->rx_pool = NULL;
+	}
+	if (sock->tx_pool) {
+		pgm_debug ("releasing transmit buffer pool.");
+		pgm_skb_pool_destroy (sock->tx_pool);
+		sock->tx_pool = NULL;
+	}
 	pgm_debug ("destroying notification channels.");
 	if (sock->can_send_data) {
 		if (sock->use_pgmcc) {
@@ -377,6 +434,9 @@ pgm_socket (
 	new_sock->dport		= DEFAULT_DATA_DESTINATION_PORT;
 	new_sock->tsi.sport	= DEFAULT_DATA_SOURCE_PORT;
 	new_sock->adv_mode	= 0;	/* advance with time */
+#ifdef SO_ATTACH_FILTER
+	new_sock->use_kernel_filter = TRUE;
+#endif
 
 /* PGMCC */
 	new_sock->acker_nla.ss_family = family;
@@ -711,7 +771,11 @@ pgm_getsockopt (
 			break;
 		if (PGM_UNLIKELY(*optlen != sizeof (SOCKET)))
 			break;
-		*(SOCKET*restrict)optval = pgm_notify_get_socket (&sock->pending_notify);
+/* network thread signals on the ring */
+		if (sock->rx_ring)
+			*(SOCKET*restrict)optval = pgm_notify_get_socket (&sock->ring_notify);
+		else
+			*(SOCKET*restrict)optval = pgm_notify_get_socket (&sock->pending_notify);
 		status = TRUE;
 		break;
 
@@ -736,7 +800,7 @@ pgm_getsockopt (
 			break;
 		{
 			struct timeval* tv = optval;
-			const long usecs = (long)pgm_timer_expiration (sock);
+			const long usecs = (long)pgm_timer_expiration (sock, pgm_time_update_now());
 			tv->tv_sec  = usecs / 1000000L;
 			tv->tv_usec = usecs % 1000000L;
 		}
@@ -839,6 +903,13 @@ pgm_getsockopt (
 		status = TRUE;
 		break;
 
+	case PGM_PACING:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->txw_pacing;
+		status = TRUE;
+		break;
+
 	case PGM_UNCONTROLLED_ODATA:
 		if (PGM_UNLIKELY(*optlen != sizeof (int)))
 			break;
@@ -920,6 +991,13 @@ pgm_getsockopt (
 		status = TRUE;
 		break;
 
+	case PGM_NCF_IVL:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = (int)sock->ncf_ivl;
+		status = TRUE;
+		break;
+
 	case PGM_NAK_RPT_IVL:
 		if (PGM_UNLIKELY(*optlen != sizeof (int)))
 			break;
@@ -1016,6 +1094,51 @@ pgm_getsockopt (
 		status = TRUE;
 		break;
 
+	case PGM_DEFER_CHECKSUM:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->use_deferred_checksum ? 1 : 0;
+		status = TRUE;
+		break;
+
+	case PGM_RECV_THREAD:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->rx_ring_len;
+		status = TRUE;
+		break;
+
+	case PGM_RX_TIMESTAMP:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->use_rx_timestamp ? 1 : 0;
+		status = TRUE;
+		break;
+
+	case PGM_SEND_ZEROCOPY:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = NULL != sock->zerocopy ? (int)sock->zerocopy_min : 0;
+		status = TRUE;
+		break;
+
+	case PGM_KERNEL_FILTER:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->use_kernel_filter ? 1 : 0;
+		status = TRUE;
+		break;
+
+	case PGM_FILTER_TSI:
+		if (PGM_UNLIKELY(*optlen != sizeof (pgm_tsi_t)))
+			break;
+		if (sock->use_filter_tsi)
+			memcpy (optval, &sock->filter_tsi, sizeof (pgm_tsi_t));
+		else
+			memset (optval, 0, sizeof (pgm_tsi_t));
+		status = TRUE;
+		break;
+
 	case PGM_SEND_GROUP:
 		if (PGM_UNLIKELY(*optlen != sizeof (struct group_req)))
 			break;
@@ -1037,6 +1160,125 @@ pgm_getsockopt (
 		status = TRUE;
 		break;
 
+	case PGM_RECV_BATCH:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->rx_batch_len;
+		status = TRUE;
+		break;
+
+/* average datagrams returned per batched read as percentage of batch size */
+	case PGM_RECV_BATCH_FILL:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		if (NULL == sock->rx_batch)
+			break;
+		*(int*restrict)optval = sock->rx_batch->calls ?
+				(int)((100ULL * sock->rx_batch->datagrams) / ((uint64_t)sock->rx_batch->calls * sock->rx_batch->len)) : 0;
+		status = TRUE;
+		break;
+
+	case PGM_SEND_BURST:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = sock->tx_burst_len;
+		status = TRUE;
+		break;
+
+/* average datagrams sent per burst write as percentage of burst size */
+	case PGM_SEND_BURST_FILL:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		if (NULL == sock->tx_burst)
+			break;
+		*(int*restrict)optval = sock->tx_burst->calls ?
+				(int)((100ULL * sock->tx_burst->datagrams) / ((uint64_t)sock->tx_burst->calls * sock->tx_burst->len)) : 0;
+		status = TRUE;
+		break;
+
+/* packet buffer pool statistics, sum of transmit and receive pools */
+	case PGM_SKB_POOL_HITS:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = (int)((sock->rx_pool ? pgm_atomic_read32 (&sock->rx_pool->hits) : 0) +
+					      (sock->tx_pool ? pgm_atomic_read32 (&sock->tx_pool->hits) : 0));
+		status = TRUE;
+		break;
+
+	case PGM_SKB_POOL_MISSES:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = (int)((sock->rx_pool ? pgm_atomic_read32 (&sock->rx_pool->misses) : 0) +
+					      (sock->tx_pool ? pgm_atomic_read32 (&sock->tx_pool->misses) : 0));
+		status = TRUE;
+		break;
+
+	case PGM_SKB_POOL_HIGH_WATER:
+		if (PGM_UNLIKELY(*optlen != sizeof (int)))
+			break;
+		*(int*restrict)optval = (int)((sock->rx_pool ? pgm_atomic_read32 (&sock->rx_pool->high_water) : 0) +
+					      (sock->tx_pool ? pgm_atomic_read32 (&sock->tx_pool->high_water) : 0));
+		status = TRUE;
+		break;
+
+/* receive window slot memory, sum over all peers */
+	case PGM_RXW_RESERVED:
+	case PGM_RXW_USED:
+		if (PGM_UNLIKELY(*optlen != sizeof (size_t)))
+			break;
+		{
+			size_t total = 0;
+/* windows are resized and advanced under the receiver lock */
+			pgm_mutex_lock (&sock->receiver_mutex);
+			pgm_rwlock_reader_lock (&sock->peers_lock);
+			for (const pgm_list_t* list = sock->peers_list; NULL != list; list = list->next)
+			{
+				const pgm_rxw_t* window = ((const pgm_peer_t*)list->data)->window;
+				total += (PGM_RXW_RESERVED == optname) ? pgm_rxw_reserved (window) : pgm_rxw_used (window);
+			}
+			pgm_rwlock_reader_unlock (&sock->peers_lock);
+			pgm_mutex_unlock (&sock->receiver_mutex);
+			*(size_t*restrict)optval = total;
+		}
+		status = TRUE;
+		break;
+
+	case PGM_STATS:
+		if (PGM_UNLIKELY(*optlen != sizeof (struct pgm_stats_t)))
+			break;
+		{
+			struct pgm_stats_t*const stats = optval;
+			uint64_t source[PGM_PC_SOURCE_MAX], receiver[PGM_PC_RECEIVER_MAX];
+			pgm_sock_stats_snapshot (sock, source);
+			stats->data_bytes_sent	   = source[PGM_PC_SOURCE_DATA_BYTES_SENT];
+			stats->data_msgs_sent	   = source[PGM_PC_SOURCE_DATA_MSGS_SENT];
+			stats->bytes_sent	   = source[PGM_PC_SOURCE_BYTES_SENT];
+			stats->bytes_retransmitted = source[PGM_PC_SOURCE_SELECTIVE_BYTES_RETRANSMITTED];
+			stats->msgs_retransmitted  = source[PGM_PC_SOURCE_SELECTIVE_MSGS_RETRANSMITTED];
+			stats->naks_received	   = source[PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED];
+			stats->naks_ignored	   = source[PGM_PC_SOURCE_SELECTIVE_NAKS_IGNORED];
+			stats->nnaks_received	   = source[PGM_PC_SOURCE_SELECTIVE_NNAKS_RECEIVED];
+			stats->cksum_errors	   = source[PGM_PC_SOURCE_CKSUM_ERRORS];
+			stats->packets_discarded   = source[PGM_PC_SOURCE_PACKETS_DISCARDED];
+			stats->data_bytes_received = stats->data_msgs_received = stats->bytes_received = 0;
+			stats->naks_sent = stats->naks_failed = stats->dup_datas = 0;
+			pgm_rwlock_reader_lock (&sock->peers_lock);
+			for (const pgm_list_t* list = sock->peers_list; NULL != list; list = list->next)
+			{
+				pgm_peer_stats_snapshot ((const pgm_peer_t*)list->data, receiver);
+				stats->data_bytes_received += receiver[PGM_PC_RECEIVER_DATA_BYTES_RECEIVED];
+				stats->data_msgs_received  += receiver[PGM_PC_RECEIVER_DATA_MSGS_RECEIVED];
+				stats->bytes_received	   += receiver[PGM_PC_RECEIVER_BYTES_RECEIVED];
+				stats->naks_sent	   += receiver[PGM_PC_RECEIVER_SELECTIVE_NAKS_SENT];
+				stats->naks_failed	   += receiver[PGM_PC_RECEIVER_SELECTIVE_NAKS_FAILED];
+				stats->dup_datas	   += receiver[PGM_PC_RECEIVER_DUP_DATAS];
+				stats->packets_discarded   += receiver[PGM_PC_RECEIVER_PACKETS_DISCARDED];
+			}
+			pgm_rwlock_reader_unlock (&sock->peers_lock);
+		}
+		status = TRUE;
+		break;
+
 /** write-only options **/
 	case PGM_IP_ROUTER_ALERT:
 	case PGM_MULTICAST_LOOP:
@@ -1287,6 +1529,22 @@ pgm_setsockopt (
 		status = TRUE;
 		break;
 
+/* spacing of packets within the TXW_MAX_RTE limit, PGM_PACING_NONE permits
+ * bursts of one millisecond of data.  PGM_PACING_KERNEL falls back to
+ * PGM_PACING_USER when SO_MAX_PACING_RATE is unavailable at bind time.
+ */
+	case PGM_PACING:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		if (PGM_UNLIKELY(sock->is_bound))
+			break;
+		if (PGM_UNLIKELY(*(const int*)optval < PGM_PACING_NONE ||
+				 *(const int*)optval > PGM_PACING_KERNEL))
+			break;
+		sock->txw_pacing = *(const int*)optval;
+		status = TRUE;
+		break;
+
 /* ignore rate limit for original data packets, i.e. only apply to repairs.
  */
 	case PGM_UNCONTROLLED_ODATA:
@@ -1383,6 +1641,19 @@ pgm_setsockopt (
 		status = TRUE;
 		break;
 
+/* source NAK aggregation interval in microseconds, 0 disables.  NAKs for
+ * sequences already queued or confirmed within the interval are ignored,
+ * remaining sequences are confirmed by one NCF list per interval.
+ */
+	case PGM_NCF_IVL:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		if (PGM_UNLIKELY(*(const int*)optval < 0))
+			break;
+		sock->ncf_ivl = *(const int*)optval;
+		status = TRUE;
+		break;
+
 /* repeat interval prior to re-sending a NAK, in milliseconds.
  */
 	case PGM_NAK_RPT_IVL:
@@ -1474,6 +1745,7 @@ pgm_setsockopt (
 			sock->use_var_pktlen		= fecinfo->var_pktlen_enabled;
 			sock->rs_n			= fecinfo->block_size;
 			sock->rs_k			= fecinfo->group_size;
+			sock->tg_sqn_shift		= pgm_power2_log2 (fecinfo->group_size);
 			sock->rs_proactive_h		= fecinfo->proactive_packets;
 		}
 		status = TRUE;
@@ -1554,6 +1826,100 @@ pgm_setsockopt (
 		status = TRUE;
 		break;
 
+/* verify the checksum of original data whilst copying to the application
+ * buffer in pgm_recv() and pgm_recvfrom() instead of on arrival.
+ */
+	case PGM_DEFER_CHECKSUM:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		sock->use_deferred_checksum = (0 != *(const int*)optval);
+		status = TRUE;
+		break;
+
+/* library owned network thread handing APDUs to the application through a ring of
+ * the given length, rounded up to a power of two.  0 <= ring <= PGM_MAX_RECV_RING,
+ * 0 disables.  The thread is started by pgm_connect().
+ */
+	case PGM_RECV_THREAD:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		if (PGM_UNLIKELY(sock->is_bound))
+			break;
+		if (PGM_UNLIKELY(*(const int*)optval < 0))
+			break;
+		if (PGM_UNLIKELY(*(const int*)optval > PGM_MAX_RECV_RING))
+			break;
+		sock->rx_ring_len = *(const int*)optval ? (unsigned)pgm_nearest_power (1, *(const int*)optval) : 0;
+		status = TRUE;
+		break;
+
+/* stamp received packets with the kernel arrival time instead of the time read
+ * from the socket, dwell time in the socket receive queue is recorded in the
+ * Rx.QueueingDelay histogram.  Requires SO_TIMESTAMPNS.
+ */
+	case PGM_RX_TIMESTAMP:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		if (SOCKET_ERROR == pgm_sockaddr_timestamp (sock->recv_sock, (0 != *(const int*)optval)))
+			break;
+		sock->use_rx_timestamp = (0 != *(const int*)optval);
+		status = TRUE;
+		break;
+
+/* discard packets for other groups, data-destination ports and blocked sources
+ * in the kernel with a BPF program on the receive socket.  On by default where
+ * SO_ATTACH_FILTER is available.
+ */
+	case PGM_KERNEL_FILTER:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		if (PGM_UNLIKELY(sock->is_bound))
+			break;
+#ifndef SO_ATTACH_FILTER
+		if (PGM_UNLIKELY(0 != *(const int*)optval))
+			break;
+#endif
+		sock->use_kernel_filter = (0 != *(const int*)optval);
+		status = TRUE;
+		break;
+
+/* only receive from one source, a null TSI receives from all sources.
+ */
+	case PGM_FILTER_TSI:
+		if (PGM_UNLIKELY(optlen != sizeof (pgm_tsi_t)))
+			break;
+		{
+			const pgm_tsi_t* tsi = optval;
+			pgm_tsi_t null_tsi;
+			memset (&null_tsi, 0, sizeof (pgm_tsi_t));
+			sock->use_filter_tsi = !pgm_tsi_equal (tsi, &null_tsi);
+			memcpy (&sock->filter_tsi, tsi, sizeof (pgm_tsi_t));
+			if (sock->is_bound)
+				pgm_filter_update (sock);
+		}
+		status = TRUE;
+		break;
+
+/* transmit original data packets of at least the given TPDU size without copying
+ * into the kernel with MSG_ZEROCOPY, 0 disables.  Buffers are held until the
+ * kernel reports completion on the socket error queue, repairs of a held buffer
+ * are sent from a copy.  Falls back to copying when unsupported at bind time.
+ */
+	case PGM_SEND_ZEROCOPY:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		if (PGM_UNLIKELY(sock->is_bound))
+			break;
+		if (PGM_UNLIKELY(*(const int*)optval < 0))
+			break;
+#ifndef MSG_ZEROCOPY
+		if (PGM_UNLIKELY(*(const int*)optval > 0))
+			break;
+#endif
+		sock->zerocopy_min = (unsigned)*(const int*)optval;
+		status = TRUE;
+		break;
+
 /* sending group, singular.  note that the address is only stored and used
  * later in sendto() calls, this routine only considers the interface.
  */
@@ -1675,6 +2041,8 @@ pgm_setsockopt (
 					(unsigned)gr->gr_interface);
 			}
 			sock->recv_gsr_len++;
+			if (sock->is_bound)
+				pgm_filter_update (sock);
 		}
 	}
 		status = TRUE;
@@ -1706,6 +2074,8 @@ pgm_setsockopt (
 				}
 				i++;
 			}
+			if (sock->is_bound)
+				pgm_filter_update (sock);
 			if (PGM_UNLIKELY(sock->family != gr->gr_group.ss_family))
 				break;
 			if (SOCKET_ERROR == pgm_sockaddr_leave_group (sock->recv_sock, sock->family, gr))
@@ -1729,10 +2099,24 @@ pgm_setsockopt (
 			break;
 		{
 			const struct group_source_req* gsr = optval;
+			unsigned i;
 			if (PGM_UNLIKELY(sock->family != gsr->gsr_group.ss_family))
 				break;
 			if (SOCKET_ERROR == pgm_sockaddr_block_source (sock->recv_sock, sock->family, gsr))
 				break;
+/* record for the kernel packet filter */
+			for (i = 0; i < sock->block_gsr_len; i++)
+			{
+				if (pgm_sockaddr_cmp ((const struct sockaddr*)&gsr->gsr_group,  (struct sockaddr*)&sock->block_gsr[i].gsr_group)  == 0 &&
+				    pgm_sockaddr_cmp ((const struct sockaddr*)&gsr->gsr_source, (struct sockaddr*)&sock->block_gsr[i].gsr_source) == 0)
+					break;
+			}
+			if (i == sock->block_gsr_len && sock->block_gsr_len < IP_MAX_MEMBERSHIPS) {
+				memcpy (&sock->block_gsr[sock->block_gsr_len], gsr, sizeof(struct group_source_req));
+				sock->block_gsr_len++;
+				if (sock->is_bound)
+					pgm_filter_update (sock);
+			}
 		}
 		status = TRUE;
 		break;
@@ -1748,6 +2132,18 @@ pgm_setsockopt (
 				break;
 			if (SOCKET_ERROR == pgm_sockaddr_unblock_source (sock->recv_sock, sock->family, gsr))
 				break;
+			for (unsigned i = 0; i < sock->block_gsr_len; i++)
+			{
+				if (pgm_sockaddr_cmp ((const struct sockaddr*)&gsr->gsr_group,  (struct sockaddr*)&sock->block_gsr[i].gsr_group)  == 0 &&
+				    pgm_sockaddr_cmp ((const struct sockaddr*)&gsr->gsr_source, (struct sockaddr*)&sock->block_gsr[i].gsr_source) == 0)
+				{
+					sock->block_gsr_len--;
+					memmove (&sock->block_gsr[i], &sock->block_gsr[i+1], (sock->block_gsr_len - i) * sizeof(struct group_source_req));
+					if (sock->is_bound)
+						pgm_filter_update (sock);
+					break;
+				}
+			}
 		}
 		status = TRUE;
 		break;
@@ -1797,6 +2193,8 @@ pgm_setsockopt (
 				break;
 			memcpy (&sock->recv_gsr[sock->recv_gsr_len], gsr, sizeof(struct group_source_req));
 			sock->recv_gsr_len++;
+			if (sock->is_bound)
+				pgm_filter_update (sock);
 		}
 		status = TRUE;
 		break;
@@ -1825,6 +2223,8 @@ pgm_setsockopt (
 					}
 				}
 			}
+			if (sock->is_bound)
+				pgm_filter_update (sock);
 			if (PGM_UNLIKELY(sock->family != gsr->gsr_group.ss_family))
 				break;
 			if (PGM_UNLIKELY(sock->family != gsr->gsr_source.ss_family))
@@ -1871,6 +2271,46 @@ pgm_setsockopt (
 		status = TRUE;
 		break;
 
+/* number of datagrams read per system call, requires recvmmsg().
+ * 0 < batch <= PGM_MAX_RECV_BATCH, 1 disables batching.
+ */
+	case PGM_RECV_BATCH:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		if (PGM_UNLIKELY(sock->is_bound))
+			break;
+		if (PGM_UNLIKELY(*(const int*)optval <= 0))
+			break;
+		if (PGM_UNLIKELY(*(const int*)optval > PGM_MAX_RECV_BATCH))
+			break;
+#ifndef HAVE_RECVMMSG
+		if (PGM_UNLIKELY(*(const int*)optval > 1))
+			break;
+#endif
+		sock->rx_batch_len = *(const int*)optval;
+		status = TRUE;
+		break;
+
+/* number of original data packets, or queued selective repairs, written per system call,
+ * requires sendmmsg().  0 < burst <= PGM_MAX_SEND_BURST, 1 disables burst transmit.
+ */
+	case PGM_SEND_BURST:
+		if (PGM_UNLIKELY(optlen != sizeof (int)))
+			break;
+		if (PGM_UNLIKELY(sock->is_bound))
+			break;
+		if (PGM_UNLIKELY(*(const int*)optval <= 0))
+			break;
+		if (PGM_UNLIKELY(*(const int*)optval > PGM_MAX_SEND_BURST))
+			break;
+#ifndef HAVE_SENDMMSG
+		if (PGM_UNLIKELY(*(const int*)optval > 1))
+			break;
+#endif
+		sock->tx_burst_len = *(const int*)optval;
+		status = TRUE;
+		break;
+
 /** read-only options **/
 	case PGM_MSSS:
 	case PGM_MSS:
@@ -1882,6 +2322,14 @@ pgm_setsockopt (
 	case PGM_ACK_SOCK:
 	case PGM_TIME_REMAIN:
 	case PGM_RATE_REMAIN:
+	case PGM_RECV_BATCH_FILL:
+	case PGM_SKB_POOL_HITS:
+	case PGM_SKB_POOL_MISSES:
+	case PGM_SKB_POOL_HIGH_WATER:
+	case PGM_SEND_BURST_FILL:
+	case PGM_RXW_RESERVED:
+	case PGM_RXW_USED:
+	case PGM_STATS:
 	default:
 		break;
 	}
@@ -2125,6 +2573,20 @@ pgm_bind3 (
 		pgm_rwlock_writer_unlock (&sock->lock);
 		return FALSE;
 	}
+	if (sock->can_recv_data &&
+	    sock->rx_ring_len &&
+	    0 != pgm_notify_init (&sock->ring_notify))
+	{
+		const int save_errno = pgm_get_last_sock_error();
+		char errbuf[1024];
+		pgm_set_error (error,
+			       PGM_ERROR_DOMAIN_SOCKET,
+			       pgm_error_from_sock_errno (save_errno),
+			       _("Creating receive ring notification channel: %s"),
+			       pgm_sock_strerror_s (errbuf, sizeof (errbuf), save_errno));
+		pgm_rwlock_writer_unlock (&sock->lock);
+		return FALSE;
+	}
 
 /* determine IP header size for rate regulation engine & stats */
 	sock->iphdr_len = (AF_INET == sock->family) ? sizeof(struct pgm_ip) : sizeof(struct pgm_ip6_hdr);
@@ -2147,7 +2609,7 @@ pgm_bind3 (
 		pgm_trace (PGM_LOG_ROLE_TX_WINDOW,_("Create transmit window."));
 		sock->window = sock->txw_sqns ?
 					pgm_txw_create (&sock->tsi,
-							0,			/* MAX_TPDU */
+							sock->max_tpdu,		/* MAX_TPDU */
 							sock->txw_sqns,		/* TXW_SQNS */
 							0,			/* TXW_SECS */
 							0,			/* TXW_MAX_RTE */
@@ -2167,7 +2629,7 @@ pgm_bind3 (
 
 /* create peer list */
 	if (sock->can_recv_data) {
-		sock->peers_hashtable = pgm_hashtable_new (pgm_tsi_hash, pgm_tsi_equal);
+		sock->peers_hashtable = pgm_tsitable_new ();
 		pgm_assert (NULL != sock->peers_hashtable);
 	}
 
@@ -2365,6 +2827,23 @@ pgm_bind3 (
 			pgm_trace (PGM_LOG_ROLE_RATE_CONTROL,_("Setting rate regulation to %" PRIzd " bytes per second."),
 					sock->txw_max_rte);
 			pgm_rate_create (&sock->rate_control, sock->txw_max_rte, sock->iphdr_len, sock->max_tpdu);
+/* kernel pacing keeps the bucket as a bound on queued data */
+			if (PGM_PACING_KERNEL == sock->txw_pacing) {
+				if (SOCKET_ERROR == pgm_sockaddr_pacing_rate (sock->send_sock, sock->txw_max_rte) ||
+				    SOCKET_ERROR == pgm_sockaddr_pacing_rate (sock->send_with_router_alert_sock, sock->txw_max_rte))
+				{
+					char errbuf[1024];
+					const int save_errno = pgm_get_last_sock_error();
+					pgm_warn (_("Kernel pacing unavailable, falling back to library pacing: %s"),
+						  pgm_sock_strerror_s (errbuf, sizeof (errbuf), save_errno));
+					sock->txw_pacing = PGM_PACING_USER;
+				} else
+					pgm_trace (PGM_LOG_ROLE_RATE_CONTROL,_("Enable kernel pacing."));
+			}
+			if (PGM_PACING_USER == sock->txw_pacing) {
+				pgm_trace (PGM_LOG_ROLE_RATE_CONTROL,_("Enable packet pacing."));
+				pgm_rate_set_pacing (&sock->rate_control, sock->max_tpdu);
+			}
 			sock->is_controlled_spm   = TRUE;	/* must always be set */
 		} else
 			sock->is_controlled_spm   = FALSE;
@@ -2383,8 +2862,52 @@ pgm_bind3 (
 		}
 	}
 
+/* packet buffer pools sized to one full window plus in-flight buffers, further
+ * peers and oversized requests fall back to the heap.
+ */
+	if (sock->can_send_data) {
+		const uint32_t tx_pool_len = (uint32_t)pgm_txw_max_length (sock->window) + 1;
+		pgm_build_header_templates (sock);
+		pgm_trace (PGM_LOG_ROLE_TX_WINDOW,_("Create transmit buffer pool of %" PRIu32 " packets."), tx_pool_len);
+		sock->tx_pool = pgm_skb_pool_create (tx_pool_len, sock->max_tpdu);
+		if (sock->tx_burst_len > 1) {
+			pgm_trace (PGM_LOG_ROLE_NETWORK,_("Create transmit burst of %u datagrams."), sock->tx_burst_len);
+			sock->tx_burst = pgm_send_burst_create (sock->tx_burst_len);
+			sock->rdata_burst = pgm_send_burst_create (sock->tx_burst_len);
+		}
+		if (sock->zerocopy_min > 0) {
+			if (SOCKET_ERROR == pgm_sockaddr_zerocopy (sock->send_sock, TRUE) ||
+			    NULL == (sock->zerocopy = pgm_zerocopy_create ()))
+			{
+				char errbuf[1024];
+				const int save_errno = pgm_get_last_sock_error();
+				pgm_warn (_("Zero-copy transmit unavailable, falling back to copying: %s"),
+					  pgm_sock_strerror_s (errbuf, sizeof (errbuf), save_errno));
+			} else
+				pgm_trace (PGM_LOG_ROLE_NETWORK,_("Enable zero-copy transmit of %u byte or larger packets."), sock->zerocopy_min);
+		}
+	}
+	if (sock->can_recv_data) {
+		const unsigned rxw_sqns = sock->rxw_sqns ? sock->rxw_sqns : (unsigned)( (sock->rxw_secs * sock->rxw_max_rte) / sock->max_tpdu );
+		const uint32_t rx_pool_len = rxw_sqns + sock->rx_batch_len + 1;
+		pgm_trace (PGM_LOG_ROLE_RX_WINDOW,_("Create receive buffer pool of %" PRIu32 " packets."), rx_pool_len);
+		sock->rx_pool = pgm_skb_pool_create (rx_pool_len, sock->max_tpdu);
+	}
+
 /* allocate first incoming packet buffer */
-	sock->rx_buffer = pgm_alloc_skb (sock->max_tpdu);
+	sock->rx_buffer = pgm_skb_pool_alloc (sock->rx_pool, sock->max_tpdu);
+	if (sock->rx_batch_len > 1) {
+		pgm_trace (PGM_LOG_ROLE_NETWORK,_("Create receive batch of %u datagrams."), sock->rx_batch_len);
+		sock->rx_batch = pgm_recv_batch_create (sock->rx_batch_len, sock->rx_pool, sock->max_tpdu);
+	}
+	if (sock->can_recv_data && sock->rx_ring_len) {
+		pgm_trace (PGM_LOG_ROLE_NETWORK,_("Create receive ring of %u APDUs."), sock->rx_ring_len);
+		sock->rx_ring = pgm_ring_create (sock->rx_ring_len);
+		pgm_atomic_write32 (&sock->rx_thread_status, PGM_IO_STATUS_NORMAL);
+	}
+
+/* drop unwanted packets before they reach user space */
+	pgm_filter_update (sock);
 
 /* bind complete */
 	sock->is_bound = TRUE;
@@ -2464,6 +2987,13 @@ pgm_connect (
 
 /* cleanup */
 	pgm_rwlock_writer_unlock (&sock->lock);
+
+/* network thread runs under the reader lock */
+	if (sock->rx_ring &&
+	    !pgm_recv_thread_create (sock, error))
+	{
+		return FALSE;
+	}
 	pgm_debug ("PGM socket successfully connected.");
 	return TRUE;
 }
@@ -2518,7 +3048,18 @@ pgm_select_info (
 
 	const bool is_congested = (sock->use_pgmcc && sock->tokens < pgm_fp8 (1)) ? TRUE : FALSE;
 
-	if (readfds)
+	if (readfds && sock->rx_ring)
+	{
+/* network thread owns the receive socket */
+		const SOCKET ring_fd = pgm_notify_get_socket (&sock->ring_notify);
+		FD_SET(ring_fd, readfds);
+#ifndef _WIN32
+		fds = ring_fd + 1;
+#else
+		fds = 1;
+#endif
+	}
+	else if (readfds)
 	{
 		FD_SET(sock->recv_sock, readfds);
 #ifndef _WIN32
@@ -2620,8 +3161,16 @@ pgm_wsapoll_info (
 		return SOCKET_ERROR;
 	}
 
+/* network thread owns the receive socket */
+	if (events & PGM_POLLIN && sock->rx_ring)
+	{
+		pgm_assert ( (1 + nfds) <= *n_fds );
+		fds[nfds].fd = pgm_notify_get_socket (&sock->ring_notify);
+		fds[nfds].events = PGM_POLLIN;
+		nfds++;
+	}
 /* we currently only support one incoming socket */
-	if (events & PGM_POLLIN)
+	else if (events & PGM_POLLIN)
 	{
 		pgm_assert ( (1 + nfds) <= *n_fds );
 		fds[nfds].fd = sock->recv_sock;
@@ -2688,7 +3237,16 @@ pgm_epoll_ctl (
 		return SOCKET_ERROR;
 	}
 
-	if (events & EPOLLIN)
+	if (events & EPOLLIN && sock->rx_ring)
+	{
+/* network thread owns the receive socket */
+		event.events = events & (EPOLLIN | EPOLLET | EPOLLONESHOT);
+		event.data.ptr = sock;
+		retval = epoll_ctl (epfd, op, pgm_notify_get_socket (&sock->ring_notify), &event);
+		if (retval)
+			goto out;
+	}
+	else if (events & EPOLLIN)
 	{
 		event.events = events & (EPOLLIN | EPOLLET | EPOLLONESHOT);
 		event.data.ptr = sock;
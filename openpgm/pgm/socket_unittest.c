@@ -58,6 +58,8 @@
 #define pgm_peer_unref		mock_pgm_peer_unref
 #define pgm_on_nak_notify	mock_pgm_on_nak_notify
 #define pgm_send_spm		mock_pgm_send_spm
+#define pgm_build_header_templates	mock_pgm_build_header_templates
+#define pgm_filter_update	mock_pgm_filter_update
 #define pgm_timer_prepare	mock_pgm_timer_prepare
 #define pgm_timer_check		mock_pgm_timer_check
 #define pgm_timer_expiration	mock_pgm_timer_expiration
@@ -70,6 +72,12 @@
 #define pgm_rs_create		mock_pgm_rs_create
 #define pgm_rs_destroy		mock_pgm_rs_destroy
 #define pgm_time_update_now	mock_pgm_time_update_now
+#define pgm_recv_batch_create	mock_pgm_recv_batch_create
+#define pgm_recv_batch_destroy	mock_pgm_recv_batch_destroy
+#define pgm_send_burst_create	mock_pgm_send_burst_create
+#define pgm_send_burst_destroy	mock_pgm_send_burst_destroy
+#define pgm_recv_thread_create	mock_pgm_recv_thread_create
+#define pgm_recv_thread_join	mock_pgm_recv_thread_join
 
 #define SOCK_DEBUG
 #include "socket.c"
@@ -221,6 +229,24 @@ mock_pgm_send_spm (
 	return TRUE;
 }
 
+PGM_GNUC_INTERNAL
+void
+mock_pgm_build_header_templates (
+	pgm_sock_t* const	sock
+	)
+{
+}
+
+/** filter module */
+PGM_GNUC_INTERNAL
+bool
+mock_pgm_filter_update (
+	pgm_sock_t* const	sock
+	)
+{
+	return TRUE;
+}
+
 /** timer module */
 PGM_GNUC_INTERNAL
 bool
@@ -234,7 +260,8 @@ mock_pgm_timer_prepare (
 PGM_GNUC_INTERNAL
 bool
 mock_pgm_timer_check (
-	pgm_sock_t* const		sock
+	pgm_sock_t* const		sock,
+	const pgm_time_t		now
 	)
 {
 	return FALSE;
@@ -243,7 +270,8 @@ mock_pgm_timer_check (
 PGM_GNUC_INTERNAL
 pgm_time_t
 mock_pgm_timer_expiration (
-	pgm_sock_t* const		sock
+	pgm_sock_t* const		sock,
+	const pgm_time_t		now
 	)
 {
 	return 100L;
@@ -252,7 +280,8 @@ mock_pgm_timer_expiration (
 PGM_GNUC_INTERNAL
 bool
 mock_pgm_timer_dispatch (
-	pgm_sock_t* const		sock
+	pgm_sock_t* const		sock,
+	const pgm_time_t		now
 	)
 {
 	return TRUE;
@@ -330,6 +359,64 @@ mock_pgm_rs_destroy (
 {
 }
 
+/** net module */
+PGM_GNUC_INTERNAL
+struct pgm_recv_batch_t*
+mock_pgm_recv_batch_create (
+	const unsigned		batch_len,
+	pgm_skb_pool_t*const	pool,
+	const uint16_t		max_tpdu
+	)
+{
+	return g_new0 (struct pgm_recv_batch_t, 1);
+}
+
+PGM_GNUC_INTERNAL
+void
+mock_pgm_recv_batch_destroy (
+	struct pgm_recv_batch_t*	batch
+	)
+{
+	g_free (batch);
+}
+
+PGM_GNUC_INTERNAL
+struct pgm_send_burst_t*
+mock_pgm_send_burst_create (
+	const unsigned		burst_len
+	)
+{
+	return g_new0 (struct pgm_send_burst_t, 1);
+}
+
+PGM_GNUC_INTERNAL
+void
+mock_pgm_send_burst_destroy (
+	struct pgm_send_burst_t*	burst
+	)
+{
+	g_free (burst);
+}
+
+PGM_GNUC_INTERNAL
+bool
+mock_pgm_recv_thread_create (
+	pgm_sock_t*const	sock,
+	pgm_error_t**		error
+	)
+{
+	sock->has_rx_thread = TRUE;
+	return TRUE;
+}
+
+PGM_GNUC_INTERNAL
+void
+mock_pgm_recv_thread_join (
+	pgm_sock_t*const	sock
+	)
+{
+}
+
 /** time module */
 static pgm_time_t _mock_pgm_time_update_now (void);
 pgm_time_update_func mock_pgm_time_update_now = _mock_pgm_time_update_now;
@@ -27,6 +27,7 @@
 #include <impl/framework.h>
 #include <impl/socket.h>
 #include <impl/source.h>
+#include <impl/timer.h>
 #include <impl/sqn_list.h>
 #include <impl/packet_parse.h>
 #include <impl/net.h>
@@ -45,10 +46,13 @@ static inline bool peer_is_peer (const pgm_peer_t*) PGM_GNUC_CONST;
 static void reset_heartbeat_spm (pgm_sock_t*const, const pgm_time_t);
 static bool send_ncf (pgm_sock_t*const restrict, const struct sockaddr*const restrict, const struct sockaddr*const restrict, const uint32_t, const bool);
 static bool send_ncf_list (pgm_sock_t*const restrict, const struct sockaddr*const restrict, const struct sockaddr*const restrict, struct pgm_sqn_list_t*const restrict, const bool);
+static void send_ncf_pending (pgm_sock_t*const, const bool);
+static void aggregate_nak (pgm_sock_t*const restrict, const struct sockaddr*const restrict, const struct sockaddr*const restrict, const struct pgm_sqn_list_t*const restrict, const bool, const pgm_time_t);
 static int send_odata (pgm_sock_t*const restrict, struct pgm_sk_buff_t*const restrict, size_t*restrict);
 static int send_odata_copy (pgm_sock_t*const restrict, const void*restrict, const uint16_t, size_t*restrict);
 static int send_odatav (pgm_sock_t*const restrict, const struct pgm_iovec*const restrict, const unsigned, size_t*restrict);
 static bool send_rdata (pgm_sock_t*restrict, struct pgm_sk_buff_t*restrict);
+static bool send_rdata_burst (pgm_sock_t*const, unsigned);
 
 
 static inline
@@ -159,10 +163,41 @@ pgm_on_deferred_nak (
  * has been retransmitted.
  */
 	pgm_spinlock_lock (&sock->txw_spinlock);
+
+/* drain consecutive selective repairs in one write when burst transmission is enabled */
+	if (NULL != sock->rdata_burst) {
+		struct pgm_send_burst_t* burst = sock->rdata_burst;
+		unsigned count = pgm_txw_retransmit_try_peek_selective (sock->window, burst->skb, burst->len);
+		if (count > 1) {
+			for (unsigned i = 0; i < count; i++)
+				burst->skb[i] = pgm_skb_get (burst->skb[i]);
+			pgm_spinlock_unlock (&sock->txw_spinlock);
+/* repairs are rewritten in place, stop the batch before any zero-copy send in flight */
+			if (NULL != sock->zerocopy) {
+				unsigned n = 0;
+				while (n < count && !pgm_zerocopy_is_pending (sock->zerocopy, sock->send_sock, burst->skb[n]))
+					n++;
+				for (unsigned i = MAX(n, 1); i < count; i++)
+					pgm_free_skb (burst->skb[i]);
+				count = n;
+				if (count <= 1) {
+					skb = burst->skb[0];
+					goto send_one;
+				}
+			}
+			if (!send_rdata_burst (sock, count)) {
+				pgm_notify_send (&sock->rdata_notify);
+				return FALSE;
+			}
+			return TRUE;
+		}
+	}
+
 	skb = pgm_txw_retransmit_try_peek (sock->window);
 	if (skb) {
 		skb = pgm_skb_get (skb);
 		pgm_spinlock_unlock (&sock->txw_spinlock);
+send_one:
 		if (!send_rdata (sock, skb)) {
 			pgm_free_skb (skb);
 			pgm_notify_send (&sock->rdata_notify);
@@ -302,18 +337,18 @@ pgm_on_nak (
 
 	const bool is_parity = skb->pgm_header->pgm_options & PGM_OPT_PARITY;
 	if (is_parity) {
-		sock->cumulative_stats[PGM_PC_SOURCE_PARITY_NAKS_RECEIVED]++;
+		pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_PARITY_NAKS_RECEIVED);
 		if (!sock->use_ondemand_parity) {
 			pgm_trace (PGM_LOG_ROLE_NETWORK,_("Parity NAK rejected as on-demand parity is not enabled."));
-			sock->cumulative_stats[PGM_PC_SOURCE_MALFORMED_NAKS]++;
+			pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_MALFORMED_NAKS);
 			return FALSE;
 		}
 	} else
-		sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED]++;
+		pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_SELECTIVE_NAKS_RECEIVED);
 
 	if (PGM_UNLIKELY(!pgm_verify_nak (skb))) {
 		pgm_trace (PGM_LOG_ROLE_NETWORK,_("Malformed NAK rejected on verification."));
-		sock->cumulative_stats[PGM_PC_SOURCE_MALFORMED_NAKS]++;
+		pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_MALFORMED_NAKS);
 		return FALSE;
 	}
 
@@ -327,7 +362,7 @@ pgm_on_nak (
 		char saddr[INET6_ADDRSTRLEN];
 		pgm_sockaddr_ntop ((struct sockaddr*)&nak_src_nla, saddr, sizeof(saddr));
 		pgm_trace (PGM_LOG_ROLE_NETWORK,_("NAK rejected for unmatched NLA: %s"), saddr);
-		sock->cumulative_stats[PGM_PC_SOURCE_MALFORMED_NAKS]++;
+		pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_MALFORMED_NAKS);
 		return FALSE;
 	}
 
@@ -338,7 +373,7 @@ pgm_on_nak (
 		char sgroup[INET6_ADDRSTRLEN];
 		pgm_sockaddr_ntop ((struct sockaddr*)&nak_src_nla, sgroup, sizeof(sgroup));
 		pgm_trace (PGM_LOG_ROLE_NETWORK,_("NAK rejected as targeted for different multicast group: %s"), sgroup);
-		sock->cumulative_stats[PGM_PC_SOURCE_MALFORMED_NAKS]++;
+		pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_MALFORMED_NAKS);
 		return FALSE;
 	}
 
@@ -359,12 +394,12 @@ pgm_on_nak (
 				(const struct pgm_opt_length*)(nak  + 1);
 		if (PGM_UNLIKELY(opt_len->opt_type != PGM_OPT_LENGTH)) {
 			pgm_trace (PGM_LOG_ROLE_NETWORK,_("Malformed NAK rejected on unexpected primary PGM option type."));
-			sock->cumulative_stats[PGM_PC_SOURCE_MALFORMED_NAKS]++;
+			pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_MALFORMED_NAKS);
 			return FALSE;
 		}
 		if (PGM_UNLIKELY(opt_len->opt_length != sizeof(struct pgm_opt_length))) {
 			pgm_trace (PGM_LOG_ROLE_NETWORK,_("Malformed NAK rejected on length of length option header."));
-			sock->cumulative_stats[PGM_PC_SOURCE_MALFORMED_NAKS]++;
+			pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_MALFORMED_NAKS);
 			return FALSE;
 		}
 /* TODO: check for > 16 options & past packet end */
@@ -391,6 +426,12 @@ pgm_on_nak (
 		nak_list++;
 	}
 
+/* aggregate confirmations over ncf_ivl */
+	if (sock->ncf_ivl > 0) {
+		aggregate_nak (sock, (struct sockaddr*)&nak_src_nla, (struct sockaddr*)&nak_grp_nla, &sqn_list, is_parity, skb->tstamp);
+		return TRUE;
+	}
+
 /* send NAK confirm packet immediately, then defer to timer thread for a.s.a.p
  * delivery of the actual RDATA packets.  blocking send for NCF is ignored as RDATA
  * broadcast will be sent later.
@@ -405,11 +446,133 @@ pgm_on_nak (
 		const bool push_status = pgm_txw_retransmit_push (sock->window, sqn_list.sqn[i], is_parity, sock->tg_sqn_shift);
 		if (PGM_UNLIKELY(!push_status)) {
 			pgm_trace (PGM_LOG_ROLE_TX_WINDOW,_("Failed to push retransmit request for #%" PRIu32), sqn_list.sqn[i]);
+			continue;
 		}
+#ifdef USE_HISTOGRAMS
+/* stamp selective repairs for RDATA dwell time */
+		if (!is_parity)
+			pgm_txw_set_nak_tstamp (pgm_txw_peek (sock->window, sqn_list.sqn[i]), skb->tstamp);
+#endif
 	}
 	return TRUE;
 }
 
+/* NAK storm control: when many receivers lose the same packet the source sees
+ * one NAK per receiver.  The first NAK for a sequence queues the repair and
+ * joins the pending NCF list, repeats are ignored while the repair is queued
+ * or within ncf_ivl of the confirmation as the multicast NCF and RDATA will
+ * reach every receiver.  The pending list carries the NLAs of its NAKs, a NAK
+ * with different NLAs first flushes the list.
+ */
+
+static
+void
+aggregate_nak (
+	pgm_sock_t*		     const restrict sock,
+	const struct sockaddr*	     const restrict nak_src_nla,
+	const struct sockaddr*	     const restrict nak_grp_nla,
+	const struct pgm_sqn_list_t* const restrict sqn_list,
+	const bool				    is_parity,
+	const pgm_time_t			    now
+	)
+{
+	struct pgm_ncf_pending_t* pending = &sock->ncf_pending[ is_parity ? 1 : 0 ];
+
+/* pre-conditions */
+	pgm_assert (NULL != sock);
+	pgm_assert (NULL != nak_src_nla);
+	pgm_assert (NULL != nak_grp_nla);
+	pgm_assert (NULL != sqn_list);
+	pgm_assert (sock->ncf_ivl > 0);
+
+	if (pending->sqn_list.len > 0 &&
+	    (0 != pgm_sockaddr_cmp (nak_src_nla, (struct sockaddr*)&pending->src_nla) ||
+	     0 != pgm_sockaddr_cmp (nak_grp_nla, (struct sockaddr*)&pending->grp_nla)))
+	{
+		send_ncf_pending (sock, is_parity);
+	}
+	if (0 == pending->sqn_list.len) {
+		memcpy (&pending->src_nla, nak_src_nla, pgm_sockaddr_len (nak_src_nla));
+		memcpy (&pending->grp_nla, nak_grp_nla, pgm_sockaddr_len (nak_grp_nla));
+	}
+
+	for (uint_fast8_t i = 0; i < sqn_list->len; i++)
+	{
+		const uint32_t sequence = sqn_list->sqn[i];
+		if (is_parity)
+		{
+/* parity requests for a queued transmission group only raise the packet count */
+			if (!pgm_txw_retransmit_push (sock->window, sequence, TRUE, sock->tg_sqn_shift)) {
+				pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_PARITY_NAKS_IGNORED);
+				continue;
+			}
+		}
+		else
+		{
+			struct pgm_sk_buff_t* skb = pgm_txw_peek (sock->window, sequence);
+			if (NULL == skb) {
+				pgm_trace (PGM_LOG_ROLE_TX_WINDOW,_("Requested packet #%" PRIu32 " not in window."), sequence);
+				continue;
+			}
+			if (pgm_time_after (pgm_txw_get_ncf_expiry (skb), now) ||
+			    !pgm_txw_retransmit_push (sock->window, sequence, FALSE, sock->tg_sqn_shift))
+			{
+				pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_SELECTIVE_NAKS_IGNORED);
+				continue;
+			}
+			pgm_txw_set_ncf_expiry (skb, now + sock->ncf_ivl);
+			pgm_txw_set_nak_tstamp (skb, now);
+		}
+		pending->sqn_list.sqn[ pending->sqn_list.len++ ] = sequence;
+		if (PGM_N_ELEMENTS(pending->sqn_list.sqn) == pending->sqn_list.len)
+			send_ncf_pending (sock, is_parity);
+	}
+
+/* wake the timer for the first confirmation of an interval */
+	if (pending->sqn_list.len > 0 && 0 == sock->ncf_expiry) {
+		sock->ncf_expiry = now + sock->ncf_ivl;
+		pgm_timer_lock (sock);
+		if (pgm_time_after (sock->next_poll, sock->ncf_expiry))
+			sock->next_poll = sock->ncf_expiry;
+		pgm_timer_unlock (sock);
+	}
+}
+
+static
+void
+send_ncf_pending (
+	pgm_sock_t* const	sock,
+	const bool		is_parity
+	)
+{
+	struct pgm_ncf_pending_t* pending = &sock->ncf_pending[ is_parity ? 1 : 0 ];
+
+	if (1 == pending->sqn_list.len)
+		send_ncf (sock, (struct sockaddr*)&pending->src_nla, (struct sockaddr*)&pending->grp_nla, pending->sqn_list.sqn[0], is_parity);
+	else if (pending->sqn_list.len > 1)
+		send_ncf_list (sock, (struct sockaddr*)&pending->src_nla, (struct sockaddr*)&pending->grp_nla, &pending->sqn_list, is_parity);
+	pending->sqn_list.len = 0;
+}
+
+/* send NCFs aggregated over the last interval, called from the timer.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_send_deferred_ncf (
+	pgm_sock_t* const	sock
+	)
+{
+/* pre-conditions */
+	pgm_assert (NULL != sock);
+
+	pgm_debug ("pgm_send_deferred_ncf (sock:%p)", (const void*)sock);
+
+	send_ncf_pending (sock, FALSE);
+	send_ncf_pending (sock, TRUE);
+	sock->ncf_expiry = 0;
+}
+
 /* Null-NAK, or N-NAK propogated by a DLR for hand waving excitement
  *
  * if NNAK is valid, returns TRUE.  on error, FALSE is returned.
@@ -434,10 +597,10 @@ pgm_on_nnak (
 	pgm_debug ("pgm_on_nnak (sock:%p skb:%p)",
 		(void*)sock, (void*)skb);
 
-	sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NNAK_PACKETS_RECEIVED]++;
+	pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_SELECTIVE_NNAK_PACKETS_RECEIVED);
 
 	if (PGM_UNLIKELY(!pgm_verify_nnak (skb))) {
-		sock->cumulative_stats[PGM_PC_SOURCE_NNAK_ERRORS]++;
+		pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_NNAK_ERRORS);
 		return FALSE;
 	}
 
@@ -449,7 +612,7 @@ pgm_on_nnak (
 
 	if (PGM_UNLIKELY(pgm_sockaddr_cmp ((struct sockaddr*)&nnak_src_nla, (struct sockaddr*)&sock->send_addr) != 0))
 	{
-		sock->cumulative_stats[PGM_PC_SOURCE_NNAK_ERRORS]++;
+		pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_NNAK_ERRORS);
 		return FALSE;
 	}
 
@@ -457,7 +620,7 @@ pgm_on_nnak (
 	pgm_nla_to_sockaddr ((AF_INET6 == nnak_src_nla.ss_family) ? &nnak6->nak6_grp_nla_afi : &nnak->nak_grp_nla_afi, (struct sockaddr*)&nnak_grp_nla);
 	if (PGM_UNLIKELY(pgm_sockaddr_cmp ((struct sockaddr*)&nnak_grp_nla, (struct sockaddr*)&sock->send_gsr.gsr_group) != 0))
 	{
-		sock->cumulative_stats[PGM_PC_SOURCE_NNAK_ERRORS]++;
+		pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_NNAK_ERRORS);
 		return FALSE;
 	}
 
@@ -468,11 +631,11 @@ pgm_on_nnak (
 							(const struct pgm_opt_length*)(nnak6 + 1) :
 							(const struct pgm_opt_length*)(nnak + 1);
 		if (PGM_UNLIKELY(opt_len->opt_type != PGM_OPT_LENGTH)) {
-			sock->cumulative_stats[PGM_PC_SOURCE_NNAK_ERRORS]++;
+			pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_NNAK_ERRORS);
 			return FALSE;
 		}
 		if (PGM_UNLIKELY(opt_len->opt_length != sizeof(struct pgm_opt_length))) {
-			sock->cumulative_stats[PGM_PC_SOURCE_NNAK_ERRORS]++;
+			pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_NNAK_ERRORS);
 			return FALSE;
 		}
 /* TODO: check for > 16 options & past packet end */
@@ -486,7 +649,7 @@ pgm_on_nnak (
 		} while (!(opt_header->opt_type & PGM_OPT_END));
 	}
 
-	sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_NNAKS_RECEIVED] += 1 + nnak_list_len;
+	pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_SELECTIVE_NNAKS_RECEIVED, 1 + nnak_list_len);
 	return TRUE;
 }
 
@@ -514,10 +677,10 @@ pgm_on_ack (
 	pgm_debug ("pgm_on_ack (sock:%p skb:%p)",
 		(const void*)sock, (const void*)skb);
 
-	sock->cumulative_stats[PGM_PC_SOURCE_ACK_PACKETS_RECEIVED]++;
+	pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_ACK_PACKETS_RECEIVED);
 
 	if (PGM_UNLIKELY(!pgm_verify_ack (skb))) {
-		sock->cumulative_stats[PGM_PC_SOURCE_ACK_ERRORS]++;
+		pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_ACK_ERRORS);
 		return FALSE;
 	}
 
@@ -659,6 +822,49 @@ notify_tx:
 	return TRUE;
 }
 
+/* pre-build ODATA and SPM header templates from the bound socket identity, the
+ * type/options word and per-packet fields are excluded from the saved checksum.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_build_header_templates (
+	pgm_sock_t* const	sock
+	)
+{
+	struct pgm_header *header;
+	struct pgm_spm	  *spm;
+
+/* pre-conditions */
+	pgm_assert (NULL != sock);
+
+/* ODATA */
+	memset (sock->odata_template, 0, sizeof (sock->odata_template));
+	header = (struct pgm_header*)sock->odata_template;
+	memcpy (header->pgm_gsi, &sock->tsi.gsi, sizeof(pgm_gsi_t));
+	header->pgm_sport	= sock->tsi.sport;
+	header->pgm_dport	= sock->dport;
+	sock->unfolded_odata_template = pgm_csum_partial (header, (uint16_t)sizeof (sock->odata_template), 0);
+	header->pgm_type	= PGM_ODATA;
+
+/* SPM */
+	memset (sock->spm_template, 0, sizeof (sock->spm_template));
+	header = (struct pgm_header*)sock->spm_template;
+	spm = (struct pgm_spm*)(header + 1);
+	memcpy (header->pgm_gsi, &sock->tsi.gsi, sizeof(pgm_gsi_t));
+	header->pgm_sport	= sock->tsi.sport;
+	header->pgm_dport	= sock->dport;
+/* our nla */
+	pgm_sockaddr_to_nla ((struct sockaddr*)&sock->send_addr, (char*)&spm->spm_nla_afi);
+	sock->spm_template_len = sizeof(struct pgm_header);
+	if (AF_INET == sock->send_gsr.gsr_group.ss_family)
+		sock->spm_template_len += sizeof(struct pgm_spm);
+	else
+		sock->spm_template_len += sizeof(struct pgm_spm6);
+	sock->unfolded_spm_template = pgm_csum_partial (header, sock->spm_template_len, 0);
+	header->pgm_type	= PGM_SPM;
+}
+
 /* ambient/heartbeat SPM's
  *
  * heartbeat: ihb_tmr decaying between ihb_min and ihb_max 2x after last packet
@@ -677,7 +883,8 @@ pgm_send_spm (
 	char		  *buf;
 	struct pgm_header *header;
 	struct pgm_spm	  *spm;
-	struct pgm_spm6	  *spm6;
+	uint16_t	   type_options;
+	uint32_t	   unfolded_header;
 	ssize_t		   sent;
 
 /* pre-conditions */
@@ -687,11 +894,7 @@ pgm_send_spm (
 	pgm_debug ("pgm_send_spm (sock:%p flags:%d)",
 		(const void*)sock, flags);
 
-	tpdu_length = sizeof(struct pgm_header);
-	if (AF_INET == sock->send_gsr.gsr_group.ss_family)
-		tpdu_length += sizeof(struct pgm_spm);
-	else
-		tpdu_length += sizeof(struct pgm_spm6);
+	tpdu_length = sock->spm_template_len;
 	if (sock->use_proactive_parity ||
 	    sock->use_ondemand_parity ||
 	    sock->is_pending_crqst ||
@@ -713,23 +916,18 @@ pgm_send_spm (
 				       sizeof(struct pgm_opt_fin);
 	}
 	buf = pgm_alloca (tpdu_length);
+	memcpy (buf, sock->spm_template, sock->spm_template_len);
 	header = (struct pgm_header*)buf;
 	spm  = (struct pgm_spm *)(header + 1);
-	spm6 = (struct pgm_spm6*)(header + 1);
-	memcpy (header->pgm_gsi, &sock->tsi.gsi, sizeof(pgm_gsi_t));
-	header->pgm_sport       = sock->tsi.sport;
-	header->pgm_dport       = sock->dport;
-	header->pgm_type        = PGM_SPM;
-	header->pgm_options     = 0;
-	header->pgm_tsdu_length = 0;
 
-/* SPM */
+/* SPM, IPv6 shares leading fields */
 	spm->spm_sqn		= pgm_htonl (sock->spm_sqn);
 	spm->spm_trail		= pgm_htonl (pgm_txw_trail_atomic (sock->window));
 	spm->spm_lead		= pgm_htonl (pgm_txw_lead_atomic (sock->window));
-	spm->spm_reserved	= 0;
-/* our nla */
-	pgm_sockaddr_to_nla ((struct sockaddr*)&sock->send_addr, (char*)&spm->spm_nla_afi);
+	unfolded_header = sock->unfolded_spm_template;
+	unfolded_header = add32_with_carry (unfolded_header, spm->spm_sqn);
+	unfolded_header = add32_with_carry (unfolded_header, spm->spm_trail);
+	unfolded_header = add32_with_carry (unfolded_header, spm->spm_lead);
 
 /* PGM options */
 	if (sock->use_proactive_parity ||
@@ -741,10 +939,7 @@ pgm_send_spm (
 		struct pgm_opt_length* opt_len;
 		uint16_t opt_total_length;
 
-		if (AF_INET == sock->send_gsr.gsr_group.ss_family)
-			opt_header = (struct pgm_opt_header*)(spm + 1);
-		else
-			opt_header = (struct pgm_opt_header*)(spm6 + 1);
+		opt_header = (struct pgm_opt_header*)(buf + sock->spm_template_len);
 		header->pgm_options |= PGM_OPT_PRESENT;
 		opt_len			= (struct pgm_opt_length*)opt_header;
 		opt_len->opt_type	= PGM_OPT_LENGTH;
@@ -806,11 +1001,15 @@ pgm_send_spm (
 
 		last_opt_header->opt_type |= PGM_OPT_END;
 		opt_len->opt_total_length = pgm_htons (opt_total_length);
+		unfolded_header = pgm_csum_block_add (unfolded_header,
+						      pgm_csum_partial (opt_len, opt_total_length, 0),
+						      sock->spm_template_len);
 	}
 
 /* checksum optional for SPMs */
-	header->pgm_checksum = 0;
-	header->pgm_checksum = pgm_csum_fold (pgm_csum_partial (buf, (uint16_t)tpdu_length, 0));
+	memcpy (&type_options, &header->pgm_type, sizeof (type_options));
+	unfolded_header = add32_with_carry (unfolded_header, type_options);
+	header->pgm_checksum = pgm_csum_fold (unfolded_header);
 
 	sent = pgm_sendto (sock,
 			   flags != PGM_OPT_SYN && sock->is_controlled_spm,	/* rate limited */
@@ -832,7 +1031,7 @@ pgm_send_spm (
 
 /* advance SPM sequence only on successful transmission */
 	sock->spm_sqn++;
-	pgm_atomic_add32 (&sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT], (uint32_t)tpdu_length);
+	pgm_stats_atomic_add (pgm_sock_stats (sock, PGM_STATS_APP), PGM_PC_SOURCE_BYTES_SENT, tpdu_length);
 	return TRUE;
 }
 
@@ -917,7 +1116,7 @@ send_ncf (
 		return FALSE;
 /* fall through silently on other errors */
 			
-	pgm_atomic_add32 (&sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT], (uint32_t)tpdu_length);
+	pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_BYTES_SENT, tpdu_length);
 	return TRUE;
 }
 
@@ -1032,7 +1231,7 @@ send_ncf_list (
 		return FALSE;
 /* fall through silently on other errors */
 
-	pgm_atomic_add32 (&sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT], (uint32_t)tpdu_length);
+	pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_BYTES_SENT, tpdu_length);
 	return TRUE;
 }
 
@@ -1065,6 +1264,216 @@ reset_heartbeat_spm (
  */
 #define STATE(x)	(sock->pkt_dontwait_state.x)
 
+/* complete the ODATA header template for one packet, returns the unfolded
+ * checksum of the PGM and data headers.
+ */
+
+static inline
+uint32_t
+prepare_odata (
+	pgm_sock_t*	      const restrict sock,
+	struct pgm_sk_buff_t* const restrict skb,
+	const uint16_t			     tsdu_length,
+	const uint8_t			     options
+	)
+{
+	uint16_t type_options;
+	uint32_t unfolded_header;
+
+	memcpy (skb->pgm_header, sock->odata_template, sizeof (sock->odata_template));
+	skb->pgm_header->pgm_options	 = options;
+	skb->pgm_header->pgm_tsdu_length = pgm_htons (tsdu_length);
+	skb->pgm_data->data_sqn		 = pgm_htonl (pgm_txw_next_lead(sock->window));
+	skb->pgm_data->data_trail	 = pgm_htonl (pgm_txw_trail(sock->window));
+
+	memcpy (&type_options, &skb->pgm_header->pgm_type, sizeof (type_options));
+	unfolded_header = sock->unfolded_odata_template;
+	unfolded_header = add32_with_carry (unfolded_header, type_options);
+	unfolded_header = add32_with_carry (unfolded_header, skb->pgm_header->pgm_tsdu_length);
+	unfolded_header = add32_with_carry (unfolded_header, skb->pgm_data->data_sqn);
+	unfolded_header = add32_with_carry (unfolded_header, skb->pgm_data->data_trail);
+	return unfolded_header;
+}
+
+/* fragmentation option header for one TSDU of a multi-packet APDU, appended
+ * after the data header and added to the unfolded header checksum.  returns
+ * the start of the payload.
+ */
+
+static
+void*
+add_opt_fragment (
+	pgm_sock_t*	      const restrict sock,
+	struct pgm_sk_buff_t* const restrict skb,
+	const size_t			     apdu_length,
+	uint32_t*		    restrict unfolded_header
+	)
+{
+	struct pgm_opt_header	*opt_header;
+	struct pgm_opt_length	*opt_len;
+	const uint16_t opt_total_length = (uint16_t)(sizeof(struct pgm_opt_length) +
+						     sizeof(struct pgm_opt_header) +
+						     sizeof(struct pgm_opt_fragment));
+
+/* OPT_LENGTH */
+	opt_len				= (struct pgm_opt_length*)(skb->pgm_data + 1);
+	opt_len->opt_type		= PGM_OPT_LENGTH;
+	opt_len->opt_length		= sizeof(struct pgm_opt_length);
+	opt_len->opt_total_length	= pgm_htons (opt_total_length);
+/* OPT_FRAGMENT */
+	opt_header			= (struct pgm_opt_header*)(opt_len + 1);
+	opt_header->opt_type		= PGM_OPT_FRAGMENT | PGM_OPT_END;
+	opt_header->opt_length		= sizeof(struct pgm_opt_header) +
+					  sizeof(struct pgm_opt_fragment);
+	skb->pgm_opt_fragment			= (struct pgm_opt_fragment*)(opt_header + 1);
+	skb->pgm_opt_fragment->opt_reserved	= 0;
+	skb->pgm_opt_fragment->opt_sqn		= pgm_htonl (STATE(first_sqn));
+	skb->pgm_opt_fragment->opt_frag_off	= pgm_htonl ((uint32_t)STATE(data_bytes_offset));
+	skb->pgm_opt_fragment->opt_frag_len	= pgm_htonl ((uint32_t)apdu_length);
+	*unfolded_header = pgm_csum_block_add (*unfolded_header,
+					       pgm_csum_partial (opt_len, opt_total_length, 0),
+					       sizeof(struct pgm_header) + sizeof(struct pgm_data));
+	return skb->pgm_opt_fragment + 1;
+}
+
+/* congestion control option header indicating elected peer for ACKs, appended
+ * after the data header and added to the unfolded header checksum.  returns
+ * the start of the payload.
+ */
+
+static
+void*
+add_opt_pgmcc_data (
+	pgm_sock_t*	      const restrict sock,
+	struct pgm_sk_buff_t* const restrict skb,
+	uint32_t*		    restrict unfolded_header
+	)
+{
+	struct pgm_opt_header	   *opt_header;
+	struct pgm_opt_length	   *opt_len;
+	struct pgm_opt_pgmcc_data  *pgmcc_data;
+	const size_t opt_pgmcc_data_len = ((AF_INET6 == sock->acker_nla.ss_family) ?
+						sizeof (struct pgm_opt6_pgmcc_data) :
+						sizeof (struct pgm_opt_pgmcc_data));
+	const uint16_t opt_total_length = (uint16_t)(sizeof (struct pgm_opt_length) +
+						     sizeof (struct pgm_opt_header) +
+						     opt_pgmcc_data_len);
+
+	opt_len = (struct pgm_opt_length*)(skb->pgm_data + 1);
+	opt_len->opt_type	= PGM_OPT_LENGTH;
+	opt_len->opt_length	= sizeof (struct pgm_opt_length);
+	opt_len->opt_total_length = pgm_htons (opt_total_length);
+	opt_header = (struct pgm_opt_header*)(opt_len + 1);
+	opt_header->opt_type	= PGM_OPT_PGMCC_DATA | PGM_OPT_END;
+	opt_header->opt_length	= sizeof (struct pgm_opt_header) +
+					opt_pgmcc_data_len;
+	opt_header->opt_reserved = 0;
+	pgmcc_data  = (struct pgm_opt_pgmcc_data *)(opt_header + 1);
+	pgmcc_data->opt_reserved = 0;
+	pgmcc_data->opt_tstamp = pgm_htonl ((uint32_t)pgm_to_msecs (skb->tstamp));
+/* acker nla */
+	pgm_sockaddr_to_nla ((struct sockaddr*)&sock->acker_nla, (char*)&pgmcc_data->opt_nla_afi);
+	*unfolded_header = pgm_csum_block_add (*unfolded_header,
+					       pgm_csum_partial (opt_len, opt_total_length, 0),
+					       sizeof (struct pgm_header) + sizeof (struct pgm_data));
+	return (char*)opt_len + opt_total_length;
+}
+
+/* flush the burst transmit queue of original data, accumulating statistics
+ * for the caller.
+ *
+ * returns TRUE when the queue has drained, returns FALSE if the send would
+ * block or exceeds the rate limit with the remaining wire size saved into
+ * pgm_sock_t::blocklen.
+ */
+
+static
+bool
+send_odata_burst (
+	pgm_sock_t*   const restrict	sock,
+	size_t*	      const restrict	bytes_sent,
+	unsigned*     const restrict	packets_sent,
+	size_t*	      const restrict	data_bytes_sent,
+	int*	      const restrict	save_errno
+	)
+{
+	struct pgm_send_burst_t* burst = sock->tx_burst;
+
+	pgm_assert (NULL != burst);
+
+	while (burst->head < burst->count)
+	{
+		const int consumed = pgm_sendto_burst (sock,
+						       !STATE(is_rate_limited),	/* rate limit on blocking */
+						       &sock->odata_rate_control,
+						       FALSE,				/* regular socket */
+						       burst,
+						       (struct sockaddr*)&sock->send_gsr.gsr_group,
+						       pgm_sockaddr_len((struct sockaddr*)&sock->send_gsr.gsr_group));
+		if (consumed < 0) {
+			*save_errno = pgm_get_last_sock_error();
+			sock->blocklen = 0;
+			for (unsigned i = burst->head; i < burst->count; i++)
+				sock->blocklen += ((char*)burst->skb[i]->tail - (char*)burst->skb[i]->head) + sock->iphdr_len;
+			return FALSE;
+		}
+
+		for (unsigned i = burst->head; i < burst->head + (unsigned)consumed; i++)
+		{
+			struct pgm_sk_buff_t* skb = burst->skb[i];
+			const size_t tpdu_length = (char*)skb->tail - (char*)skb->head;
+			if (PGM_LIKELY(burst->sent[i] == tpdu_length)) {
+				*bytes_sent += tpdu_length + sock->iphdr_len;	/* as counted at IP layer */
+				(*packets_sent)++;				/* IP packets */
+				*data_bytes_sent += skb->len;
+			}
+/* check for end of transmission group */
+			if (sock->use_proactive_parity) {
+				const uint32_t odata_sqn = pgm_ntohl (skb->pgm_data->data_sqn);
+				const uint32_t tg_sqn_mask = 0xffffffff << sock->tg_sqn_shift;
+				if (!((odata_sqn + 1) & ~tg_sqn_mask))
+					pgm_schedule_proactive_nak (sock, odata_sqn & tg_sqn_mask);
+			}
+			pgm_free_skb (skb);
+		}
+		burst->head += consumed;
+	}
+	burst->head = burst->count = 0;
+	return TRUE;
+}
+
+/* burst transmission requires the rate limit be either pre-checked or
+ * blocking as the bucket is charged for the entire burst at once.
+ */
+
+static inline
+bool
+can_send_burst (
+	const pgm_sock_t* const	sock
+	)
+{
+	return NULL != sock->tx_burst &&
+		(!sock->is_nonblocking ||
+		 STATE(is_rate_limited) ||
+		 (0 == sock->rate_control.rate_per_sec && 0 == sock->odata_rate_control.rate_per_sec));
+}
+
+/* a non-blocking APDU is checked against the rate limit as a whole before the
+ * first TPDU is sent.  Packet pacing shrinks the bucket to a single TPDU so a
+ * multi-TPDU APDU could never pass, it is instead limited per TPDU.
+ */
+
+static inline
+bool
+can_check_apdu_rate (
+	const pgm_sock_t* const	sock
+	)
+{
+	return sock->is_nonblocking &&
+		sock->is_controlled_odata &&
+		!(PGM_PACING_USER == sock->txw_pacing && 0 != sock->rate_control.rate_per_sec);
+}
+
 /* send one PGM data packet, transmit window owned memory.
  *
  * On success, returns PGM_IO_STATUS_NORMAL and the number of data bytes pushed
@@ -1087,6 +1496,7 @@ send_odata (
 	)
 {
 	void	*data;
+	uint32_t unfolded_header;
 	ssize_t	 sent;
 
 /* pre-conditions */
@@ -1114,45 +1524,11 @@ send_odata (
 
 	STATE(skb)->pgm_header = (struct pgm_header*)STATE(skb)->head;
 	STATE(skb)->pgm_data   = (struct pgm_data*)(STATE(skb)->pgm_header + 1);
-	memcpy (STATE(skb)->pgm_header->pgm_gsi, &sock->tsi.gsi, sizeof(pgm_gsi_t));
-	STATE(skb)->pgm_header->pgm_sport	= sock->tsi.sport;
-	STATE(skb)->pgm_header->pgm_dport	= sock->dport;
-	STATE(skb)->pgm_header->pgm_type        = PGM_ODATA;
-        STATE(skb)->pgm_header->pgm_options     = sock->use_pgmcc ? PGM_OPT_PRESENT : 0;
-        STATE(skb)->pgm_header->pgm_tsdu_length = pgm_htons (tsdu_length);
-
-/* ODATA */
-        STATE(skb)->pgm_data->data_sqn		= pgm_htonl (pgm_txw_next_lead(sock->window));
-        STATE(skb)->pgm_data->data_trail	= pgm_htonl (pgm_txw_trail(sock->window));
-
-        STATE(skb)->pgm_header->pgm_checksum    = 0;
+	unfolded_header = prepare_odata (sock, STATE(skb), tsdu_length, sock->use_pgmcc ? PGM_OPT_PRESENT : 0);
 	data = STATE(skb)->pgm_data + 1;
-/* congestion control option header indicating elected peer for ACKs. */
-	if (sock->use_pgmcc) {
-		struct pgm_opt_header	   *opt_header;
-		struct pgm_opt_length	   *opt_len;
-		struct pgm_opt_pgmcc_data  *pgmcc_data;
-		const size_t opt_pgmcc_data_len = ((AF_INET6 == sock->acker_nla.ss_family) ?
-							sizeof (struct pgm_opt6_pgmcc_data) :
-							sizeof (struct pgm_opt_pgmcc_data));
-		opt_len = data;
-		opt_len->opt_type	= PGM_OPT_LENGTH;
-		opt_len->opt_length	= sizeof(struct pgm_opt_length);
-		opt_len->opt_total_length = pgm_htons ((uint16_t)(sizeof (struct pgm_opt_length) +
-							sizeof (struct pgm_opt_header) +
-							opt_pgmcc_data_len));
-		opt_header = (struct pgm_opt_header*)(opt_len + 1);
-		opt_header->opt_type	= PGM_OPT_PGMCC_DATA | PGM_OPT_END;
-		opt_header->opt_length	= sizeof (struct pgm_opt_header) +
-						opt_pgmcc_data_len;
-		pgmcc_data  = (struct pgm_opt_pgmcc_data *)(opt_header + 1);
-		pgmcc_data->opt_tstamp = pgm_htonl ((uint32_t)pgm_to_msecs (STATE(skb)->tstamp));
-/* acker nla */
-		pgm_sockaddr_to_nla ((struct sockaddr*)&sock->acker_nla, (char*)&pgmcc_data->opt_nla_afi);
-		data = (char*)opt_header + opt_header->opt_length;
-	}
+	if (sock->use_pgmcc)
+		data = add_opt_pgmcc_data (sock, STATE(skb), &unfolded_header);
 	const size_t   pgm_header_len		= (char*)data - (char*)STATE(skb)->pgm_header;
-	const uint32_t unfolded_header		= pgm_csum_partial (STATE(skb)->pgm_header, (uint16_t)pgm_header_len, 0);
 	STATE(unfolded_odata)			= pgm_csum_partial (data, (uint16_t)tsdu_length, 0);
         STATE(skb)->pgm_header->pgm_checksum	= pgm_csum_fold (pgm_csum_block_add (unfolded_header, STATE(unfolded_odata), (uint16_t)pgm_header_len));
 
@@ -1192,14 +1568,12 @@ retry_send:
 		return PGM_IO_STATUS_CONGESTION;	/* peer expiration to re-elect ACKer */
 	}
 
-	sent = pgm_sendto (sock,
-			   !STATE(is_rate_limited),	/* rate limit on blocking */
-			   &sock->odata_rate_control,
-			   FALSE,			/* regular socket */
-			   STATE(skb)->head,
-			   tpdu_length,
-			   (struct sockaddr*)&sock->send_gsr.gsr_group,
-			   pgm_sockaddr_len((struct sockaddr*)&sock->send_gsr.gsr_group));
+	sent = pgm_sendto_skb (sock,
+			       !STATE(is_rate_limited),	/* rate limit on blocking */
+			       &sock->odata_rate_control,
+			       STATE(skb),
+			       (struct sockaddr*)&sock->send_gsr.gsr_group,
+			       pgm_sockaddr_len((struct sockaddr*)&sock->send_gsr.gsr_group));
 	if (sent < 0) {
 		const int save_errno = pgm_get_last_sock_error();
 		if (PGM_LIKELY(PGM_SOCK_EAGAIN == save_errno || PGM_SOCK_ENOBUFS == save_errno))
@@ -1228,9 +1602,9 @@ retry_send:
 	pgm_txw_set_unfolded_checksum (STATE(skb), STATE(unfolded_odata));
 /* increment socket statistics */
 	if (PGM_LIKELY((size_t)sent == tpdu_length)) {
-		sock->cumulative_stats[PGM_PC_SOURCE_DATA_BYTES_SENT] += tsdu_length;
-		sock->cumulative_stats[PGM_PC_SOURCE_DATA_MSGS_SENT]  ++;
-		pgm_atomic_add32 (&sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT], (uint32_t)(tpdu_length + sock->iphdr_len));
+		pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_SEND), PGM_PC_SOURCE_DATA_BYTES_SENT, tsdu_length);
+		pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_SEND), PGM_PC_SOURCE_DATA_MSGS_SENT);
+		pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_SEND), PGM_PC_SOURCE_BYTES_SENT, tpdu_length + sock->iphdr_len);
 	}
 /* check for end of transmission group for pro-active packets */
 	if (sock->use_proactive_parity) {
@@ -1263,6 +1637,7 @@ send_odata_copy (
 	)
 {
 	void	*data;
+	uint32_t unfolded_header;
 	ssize_t	 sent;
 
 /* pre-conditions */
@@ -1282,7 +1657,7 @@ send_odata_copy (
 		goto retry_send;
 	}
 
-	STATE(skb) = pgm_alloc_skb (sock->max_tpdu);
+	STATE(skb) = pgm_skb_pool_alloc (sock->tx_pool, sock->max_tpdu);
 	STATE(skb)->sock = sock;
 	STATE(skb)->tstamp = pgm_time_update_now();
 	pgm_skb_reserve (STATE(skb), (uint16_t)pgm_pkt_offset (FALSE, pgmcc_family));
@@ -1290,46 +1665,11 @@ send_odata_copy (
 
 	STATE(skb)->pgm_header	= (struct pgm_header*)STATE(skb)->head;
 	STATE(skb)->pgm_data	= (struct pgm_data*)(STATE(skb)->pgm_header + 1);
-	memcpy (STATE(skb)->pgm_header->pgm_gsi, &sock->tsi.gsi, sizeof(pgm_gsi_t));
-	STATE(skb)->pgm_header->pgm_sport	= sock->tsi.sport;
-	STATE(skb)->pgm_header->pgm_dport	= sock->dport;
-	STATE(skb)->pgm_header->pgm_type	= PGM_ODATA;
-	STATE(skb)->pgm_header->pgm_options	= sock->use_pgmcc ? PGM_OPT_PRESENT : 0;
-	STATE(skb)->pgm_header->pgm_tsdu_length = pgm_htons (tsdu_length);
-
-/* ODATA */
-	STATE(skb)->pgm_data->data_sqn		= pgm_htonl (pgm_txw_next_lead(sock->window));
-	STATE(skb)->pgm_data->data_trail	= pgm_htonl (pgm_txw_trail(sock->window));
-
-	STATE(skb)->pgm_header->pgm_checksum	= 0;
+	unfolded_header = prepare_odata (sock, STATE(skb), tsdu_length, sock->use_pgmcc ? PGM_OPT_PRESENT : 0);
 	data = STATE(skb)->pgm_data + 1;
-/* congestion control option header indicating elected peer for ACKs. */
-	if (sock->use_pgmcc) {
-		struct pgm_opt_header		*opt_header;
-		struct pgm_opt_length		*opt_len;
-		struct pgm_opt_pgmcc_data	*pgmcc_data;
-		const size_t opt_pgmcc_data_len = ((AF_INET6 == sock->acker_nla.ss_family) ?
-							sizeof (struct pgm_opt6_pgmcc_data) :
-							sizeof (struct pgm_opt_pgmcc_data));
-		opt_len = data;
-		opt_len->opt_type	= PGM_OPT_LENGTH;
-		opt_len->opt_length	= sizeof (struct pgm_opt_length);
-		opt_len->opt_total_length = pgm_htons ((uint16_t)(sizeof (struct pgm_opt_length) +
-							sizeof (struct pgm_opt_header) +
-							opt_pgmcc_data_len));
-		opt_header = (struct pgm_opt_header*)(opt_len + 1);
-		opt_header->opt_type	= PGM_OPT_PGMCC_DATA | PGM_OPT_END;
-		opt_header->opt_length	= sizeof (struct pgm_opt_header) +
-						opt_pgmcc_data_len;
-		pgmcc_data  = (struct pgm_opt_pgmcc_data *)(opt_header + 1);
-		pgmcc_data->opt_reserved = 0;
-		pgmcc_data->opt_tstamp = pgm_htonl ((uint32_t)pgm_to_msecs (STATE(skb)->tstamp));
-/* acker nla */
-		pgm_sockaddr_to_nla ((struct sockaddr*)&sock->acker_nla, (char*)&pgmcc_data->opt_nla_afi);
-		data = (char*)opt_header + opt_header->opt_length;
-	}
+	if (sock->use_pgmcc)
+		data = add_opt_pgmcc_data (sock, STATE(skb), &unfolded_header);
 	const size_t   pgm_header_len		= (char*)data - (char*)STATE(skb)->pgm_header;
-	const uint32_t unfolded_header		= pgm_csum_partial (STATE(skb)->pgm_header, (uint16_t)pgm_header_len, 0);
 	STATE(unfolded_odata)			= pgm_csum_partial_copy (tsdu, data, (uint16_t)tsdu_length, 0);
 	STATE(skb)->pgm_header->pgm_checksum	= pgm_csum_fold (pgm_csum_block_add (unfolded_header, STATE(unfolded_odata), (uint16_t)pgm_header_len));
 
@@ -1365,14 +1705,12 @@ retry_send:
 		return PGM_IO_STATUS_CONGESTION;
 	}
 
-	sent = pgm_sendto (sock,
-			   !STATE(is_rate_limited),	/* rate limit on blocking */
-			   &sock->odata_rate_control,
-			   FALSE,			/* regular socket */
-			   STATE(skb)->head,
-			   tpdu_length,
-			   (struct sockaddr*)&sock->send_gsr.gsr_group,
-			   pgm_sockaddr_len((struct sockaddr*)&sock->send_gsr.gsr_group));
+	sent = pgm_sendto_skb (sock,
+			       !STATE(is_rate_limited),	/* rate limit on blocking */
+			       &sock->odata_rate_control,
+			       STATE(skb),
+			       (struct sockaddr*)&sock->send_gsr.gsr_group,
+			       pgm_sockaddr_len((struct sockaddr*)&sock->send_gsr.gsr_group));
 	if (sent < 0) {
 		const int save_errno = pgm_get_last_sock_error();
 		if (PGM_LIKELY(PGM_SOCK_EAGAIN == save_errno || PGM_SOCK_ENOBUFS == save_errno))
@@ -1403,9 +1741,9 @@ retry_send:
 	pgm_txw_set_unfolded_checksum (STATE(skb), STATE(unfolded_odata));
 /* increment socket statistics */
 	if (PGM_LIKELY((size_t)sent == tpdu_length)) {
-		sock->cumulative_stats[PGM_PC_SOURCE_DATA_BYTES_SENT] += tsdu_length;
-		sock->cumulative_stats[PGM_PC_SOURCE_DATA_MSGS_SENT]  ++;
-		pgm_atomic_add32 (&sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT], (uint32_t)(tpdu_length + sock->iphdr_len));
+		pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_SEND), PGM_PC_SOURCE_DATA_BYTES_SENT, tsdu_length);
+		pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_SEND), PGM_PC_SOURCE_DATA_MSGS_SENT);
+		pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_SEND), PGM_PC_SOURCE_BYTES_SENT, tpdu_length + sock->iphdr_len);
 	}
 /* check for end of transmission group for pro-active packets */
 	if (sock->use_proactive_parity) {
@@ -1442,6 +1780,7 @@ send_odatav (
 	)
 {
 	char		*dst;
+	uint32_t	 unfolded_header;
 	size_t		 tpdu_length;
 	ssize_t		 sent;
 
@@ -1475,32 +1814,22 @@ send_odatav (
 	}
 	pgm_return_val_if_fail (STATE(tsdu_length) <= sock->max_tsdu, PGM_IO_STATUS_ERROR);
 
-	STATE(skb) = pgm_alloc_skb (sock->max_tpdu);
+	STATE(skb) = pgm_skb_pool_alloc (sock->tx_pool, sock->max_tpdu);
 	STATE(skb)->sock = sock;
 	STATE(skb)->tstamp = pgm_time_update_now();
 	const sa_family_t pgmcc_family = sock->use_pgmcc ? sock->family : 0;
 	pgm_skb_reserve (STATE(skb), (uint16_t)pgm_pkt_offset (FALSE, pgmcc_family));
 	pgm_skb_put (STATE(skb), (uint16_t)STATE(tsdu_length));
 
-	STATE(skb)->pgm_header  = (struct pgm_header*)STATE(skb)->data;
+	STATE(skb)->pgm_header  = (struct pgm_header*)STATE(skb)->head;
 	STATE(skb)->pgm_data    = (struct pgm_data*)(STATE(skb)->pgm_header + 1);
-	memcpy (STATE(skb)->pgm_header->pgm_gsi, &sock->tsi.gsi, sizeof(pgm_gsi_t));
-	STATE(skb)->pgm_header->pgm_sport	= sock->tsi.sport;
-	STATE(skb)->pgm_header->pgm_dport	= sock->dport;
-	STATE(skb)->pgm_header->pgm_type	= PGM_ODATA;
-	STATE(skb)->pgm_header->pgm_options	= 0;
-	STATE(skb)->pgm_header->pgm_tsdu_length = pgm_htons ((uint16_t)STATE(tsdu_length));
-
-/* ODATA */
-	STATE(skb)->pgm_data->data_sqn		= pgm_htonl (pgm_txw_next_lead(sock->window));
-	STATE(skb)->pgm_data->data_trail	= pgm_htonl (pgm_txw_trail(sock->window));
-
-	STATE(skb)->pgm_header->pgm_checksum	= 0;
-	const size_t   pgm_header_len		= (char*)(STATE(skb)->pgm_data + 1) - (char*)STATE(skb)->pgm_header;
-	const uint32_t unfolded_header		= pgm_csum_partial (STATE(skb)->pgm_header, (uint16_t)pgm_header_len, 0);
+	unfolded_header = prepare_odata (sock, STATE(skb), (uint16_t)STATE(tsdu_length), sock->use_pgmcc ? PGM_OPT_PRESENT : 0);
+	dst = (char*)(STATE(skb)->pgm_data + 1);
+	if (sock->use_pgmcc)
+		dst = add_opt_pgmcc_data (sock, STATE(skb), &unfolded_header);
+	const size_t   pgm_header_len		= dst - (char*)STATE(skb)->pgm_header;
 
 /* unroll first iteration to make friendly branch prediction */
-	dst			= (char*)(STATE(skb)->pgm_data + 1);
 	STATE(unfolded_odata)	= pgm_csum_partial_copy ((const char*)vector[0].iov_base, dst, (uint16_t)vector[0].iov_len, 0);
 
 /* iterate over one or more vector elements to perform scatter/gather checksum & copy */
@@ -1537,14 +1866,12 @@ send_odatav (
 	}
 
 retry_send:
-	sent = pgm_sendto (sock,
-			   !STATE(is_rate_limited),	/* rate limit on blocking */
-			   &sock->odata_rate_control,
-			   FALSE,			/* regular socket */
-			   STATE(skb)->head,
-			   tpdu_length,
-			   (struct sockaddr*)&sock->send_gsr.gsr_group,
-			   pgm_sockaddr_len((struct sockaddr*)&sock->send_gsr.gsr_group));
+	sent = pgm_sendto_skb (sock,
+			       !STATE(is_rate_limited),	/* rate limit on blocking */
+			       &sock->odata_rate_control,
+			       STATE(skb),
+			       (struct sockaddr*)&sock->send_gsr.gsr_group,
+			       pgm_sockaddr_len((struct sockaddr*)&sock->send_gsr.gsr_group));
 	if (sent < 0) {
 		const int save_errno = pgm_get_last_sock_error();
 		if (PGM_LIKELY(PGM_SOCK_EAGAIN == save_errno || PGM_SOCK_ENOBUFS == save_errno))
@@ -1567,10 +1894,10 @@ retry_send:
 /* save unfolded odata for retransmissions */
 	pgm_txw_set_unfolded_checksum (STATE(skb), STATE(unfolded_odata));
 /* increment socket statistics */
-	if (PGM_LIKELY((size_t)sent == STATE(skb)->len)) {
-		sock->cumulative_stats[PGM_PC_SOURCE_DATA_BYTES_SENT] += STATE(tsdu_length);
-		sock->cumulative_stats[PGM_PC_SOURCE_DATA_MSGS_SENT]  ++;
-		pgm_atomic_add32 (&sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT], (uint32_t)(tpdu_length + sock->iphdr_len));
+	if (PGM_LIKELY((size_t)sent == tpdu_length)) {
+		pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_SEND), PGM_PC_SOURCE_DATA_BYTES_SENT, STATE(tsdu_length));
+		pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_SEND), PGM_PC_SOURCE_DATA_MSGS_SENT);
+		pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_SEND), PGM_PC_SOURCE_BYTES_SENT, tpdu_length + sock->iphdr_len);
 	}
 /* check for end of transmission group */
 	if (sock->use_proactive_parity) {
@@ -1614,12 +1941,15 @@ send_apdu (
 	const sa_family_t pgmcc_family = sock->use_pgmcc ? sock->family : 0;
 
 /* continue if blocked mid-apdu */
-	if (sock->is_apdu_eagain)
+	if (sock->is_apdu_eagain) {
+		if (STATE(is_burst))
+			goto retry_burst_send;
 		goto retry_send;
+	}
 
 /* if non-blocking calculate total wire size and check rate limit */
 	STATE(is_rate_limited) = FALSE;
-	if (sock->is_nonblocking && sock->is_controlled_odata)
+	if (can_check_apdu_rate (sock))
 	{
 		const size_t header_length = pgm_pkt_offset (TRUE, pgmcc_family);
 		size_t tpdu_length = 0;
@@ -1641,61 +1971,34 @@ send_apdu (
 		}
 		STATE(is_rate_limited) = TRUE;
 	}
+	STATE(is_burst) = can_send_burst (sock);
+	STATE(tstamp)   = pgm_time_update_now();
 
 	STATE(data_bytes_offset)	= 0;
 	STATE(first_sqn)		= pgm_txw_next_lead(sock->window);
 
 	do {
 		size_t			 tpdu_length, header_length;
-		struct pgm_opt_header	*opt_header;
-		struct pgm_opt_length	*opt_len;
+		uint32_t		 unfolded_header;
 		ssize_t			 sent;
 
 /* retrieve packet storage from transmit window */
 		header_length = pgm_pkt_offset (TRUE, pgmcc_family);
 		STATE(tsdu_length) = MIN( source_max_tsdu (sock, TRUE), apdu_length - STATE(data_bytes_offset) );
 
-		STATE(skb) = pgm_alloc_skb (sock->max_tpdu);
+		STATE(skb) = pgm_skb_pool_alloc (sock->tx_pool, sock->max_tpdu);
 		STATE(skb)->sock = sock;
-		STATE(skb)->tstamp = pgm_time_update_now();
+		STATE(skb)->tstamp = STATE(tstamp);
 		pgm_skb_reserve (STATE(skb), (uint16_t)header_length);
 		pgm_skb_put (STATE(skb), (uint16_t)STATE(tsdu_length));
 
 		STATE(skb)->pgm_header  = (struct pgm_header*)STATE(skb)->head;
 		STATE(skb)->pgm_data    = (struct pgm_data*)(STATE(skb)->pgm_header + 1);
-		memcpy (STATE(skb)->pgm_header->pgm_gsi, &sock->tsi.gsi, sizeof(pgm_gsi_t));
-		STATE(skb)->pgm_header->pgm_sport	= sock->tsi.sport;
-		STATE(skb)->pgm_header->pgm_dport	= sock->dport;
-		STATE(skb)->pgm_header->pgm_type	= PGM_ODATA;
-		STATE(skb)->pgm_header->pgm_options	= PGM_OPT_PRESENT;
-		STATE(skb)->pgm_header->pgm_tsdu_length = pgm_htons ((uint16_t)STATE(tsdu_length));
-
-/* ODATA */
-		STATE(skb)->pgm_data->data_sqn		= pgm_htonl (pgm_txw_next_lead(sock->window));
-		STATE(skb)->pgm_data->data_trail	= pgm_htonl (pgm_txw_trail(sock->window));
-
-/* OPT_LENGTH */
-		opt_len					= (struct pgm_opt_length*)(STATE(skb)->pgm_data + 1);
-		opt_len->opt_type			= PGM_OPT_LENGTH;
-		opt_len->opt_length			= sizeof(struct pgm_opt_length);
-		opt_len->opt_total_length		= pgm_htons ((uint16_t)(sizeof(struct pgm_opt_length) +
-									sizeof(struct pgm_opt_header) +
-									sizeof(struct pgm_opt_fragment)));
-/* OPT_FRAGMENT */
-		opt_header				= (struct pgm_opt_header*)(opt_len + 1);
-		opt_header->opt_type			= PGM_OPT_FRAGMENT | PGM_OPT_END;
-		opt_header->opt_length			= sizeof(struct pgm_opt_header) +
-						  	  sizeof(struct pgm_opt_fragment);
-		STATE(skb)->pgm_opt_fragment			= (struct pgm_opt_fragment*)(opt_header + 1);
-		STATE(skb)->pgm_opt_fragment->opt_reserved	= 0;
-		STATE(skb)->pgm_opt_fragment->opt_sqn		= pgm_htonl (STATE(first_sqn));
-		STATE(skb)->pgm_opt_fragment->opt_frag_off	= pgm_htonl ((uint32_t)STATE(data_bytes_offset));
-		STATE(skb)->pgm_opt_fragment->opt_frag_len	= pgm_htonl ((uint32_t)apdu_length);
+		unfolded_header = prepare_odata (sock, STATE(skb), (uint16_t)STATE(tsdu_length), PGM_OPT_PRESENT);
+		add_opt_fragment (sock, STATE(skb), apdu_length, &unfolded_header);
 
 /* TODO: the assembly checksum & copy routine is faster than memcpy & pgm_cksum on >= opteron hardware */
-		STATE(skb)->pgm_header->pgm_checksum	= 0;
 		const size_t   pgm_header_len		= (char*)(STATE(skb)->pgm_opt_fragment + 1) - (char*)STATE(skb)->pgm_header;
-		const uint32_t unfolded_header		= pgm_csum_partial (STATE(skb)->pgm_header, (uint16_t)pgm_header_len, 0);
 		STATE(unfolded_odata)			= pgm_csum_partial_copy ((const char*)apdu + STATE(data_bytes_offset), STATE(skb)->pgm_opt_fragment + 1, (uint16_t)STATE(tsdu_length), 0);
 		STATE(skb)->pgm_header->pgm_checksum	= pgm_csum_fold (pgm_csum_block_add (unfolded_header, STATE(unfolded_odata), (uint16_t)pgm_header_len));
 
@@ -1704,17 +2007,31 @@ send_apdu (
 		pgm_txw_add (sock->window, STATE(skb));
 		pgm_spinlock_unlock (&sock->txw_spinlock);
 
+/* queue until the burst is full or the apdu is complete */
+		if (STATE(is_burst)) {
+			pgm_txw_set_unfolded_checksum (STATE(skb), STATE(unfolded_odata));
+			sock->tx_burst->skb[ sock->tx_burst->count++ ] = pgm_skb_get (STATE(skb));
+			STATE(data_bytes_offset) += STATE(tsdu_length);
+			if (sock->tx_burst->count < sock->tx_burst->len &&
+			    STATE(data_bytes_offset) < apdu_length)
+				continue;
+retry_burst_send:
+			if (!send_odata_burst (sock, &bytes_sent, &packets_sent, &data_bytes_sent, &save_errno)) {
+				sock->is_apdu_eagain = TRUE;
+				goto blocked;
+			}
+			continue;
+		}
+
 retry_send:
 		pgm_assert ((char*)STATE(skb)->tail > (char*)STATE(skb)->head);
 		tpdu_length = (char*)STATE(skb)->tail - (char*)STATE(skb)->head;
-		sent = pgm_sendto (sock,
-				   !STATE(is_rate_limited),	/* rate limit on blocking */
-			   	   &sock->odata_rate_control,
-				   FALSE,			/* regular socket */
-				   STATE(skb)->head,
-				   tpdu_length,
-				   (struct sockaddr*)&sock->send_gsr.gsr_group,
-				   pgm_sockaddr_len((struct sockaddr*)&sock->send_gsr.gsr_group));
+		sent = pgm_sendto_skb (sock,
+				       !STATE(is_rate_limited),	/* rate limit on blocking */
+			   	       &sock->odata_rate_control,
+				       STATE(skb),
+				       (struct sockaddr*)&sock->send_gsr.gsr_group,
+				       pgm_sockaddr_len((struct sockaddr*)&sock->send_gsr.gsr_group));
 		if (sent < 0) {
 			save_errno = pgm_get_last_sock_error();
 			if (PGM_LIKELY(PGM_SOCK_EAGAIN == save_errno || PGM_SOCK_ENOBUFS == save_errno))
@@ -1753,9 +2070,9 @@ retry_send:
 /* SPM heartbeats decay from last sent data packet */
 	reset_heartbeat_spm (sock, STATE(skb)->tstamp);
 /* increment socket statistics */
-	pgm_atomic_add32 (&sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT], (uint32_t)bytes_sent);
-	sock->cumulative_stats[PGM_PC_SOURCE_DATA_MSGS_SENT]  += packets_sent;
-	sock->cumulative_stats[PGM_PC_SOURCE_DATA_BYTES_SENT] += data_bytes_sent;
+	pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_SEND), PGM_PC_SOURCE_BYTES_SENT, bytes_sent);
+	pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_SEND), PGM_PC_SOURCE_DATA_MSGS_SENT, packets_sent);
+	pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_SEND), PGM_PC_SOURCE_DATA_BYTES_SENT, data_bytes_sent);
 	if (bytes_written)
 		*bytes_written = apdu_length;
 	return PGM_IO_STATUS_NORMAL;
@@ -1763,9 +2080,9 @@ retry_send:
 blocked:
 	if (bytes_sent) {
 		reset_heartbeat_spm (sock, STATE(skb)->tstamp);
-		pgm_atomic_add32 (&sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT], (uint32_t)bytes_sent);
-		sock->cumulative_stats[PGM_PC_SOURCE_DATA_MSGS_SENT]  += packets_sent;
-		sock->cumulative_stats[PGM_PC_SOURCE_DATA_BYTES_SENT] += data_bytes_sent;
+		pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_SEND), PGM_PC_SOURCE_BYTES_SENT, bytes_sent);
+		pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_SEND), PGM_PC_SOURCE_DATA_MSGS_SENT, packets_sent);
+		pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_SEND), PGM_PC_SOURCE_DATA_BYTES_SENT, data_bytes_sent);
 	}
 	if (PGM_SOCK_ENOBUFS == save_errno)
 		return PGM_IO_STATUS_RATE_LIMITED;
@@ -1791,6 +2108,7 @@ pgm_send (
 {
 	pgm_debug ("pgm_send (sock:%p apdu:%p apdu-length:%" PRIzu " bytes-written:%p)",
 		(void*)sock, apdu, apdu_length, (void*)bytes_written);
+	PGM_HDR_START (start);
 
 /* parameters */
 	pgm_return_val_if_fail (NULL != sock, PGM_IO_STATUS_ERROR);
@@ -1818,6 +2136,8 @@ pgm_send (
 		const int status = send_odata_copy (sock, apdu, (uint16_t)apdu_length, bytes_written);
 		pgm_mutex_unlock (&sock->source_mutex);
 		pgm_rwlock_reader_unlock (&sock->lock);
+		if (PGM_IO_STATUS_NORMAL == status)
+			PGM_HDR_RECORD_SINCE (PGM_HDR_SEND_CALL, start);
 		return status;
 	}
 	else
@@ -1825,6 +2145,8 @@ pgm_send (
 		const int status = send_apdu (sock, apdu, (uint16_t)apdu_length, bytes_written);
 		pgm_mutex_unlock (&sock->source_mutex);
 		pgm_rwlock_reader_unlock (&sock->lock);
+		if (PGM_IO_STATUS_NORMAL == status)
+			PGM_HDR_RECORD_SINCE (PGM_HDR_SEND_CALL, start);
 		return status;
 	}
 }
@@ -1869,6 +2191,7 @@ pgm_sendv (
 		count,
 		is_one_apdu ? "TRUE" : "FALSE",
 		(const void*)bytes_written);
+	PGM_HDR_START (start);
 
 	pgm_return_val_if_fail (NULL != sock, PGM_IO_STATUS_ERROR);
 	pgm_return_val_if_fail (count <= PGM_MAX_FRAGMENTS, PGM_IO_STATUS_ERROR);
@@ -1890,6 +2213,8 @@ pgm_sendv (
 		const int status = send_odata_copy (sock, NULL, 0, bytes_written);
 		pgm_mutex_unlock (&sock->source_mutex);
 		pgm_rwlock_reader_unlock (&sock->lock);
+		if (PGM_IO_STATUS_NORMAL == status)
+			PGM_HDR_RECORD_SINCE (PGM_HDR_SEND_CALL, start);
 		return status;
 	}
 
@@ -1903,8 +2228,12 @@ pgm_sendv (
 				const int status = send_odatav (sock, vector, count, bytes_written);
 				pgm_mutex_unlock (&sock->source_mutex);
 				pgm_rwlock_reader_unlock (&sock->lock);
+				if (PGM_IO_STATUS_NORMAL == status)
+					PGM_HDR_RECORD_SINCE (PGM_HDR_SEND_CALL, start);
 				return status;
 			}
+			else if (STATE(is_burst))
+				goto retry_one_apdu_burst_send;
 			else
 				goto retry_one_apdu_send;
 		} else {
@@ -1937,6 +2266,8 @@ pgm_sendv (
 			const int status = send_odatav (sock, vector, count, bytes_written);
 			pgm_mutex_unlock (&sock->source_mutex);
 			pgm_rwlock_reader_unlock (&sock->lock);
+			if (PGM_IO_STATUS_NORMAL == status)
+				PGM_HDR_RECORD_SINCE (PGM_HDR_SEND_CALL, start);
 			return status;
 		} else if (STATE(apdu_length) > sock->max_apdu) {
 			pgm_mutex_unlock (&sock->source_mutex);
@@ -1981,12 +2312,13 @@ retry_send:
 			*bytes_written = data_bytes_sent;
 		pgm_mutex_unlock (&sock->source_mutex);
 		pgm_rwlock_reader_unlock (&sock->lock);
+		PGM_HDR_RECORD_SINCE (PGM_HDR_SEND_CALL, start);
 		return PGM_IO_STATUS_NORMAL;
 	}
 
 /* if non-blocking calculate total wire size and check rate limit */
 	STATE(is_rate_limited) = FALSE;
-	if (sock->is_nonblocking && sock->is_controlled_odata)
+	if (can_check_apdu_rate (sock))
         {
 		const size_t header_length = pgm_pkt_offset (TRUE, pgmcc_family);
                 size_t tpdu_length = 0;
@@ -2010,6 +2342,8 @@ retry_send:
 		}
 		STATE(is_rate_limited) = TRUE;
         }
+	STATE(is_burst) = can_send_burst (sock);
+	STATE(tstamp)   = pgm_time_update_now();
 
 	STATE(data_bytes_offset)	= 0;
 	STATE(vector_index)		= 0;
@@ -2019,8 +2353,7 @@ retry_send:
 
 	do {
 		size_t			 tpdu_length, header_length;
-		struct pgm_opt_header	*opt_header;
-		struct pgm_opt_length	*opt_len;
+		uint32_t		 unfolded_header;
 		const char		*src;
 		char			*dst;
 		size_t			 src_length, dst_length, copy_length;
@@ -2029,47 +2362,19 @@ retry_send:
 /* retrieve packet storage from transmit window */
 		header_length = pgm_pkt_offset (TRUE, pgmcc_family);
 		STATE(tsdu_length) = MIN( source_max_tsdu (sock, TRUE), STATE(apdu_length) - STATE(data_bytes_offset) );
-		STATE(skb) = pgm_alloc_skb (sock->max_tpdu);
+		STATE(skb) = pgm_skb_pool_alloc (sock->tx_pool, sock->max_tpdu);
 		STATE(skb)->sock = sock;
-		STATE(skb)->tstamp = pgm_time_update_now();
+		STATE(skb)->tstamp = STATE(tstamp);
 		pgm_skb_reserve (STATE(skb), (uint16_t)header_length);
 		pgm_skb_put (STATE(skb), (uint16_t)STATE(tsdu_length));
 
 		STATE(skb)->pgm_header  = (struct pgm_header*)STATE(skb)->head;
 		STATE(skb)->pgm_data    = (struct pgm_data*)(STATE(skb)->pgm_header + 1);
-		memcpy (STATE(skb)->pgm_header->pgm_gsi, &sock->tsi.gsi, sizeof(pgm_gsi_t));
-		STATE(skb)->pgm_header->pgm_sport	= sock->tsi.sport;
-		STATE(skb)->pgm_header->pgm_dport	= sock->dport;
-		STATE(skb)->pgm_header->pgm_type	= PGM_ODATA;
-		STATE(skb)->pgm_header->pgm_options	= PGM_OPT_PRESENT;
-		STATE(skb)->pgm_header->pgm_tsdu_length = pgm_htons ((uint16_t)STATE(tsdu_length));
-
-/* ODATA */
-		STATE(skb)->pgm_data->data_sqn		= pgm_htonl (pgm_txw_next_lead(sock->window));
-		STATE(skb)->pgm_data->data_trail	= pgm_htonl (pgm_txw_trail(sock->window));
-
-/* OPT_LENGTH */
-		opt_len					= (struct pgm_opt_length*)(STATE(skb)->pgm_data + 1);
-		opt_len->opt_type			= PGM_OPT_LENGTH;
-		opt_len->opt_length			= sizeof(struct pgm_opt_length);
-		opt_len->opt_total_length		= pgm_htons ((uint16_t)(sizeof(struct pgm_opt_length) +
-									sizeof(struct pgm_opt_header) +
-									sizeof(struct pgm_opt_fragment)));
-/* OPT_FRAGMENT */
-		opt_header				= (struct pgm_opt_header*)(opt_len + 1);
-		opt_header->opt_type			= PGM_OPT_FRAGMENT | PGM_OPT_END;
-		opt_header->opt_length			= sizeof(struct pgm_opt_header) +
-							  sizeof(struct pgm_opt_fragment);
-		STATE(skb)->pgm_opt_fragment			= (struct pgm_opt_fragment*)(opt_header + 1);
-		STATE(skb)->pgm_opt_fragment->opt_reserved	= 0;
-		STATE(skb)->pgm_opt_fragment->opt_sqn		= pgm_htonl (STATE(first_sqn));
-		STATE(skb)->pgm_opt_fragment->opt_frag_off	= pgm_htonl ((uint32_t)STATE(data_bytes_offset));
-		STATE(skb)->pgm_opt_fragment->opt_frag_len	= pgm_htonl ((uint32_t)STATE(apdu_length));
+		unfolded_header = prepare_odata (sock, STATE(skb), (uint16_t)STATE(tsdu_length), PGM_OPT_PRESENT);
+		add_opt_fragment (sock, STATE(skb), STATE(apdu_length), &unfolded_header);
 
 /* checksum & copy */
-		STATE(skb)->pgm_header->pgm_checksum	= 0;
 		const size_t   pgm_header_len		= (char*)(STATE(skb)->pgm_opt_fragment + 1) - (char*)STATE(skb)->pgm_header;
-		const uint32_t unfolded_header		= pgm_csum_partial (STATE(skb)->pgm_header, (uint16_t)pgm_header_len, 0);
 
 /* iterate over one or more vector elements to perform scatter/gather checksum & copy
  *
@@ -2116,16 +2421,30 @@ retry_send:
 		pgm_txw_add (sock->window, STATE(skb));
 		pgm_spinlock_unlock (&sock->txw_spinlock);
 
+/* queue until the burst is full or the apdu is complete */
+		if (STATE(is_burst)) {
+			pgm_txw_set_unfolded_checksum (STATE(skb), STATE(unfolded_odata));
+			sock->tx_burst->skb[ sock->tx_burst->count++ ] = pgm_skb_get (STATE(skb));
+			STATE(data_bytes_offset) += STATE(tsdu_length);
+			if (sock->tx_burst->count < sock->tx_burst->len &&
+			    STATE(data_bytes_offset) < STATE(apdu_length))
+				continue;
+retry_one_apdu_burst_send:
+			if (!send_odata_burst (sock, &bytes_sent, &packets_sent, &data_bytes_sent, &save_errno)) {
+				sock->is_apdu_eagain = TRUE;
+				goto blocked;
+			}
+			continue;
+		}
+
 retry_one_apdu_send:
 		tpdu_length = (char*)STATE(skb)->tail - (char*)STATE(skb)->head;
-		sent = pgm_sendto (sock,
-				   !STATE(is_rate_limited),	/* rate limited on blocking */
-			   	   &sock->odata_rate_control,
-				   FALSE,			/* regular socket */
-				   STATE(skb)->head,
-				   tpdu_length,
-				   (struct sockaddr*)&sock->send_gsr.gsr_group,
-				   pgm_sockaddr_len((struct sockaddr*)&sock->send_gsr.gsr_group));
+		sent = pgm_sendto_skb (sock,
+				       !STATE(is_rate_limited),	/* rate limited on blocking */
+			   	       &sock->odata_rate_control,
+				       STATE(skb),
+				       (struct sockaddr*)&sock->send_gsr.gsr_group,
+				       pgm_sockaddr_len((struct sockaddr*)&sock->send_gsr.gsr_group));
 		if (sent < 0) {
 			save_errno = pgm_get_last_sock_error();
 			if (PGM_LIKELY(PGM_SOCK_EAGAIN == save_errno || PGM_SOCK_ENOBUFS == save_errno))
@@ -2164,21 +2483,22 @@ retry_one_apdu_send:
 /* SPM heartbeats decay from last sent data packet */
 	reset_heartbeat_spm (sock, STATE(skb)->tstamp);
 /* increment socket statistics */
-	pgm_atomic_add32 (&sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT], (uint32_t)bytes_sent);
-	sock->cumulative_stats[PGM_PC_SOURCE_DATA_MSGS_SENT]  += packets_sent;
-	sock->cumulative_stats[PGM_PC_SOURCE_DATA_BYTES_SENT] += data_bytes_sent;
+	pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_SEND), PGM_PC_SOURCE_BYTES_SENT, bytes_sent);
+	pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_SEND), PGM_PC_SOURCE_DATA_MSGS_SENT, packets_sent);
+	pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_SEND), PGM_PC_SOURCE_DATA_BYTES_SENT, data_bytes_sent);
 	if (bytes_written)
 		*bytes_written = STATE(apdu_length);
 	pgm_mutex_unlock (&sock->source_mutex);
 	pgm_rwlock_reader_unlock (&sock->lock);
+	PGM_HDR_RECORD_SINCE (PGM_HDR_SEND_CALL, start);
 	return PGM_IO_STATUS_NORMAL;
 
 blocked:
 	if (bytes_sent) {
 		reset_heartbeat_spm (sock, STATE(skb)->tstamp);
-		pgm_atomic_add32 (&sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT], (uint32_t)bytes_sent);
-		sock->cumulative_stats[PGM_PC_SOURCE_DATA_MSGS_SENT]  += packets_sent;
-		sock->cumulative_stats[PGM_PC_SOURCE_DATA_BYTES_SENT] += data_bytes_sent;
+		pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_SEND), PGM_PC_SOURCE_BYTES_SENT, bytes_sent);
+		pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_SEND), PGM_PC_SOURCE_DATA_MSGS_SENT, packets_sent);
+		pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_SEND), PGM_PC_SOURCE_DATA_BYTES_SENT, data_bytes_sent);
 	}
 	pgm_mutex_unlock (&sock->source_mutex);
 	pgm_rwlock_reader_unlock (&sock->lock);
@@ -2220,6 +2540,7 @@ pgm_send_skbv (
 		count,
 		is_one_apdu ? "TRUE" : "FALSE",
 		(const void*)bytes_written);
+	PGM_HDR_START (start);
 
 	pgm_return_val_if_fail (NULL != sock, PGM_IO_STATUS_ERROR);
 	pgm_return_val_if_fail (count <= PGM_MAX_FRAGMENTS, PGM_IO_STATUS_ERROR);
@@ -2241,6 +2562,8 @@ pgm_send_skbv (
 		const int status = send_odata_copy (sock, NULL, 0, bytes_written);
 		pgm_mutex_unlock (&sock->source_mutex);
 		pgm_rwlock_reader_unlock (&sock->lock);
+		if (PGM_IO_STATUS_NORMAL == status)
+			PGM_HDR_RECORD_SINCE (PGM_HDR_SEND_CALL, start);
 		return status;
 	}
 	else if (1 == count)
@@ -2248,17 +2571,22 @@ pgm_send_skbv (
 		const int status = send_odata (sock, vector[0], bytes_written);
 		pgm_mutex_unlock (&sock->source_mutex);
 		pgm_rwlock_reader_unlock (&sock->lock);
+		if (PGM_IO_STATUS_NORMAL == status)
+			PGM_HDR_RECORD_SINCE (PGM_HDR_SEND_CALL, start);
 		return status;
 	}
 
 	const sa_family_t pgmcc_family = sock->use_pgmcc ? sock->family : 0;
 
 /* continue if blocked mid-apdu */
-	if (sock->is_apdu_eagain)
+	if (sock->is_apdu_eagain) {
+		if (STATE(is_burst))
+			goto retry_burst_send;
 		goto retry_send;
+	}
 
 	STATE(is_rate_limited) = FALSE;
-	if (sock->is_nonblocking && sock->is_controlled_odata)
+	if (can_check_apdu_rate (sock))
 	{
 		size_t total_tpdu_length = 0;
 
@@ -2277,6 +2605,8 @@ pgm_send_skbv (
 		}
 		STATE(is_rate_limited) = TRUE;
 	}
+	STATE(is_burst) = can_send_burst (sock);
+	STATE(tstamp)   = pgm_time_update_now();
 
 	if (is_one_apdu)
 	{
@@ -2301,49 +2631,22 @@ pgm_send_skbv (
 	for (STATE(vector_index) = 0; STATE(vector_index) < count; STATE(vector_index)++)
 	{
 		size_t		tpdu_length;
+		uint32_t	unfolded_header;
 		ssize_t		sent;
 
 		STATE(tsdu_length) = vector[STATE(vector_index)]->len;
 		
 		STATE(skb) = pgm_skb_get(vector[STATE(vector_index)]);
 		STATE(skb)->sock = sock;
-		STATE(skb)->tstamp = pgm_time_update_now();
+		STATE(skb)->tstamp = STATE(tstamp);
 
 		STATE(skb)->pgm_header = (struct pgm_header*)STATE(skb)->head;
 		STATE(skb)->pgm_data   = (struct pgm_data*)(STATE(skb)->pgm_header + 1);
-		memcpy (STATE(skb)->pgm_header->pgm_gsi, &sock->tsi.gsi, sizeof(pgm_gsi_t));
-		STATE(skb)->pgm_header->pgm_sport	= sock->tsi.sport;
-		STATE(skb)->pgm_header->pgm_dport	= sock->dport;
-		STATE(skb)->pgm_header->pgm_type	= PGM_ODATA;
-		STATE(skb)->pgm_header->pgm_options	= is_one_apdu ? PGM_OPT_PRESENT : 0;
-		STATE(skb)->pgm_header->pgm_tsdu_length = pgm_htons ((uint16_t)STATE(tsdu_length));
-
-/* ODATA */
-		STATE(skb)->pgm_data->data_sqn		= pgm_htonl (pgm_txw_next_lead(sock->window));
-		STATE(skb)->pgm_data->data_trail	= pgm_htonl (pgm_txw_trail(sock->window));
+		unfolded_header = prepare_odata (sock, STATE(skb), (uint16_t)STATE(tsdu_length), is_one_apdu ? PGM_OPT_PRESENT : 0);
 
 		if (is_one_apdu)
 		{
-			struct pgm_opt_header	*opt_header;
-			struct pgm_opt_length	*opt_len;
-
-/* OPT_LENGTH */
-			opt_len					= (struct pgm_opt_length*)(STATE(skb)->pgm_data + 1);
-			opt_len->opt_type			= PGM_OPT_LENGTH;
-			opt_len->opt_length			= sizeof(struct pgm_opt_length);
-			opt_len->opt_total_length		= pgm_htons ((uint16_t)(sizeof(struct pgm_opt_length) +
-										sizeof(struct pgm_opt_header) +
-										sizeof(struct pgm_opt_fragment)));
-/* OPT_FRAGMENT */
-			opt_header				= (struct pgm_opt_header*)(opt_len + 1);
-			opt_header->opt_type			= PGM_OPT_FRAGMENT | PGM_OPT_END;
-			opt_header->opt_length			= sizeof(struct pgm_opt_header) +
-								  sizeof(struct pgm_opt_fragment);
-			STATE(skb)->pgm_opt_fragment			= (struct pgm_opt_fragment*)(opt_header + 1);
-			STATE(skb)->pgm_opt_fragment->opt_reserved	= 0;
-			STATE(skb)->pgm_opt_fragment->opt_sqn		= pgm_htonl (STATE(first_sqn));
-			STATE(skb)->pgm_opt_fragment->opt_frag_off	= pgm_htonl ((uint32_t)STATE(data_bytes_offset));
-			STATE(skb)->pgm_opt_fragment->opt_frag_len	= pgm_htonl ((uint32_t)STATE(apdu_length));
+			add_opt_fragment (sock, STATE(skb), STATE(apdu_length), &unfolded_header);
 
 			pgm_assert (STATE(skb)->data == (STATE(skb)->pgm_opt_fragment + 1));
 		}
@@ -2353,10 +2656,8 @@ pgm_send_skbv (
 		}
 
 /* TODO: the assembly checksum & copy routine is faster than memcpy & pgm_cksum on >= opteron hardware */
-		STATE(skb)->pgm_header->pgm_checksum	= 0;
 		pgm_assert ((char*)STATE(skb)->data > (char*)STATE(skb)->pgm_header);
 		const size_t header_length		= (char*)STATE(skb)->data - (char*)STATE(skb)->pgm_header;
-		const uint32_t unfolded_header		= pgm_csum_partial (STATE(skb)->pgm_header, (uint16_t)header_length, 0);
 		STATE(unfolded_odata)			= pgm_csum_partial ((char*)STATE(skb)->data, (uint16_t)STATE(tsdu_length), 0);
 		STATE(skb)->pgm_header->pgm_checksum	= pgm_csum_fold (pgm_csum_block_add (unfolded_header, STATE(unfolded_odata), (uint16_t)header_length));
 
@@ -2364,17 +2665,33 @@ pgm_send_skbv (
 		pgm_spinlock_lock (&sock->txw_spinlock);
 		pgm_txw_add (sock->window, STATE(skb));
 		pgm_spinlock_unlock (&sock->txw_spinlock);
+
+/* queue until the burst is full or the vector is complete, transferring the
+ * application reference to the queue.
+ */
+		if (STATE(is_burst)) {
+			pgm_txw_set_unfolded_checksum (STATE(skb), STATE(unfolded_odata));
+			sock->tx_burst->skb[ sock->tx_burst->count++ ] = STATE(skb);
+			STATE(data_bytes_offset) += STATE(tsdu_length);
+			if (sock->tx_burst->count < sock->tx_burst->len &&
+			    STATE(vector_index) + 1 < count)
+				continue;
+retry_burst_send:
+			if (!send_odata_burst (sock, &bytes_sent, &packets_sent, &data_bytes_sent, &save_errno)) {
+				sock->is_apdu_eagain = TRUE;
+				goto blocked;
+			}
+			continue;
+		}
 retry_send:
 		pgm_assert ((char*)STATE(skb)->tail > (char*)STATE(skb)->head);
 		tpdu_length = (char*)STATE(skb)->tail - (char*)STATE(skb)->head;
-		sent = pgm_sendto (sock,
-				   !STATE(is_rate_limited),	/* rate limited on blocking */
-			   	   &sock->odata_rate_control,
-				   FALSE,			/* regular socket */
-				   STATE(skb)->head,
-				   tpdu_length,
-				   (struct sockaddr*)&sock->send_gsr.gsr_group,
-				   pgm_sockaddr_len((struct sockaddr*)&sock->send_gsr.gsr_group));
+		sent = pgm_sendto_skb (sock,
+				       !STATE(is_rate_limited),	/* rate limited on blocking */
+			   	       &sock->odata_rate_control,
+				       STATE(skb),
+				       (struct sockaddr*)&sock->send_gsr.gsr_group,
+				       pgm_sockaddr_len((struct sockaddr*)&sock->send_gsr.gsr_group));
 		if (sent < 0) {
 			save_errno = pgm_get_last_sock_error();
 			if (PGM_LIKELY(PGM_SOCK_EAGAIN == save_errno || PGM_SOCK_ENOBUFS == save_errno))
@@ -2419,21 +2736,22 @@ retry_send:
 /* SPM heartbeats decay from last sent data packet */
 	reset_heartbeat_spm (sock, STATE(skb)->tstamp);
 /* increment socket statistics */
-	pgm_atomic_add32 (&sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT], (uint32_t)bytes_sent);
-	sock->cumulative_stats[PGM_PC_SOURCE_DATA_MSGS_SENT]  += packets_sent;
-	sock->cumulative_stats[PGM_PC_SOURCE_DATA_BYTES_SENT] += data_bytes_sent;
+	pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_SEND), PGM_PC_SOURCE_BYTES_SENT, bytes_sent);
+	pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_SEND), PGM_PC_SOURCE_DATA_MSGS_SENT, packets_sent);
+	pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_SEND), PGM_PC_SOURCE_DATA_BYTES_SENT, data_bytes_sent);
 	if (bytes_written)
 		*bytes_written = data_bytes_sent;
 	pgm_mutex_unlock (&sock->source_mutex);
 	pgm_rwlock_reader_unlock (&sock->lock);
+	PGM_HDR_RECORD_SINCE (PGM_HDR_SEND_CALL, start);
 	return PGM_IO_STATUS_NORMAL;
 
 blocked:
 	if (bytes_sent) {
 		reset_heartbeat_spm (sock, STATE(skb)->tstamp);
-		pgm_atomic_add32 (&sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT], (uint32_t)bytes_sent);
-		sock->cumulative_stats[PGM_PC_SOURCE_DATA_MSGS_SENT]  += packets_sent;
-		sock->cumulative_stats[PGM_PC_SOURCE_DATA_BYTES_SENT] += data_bytes_sent;
+		pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_SEND), PGM_PC_SOURCE_BYTES_SENT, bytes_sent);
+		pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_SEND), PGM_PC_SOURCE_DATA_MSGS_SENT, packets_sent);
+		pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_SEND), PGM_PC_SOURCE_DATA_BYTES_SENT, data_bytes_sent);
 	}
 	pgm_mutex_unlock (&sock->source_mutex);
 	pgm_rwlock_reader_unlock (&sock->lock);
@@ -2448,11 +2766,75 @@ blocked:
  */
 #undef STATE
 
+/* rewrite previous odata/rdata contents as RDATA with current trail.
+ */
+
+static inline
+void
+prepare_rdata (
+	pgm_sock_t*	      const restrict sock,
+	struct pgm_sk_buff_t* const restrict skb
+	)
+{
+	struct pgm_header	*header;
+	struct pgm_data		*rdata;
+	uint16_t		 old_type_options, new_type_options;
+	uint32_t		 old_trail;
+
+	const size_t tpdu_length	= (char*)skb->tail - (char*)skb->head;
+	header				= skb->pgm_header;
+	rdata				= skb->pgm_data;
+	memcpy (&old_type_options, &header->pgm_type, sizeof (old_type_options));
+	old_trail			= rdata->data_trail;
+	header->pgm_type		= PGM_RDATA;
+/* RDATA */
+        rdata->data_trail		= pgm_htonl (pgm_txw_trail(sock->window));
+
+/* original data carries a valid checksum, only the type and trail change */
+	if (!(header->pgm_options & PGM_OPT_PARITY)) {
+		memcpy (&new_type_options, &header->pgm_type, sizeof (new_type_options));
+		header->pgm_checksum	= pgm_csum_replace (header->pgm_checksum, old_type_options, new_type_options);
+		header->pgm_checksum	= pgm_csum_replace (header->pgm_checksum, old_trail, rdata->data_trail);
+		return;
+	}
+
+/* parity packets are generated without a checksum */
+        header->pgm_checksum		= 0;
+	const size_t header_length	= tpdu_length - pgm_ntohs(header->pgm_tsdu_length);
+	const uint32_t unfolded_header	= pgm_csum_partial (header, (uint16_t)header_length, 0);
+	const uint32_t unfolded_odata	= pgm_txw_get_unfolded_checksum (skb);
+	header->pgm_checksum		= pgm_csum_fold (pgm_csum_block_add (unfolded_header, unfolded_odata, (uint16_t)header_length));
+}
+
 /* send repair packet.
  *
  * on success, TRUE is returned.  on error, FALSE is returned.
  */
 
+/* time from the NAK queueing a selective repair to its RDATA.  the stamp is
+ * cleared so that retransmissions not asked for by a NAK are not counted.
+ */
+
+static inline
+void
+record_rdata_dwell (
+	struct pgm_sk_buff_t* const	skb,
+	const pgm_time_t		now
+	)
+{
+#ifdef USE_HISTOGRAMS
+	const pgm_time_t nak_tstamp = pgm_txw_get_nak_tstamp (skb);
+	if (0 == nak_tstamp)
+		return;
+	if (pgm_time_after_eq (now, nak_tstamp))
+		PGM_HDR_RECORD (PGM_HDR_RDATA_DWELL, pgm_to_nsecs (now - nak_tstamp));
+	pgm_txw_set_nak_tstamp (skb, 0);
+#else
+	(void)skb;
+	(void)now;
+#endif
+}
+
 static
 bool
 send_rdata (
@@ -2460,9 +2842,9 @@ send_rdata (
 	struct pgm_sk_buff_t* restrict skb
 	)
 {
+	struct pgm_sk_buff_t	*repair = skb;
 	size_t			 tpdu_length;
 	struct pgm_header	*header;
-	struct pgm_data		*rdata;
 	ssize_t			 sent;
 
 /* pre-conditions */
@@ -2483,19 +2865,6 @@ send_rdata (
 		return FALSE;
 	}
 
-/* update previous odata/rdata contents */
-	header				= skb->pgm_header;
-	rdata				= skb->pgm_data;
-	header->pgm_type		= PGM_RDATA;
-/* RDATA */
-        rdata->data_trail		= pgm_htonl (pgm_txw_trail(sock->window));
-
-        header->pgm_checksum		= 0;
-	const size_t header_length	= tpdu_length - pgm_ntohs(header->pgm_tsdu_length);
-	const uint32_t unfolded_header	= pgm_csum_partial (header, (uint16_t)header_length, 0);
-	const uint32_t unfolded_odata	= pgm_txw_get_unfolded_checksum (skb);
-	header->pgm_checksum		= pgm_csum_fold (pgm_csum_block_add (unfolded_header, unfolded_odata, (uint16_t)header_length));
-
 /* congestion control */
 	if (sock->use_pgmcc &&
 	    sock->tokens < pgm_fp8 (1))
@@ -2505,6 +2874,15 @@ send_rdata (
 		return FALSE;
 	}
 
+/* the kernel may still be reading the original transmission, rewrite a copy */
+	if (NULL != sock->zerocopy &&
+	    pgm_zerocopy_is_pending (sock->zerocopy, sock->send_sock, skb))
+	{
+		repair = pgm_skb_copy (skb);
+	}
+	prepare_rdata (sock, repair);
+	header = repair->pgm_header;
+
 	sent = pgm_sendto (sock,
 			   FALSE,			/* already rate limited */
 			   &sock->rdata_rate_control,
@@ -2517,6 +2895,8 @@ send_rdata (
 		const int save_errno = pgm_get_last_sock_error();
 		if (PGM_LIKELY(PGM_SOCK_EAGAIN == save_errno || PGM_SOCK_ENOBUFS == save_errno))
 		{
+			if (repair != skb)
+				pgm_free_skb (repair);
 			sock->blocklen = tpdu_length + sock->iphdr_len;
 			return FALSE;
 		}
@@ -2538,9 +2918,117 @@ send_rdata (
 	pgm_mutex_unlock (&sock->timer_mutex);
 
 	pgm_txw_inc_retransmit_count (skb);
-	sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_BYTES_RETRANSMITTED] += pgm_ntohs(header->pgm_tsdu_length);
-	sock->cumulative_stats[PGM_PC_SOURCE_SELECTIVE_MSGS_RETRANSMITTED]++;	/* impossible to determine APDU count */
-	pgm_atomic_add32 (&sock->cumulative_stats[PGM_PC_SOURCE_BYTES_SENT], (uint32_t)(tpdu_length + sock->iphdr_len));
+	record_rdata_dwell (skb, now);
+	pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_SELECTIVE_BYTES_RETRANSMITTED, pgm_ntohs(header->pgm_tsdu_length));
+	pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_SELECTIVE_MSGS_RETRANSMITTED);	/* impossible to determine APDU count */
+	pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_BYTES_SENT, tpdu_length + sock->iphdr_len);
+	if (repair != skb)
+		pgm_free_skb (repair);
+	return TRUE;
+}
+
+/* send referenced repair packets pgm_send_burst_t::skb[0..count) of pgm_sock_t::rdata_burst
+ * in one write, truncated to the remaining repair rate budget and pgmcc tokens.  sent
+ * packets are removed from the retransmit queue, heartbeat and congestion state are
+ * updated once per batch.  all references are released.
+ *
+ * returns TRUE when every packet was sent, returns FALSE if the send would block or
+ * exceeds the rate limit with the wire size of the next packet saved into
+ * pgm_sock_t::blocklen.
+ */
+
+static
+bool
+send_rdata_burst (
+	pgm_sock_t* const	sock,
+	unsigned		count
+	)
+{
+	struct pgm_send_burst_t* burst;
+	const unsigned queued = count;
+	unsigned n = 0;
+	int consumed = 0;
+
+/* pre-conditions */
+	pgm_assert (NULL != sock);
+	pgm_assert (NULL != sock->rdata_burst);
+	pgm_assert_cmpuint (count, >, 0);
+	pgm_assert_cmpuint (count, <=, sock->rdata_burst->len);
+
+	burst = sock->rdata_burst;
+
+/* congestion control, one token per packet */
+	if (sock->use_pgmcc && count > pgm_fp8tou (sock->tokens))
+		count = pgm_fp8tou (sock->tokens);
+
+/* rate check including rdata specific limits per packet, only the first may block */
+	while (n < count)
+	{
+		struct pgm_sk_buff_t* skb = burst->skb[n];
+		const size_t tpdu_length = (char*)skb->tail - (char*)skb->head;
+		if (sock->is_controlled_rdata &&
+		    !pgm_rate_check2 (&sock->rate_control,
+				      &sock->rdata_rate_control,
+				      tpdu_length,
+				      0 == n ? sock->is_nonblocking : TRUE))
+			break;
+		prepare_rdata (sock, skb);
+		n++;
+	}
+
+	if (n > 0) {
+		burst->head  = 0;
+		burst->count = n;
+		consumed = pgm_sendto_burst (sock,
+					     FALSE,			/* already rate limited */
+					     &sock->rdata_rate_control,
+					     TRUE,			/* with router alert */
+					     burst,
+					     (struct sockaddr*)&sock->send_gsr.gsr_group,
+					     pgm_sockaddr_len((struct sockaddr*)&sock->send_gsr.gsr_group));
+		burst->head = burst->count = 0;
+		if (consumed < 0)
+			consumed = 0;
+	}
+
+	if (consumed > 0)
+	{
+		const pgm_time_t now = pgm_time_update_now();
+
+		if (sock->use_pgmcc) {
+			sock->tokens -= pgm_fp8 (consumed);
+			sock->ack_expiry = now + sock->ack_expiry_ivl;
+		}
+
+/* re-set spm timer once for the batch */
+		pgm_mutex_lock (&sock->timer_mutex);
+		sock->spm_heartbeat_state = 1;
+		sock->next_heartbeat_spm = now + sock->spm_heartbeat_interval[sock->spm_heartbeat_state++];
+		pgm_mutex_unlock (&sock->timer_mutex);
+
+		for (unsigned i = 0; i < (unsigned)consumed; i++)
+		{
+			struct pgm_sk_buff_t* skb = burst->skb[i];
+			const size_t tpdu_length = (char*)skb->tail - (char*)skb->head;
+			pgm_txw_inc_retransmit_count (skb);
+			record_rdata_dwell (skb, now);
+			pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_SELECTIVE_BYTES_RETRANSMITTED, pgm_ntohs(skb->pgm_header->pgm_tsdu_length));
+			pgm_stats_inc (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_SELECTIVE_MSGS_RETRANSMITTED);
+			pgm_stats_add (pgm_sock_stats (sock, PGM_STATS_RECV), PGM_PC_SOURCE_BYTES_SENT, tpdu_length + sock->iphdr_len);
+			pgm_free_skb (skb);
+/* re-enable NAK processing for this sequence number */
+			pgm_txw_retransmit_remove_head (sock->window);
+		}
+	}
+
+/* release unsent packets, they remain queued */
+	if ((unsigned)consumed < queued) {
+		const struct pgm_sk_buff_t* skb = burst->skb[consumed];
+		sock->blocklen = ((char*)skb->tail - (char*)skb->head) + sock->iphdr_len;
+		for (unsigned i = consumed; i < queued; i++)
+			pgm_free_skb (burst->skb[i]);
+		return FALSE;
+	}
 	return TRUE;
 }
 
@@ -0,0 +1,372 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * performance tests for the source transmit path.
+ *
+ * Copyright (c) 2010-2016 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* drives pgm_send(), pgm_sendv() and pgm_send_skbv() on a bound and connected
+ * socket with the network replaced by a stub, so only library overhead is
+ * measured.  one CSV line is printed per configuration:
+ *
+ *	api,tsdu,fec,pgmcc,rate,packets,elapsed_us,packets_per_sec,ns_per_packet,copy_ratio
+ *
+ * copy_ratio is payload bytes transmitted from library owned memory per
+ * payload byte, i.e. 1.0 when the application data is copied into the
+ * transmit window and 0.0 when the application buffer is sent in place.
+ */
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pgm/pgm.h>
+#include <impl/framework.h>
+#include <impl/socket.h>
+#include <impl/source.h>
+#include <impl/txw.h>
+
+
+#define PERF_NETWORK		"127.0.0.1;239.192.0.1"
+#define PERF_UDP_ENCAP_PORT	3056
+#define PERF_DPORT		7500
+#define PERF_SPORT		7501
+#define PERF_MAX_TPDU		1500
+#define PERF_TXW_SQNS		4096
+#define PERF_PACKETS		65536		/* per configuration */
+#define PERF_APDU		8192		/* fragmented, not for pgm_send_skbv() */
+#define PERF_RS_N		255
+#define PERF_RS_K		8
+#define PERF_ACK_C		75
+#define PERF_ACK_C_P		500
+
+enum {
+	PERF_SEND = 0,
+	PERF_SENDV,
+	PERF_SEND_SKBV,
+	PERF_API_MAX
+};
+
+static const char* perf_api_name[ PERF_API_MAX ] = { "pgm_send", "pgm_sendv", "pgm_send_skbv" };
+
+/* application owned memory for the current call */
+
+struct perf_region_t {
+	const char*	lo;
+	const char*	hi;
+};
+
+static struct perf_region_t perf_app[ PGM_MAX_FRAGMENTS ];
+static unsigned perf_app_len = 0;
+static uint64_t perf_payload_bytes = 0;
+static uint64_t perf_copied_bytes = 0;
+
+/* network replacement in net.c */
+extern int (*priv_sendto)(SOCKET, const char*, int, int, const struct sockaddr*, int);
+
+
+static
+bool
+perf_is_app_memory (
+	const char*	p
+	)
+{
+	for (unsigned i = 0; i < perf_app_len; i++)
+		if (p >= perf_app[i].lo && p < perf_app[i].hi)
+			return TRUE;
+	return FALSE;
+}
+
+static
+int
+perf_sendto (
+	SOCKET			s,
+	const char*		buf,
+	int			len,
+	int			flags,
+	const struct sockaddr*	to,
+	int			tolen
+	)
+{
+	const struct pgm_header* header = (const struct pgm_header*)buf;
+	const uint16_t tsdu_length = pgm_ntohs (header->pgm_tsdu_length);
+
+	(void)s; (void)flags; (void)to; (void)tolen;
+
+/* original data only, parity and repairs are generated by the library */
+	if (PGM_ODATA == header->pgm_type && tsdu_length > 0) {
+		perf_payload_bytes += tsdu_length;
+		if (!perf_is_app_memory (buf + len - tsdu_length))
+			perf_copied_bytes += tsdu_length;
+	}
+	return len;
+}
+
+static
+pgm_sock_t*
+perf_create_sock (
+	const bool	use_fec,
+	const bool	use_pgmcc,
+	const bool	use_rate
+	)
+{
+	struct pgm_addrinfo_t* res = NULL;
+	pgm_error_t* pgm_err = NULL;
+	pgm_sock_t* sock = NULL;
+
+	if (!pgm_getaddrinfo (PERF_NETWORK, NULL, &res, &pgm_err)) {
+		fprintf (stderr, "Parsing network parameter: %s\n", pgm_err->message);
+		goto err_abort;
+	}
+	if (!pgm_socket (&sock, AF_INET, SOCK_SEQPACKET, IPPROTO_UDP, &pgm_err)) {
+		fprintf (stderr, "Creating PGM/UDP socket: %s\n", pgm_err->message);
+		goto err_abort;
+	}
+
+	const int send_only = 1,
+		  no_router_assist = 0,
+		  max_tpdu = PERF_MAX_TPDU,
+		  sqns = PERF_TXW_SQNS,
+		  max_rte = INT_MAX,
+		  encap_port = PERF_UDP_ENCAP_PORT,
+		  ambient_spm = pgm_secs (30),
+		  heartbeat_spm[] = { pgm_secs (30) },
+		  blocking = 0;
+
+	pgm_setsockopt (sock, IPPROTO_PGM, PGM_UDP_ENCAP_UCAST_PORT, &encap_port, sizeof(encap_port));
+	pgm_setsockopt (sock, IPPROTO_PGM, PGM_UDP_ENCAP_MCAST_PORT, &encap_port, sizeof(encap_port));
+	pgm_setsockopt (sock, IPPROTO_PGM, PGM_IP_ROUTER_ALERT, &no_router_assist, sizeof(no_router_assist));
+	pgm_setsockopt (sock, IPPROTO_PGM, PGM_SEND_ONLY, &send_only, sizeof(send_only));
+	pgm_setsockopt (sock, IPPROTO_PGM, PGM_MTU, &max_tpdu, sizeof(max_tpdu));
+	pgm_setsockopt (sock, IPPROTO_PGM, PGM_TXW_SQNS, &sqns, sizeof(sqns));
+	pgm_setsockopt (sock, IPPROTO_PGM, PGM_AMBIENT_SPM, &ambient_spm, sizeof(ambient_spm));
+	pgm_setsockopt (sock, IPPROTO_PGM, PGM_HEARTBEAT_SPM, &heartbeat_spm, sizeof(heartbeat_spm));
+	if (use_rate)
+		pgm_setsockopt (sock, IPPROTO_PGM, PGM_TXW_MAX_RTE, &max_rte, sizeof(max_rte));
+	if (use_fec) {
+		struct pgm_fecinfo_t fecinfo;
+		fecinfo.block_size		= PERF_RS_N;
+		fecinfo.proactive_packets	= 1;
+		fecinfo.group_size		= PERF_RS_K;
+		fecinfo.ondemand_parity_enabled	= TRUE;
+		fecinfo.var_pktlen_enabled	= TRUE;
+		pgm_setsockopt (sock, IPPROTO_PGM, PGM_USE_FEC, &fecinfo, sizeof(fecinfo));
+	}
+	if (use_pgmcc) {
+		struct pgm_pgmccinfo_t pgmccinfo;
+		pgmccinfo.ack_bo_ivl	= pgm_msecs (50);
+		pgmccinfo.ack_c		= PERF_ACK_C;
+		pgmccinfo.ack_c_p	= PERF_ACK_C_P;
+		pgm_setsockopt (sock, IPPROTO_PGM, PGM_USE_PGMCC, &pgmccinfo, sizeof(pgmccinfo));
+	}
+
+	struct pgm_sockaddr_t addr;
+	memset (&addr, 0, sizeof(addr));
+	addr.sa_port = PERF_DPORT;
+	addr.sa_addr.sport = PERF_SPORT;
+	if (!pgm_gsi_create_from_hostname (&addr.sa_addr.gsi, &pgm_err)) {
+		fprintf (stderr, "Creating GSI: %s\n", pgm_err->message);
+		goto err_abort;
+	}
+	struct pgm_interface_req_t if_req;
+	memset (&if_req, 0, sizeof(if_req));
+	if_req.ir_interface = res->ai_recv_addrs[0].gsr_interface;
+	memcpy (&if_req.ir_address, &res->ai_send_addrs[0].gsr_addr, sizeof(struct sockaddr_storage));
+	if (!pgm_bind3 (sock,
+			&addr, sizeof(addr),
+			&if_req, sizeof(if_req),	/* tx interface */
+			&if_req, sizeof(if_req),	/* rx interface */
+			&pgm_err))
+	{
+		fprintf (stderr, "Binding PGM socket: %s\n", pgm_err->message);
+		goto err_abort;
+	}
+	for (unsigned i = 0; i < res->ai_recv_addrs_len; i++)
+		pgm_setsockopt (sock, IPPROTO_PGM, PGM_JOIN_GROUP, &res->ai_recv_addrs[i], sizeof(struct pgm_group_source_req));
+	pgm_setsockopt (sock, IPPROTO_PGM, PGM_SEND_GROUP, &res->ai_send_addrs[0], sizeof(struct pgm_group_source_req));
+	pgm_setsockopt (sock, IPPROTO_PGM, PGM_NOBLOCK, &blocking, sizeof(blocking));
+	pgm_freeaddrinfo (res);
+	res = NULL;
+
+/* SYN SPMs are sent on connect and not counted */
+	if (!pgm_connect (sock, &pgm_err)) {
+		fprintf (stderr, "Connecting PGM socket: %s\n", pgm_err->message);
+		goto err_abort;
+	}
+	return sock;
+
+err_abort:
+	if (NULL != sock)
+		pgm_close (sock, FALSE);
+	if (NULL != res)
+		pgm_freeaddrinfo (res);
+	if (NULL != pgm_err)
+		pgm_error_free (pgm_err);
+	return NULL;
+}
+
+/* transmit PERF_PACKETS worth of tsdu_length payloads through one API.
+ *
+ * returns elapsed time in microseconds, or -1 on error.
+ */
+
+static
+int64_t
+perf_run (
+	pgm_sock_t* const	sock,
+	const int		api,
+	const size_t		tsdu_length
+	)
+{
+	const bool is_fragmented = tsdu_length > sock->max_tsdu;
+	const unsigned packets = is_fragmented ? PERF_PACKETS / (unsigned)((tsdu_length + sock->max_tsdu_fragment - 1) / sock->max_tsdu_fragment) : PERF_PACKETS;
+	const sa_family_t pgmcc_family = sock->use_pgmcc ? sock->family : 0;
+	char* payload = malloc (tsdu_length);
+	struct pgm_sk_buff_t** skbs = NULL;
+	pgm_time_t elapsed = 0;
+	size_t bytes_written;
+	int status = PGM_IO_STATUS_NORMAL;
+
+	memset (payload, 'x', tsdu_length);
+	if (PERF_SEND_SKBV == api) {
+		skbs = malloc (packets * sizeof(struct pgm_sk_buff_t*));
+		for (unsigned i = 0; i < packets; i++) {
+			skbs[i] = pgm_alloc_skb (sock->max_tpdu);
+			pgm_skb_reserve (skbs[i], (uint16_t)pgm_pkt_offset (FALSE, pgmcc_family));
+			pgm_skb_put (skbs[i], (uint16_t)tsdu_length);
+			memcpy (skbs[i]->data, payload, tsdu_length);
+		}
+	}
+
+	for (unsigned i = 0; i < packets && PGM_IO_STATUS_NORMAL == status; i++)
+	{
+		struct pgm_iovec vector[2];
+
+/* no ACKs are returned, keep the congestion window open */
+		if (sock->use_pgmcc)
+			sock->tokens = pgm_fp8 (PGM_MAX_FRAGMENTS);
+
+		const pgm_time_t start = pgm_time_update_now();
+		switch (api) {
+		case PERF_SEND:
+			perf_app[0].lo = payload;
+			perf_app[0].hi = payload + tsdu_length;
+			perf_app_len = 1;
+			status = pgm_send (sock, payload, tsdu_length, &bytes_written);
+			break;
+		case PERF_SENDV:
+			vector[0].iov_base = payload;
+			vector[0].iov_len  = tsdu_length / 2;
+			vector[1].iov_base = payload + vector[0].iov_len;
+			vector[1].iov_len  = tsdu_length - vector[0].iov_len;
+			perf_app[0].lo = payload;
+			perf_app[0].hi = payload + tsdu_length;
+			perf_app_len = 1;
+			status = pgm_sendv (sock, vector, 2, TRUE, &bytes_written);
+			break;
+		case PERF_SEND_SKBV:
+			perf_app[0].lo = (const char*)skbs[i]->head;
+			perf_app[0].hi = (const char*)skbs[i]->end;
+			perf_app_len = 1;
+			status = pgm_send_skbv (sock, &skbs[i], 1, FALSE, &bytes_written);
+			break;
+		default: break;
+		}
+/* parity packets for completed transmission groups */
+		while (!pgm_txw_retransmit_is_empty (sock->window))
+			if (!pgm_on_deferred_nak (sock))
+				break;
+		elapsed += pgm_time_update_now() - start;
+	}
+
+	if (NULL != skbs)
+		free (skbs);		/* references transferred to the transmit window */
+	free (payload);
+	if (PGM_IO_STATUS_NORMAL != status) {
+		fprintf (stderr, "%s returned status %d.\n", perf_api_name[api], status);
+		return -1;
+	}
+	return (int64_t)elapsed;
+}
+
+int
+main (void)
+{
+	const size_t tsdu_lengths[] = { 64, 256, 1024, 0 /* max_tsdu */, PERF_APDU };
+	pgm_error_t* pgm_err = NULL;
+	int retval = EXIT_SUCCESS;
+
+	if (!pgm_init (&pgm_err)) {
+		fprintf (stderr, "Unable to start PGM engine: %s\n", pgm_err->message);
+		pgm_error_free (pgm_err);
+		return EXIT_FAILURE;
+	}
+	priv_sendto = &perf_sendto;
+
+	printf ("api,tsdu,fec,pgmcc,rate,packets,elapsed_us,packets_per_sec,ns_per_packet,copy_ratio\n");
+	for (unsigned config = 0; config < 8; config++)
+	{
+		const bool use_fec   = (config & 1) ? TRUE : FALSE;
+		const bool use_pgmcc = (config & 2) ? TRUE : FALSE;
+		const bool use_rate  = (config & 4) ? TRUE : FALSE;
+
+		for (int api = 0; api < PERF_API_MAX; api++)
+			for (unsigned i = 0; i < PGM_N_ELEMENTS(tsdu_lengths); i++)
+			{
+				pgm_sock_t* sock = perf_create_sock (use_fec, use_pgmcc, use_rate);
+				if (NULL == sock) {
+					retval = EXIT_FAILURE;
+					goto cleanup;
+				}
+				const size_t tsdu_length = tsdu_lengths[i] ? tsdu_lengths[i] : sock->max_tsdu;
+				if (PERF_SEND_SKBV == api && tsdu_length > sock->max_tsdu) {
+					pgm_close (sock, FALSE);
+					continue;
+				}
+				perf_payload_bytes = perf_copied_bytes = 0;
+				const uint64_t packets_start = pgm_sock_stats_read (sock, PGM_PC_SOURCE_DATA_MSGS_SENT);
+				const int64_t elapsed = perf_run (sock, api, tsdu_length);
+				const uint64_t packets = pgm_sock_stats_read (sock, PGM_PC_SOURCE_DATA_MSGS_SENT) - packets_start;
+				pgm_close (sock, FALSE);
+				if (elapsed < 0) {
+					retval = EXIT_FAILURE;
+					goto cleanup;
+				}
+				printf ("%s,%zu,%d,%d,%d,%" PRIu64 ",%" PRIi64 ",%.0f,%.1f,%.3f\n",
+					perf_api_name[api],
+					tsdu_length,
+					use_fec ? 1 : 0,
+					use_pgmcc ? 1 : 0,
+					use_rate ? 1 : 0,
+					packets,
+					elapsed,
+					elapsed > 0 ? (1e6 * packets) / elapsed : 0.0,
+					packets > 0 ? (1e3 * elapsed) / packets : 0.0,
+					perf_payload_bytes > 0 ? (double)perf_copied_bytes / perf_payload_bytes : 0.0);
+				fflush (stdout);
+			}
+	}
+
+cleanup:
+	pgm_shutdown ();
+	return retval;
+}
+
+/* eof */
@@ -63,15 +63,31 @@ static gboolean mock_is_valid_spmr = TRUE;
 static gboolean mock_is_valid_ack = TRUE;
 static gboolean mock_is_valid_nak = TRUE;
 static gboolean mock_is_valid_nnak = TRUE;
+static guint mock_burst_calls = 0;
+static guint mock_retransmit_selective_len = 0;
+static guint mock_retransmit_remove_calls = 0;
+static gboolean mock_is_zerocopy_pending = FALSE;
+static guint mock_sendto_calls = 0;
+static struct pgm_sk_buff_t* mock_peek_skb = NULL;
+static guint64 mock_ncf_expiry = 0;
+static gboolean mock_is_csum_enabled = FALSE;
+static struct pgm_sk_buff_t* mock_retransmit_skb = NULL;
+static guint8 mock_sent_buf[ TEST_MAX_TPDU ];
+static gsize mock_sent_len = 0;
 
 
 #define pgm_txw_get_unfolded_checksum	mock_pgm_txw_get_unfolded_checksum
 #define pgm_txw_set_unfolded_checksum	mock_pgm_txw_set_unfolded_checksum
 #define pgm_txw_inc_retransmit_count	mock_pgm_txw_inc_retransmit_count
+#define pgm_txw_get_ncf_expiry		mock_pgm_txw_get_ncf_expiry
+#define pgm_txw_set_ncf_expiry		mock_pgm_txw_set_ncf_expiry
+#define pgm_txw_get_nak_tstamp		mock_pgm_txw_get_nak_tstamp
+#define pgm_txw_set_nak_tstamp		mock_pgm_txw_set_nak_tstamp
 #define pgm_txw_add			mock_pgm_txw_add
 #define pgm_txw_peek			mock_pgm_txw_peek
 #define pgm_txw_retransmit_push		mock_pgm_txw_retransmit_push
 #define pgm_txw_retransmit_try_peek	mock_pgm_txw_retransmit_try_peek
+#define pgm_txw_retransmit_try_peek_selective	mock_pgm_txw_retransmit_try_peek_selective
 #define pgm_txw_retransmit_remove_head	mock_pgm_txw_retransmit_remove_head
 #define pgm_rs_encode			mock_pgm_rs_encode
 #define pgm_rate_check			mock_pgm_rate_check
@@ -84,6 +100,9 @@ static gboolean mock_is_valid_nnak = TRUE;
 #define pgm_csum_block_add		mock_pgm_csum_block_add
 #define pgm_csum_fold			mock_pgm_csum_fold
 #define pgm_sendto_hops			mock_pgm_sendto_hops
+#define pgm_sendto_burst		mock_pgm_sendto_burst
+#define pgm_sendto_skb			mock_pgm_sendto_skb
+#define pgm_zerocopy_is_pending		mock_pgm_zerocopy_is_pending
 #define pgm_time_update_now		mock_pgm_time_update_now
 #define pgm_setsockopt			mock_pgm_setsockopt
 
@@ -91,6 +110,17 @@ static gboolean mock_is_valid_nnak = TRUE;
 #define SOURCE_DEBUG
 #include "source.c"
 
+/* checksum module for verifying generated packets */
+#undef pgm_compat_csum_partial
+#undef pgm_compat_csum_partial_copy
+#undef pgm_csum_block_add
+#undef pgm_csum_fold
+uint16_t pgm_csum_fold (uint32_t);
+uint32_t pgm_csum_block_add (uint32_t, uint32_t, const uint16_t);
+uint32_t pgm_compat_csum_partial (const void*, uint16_t, uint32_t);
+uint32_t pgm_compat_csum_partial_copy (const void*restrict, void*restrict, uint16_t, uint32_t);
+void pgm_checksum_init (const pgm_cpu_t*);
+
 
 static
 void
@@ -99,6 +129,17 @@ mock_setup (void)
 	if (!g_thread_supported ()) g_thread_init (NULL);
 }
 
+/* switch to the portable checksum routines */
+static
+void
+mock_enable_csum (void)
+{
+	pgm_cpu_t cpu;
+	memset (&cpu, 0, sizeof(cpu));
+	pgm_checksum_init (&cpu);
+	mock_is_csum_enabled = TRUE;
+}
+
 static
 struct pgm_sock_t*
 generate_sock (void)
@@ -126,6 +167,7 @@ generate_sock (void)
 	pgm_mutex_init (&sock->source_mutex);
 	pgm_mutex_init (&sock->timer_mutex);
 	pgm_rwlock_init (&sock->lock);
+	pgm_build_header_templates (sock);
 	return sock;
 }
 
@@ -174,6 +216,23 @@ generate_odata (void)
 	return skb;
 }
 
+/* full checksum recompute of a complete TPDU */
+static
+gboolean
+is_valid_checksum (
+	const guint8*			buf,
+	const gsize			len
+	)
+{
+	guint8 tpdu[ TEST_MAX_TPDU ];
+	struct pgm_header* header = (struct pgm_header*)tpdu;
+	g_assert (len <= sizeof(tpdu));
+	memcpy (tpdu, buf, len);
+	const guint16 sum = header->pgm_checksum;
+	header->pgm_checksum = 0;
+	return sum == pgm_csum_fold (pgm_csum_partial (tpdu, (uint16_t)len, 0));
+}
+
 static
 pgm_peer_t*
 generate_peer (void)
@@ -308,7 +367,40 @@ mock_pgm_txw_peek (
 {
 	g_debug ("mock_pgm_txw_peek (window:%p sequence:%" G_GUINT32_FORMAT ")",
 		(gpointer)window, sequence);
-	return NULL;
+	return mock_peek_skb;
+}
+
+pgm_time_t
+mock_pgm_txw_get_ncf_expiry (
+	const struct pgm_sk_buff_t* const skb
+	)
+{
+	return mock_ncf_expiry;
+}
+
+void
+mock_pgm_txw_set_ncf_expiry (
+	struct pgm_sk_buff_t* const	skb,
+	const pgm_time_t		expiry
+	)
+{
+	mock_ncf_expiry = expiry;
+}
+
+pgm_time_t
+mock_pgm_txw_get_nak_tstamp (
+	const struct pgm_sk_buff_t* const skb
+	)
+{
+	return 0;
+}
+
+void
+mock_pgm_txw_set_nak_tstamp (
+	struct pgm_sk_buff_t* const	skb,
+	const pgm_time_t		tstamp
+	)
+{
 }
 
 bool
@@ -357,9 +449,26 @@ mock_pgm_txw_retransmit_try_peek (
 {
 	g_debug ("mock_pgm_txw_retransmit_try_peek (window:%p)",
 		(gpointer)window);
+	if (NULL != mock_retransmit_skb)
+		return mock_retransmit_skb;
 	return generate_odata (); 
 }
 
+unsigned
+mock_pgm_txw_retransmit_try_peek_selective (
+	pgm_txw_t* const		window,
+	struct pgm_sk_buff_t**		skbs,
+	const unsigned			n
+	)
+{
+	unsigned count = MIN(n, mock_retransmit_selective_len);
+	g_debug ("mock_pgm_txw_retransmit_try_peek_selective (window:%p skbs:%p n:%u)",
+		(gpointer)window, (gpointer)skbs, n);
+	for (unsigned i = 0; i < count; i++)
+		skbs[i] = generate_odata ();
+	return count;
+}
+
 void
 mock_pgm_txw_retransmit_remove_head (
 	pgm_txw_t* const		window
@@ -367,6 +476,7 @@ mock_pgm_txw_retransmit_remove_head (
 {
 	g_debug ("mock_pgm_txw_retransmit_remove_head (window:%p)",
 		(gpointer)window);
+	mock_retransmit_remove_calls++;
 }
 
 void
@@ -434,6 +544,8 @@ mock_pgm_compat_csum_partial (
 	uint32_t			csum
 	)
 {
+	if (mock_is_csum_enabled)
+		return pgm_compat_csum_partial (addr, len, csum);
 	return 0x0;
 }
 
@@ -445,6 +557,8 @@ mock_pgm_compat_csum_partial_copy (
 	uint32_t			csum
 	)
 {
+	if (mock_is_csum_enabled)
+		return pgm_compat_csum_partial_copy (src, dst, len, csum);
 	return 0x0;
 }
 
@@ -455,6 +569,8 @@ mock_pgm_csum_block_add (
 	uint16_t			offset
 	)
 {
+	if (mock_is_csum_enabled)
+		return pgm_csum_block_add (csum, csum2, offset);
 	return 0x0;
 }
 
@@ -463,6 +579,8 @@ mock_pgm_csum_fold (
 	uint32_t			csum
 	)
 {
+	if (mock_is_csum_enabled)
+		return pgm_csum_fold (csum);
 	return 0x0;
 }
 
@@ -492,9 +610,69 @@ mock_pgm_sendto_hops (
 		(unsigned)len,
 		saddr,
 		tolen);
+	mock_sendto_calls++;
+	if (len <= sizeof(mock_sent_buf)) {
+		memcpy (mock_sent_buf, buf, len);
+		mock_sent_len = len;
+	}
 	return len;
 }
 
+PGM_GNUC_INTERNAL
+ssize_t
+mock_pgm_sendto_skb (
+	pgm_sock_t*			sock,
+	bool				use_rate_limit,
+	pgm_rate_t*			minor_rate_control,
+	struct pgm_sk_buff_t*		skb,
+	const struct sockaddr*		to,
+	socklen_t			tolen
+	)
+{
+	return mock_pgm_sendto_hops (sock, use_rate_limit, minor_rate_control, FALSE, -1, skb->head, (char*)skb->tail - (char*)skb->head, to, tolen);
+}
+
+PGM_GNUC_INTERNAL
+int
+mock_pgm_sendto_burst (
+	pgm_sock_t*			sock,
+	bool				use_rate_limit,
+	pgm_rate_t*			minor_rate_control,
+	bool				use_router_alert,
+	struct pgm_send_burst_t*	burst,
+	const struct sockaddr*		to,
+	socklen_t			tolen
+	)
+{
+	g_debug ("mock_pgm_sendto_burst (sock:%p use-rate-limit:%s minor-rate-control:%p use-router-alert:%s burst:%p head:%u count:%u tolen:%d)",
+		(gpointer)sock,
+		use_rate_limit ? "YES" : "NO",
+		(gpointer)minor_rate_control,
+		use_router_alert ? "YES" : "NO",
+		(gpointer)burst,
+		burst->head,
+		burst->count,
+		tolen);
+	for (unsigned i = burst->head; i < burst->count; i++)
+		burst->sent[i] = (char*)burst->skb[i]->tail - (char*)burst->skb[i]->head;
+	mock_burst_calls++;
+	return burst->count - burst->head;
+}
+
+/** zero-copy module */
+PGM_GNUC_INTERNAL
+bool
+mock_pgm_zerocopy_is_pending (
+	pgm_zerocopy_t*			zc,
+	const SOCKET			s,
+	const struct pgm_sk_buff_t*	skb
+	)
+{
+	g_debug ("mock_pgm_zerocopy_is_pending (zc:%p s:%d skb:%p)",
+		(gpointer)zc, (int)s, (gconstpointer)skb);
+	return mock_is_zerocopy_pending;
+}
+
 /** time module */
 static pgm_time_t _mock_pgm_time_update_now (void);
 pgm_time_update_func mock_pgm_time_update_now = _mock_pgm_time_update_now;
@@ -583,6 +761,90 @@ START_TEST (test_send_pass_002)
 }
 END_TEST
 
+/* large apdu with burst transmission */
+START_TEST (test_send_pass_003)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->is_bound = TRUE;
+	struct pgm_send_burst_t* burst = g_new0 (struct pgm_send_burst_t, 1);
+	burst->len  = 4;
+	burst->skb  = g_new0 (struct pgm_sk_buff_t*, burst->len);
+	burst->sent = g_new0 (size_t, burst->len);
+	sock->tx_burst = burst;
+	const gsize apdu_length = 16000;
+	const guint packets = (apdu_length + sock->max_tsdu_fragment - 1) / sock->max_tsdu_fragment;
+	guint8 buffer[ apdu_length ];
+	gsize bytes_written;
+	mock_burst_calls = 0;
+	fail_unless (PGM_IO_STATUS_NORMAL == pgm_send (sock, buffer, apdu_length, &bytes_written), "send not normal");
+	fail_unless ((gssize)apdu_length == bytes_written, "send underrun");
+	fail_unless ((packets + burst->len - 1) / burst->len == mock_burst_calls, "burst count mismatch");
+	fail_unless (0 == burst->count, "burst not drained");
+	fail_unless (packets == pgm_sock_stats_read (sock, PGM_PC_SOURCE_DATA_MSGS_SENT), "packet count mismatch");
+	fail_unless (apdu_length == pgm_sock_stats_read (sock, PGM_PC_SOURCE_DATA_BYTES_SENT), "data bytes mismatch");
+}
+END_TEST
+
+/* multi-TPDU apdu on a non-blocking socket with packet pacing */
+START_TEST (test_send_pass_004)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->is_bound = TRUE;
+	sock->is_nonblocking = TRUE;
+	sock->is_controlled_odata = TRUE;
+	sock->txw_pacing = PGM_PACING_USER;
+	fail_unless (pgm_time_init (NULL), "time init failed");
+	pgm_rate_create (&sock->rate_control, 1000 * 1000, sock->iphdr_len, sock->max_tpdu);
+	pgm_rate_set_pacing (&sock->rate_control, sock->max_tpdu);
+	const gsize apdu_length = 3 * sock->max_tsdu_fragment;
+	guint8 buffer[ apdu_length ];
+	gsize bytes_written;
+	int status;
+	for (guint i = 0; i < 100; i++) {
+		status = pgm_send (sock, buffer, apdu_length, &bytes_written);
+		if (PGM_IO_STATUS_RATE_LIMITED != status)
+			break;
+		g_usleep (10 * 1000);
+	}
+	fail_unless (PGM_IO_STATUS_NORMAL == status, "send not normal");
+	fail_unless ((gssize)apdu_length == bytes_written, "send underrun");
+	fail_unless (pgm_time_shutdown (), "time shutdown failed");
+}
+END_TEST
+
+/* header template checksums across sequence number wrap */
+START_TEST (test_send_pass_005)
+{
+	mock_enable_csum ();
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->is_bound = TRUE;
+	sock->window->lead  = UINT32_MAX;
+	sock->window->trail = UINT32_MAX - 10;
+	guint8 buffer[ 3 * TEST_MAX_TPDU ];
+	for (guint i = 0; i < sizeof(buffer); i++)
+		buffer[i] = (guint8)i;
+	gsize bytes_written;
+/* single TPDU */
+	fail_unless (PGM_IO_STATUS_NORMAL == pgm_send (sock, buffer, 101, &bytes_written), "send not normal");
+	const struct pgm_header* header = (const struct pgm_header*)mock_sent_buf;
+	const struct pgm_data* odata = (const struct pgm_data*)(header + 1);
+	fail_unless (PGM_ODATA == header->pgm_type, "not odata");
+	fail_unless (0 == g_ntohl (odata->data_sqn), "sequence mismatch");
+	fail_unless (UINT32_MAX - 10 == g_ntohl (odata->data_trail), "trail mismatch");
+	fail_unless (is_valid_checksum (mock_sent_buf, mock_sent_len), "odata checksum mismatch");
+/* multiple TPDUs with OPT_FRAGMENT */
+	sock->window->lead = UINT32_MAX - 2;
+	fail_unless (PGM_IO_STATUS_NORMAL == pgm_send (sock, buffer, sizeof(buffer), &bytes_written), "send not normal");
+	fail_unless (UINT32_MAX - 1 == g_ntohl (odata->data_sqn), "sequence mismatch");
+	fail_unless (PGM_OPT_PRESENT & header->pgm_options, "no fragment option");
+	fail_unless (is_valid_checksum (mock_sent_buf, mock_sent_len), "fragment checksum mismatch");
+	mock_is_csum_enabled = FALSE;
+}
+END_TEST
+
 START_TEST (test_send_fail_001)
 {
 	guint8 buffer[ TEST_TXW_SQNS * TEST_MAX_TPDU ];
@@ -768,6 +1030,32 @@ START_TEST (test_send_spm_pass_001)
 }
 END_TEST
 
+/* header template checksums across sequence number wrap, with and without options */
+START_TEST (test_send_spm_pass_002)
+{
+	mock_enable_csum ();
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->spm_sqn = UINT32_MAX - 1;
+	sock->window->lead  = 2;
+	sock->window->trail = UINT32_MAX - 2;
+	fail_unless (TRUE == pgm_send_spm (sock, 0), "send_spm failed");
+	const struct pgm_header* header = (const struct pgm_header*)mock_sent_buf;
+	const struct pgm_spm* spm = (const struct pgm_spm*)(header + 1);
+	fail_unless (PGM_SPM == header->pgm_type, "not spm");
+	fail_unless (UINT32_MAX - 1 == g_ntohl (spm->spm_sqn), "sequence mismatch");
+	fail_unless (is_valid_checksum (mock_sent_buf, mock_sent_len), "spm checksum mismatch");
+	sock->use_proactive_parity = TRUE;
+	sock->rs_k = 8;
+	sock->is_pending_crqst = TRUE;
+	fail_unless (TRUE == pgm_send_spm (sock, PGM_OPT_FIN), "send_spm failed");
+	fail_unless (UINT32_MAX == g_ntohl (spm->spm_sqn), "sequence mismatch");
+	fail_unless (PGM_OPT_PRESENT & header->pgm_options, "no options");
+	fail_unless (is_valid_checksum (mock_sent_buf, mock_sent_len), "spm checksum mismatch");
+	mock_is_csum_enabled = FALSE;
+}
+END_TEST
+
 START_TEST (test_send_spm_fail_001)
 {
 	pgm_send_spm (NULL, 0);
@@ -789,7 +1077,83 @@ START_TEST (test_on_deferred_nak_pass_001)
 	pgm_on_deferred_nak (sock);
 }
 END_TEST
+
+/* queued selective repairs with burst transmission */
+START_TEST (test_on_deferred_nak_pass_002)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	struct pgm_send_burst_t* burst = g_new0 (struct pgm_send_burst_t, 1);
+	burst->len  = 4;
+	burst->skb  = g_new0 (struct pgm_sk_buff_t*, burst->len);
+	burst->sent = g_new0 (size_t, burst->len);
+	sock->rdata_burst = burst;
+	mock_retransmit_selective_len = 3;
+	mock_retransmit_remove_calls = 0;
+	mock_burst_calls = 0;
+	fail_unless (TRUE == pgm_on_deferred_nak (sock), "on_deferred_nak failed");
+	fail_unless (1 == mock_burst_calls, "burst count mismatch");
+	fail_unless (3 == mock_retransmit_remove_calls, "remove count mismatch");
+	fail_unless (0 == burst->count, "burst not drained");
+	fail_unless (3 == pgm_sock_stats_read (sock, PGM_PC_SOURCE_SELECTIVE_MSGS_RETRANSMITTED), "repair count mismatch");
+	for (unsigned i = 0; i < 3; i++)
+		fail_unless (PGM_RDATA == burst->skb[i]->pgm_header->pgm_type, "not rdata");
+}
+END_TEST
+
+/* repairs of packets still referenced by zero-copy sends are sent from a copy */
+START_TEST (test_on_deferred_nak_pass_003)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	struct pgm_send_burst_t* burst = g_new0 (struct pgm_send_burst_t, 1);
+	burst->len  = 4;
+	burst->skb  = g_new0 (struct pgm_sk_buff_t*, burst->len);
+	burst->sent = g_new0 (size_t, burst->len);
+	sock->rdata_burst = burst;
+	sock->zerocopy = g_new0 (pgm_zerocopy_t, 1);
+	mock_is_zerocopy_pending = TRUE;
+	mock_retransmit_selective_len = 3;
+	mock_retransmit_remove_calls = 0;
+	mock_burst_calls = 0;
+	fail_unless (TRUE == pgm_on_deferred_nak (sock), "on_deferred_nak failed");
+	mock_is_zerocopy_pending = FALSE;
+	fail_unless (0 == mock_burst_calls, "burst count mismatch");
+	fail_unless (1 == mock_retransmit_remove_calls, "remove count mismatch");
+	fail_unless (1 == pgm_sock_stats_read (sock, PGM_PC_SOURCE_SELECTIVE_MSGS_RETRANSMITTED), "repair count mismatch");
+	fail_unless (PGM_ODATA == burst->skb[0]->pgm_header->pgm_type, "original rewritten");
+}
+END_TEST
 	
+/* repair checksum updated incrementally from the original data across trail wrap */
+START_TEST (test_on_deferred_nak_pass_004)
+{
+	mock_enable_csum ();
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	struct pgm_sk_buff_t* skb = generate_odata ();
+	const gsize tpdu_length = (char*)skb->tail - (char*)skb->head;
+	memcpy (skb->pgm_header->pgm_gsi, &sock->tsi.gsi, sizeof(pgm_gsi_t));
+	skb->pgm_header->pgm_sport = sock->tsi.sport;
+	skb->pgm_header->pgm_dport = sock->dport;
+	skb->pgm_data->data_sqn    = g_htonl (UINT32_MAX);
+	skb->pgm_data->data_trail  = g_htonl (UINT32_MAX - 10);
+	skb->pgm_header->pgm_checksum = pgm_csum_fold (pgm_csum_partial (skb->head, (uint16_t)tpdu_length, 0));
+	fail_unless (is_valid_checksum (skb->head, tpdu_length), "odata checksum mismatch");
+	sock->window->trail = 1;
+	mock_retransmit_skb = skb;
+	fail_unless (TRUE == pgm_on_deferred_nak (sock), "on_deferred_nak failed");
+	mock_retransmit_skb = NULL;
+	const struct pgm_header* header = (const struct pgm_header*)mock_sent_buf;
+	const struct pgm_data* rdata = (const struct pgm_data*)(header + 1);
+	fail_unless (tpdu_length == mock_sent_len, "length mismatch");
+	fail_unless (PGM_RDATA == header->pgm_type, "not rdata");
+	fail_unless (1 == g_ntohl (rdata->data_trail), "trail mismatch");
+	fail_unless (is_valid_checksum (mock_sent_buf, mock_sent_len), "rdata checksum mismatch");
+	mock_is_csum_enabled = FALSE;
+}
+END_TEST
+
 START_TEST (test_on_deferred_nak_fail_001)
 {
 	pgm_on_deferred_nak (NULL);
@@ -912,6 +1276,67 @@ START_TEST (test_on_nak_pass_004)
 }
 END_TEST
 
+/* duplicate naks within the aggregation interval */
+START_TEST (test_on_nak_pass_005)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->ncf_ivl = pgm_msecs(10);
+	mock_peek_skb = generate_skb ();
+	for (unsigned i = 0; i < 3; i++) {
+		struct pgm_sk_buff_t* skb = generate_single_nak ();
+		fail_if (NULL == skb, "generate_single_nak failed");
+		skb->sock = sock;
+		skb->tstamp = pgm_secs(1) + pgm_msecs(i);
+		fail_unless (TRUE == pgm_on_nak (sock, skb), "on_nak failed");
+	}
+	fail_unless (0 == mock_sendto_calls, "NCF not deferred");
+	fail_unless (1 == sock->ncf_pending[0].sqn_list.len, "pending NCF mismatch");
+	fail_unless (2 == pgm_sock_stats_read (sock, PGM_PC_SOURCE_SELECTIVE_NAKS_IGNORED), "ignored NAKs mismatch");
+	fail_unless (pgm_secs(1) + pgm_msecs(10) == sock->ncf_expiry, "NCF expiry mismatch");
+	pgm_send_deferred_ncf (sock);
+	fail_unless (1 == mock_sendto_calls, "NCF not sent");
+	fail_unless (0 == sock->ncf_pending[0].sqn_list.len, "pending NCF not cleared");
+	fail_unless (0 == sock->ncf_expiry, "NCF expiry not cleared");
+}
+END_TEST
+
+/* aggregated confirmations carry the NLAs of their NAKs */
+START_TEST (test_on_nak_pass_006)
+{
+	pgm_sock_t* sock = generate_sock ();
+	fail_if (NULL == sock, "generate_sock failed");
+	sock->ncf_ivl = pgm_msecs(10);
+	mock_peek_skb = generate_skb ();
+	mock_sendto_calls = 0;
+	struct sockaddr_in src_nla[2], grp_nla;
+	memset (src_nla, 0, sizeof(src_nla));
+	memset (&grp_nla, 0, sizeof(grp_nla));
+	src_nla[0].sin_family = src_nla[1].sin_family = grp_nla.sin_family = AF_INET;
+	src_nla[0].sin_addr.s_addr = inet_addr ("127.0.0.2");
+	src_nla[1].sin_addr.s_addr = inet_addr ("127.0.0.3");
+	grp_nla.sin_addr.s_addr = inet_addr ("239.192.0.1");
+	struct pgm_sqn_list_t sqn_list = { .len = 1 };
+	for (unsigned i = 0; i < 2; i++) {
+		sqn_list.sqn[0] = i;
+		mock_ncf_expiry = 0;
+		aggregate_nak (sock, (struct sockaddr*)&src_nla[i], (struct sockaddr*)&grp_nla, &sqn_list, FALSE, pgm_secs(1));
+	}
+	fail_unless (1 == mock_sendto_calls, "NCF not flushed on NLA change");
+	fail_unless (1 == sock->ncf_pending[0].sqn_list.len, "pending NCF mismatch");
+	pgm_send_deferred_ncf (sock);
+	fail_unless (2 == mock_sendto_calls, "NCF not sent");
+	const struct pgm_header* header = (const struct pgm_header*)mock_sent_buf;
+	const struct pgm_nak* ncf = (const struct pgm_nak*)(header + 1);
+	struct sockaddr_storage addr;
+	fail_unless (PGM_NCF == header->pgm_type, "not ncf");
+	pgm_nla_to_sockaddr (&ncf->nak_src_nla_afi, (struct sockaddr*)&addr);
+	fail_unless (0 == pgm_sockaddr_cmp ((struct sockaddr*)&addr, (struct sockaddr*)&src_nla[1]), "source NLA mismatch");
+	pgm_nla_to_sockaddr (&ncf->nak_grp_nla_afi, (struct sockaddr*)&addr);
+	fail_unless (0 == pgm_sockaddr_cmp ((struct sockaddr*)&addr, (struct sockaddr*)&grp_nla), "group NLA mismatch");
+}
+END_TEST
+
 START_TEST (test_on_nak_fail_001)
 {
 	pgm_sock_t* sock = generate_sock ();
@@ -1158,6 +1583,9 @@ make_test_suite (void)
 	tcase_add_checked_fixture (tc_send, mock_setup, NULL);
 	tcase_add_test (tc_send, test_send_pass_001);
 	tcase_add_test (tc_send, test_send_pass_002);
+	tcase_add_test (tc_send, test_send_pass_003);
+	tcase_add_test (tc_send, test_send_pass_004);
+	tcase_add_test (tc_send, test_send_pass_005);
 	tcase_add_test (tc_send, test_send_fail_001);
 
 	TCase* tc_sendv = tcase_create ("sendv");
@@ -1180,6 +1608,7 @@ make_test_suite (void)
 	suite_add_tcase (s, tc_send_spm);
 	tcase_add_checked_fixture (tc_send_spm, mock_setup, NULL);
 	tcase_add_test (tc_send_spm, test_send_spm_pass_001);
+	tcase_add_test (tc_send_spm, test_send_spm_pass_002);
 #ifndef PGM_CHECK_NOFORK
 	tcase_add_test_raise_signal (tc_send_spm, test_send_spm_fail_001, SIGABRT);
 #endif
@@ -1188,6 +1617,9 @@ make_test_suite (void)
 	suite_add_tcase (s, tc_on_deferred_nak);
 	tcase_add_checked_fixture (tc_on_deferred_nak, mock_setup, NULL);
 	tcase_add_test (tc_on_deferred_nak, test_on_deferred_nak_pass_001);
+	tcase_add_test (tc_on_deferred_nak, test_on_deferred_nak_pass_002);
+	tcase_add_test (tc_on_deferred_nak, test_on_deferred_nak_pass_003);
+	tcase_add_test (tc_on_deferred_nak, test_on_deferred_nak_pass_004);
 #ifndef PGM_CHECK_NOFORK
 	tcase_add_test_raise_signal (tc_on_deferred_nak, test_on_deferred_nak_fail_001, SIGABRT);
 #endif
@@ -1209,6 +1641,8 @@ make_test_suite (void)
 	tcase_add_test (tc_on_nak, test_on_nak_pass_002);
 	tcase_add_test (tc_on_nak, test_on_nak_pass_003);
 	tcase_add_test (tc_on_nak, test_on_nak_pass_004);
+	tcase_add_test (tc_on_nak, test_on_nak_pass_005);
+	tcase_add_test (tc_on_nak, test_on_nak_pass_006);
 	tcase_add_test (tc_on_nak, test_on_nak_fail_001);
 #ifndef PGM_CHECK_NOFORK
 	tcase_add_test_raise_signal (tc_on_nak, test_on_nak_fail_002, SIGABRT);
@@ -0,0 +1,95 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * 64-bit performance counters sharded by writer role.
+ *
+ * Copyright (c) 2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+#include <string.h>
+#include <impl/framework.h>
+
+
+//#define STATS_DEBUG
+
+/* collects before giving up on writers going quiet */
+#define PGM_STATS_MAX_COLLECTS	8
+
+
+static
+void
+_pgm_stats_collect (
+	const volatile uint64_t* restrict shard,
+	const size_t			  stride,
+	const unsigned			  shards,
+	const unsigned			  len,
+	uint64_t*		 restrict sum
+	)
+{
+	for (unsigned i = 0; i < len; i++)
+		sum[i] = pgm_atomic_read64 (&shard[i]);
+	for (unsigned j = 1; j < shards; j++) {
+		shard += stride;
+		for (unsigned i = 0; i < len; i++)
+			sum[i] += pgm_atomic_read64 (&shard[i]);
+	}
+}
+
+/* sum sharded counters into snapshot without stopping the writers.
+ *
+ * counters only move forward, so two identical collects in a row show that
+ * nothing changed between them and the result is the value of every counter
+ * at one instant.  if the writers never pause the last collect is returned,
+ * which is exact per counter.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_stats_snapshot (
+	const volatile uint64_t* restrict shard,	/* first counter of first shard */
+	const size_t			  stride,	/* in counters */
+	const unsigned			  shards,
+	const unsigned			  len,		/* counters per shard */
+	uint64_t*		 restrict snapshot
+	)
+{
+	uint64_t collect[PGM_STATS_MAX_LEN];
+
+/* pre-conditions */
+	pgm_assert (NULL != shard);
+	pgm_assert (shards > 0);
+	pgm_assert (len > 0);
+	pgm_assert (len <= PGM_STATS_MAX_LEN);
+	pgm_assert (shards == 1 || stride >= len);
+	pgm_assert (NULL != snapshot);
+
+	_pgm_stats_collect (shard, stride, shards, len, snapshot);
+	for (unsigned i = 1; i < PGM_STATS_MAX_COLLECTS; i++)
+	{
+		_pgm_stats_collect (shard, stride, shards, len, collect);
+		if (0 == memcmp (collect, snapshot, len * sizeof(uint64_t)))
+			return;
+		memcpy (snapshot, collect, len * sizeof(uint64_t));
+	}
+#ifdef STATS_DEBUG
+	pgm_debug ("Snapshot of %u counters did not settle.", len);
+#endif
+}
+
+/* eof */
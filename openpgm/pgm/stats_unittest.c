@@ -0,0 +1,197 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * unit tests for sharded performance counters.
+ *
+ * Copyright (c) 2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include <signal.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+#include <check.h>
+
+#ifdef _WIN32
+#	define PGM_CHECK_NOFORK		1
+#endif
+
+
+/* mock state */
+
+#define TEST_COUNTERS		5
+
+
+/* mock functions for external references */
+
+#define STATS_DEBUG
+#include "stats.c"
+
+PGM_GNUC_INTERNAL
+int
+pgm_get_nprocs (void)
+{
+	return 1;
+}
+
+
+/* target:
+ *	void
+ *	pgm_stats_add (
+ *		volatile uint64_t*	shard,
+ *		const unsigned		counter,
+ *		const uint64_t		val
+ *	)
+ */
+
+/* counters carry past 32 bits */
+START_TEST (test_add_pass_001)
+{
+	volatile uint64_t shard[TEST_COUNTERS];
+	memset ((void*)shard, 0, sizeof(shard));
+	pgm_stats_add (shard, 1, UINT32_MAX);
+	pgm_stats_inc (shard, 1);
+	fail_unless ((uint64_t)UINT32_MAX + 1 == shard[1], "add failed");
+	fail_unless (0 == shard[0], "neighbour modified");
+	fail_unless (0 == shard[2], "neighbour modified");
+}
+END_TEST
+
+/* target:
+ *	void
+ *	pgm_stats_atomic_inc (
+ *		volatile uint64_t*	shard,
+ *		const unsigned		counter
+ *	)
+ */
+
+START_TEST (test_atomic_inc_pass_001)
+{
+	volatile uint64_t shard[TEST_COUNTERS];
+	memset ((void*)shard, 0, sizeof(shard));
+	pgm_stats_atomic_inc (shard, 4);
+	pgm_stats_atomic_add (shard, 4, 2);
+	fail_unless (3 == shard[4], "add failed");
+}
+END_TEST
+
+/* target:
+ *	void
+ *	pgm_stats_snapshot (
+ *		const volatile uint64_t* restrict shard,
+ *		const size_t			  stride,
+ *		const unsigned			  shards,
+ *		const unsigned			  len,
+ *		uint64_t*		 restrict snapshot
+ *	)
+ */
+
+/* padded shards as laid out in pgm_sock_t */
+START_TEST (test_snapshot_pass_001)
+{
+	volatile uint64_t stats[PGM_STATS_SHARDS][PGM_STATS_SHARD_LEN(TEST_COUNTERS)];
+	uint64_t snapshot[TEST_COUNTERS];
+	memset ((void*)stats, 0xff, sizeof(stats));
+	for (unsigned i = 0; i < PGM_STATS_SHARDS; i++)
+		for (unsigned j = 0; j < TEST_COUNTERS; j++)
+			stats[i][PGM_STATS_PAD + j] = (i + 1) * (j + 1);
+	pgm_stats_snapshot (&stats[0][PGM_STATS_PAD], PGM_STATS_SHARD_LEN(TEST_COUNTERS), PGM_STATS_SHARDS, TEST_COUNTERS, snapshot);
+	const unsigned roles = PGM_STATS_SHARDS * (PGM_STATS_SHARDS + 1) / 2;
+	for (unsigned j = 0; j < TEST_COUNTERS; j++)
+		fail_unless (roles * (j + 1) == snapshot[j], "sum mismatch");
+}
+END_TEST
+
+/* single shard as laid out in pgm_peer_t */
+START_TEST (test_snapshot_pass_002)
+{
+	volatile uint64_t stats[TEST_COUNTERS] = { 1, 2, UINT64_C(0x100000000), 4, 5 };
+	uint64_t snapshot[TEST_COUNTERS];
+	pgm_stats_snapshot (stats, 0, 1, TEST_COUNTERS, snapshot);
+	fail_unless (0 == memcmp ((const void*)stats, snapshot, sizeof(snapshot)), "snapshot mismatch");
+}
+END_TEST
+
+START_TEST (test_snapshot_fail_001)
+{
+	uint64_t snapshot[TEST_COUNTERS];
+	pgm_stats_snapshot (NULL, 0, 1, TEST_COUNTERS, snapshot);
+	fail ("reached");
+}
+END_TEST
+
+/* too many counters */
+START_TEST (test_snapshot_fail_002)
+{
+	volatile uint64_t stats[PGM_STATS_MAX_LEN + 1];
+	uint64_t snapshot[PGM_STATS_MAX_LEN + 1];
+	pgm_stats_snapshot (stats, 0, 1, PGM_STATS_MAX_LEN + 1, snapshot);
+	fail ("reached");
+}
+END_TEST
+
+
+static
+Suite*
+make_test_suite (void)
+{
+	Suite* s;
+
+	s = suite_create (__FILE__);
+
+	TCase* tc_add = tcase_create ("add");
+	suite_add_tcase (s, tc_add);
+	tcase_add_test (tc_add, test_add_pass_001);
+
+	TCase* tc_atomic_inc = tcase_create ("atomic-inc");
+	suite_add_tcase (s, tc_atomic_inc);
+	tcase_add_test (tc_atomic_inc, test_atomic_inc_pass_001);
+
+	TCase* tc_snapshot = tcase_create ("snapshot");
+	suite_add_tcase (s, tc_snapshot);
+	tcase_add_test (tc_snapshot, test_snapshot_pass_001);
+	tcase_add_test (tc_snapshot, test_snapshot_pass_002);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_snapshot, test_snapshot_fail_001, SIGABRT);
+	tcase_add_test_raise_signal (tc_snapshot, test_snapshot_fail_002, SIGABRT);
+#endif
+	return s;
+}
+
+static
+Suite*
+make_master_suite (void)
+{
+	Suite* s = suite_create ("Master");
+	return s;
+}
+
+int
+main (void)
+{
+	pgm_messages_init();
+	SRunner* sr = srunner_create (make_master_suite ());
+	srunner_add_suite (sr, make_test_suite ());
+	srunner_run_all (sr, CK_ENV);
+	int number_failed = srunner_ntests_failed (sr);
+	srunner_free (sr);
+	pgm_messages_shutdown();
+	return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* eof */
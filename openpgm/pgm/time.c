@@ -26,6 +26,7 @@
 #endif
 #include <errno.h>
 #include <stdlib.h>
+#include <string.h>
 #ifdef _WIN32
 #	define WIN32_LEAN_AND_MEAN
 #	include <windows.h>
@@ -73,6 +74,9 @@ static void			pgm_time_conv_from_reset (const pgm_time_t*const restrict, time_t*
 #if defined(HAVE_CLOCK_GETTIME)
 #	include <time.h>
 static pgm_time_t		pgm_clock_update (void);
+#	ifdef CLOCK_MONOTONIC_COARSE
+static pgm_time_t		pgm_coarse_clock_update (void);
+#	endif
 #endif
 #ifdef HAVE_FTIME
 #	include <sys/timeb.h>
@@ -171,6 +175,11 @@ static pgm_time_t		pgm_rtc_update (void);
 #		include <intrin.h>
 #	endif
 #	define TSC_NS_SCALE	10 /* 2^10, carefully chosen */
+#	ifdef HAVE_CLOCK_GETTIME
+#		define TSC_FALLBACK_UPDATE	pgm_clock_update
+#	else
+#		define TSC_FALLBACK_UPDATE	pgm_gettimeofday_update
+#	endif
 #	define TSC_US_SCALE	20
 static uint_fast32_t		tsc_khz PGM_GNUC_READ_MOSTLY = 0;
 static uint_fast32_t		tsc_ns_mul PGM_GNUC_READ_MOSTLY = 0;
@@ -255,6 +264,8 @@ pgm_time_init (
 /* default time stamp function */
 #if defined(_WIN32)
 			"MMTIME"
+#elif defined(HAVE_CLOCK_GETTIME)
+			"CLOCK_MONOTONIC"
 #else
 			"GETTIMEOFDAY"
 #endif
@@ -271,9 +282,23 @@ pgm_time_init (
 		break;
 #endif
 #ifdef HAVE_CLOCK_GETTIME
+/* CLOCK_MONOTONIC, or CLOCK_MONOTONIC_COARSE for any PGM_TIMER value containing COARSE */
 	case 'C':
-		pgm_minor (_("Using clock_gettime() timer."));
-		pgm_time_update_now	= pgm_clock_update;
+#	ifdef CLOCK_MONOTONIC_COARSE
+		if (NULL != strstr (pgm_timer, "COARSE")) {
+			struct timespec res;
+			pgm_time_update_now	= pgm_coarse_clock_update;
+			if (0 == clock_getres (CLOCK_MONOTONIC_COARSE, &res))
+				pgm_minor (_("Using clock_gettime(CLOCK_MONOTONIC_COARSE) timer with %ld ns resolution."),
+					(long)(res.tv_sec * 1000000000L + res.tv_nsec));
+		}
+		else
+#	endif
+		{
+			pgm_minor (_("Using clock_gettime(CLOCK_MONOTONIC) timer."));
+			pgm_time_update_now	= pgm_clock_update;
+		}
+		pgm_time_since_epoch	= pgm_time_conv_from_reset;
 		break;
 #endif
 #ifdef HAVE_DEV_RTC
@@ -372,8 +397,9 @@ pgm_time_init (
 	{
 		char	*rdtsc_frequency;
 
-#ifdef HAVE_PROC_CPUINFO
-/* attempt to parse clock ticks from kernel
+#if defined(HAVE_PROC_CPUINFO) && !defined(HAVE_CLOCK_GETTIME)
+/* attempt to parse clock ticks from kernel, with a monotonic clock available the
+ * TSC is calibrated instead as "cpu MHz" reports the current core frequency.
  */
 		FILE	*fp = fopen ("/proc/cpuinfo", "r");
 		if (fp)
@@ -512,8 +538,14 @@ pgm_time_init (
 	pgm_time_update_now();
 
 /* calculate relative time offset */
-#if defined(HAVE_DEV_RTC) || defined(HAVE_RDTSC) || defined(HAVE_DEV_HPET) || defined(_WIN32)
+#if defined(HAVE_CLOCK_GETTIME) || defined(HAVE_DEV_RTC) || defined(HAVE_RDTSC) || defined(HAVE_DEV_HPET) || defined(_WIN32)
 	if (	0
+#	ifdef HAVE_CLOCK_GETTIME
+		|| pgm_time_update_now == pgm_clock_update
+#		ifdef CLOCK_MONOTONIC_COARSE
+		|| pgm_time_update_now == pgm_coarse_clock_update
+#		endif
+#	endif
 #	ifdef HAVE_DEV_RTC
 		|| pgm_time_update_now == pgm_rtc_update
 #	endif
@@ -610,21 +642,37 @@ pgm_gettimeofday_update (void)
 #endif /* HAVE_GETTIMEOFDAY */
 
 #ifdef HAVE_CLOCK_GETTIME
+/* CLOCK_MONOTONIC never steps backwards so no clamp against a shared last value is
+ * required, serviced from the vDSO on Linux without entering the kernel.
+ *
+ * WARNING: time is relative to an unspecified start, usually boot.
+ */
+
 static
 pgm_time_t
 pgm_clock_update (void)
 {
 	struct timespec		clock_now;
-	pgm_time_t		now;
-	static pgm_time_t	last = 0;
 
 	clock_gettime (CLOCK_MONOTONIC, &clock_now);
-	now = secs_to_usecs (clock_now.tv_sec) + nsecs_to_usecs (clock_now.tv_nsec);
-	if (PGM_UNLIKELY(now < last))
-		return last;
-	else
-		return last = now;
+	return secs_to_usecs (clock_now.tv_sec) + nsecs_to_usecs (clock_now.tv_nsec);
 }
+
+#	ifdef CLOCK_MONOTONIC_COARSE
+/* Time of the last scheduler tick, resolution of 1-10ms depending upon kernel HZ.
+ * Cheapest monotonic source, rate limits below one packet per tick will burst.
+ */
+
+static
+pgm_time_t
+pgm_coarse_clock_update (void)
+{
+	struct timespec		clock_now;
+
+	clock_gettime (CLOCK_MONOTONIC_COARSE, &clock_now);
+	return secs_to_usecs (clock_now.tv_sec) + nsecs_to_usecs (clock_now.tv_nsec);
+}
+#	endif
 #endif /* HAVE_CLOCK_GETTIME */
 
 #ifdef HAVE_FTIME
@@ -800,8 +848,9 @@ pgm_rdtsc (void)
 }
 
 #	ifndef _WIN32
-/* determine ratio of ticks to nano-seconds, use /dev/rtc for high accuracy
- * millisecond timer and convert.
+/* determine ratio of ticks to nano-seconds, calibrated against CLOCK_MONOTONIC when
+ * available otherwise a four second sleep.  an unstable TSC falls back to the most
+ * stable clock available.
  *
  * WARNING: time is relative to start of timer.
  */
@@ -836,12 +885,12 @@ pgm_tsc_init (
 	if (!flags || !strstr (flags, " tsc")) {
 		pgm_warn (_("Linux kernel reports no Time Stamp Counter (TSC)."));
 /* force both to stable clocks even though one might be OK */
-		pgm_time_update_now	= pgm_gettimeofday_update;
+		pgm_time_update_now	= TSC_FALLBACK_UPDATE;
 		ret = TRUE;
 	} else if (!strstr (flags, " constant_tsc")) {
 		pgm_warn (_("Linux kernel reports non-constant Time Stamp Counter (TSC)."));
 /* force both to stable clocks even though one might be OK */
-		pgm_time_update_now	= pgm_gettimeofday_update;
+		pgm_time_update_now	= TSC_FALLBACK_UPDATE;
 		ret = TRUE;
 	}
 
@@ -851,6 +900,29 @@ pgm_tsc_init (
 
 #		endif /* HAVE_PROC_CPUINFO */
 
+#		ifdef HAVE_CLOCK_GETTIME
+/* busy wait against the monotonic clock, accurate to parts per million */
+	{
+		const pgm_time_t	calibration_usec = pgm_msecs (50);
+		pgm_time_t		clock_start, clock_stop;
+		uint64_t		tsc_start, tsc_stop;
+
+		clock_start = pgm_clock_update();
+		tsc_start   = pgm_rdtsc();
+		do {
+			clock_stop = pgm_clock_update();
+		} while (clock_stop - clock_start < calibration_usec);
+		tsc_stop    = pgm_rdtsc();
+
+		if (PGM_LIKELY(tsc_stop > tsc_start)) {
+			tsc_khz = (uint_fast32_t)(((tsc_stop - tsc_start) * 1000) / (clock_stop - clock_start));
+			pgm_minor (_("Calibrated TSC against CLOCK_MONOTONIC over %" PGM_TIME_FORMAT " us."),
+				clock_stop - clock_start);
+			return TRUE;
+		}
+	}
+#		endif /* HAVE_CLOCK_GETTIME */
+
 	pgm_time_t		start, stop, elapsed;
 	const pgm_time_t	calibration_usec = secs_to_usecs (4);
 	struct timespec		req = {
@@ -871,7 +943,7 @@ pgm_tsc_init (
 			   "timing.  To prevent the start delay from this benchmark and use a stable clock "
 			   "source set the environment variable PGM_TIMER to GTOD."));
 /* force both to stable clocks even though one might be OK */
-		pgm_time_update_now = pgm_gettimeofday_update;
+		pgm_time_update_now = TSC_FALLBACK_UPDATE;
 		return TRUE;
 	}
 
@@ -126,6 +126,25 @@ START_TEST (test_update_now_pass_001)
 }
 END_TEST
 
+/* coarse monotonic clock */
+#ifdef HAVE_CLOCK_GETTIME
+START_TEST (test_update_now_pass_002)
+{
+	setenv ("PGM_TIMER", "CLOCK_MONOTONIC_COARSE", 1);
+	fail_unless (TRUE == pgm_time_init (NULL), "init failed");
+	unsetenv ("PGM_TIMER");
+	pgm_time_t last_time = pgm_time_update_now ();
+	for (unsigned i = 1; i <= 1000; i++)
+	{
+		const pgm_time_t check_time = pgm_time_update_now ();
+		fail_unless (G_LIKELY(check_time >= last_time), "non-monotonic");
+		last_time = check_time;
+	}
+	fail_unless (TRUE == pgm_time_shutdown (), "shutdown failed");
+}
+END_TEST
+#endif
+
 /* target:
  *	void
  *	pgm_time_since_epoch (
@@ -151,6 +170,18 @@ START_TEST (test_since_epoch_pass_001)
 }
 END_TEST
 
+/* relative clocks are offset to wall time */
+START_TEST (test_since_epoch_pass_002)
+{
+	time_t t;
+	fail_unless (TRUE == pgm_time_init (NULL), "init failed");
+	pgm_time_t pgm_now = pgm_time_update_now ();
+	pgm_time_since_epoch (&pgm_now, &t);
+	fail_unless (labs ((long)(t - time (NULL))) <= 1, "offset failed");
+	fail_unless (TRUE == pgm_time_shutdown (), "shutdown failed");
+}
+END_TEST
+
 
 static
 Suite*
@@ -172,10 +203,14 @@ make_test_suite (void)
 	TCase* tc_update_now = tcase_create ("update-now");
 	suite_add_tcase (s, tc_update_now);
 	tcase_add_test (tc_update_now, test_update_now_pass_001);
+#ifdef HAVE_CLOCK_GETTIME
+	tcase_add_test (tc_update_now, test_update_now_pass_002);
+#endif
 
 	TCase* tc_since_epoch = tcase_create ("since-epoch");
 	suite_add_tcase (s, tc_since_epoch);
 	tcase_add_test (tc_since_epoch, test_since_epoch_pass_001);
+	tcase_add_test (tc_since_epoch, test_since_epoch_pass_002);
 	return s;
 }
 
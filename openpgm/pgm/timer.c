@@ -75,10 +75,10 @@ pgm_timer_prepare (
 PGM_GNUC_INTERNAL
 bool
 pgm_timer_check (
-	pgm_sock_t* const	sock
+	pgm_sock_t* const	sock,
+	const pgm_time_t	now
 	)
 {
-	const pgm_time_t now = pgm_time_update_now();
 	bool expired;
 
 /* pre-conditions */
@@ -96,10 +96,10 @@ pgm_timer_check (
 PGM_GNUC_INTERNAL
 pgm_time_t
 pgm_timer_expiration (
-	pgm_sock_t* const	sock
+	pgm_sock_t* const	sock,
+	const pgm_time_t	now
 	)
 {
-	const pgm_time_t now = pgm_time_update_now();
 	pgm_time_t expiration;
 
 /* pre-conditions */
@@ -111,19 +111,19 @@ pgm_timer_expiration (
 	return expiration;
 }
 
-/* call all timers, assume that time_now has been updated by either pgm_timer_prepare
- * or pgm_timer_check and no other method calls here.
- * 
+/* call all timers with the time sampled by the caller for pgm_timer_check, one
+ * clock read serves the whole event loop iteration.
+ *
  * returns TRUE on success, returns FALSE on blocked send-in-receive operation.
  */
 
 PGM_GNUC_INTERNAL
 bool
 pgm_timer_dispatch (
-	pgm_sock_t* const	sock
+	pgm_sock_t* const	sock,
+	const pgm_time_t	now
 	)
 {
-	const pgm_time_t now = pgm_time_update_now();
 	pgm_time_t next_expiration = 0;
 
 /* pre-conditions */
@@ -131,6 +131,18 @@ pgm_timer_dispatch (
 
 	pgm_debug ("pgm_timer_dispatch (sock:%p)", (const void*)sock);
 
+#ifdef USE_HISTOGRAMS
+/* lateness of the earliest timer including the trip from pgm_timer_check */
+	{
+		const pgm_time_t dispatch_time = pgm_time_update_now();
+		pgm_timer_lock (sock);
+		const pgm_time_t next_poll = sock->next_poll;
+		pgm_timer_unlock (sock);
+		if (pgm_time_after_eq (dispatch_time, next_poll))
+			PGM_HDR_RECORD (PGM_HDR_TIMER_LATENESS, pgm_to_nsecs (dispatch_time - next_poll));
+	}
+#endif
+
 /* find which timers have expired and call each */
 	if (sock->can_recv_data)
 	{
@@ -141,6 +153,15 @@ pgm_timer_dispatch (
 
 	if (sock->can_send_data)
 	{
+/* aggregated NAK confirmations */
+		if (0 != sock->ncf_expiry)
+		{
+			if (pgm_time_after_eq (now, sock->ncf_expiry))
+				pgm_send_deferred_ncf (sock);
+			else
+				next_expiration = next_expiration > 0 ? MIN(next_expiration, sock->ncf_expiry) : sock->ncf_expiry;
+		}
+
 /* reset congestion control on ACK timeout */
 		if (sock->use_pgmcc &&
 		    sock->tokens < pgm_fp8 (1) &&
@@ -48,6 +48,7 @@
 #define pgm_min_receiver_expiry		mock_pgm_min_receiver_expiry
 #define pgm_check_peer_state		mock_pgm_check_peer_state
 #define pgm_send_spm			mock_pgm_send_spm
+#define pgm_send_deferred_ncf		mock_pgm_send_deferred_ncf
 
 
 #define TIMER_DEBUG
@@ -221,6 +222,15 @@ mock_pgm_send_spm (
 	return TRUE;
 }
 
+PGM_GNUC_INTERNAL
+void
+mock_pgm_send_deferred_ncf (
+	pgm_sock_t*		sock
+	)
+{
+	g_assert (NULL != sock);
+}
+
 
 /* target:
  *	bool
@@ -249,7 +259,8 @@ END_TEST
 /* target:
  *	bool
  *	pgm_timer_check (
- *		pgm_sock_t*	sock
+ *		pgm_sock_t*	sock,
+ *		const pgm_time_t	now
  *	)
  */
 
@@ -257,13 +268,13 @@ START_TEST (test_check_pass_001)
 {
 	pgm_sock_t* sock = generate_sock ();
 	fail_if (NULL == sock, "generate_sock failed");
-	fail_unless (TRUE == pgm_timer_check (sock), "check failed");
+	fail_unless (TRUE == pgm_timer_check (sock, mock_pgm_time_now), "check failed");
 }
 END_TEST
 
 START_TEST (test_check_fail_001)
 {
-	gboolean expired = pgm_timer_check (NULL);
+	gboolean expired = pgm_timer_check (NULL, mock_pgm_time_now);
 	fail ("reached");
 }
 END_TEST
@@ -271,7 +282,8 @@ END_TEST
 /* target:
  *	pgm_time_t
  *	pgm_timer_expiration (
- *		pgm_sock_t*	sock
+ *		pgm_sock_t*	sock,
+ *		const pgm_time_t	now
  *	)
  */
 
@@ -280,13 +292,13 @@ START_TEST (test_expiration_pass_001)
 	pgm_sock_t* sock = generate_sock ();
 	fail_if (NULL == sock, "generate_sock failed");
 	sock->next_poll = mock_pgm_time_now + pgm_secs(300);
-	fail_unless (pgm_secs(300) == pgm_timer_expiration (sock), "expiration failed");
+	fail_unless (pgm_secs(300) == pgm_timer_expiration (sock, mock_pgm_time_now), "expiration failed");
 }
 END_TEST
 
 START_TEST (test_expiration_fail_001)
 {
-	long expiration = pgm_timer_expiration (NULL);
+	long expiration = pgm_timer_expiration (NULL, mock_pgm_time_now);
 	fail ("reached");
 }
 END_TEST
@@ -294,7 +306,8 @@ END_TEST
 /* target:
  *	void
  *	pgm_timer_dispatch (
- *		pgm_sock_t*	sock
+ *		pgm_sock_t*	sock,
+ *		const pgm_time_t	now
  *	)
  */
 
@@ -302,13 +315,13 @@ START_TEST (test_dispatch_pass_001)
 {
 	pgm_sock_t* sock = generate_sock ();
 	fail_if (NULL == sock, "generate_sock failed");
-	pgm_timer_dispatch (sock);
+	pgm_timer_dispatch (sock, mock_pgm_time_now);
 }
 END_TEST
 
 START_TEST (test_dispatch_fail_001)
 {
-	pgm_timer_dispatch (NULL);
+	pgm_timer_dispatch (NULL, mock_pgm_time_now);
 	fail ("reached");
 }
 END_TEST
@@ -0,0 +1,306 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * Open addressing table keyed on transport session identifier.
+ *
+ * Copyright (c) 2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+#include <impl/framework.h>
+
+
+//#define TSITABLE_DEBUG
+
+#define TSITABLE_MIN_SIZE	16
+#define TSITABLE_MIGRATE_STEP	4		/* old slots moved per insert or remove */
+
+PGM_STATIC_ASSERT(sizeof(pgm_tsi_t) == sizeof(uint64_t));
+
+
+/* Fibonacci hashing of the 64-bit key, GSI and port bits are spread into the
+ * upper word so masking the result is safe for sequential node identifiers.
+ */
+
+static inline
+uint32_t
+_pgm_tsitable_hash (
+	const pgm_tsi_t*	tsi
+	)
+{
+	uint64_t key;
+	memcpy (&key, tsi, sizeof(key));
+	return (uint32_t)((key * UINT64_C(0x9e3779b97f4a7c15)) >> 32);
+}
+
+static inline
+bool
+_pgm_tsitable_equal (
+	const pgm_tsi_t* restrict tsi1,
+	const pgm_tsi_t* restrict tsi2
+	)
+{
+	return (0 == memcmp (tsi1, tsi2, sizeof(pgm_tsi_t)));
+}
+
+/* returns slot containing tsi or the empty slot ending the probe sequence.
+ */
+
+static inline
+uint32_t
+_pgm_tsitable_probe (
+	const struct pgm_tsientry_t* restrict entries,
+	const uint32_t			      mask,
+	uint32_t			      slot,
+	const pgm_tsi_t*	     restrict tsi
+	)
+{
+	while (NULL != entries[slot].value && !_pgm_tsitable_equal (&entries[slot].tsi, tsi))
+		slot = (slot + 1) & mask;
+	return slot;
+}
+
+/* first slot to probe in the table being migrated.  slots from old_first have
+ * been emptied so a probe homed inside that range starts at the first slot not
+ * yet migrated.  old_first was empty when migration began so no probe sequence
+ * wraps across it.
+ */
+
+static inline
+uint32_t
+_pgm_tsitable_old_start (
+	const pgm_tsitable_t*	t,
+	const uint32_t		hash
+	)
+{
+	const uint32_t home = hash & t->old_mask;
+	if (((home - t->old_first) & t->old_mask) < t->old_done)
+		return (t->old_first + t->old_done) & t->old_mask;
+	return home;
+}
+
+/* remove slot with backward shift, no tombstones are left behind.
+ */
+
+static
+void
+_pgm_tsitable_erase (
+	pgm_tsitable_t*	t,
+	const bool	is_old,
+	uint32_t	hole
+	)
+{
+	struct pgm_tsientry_t* entries = is_old ? t->old_entries : t->entries;
+	const uint32_t mask = is_old ? t->old_mask : t->mask;
+	uint32_t slot = hole;
+
+	for (;;)
+	{
+		slot = (slot + 1) & mask;
+		if (NULL == entries[slot].value)
+			break;
+		const uint32_t hash = _pgm_tsitable_hash (&entries[slot].tsi);
+		const uint32_t home = is_old ? _pgm_tsitable_old_start (t, hash) : (hash & mask);
+/* move back unless home lies cyclically within (hole, slot] */
+		if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+			entries[hole] = entries[slot];
+			hole = slot;
+		}
+	}
+	entries[hole].value = NULL;
+}
+
+/* move up to n slots of the previous table into the current table.
+ */
+
+static
+void
+_pgm_tsitable_migrate (
+	pgm_tsitable_t*	t,
+	uint32_t	n
+	)
+{
+	if (NULL == t->old_entries)
+		return;
+
+	const uint32_t old_size = t->old_mask + 1;
+	while (n-- && t->old_done < old_size)
+	{
+		struct pgm_tsientry_t* entry = &t->old_entries[ (t->old_first + t->old_done) & t->old_mask ];
+		if (NULL != entry->value) {
+			const uint32_t slot = _pgm_tsitable_probe (t->entries, t->mask, _pgm_tsitable_hash (&entry->tsi) & t->mask, &entry->tsi);
+			t->entries[slot] = *entry;
+			entry->value = NULL;
+		}
+		t->old_done++;
+	}
+
+	if (t->old_done == old_size) {
+		pgm_free (t->old_entries);
+		t->old_entries = NULL;
+	}
+}
+
+static
+void
+_pgm_tsitable_grow (
+	pgm_tsitable_t*	t
+	)
+{
+	uint32_t first = 0;
+
+/* complete previous migration */
+	_pgm_tsitable_migrate (t, UINT32_MAX);
+
+	t->old_entries	= t->entries;
+	t->old_mask	= t->mask;
+	t->old_done	= 0;
+	t->mask		= (2 * (t->old_mask + 1)) - 1;
+	t->entries	= pgm_new0 (struct pgm_tsientry_t, t->mask + 1);
+
+/* load is under three quarters so an empty slot exists */
+	while (NULL != t->old_entries[first].value)
+		first++;
+	t->old_first	= first;
+
+	pgm_debug ("pgm_tsitable_grow (t:%p size:%" PRIu32 ")", (const void*)t, t->mask + 1);
+}
+
+PGM_GNUC_INTERNAL
+pgm_tsitable_t*
+pgm_tsitable_new (void)
+{
+	pgm_tsitable_t* t;
+
+	t = pgm_new0 (pgm_tsitable_t, 1);
+	t->mask		= TSITABLE_MIN_SIZE - 1;
+	t->entries	= pgm_new0 (struct pgm_tsientry_t, TSITABLE_MIN_SIZE);
+	return t;
+}
+
+PGM_GNUC_INTERNAL
+void
+pgm_tsitable_destroy (
+	pgm_tsitable_t*	t
+	)
+{
+	pgm_return_if_fail (NULL != t);
+
+	if (t->old_entries)
+		pgm_free (t->old_entries);
+	pgm_free (t->entries);
+	pgm_free (t);
+}
+
+/* insert value, which must not be NULL, for a tsi not already present.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_tsitable_insert (
+	pgm_tsitable_t*  restrict t,
+	const pgm_tsi_t* restrict tsi,
+	void*		 restrict value
+	)
+{
+	uint32_t hash, slot;
+
+	pgm_return_if_fail (NULL != t);
+	pgm_return_if_fail (NULL != tsi);
+	pgm_return_if_fail (NULL != value);
+
+	if (4 * (t->count + 1) > 3 * (t->mask + 1))
+		_pgm_tsitable_grow (t);
+
+	hash = _pgm_tsitable_hash (tsi);
+	if (t->old_entries) {
+		slot = _pgm_tsitable_probe (t->old_entries, t->old_mask, _pgm_tsitable_old_start (t, hash), tsi);
+		pgm_return_if_fail (NULL == t->old_entries[slot].value);
+	}
+	slot = _pgm_tsitable_probe (t->entries, t->mask, hash & t->mask, tsi);
+	pgm_return_if_fail (NULL == t->entries[slot].value);
+
+	memcpy (&t->entries[slot].tsi, tsi, sizeof(pgm_tsi_t));
+	t->entries[slot].value = value;
+	t->count++;
+
+	_pgm_tsitable_migrate (t, TSITABLE_MIGRATE_STEP);
+}
+
+/* returns TRUE if tsi was found and removed, FALSE if not present.
+ */
+
+PGM_GNUC_INTERNAL
+bool
+pgm_tsitable_remove (
+	pgm_tsitable_t*  restrict t,
+	const pgm_tsi_t* restrict tsi
+	)
+{
+	uint32_t hash, slot;
+	bool is_found = FALSE;
+
+	pgm_return_val_if_fail (NULL != t, FALSE);
+	pgm_return_val_if_fail (NULL != tsi, FALSE);
+
+	hash = _pgm_tsitable_hash (tsi);
+	slot = _pgm_tsitable_probe (t->entries, t->mask, hash & t->mask, tsi);
+	if (NULL != t->entries[slot].value) {
+		_pgm_tsitable_erase (t, FALSE, slot);
+		is_found = TRUE;
+	} else if (t->old_entries) {
+		slot = _pgm_tsitable_probe (t->old_entries, t->old_mask, _pgm_tsitable_old_start (t, hash), tsi);
+		if (NULL != t->old_entries[slot].value) {
+			_pgm_tsitable_erase (t, TRUE, slot);
+			is_found = TRUE;
+		}
+	}
+
+	if (is_found)
+		t->count--;
+	_pgm_tsitable_migrate (t, TSITABLE_MIGRATE_STEP);
+	return is_found;
+}
+
+/* returns value for tsi or NULL if not present.  lookups never modify the table
+ * and are safe with concurrent readers.
+ */
+
+PGM_GNUC_INTERNAL
+void*
+pgm_tsitable_lookup (
+	const pgm_tsitable_t* restrict t,
+	const pgm_tsi_t*      restrict tsi
+	)
+{
+	uint32_t hash, slot;
+
+	pgm_return_val_if_fail (NULL != t, NULL);
+	pgm_return_val_if_fail (NULL != tsi, NULL);
+
+	hash = _pgm_tsitable_hash (tsi);
+	slot = _pgm_tsitable_probe (t->entries, t->mask, hash & t->mask, tsi);
+	if (PGM_LIKELY(NULL != t->entries[slot].value))
+		return t->entries[slot].value;
+	if (NULL == t->old_entries)
+		return NULL;
+	slot = _pgm_tsitable_probe (t->old_entries, t->old_mask, _pgm_tsitable_old_start (t, hash), tsi);
+	return t->old_entries[slot].value;
+}
+
+/* eof */
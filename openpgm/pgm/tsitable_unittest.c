@@ -0,0 +1,283 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * unit tests for the TSI keyed peer table.
+ *
+ * Copyright (c) 2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include <signal.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+#include <check.h>
+
+
+/* mock state */
+
+#define TEST_KEYS	2000
+
+/* mock functions for external references */
+
+#define TSITABLE_DEBUG
+#include "tsitable.c"
+
+PGM_GNUC_INTERNAL
+int
+pgm_get_nprocs (void)
+{
+	return 1;
+}
+
+static
+void
+generate_tsi (
+	pgm_tsi_t*	tsi,
+	const guint	i
+	)
+{
+/* sequential node identifiers on one port and one node on sequential ports */
+	memset (tsi, 0, sizeof(pgm_tsi_t));
+	tsi->gsi.identifier[0] = 1;
+	tsi->gsi.identifier[4] = (i >> 8) & 0xff;
+	tsi->gsi.identifier[5] = i & 0xff;
+	tsi->sport = g_htons (1000 + (i % 3));
+}
+
+
+/* target:
+ *	pgm_tsitable_t*
+ *	pgm_tsitable_new (void)
+ */
+
+START_TEST (test_new_pass_001)
+{
+	pgm_tsitable_t* t = pgm_tsitable_new ();
+	fail_if (NULL == t, "new failed");
+	fail_unless (0 == t->count, "new failed");
+	fail_unless (0 == ((t->mask + 1) & t->mask), "not power of two");
+	pgm_tsitable_destroy (t);
+}
+END_TEST
+
+/* target:
+ *	void
+ *	pgm_tsitable_insert (
+ *		pgm_tsitable_t*		t,
+ *		const pgm_tsi_t*	tsi,
+ *		void*			value
+ *	)
+ */
+
+START_TEST (test_insert_pass_001)
+{
+	pgm_tsitable_t* t = pgm_tsitable_new ();
+	pgm_tsi_t tsi[3];
+	for (guint i = 0; i < G_N_ELEMENTS(tsi); i++) {
+		generate_tsi (&tsi[i], i);
+		pgm_tsitable_insert (t, &tsi[i], GUINT_TO_POINTER(i + 1));
+	}
+	fail_unless (3 == t->count, "insert failed");
+	for (guint i = 0; i < G_N_ELEMENTS(tsi); i++)
+		fail_unless (GUINT_TO_POINTER(i + 1) == pgm_tsitable_lookup (t, &tsi[i]), "lookup failed");
+	pgm_tsitable_destroy (t);
+}
+END_TEST
+
+/* every key visible whilst growth migrates the previous table */
+START_TEST (test_insert_pass_002)
+{
+	pgm_tsitable_t* t = pgm_tsitable_new ();
+	gboolean is_migrated = FALSE;
+	for (guint i = 0; i < TEST_KEYS; i++) {
+		pgm_tsi_t tsi;
+		generate_tsi (&tsi, i);
+		pgm_tsitable_insert (t, &tsi, GUINT_TO_POINTER(i + 1));
+		if (NULL != t->old_entries)
+			is_migrated = TRUE;
+		for (guint j = 0; j <= i; j++) {
+			generate_tsi (&tsi, j);
+			fail_unless (GUINT_TO_POINTER(j + 1) == pgm_tsitable_lookup (t, &tsi), "lookup failed");
+		}
+	}
+	fail_unless (is_migrated, "no growth");
+	fail_unless (TEST_KEYS == t->count, "insert failed");
+	fail_unless (4 * t->count <= 3 * (t->mask + 1), "overloaded");
+	pgm_tsitable_destroy (t);
+}
+END_TEST
+
+/* duplicate key */
+START_TEST (test_insert_fail_001)
+{
+	pgm_tsitable_t* t = pgm_tsitable_new ();
+	pgm_tsi_t tsi;
+	generate_tsi (&tsi, 0);
+	pgm_tsitable_insert (t, &tsi, GUINT_TO_POINTER(1));
+	pgm_tsitable_insert (t, &tsi, GUINT_TO_POINTER(2));
+	fail_unless (1 == t->count, "duplicate inserted");
+	fail_unless (GUINT_TO_POINTER(1) == pgm_tsitable_lookup (t, &tsi), "lookup failed");
+	pgm_tsitable_destroy (t);
+}
+END_TEST
+
+/* target:
+ *	void*
+ *	pgm_tsitable_lookup (
+ *		const pgm_tsitable_t*	t,
+ *		const pgm_tsi_t*	tsi
+ *	)
+ */
+
+START_TEST (test_lookup_pass_001)
+{
+	pgm_tsitable_t* t = pgm_tsitable_new ();
+	pgm_tsi_t tsi;
+	generate_tsi (&tsi, 0);
+	fail_unless (NULL == pgm_tsitable_lookup (t, &tsi), "lookup failed");
+	pgm_tsitable_destroy (t);
+}
+END_TEST
+
+START_TEST (test_lookup_fail_001)
+{
+	pgm_tsi_t tsi;
+	generate_tsi (&tsi, 0);
+	fail_unless (NULL == pgm_tsitable_lookup (NULL, &tsi), "lookup failed");
+}
+END_TEST
+
+/* target:
+ *	bool
+ *	pgm_tsitable_remove (
+ *		pgm_tsitable_t*		t,
+ *		const pgm_tsi_t*	tsi
+ *	)
+ */
+
+START_TEST (test_remove_pass_001)
+{
+	pgm_tsitable_t* t = pgm_tsitable_new ();
+	pgm_tsi_t tsi;
+	generate_tsi (&tsi, 0);
+	fail_unless (FALSE == pgm_tsitable_remove (t, &tsi), "remove failed");
+	pgm_tsitable_insert (t, &tsi, GUINT_TO_POINTER(1));
+	fail_unless (TRUE == pgm_tsitable_remove (t, &tsi), "remove failed");
+	fail_unless (0 == t->count, "remove failed");
+	fail_unless (NULL == pgm_tsitable_lookup (t, &tsi), "lookup failed");
+	pgm_tsitable_destroy (t);
+}
+END_TEST
+
+/* random insert and remove against a reference set including during migration */
+START_TEST (test_remove_pass_002)
+{
+	pgm_tsitable_t* t = pgm_tsitable_new ();
+	gboolean present[ TEST_KEYS ];
+	guint32 seed = 1;
+	guint count = 0;
+	memset (present, 0, sizeof(present));
+	for (guint n = 0; n < 8 * TEST_KEYS; n++) {
+		pgm_tsi_t tsi;
+		seed = seed * 1103515245 + 12345;
+		const guint i = (seed >> 8) % TEST_KEYS;
+		generate_tsi (&tsi, i);
+		if (present[i]) {
+			fail_unless (TRUE == pgm_tsitable_remove (t, &tsi), "remove failed");
+			present[i] = FALSE;
+			count--;
+		} else {
+			pgm_tsitable_insert (t, &tsi, GUINT_TO_POINTER(i + 1));
+			present[i] = TRUE;
+			count++;
+		}
+		fail_unless (count == t->count, "count mismatch");
+		if (0 == n % 64 || NULL != t->old_entries) {
+			for (guint j = 0; j < TEST_KEYS; j++) {
+				generate_tsi (&tsi, j);
+				fail_unless ((present[j] ? GUINT_TO_POINTER(j + 1) : NULL) == pgm_tsitable_lookup (t, &tsi), "lookup failed");
+			}
+		}
+	}
+	pgm_tsitable_destroy (t);
+}
+END_TEST
+
+START_TEST (test_remove_fail_001)
+{
+	pgm_tsi_t tsi;
+	generate_tsi (&tsi, 0);
+	fail_unless (FALSE == pgm_tsitable_remove (NULL, &tsi), "remove failed");
+}
+END_TEST
+
+
+static
+Suite*
+make_test_suite (void)
+{
+	Suite* s;
+
+	s = suite_create (__FILE__);
+
+	TCase* tc_new = tcase_create ("new");
+	suite_add_tcase (s, tc_new);
+	tcase_add_test (tc_new, test_new_pass_001);
+
+	TCase* tc_insert = tcase_create ("insert");
+	suite_add_tcase (s, tc_insert);
+	tcase_add_test (tc_insert, test_insert_pass_001);
+	tcase_add_test (tc_insert, test_insert_pass_002);
+	tcase_add_test (tc_insert, test_insert_fail_001);
+
+	TCase* tc_lookup = tcase_create ("lookup");
+	suite_add_tcase (s, tc_lookup);
+	tcase_add_test (tc_lookup, test_lookup_pass_001);
+	tcase_add_test (tc_lookup, test_lookup_fail_001);
+
+	TCase* tc_remove = tcase_create ("remove");
+	suite_add_tcase (s, tc_remove);
+	tcase_add_test (tc_remove, test_remove_pass_001);
+	tcase_add_test (tc_remove, test_remove_pass_002);
+	tcase_add_test (tc_remove, test_remove_fail_001);
+
+	return s;
+}
+
+static
+Suite*
+make_master_suite (void)
+{
+	Suite* s = suite_create ("Master");
+	return s;
+}
+
+int
+main (void)
+{
+	pgm_messages_init();
+	SRunner* sr = srunner_create (make_master_suite ());
+	srunner_add_suite (sr, make_test_suite ());
+	srunner_run_all (sr, CK_ENV);
+	int number_failed = srunner_ntests_failed (sr);
+	srunner_free (sr);
+	pgm_messages_shutdown();
+	return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* eof */
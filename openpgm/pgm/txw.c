@@ -77,7 +77,7 @@ _pgm_txw_peek (
 
 	if (pgm_uint32_gte (sequence, window->trail) && pgm_uint32_lte (sequence, window->lead))
 	{
-		const uint_fast32_t index_ = sequence % pgm_txw_max_length (window);
+		const uint_fast32_t index_ = pgm_txw_index (window, sequence);
 		skb = window->pdata[index_];
 		pgm_assert (NULL != skb);
 		pgm_assert (pgm_skb_is_valid (skb));
@@ -138,6 +138,48 @@ pgm_txw_inc_retransmit_count (
 	state->retransmit_count++;
 }
 
+PGM_GNUC_INTERNAL
+pgm_time_t
+pgm_txw_get_ncf_expiry (
+	const struct pgm_sk_buff_t*const skb
+	)
+{
+	const pgm_txw_state_t*const state = (const pgm_txw_state_t*const)&skb->cb;
+	return state->ncf_expiry;
+}
+
+PGM_GNUC_INTERNAL
+void
+pgm_txw_set_ncf_expiry (
+	struct pgm_sk_buff_t*const skb,
+	const pgm_time_t	expiry
+	)
+{
+	pgm_txw_state_t* state = (pgm_txw_state_t*)&skb->cb;
+	state->ncf_expiry = expiry;
+}
+
+PGM_GNUC_INTERNAL
+pgm_time_t
+pgm_txw_get_nak_tstamp (
+	const struct pgm_sk_buff_t*const skb
+	)
+{
+	const pgm_txw_state_t*const state = (const pgm_txw_state_t*const)&skb->cb;
+	return state->nak_tstamp;
+}
+
+PGM_GNUC_INTERNAL
+void
+pgm_txw_set_nak_tstamp (
+	struct pgm_sk_buff_t*const skb,
+	const pgm_time_t	tstamp
+	)
+{
+	pgm_txw_state_t* state = (pgm_txw_state_t*)&skb->cb;
+	state->nak_tstamp = tstamp;
+}
+
 PGM_GNUC_INTERNAL
 bool
 pgm_txw_retransmit_is_empty (
@@ -179,7 +221,6 @@ pgm_txw_create (
 /* pre-conditions */
 	pgm_assert (NULL != tsi);
 	if (sqns) {
-		pgm_assert_cmpuint (tpdu_size, ==, 0);
 		pgm_assert_cmpuint (sqns, >, 0);
 		pgm_assert_cmpuint (sqns & PGM_UINT32_SIGN_BIT, ==, 0);
 		pgm_assert_cmpuint (secs, ==, 0);
@@ -190,6 +231,7 @@ pgm_txw_create (
 		pgm_assert_cmpuint (max_rte, >, 0);
 	}
 	if (use_fec) {
+		pgm_assert_cmpuint (tpdu_size, >, 0);	/* parity buffer */
 		pgm_assert_cmpuint (rs_n, >, 0);
 		pgm_assert_cmpuint (rs_k, >, 0);
 	}
@@ -203,7 +245,9 @@ pgm_txw_create (
 /* calculate transmit window parameters */
 	pgm_assert (sqns || (tpdu_size && secs && max_rte));
 	const unsigned alloc_sqns = sqns ? sqns : (unsigned)( (secs * max_rte) / tpdu_size );
-	window = pgm_malloc0 (sizeof(pgm_txw_t) + ( alloc_sqns * sizeof(struct pgm_sk_buff_t*) ));
+/* round slot array up to a power of 2 so that lookups are a mask */
+	const unsigned slots = (unsigned)pgm_nearest_power (1, alloc_sqns);
+	window = pgm_malloc0 (sizeof(pgm_txw_t) + ( slots * sizeof(struct pgm_sk_buff_t*) ));
 	window->tsi = tsi;
 
 /* empty state for transmission group boundaries to align.
@@ -223,6 +267,7 @@ pgm_txw_create (
 
 /* pointer array */
 	window->alloc = alloc_sqns;
+	window->mask  = slots - 1;
 
 /* post-conditions */
 	pgm_assert_cmpuint (pgm_txw_max_length (window), ==, alloc_sqns);
@@ -267,6 +312,8 @@ pgm_txw_shutdown (
 /* free reed-solomon state */
 	if (window->is_fec_enabled) {
 		pgm_free_skb (window->parity_buffer);
+		if (window->parity_rows)
+			pgm_free (window->parity_rows);
 		pgm_rs_destroy (&window->rs);
 	}
 
@@ -320,7 +367,7 @@ pgm_txw_add (
 	skb->sequence = window->lead;
 
 /* add skb to window */
-	const uint_fast32_t index_ = skb->sequence % pgm_txw_max_length (window);
+	const uint_fast32_t index_ = pgm_txw_index (window, skb->sequence);
 	window->pdata[index_] = skb;
 
 /* statistics */
@@ -377,6 +424,13 @@ pgm_txw_remove_tail (
 		state->waiting_retransmit = 0;
 	}
 
+/* drop parity encoded from this transmission group */
+	if (window->parity_row_count &&
+	    (skb->sequence & (0xffffffff << window->tg_sqn_shift)) == window->parity_tg_sqn)
+	{
+		window->parity_row_count = 0;
+	}
+
 /* statistics */
 	window->size -= skb->len;
 	if (state->retransmit_count > 0) {
@@ -388,7 +442,7 @@ pgm_txw_remove_tail (
 
 /* remove reference to skb */
 	if (PGM_UNLIKELY(pgm_mem_gc_friendly)) {
-		const uint_fast32_t index_ = skb->sequence % pgm_txw_max_length (window);
+		const uint_fast32_t index_ = pgm_txw_index (window, skb->sequence);
 		window->pdata[index_] = NULL;
 	}
 	pgm_free_skb (skb);
@@ -727,12 +781,58 @@ pgm_txw_retransmit_try_peek (
 		data = opt_fragment + 1;
 	}
 
-/* encode payload */
-	pgm_rs_encode (&window->rs,
-			src,
-			window->rs.k + rs_h,
-			data,
+/* encode payload, when more than one parity packet is outstanding encode
+ * every outstanding row in one pass and serve following requests from the
+ * cached rows.
+ */
+	const bool is_cached = window->parity_row_count &&
+			       window->parity_tg_sqn == tg_sqn &&
+			       window->parity_row_length == parity_length &&
+			       rs_h >= window->parity_row_first &&
+			       rs_h < window->parity_row_first + window->parity_row_count;
+/* a selective NAK for the group leader may follow parity already sent, leaving
+ * more sent than requested.
+ */
+	const int outstanding = (int)state->pkt_cnt_requested - (int)state->pkt_cnt_sent;
+	const uint8_t rows = (uint8_t)MAX(1, MIN(MIN(outstanding, PGM_TXW_PARITY_ROWS),
+						 (window->rs.n - window->rs.k) - rs_h));
+	if (!is_cached && rows > 1)
+	{
+		uint8_t offsets[ PGM_TXW_PARITY_ROWS ];
+		pgm_gf8_t* dst[ PGM_TXW_PARITY_ROWS ];
+		if (parity_length > window->parity_row_size) {
+			window->parity_rows = pgm_realloc (window->parity_rows, PGM_TXW_PARITY_ROWS * parity_length);
+			window->parity_row_size = parity_length;
+		}
+		for (uint_fast8_t i = 0; i < rows; i++) {
+			offsets[i] = window->rs.k + rs_h + i;
+			dst[i] = window->parity_rows + (i * window->parity_row_size);
+		}
+		pgm_rs_encode_rows (&window->rs,
+				    src,
+				    offsets,
+				    dst,
+				    rows,
+				    parity_length);
+		window->parity_tg_sqn	  = tg_sqn;
+		window->parity_row_length = parity_length;
+		window->parity_row_first  = rs_h;
+		window->parity_row_count  = rows;
+	}
+	if (is_cached || rows > 1)
+	{
+		memcpy (data,
+			window->parity_rows + ((rs_h - window->parity_row_first) * window->parity_row_size),
 			parity_length);
+	}
+	else
+	{
+		pgm_rs_encode (&window->rs,
+				src,
+				window->rs.k + rs_h,
+				data,
+				parity_length);
+	}
 
 /* calculate partial checksum */
 	const uint16_t tsdu_length = pgm_ntohs (skb->pgm_header->pgm_tsdu_length);
@@ -740,6 +840,49 @@ pgm_txw_retransmit_try_peek (
 	return skb;
 }
 
+/* peek up to n selective repair requests from the retransmit queue in queue
+ * order, stopping at the first parity request as parity packets share one
+ * encoding buffer, or at a packet still in transit.  entries remain queued
+ * until removed with pgm_txw_retransmit_remove_head().
+ *
+ * returns count of skbs stored in skbs.
+ */
+
+PGM_GNUC_INTERNAL
+unsigned
+pgm_txw_retransmit_try_peek_selective (
+	pgm_txw_t*	      const restrict window,
+	struct pgm_sk_buff_t**	    restrict skbs,
+	const unsigned			     n
+	)
+{
+	pgm_list_t* link;
+	unsigned count = 0;
+
+/* pre-conditions */
+	pgm_assert (NULL != window);
+	pgm_assert (NULL != skbs);
+	pgm_assert (n > 0);
+
+	pgm_debug ("retransmit_try_peek_selective (window:%p skbs:%p n:%u)",
+		(const void*)window, (const void*)skbs, n);
+
+	for (link = pgm_queue_peek_tail_link (&window->retransmit_queue);
+	     NULL != link && count < n;
+	     link = link->prev)
+	{
+		struct pgm_sk_buff_t* skb = (struct pgm_sk_buff_t*)link;
+		const pgm_txw_state_t* state = (const pgm_txw_state_t*)&skb->cb;
+
+		pgm_assert (pgm_skb_is_valid (skb));
+		if (state->pkt_cnt_requested ||
+		    1 != pgm_atomic_read32 (&skb->users))
+			break;
+		skbs[ count++ ] = skb;
+	}
+	return count;
+}
+
 /* remove head entry from retransmit queue, will fail on assertion if queue is empty.
  */
 
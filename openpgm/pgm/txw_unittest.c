@@ -37,12 +37,15 @@
 #define pgm_rs_create			mock_pgm_rs_create
 #define pgm_rs_destroy			mock_pgm_rs_destroy
 #define pgm_rs_encode			mock_pgm_rs_encode
+#define pgm_rs_encode_rows		mock_pgm_rs_encode_rows
 #define pgm_compat_csum_partial		mock_pgm_compat_csum_partial
 #define pgm_histogram_init		mock_pgm_histogram_init
 
 #define TXW_DEBUG
 #include "txw.c"
 
+static unsigned mock_encode_calls = 0;
+
 
 /** reed-solomon module */
 void
@@ -52,6 +55,8 @@ mock_pgm_rs_create (
 	uint8_t			k
 	)
 {
+	rs->n = n;
+	rs->k = k;
 }
 
 void
@@ -70,6 +75,20 @@ mock_pgm_rs_encode(
 	const uint16_t		len
         )
 {
+	mock_encode_calls++;
+}
+
+void
+mock_pgm_rs_encode_rows (
+	pgm_rs_t*		rs,
+	const pgm_gf8_t**	src,
+	const uint8_t*		offsets,
+	pgm_gf8_t**		dst,
+	const uint8_t		count,
+	const uint16_t		len
+	)
+{
+	mock_encode_calls++;
 }
 
 /** checksum module */
@@ -351,6 +370,8 @@ START_TEST (test_max_length_pass_001)
 	pgm_txw_t* window = pgm_txw_create (&tsi, 0, window_length, 0, 0, FALSE, 0, 0);
 	fail_if (NULL == window, "create failed");
 	fail_unless (window_length == pgm_txw_max_length (window), "max_length failed");
+/* slot array rounded up to a power of 2 */
+	fail_unless (127 == window->mask, "max_length failed");
 	pgm_txw_shutdown (window);
 }
 END_TEST
@@ -586,6 +607,55 @@ START_TEST (test_retransmit_try_peek_pass_001)
 }
 END_TEST
 
+/* outstanding parity packets of a transmission group encoded in one pass */
+START_TEST (test_retransmit_try_peek_pass_002)
+{
+	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	pgm_txw_t* window = pgm_txw_create (&tsi, 1500, 0, 60, 800000, TRUE, 255, 4);
+	fail_if (NULL == window, "create failed");
+	for (unsigned i = 0; i < 4; i++) {
+		struct pgm_sk_buff_t* skb = generate_valid_skb ();
+		fail_if (NULL == skb, "generate_valid_skb failed");
+		pgm_txw_add (window, skb);
+	}
+	fail_unless (TRUE == pgm_txw_retransmit_push (window, window->trail | 1, TRUE, window->tg_sqn_shift), "retransmit_push failed");
+	struct pgm_sk_buff_t* skb = pgm_txw_peek (window, window->trail);
+	((pgm_txw_state_t*)&skb->cb)->pkt_cnt_requested = 3;
+	mock_encode_calls = 0;
+	for (unsigned i = 0; i < 3; i++) {
+		fail_unless (NULL != pgm_txw_retransmit_try_peek (window), "retransmit_try_peek failed");
+		pgm_txw_retransmit_remove_head (window);
+	}
+	fail_unless (1 == mock_encode_calls, "retransmit_try_peek failed");
+	fail_unless (3 == window->parity_row_count, "retransmit_try_peek failed");
+	fail_unless (!pgm_txw_retransmit_can_peek (window), "retransmit_try_peek failed");
+	pgm_txw_shutdown (window);
+}
+END_TEST
+
+/* more parity sent than requested encodes one row */
+START_TEST (test_retransmit_try_peek_pass_003)
+{
+	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	pgm_txw_t* window = pgm_txw_create (&tsi, 1500, 0, 60, 800000, TRUE, 255, 4);
+	fail_if (NULL == window, "create failed");
+	for (unsigned i = 0; i < 4; i++) {
+		struct pgm_sk_buff_t* skb = generate_valid_skb ();
+		fail_if (NULL == skb, "generate_valid_skb failed");
+		pgm_txw_add (window, skb);
+	}
+	fail_unless (TRUE == pgm_txw_retransmit_push (window, window->trail | 1, TRUE, window->tg_sqn_shift), "retransmit_push failed");
+	struct pgm_sk_buff_t* skb = pgm_txw_peek (window, window->trail);
+	((pgm_txw_state_t*)&skb->cb)->pkt_cnt_requested = 1;
+	((pgm_txw_state_t*)&skb->cb)->pkt_cnt_sent = 2;
+	mock_encode_calls = 0;
+	fail_unless (NULL != pgm_txw_retransmit_try_peek (window), "retransmit_try_peek failed");
+	fail_unless (1 == mock_encode_calls, "retransmit_try_peek failed");
+	fail_unless (0 == window->parity_row_count, "retransmit_try_peek failed");
+	pgm_txw_shutdown (window);
+}
+END_TEST
+
 /* null window */
 START_TEST (test_retransmit_try_peek_fail_001)
 {
@@ -594,6 +664,79 @@ START_TEST (test_retransmit_try_peek_fail_001)
 }
 END_TEST
 
+/* target:
+ *	unsigned
+ *	pgm_txw_retransmit_try_peek_selective (
+ *		pgm_txw_t* const		window,
+ *		struct pgm_sk_buff_t**		skbs,
+ *		const unsigned			n
+ *		)
+ */
+
+START_TEST (test_retransmit_try_peek_selective_pass_001)
+{
+	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	fail_if (NULL == window, "create failed");
+	for (unsigned i = 0; i < 3; i++) {
+		struct pgm_sk_buff_t* skb = generate_valid_skb ();
+		fail_if (NULL == skb, "generate_valid_skb failed");
+		pgm_txw_add (window, skb);
+		fail_unless (1 == pgm_txw_retransmit_push (window, window->trail + i, FALSE, 0), "retransmit_push failed");
+	}
+	struct pgm_sk_buff_t* skbs[ 8 ];
+	fail_unless (3 == pgm_txw_retransmit_try_peek_selective (window, skbs, G_N_ELEMENTS(skbs)), "retransmit_try_peek_selective failed");
+	for (unsigned i = 0; i < 3; i++)
+		fail_unless (window->trail + i == skbs[i]->sequence, "retransmit_try_peek_selective failed");
+	fail_unless (2 == pgm_txw_retransmit_try_peek_selective (window, skbs, 2), "retransmit_try_peek_selective failed");
+/* entries remain queued */
+	fail_unless (skbs[0] == pgm_txw_retransmit_try_peek (window), "retransmit_try_peek failed");
+	pgm_txw_shutdown (window);
+}
+END_TEST
+
+/* parity request ends the batch */
+START_TEST (test_retransmit_try_peek_selective_pass_002)
+{
+	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	pgm_txw_t* window = pgm_txw_create (&tsi, 1500, 0, 60, 800000, TRUE, 255, 4);
+	fail_if (NULL == window, "create failed");
+	for (unsigned i = 0; i < 8; i++) {
+		struct pgm_sk_buff_t* skb = generate_valid_skb ();
+		fail_if (NULL == skb, "generate_valid_skb failed");
+		pgm_txw_add (window, skb);
+	}
+	fail_unless (TRUE == pgm_txw_retransmit_push (window, window->trail + 4, FALSE, window->tg_sqn_shift), "retransmit_push failed");
+	fail_unless (TRUE == pgm_txw_retransmit_push (window, window->trail | 1, TRUE, window->tg_sqn_shift), "retransmit_push failed");
+	fail_unless (TRUE == pgm_txw_retransmit_push (window, window->trail + 5, FALSE, window->tg_sqn_shift), "retransmit_push failed");
+	struct pgm_sk_buff_t* skbs[ 8 ];
+	fail_unless (1 == pgm_txw_retransmit_try_peek_selective (window, skbs, G_N_ELEMENTS(skbs)), "retransmit_try_peek_selective failed");
+	fail_unless (window->trail + 4 == skbs[0]->sequence, "retransmit_try_peek_selective failed");
+	pgm_txw_shutdown (window);
+}
+END_TEST
+
+/* empty retransmit queue */
+START_TEST (test_retransmit_try_peek_selective_pass_003)
+{
+	const pgm_tsi_t tsi = { { 1, 2, 3, 4, 5, 6 }, 1000 };
+	pgm_txw_t* window = pgm_txw_create (&tsi, 0, 100, 0, 0, FALSE, 0, 0);
+	fail_if (NULL == window, "create failed");
+	struct pgm_sk_buff_t* skbs[ 8 ];
+	fail_unless (0 == pgm_txw_retransmit_try_peek_selective (window, skbs, G_N_ELEMENTS(skbs)), "retransmit_try_peek_selective failed");
+	pgm_txw_shutdown (window);
+}
+END_TEST
+
+/* null window */
+START_TEST (test_retransmit_try_peek_selective_fail_001)
+{
+	struct pgm_sk_buff_t* skbs[ 8 ];
+	const unsigned count = pgm_txw_retransmit_try_peek_selective (NULL, skbs, G_N_ELEMENTS(skbs));
+	fail ("reached");
+}
+END_TEST
+
 /* target:
  *	void
  *	pgm_txw_retransmit_remove_head (
@@ -746,10 +889,21 @@ make_test_suite (void)
 	TCase* tc_retransmit_try_peek = tcase_create ("retransmit-try-peek");
 	suite_add_tcase (s, tc_retransmit_try_peek);
 	tcase_add_test (tc_retransmit_try_peek, test_retransmit_try_peek_pass_001);
+	tcase_add_test (tc_retransmit_try_peek, test_retransmit_try_peek_pass_002);
+	tcase_add_test (tc_retransmit_try_peek, test_retransmit_try_peek_pass_003);
 #ifndef PGM_CHECK_NOFORK
 	tcase_add_test_raise_signal (tc_retransmit_try_peek, test_retransmit_try_peek_fail_001, SIGABRT);
 #endif
 
+	TCase* tc_retransmit_try_peek_selective = tcase_create ("retransmit-try-peek-selective");
+	suite_add_tcase (s, tc_retransmit_try_peek_selective);
+	tcase_add_test (tc_retransmit_try_peek_selective, test_retransmit_try_peek_selective_pass_001);
+	tcase_add_test (tc_retransmit_try_peek_selective, test_retransmit_try_peek_selective_pass_002);
+	tcase_add_test (tc_retransmit_try_peek_selective, test_retransmit_try_peek_selective_pass_003);
+#ifndef PGM_CHECK_NOFORK
+	tcase_add_test_raise_signal (tc_retransmit_try_peek_selective, test_retransmit_try_peek_selective_fail_001, SIGABRT);
+#endif
+
 	TCase* tc_retransmit_remove_head = tcase_create ("retransmit-remove-head");
 	suite_add_tcase (s, tc_retransmit_remove_head);
 	tcase_add_test (tc_retransmit_remove_head, test_retransmit_remove_head_pass_001);
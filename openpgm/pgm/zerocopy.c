@@ -0,0 +1,236 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * Completion tracking of zero-copy transmit buffers.
+ *
+ * Copyright (c) 2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#	include <config.h>
+#endif
+#ifndef _WIN32
+#	include <sys/socket.h>
+#	include <netinet/in.h>
+#endif
+#if defined(MSG_ZEROCOPY) && defined(SO_ZEROCOPY)
+#	include <linux/errqueue.h>
+#endif
+#include <impl/framework.h>
+
+
+//#define ZEROCOPY_DEBUG
+
+#define ZEROCOPY_MIN_SIZE	256
+
+
+/* release held buffers up to and including id last.
+ *
+ * returns count of buffers released.
+ */
+
+static
+unsigned
+_pgm_zerocopy_complete (
+	pgm_zerocopy_t*	zc,
+	const uint32_t	last
+	)
+{
+	unsigned released = 0;
+
+	while (zc->done != zc->next && (int32_t)(last - zc->done) >= 0)
+	{
+		struct pgm_sk_buff_t** slot = &zc->skb[ zc->done & zc->mask ];
+		pgm_free_skb (*slot);
+		*slot = NULL;
+		zc->done++;
+		released++;
+	}
+	zc->completed += released;
+	return released;
+}
+
+/* read every pending notification from the socket error queue, caller holds the mutex.
+ */
+
+static
+unsigned
+_pgm_zerocopy_reap (
+	pgm_zerocopy_t*	zc,
+	const SOCKET	s
+	)
+{
+	unsigned released = 0;
+
+#if defined(MSG_ZEROCOPY) && defined(SO_ZEROCOPY)
+	while (zc->done != zc->next)
+	{
+		char aux[ 128 ];
+		struct msghdr msg;
+		memset (&msg, 0, sizeof(msg));
+		msg.msg_control		= aux;
+		msg.msg_controllen	= sizeof(aux);
+		if (recvmsg (s, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
+			break;
+
+		struct cmsghdr* cmsg;
+		for (cmsg = CMSG_FIRSTHDR(&msg);
+		     cmsg != NULL;
+		     cmsg = CMSG_NXTHDR(&msg, cmsg))
+		{
+			if (!(IPPROTO_IP == cmsg->cmsg_level && IP_RECVERR == cmsg->cmsg_type) &&
+			    !(IPPROTO_IPV6 == cmsg->cmsg_level && IPV6_RECVERR == cmsg->cmsg_type))
+				continue;
+			struct sock_extended_err serr;
+			memcpy (&serr, CMSG_DATA(cmsg), sizeof(serr));
+			if (SO_EE_ORIGIN_ZEROCOPY != serr.ee_origin || 0 != serr.ee_errno)
+				continue;
+/* range of ids from ee_info to ee_data inclusive */
+			if (serr.ee_code & SO_EE_CODE_ZEROCOPY_COPIED)
+				zc->copied += serr.ee_data - serr.ee_info + 1;
+			released += _pgm_zerocopy_complete (zc, serr.ee_data);
+		}
+	}
+#else
+	(void)zc;
+	(void)s;
+#endif /* MSG_ZEROCOPY */
+	return released;
+}
+
+/* returns NULL if zero-copy transmit is not supported by the platform.
+ */
+
+PGM_GNUC_INTERNAL
+pgm_zerocopy_t*
+pgm_zerocopy_create (void)
+{
+#if defined(MSG_ZEROCOPY) && defined(SO_ZEROCOPY)
+	pgm_zerocopy_t* zc;
+
+	zc = pgm_new0 (pgm_zerocopy_t, 1);
+	pgm_mutex_init (&zc->mutex);
+	zc->mask = ZEROCOPY_MIN_SIZE - 1;
+	zc->skb  = pgm_new0 (struct pgm_sk_buff_t*, ZEROCOPY_MIN_SIZE);
+	return zc;
+#else
+	return NULL;
+#endif
+}
+
+/* buffers still in flight are released, the kernel pins the underlying pages
+ * until transmission completes.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_zerocopy_destroy (
+	pgm_zerocopy_t*	zc
+	)
+{
+	pgm_return_if_fail (NULL != zc);
+
+	_pgm_zerocopy_complete (zc, zc->next - 1);
+	pgm_free (zc->skb);
+	pgm_mutex_free (&zc->mutex);
+	pgm_free (zc);
+}
+
+/* hold a reference on skb for the zero-copy send just completed on socket s.  must
+ * be called in send order for every successful MSG_ZEROCOPY send on the socket.
+ */
+
+PGM_GNUC_INTERNAL
+void
+pgm_zerocopy_hold (
+	pgm_zerocopy_t*	      restrict zc,
+	const SOCKET		       s,
+	struct pgm_sk_buff_t* restrict skb
+	)
+{
+	pgm_return_if_fail (NULL != zc);
+	pgm_return_if_fail (NULL != skb);
+
+	pgm_mutex_lock (&zc->mutex);
+	if (PGM_UNLIKELY(zc->next - zc->done > zc->mask))
+	{
+		_pgm_zerocopy_reap (zc, s);
+/* grow on completions lagging a full ring */
+		if (zc->next - zc->done > zc->mask) {
+			const uint32_t mask = (2 * (zc->mask + 1)) - 1;
+			struct pgm_sk_buff_t** ring = pgm_new0 (struct pgm_sk_buff_t*, mask + 1);
+			for (uint32_t id = zc->done; id != zc->next; id++)
+				ring[ id & mask ] = zc->skb[ id & zc->mask ];
+			pgm_free (zc->skb);
+			zc->skb  = ring;
+			zc->mask = mask;
+			pgm_debug ("pgm_zerocopy_hold (zc:%p size:%" PRIu32 ")", (const void*)zc, mask + 1);
+		}
+	}
+	zc->skb[ zc->next & zc->mask ] = pgm_skb_get (skb);
+	zc->next++;
+	pgm_mutex_unlock (&zc->mutex);
+}
+
+/* returns count of buffers released by completions waiting on socket s.
+ */
+
+PGM_GNUC_INTERNAL
+unsigned
+pgm_zerocopy_reap (
+	pgm_zerocopy_t*	zc,
+	const SOCKET	s
+	)
+{
+	unsigned released;
+
+	pgm_return_val_if_fail (NULL != zc, 0);
+
+	pgm_mutex_lock (&zc->mutex);
+	released = _pgm_zerocopy_reap (zc, s);
+	pgm_mutex_unlock (&zc->mutex);
+	return released;
+}
+
+/* returns TRUE if the kernel may still read skb from a zero-copy send after taking
+ * completions waiting on socket s.
+ */
+
+PGM_GNUC_INTERNAL
+bool
+pgm_zerocopy_is_pending (
+	pgm_zerocopy_t*		    restrict zc,
+	const SOCKET			     s,
+	const struct pgm_sk_buff_t* restrict skb
+	)
+{
+	bool is_pending = FALSE;
+
+	pgm_return_val_if_fail (NULL != zc, FALSE);
+	pgm_return_val_if_fail (NULL != skb, FALSE);
+
+	pgm_mutex_lock (&zc->mutex);
+	_pgm_zerocopy_reap (zc, s);
+	for (uint32_t id = zc->done; id != zc->next; id++)
+		if (skb == zc->skb[ id & zc->mask ]) {
+			is_pending = TRUE;
+			break;
+		}
+	pgm_mutex_unlock (&zc->mutex);
+	return is_pending;
+}
+
+/* eof */
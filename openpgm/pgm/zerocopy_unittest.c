@@ -0,0 +1,340 @@
+/* vim:ts=8:sts=8:sw=4:noai:noexpandtab
+ *
+ * unit tests for zero-copy transmit completion tracking.
+ *
+ * Copyright (c) 2011 Miru Limited.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include <errno.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#	include <sys/socket.h>
+#endif
+#include <glib.h>
+#include <check.h>
+
+
+/* mock state */
+
+#define TEST_SOCK	3
+
+/* pending completion notifications, ranges of ids */
+struct mock_notification_t {
+	uint32_t	lo, hi;
+	bool		is_copied;
+};
+
+static struct mock_notification_t mock_notifications[ 16 ];
+static guint mock_notifications_head = 0;
+static guint mock_notifications_tail = 0;
+
+#ifndef _WIN32
+ssize_t mock_recvmsg (int, struct msghdr*, int);
+#endif
+
+#define recvmsg		mock_recvmsg
+
+#define ZEROCOPY_DEBUG
+#include "zerocopy.c"
+
+
+static
+void
+mock_setup (void)
+{
+	mock_notifications_head = mock_notifications_tail = 0;
+}
+
+static
+void
+push_completion (
+	uint32_t	lo,
+	uint32_t	hi,
+	bool		is_copied
+	)
+{
+	g_assert (mock_notifications_tail < G_N_ELEMENTS(mock_notifications));
+	struct mock_notification_t* n = &mock_notifications[ mock_notifications_tail++ ];
+	n->lo = lo;
+	n->hi = hi;
+	n->is_copied = is_copied;
+}
+
+/* mock functions for external references */
+
+PGM_GNUC_INTERNAL
+int
+pgm_get_nprocs (void)
+{
+	return 1;
+}
+
+#ifndef _WIN32
+ssize_t
+mock_recvmsg (
+	int		s,
+	struct msghdr*	msg,
+	int		flags
+	)
+{
+	g_assert (TEST_SOCK == s);
+	g_assert (MSG_ERRQUEUE & flags);
+	if (mock_notifications_head == mock_notifications_tail) {
+		errno = EAGAIN;
+		return -1;
+	}
+#if defined(MSG_ZEROCOPY) && defined(SO_ZEROCOPY)
+	const struct mock_notification_t* n = &mock_notifications[ mock_notifications_head++ ];
+	struct sock_extended_err serr;
+	memset (&serr, 0, sizeof(serr));
+	serr.ee_origin	= SO_EE_ORIGIN_ZEROCOPY;
+	serr.ee_code	= n->is_copied ? SO_EE_CODE_ZEROCOPY_COPIED : 0;
+	serr.ee_info	= n->lo;
+	serr.ee_data	= n->hi;
+	g_assert (msg->msg_controllen >= CMSG_SPACE(sizeof(serr)));
+	struct cmsghdr* cmsg = CMSG_FIRSTHDR(msg);
+	cmsg->cmsg_level = IPPROTO_IP;
+	cmsg->cmsg_type  = IP_RECVERR;
+	cmsg->cmsg_len   = CMSG_LEN(sizeof(serr));
+	memcpy (CMSG_DATA(cmsg), &serr, sizeof(serr));
+	msg->msg_controllen = CMSG_SPACE(sizeof(serr));
+#endif
+	return 0;
+}
+#endif /* !_WIN32 */
+
+static
+struct pgm_sk_buff_t*
+generate_skb (void)
+{
+	struct pgm_sk_buff_t* skb = pgm_alloc_skb (1500);
+	pgm_skb_put (skb, 1000);
+	return skb;
+}
+
+
+/* target:
+ *	pgm_zerocopy_t*
+ *	pgm_zerocopy_create (void)
+ */
+
+START_TEST (test_create_pass_001)
+{
+	pgm_zerocopy_t* zc = pgm_zerocopy_create ();
+#if defined(MSG_ZEROCOPY) && defined(SO_ZEROCOPY)
+	fail_if (NULL == zc, "create failed");
+	fail_unless (0 == ((zc->mask + 1) & zc->mask), "not power of two");
+	fail_unless (zc->next == zc->done, "not empty");
+	pgm_zerocopy_destroy (zc);
+#else
+	fail_unless (NULL == zc, "create without platform support");
+#endif
+}
+END_TEST
+
+#if defined(MSG_ZEROCOPY) && defined(SO_ZEROCOPY)
+/* target:
+ *	void
+ *	pgm_zerocopy_hold (
+ *		pgm_zerocopy_t*		zc,
+ *		const SOCKET		s,
+ *		struct pgm_sk_buff_t*	skb
+ *		)
+ */
+
+START_TEST (test_hold_pass_001)
+{
+	pgm_zerocopy_t* zc = pgm_zerocopy_create ();
+	fail_if (NULL == zc, "create failed");
+	struct pgm_sk_buff_t* skb = generate_skb ();
+	pgm_zerocopy_hold (zc, TEST_SOCK, skb);
+	fail_unless (2 == pgm_atomic_read32 (&skb->users), "reference not held");
+	fail_unless (1 == zc->next, "id not advanced");
+	pgm_zerocopy_destroy (zc);
+	fail_unless (1 == pgm_atomic_read32 (&skb->users), "reference not released");
+	pgm_free_skb (skb);
+}
+END_TEST
+
+/* completions lagging a full ring grow the ring preserving order */
+START_TEST (test_hold_pass_002)
+{
+	pgm_zerocopy_t* zc = pgm_zerocopy_create ();
+	fail_if (NULL == zc, "create failed");
+	const uint32_t count = 3 * (zc->mask + 1);
+	struct pgm_sk_buff_t** skbs = g_new0 (struct pgm_sk_buff_t*, count);
+	for (uint32_t i = 0; i < count; i++) {
+		skbs[i] = generate_skb ();
+		pgm_zerocopy_hold (zc, TEST_SOCK, skbs[i]);
+	}
+	fail_unless (zc->mask + 1 >= count, "ring not grown");
+	for (uint32_t i = 0; i < count; i++)
+		fail_unless (skbs[i] == zc->skb[ i & zc->mask ], "order lost");
+	push_completion (0, count - 1, FALSE);
+	fail_unless (count == pgm_zerocopy_reap (zc, TEST_SOCK), "reap failed");
+	for (uint32_t i = 0; i < count; i++) {
+		fail_unless (1 == pgm_atomic_read32 (&skbs[i]->users), "reference not released");
+		pgm_free_skb (skbs[i]);
+	}
+	g_free (skbs);
+	pgm_zerocopy_destroy (zc);
+}
+END_TEST
+
+/* target:
+ *	unsigned
+ *	pgm_zerocopy_reap (
+ *		pgm_zerocopy_t*		zc,
+ *		const SOCKET		s
+ *		)
+ */
+
+/* partial and kernel copied completions */
+START_TEST (test_reap_pass_001)
+{
+	pgm_zerocopy_t* zc = pgm_zerocopy_create ();
+	fail_if (NULL == zc, "create failed");
+	struct pgm_sk_buff_t* skbs[3];
+	for (unsigned i = 0; i < G_N_ELEMENTS(skbs); i++) {
+		skbs[i] = generate_skb ();
+		pgm_zerocopy_hold (zc, TEST_SOCK, skbs[i]);
+	}
+	fail_unless (0 == pgm_zerocopy_reap (zc, TEST_SOCK), "reap without completions");
+	push_completion (0, 1, TRUE);
+	fail_unless (2 == pgm_zerocopy_reap (zc, TEST_SOCK), "reap failed");
+	fail_unless (2 == zc->copied, "copied count mismatch");
+	fail_unless (1 == pgm_atomic_read32 (&skbs[0]->users), "reference not released");
+	fail_unless (1 == pgm_atomic_read32 (&skbs[1]->users), "reference not released");
+	fail_unless (2 == pgm_atomic_read32 (&skbs[2]->users), "reference released early");
+	push_completion (2, 2, FALSE);
+	fail_unless (1 == pgm_zerocopy_reap (zc, TEST_SOCK), "reap failed");
+	fail_unless (3 == zc->completed, "completed count mismatch");
+	for (unsigned i = 0; i < G_N_ELEMENTS(skbs); i++)
+		pgm_free_skb (skbs[i]);
+	pgm_zerocopy_destroy (zc);
+}
+END_TEST
+#endif /* MSG_ZEROCOPY */
+
+START_TEST (test_reap_fail_001)
+{
+	fail_unless (0 == pgm_zerocopy_reap (NULL, TEST_SOCK), "reap failed");
+}
+END_TEST
+
+#if defined(MSG_ZEROCOPY) && defined(SO_ZEROCOPY)
+/* target:
+ *	bool
+ *	pgm_zerocopy_is_pending (
+ *		pgm_zerocopy_t*			zc,
+ *		const SOCKET			s,
+ *		const struct pgm_sk_buff_t*	skb
+ *		)
+ */
+
+START_TEST (test_is_pending_pass_001)
+{
+	pgm_zerocopy_t* zc = pgm_zerocopy_create ();
+	fail_if (NULL == zc, "create failed");
+	struct pgm_sk_buff_t* held = generate_skb ();
+	struct pgm_sk_buff_t* other = generate_skb ();
+	pgm_zerocopy_hold (zc, TEST_SOCK, held);
+	fail_unless (TRUE == pgm_zerocopy_is_pending (zc, TEST_SOCK, held), "held not pending");
+	fail_unless (FALSE == pgm_zerocopy_is_pending (zc, TEST_SOCK, other), "other pending");
+	push_completion (0, 0, FALSE);
+	fail_unless (FALSE == pgm_zerocopy_is_pending (zc, TEST_SOCK, held), "completed pending");
+	pgm_free_skb (held);
+	pgm_free_skb (other);
+	pgm_zerocopy_destroy (zc);
+}
+END_TEST
+#endif /* MSG_ZEROCOPY */
+
+START_TEST (test_is_pending_fail_001)
+{
+	struct pgm_sk_buff_t* skb = generate_skb ();
+	fail_unless (FALSE == pgm_zerocopy_is_pending (NULL, TEST_SOCK, skb), "is_pending failed");
+	pgm_free_skb (skb);
+}
+END_TEST
+
+
+static
+Suite*
+make_test_suite (void)
+{
+	Suite* s;
+
+	s = suite_create (__FILE__);
+
+	TCase* tc_create = tcase_create ("create");
+	suite_add_tcase (s, tc_create);
+	tcase_add_test (tc_create, test_create_pass_001);
+
+#if defined(MSG_ZEROCOPY) && defined(SO_ZEROCOPY)
+	TCase* tc_hold = tcase_create ("hold");
+	suite_add_tcase (s, tc_hold);
+	tcase_add_checked_fixture (tc_hold, mock_setup, NULL);
+	tcase_add_test (tc_hold, test_hold_pass_001);
+	tcase_add_test (tc_hold, test_hold_pass_002);
+#endif
+
+	TCase* tc_reap = tcase_create ("reap");
+	suite_add_tcase (s, tc_reap);
+	tcase_add_checked_fixture (tc_reap, mock_setup, NULL);
+#if defined(MSG_ZEROCOPY) && defined(SO_ZEROCOPY)
+	tcase_add_test (tc_reap, test_reap_pass_001);
+#endif
+	tcase_add_test (tc_reap, test_reap_fail_001);
+
+	TCase* tc_is_pending = tcase_create ("is-pending");
+	suite_add_tcase (s, tc_is_pending);
+	tcase_add_checked_fixture (tc_is_pending, mock_setup, NULL);
+#if defined(MSG_ZEROCOPY) && defined(SO_ZEROCOPY)
+	tcase_add_test (tc_is_pending, test_is_pending_pass_001);
+#endif
+	tcase_add_test (tc_is_pending, test_is_pending_fail_001);
+
+	return s;
+}
+
+static
+Suite*
+make_master_suite (void)
+{
+	Suite* s = suite_create ("Master");
+	return s;
+}
+
+int
+main (void)
+{
+	pgm_messages_init();
+	SRunner* sr = srunner_create (make_master_suite ());
+	srunner_add_suite (sr, make_test_suite ());
+	srunner_run_all (sr, CK_ENV);
+	int number_failed = srunner_ntests_failed (sr);
+	srunner_free (sr);
+	pgm_messages_shutdown();
+	return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* eof */